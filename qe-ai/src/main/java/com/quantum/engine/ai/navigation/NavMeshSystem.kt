@@ -22,6 +22,8 @@ class NavMeshSystem : System() {
     
     override val systemName = "NavMeshSystem"
     override val requiredComponents = listOf(ComponentType.of<NavMeshAgentComponent>())
+    override val readComponents = requiredComponents
+    override val writeComponents = requiredComponents
     
     private val navMeshes = mutableMapOf<String, NavMesh>()
     private val agents = mutableListOf<NavMeshAgent>()
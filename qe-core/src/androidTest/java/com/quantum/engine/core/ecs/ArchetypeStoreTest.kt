@@ -0,0 +1,75 @@
+package com.quantum.engine.core.ecs
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotSame
+import org.junit.Assert.assertSame
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Movimientos entre archetypes sobre el almacén nativo: columnas gestionadas
+ * y nativas, y huecos rellenados con la última fila
+ */
+@RunWith(AndroidJUnit4::class)
+class ArchetypeStoreTest {
+
+    private lateinit var entityManager: EntityManager
+
+    @Before
+    fun setUp() {
+        entityManager = EntityManager()
+    }
+
+    @After
+    fun tearDown() {
+        entityManager.clear()
+    }
+
+    private fun createWithHealth(health: Float): Entity {
+        val entity = entityManager.createEntity()
+        entityManager.addComponent(entity, TestPosition(health, 0f, 0f))
+        entityManager.addComponent(entity, TestHealth(health))
+        return entity
+    }
+
+    @Test
+    fun moveKeepsManagedAndNativeColumns() {
+        val entity = createWithHealth(5f)
+        val before = entityManager.getArchetype(entity)
+
+        entityManager.addComponent(entity, TestVelocity(1f, 2f, 3f))
+        val moved = entityManager.getArchetype(entity)!!
+        assertNotSame(before, moved)
+        assertEquals(3, moved.types.size)
+        assertEquals(TestPosition(5f, 0f, 0f), entityManager.getComponent<TestPosition>(entity))
+        assertEquals(5f, entityManager.getComponent<TestHealth>(entity)!!.value, 0f)
+
+        // Quitar el tipo vuelve al mismo archetype por su arista
+        assertEquals(TestVelocity(1f, 2f, 3f), entityManager.removeComponent<TestVelocity>(entity))
+        assertSame(before, entityManager.getArchetype(entity))
+        assertEquals(5f, entityManager.getComponent<TestHealth>(entity)!!.value, 0f)
+    }
+
+    @Test
+    fun removalsAcrossChunksKeepEveryRow() {
+        // Varios chunks: cada hueco se rellena con la última fila del archetype
+        val entities = Array(3000) { createWithHealth(it.toFloat()) }
+        val archetype = entityManager.getArchetype(entities[0])!!
+        assertTrue(archetype.chunks.size > 1)
+
+        for (i in entities.indices step 3) {
+            entityManager.destroyEntity(entities[i])
+        }
+
+        for (i in entities.indices) {
+            if (i % 3 == 0) continue
+            assertEquals(i.toFloat(), entityManager.getComponent<TestHealth>(entities[i])!!.value, 0f)
+            assertEquals(i.toFloat(), entityManager.getComponent<TestPosition>(entities[i])!!.x, 0f)
+        }
+        assertEquals(2000, archetype.entityCount)
+    }
+}
@@ -0,0 +1,158 @@
+package com.quantum.engine.core.ecs
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.quantum.engine.jobs.NativeJobSystem
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNotSame
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertSame
+import org.junit.Assert.assertTrue
+import org.junit.Assume.assumeTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Reproducción de EntityCommandBuffer sobre el almacén nativo y cambios
+ * estructurales durante una etapa en paralelo
+ */
+@RunWith(AndroidJUnit4::class)
+class EntityCommandBufferTest {
+
+    private lateinit var entityManager: EntityManager
+
+    @Before
+    fun setUp() {
+        entityManager = EntityManager()
+    }
+
+    @After
+    fun tearDown() {
+        entityManager.clear()
+    }
+
+    private fun createWithHealth(health: Float): Entity {
+        val entity = entityManager.createEntity()
+        entityManager.addComponent(entity, TestPosition(health, 0f, 0f))
+        entityManager.addComponent(entity, TestHealth(health))
+        return entity
+    }
+
+    @Test
+    fun batchedMovesAcrossChunksKeepEveryRow() {
+        // Varios chunks por archetype: los huecos se rellenan con la última fila
+        val entities = Array(3000) { createWithHealth(it.toFloat()) }
+        assertTrue(entityManager.getArchetype(entities[0])!!.chunks.size > 1)
+
+        val buffer = entityManager.commandBuffer()
+        for (i in entities.indices step 2) {
+            buffer.addComponent(entities[i], TestVelocity(i.toFloat(), 0f, 0f))
+        }
+        entityManager.playbackCommands()
+
+        for (i in entities.indices) {
+            val entity = entities[i]
+            assertEquals(i % 2 == 0, entityManager.hasComponent<TestVelocity>(entity))
+            assertEquals(i.toFloat(), entityManager.getComponent<TestHealth>(entity)!!.value, 0f)
+            assertEquals(i.toFloat(), entityManager.getComponent<TestPosition>(entity)!!.x, 0f)
+        }
+        assertEquals(1500, entityManager.getArchetype(entities[0])!!.entityCount)
+        assertEquals(1500, entityManager.getArchetype(entities[1])!!.entityCount)
+    }
+
+    @Test
+    fun playbackAppliesFoldedCommands() {
+        val changed = createWithHealth(1f)
+        val destroyed = createWithHealth(2f)
+        val prefab = createWithHealth(7f)
+
+        val buffer = entityManager.commandBuffer()
+        val created = buffer.createEntity("spawned")
+        buffer.addComponent(created, TestPosition(4f, 5f, 6f))
+        buffer.addComponent(changed, TestVelocity(1f, 0f, 0f))
+        buffer.removeComponent<TestPosition>(changed)
+        buffer.addComponent(destroyed, TestVelocity())
+        buffer.destroyEntity(destroyed)
+        val copies = buffer.instantiate(prefab, 3)
+
+        // Nada cambia hasta el punto de sincronización
+        assertFalse(entityManager.isValid(created))
+        assertTrue(entityManager.hasComponent<TestPosition>(changed))
+        assertTrue(entityManager.isValid(destroyed))
+
+        entityManager.playbackCommands()
+        assertTrue(buffer.isEmpty)
+
+        assertTrue(entityManager.isValid(created))
+        assertEquals("spawned", entityManager.getMetadata(created)!!.name)
+        assertEquals(TestPosition(4f, 5f, 6f), entityManager.getComponent<TestPosition>(created))
+
+        assertTrue(entityManager.hasComponent<TestVelocity>(changed))
+        assertNull(entityManager.getComponent<TestPosition>(changed))
+        assertEquals(1f, entityManager.getComponent<TestHealth>(changed)!!.value, 0f)
+
+        // Destruir gana a cualquier otro comando sobre la entidad
+        assertFalse(entityManager.isValid(destroyed))
+
+        for (i in 0 until 3) {
+            val copy = Entity(copies.id + i)
+            assertTrue(entityManager.isValid(copy))
+            assertSame(entityManager.getArchetype(prefab), entityManager.getArchetype(copy))
+            assertEquals(7f, entityManager.getComponent<TestHealth>(copy)!!.value, 0f)
+
+            // Los gestionados se copian con clone()
+            val position = entityManager.getComponent<TestPosition>(copy)
+            assertNotNull(position)
+            assertEquals(TestPosition(7f, 0f, 0f), position)
+            assertNotSame(entityManager.getComponent<TestPosition>(prefab), position)
+        }
+    }
+
+    private class SpawnSystem(
+        private val target: Entity,
+        override val writeComponents: List<ComponentType>
+    ) : System() {
+        override val requiredComponents: List<ComponentType> = emptyList()
+        override val readComponents: List<ComponentType> = emptyList()
+
+        var spawned = Entity.NULL
+        var appliedDuringStage = true
+
+        override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+            // En la etapa en paralelo se graban en el buffer del hilo
+            spawned = entityManager.createEntity("spawned")
+            entityManager.addComponent(spawned, TestPosition(1f, 2f, 3f))
+            entityManager.addComponent(target, TestVelocity(4f, 0f, 0f))
+            appliedDuringStage = entityManager.isValid(spawned) ||
+                entityManager.hasComponent<TestVelocity>(target)
+        }
+    }
+
+    @Test
+    fun structuralChangesInAParallelStageWaitForPlayback() {
+        assumeTrue(NativeJobSystem.shared != null)
+        val first = createWithHealth(1f)
+        val second = createWithHealth(2f)
+        val archetypeCount = entityManager.archetypes.size
+
+        val systemManager = SystemManager(entityManager)
+        val spawners = listOf(
+            systemManager.registerSystem(SpawnSystem(first, listOf(ComponentType.of<TestVelocity>()))),
+            systemManager.registerSystem(SpawnSystem(second, listOf(ComponentType.of<TestHealth>())))
+        )
+        systemManager.update(1f / 60f)
+
+        for (spawner in spawners) {
+            assertFalse(spawner.appliedDuringStage)
+            assertEquals(TestPosition(1f, 2f, 3f), entityManager.getComponent<TestPosition>(spawner.spawned))
+        }
+        assertEquals(4f, entityManager.getComponent<TestVelocity>(first)!!.x, 0f)
+        assertEquals(4f, entityManager.getComponent<TestVelocity>(second)!!.x, 0f)
+        assertTrue(entityManager.archetypes.size > archetypeCount)
+
+        systemManager.shutdown()
+    }
+}
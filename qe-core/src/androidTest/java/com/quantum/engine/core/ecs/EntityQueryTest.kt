@@ -0,0 +1,138 @@
+package com.quantum.engine.core.ecs
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Consultas cacheadas: archetypes registrados al primer uso y los creados
+ * después, y filtro de cambios por columna y chunk
+ */
+@RunWith(AndroidJUnit4::class)
+class EntityQueryTest {
+
+    private lateinit var entityManager: EntityManager
+    private var moving = Entity.NULL
+    private var still = Entity.NULL
+
+    @Before
+    fun setUp() {
+        entityManager = EntityManager()
+
+        // Archetypes distintos, así que chunks distintos
+        moving = entityManager.createEntity()
+        entityManager.addComponent(moving, TestPosition())
+        entityManager.addComponent(moving, TestVelocity())
+        still = entityManager.createEntity()
+        entityManager.addComponent(still, TestPosition())
+    }
+
+    @After
+    fun tearDown() {
+        entityManager.clear()
+    }
+
+    @Test
+    fun queriesWithoutChangedSeeEverything() {
+        val query = entityManager.query().with<TestPosition>().without<TestVelocity>()
+        assertEquals(listOf(still), query.execute())
+        assertEquals(listOf(still), query.execute())
+        assertEquals(1, query.entityCount)
+    }
+
+    @Test
+    fun registeredQueryReceivesNewArchetypes() {
+        val query = entityManager.query().with<TestPosition>()
+        assertEquals(2, query.archetypes.size)
+        val structure = query.structureVersion
+
+        // Archetype nuevo que cumple, y otro que no
+        val healthy = entityManager.createEntity()
+        entityManager.addComponent(healthy, TestPosition())
+        entityManager.addComponent(healthy, TestHealth(1f))
+        val other = entityManager.createEntity()
+        entityManager.addComponent(other, TestHealth(2f))
+
+        assertEquals(3, query.archetypes.size)
+        assertTrue(query.structureVersion != structure)
+        assertEquals(setOf(moving, still, healthy), query.execute().toSet())
+
+        // Tras dispose() vuelve a registrarse con lo que haya
+        query.dispose()
+        assertEquals(3, query.entityCount)
+    }
+
+    @Test
+    fun changedVisitsOnlyWrittenChunks() {
+        val query = entityManager.query().changed<TestPosition>()
+
+        // Primer recorrido: todo es nuevo
+        assertEquals(setOf(moving, still), query.execute().toSet())
+        assertTrue(query.execute().isEmpty())
+
+        entityManager.getComponentForWrite<TestPosition>(moving)!!.x = 1f
+        assertEquals(listOf(moving), query.execute())
+        assertTrue(query.execute().isEmpty())
+
+        // Escribir otra columna no cuenta
+        entityManager.getComponentForWrite<TestVelocity>(moving)!!.x = 1f
+        assertTrue(query.execute().isEmpty())
+
+        entityManager.setComponent(still, TestPosition(2f, 0f, 0f))
+        assertEquals(listOf(still), query.execute())
+    }
+
+    @Test
+    fun structuralChangesMarkTheTargetChunk() {
+        val query = entityManager.query().changed<TestPosition>()
+        query.execute()
+
+        // still entra en el chunk de moving: cambian sus filas
+        entityManager.addComponent(still, TestVelocity())
+        assertEquals(setOf(moving, still), query.execute().toSet())
+        assertTrue(query.execute().isEmpty())
+    }
+
+    @Test
+    fun systemsSeeWritesFromEarlierSystemsOnly() {
+        val type = ComponentType.of<TestPosition>()
+        val chunk = entityManager.getArchetype(moving)!!.chunks[0]
+        val writer = object : System() {
+            override val requiredComponents: List<ComponentType> = emptyList()
+            override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+                entityManager.getComponentForWrite<TestPosition>(moving)!!.x += 1f
+            }
+        }
+        val reader = object : System() {
+            override val requiredComponents: List<ComponentType> = emptyList()
+            var changed = false
+            override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+                changed = didChange(chunk, type)
+            }
+        }.apply { priority = 1 }
+
+        val systemManager = SystemManager(entityManager)
+        systemManager.parallelStages = false
+        systemManager.registerSystem(writer)
+        systemManager.registerSystem(reader)
+
+        systemManager.update(1f / 60f)
+        assertTrue(reader.changed)
+
+        // Sin escrituras nuevas desde su ejecución anterior
+        writer.enabled = false
+        systemManager.update(1f / 60f)
+        assertFalse(reader.changed)
+
+        writer.enabled = true
+        systemManager.update(1f / 60f)
+        assertTrue(reader.changed)
+
+        systemManager.shutdown()
+    }
+}
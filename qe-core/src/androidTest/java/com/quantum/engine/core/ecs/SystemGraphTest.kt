@@ -0,0 +1,155 @@
+package com.quantum.engine.core.ecs
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.quantum.engine.jobs.NativeJobSystem
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertSame
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.util.Collections
+import java.util.concurrent.atomic.AtomicBoolean
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * Orden de SystemGraph: conflictos de componentes y sistemas exclusivos
+ */
+@RunWith(AndroidJUnit4::class)
+class SystemGraphTest {
+
+    private class StageSystem(
+        override val readComponents: List<ComponentType>?,
+        override val writeComponents: List<ComponentType>?
+    ) : System() {
+        override val requiredComponents: List<ComponentType> = emptyList()
+
+        var updates = 0
+        var lastThread: Thread? = null
+
+        override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+            updates++
+            lastThread = Thread.currentThread()
+        }
+    }
+
+    private val position = ComponentType.of<TestPosition>()
+    private val velocity = ComponentType.of<TestVelocity>()
+
+    private lateinit var scheduler: NativeJobSystem
+    private lateinit var graph: SystemGraph
+
+    @Before
+    fun setUp() {
+        scheduler = NativeJobSystem(workerCount = 3)
+        graph = SystemGraph()
+    }
+
+    @After
+    fun tearDown() {
+        graph.close()
+        scheduler.close()
+    }
+
+    @Test
+    fun conflictsAndExclusiveSystemsKeepPriorityOrder() {
+        val systems = listOf(
+            StageSystem(null, listOf(position)),            // 0
+            StageSystem(listOf(position), null),            // 1: después de 0
+            StageSystem(null, listOf(velocity)),            // 2: libre
+            StageSystem(null, null),                        // 3: exclusivo
+            StageSystem(listOf(velocity), listOf(position)) // 4: después de 3
+        )
+        graph.build(systems)
+
+        // Sólo 0 -> 1: el exclusivo separa los tramos sin aristas
+        assertEquals(1, graph.edgeCount)
+
+        val caller = Thread.currentThread()
+        repeat(100) {
+            val order = Collections.synchronizedList(ArrayList<Int>())
+            val running = AtomicInteger()
+            val exclusiveShared = AtomicBoolean(false)
+            val exclusiveThread = arrayOfNulls<Thread>(1)
+
+            graph.run(scheduler) { index, _ ->
+                val concurrent = running.incrementAndGet()
+                if (index == 3) {
+                    exclusiveThread[0] = Thread.currentThread()
+                    if (concurrent != 1) exclusiveShared.set(true)
+                    Thread.sleep(1)
+                }
+                order.add(index)
+                running.decrementAndGet()
+            }
+
+            assertEquals(setOf(0, 1, 2, 3, 4), order.toSet())
+            assertEquals(5, order.size)
+            assertTrue(order.indexOf(0) < order.indexOf(1))
+            assertEquals(3, order[3])
+            assertEquals(4, order[4])
+            assertFalse(exclusiveShared.get())
+            assertSame(caller, exclusiveThread[0])
+        }
+    }
+
+    @Test
+    fun systemManagerRunsEachEnabledSystemOnce() {
+        val entityManager = EntityManager()
+        val systemManager = SystemManager(entityManager)
+        val writer = systemManager.registerSystem(StageSystem(null, listOf(position)))
+        val exclusive = systemManager.registerSystem(StageSystem(null, null).apply { priority = 1 })
+        val reader = systemManager.registerSystem(StageSystem(listOf(position), null).apply { priority = 2 })
+        val disabled = systemManager.registerSystem(StageSystem(listOf(velocity), null).apply { enabled = false })
+
+        systemManager.update(1f / 60f)
+
+        assertEquals(1, writer.updates)
+        assertEquals(1, exclusive.updates)
+        assertEquals(1, reader.updates)
+        assertEquals(0, disabled.updates)
+        assertSame(Thread.currentThread(), exclusive.lastThread)
+
+        systemManager.shutdown()
+        entityManager.clear()
+    }
+
+    private class OrderedSystem(private val log: MutableList<Int>, private val index: Int) : System() {
+        override val requiredComponents: List<ComponentType> = emptyList()
+
+        override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+            log.add(index)
+        }
+
+        override fun onFixedUpdate(entityManager: EntityManager, fixedDeltaTime: Float) {
+            log.add(-index - 1)
+        }
+    }
+
+    @Test
+    fun systemsWithoutDeclaredSetsKeepTheirOriginalOrder() {
+        // Ningún sistema declara readComponents / writeComponents: todos son
+        // exclusivos y corren uno a uno en orden de prioridad, como antes
+        val entityManager = EntityManager()
+        val systemManager = SystemManager(entityManager)
+        val log = Collections.synchronizedList(ArrayList<Int>())
+        for (index in listOf(3, 0, 4, 1, 2)) {
+            systemManager.registerSystem(OrderedSystem(log, index).apply { priority = index })
+        }
+
+        repeat(20) {
+            log.clear()
+            systemManager.update(1f / 60f)
+            assertEquals(listOf(0, 1, 2, 3, 4), log.toList())
+
+            log.clear()
+            systemManager.fixedUpdate(1f / 60f)
+            assertEquals(listOf(-1, -2, -3, -4, -5), log.toList())
+        }
+
+        systemManager.shutdown()
+        entityManager.clear()
+    }
+}
@@ -0,0 +1,25 @@
+package com.quantum.engine.core.ecs
+
+import java.nio.ByteBuffer
+
+/**
+ * Componentes de los tests del ECS: dos gestionados y uno nativo, para que
+ * los movimientos copien columnas de los dos tipos
+ */
+internal data class TestPosition(var x: Float = 0f, var y: Float = 0f, var z: Float = 0f) : Component {
+    override fun clone(): Component = copy()
+}
+
+internal data class TestVelocity(var x: Float = 0f, var y: Float = 0f, var z: Float = 0f) : Component
+
+internal class TestHealth(var value: Float = 0f) : NativeComponent {
+    override val nativeSize: Int get() = 4
+
+    override fun write(buffer: ByteBuffer, offset: Int) {
+        buffer.putFloat(offset, value)
+    }
+
+    override fun read(buffer: ByteBuffer, offset: Int) {
+        value = buffer.getFloat(offset)
+    }
+}
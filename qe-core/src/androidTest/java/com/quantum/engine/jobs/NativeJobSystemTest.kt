@@ -0,0 +1,81 @@
+package com.quantum.engine.jobs
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.util.Collections
+import java.util.concurrent.atomic.AtomicInteger
+import java.util.concurrent.atomic.AtomicIntegerArray
+
+/**
+ * Dependencias y contadores de NativeJobSystem
+ */
+@RunWith(AndroidJUnit4::class)
+class NativeJobSystemTest {
+
+    private lateinit var jobs: NativeJobSystem
+
+    @Before
+    fun setUp() {
+        assertTrue(NativeJobSystem.isAvailable)
+        jobs = NativeJobSystem(workerCount = 3)
+    }
+
+    @After
+    fun tearDown() {
+        jobs.close()
+    }
+
+    @Test
+    fun scheduleAfterWaitsForEveryJobOfTheCounter() {
+        JobCounter().use { first ->
+            JobCounter().use { second ->
+                assertTrue(first.isDone)
+
+                val log = Collections.synchronizedList(ArrayList<String>())
+                for (i in 0 until 8) {
+                    jobs.schedule(counter = first, begin = i, end = i + 1) { begin, _ ->
+                        Thread.sleep(2)
+                        log.add("a$begin")
+                    }
+                }
+                jobs.schedule(counter = second, after = first) { _, _ -> log.add("b") }
+                jobs.wait(second)
+
+                assertTrue(first.isDone)
+                assertTrue(second.isDone)
+                assertEquals(9, log.size)
+                assertEquals("b", log.last())
+            }
+        }
+    }
+
+    @Test
+    fun parallelForCoversTheRangeOnce() {
+        val count = 10_000
+        val hits = AtomicIntegerArray(count)
+        jobs.parallelFor(count, 64) { begin, end ->
+            for (i in begin until end) hits.incrementAndGet(i)
+        }
+        for (i in 0 until count) {
+            assertEquals(1, hits.get(i))
+        }
+    }
+
+    @Test
+    fun counterIsReusableOnceDone() {
+        JobCounter().use { counter ->
+            val sum = AtomicInteger()
+            repeat(3) {
+                jobs.parallelFor(1000, 16, counter) { begin, end -> sum.addAndGet(end - begin) }
+                jobs.wait(counter)
+                assertTrue(counter.isDone)
+            }
+            assertEquals(3000, sum.get())
+        }
+    }
+}
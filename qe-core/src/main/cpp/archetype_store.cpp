@@ -0,0 +1,344 @@
+// archetype_store.cpp - Entidades por archetype en chunks SoA de 16KB
+#include "archetype_store.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+static inline int32_t alignColumn(int32_t offset) {
+    return (offset + ArchetypeStore::COLUMN_ALIGNMENT - 1) & ~(ArchetypeStore::COLUMN_ALIGNMENT - 1);
+}
+
+ArchetypeStore::ArchetypeStore() : typeSizes(MAX_TYPES, -1) {
+    // Archetype 0: entidades sin componentes
+    getArchetype(nullptr, 0);
+}
+
+ArchetypeStore::~ArchetypeStore() {
+    for (Chunk& chunk : chunks) {
+        free(chunk.memory);
+    }
+}
+
+bool ArchetypeStore::registerType(int32_t type, int32_t size) {
+    if (type < 0 || type >= MAX_TYPES || size < 0 || size > CHUNK_BYTES / 8) return false;
+    if (typeSizes[type] >= 0) return typeSizes[type] == size;
+    typeSizes[type] = size;
+    return true;
+}
+
+int32_t ArchetypeStore::getArchetype(const int32_t* types, int32_t count) {
+    std::vector<int32_t> key(types, types + count);
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+
+    auto found = archetypesByTypes.find(key);
+    if (found != archetypesByTypes.end()) return found->second;
+
+    for (int32_t type : key) {
+        if (type < 0 || type >= MAX_TYPES || typeSizes[type] < 0) return -1;
+    }
+
+    Archetype archetype;
+    archetype.types = key;
+
+    // Capacidad: bytes por fila con las referencias gestionadas contando
+    // REFERENCE_BYTES, menos el relleno de alinear cada columna
+    int32_t rowBytes = ENTITY_BYTES;
+    int32_t nativeColumns = 1;
+    for (int32_t type : key) {
+        int32_t size = typeSizes[type];
+        archetype.sizes.push_back(size);
+        rowBytes += size > 0 ? size : REFERENCE_BYTES;
+        if (size > 0) nativeColumns++;
+    }
+    archetype.capacity = (CHUNK_BYTES - nativeColumns * COLUMN_ALIGNMENT) / rowBytes;
+    if (archetype.capacity < 1) return -1;
+
+    int32_t offset = alignColumn(archetype.capacity * ENTITY_BYTES);
+    for (int32_t size : archetype.sizes) {
+        if (size > 0) {
+            archetype.offsets.push_back(offset);
+            offset = alignColumn(offset + archetype.capacity * size);
+        } else {
+            archetype.offsets.push_back(-1);
+        }
+    }
+    if (offset > CHUNK_BYTES) return -1;
+
+    int32_t index = static_cast<int32_t>(archetypes.size());
+    archetypes.push_back(std::move(archetype));
+    archetypesByTypes.emplace(std::move(key), index);
+    return index;
+}
+
+int32_t ArchetypeStore::allocateChunk(int32_t archetype) {
+    int32_t index;
+    if (!freeChunks.empty()) {
+        index = freeChunks.back();
+        freeChunks.pop_back();
+    } else {
+        void* memory = nullptr;
+        if (posix_memalign(&memory, 64, CHUNK_BYTES) != 0) return -1;
+        index = static_cast<int32_t>(chunks.size());
+        chunks.push_back({ static_cast<uint8_t*>(memory), -1, 0 });
+    }
+    Chunk& chunk = chunks[index];
+    chunk.archetype = archetype;
+    chunk.count = 0;
+    return index;
+}
+
+void ArchetypeStore::releaseChunk(int32_t chunk) {
+    chunks[chunk].archetype = -1;
+    chunks[chunk].count = 0;
+    freeChunks.push_back(chunk);
+}
+
+bool ArchetypeStore::appendRow(int32_t archetype, int32_t& chunk, int32_t& row, int32_t& newChunk) {
+    Archetype& a = archetypes[archetype];
+    int32_t position = a.entityCount / a.capacity;
+    newChunk = -1;
+    if (position == static_cast<int32_t>(a.chunks.size())) {
+        newChunk = allocateChunk(archetype);
+        if (newChunk < 0) return false;
+        a.chunks.push_back(newChunk);
+    }
+    chunk = a.chunks[position];
+    row = a.entityCount % a.capacity;
+    chunks[chunk].count++;
+    a.entityCount++;
+    return true;
+}
+
+int32_t ArchetypeStore::appendRows(int32_t archetype, int32_t count, int32_t* newChunks, int32_t& newChunkCount) {
+    Archetype& a = archetypes[archetype];
+    const int32_t first = a.entityCount;
+    const int32_t lastPosition = (first + count - 1) / a.capacity;
+    newChunkCount = 0;
+    while (static_cast<int32_t>(a.chunks.size()) <= lastPosition) {
+        int32_t chunk = allocateChunk(archetype);
+        if (chunk < 0) {
+            // Sin memoria: se deshacen las reservas de esta llamada
+            for (; newChunkCount > 0; newChunkCount--) {
+                a.chunks.pop_back();
+                releaseChunk(newChunks[newChunkCount - 1]);
+            }
+            return -1;
+        }
+        a.chunks.push_back(chunk);
+        newChunks[newChunkCount++] = chunk;
+    }
+
+    for (int32_t index = first; index < first + count;) {
+        Chunk& chunk = chunks[a.chunks[index / a.capacity]];
+        int32_t rows = std::min(a.capacity - index % a.capacity, first + count - index);
+        chunk.count += rows;
+        index += rows;
+    }
+    a.entityCount += count;
+    return first;
+}
+
+void ArchetypeStore::removeRow(int32_t archetype, int32_t chunk, int32_t row, int32_t* result) {
+    Archetype& a = archetypes[archetype];
+    const int32_t last = a.entityCount - 1;
+    const int32_t lastPosition = last / a.capacity;
+    const int32_t lastChunk = a.chunks[lastPosition];
+    const int32_t lastRow = last % a.capacity;
+
+    result[HOLE_CHUNK] = chunk;
+    result[HOLE_ROW] = row;
+    result[FROM_CHUNK] = -1;
+    result[FROM_ROW] = -1;
+    result[FREED_CHUNK] = -1;
+
+    if (lastChunk != chunk || lastRow != row) {
+        uint8_t* dst = chunks[chunk].memory;
+        const uint8_t* src = chunks[lastChunk].memory;
+        entities(chunk)[row] = entities(lastChunk)[lastRow];
+        for (size_t i = 0; i < a.types.size(); i++) {
+            int32_t size = a.sizes[i];
+            if (size == 0) continue;
+            std::memcpy(dst + a.offsets[i] + row * size, src + a.offsets[i] + lastRow * size, size);
+        }
+        result[FROM_CHUNK] = lastChunk;
+        result[FROM_ROW] = lastRow;
+    }
+
+    chunks[lastChunk].count--;
+    a.entityCount--;
+
+    // El chunk vaciado queda de repuesto; si ya había uno detrás, al pool
+    if (chunks[lastChunk].count == 0 && lastPosition + 1 < static_cast<int32_t>(a.chunks.size())) {
+        int32_t spare = a.chunks.back();
+        a.chunks.pop_back();
+        releaseChunk(spare);
+        result[FREED_CHUNK] = spare;
+    }
+}
+
+static void clearResult(int32_t* result) {
+    std::fill(result, result + ArchetypeStore::RESULT_INTS, -1);
+}
+
+bool ArchetypeStore::addEntity(int32_t archetype, int64_t entity, int32_t* result) {
+    int32_t chunk, row, newChunk;
+    if (!appendRow(archetype, chunk, row, newChunk)) {
+        clearResult(result);
+        return false;
+    }
+
+    const Archetype& a = archetypes[archetype];
+    uint8_t* memory = chunks[chunk].memory;
+    entities(chunk)[row] = entity;
+    for (size_t i = 0; i < a.types.size(); i++) {
+        if (a.sizes[i] > 0) {
+            std::memset(memory + a.offsets[i] + row * a.sizes[i], 0, a.sizes[i]);
+        }
+    }
+
+    result[DST_CHUNK] = chunk;
+    result[DST_ROW] = row;
+    result[HOLE_CHUNK] = -1;
+    result[HOLE_ROW] = -1;
+    result[FROM_CHUNK] = -1;
+    result[FROM_ROW] = -1;
+    result[NEW_CHUNK] = newChunk;
+    result[FREED_CHUNK] = -1;
+    return true;
+}
+
+bool ArchetypeStore::moveEntity(int32_t chunk, int32_t row, int32_t archetype, int32_t* result) {
+    const int32_t source = chunks[chunk].archetype;
+    if (source == archetype) {
+        result[DST_CHUNK] = chunk;
+        result[DST_ROW] = row;
+        result[HOLE_CHUNK] = -1;
+        result[HOLE_ROW] = -1;
+        result[FROM_CHUNK] = -1;
+        result[FROM_ROW] = -1;
+        result[NEW_CHUNK] = -1;
+        result[FREED_CHUNK] = -1;
+        return true;
+    }
+
+    int32_t dstChunk, dstRow, newChunk;
+    if (!appendRow(archetype, dstChunk, dstRow, newChunk)) {
+        clearResult(result);
+        return false;
+    }
+
+    // Columnas nativas: los tipos comunes se copian, los nuevos a cero
+    const Archetype& from = archetypes[source];
+    const Archetype& to = archetypes[archetype];
+    const uint8_t* src = chunks[chunk].memory;
+    uint8_t* dst = chunks[dstChunk].memory;
+    entities(dstChunk)[dstRow] = entities(chunk)[row];
+
+    size_t j = 0;
+    for (size_t i = 0; i < to.types.size(); i++) {
+        int32_t size = to.sizes[i];
+        while (j < from.types.size() && from.types[j] < to.types[i]) j++;
+        if (size == 0) continue;
+        uint8_t* column = dst + to.offsets[i] + dstRow * size;
+        if (j < from.types.size() && from.types[j] == to.types[i]) {
+            std::memcpy(column, src + from.offsets[j] + row * size, size);
+        } else {
+            std::memset(column, 0, size);
+        }
+    }
+
+    removeRow(source, chunk, row, result);
+    result[DST_CHUNK] = dstChunk;
+    result[DST_ROW] = dstRow;
+    result[NEW_CHUNK] = newChunk;
+    return true;
+}
+
+int32_t ArchetypeStore::addEntities(int32_t archetype, const int64_t* entities, int32_t count, int32_t* newChunks) {
+    if (count <= 0) return 0;
+    int32_t newChunkCount;
+    const int32_t first = appendRows(archetype, count, newChunks, newChunkCount);
+    if (first < 0) return -1;
+
+    const Archetype& a = archetypes[archetype];
+    for (int32_t index = first; index < first + count;) {
+        const int32_t chunk = a.chunks[index / a.capacity];
+        const int32_t row = index % a.capacity;
+        const int32_t rows = std::min(a.capacity - row, first + count - index);
+        uint8_t* memory = chunks[chunk].memory;
+
+        std::memcpy(this->entities(chunk) + row, entities + (index - first), rows * sizeof(int64_t));
+        for (size_t i = 0; i < a.types.size(); i++) {
+            if (a.sizes[i] > 0) {
+                std::memset(memory + a.offsets[i] + row * a.sizes[i], 0, rows * a.sizes[i]);
+            }
+        }
+        index += rows;
+    }
+    return newChunkCount;
+}
+
+int32_t ArchetypeStore::instantiate(int32_t chunk, int32_t row, const int64_t* entities, int32_t count,
+                                    int32_t* newChunks) {
+    if (count <= 0) return 0;
+    const int32_t archetype = chunks[chunk].archetype;
+    int32_t newChunkCount;
+    const int32_t first = appendRows(archetype, count, newChunks, newChunkCount);
+    if (first < 0) return -1;
+
+    // La memoria de un chunk no se mueve, así que la fila origen sigue válida
+    const Archetype& a = archetypes[archetype];
+    const uint8_t* source = chunks[chunk].memory;
+    for (int32_t index = first; index < first + count;) {
+        const int32_t dstChunk = a.chunks[index / a.capacity];
+        const int32_t dstRow = index % a.capacity;
+        const int32_t rows = std::min(a.capacity - dstRow, first + count - index);
+        uint8_t* memory = chunks[dstChunk].memory;
+
+        std::memcpy(this->entities(dstChunk) + dstRow, entities + (index - first), rows * sizeof(int64_t));
+        for (size_t i = 0; i < a.types.size(); i++) {
+            const int32_t size = a.sizes[i];
+            if (size == 0) continue;
+            uint8_t* column = memory + a.offsets[i] + dstRow * size;
+            std::memcpy(column, source + a.offsets[i] + row * size, size);
+            for (int32_t filled = 1; filled < rows;) {
+                int32_t copy = std::min(filled, rows - filled);
+                std::memcpy(column + filled * size, column, copy * size);
+                filled += copy;
+            }
+        }
+        index += rows;
+    }
+    return newChunkCount;
+}
+
+int32_t ArchetypeStore::moveEntities(const int32_t* chunks, const int32_t* rows, const int32_t* archetypes,
+                                     int32_t count, int32_t* results) {
+    for (int32_t i = 0; i < count; i++) {
+        int32_t* result = results + i * RESULT_INTS;
+        if (archetypes[i] < 0) {
+            removeEntity(chunks[i], rows[i], result);
+        } else if (!moveEntity(chunks[i], rows[i], archetypes[i], result)) {
+            return i;
+        }
+    }
+    return count;
+}
+
+void ArchetypeStore::removeEntity(int32_t chunk, int32_t row, int32_t* result) {
+    removeRow(chunks[chunk].archetype, chunk, row, result);
+    result[DST_CHUNK] = -1;
+    result[DST_ROW] = -1;
+    result[NEW_CHUNK] = -1;
+}
+
+void ArchetypeStore::clear() {
+    for (Archetype& archetype : archetypes) {
+        for (int32_t chunk : archetype.chunks) {
+            releaseChunk(chunk);
+        }
+        archetype.chunks.clear();
+        archetype.entityCount = 0;
+    }
+}
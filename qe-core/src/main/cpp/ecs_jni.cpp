@@ -0,0 +1,175 @@
+#include <jni.h>
+#include <android/log.h>
+#include "archetype_store.h"
+
+#define LOG_TAG "EcsJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * Acceso crítico a un array primitivo (ver math_jni.cpp)
+ */
+template <typename T>
+class CriticalArray {
+public:
+    CriticalArray(JNIEnv* env, jarray array, bool writable)
+        : env(env), array(array), writable(writable) {
+        if (array) {
+            data = static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr));
+        }
+    }
+
+    ~CriticalArray() {
+        if (data) {
+            env->ReleasePrimitiveArrayCritical(array, data, writable ? 0 : JNI_ABORT);
+        }
+    }
+
+    T* get() const { return data; }
+
+private:
+    JNIEnv* env;
+    jarray array;
+    bool writable;
+    T* data = nullptr;
+};
+
+typedef CriticalArray<jint> CriticalInts;
+typedef CriticalArray<jlong> CriticalLongs;
+
+static inline ArchetypeStore* getStore(jlong handle) {
+    return reinterpret_cast<ArchetypeStore*>(handle);
+}
+
+extern "C" {
+
+// ========== Lifecycle ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeCreate(
+    JNIEnv* env, jobject obj) {
+    LOGI("Creating native ArchetypeStore");
+    return reinterpret_cast<jlong>(new ArchetypeStore());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeDestroy(
+    JNIEnv* env, jobject obj, jlong handle) {
+    delete getStore(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeClear(
+    JNIEnv* env, jobject obj, jlong handle) {
+    getStore(handle)->clear();
+}
+
+// ========== Archetypes ==========
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeRegisterType(
+    JNIEnv* env, jobject obj, jlong handle, jint type, jint size) {
+    if (!getStore(handle)->registerType(type, size)) {
+        LOGE("Invalid component type %d (size %d)", type, size);
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeGetArchetype(
+    JNIEnv* env, jobject obj, jlong handle, jintArray types, jint count) {
+    int32_t ids[ArchetypeStore::MAX_TYPES];
+    if (count < 0 || count > ArchetypeStore::MAX_TYPES) return -1;
+    env->GetIntArrayRegion(types, 0, count, ids);
+    return getStore(handle)->getArchetype(ids, count);
+}
+
+/**
+ * Capacidad por chunk y offset de cada columna (-1 = gestionada), en el
+ * orden de tipos del archetype
+ */
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeGetArchetypeLayout(
+    JNIEnv* env, jobject obj, jlong handle, jint archetype, jintArray outOffsets) {
+    const ArchetypeStore::Archetype& info = getStore(handle)->getArchetypeInfo(archetype);
+    jsize count = static_cast<jsize>(info.offsets.size());
+    if (count > 0) {
+        env->SetIntArrayRegion(outOffsets, 0, count, info.offsets.data());
+    }
+    return info.capacity;
+}
+
+// ========== Entidades ==========
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeAddEntity(
+    JNIEnv* env, jobject obj, jlong handle, jint archetype, jlong entity, jintArray outResult) {
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    bool added = getStore(handle)->addEntity(archetype, entity, result);
+    env->SetIntArrayRegion(outResult, 0, ArchetypeStore::RESULT_INTS, result);
+    return added ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeMoveEntity(
+    JNIEnv* env, jobject obj, jlong handle, jint chunk, jint row, jint archetype, jintArray outResult) {
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    bool moved = getStore(handle)->moveEntity(chunk, row, archetype, result);
+    env->SetIntArrayRegion(outResult, 0, ArchetypeStore::RESULT_INTS, result);
+    return moved ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeRemoveEntity(
+    JNIEnv* env, jobject obj, jlong handle, jint chunk, jint row, jintArray outResult) {
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    getStore(handle)->removeEntity(chunk, row, result);
+    env->SetIntArrayRegion(outResult, 0, ArchetypeStore::RESULT_INTS, result);
+}
+
+// ========== Lotes (EntityCommandBuffer) ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeAddEntities(
+    JNIEnv* env, jobject obj, jlong handle, jint archetype, jlongArray entities, jint count,
+    jintArray outNewChunks) {
+    CriticalLongs ids(env, entities, false);
+    CriticalInts newChunks(env, outNewChunks, true);
+    return getStore(handle)->addEntities(archetype, ids.get(), count, newChunks.get());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeInstantiate(
+    JNIEnv* env, jobject obj, jlong handle, jint chunk, jint row, jlongArray entities, jint count,
+    jintArray outNewChunks) {
+    CriticalLongs ids(env, entities, false);
+    CriticalInts newChunks(env, outNewChunks, true);
+    return getStore(handle)->instantiate(chunk, row, ids.get(), count, newChunks.get());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeMoveEntities(
+    JNIEnv* env, jobject obj, jlong handle, jintArray chunks, jintArray rows, jintArray archetypes,
+    jint count, jintArray outResults) {
+    CriticalInts chunkData(env, chunks, false);
+    CriticalInts rowData(env, rows, false);
+    CriticalInts archetypeData(env, archetypes, false);
+    CriticalInts results(env, outResults, true);
+    return getStore(handle)->moveEntities(chunkData.get(), rowData.get(), archetypeData.get(), count, results.get());
+}
+
+// ========== Chunks ==========
+
+/**
+ * Los CHUNK_BYTES del chunk como ByteBuffer directo: Kotlin lee y escribe
+ * las columnas sin copias. La memoria de un chunk no se mueve ni se libera
+ * hasta destruir el store, aunque el chunk vuelva al pool.
+ */
+JNIEXPORT jobject JNICALL
+Java_com_quantum_engine_core_ecs_ArchetypeStore_nativeGetChunkMemory(
+    JNIEnv* env, jobject obj, jlong handle, jint chunk) {
+    return env->NewDirectByteBuffer(getStore(handle)->getChunkMemory(chunk), ArchetypeStore::CHUNK_BYTES);
+}
+
+} // extern "C"
@@ -0,0 +1,174 @@
+#ifndef ARCHETYPE_STORE_H
+#define ARCHETYPE_STORE_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * Almacén de entidades por archetype en chunks de 16KB
+ *
+ * Cada archetype (conjunto ordenado de tipos de componente) guarda sus
+ * entidades en chunks de CHUNK_BYTES con una columna SoA por tipo: primero
+ * los ids de entidad (int64) y después una columna por tipo nativo (blittable),
+ * cada una alineada a COLUMN_ALIGNMENT. Los tipos gestionados (objetos de
+ * Kotlin) no ocupan memoria aquí: Kotlin los guarda en arrays por chunk con
+ * las mismas filas, y cuentan REFERENCE_BYTES para la capacidad.
+ *
+ * Las entidades de un archetype están densas: la i-ésima está en el chunk
+ * i / capacidad, fila i % capacidad. Quitar una mueve la última a su hueco,
+ * así que sólo el último chunk está a medias; se guarda como mucho un chunk
+ * vacío de repuesto por archetype y los demás vuelven al pool.
+ *
+ * Las operaciones estructurales escriben en result (RESULT_INTS enteros)
+ * dónde quedó la entidad y qué fila se movió, para que Kotlin repita el
+ * movimiento en sus columnas gestionadas.
+ */
+class ArchetypeStore {
+public:
+    static constexpr int32_t CHUNK_BYTES = 16 * 1024;
+    static constexpr int32_t COLUMN_ALIGNMENT = 16;
+    static constexpr int32_t ENTITY_BYTES = 8;
+    static constexpr int32_t REFERENCE_BYTES = 4;
+    static constexpr int32_t MAX_TYPES = 256;          // ComponentMask de Kotlin
+
+    // Resultado de add / move / remove
+    enum Result : int32_t {
+        DST_CHUNK = 0,          // chunk y fila nuevos de la entidad (-1 al quitarla)
+        DST_ROW = 1,
+        HOLE_CHUNK = 2,         // fila que dejó libre
+        HOLE_ROW = 3,
+        FROM_CHUNK = 4,         // fila movida al hueco (-1 si era la última)
+        FROM_ROW = 5,
+        NEW_CHUNK = 6,          // chunk reservado por la operación o -1
+        FREED_CHUNK = 7,        // chunk devuelto al pool o -1
+        RESULT_INTS = 8
+    };
+
+    struct Archetype {
+        std::vector<int32_t> types;             // ordenados
+        std::vector<int32_t> sizes;             // bytes por entidad; 0 = gestionado
+        std::vector<int32_t> offsets;           // columna en el chunk; -1 = gestionado
+        int32_t capacity = 0;                   // entidades por chunk
+        int32_t entityCount = 0;
+        std::vector<int32_t> chunks;            // en orden; el último puede ser el de repuesto
+    };
+
+    struct Chunk {
+        uint8_t* memory = nullptr;
+        int32_t archetype = -1;                 // -1 = libre
+        int32_t count = 0;
+    };
+
+    ArchetypeStore();
+    ~ArchetypeStore();
+
+    ArchetypeStore(const ArchetypeStore&) = delete;
+    ArchetypeStore& operator=(const ArchetypeStore&) = delete;
+
+    /**
+     * Tamaño de un tipo de componente; 0 = gestionado por Kotlin. Un tipo no
+     * cambia de tamaño una vez usado en un archetype.
+     *
+     * @return false si el id está fuera de rango o ya tenía otro tamaño
+     */
+    bool registerType(int32_t type, int32_t size);
+
+    /**
+     * Archetype con esos tipos (en cualquier orden, sin repetir), creado si
+     * no existía
+     *
+     * @return Índice del archetype o -1 si algún tipo no está registrado o
+     *         una fila no cabe en un chunk
+     */
+    int32_t getArchetype(const int32_t* types, int32_t count);
+
+    int32_t getArchetypeCount() const { return static_cast<int32_t>(archetypes.size()); }
+    const Archetype& getArchetypeInfo(int32_t archetype) const { return archetypes[archetype]; }
+
+    /**
+     * Añade la entidad al final del archetype
+     *
+     * @return false (y result a -1, sin cambios) si no hay memoria para un chunk
+     */
+    bool addEntity(int32_t archetype, int64_t entity, int32_t* result);
+
+    /**
+     * Lleva la fila al final de otro archetype copiando las columnas nativas
+     * de los tipos comunes; las de tipos nuevos quedan a cero
+     *
+     * @return false (y result a -1, sin cambios) si no hay memoria para un chunk
+     */
+    bool moveEntity(int32_t chunk, int32_t row, int32_t archetype, int32_t* result);
+
+    void removeEntity(int32_t chunk, int32_t row, int32_t* result);
+
+    /**
+     * Añade count entidades al final del archetype: los ids con un memcpy y
+     * las columnas nativas a cero con un memset por columna y chunk
+     *
+     * @param newChunks Chunks reservados, en orden (hasta count / capacidad + 1)
+     * @return Número de chunks reservados, o -1 sin cambios si no hay memoria
+     */
+    int32_t addEntities(int32_t archetype, const int64_t* entities, int32_t count, int32_t* newChunks);
+
+    /**
+     * Añade count copias de la fila (chunk, row) al final de su archetype: en
+     * cada chunk destino se copia la fila una vez y se duplica el bloque
+     * copiado hasta llenar el rango, así que son O(log n) memcpy por columna
+     *
+     * @return Como addEntities
+     */
+    int32_t instantiate(int32_t chunk, int32_t row, const int64_t* entities, int32_t count, int32_t* newChunks);
+
+    /**
+     * moveEntity / removeEntity en lote: la fila (chunks[i], rows[i]) pasa a
+     * archetypes[i] o se quita si es -1, con RESULT_INTS enteros por entidad
+     * en results. Las posiciones se aplican en orden, así que deben seguir
+     * siendo válidas tras las operaciones anteriores (p. ej. de la última
+     * fila a la primera dentro de cada archetype origen).
+     *
+     * @return Operaciones aplicadas; menos de count si un chunk no se pudo reservar
+     */
+    int32_t moveEntities(const int32_t* chunks, const int32_t* rows, const int32_t* archetypes,
+                         int32_t count, int32_t* results);
+
+    /** Vacía todos los archetypes y devuelve sus chunks al pool */
+    void clear();
+
+    int32_t getChunkCount() const { return static_cast<int32_t>(chunks.size()); }
+    const Chunk& getChunk(int32_t chunk) const { return chunks[chunk]; }
+    uint8_t* getChunkMemory(int32_t chunk) const { return chunks[chunk].memory; }
+
+    int64_t* entities(int32_t chunk) const {
+        return reinterpret_cast<int64_t*>(chunks[chunk].memory);
+    }
+
+private:
+    std::vector<int32_t> typeSizes;             // -1 = sin registrar
+    std::vector<Archetype> archetypes;
+    std::map<std::vector<int32_t>, int32_t> archetypesByTypes;
+
+    std::vector<Chunk> chunks;
+    std::vector<int32_t> freeChunks;            // índices libres con su memoria
+
+    int32_t allocateChunk(int32_t archetype);
+    void releaseChunk(int32_t chunk);
+
+    /** Reserva la fila del final del archetype; false si no hay memoria */
+    bool appendRow(int32_t archetype, int32_t& chunk, int32_t& row, int32_t& newChunk);
+
+    /**
+     * Reserva count filas al final del archetype
+     *
+     * @return Índice de la primera fila en el archetype, o -1 sin cambios si no hay memoria
+     */
+    int32_t appendRows(int32_t archetype, int32_t count, int32_t* newChunks, int32_t& newChunkCount);
+
+    /**
+     * Mueve la última fila del archetype a (chunk, row) y la quita del final
+     */
+    void removeRow(int32_t archetype, int32_t chunk, int32_t row, int32_t* result);
+};
+
+#endif // ARCHETYPE_STORE_H
@@ -0,0 +1,404 @@
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Allocators sin reservas en el heap en régimen estable
+ *
+ * Header-only como job_scheduler.h: cualquier librería nativa del motor lo
+ * incluye sin enlazar con libquantum_core.
+ *
+ * - LinearArena: bump allocator con marcas; se libera entero de una vez
+ * - FrameArena: una LinearArena por frame en vuelo, reseteada al retirarlo
+ * - ScratchScope: pila de scratch por hilo, liberada al salir del scope
+ * - FixedPool: bloques de tamaño fijo con free list (handles, objetos pequeños)
+ *
+ * Ninguno toma locks: quien comparta uno entre hilos lo protege.
+ */
+
+/**
+ * Contadores de un allocator desde el último takeStats()
+ *
+ * heapAllocations cuenta las veces que hubo que ir al heap (desbordes de una
+ * arena, páginas nuevas de un pool): en un frame estable es cero.
+ */
+struct AllocatorStats {
+    uint32_t allocations = 0;
+    uint32_t heapAllocations = 0;
+    uint64_t bytes = 0;
+    uint64_t peakBytes = 0;
+
+    void add(const AllocatorStats& other) {
+        allocations += other.allocations;
+        heapAllocations += other.heapAllocations;
+        bytes += other.bytes;
+        if (other.peakBytes > peakBytes) peakBytes = other.peakBytes;
+    }
+};
+
+/**
+ * LinearArena - Bump allocator sobre un bloque fijo
+ *
+ * allocate() sólo avanza un offset. Si no cabe, la reserva sale del heap en
+ * un bloque de desborde (contado en heapAllocations) y reset() agranda el
+ * bloque principal hasta el máximo visto: tras unos frames de calentamiento
+ * no vuelve a reservar. No llama a destructores: sólo para tipos triviales
+ * o cuyo destructor no importe.
+ */
+class LinearArena {
+public:
+    struct Marker {
+        size_t offset;
+        void* overflow;
+    };
+
+    /**
+     * @param capacity Bloque inicial (no cuenta como ida al heap)
+     * @param heapCounter Además de stats, cada ida al heap lo incrementa (p. ej. compartido entre hilos)
+     */
+    explicit LinearArena(size_t capacity = 0, std::atomic<uint32_t>* heapCounter = nullptr)
+        : heapCounter(heapCounter) {
+        grow(capacity);
+    }
+
+    ~LinearArena() {
+        releaseOverflow(nullptr);
+        std::free(buffer);
+    }
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+        uintptr_t start = (base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t end = static_cast<size_t>(start - base) + size;
+
+        stats.allocations++;
+        stats.bytes += size;
+
+        if (buffer && end <= capacity) {
+            offset = end;
+            notePeak();
+            return reinterpret_cast<void*>(start);
+        }
+        return allocateOverflow(size, alignment);
+    }
+
+    /** count elementos sin inicializar */
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "LinearArena no llama a destructores");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    Marker getMarker() const { return { offset, overflow }; }
+
+    /** Libera todo lo reservado después de marker */
+    void rewind(const Marker& marker) {
+        releaseOverflow(static_cast<OverflowBlock*>(marker.overflow));
+        offset = marker.offset;
+    }
+
+    /**
+     * Libera todo; si hubo desbordes, agranda el bloque para que la misma
+     * carga quepa entera la próxima vez
+     */
+    void reset() {
+        size_t required = highWater;
+        releaseOverflow(nullptr);
+        offset = 0;
+        highWater = 0;
+
+        if (required > capacity) {
+            grow(required + required / 4);
+            noteHeapAllocation();
+        }
+    }
+
+    /** Contadores desde la última llamada */
+    AllocatorStats takeStats() {
+        AllocatorStats result = stats;
+        stats = AllocatorStats();
+        stats.peakBytes = offset + overflowBytes;
+        return result;
+    }
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return offset + overflowBytes; }
+
+private:
+    struct OverflowBlock {
+        OverflowBlock* next;
+        size_t size;
+    };
+
+    uint8_t* buffer = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t highWater = 0;                   // offset + desbordes, máximo desde reset()
+    OverflowBlock* overflow = nullptr;      // pila de bloques de desborde
+    size_t overflowBytes = 0;
+    AllocatorStats stats;
+    std::atomic<uint32_t>* heapCounter;
+
+    void notePeak() {
+        size_t used = offset + overflowBytes;
+        if (used > highWater) highWater = used;
+        if (used > stats.peakBytes) stats.peakBytes = used;
+    }
+
+    void noteHeapAllocation() {
+        stats.heapAllocations++;
+        if (heapCounter) heapCounter->fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void grow(size_t newCapacity) {
+        std::free(buffer);
+        buffer = nullptr;
+        capacity = 0;
+        if (newCapacity == 0) return;
+
+        buffer = static_cast<uint8_t*>(std::malloc(newCapacity));
+        if (!buffer) throw std::bad_alloc();
+        capacity = newCapacity;
+    }
+
+    void* allocateOverflow(size_t size, size_t alignment) {
+        size_t blockSize = sizeof(OverflowBlock) + alignment + size;
+        OverflowBlock* block = static_cast<OverflowBlock*>(std::malloc(blockSize));
+        if (!block) throw std::bad_alloc();
+        noteHeapAllocation();
+
+        block->next = overflow;
+        block->size = size + alignment;
+        overflow = block;
+        overflowBytes += block->size;
+        notePeak();
+
+        uintptr_t data = reinterpret_cast<uintptr_t>(block + 1);
+        return reinterpret_cast<void*>((data + alignment - 1) & ~(uintptr_t)(alignment - 1));
+    }
+
+    void releaseOverflow(OverflowBlock* until) {
+        while (overflow && overflow != until) {
+            OverflowBlock* next = overflow->next;
+            overflowBytes -= overflow->size;
+            std::free(overflow);
+            overflow = next;
+        }
+    }
+};
+
+/**
+ * FrameArena - Memoria que vive exactamente un frame
+ *
+ * Una LinearArena por frame en vuelo. beginFrame() pasa a la del frame que se
+ * acaba de retirar (su fence ya se esperó) y la resetea, así lo reservado en
+ * un frame sigue válido mientras la GPU pueda leerlo.
+ */
+class FrameArena {
+public:
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    explicit FrameArena(size_t capacity, uint32_t framesInFlight = 1)
+        : frameCount(std::max(1u, std::min(framesInFlight, MAX_FRAMES_IN_FLIGHT))) {
+        for (uint32_t i = 0; i < frameCount; i++) {
+            frames[i].reset(new LinearArena(capacity));
+        }
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /** Llamar cuando el frame más antiguo en vuelo se ha retirado */
+    void beginFrame() {
+        lastFrameStats = frames[current]->takeStats();
+        current = (current + 1) % frameCount;
+        frames[current]->reset();
+    }
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return frames[current]->allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return frames[current]->allocateArray<T>(count);
+    }
+
+    /** Contadores del frame anterior, completos */
+    const AllocatorStats& getLastFrameStats() const { return lastFrameStats; }
+
+    size_t getCapacity() const { return frames[current]->getCapacity(); }
+
+private:
+    std::unique_ptr<LinearArena> frames[MAX_FRAMES_IN_FLIGHT];
+    uint32_t frameCount;
+    uint32_t current = 0;
+    AllocatorStats lastFrameStats;
+};
+
+/**
+ * ScratchStack - Pila de memoria temporal por hilo
+ *
+ * Para buffers cuyo tamaño depende de los datos y que no salen de la
+ * función (enumeraciones de Vulkan, órdenes de un sort). Se usa a través de
+ * ScratchScope; la pila del hilo se reserva la primera vez y crece cuando
+ * el scope más externo se cierra tras un desborde.
+ */
+class ScratchStack {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    static LinearArena& current() {
+        thread_local LinearArena arena(DEFAULT_CAPACITY, &heapAllocations());
+        return arena;
+    }
+
+    /** Idas al heap de las pilas de todos los hilos (de esta librería) */
+    static std::atomic<uint32_t>& heapAllocations() {
+        static std::atomic<uint32_t> counter{0};
+        return counter;
+    }
+
+    /** Idas al heap desde la última llamada */
+    static uint32_t takeHeapAllocations() {
+        return heapAllocations().exchange(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * ScratchScope - Todo lo reservado en él se libera al destruirlo
+ */
+class ScratchScope {
+public:
+    ScratchScope()
+        : arena(ScratchStack::current()), marker(arena.getMarker()) {}
+
+    ~ScratchScope() {
+        if (marker.offset == 0 && marker.overflow == nullptr) {
+            // Scope más externo: la pila queda vacía y puede crecer
+            arena.reset();
+        } else {
+            arena.rewind(marker);
+        }
+    }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return arena.allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return arena.allocateArray<T>(count);
+    }
+
+private:
+    LinearArena& arena;
+    LinearArena::Marker marker;
+};
+
+/**
+ * FixedPool - Objetos de un tipo en páginas de BLOCKS_PER_PAGE
+ *
+ * create()/destroy() son un pop/push en una free list intrusiva; sólo se va
+ * al heap cuando se agotan las páginas, que nunca se devuelven hasta
+ * destruir el pool. Pensado para handles que Kotlin crea y destruye cada
+ * frame y objetos pequeños de vida corta.
+ */
+template <typename T, size_t BLOCKS_PER_PAGE = 256>
+class FixedPool {
+public:
+    FixedPool() = default;
+
+    ~FixedPool() {
+        while (pages) {
+            Page* next = pages->next;
+            delete pages;
+            pages = next;
+        }
+    }
+
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        if (!freeList) addPage();
+
+        Slot* slot = freeList;
+        freeList = slot->next;
+        liveCount++;
+        stats.allocations++;
+        stats.bytes += sizeof(T);
+        if (liveCount * sizeof(T) > stats.peakBytes) stats.peakBytes = liveCount * sizeof(T);
+
+        return new (slot->storage) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) {
+        if (!object) return;
+        object->~T();
+
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList = slot;
+        liveCount--;
+    }
+
+    size_t getLiveCount() const { return liveCount; }
+    size_t getCapacity() const { return pageCount * BLOCKS_PER_PAGE; }
+
+    AllocatorStats takeStats() {
+        AllocatorStats result = stats;
+        stats = AllocatorStats();
+        stats.peakBytes = liveCount * sizeof(T);
+        return result;
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Page {
+        Page* next;
+        Slot slots[BLOCKS_PER_PAGE];
+    };
+
+    Page* pages = nullptr;
+    Slot* freeList = nullptr;
+    size_t pageCount = 0;
+    size_t liveCount = 0;
+    AllocatorStats stats;
+
+    void addPage() {
+        Page* page = new Page;
+        page->next = pages;
+        pages = page;
+        pageCount++;
+        stats.heapAllocations++;
+
+        // En orden inverso: los primeros create() salen en orden de dirección
+        for (size_t i = BLOCKS_PER_PAGE; i-- > 0;) {
+            page->slots[i].next = freeList;
+            freeList = &page->slots[i];
+        }
+    }
+};
+
+#endif // FRAME_ALLOCATOR_H
@@ -0,0 +1,84 @@
+#ifndef JOB_SCHEDULER_H
+#define JOB_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+struct Job;
+
+/**
+ * Contador de jobs pendientes
+ *
+ * Cada job programado con un contador lo incrementa y lo decrementa al
+ * terminar; wait() espera a cero ayudando con otros jobs. Los jobs
+ * programados con scheduleAfter() se lanzan cuando llega a cero, así se
+ * expresan las dependencias sin bloquear ningún hilo. Reutilizable cuando
+ * vuelve a cero.
+ *
+ * count vale -1 mientras el último finish() recoge las continuaciones; sólo
+ * cuenta como terminado al llegar a 0.
+ */
+struct JobCounter {
+    std::atomic<int32_t> count{0};
+    std::atomic<Job*> continuations{nullptr};   // lista enlazada de jobs en espera
+};
+
+/**
+ * Interfaz del scheduler compartido
+ *
+ * La implementa JobSystem en libquantum_core; las demás librerías nativas
+ * (física, culling, animación) sólo incluyen este header y reciben el
+ * puntero como handle jlong desde Kotlin, así todo el motor reparte trabajo
+ * entre los mismos hilos sin sobresuscribir núcleos.
+ */
+class JobScheduler {
+public:
+    typedef void (*JobFunction)(void* context, int32_t begin, int32_t end);
+
+    virtual ~JobScheduler() = default;
+
+    /** Workers además de los hilos que esperan (que también ejecutan jobs) */
+    virtual int32_t getWorkerCount() const = 0;
+
+    /**
+     * Programa function(context, begin, end); counter (opcional) se
+     * incrementa ya y se decrementa al terminar
+     */
+    virtual void schedule(JobFunction function, void* context, int32_t begin, int32_t end,
+                          JobCounter* counter) = 0;
+
+    /**
+     * Como schedule() pero no se lanza hasta que dependency llegue a cero
+     */
+    virtual void scheduleAfter(JobCounter* dependency, JobFunction function, void* context,
+                               int32_t begin, int32_t end, JobCounter* counter) = 0;
+
+    /**
+     * function(context, begin, end) para cada lote de batchSize elementos de
+     * [0, count), repartidos de forma adaptativa: un rango sólo se parte
+     * cuando hay hilos sin trabajo. Los lotes son siempre los mismos, así
+     * que el resultado no depende del número de hilos si cada lote escribe
+     * sólo sus salidas. counter (opcional) se decrementa al terminar todo;
+     * sin counter, bloquea ayudando hasta el final.
+     */
+    virtual void parallelFor(int32_t count, int32_t batchSize, JobFunction function, void* context,
+                             JobCounter* counter) = 0;
+
+    /** Espera a que counter llegue a cero ejecutando jobs mientras tanto */
+    virtual void wait(JobCounter* counter) = 0;
+
+    /**
+     * body(begin, end) por lotes, bloqueante; admite anidarse dentro de
+     * otros jobs
+     */
+    template <typename F>
+    void parallelFor(int32_t count, int32_t batchSize, F&& body) {
+        using Body = typename std::remove_reference<F>::type;
+        parallelFor(count, batchSize, [](void* context, int32_t begin, int32_t end) {
+            (*static_cast<Body*>(context))(begin, end);
+        }, const_cast<void*>(static_cast<const void*>(&body)), nullptr);
+    }
+};
+
+#endif // JOB_SCHEDULER_H
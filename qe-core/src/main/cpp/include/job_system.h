@@ -0,0 +1,151 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "job_scheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Job - Unidad de trabajo del scheduler
+ *
+ * batchSize > 0 marca un rango de parallelFor, que se parte en lotes de ese
+ * tamaño; si no, function recibe [begin, end) tal cual.
+ */
+struct Job {
+    JobScheduler::JobFunction function;
+    void* context;
+    int32_t begin;
+    int32_t end;
+    int32_t batchSize;
+    JobCounter* counter;
+    Job* next;          // siguiente continuación del mismo contador
+    bool pooled;        // vuelve al pool compartido al terminar
+    std::atomic<bool> live{false};      // hueco del anillo en uso hasta que el job termina
+};
+
+/**
+ * Deque Chase–Lev de capacidad fija
+ *
+ * El dueño hace push/pop por detrás sin locks (sólo compite con los ladrones
+ * por el último elemento); los demás hilos roban por delante con un CAS.
+ */
+class WorkDeque {
+public:
+    static constexpr int64_t CAPACITY = 4096;
+
+    /** false si está lleno (el llamador ejecuta el job en el sitio) */
+    bool push(Job* job);
+    Job* pop();
+    Job* steal();
+
+    bool isEmpty() const {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<Job*> buffer[CAPACITY];
+};
+
+/**
+ * JobSystem - Scheduler nativo con robo de trabajo
+ *
+ * Un WorkDeque y un anillo de jobs por worker, así que programar desde un
+ * worker no reserva memoria ni toma locks. Los hilos externos (el de
+ * render, los de Kotlin) programan en una cola de inyección con mutex y,
+ * cuando esperan, roban como un worker más. Los workers sin trabajo giran
+ * un poco y luego duermen hasta el siguiente push.
+ *
+ * Los huecos del anillo se reutilizan en orden circular saltando los de
+ * jobs que no han terminado (robados y aún en curso, o esperando en un
+ * deque); con el anillo entero vivo se reserva del pool compartido. Las
+ * continuaciones de scheduleAfter() usan siempre el pool compartido.
+ */
+class JobSystem : public JobScheduler {
+public:
+    typedef void (*ThreadCallback)();
+
+    /**
+     * @param workerCount Hilos de trabajo; -1 = núcleos - 1
+     * @param pinThreads Fija el worker i al núcleo i + 1 (el 0 queda para el
+     *                   hilo principal); sólo si el proceso tiene todos los núcleos
+     * @param onWorkerExit Llamado por cada worker antes de terminar (p. ej. DetachCurrentThread)
+     */
+    explicit JobSystem(int32_t workerCount = -1, bool pinThreads = false,
+                       ThreadCallback onWorkerExit = nullptr);
+    ~JobSystem() override;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    static constexpr uint32_t RING_SIZE = 4096;
+
+    using JobScheduler::parallelFor;
+
+    int32_t getWorkerCount() const override { return static_cast<int32_t>(workers.size()); }
+
+    void schedule(JobFunction function, void* context, int32_t begin, int32_t end,
+                  JobCounter* counter) override;
+    void scheduleAfter(JobCounter* dependency, JobFunction function, void* context,
+                       int32_t begin, int32_t end, JobCounter* counter) override;
+    void parallelFor(int32_t count, int32_t batchSize, JobFunction function, void* context,
+                     JobCounter* counter) override;
+    void wait(JobCounter* counter) override;
+
+private:
+    struct alignas(64) Worker {
+        WorkDeque deque;
+        Job ring[RING_SIZE];
+        uint32_t ringNext = 0;
+        uint32_t random = 0;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    ThreadCallback onWorkerExit;
+
+    // Cola de los hilos externos
+    std::mutex injectionMutex;
+    std::deque<Job*> injection;
+    std::atomic<int32_t> injectionSize{0};
+
+    // Jobs de hilos externos y continuaciones
+    std::mutex poolMutex;
+    std::vector<Job*> freeJobs;
+    std::vector<std::unique_ptr<Job[]>> jobBlocks;
+
+    // Workers dormidos
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<int32_t> sleepers{0};
+    uint64_t wakeSignals = 0;
+    std::atomic<bool> stopping{false};
+
+    int32_t currentWorker() const;
+    Job* allocate(int32_t worker);
+    void release(Job* job);
+    void submit(Job* job, int32_t worker);
+    void wakeOne();
+    bool hasWork();
+
+    Job* findJob(int32_t worker);
+    Job* popInjection();
+    Job* stealFrom(int32_t thief);
+    void execute(Job* job, int32_t worker);
+    void runRange(JobFunction function, void* context, int32_t begin, int32_t end,
+                  int32_t batchSize, JobCounter* counter, int32_t worker);
+
+    void addCount(JobCounter* counter, int32_t count);
+    void finish(JobCounter* counter);
+    void launchContinuations(Job* list);
+
+    void workerLoop(int32_t index, bool pin);
+};
+
+#endif // JOB_SYSTEM_H
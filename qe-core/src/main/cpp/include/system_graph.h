@@ -0,0 +1,93 @@
+#ifndef SYSTEM_GRAPH_H
+#define SYSTEM_GRAPH_H
+
+#include "job_scheduler.h"
+#include <memory>
+#include <vector>
+
+/**
+ * Grafo de dependencias de los sistemas de una etapa del frame
+ *
+ * Los sistemas llegan en orden de prioridad con las máscaras de componentes
+ * que leen y escriben (MASK_WORDS palabras, un bit por ComponentType). Hay
+ * arista i -> j (i antes que j) si uno escribe algo que el otro lee o
+ * escribe; los demás pares pueden correr a la vez. Así el resultado es el
+ * mismo que ejecutarlos en orden.
+ *
+ * Los sistemas exclusivos parten la etapa en tramos: cada uno corre solo, en
+ * el hilo que llama a run() (pueden no ser seguros fuera de él), después de
+ * que termine todo lo anterior y antes de que empiece nada posterior. Las
+ * aristas sólo unen nodos del mismo tramo.
+ *
+ * rank es el coste del camino más largo desde el nodo hasta el final de su
+ * tramo. run() lanza primero los nodos de mayor rank: la cadena crítica (p.
+ * ej. física -> transformaciones) empieza cuanto antes y los sistemas cortos
+ * rellenan los huecos. Sin reservas de memoria por frame una vez alcanzado
+ * el tamaño.
+ */
+class SystemGraph {
+public:
+    static constexpr int32_t MASK_WORDS = 4;            // 256 tipos, como ComponentMask
+
+    /**
+     * @param reads,writes MASK_WORDS palabras por sistema
+     * @param exclusive Sistemas que corren solos en el hilo de run()
+     * @param costs Coste estimado de cada sistema (ns)
+     */
+    void build(int32_t count, const uint64_t* reads, const uint64_t* writes,
+               const uint8_t* exclusive, const int64_t* costs);
+
+    /**
+     * function(context, i, i + 1) para cada sistema i en scheduler,
+     * respetando las aristas, y para los exclusivos en este hilo; bloquea
+     * ayudando hasta el final. Pensado para llamarse desde fuera de los
+     * workers (el hilo de juego).
+     */
+    void run(JobScheduler& scheduler, JobScheduler::JobFunction function, void* context);
+
+    int32_t getCount() const { return static_cast<int32_t>(nodes.size()); }
+    int32_t getEdgeCount() const { return static_cast<int32_t>(successors.size()); }
+
+    /**
+     * Coste del camino crítico (suma de los tramos y los exclusivos): el
+     * mínimo de la etapa con hilos de sobra (ns)
+     */
+    int64_t getCriticalPath() const { return criticalPath; }
+
+private:
+    struct Node {
+        int32_t firstSuccessor = 0;
+        int32_t successorCount = 0;
+        int32_t predecessorCount = 0;
+        int64_t rank = 0;
+    };
+
+    // Tramo de nodos paralelos [first, end) o un nodo exclusivo
+    struct Segment {
+        int32_t first = 0;
+        int32_t end = 0;
+        int32_t firstRoot = 0;
+        int32_t rootCount = 0;
+        bool exclusive = false;
+    };
+
+    struct RunState {
+        SystemGraph* graph;
+        JobScheduler* scheduler;
+        JobScheduler::JobFunction function;
+        void* context;
+        JobCounter done;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int32_t> successors;        // por nodo, de menor a mayor rank
+    std::vector<int32_t> roots;             // por tramo, de mayor a menor rank
+    std::vector<Segment> segments;
+    std::unique_ptr<std::atomic<int32_t>[]> remaining;     // predecesores sin terminar
+    int32_t remainingCapacity = 0;
+    int64_t criticalPath = 0;
+
+    static void runNode(void* context, int32_t node, int32_t end);
+};
+
+#endif // SYSTEM_GRAPH_H
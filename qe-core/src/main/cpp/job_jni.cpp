@@ -0,0 +1,287 @@
+#include <jni.h>
+#include <android/log.h>
+#include "frame_allocator.h"
+#include "job_system.h"
+#include "system_graph.h"
+#include <mutex>
+
+#define LOG_TAG "JobJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+JavaVM* javaVM = nullptr;
+jmethodID runMethod = nullptr;      // JobBody.run(begin, end)
+
+// Workers adjuntados a la JVM la primera vez que ejecutan un job de Kotlin
+thread_local JNIEnv* workerEnv = nullptr;
+thread_local bool workerAttached = false;
+
+JNIEnv* currentEnv() {
+    if (workerEnv) return workerEnv;
+
+    JNIEnv* env = nullptr;
+    if (javaVM->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) {
+        workerEnv = env;
+        return env;
+    }
+    if (javaVM->AttachCurrentThreadAsDaemon(&env, nullptr) != JNI_OK) {
+        LOGE("Failed to attach worker thread");
+        return nullptr;
+    }
+    workerEnv = env;
+    workerAttached = true;
+    return env;
+}
+
+void detachWorker() {
+    if (workerAttached) {
+        javaVM->DetachCurrentThread();
+        workerAttached = false;
+    }
+    workerEnv = nullptr;
+}
+
+/**
+ * Job de Kotlin: referencia global al JobBody y contador de sus lotes, que
+ * libera la referencia cuando llega a cero
+ */
+struct KotlinJob {
+    jobject body;
+    JobCounter pending;
+};
+
+/**
+ * Jobs de Kotlin y contadores se crean y destruyen cada frame desde
+ * cualquier hilo: salen de pools en vez del heap
+ */
+std::mutex poolMutex;
+FixedPool<KotlinJob> kotlinJobPool;
+FixedPool<JobCounter> counterPool;
+
+KotlinJob* createKotlinJob(JNIEnv* env, jobject body) {
+    KotlinJob* job;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        job = kotlinJobPool.create();
+    }
+    job->body = env->NewGlobalRef(body);
+    return job;
+}
+
+void destroyKotlinJob(KotlinJob* job) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    kotlinJobPool.destroy(job);
+}
+
+void runBody(void* context, int32_t begin, int32_t end) {
+    JNIEnv* env = currentEnv();
+    if (!env) return;
+
+    env->CallVoidMethod(static_cast<KotlinJob*>(context)->body, runMethod, begin, end);
+    if (env->ExceptionCheck()) {
+        // No hay a quién propagarla desde un worker
+        LOGE("Exception in job body");
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+}
+
+void releaseKotlinJob(void* context, int32_t begin, int32_t end) {
+    KotlinJob* job = static_cast<KotlinJob*>(context);
+    if (JNIEnv* env = currentEnv()) {
+        env->DeleteGlobalRef(job->body);
+    }
+    destroyKotlinJob(job);
+}
+
+inline JobSystem* getSystem(jlong handle) {
+    return static_cast<JobSystem*>(reinterpret_cast<JobScheduler*>(handle));
+}
+
+inline JobCounter* getCounter(jlong handle) {
+    return reinterpret_cast<JobCounter*>(handle);
+}
+
+inline SystemGraph* getGraph(jlong handle) {
+    return reinterpret_cast<SystemGraph*>(handle);
+}
+
+/**
+ * Acceso crítico a un array primitivo (ver math_jni.cpp)
+ */
+template <typename T>
+class CriticalArray {
+public:
+    CriticalArray(JNIEnv* env, jarray array)
+        : env(env), array(array) {
+        if (array) {
+            data = static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr));
+        }
+    }
+
+    ~CriticalArray() {
+        if (data) {
+            env->ReleasePrimitiveArrayCritical(array, data, JNI_ABORT);
+        }
+    }
+
+    T* get() const { return data; }
+
+private:
+    JNIEnv* env;
+    jarray array;
+    T* data = nullptr;
+};
+
+} // namespace
+
+extern "C" {
+
+// ========== Lifecycle ==========
+
+/**
+ * El handle es un JobScheduler*: las demás librerías nativas lo reciben tal
+ * cual y programan en los mismos workers
+ */
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeCreate(
+    JNIEnv* env, jobject obj, jint workerCount, jboolean pinThreads) {
+    if (!javaVM) {
+        env->GetJavaVM(&javaVM);
+        jclass bodyClass = env->FindClass("com/quantum/engine/jobs/JobBody");
+        runMethod = env->GetMethodID(bodyClass, "run", "(II)V");
+        env->DeleteLocalRef(bodyClass);
+    }
+
+    JobSystem* system = new JobSystem(workerCount, pinThreads == JNI_TRUE, detachWorker);
+    LOGI("Native job system: %d workers", system->getWorkerCount());
+    return reinterpret_cast<jlong>(static_cast<JobScheduler*>(system));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeDestroy(
+    JNIEnv* env, jobject obj, jlong handle) {
+    delete getSystem(handle);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeGetWorkerCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getSystem(handle)->getWorkerCount();
+}
+
+// ========== Contadores ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_jobs_JobCounter_nativeCreate(
+    JNIEnv* env, jobject obj) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return reinterpret_cast<jlong>(counterPool.create());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_jobs_JobCounter_nativeDestroy(
+    JNIEnv* env, jobject obj, jlong counter) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    counterPool.destroy(getCounter(counter));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_jobs_JobCounter_nativeIsDone(
+    JNIEnv* env, jobject obj, jlong counter) {
+    return getCounter(counter)->count.load(std::memory_order_acquire) == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+// ========== Jobs ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeSchedule(
+    JNIEnv* env, jobject obj, jlong handle, jobject body, jint begin, jint end,
+    jlong dependency, jlong counter) {
+    KotlinJob* job = createKotlinJob(env, body);
+    JobSystem* system = getSystem(handle);
+
+    system->scheduleAfter(getCounter(dependency), runBody, job, begin, end, &job->pending);
+    system->scheduleAfter(&job->pending, releaseKotlinJob, job, 0, 0, getCounter(counter));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeParallelFor(
+    JNIEnv* env, jobject obj, jlong handle, jint count, jint batchSize, jobject body,
+    jlong counter) {
+    if (count <= 0) return;
+    KotlinJob* job = createKotlinJob(env, body);
+    JobSystem* system = getSystem(handle);
+
+    if (counter == 0) {
+        system->parallelFor(count, batchSize, runBody, job, nullptr);
+        env->DeleteGlobalRef(job->body);
+        destroyKotlinJob(job);
+        return;
+    }
+
+    system->parallelFor(count, batchSize, runBody, job, &job->pending);
+    system->scheduleAfter(&job->pending, releaseKotlinJob, job, 0, 0, getCounter(counter));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_jobs_NativeJobSystem_nativeWait(
+    JNIEnv* env, jobject obj, jlong handle, jlong counter) {
+    getSystem(handle)->wait(getCounter(counter));
+}
+
+// ========== Grafo de sistemas ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeCreate(
+    JNIEnv* env, jobject obj) {
+    return reinterpret_cast<jlong>(new SystemGraph());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeDestroy(
+    JNIEnv* env, jobject obj, jlong handle) {
+    delete getGraph(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeBuild(
+    JNIEnv* env, jobject obj, jlong handle, jint count, jlongArray reads, jlongArray writes,
+    jbooleanArray exclusive, jlongArray costs) {
+    CriticalArray<jlong> readMasks(env, reads);
+    CriticalArray<jlong> writeMasks(env, writes);
+    CriticalArray<jboolean> exclusiveFlags(env, exclusive);
+    CriticalArray<jlong> costValues(env, costs);
+    if (!readMasks.get() || !writeMasks.get() || !exclusiveFlags.get() || !costValues.get()) return;
+
+    getGraph(handle)->build(count,
+                            reinterpret_cast<const uint64_t*>(readMasks.get()),
+                            reinterpret_cast<const uint64_t*>(writeMasks.get()),
+                            exclusiveFlags.get(),
+                            costValues.get());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeRun(
+    JNIEnv* env, jobject obj, jlong handle, jlong scheduler, jobject body) {
+    KotlinJob* job = createKotlinJob(env, body);
+    getGraph(handle)->run(*reinterpret_cast<JobScheduler*>(scheduler), runBody, job);
+    env->DeleteGlobalRef(job->body);
+    destroyKotlinJob(job);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeGetEdgeCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getGraph(handle)->getEdgeCount();
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_core_ecs_SystemGraph_nativeGetCriticalPath(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getGraph(handle)->getCriticalPath();
+}
+
+} // extern "C"
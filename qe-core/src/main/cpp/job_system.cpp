@@ -0,0 +1,485 @@
+// job_system.cpp - Scheduler nativo con deques Chase–Lev y robo de trabajo
+#include "job_system.h"
+#include <algorithm>
+#include <sched.h>
+
+namespace {
+
+constexpr int64_t DEQUE_MASK = WorkDeque::CAPACITY - 1;
+constexpr int32_t SPIN_ROUNDS = 64;
+constexpr int32_t POOL_BLOCK = 256;
+constexpr int32_t COUNTER_CLOSING = -1;     // finish() recogiendo las continuaciones
+
+// Worker del hilo actual (-1 fuera de los workers de ese JobSystem)
+thread_local const JobSystem* tlsSystem = nullptr;
+thread_local int32_t tlsWorker = -1;
+thread_local uint32_t tlsRandom = 0x9E3779B9u;
+
+inline uint32_t nextRandom(uint32_t& state) {
+    // xorshift32: sólo elige la primera víctima
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+inline void pinCurrentThread(int32_t core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    sched_setaffinity(0, sizeof(set), &set);   // si falla, el worker sigue sin fijar
+}
+
+} // namespace
+
+// ========== WorkDeque ==========
+
+bool WorkDeque::push(Job* job) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) return false;
+
+    buffer[b & DEQUE_MASK].store(job, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_release);     // publica el job a los ladrones
+    return true;
+}
+
+Job* WorkDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = buffer[b & DEQUE_MASK].load(std::memory_order_relaxed);
+    if (t == b) {
+        // Último elemento: se lo disputa con los ladrones
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkDeque::steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Job* job = buffer[t & DEQUE_MASK].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+// ========== JobSystem ==========
+
+JobSystem::JobSystem(int32_t workerCount, bool pinThreads, ThreadCallback onWorkerExit)
+    : onWorkerExit(onWorkerExit) {
+    const int32_t cores = std::max(static_cast<int32_t>(std::thread::hardware_concurrency()), 1);
+    if (workerCount < 0) {
+        workerCount = cores - 1;
+    }
+    // Fijar sólo tiene sentido si hay un núcleo por worker además del principal
+    pinThreads = pinThreads && workerCount < cores;
+
+    for (int32_t i = 0; i < workerCount; i++) {
+        std::unique_ptr<Worker> worker(new Worker());
+        worker->random = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+        workers.push_back(std::move(worker));
+    }
+    // Los hilos arrancan cuando todos los deques existen: roban de cualquiera
+    for (int32_t i = 0; i < workerCount; i++) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i, pinThreads);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true, std::memory_order_seq_cst);
+        wakeSignals++;
+    }
+    sleepCondition.notify_all();
+    for (std::unique_ptr<Worker>& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+int32_t JobSystem::currentWorker() const {
+    return tlsSystem == this ? tlsWorker : -1;
+}
+
+// ========== Programación ==========
+
+void JobSystem::schedule(JobFunction function, void* context, int32_t begin, int32_t end,
+                         JobCounter* counter) {
+    const int32_t worker = currentWorker();
+    addCount(counter, 1);
+
+    Job* job = allocate(worker);
+    job->function = function;
+    job->context = context;
+    job->begin = begin;
+    job->end = end;
+    job->batchSize = 0;
+    job->counter = counter;
+    submit(job, worker);
+}
+
+void JobSystem::scheduleAfter(JobCounter* dependency, JobFunction function, void* context,
+                              int32_t begin, int32_t end, JobCounter* counter) {
+    if (!dependency) {
+        schedule(function, context, begin, end, counter);
+        return;
+    }
+    addCount(counter, 1);
+
+    // Puede esperar más que RING_SIZE jobs: siempre del pool compartido
+    Job* job = allocate(-1);
+    job->function = function;
+    job->context = context;
+    job->begin = begin;
+    job->end = end;
+    job->batchSize = 0;
+    job->counter = counter;
+
+    // La referencia extra impide que dependency llegue a cero mientras se
+    // enlaza; si ya había terminado, finish() la lanza en el acto
+    addCount(dependency, 1);
+    Job* head = dependency->continuations.load(std::memory_order_relaxed);
+    do {
+        job->next = head;
+    } while (!dependency->continuations.compare_exchange_weak(
+        head, job, std::memory_order_release, std::memory_order_relaxed));
+    finish(dependency);
+}
+
+void JobSystem::parallelFor(int32_t count, int32_t batchSize, JobFunction function, void* context,
+                            JobCounter* counter) {
+    if (count <= 0) return;
+    batchSize = batchSize > 0 ? batchSize : 1;
+
+    if (!counter) {
+        // Un lote: sin scheduler
+        if (count <= batchSize) {
+            function(context, 0, count);
+            return;
+        }
+
+        // El rango entero empieza en este hilo y se parte conforme otros roban
+        JobCounter done;
+        done.count.store(1, std::memory_order_relaxed);
+        Job job{ function, context, 0, count, batchSize, &done, nullptr, false, true };
+        execute(&job, currentWorker());
+        wait(&done);
+        return;
+    }
+
+    const int32_t worker = currentWorker();
+    addCount(counter, 1);
+
+    Job* job = allocate(worker);
+    job->function = function;
+    job->context = context;
+    job->begin = 0;
+    job->end = count;
+    job->batchSize = batchSize;
+    job->counter = counter;
+    submit(job, worker);
+}
+
+void JobSystem::wait(JobCounter* counter) {
+    if (!counter) return;
+
+    const int32_t worker = currentWorker();
+    int32_t idle = 0;
+    while (counter->count.load(std::memory_order_acquire) != 0) {
+        Job* job = findJob(worker);
+        if (job) {
+            execute(job, worker);
+            idle = 0;
+        } else if (++idle > SPIN_ROUNDS) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+// ========== Jobs ==========
+
+Job* JobSystem::allocate(int32_t worker) {
+    if (worker >= 0) {
+        // Sólo este worker reserva de su anillo; los demás sólo liberan
+        Worker& owner = *workers[worker];
+        for (uint32_t probe = 0; probe < RING_SIZE; probe++) {
+            Job* job = &owner.ring[owner.ringNext++ & (RING_SIZE - 1)];
+            if (job->live.load(std::memory_order_acquire)) continue;
+            job->live.store(true, std::memory_order_relaxed);
+            job->next = nullptr;
+            job->pooled = false;
+            return job;
+        }
+        // Todo el anillo sigue vivo: al pool compartido
+    }
+
+    std::lock_guard<std::mutex> lock(poolMutex);
+    if (freeJobs.empty()) {
+        std::unique_ptr<Job[]> block(new Job[POOL_BLOCK]);
+        for (int32_t i = 0; i < POOL_BLOCK; i++) {
+            freeJobs.push_back(&block[i]);
+        }
+        jobBlocks.push_back(std::move(block));
+    }
+    Job* job = freeJobs.back();
+    freeJobs.pop_back();
+    job->live.store(true, std::memory_order_relaxed);
+    job->next = nullptr;
+    job->pooled = true;
+    return job;
+}
+
+void JobSystem::release(Job* job) {
+    if (!job->pooled) {
+        // Pareja del acquire de allocate(): lo leído del hueco queda antes de reutilizarlo
+        job->live.store(false, std::memory_order_release);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(poolMutex);
+    job->live.store(false, std::memory_order_relaxed);
+    freeJobs.push_back(job);
+}
+
+void JobSystem::submit(Job* job, int32_t worker) {
+    if (worker >= 0) {
+        if (!workers[worker]->deque.push(job)) {
+            // Deque lleno: en el sitio, ya hay trabajo de sobra para los demás
+            execute(job, worker);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        injection.push_back(job);
+        injectionSize.fetch_add(1, std::memory_order_relaxed);
+    }
+    wakeOne();
+}
+
+void JobSystem::wakeOne() {
+    // Pareja del fetch_add de sleepers en workerLoop: o el worker ve el
+    // trabajo al revisar o aquí se ve que duerme
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeSignals++;
+    }
+    sleepCondition.notify_one();
+}
+
+bool JobSystem::hasWork() {
+    if (injectionSize.load(std::memory_order_seq_cst) > 0) return true;
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        if (!worker->deque.isEmpty()) return true;
+    }
+    return false;
+}
+
+Job* JobSystem::findJob(int32_t worker) {
+    if (worker >= 0) {
+        if (Job* job = workers[worker]->deque.pop()) return job;
+    }
+    if (Job* job = popInjection()) return job;
+    return stealFrom(worker);
+}
+
+Job* JobSystem::popInjection() {
+    if (injectionSize.load(std::memory_order_relaxed) == 0) return nullptr;
+
+    std::lock_guard<std::mutex> lock(injectionMutex);
+    if (injection.empty()) return nullptr;
+    Job* job = injection.front();
+    injection.pop_front();
+    injectionSize.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+/**
+ * Por delante de los demás deques, empezando por uno al azar para no
+ * cargar siempre al mismo
+ */
+Job* JobSystem::stealFrom(int32_t thief) {
+    const int32_t count = static_cast<int32_t>(workers.size());
+    if (count == 0) return nullptr;
+
+    uint32_t& random = thief >= 0 ? workers[thief]->random : tlsRandom;
+    const int32_t start = static_cast<int32_t>(nextRandom(random) % static_cast<uint32_t>(count));
+    for (int32_t offset = 0; offset < count; offset++) {
+        int32_t victim = (start + offset) % count;
+        if (victim == thief) continue;
+        if (Job* job = workers[victim]->deque.steal()) return job;
+    }
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job, int32_t worker) {
+    // Todo en locales antes de ejecutar: el job no se vuelve a leer después
+    const JobFunction function = job->function;
+    void* const context = job->context;
+    const int32_t begin = job->begin;
+    const int32_t end = job->end;
+    const int32_t batchSize = job->batchSize;
+    JobCounter* const counter = job->counter;
+
+    if (batchSize > 0) {
+        runRange(function, context, begin, end, batchSize, counter, worker);
+    } else {
+        function(context, begin, end);
+    }
+
+    release(job);
+    finish(counter);
+}
+
+/**
+ * Partición perezosa: antes de cada lote, si el deque propio está vacío (o
+ * la cola de inyección, fuera de los workers) es que alguien se ha llevado
+ * el trabajo, y la mitad superior de lo que queda se publica como job
+ * nuevo. Con todos ocupados el rango se recorre sin tocar el scheduler.
+ */
+void JobSystem::runRange(JobFunction function, void* context, int32_t begin, int32_t end,
+                         int32_t batchSize, JobCounter* counter, int32_t worker) {
+    while (begin < end) {
+        const int32_t batches = (end - begin + batchSize - 1) / batchSize;
+        const bool starving = worker >= 0
+            ? workers[worker]->deque.isEmpty()
+            : injectionSize.load(std::memory_order_relaxed) == 0;
+
+        if (batches > 1 && starving && !workers.empty()) {
+            // Cortes siempre en múltiplos de batchSize: los lotes no cambian
+            const int32_t middle = begin + (batches / 2) * batchSize;
+            addCount(counter, 1);
+            Job* half = allocate(worker);
+            half->function = function;
+            half->context = context;
+            half->begin = middle;
+            half->end = end;
+            half->batchSize = batchSize;
+            half->counter = counter;
+            submit(half, worker);
+            end = middle;
+            continue;
+        }
+
+        const int32_t batchEnd = std::min(begin + batchSize, end);
+        function(context, begin, batchEnd);
+        begin = batchEnd;
+    }
+}
+
+// ========== Contadores ==========
+
+/**
+ * Suma count a counter. Si otro hilo lo está cerrando espera a que publique
+ * el cero: sumar en medio dejaría sus continuaciones sin lanzar.
+ */
+void JobSystem::addCount(JobCounter* counter, int32_t count) {
+    if (!counter) return;
+
+    int32_t current = counter->count.load(std::memory_order_relaxed);
+    while (true) {
+        if (current == COUNTER_CLOSING) {
+            std::this_thread::yield();
+            current = counter->count.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (counter->count.compare_exchange_weak(current, current + count,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Decrementa counter; quien lo deja en cero se lleva las continuaciones.
+ * Pasar de 1 a COUNTER_CLOSING cierra el contador en un solo paso: mientras
+ * tanto addCount() espera, así que ningún scheduleAfter() puede enlazar una
+ * continuación que nadie lance. El cero se publica al final, tras recoger la
+ * lista, porque un hilo que espera en wait() puede destruir el contador en
+ * cuanto lo ve a cero.
+ */
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+
+    int32_t current = counter->count.load(std::memory_order_relaxed);
+    while (true) {
+        const int32_t next = current > 1 ? current - 1 : COUNTER_CLOSING;
+        if (counter->count.compare_exchange_weak(current, next, std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+            if (next != COUNTER_CLOSING) return;
+            break;
+        }
+    }
+
+    Job* list = counter->continuations.exchange(nullptr, std::memory_order_acquire);
+    counter->count.store(0, std::memory_order_release);
+    launchContinuations(list);
+}
+
+void JobSystem::launchContinuations(Job* list) {
+    const int32_t worker = currentWorker();
+    while (list) {
+        Job* next = list->next;
+        list->next = nullptr;
+        submit(list, worker);
+        list = next;
+    }
+}
+
+// ========== Workers ==========
+
+void JobSystem::workerLoop(int32_t index, bool pin) {
+    tlsSystem = this;
+    tlsWorker = index;
+    if (pin) {
+        pinCurrentThread(index + 1);
+    }
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        // Un poco de espera activa antes de dormir: los jobs llegan en ráfagas
+        Job* job = nullptr;
+        for (int32_t spin = 0; spin < SPIN_ROUNDS && !job; spin++) {
+            job = findJob(index);
+            if (!job && spin > SPIN_ROUNDS / 2) std::this_thread::yield();
+        }
+        if (job) {
+            execute(job, index);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        const uint64_t seen = wakeSignals;
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (!hasWork() && !stopping.load(std::memory_order_relaxed)) {
+            sleepCondition.wait(lock, [&] {
+                return stopping.load(std::memory_order_relaxed) || wakeSignals != seen;
+            });
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if (onWorkerExit) {
+        onWorkerExit();
+    }
+    tlsSystem = nullptr;
+    tlsWorker = -1;
+}
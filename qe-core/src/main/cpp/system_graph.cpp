@@ -0,0 +1,137 @@
+// system_graph.cpp - Dependencias entre sistemas y ejecución por camino crítico
+#include "system_graph.h"
+#include <algorithm>
+
+namespace {
+
+inline bool intersects(const uint64_t* a, const uint64_t* b) {
+    for (int32_t word = 0; word < SystemGraph::MASK_WORDS; word++) {
+        if (a[word] & b[word]) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void SystemGraph::build(int32_t count, const uint64_t* reads, const uint64_t* writes,
+                        const uint8_t* exclusive, const int64_t* costs) {
+    count = std::max(count, 0);
+    nodes.assign(count, Node());
+    successors.clear();
+    roots.clear();
+    segments.clear();
+
+    if (count > remainingCapacity) {
+        remaining.reset(new std::atomic<int32_t>[count]);
+        remainingCapacity = count;
+    }
+
+    // Tramos: los exclusivos separan los grupos de nodos paralelos
+    for (int32_t i = 0; i < count;) {
+        Segment segment;
+        segment.first = i;
+        segment.exclusive = exclusive[i] != 0;
+        if (segment.exclusive) {
+            i++;
+        } else {
+            while (i < count && !exclusive[i]) i++;
+        }
+        segment.end = i;
+        segments.push_back(segment);
+    }
+
+    criticalPath = 0;
+    for (Segment& segment : segments) {
+        if (segment.exclusive) {
+            nodes[segment.first].rank = std::max<int64_t>(costs[segment.first], 1);
+            criticalPath += nodes[segment.first].rank;
+            continue;
+        }
+
+        // Aristas en orden de prioridad: i < j y conflicto -> i antes que j
+        for (int32_t i = segment.first; i < segment.end; i++) {
+            const uint64_t* readsI = reads + i * MASK_WORDS;
+            const uint64_t* writesI = writes + i * MASK_WORDS;
+
+            nodes[i].firstSuccessor = static_cast<int32_t>(successors.size());
+            for (int32_t j = i + 1; j < segment.end; j++) {
+                const uint64_t* readsJ = reads + j * MASK_WORDS;
+                const uint64_t* writesJ = writes + j * MASK_WORDS;
+
+                bool conflict = intersects(writesI, readsJ) || intersects(writesI, writesJ) ||
+                    intersects(readsI, writesJ);
+                if (conflict) {
+                    successors.push_back(j);
+                    nodes[j].predecessorCount++;
+                }
+            }
+            nodes[i].successorCount = static_cast<int32_t>(successors.size()) - nodes[i].firstSuccessor;
+        }
+
+        // rank hacia atrás: los sucesores siempre tienen índice mayor
+        segment.firstRoot = static_cast<int32_t>(roots.size());
+        int64_t segmentPath = 0;
+        for (int32_t i = segment.end - 1; i >= segment.first; i--) {
+            Node& node = nodes[i];
+            int64_t longest = 0;
+            for (int32_t k = 0; k < node.successorCount; k++) {
+                longest = std::max(longest, nodes[successors[node.firstSuccessor + k]].rank);
+            }
+            node.rank = std::max<int64_t>(costs[i], 1) + longest;
+
+            // Se publican en este orden y el worker saca el último: el de mayor rank
+            int32_t* first = successors.data() + node.firstSuccessor;
+            std::sort(first, first + node.successorCount, [this](int32_t a, int32_t b) {
+                return nodes[a].rank < nodes[b].rank;
+            });
+
+            if (node.predecessorCount == 0) {
+                roots.push_back(i);
+                segmentPath = std::max(segmentPath, node.rank);
+            }
+        }
+        segment.rootCount = static_cast<int32_t>(roots.size()) - segment.firstRoot;
+        criticalPath += segmentPath;
+
+        // Desde fuera de los workers la cola es FIFO: mayor rank primero
+        std::sort(roots.begin() + segment.firstRoot, roots.end(), [this](int32_t a, int32_t b) {
+            return nodes[a].rank > nodes[b].rank;
+        });
+    }
+}
+
+void SystemGraph::run(JobScheduler& scheduler, JobScheduler::JobFunction function, void* context) {
+    for (const Segment& segment : segments) {
+        // Barrera: lo anterior ya terminó y nada posterior ha empezado
+        if (segment.exclusive) {
+            function(context, segment.first, segment.first + 1);
+            continue;
+        }
+
+        for (int32_t i = segment.first; i < segment.end; i++) {
+            remaining[i].store(nodes[i].predecessorCount, std::memory_order_relaxed);
+        }
+
+        RunState state{ this, &scheduler, function, context, {} };
+        for (int32_t k = 0; k < segment.rootCount; k++) {
+            int32_t root = roots[segment.firstRoot + k];
+            scheduler.schedule(runNode, &state, root, root + 1, &state.done);
+        }
+        scheduler.wait(&state.done);
+    }
+}
+
+void SystemGraph::runNode(void* context, int32_t node, int32_t end) {
+    RunState* state = static_cast<RunState*>(context);
+    state->function(state->context, node, node + 1);
+
+    // Los sucesores cuentan en done antes de que este job termine
+    SystemGraph* graph = state->graph;
+    const Node& current = graph->nodes[node];
+    for (int32_t k = 0; k < current.successorCount; k++) {
+        int32_t next = graph->successors[current.firstSuccessor + k];
+        if (graph->remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            state->scheduler->schedule(runNode, state, next, next + 1, &state->done);
+        }
+    }
+}
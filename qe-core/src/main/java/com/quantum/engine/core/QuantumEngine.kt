@@ -26,7 +26,10 @@ class QuantumEngine private constructor(
     
     // Core systems
     val entityManager = EntityManager()
-    val systemManager = SystemManager(entityManager)
+    val systemManager = SystemManager(entityManager).apply {
+        // Sistemas sin conflictos de componentes a la vez en el pool nativo
+        parallelStages = config.enableMultiThreading
+    }
     
     // Engine state
     private val _state = MutableStateFlow(EngineState.STOPPED)
@@ -0,0 +1,746 @@
+package com.quantum.engine.core.ecs
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Archetype - Patrón de componentes compartido por múltiples entidades
+ *
+ * Sus entidades viven densas en chunks de ArchetypeStore.CHUNK_BYTES, una
+ * columna por tipo: los componentes nativos (NativeComponent) en memoria
+ * nativa SoA y el resto como arrays de objetos por chunk con las mismas filas.
+ */
+class Archetype internal constructor(
+    val id: Int,
+    val mask: ComponentMask,
+    val types: List<ComponentType>,
+    /** Entidades por chunk */
+    val capacity: Int,
+    internal val offsets: IntArray,     // byte de la columna nativa en el chunk; -1 = gestionada
+    internal val sizes: IntArray        // bytes por entidad de la columna nativa
+) {
+    // ComponentType.id -> columna
+    private val columnsByType = IntArray((types.maxOfOrNull { it.id } ?: -1) + 1) { -1 }
+    
+    init {
+        types.forEachIndexed { column, type -> columnsByType[type.id] = column }
+    }
+    
+    /**
+     * Chunks en orden; sólo el último con entidades puede estar a medias y
+     * puede haber uno vacío de repuesto detrás
+     */
+    val chunks = ArrayList<ArchetypeChunk>()
+    
+    var entityCount = 0
+        internal set
+    
+    /**
+     * Cambia cada vez que entra o sale una entidad del archetype
+     */
+    var structureVersion = 0L
+        internal set
+    
+    // Transiciones al añadir / quitar un tipo (ComponentType.id -> archetype)
+    internal val withEdges = HashMap<Int, Archetype>()
+    internal val withoutEdges = HashMap<Int, Archetype>()
+    
+    /**
+     * Columna del tipo en los chunks o -1 si el archetype no lo tiene
+     */
+    fun columnOf(type: ComponentType): Int =
+        if (type.id < columnsByType.size) columnsByType[type.id] else -1
+    
+    fun has(type: ComponentType): Boolean = columnOf(type) >= 0
+    
+    fun isNative(column: Int): Boolean = offsets[column] >= 0
+    
+    /**
+     * Verifica si este archetype coincide con los requisitos de un sistema
+     */
+    fun matches(
+        required: ComponentMask,
+        excluded: ComponentMask = ComponentMask()
+    ): Boolean {
+        return mask.hasAll(required) && mask.hasNone(excluded)
+    }
+    
+    override fun toString(): String = "Archetype($id, ${types.size} types, capacity $capacity)"
+}
+
+/**
+ * Chunk de 16KB de un archetype
+ *
+ * Las filas [0, count) son entidades. Las columnas gestionadas se leen con
+ * column(), sin búsquedas por entidad; las nativas con nativeColumn(), una
+ * vista directa de la memoria del chunk (orden de bytes nativo).
+ *
+ * Cada columna lleva la versión de su último cambio: columnForWrite() y
+ * nativeColumnForWrite() la suben a ArchetypeStore.writeVersion, y
+ * didChange() dice si cambió desde una versión vista antes (p. ej.
+ * System.lastSystemVersion) para saltarse los chunks sin cambios.
+ */
+class ArchetypeChunk internal constructor(
+    val id: Int,
+    private val memory: ByteBuffer,
+    private val store: ArchetypeStore
+) {
+    lateinit var archetype: Archetype
+        private set
+    
+    // Índice en archetype.chunks
+    internal var position = 0
+    
+    var count = 0
+        internal set
+    
+    internal var records = arrayOfNulls<EntityRecord>(0)
+        private set
+    
+    // Por columna: array de objetos del tipo (gestionada) o null (nativa)
+    internal var components = arrayOfNulls<Array<Any?>>(0)
+        private set
+    
+    /**
+     * Por columna: ArchetypeStore.changeVersion de la última escritura o
+     * cambio de filas en el chunk (ver EntityQuery.changed)
+     */
+    var changeVersions = LongArray(0)
+        private set
+    
+    private var nativeColumns = arrayOfNulls<ByteBuffer>(0)
+    
+    /**
+     * Reasigna el chunk (al reservarlo, quizá reutilizado de otro archetype)
+     */
+    internal fun assign(archetype: Archetype) {
+        this.archetype = archetype
+        count = 0
+        records = arrayOfNulls(archetype.capacity)
+        components = Array(archetype.types.size) { column ->
+            if (archetype.isNative(column)) {
+                null
+            } else {
+                @Suppress("UNCHECKED_CAST")
+                java.lang.reflect.Array.newInstance(
+                    ComponentType.classOf(archetype.types[column]).java, archetype.capacity
+                ) as Array<Any?>
+            }
+        }
+        nativeColumns = arrayOfNulls(archetype.types.size)
+        changeVersions = LongArray(archetype.types.size)
+    }
+    
+    /**
+     * Suelta las referencias al volver al pool
+     */
+    internal fun release() {
+        count = 0
+        records = arrayOfNulls(0)
+        components = arrayOfNulls(0)
+        nativeColumns = arrayOfNulls(0)
+        changeVersions = LongArray(0)
+    }
+    
+    /**
+     * Marca la columna como cambiada en la versión actual
+     */
+    fun markChanged(column: Int, version: Long) {
+        if (changeVersions[column] < version) changeVersions[column] = version
+    }
+    
+    internal fun markAllChanged(version: Long) {
+        for (column in changeVersions.indices) markChanged(column, version)
+    }
+    
+    /**
+     * Marca la columna del tipo como escrita en la versión actual
+     */
+    fun markChanged(type: ComponentType) {
+        val column = archetype.columnOf(type)
+        if (column >= 0) markChanged(column, store.writeVersion)
+    }
+    
+    /**
+     * Versión del último cambio de la columna del tipo (0 si no la tiene)
+     */
+    fun changeVersion(type: ComponentType): Long {
+        val column = archetype.columnOf(type)
+        return if (column >= 0) changeVersions[column] else 0L
+    }
+    
+    /**
+     * ¿Cambió la columna del tipo después de version?
+     */
+    fun didChange(type: ComponentType, version: Long): Boolean = changeVersion(type) > version
+    
+    fun entity(row: Int): Entity = Entity(memory.getLong(row * ArchetypeStore.ENTITY_BYTES))
+    
+    /**
+     * Columna gestionada del tipo: column[row] es el componente de la fila
+     */
+    inline fun <reified T : Component> column(): Array<T?> = column(ComponentType.of<T>())
+    
+    @Suppress("UNCHECKED_CAST")
+    fun <T : Component> column(type: ComponentType): Array<T?> {
+        val column = archetype.columnOf(type)
+        require(column >= 0) { "$archetype has no component type ${type.id}" }
+        return requireNotNull(components[column]) { "Component type ${type.id} is native" } as Array<T?>
+    }
+    
+    /**
+     * column() para modificar los componentes: marca la columna como cambiada
+     */
+    inline fun <reified T : Component> columnForWrite(): Array<T?> = columnForWrite(ComponentType.of<T>())
+    
+    fun <T : Component> columnForWrite(type: ComponentType): Array<T?> {
+        val column = column<T>(type)
+        markChanged(type)
+        return column
+    }
+    
+    /**
+     * Columna nativa del tipo: capacity × NativeComponent.nativeSize bytes,
+     * la fila row empieza en row * nativeSize
+     */
+    inline fun <reified T : NativeComponent> nativeColumn(): ByteBuffer = nativeColumn(ComponentType.of<T>())
+    
+    fun nativeColumn(type: ComponentType): ByteBuffer {
+        val column = archetype.columnOf(type)
+        require(column >= 0 && archetype.isNative(column)) { "Component type ${type.id} is not a native column" }
+        nativeColumns[column]?.let { return it }
+        
+        val offset = archetype.offsets[column]
+        val view = memory.duplicate()
+        view.position(offset)
+        view.limit(offset + archetype.capacity * archetype.sizes[column])
+        return view.slice().order(ByteOrder.nativeOrder()).also { nativeColumns[column] = it }
+    }
+    
+    inline fun <reified T : NativeComponent> nativeColumnForWrite(): ByteBuffer =
+        nativeColumnForWrite(ComponentType.of<T>())
+    
+    fun nativeColumnForWrite(type: ComponentType): ByteBuffer {
+        val column = nativeColumn(type)
+        markChanged(type)
+        return column
+    }
+}
+
+/**
+ * Ubicación de una entidad viva: chunk y fila
+ */
+class EntityRecord internal constructor(val entity: Entity) {
+    lateinit var chunk: ArchetypeChunk
+        internal set
+    var row = 0
+        internal set
+    
+    val archetype: Archetype get() = chunk.archetype
+}
+
+/**
+ * ArchetypeStore - Almacén de entidades por archetype (libquantum_core)
+ *
+ * Los chunks, sus columnas nativas y los ids de entidad viven en memoria
+ * nativa; las operaciones estructurales (añadir, mover de archetype, quitar)
+ * son una llamada JNI que copia las columnas nativas con memcpy y devuelve
+ * qué filas se movieron, y aquí se repiten sobre las columnas gestionadas y
+ * los EntityRecord. Quitar una fila mueve a su hueco la última del
+ * archetype, así los chunks quedan densos.
+ *
+ * No es thread-safe: EntityManager serializa los cambios estructurales.
+ */
+class ArchetypeStore : AutoCloseable {
+    
+    private var nativeHandle: Long = nativeCreate()
+    private val result = IntArray(RESULT_INTS)
+    private val typeScratch = IntArray(MAX_TYPES)
+    private val offsetScratch = IntArray(MAX_TYPES)
+    
+    // Entradas de las operaciones en lote
+    private var idScratch = LongArray(64)
+    private var newChunkScratch = IntArray(8)
+    private var chunkScratch = IntArray(64)
+    private var rowScratch = IntArray(64)
+    private var archetypeScratch = IntArray(64)
+    private var batchResults = IntArray(64 * RESULT_INTS)
+    
+    private val registeredTypes = BooleanArray(MAX_TYPES)
+    private val nativeSizes = IntArray(MAX_TYPES)
+    
+    private val archetypeList = ArrayList<Archetype>()
+    private val archetypesByMask = HashMap<ComponentMask, Archetype>()
+    
+    // Consultas registradas: reciben los archetypes nuevos que cumplen
+    private val queries = ArrayList<EntityQuery>()
+    
+    /**
+     * Archetypes en orden de creación (el índice es Archetype.id)
+     */
+    val archetypes: List<Archetype> get() = archetypeList
+    
+    // Espejo de los chunks nativos por índice; su memoria no se mueve
+    private var chunks = arrayOfNulls<ArchetypeChunk>(64)
+    
+    /**
+     * Versión con la que se marcan las escrituras; las consultas con filtro
+     * de cambios la avanzan al terminar cada recorrido
+     */
+    @Volatile
+    var changeVersion = 1L
+        private set
+    
+    // Con etapas en paralelo: versión del sistema que corre en cada hilo
+    // (0 = ninguno)
+    @Volatile
+    private var parallelWrites = false
+    private val threadWriteVersion = ThreadLocal.withInitial { LongArray(1) }
+    
+    /**
+     * Versión con la que se marcan las escrituras del hilo actual: la del
+     * sistema que corre en él durante una etapa en paralelo; si no,
+     * changeVersion
+     */
+    val writeVersion: Long
+        get() {
+            if (!parallelWrites) return changeVersion
+            val version = threadWriteVersion.get()[0]
+            return if (version != 0L) version else changeVersion
+        }
+    
+    /**
+     * Archetype de las entidades sin componentes
+     */
+    val emptyArchetype: Archetype = archetypeOf(ComponentMask())
+    
+    companion object {
+        const val CHUNK_BYTES = 16 * 1024
+        const val ENTITY_BYTES = 8
+        const val MAX_TYPES = 256
+        
+        // Resultado de las operaciones estructurales (ver archetype_store.h)
+        private const val DST_CHUNK = 0
+        private const val DST_ROW = 1
+        private const val HOLE_CHUNK = 2
+        private const val HOLE_ROW = 3
+        private const val FROM_CHUNK = 4
+        private const val FROM_ROW = 5
+        private const val NEW_CHUNK = 6
+        private const val FREED_CHUNK = 7
+        private const val RESULT_INTS = 8
+        
+        init {
+            java.lang.System.loadLibrary("quantum_core")
+        }
+    }
+    
+    /**
+     * Archetype con los tipos de mask, creado si no existía
+     */
+    fun archetypeOf(mask: ComponentMask): Archetype {
+        archetypesByMask[mask]?.let { return it }
+        
+        var count = 0
+        for (id in 0 until ComponentType.count) {
+            if (mask.has(ComponentType(id))) {
+                registerType(ComponentType(id))
+                typeScratch[count++] = id
+            }
+        }
+        val id = nativeGetArchetype(nativeHandle, typeScratch, count)
+        check(id >= 0) { "Archetype ${typeScratch.copyOf(count).contentToString()} does not fit a $CHUNK_BYTES-byte chunk" }
+        check(id == archetypeList.size) { "Native archetype $id out of sync" }
+        
+        val capacity = nativeGetArchetypeLayout(nativeHandle, id, offsetScratch)
+        val types = (0 until count).map { ComponentType(typeScratch[it]) }
+        val archetype = Archetype(
+            id = id,
+            mask = mask.copy(),
+            types = types,
+            capacity = capacity,
+            offsets = offsetScratch.copyOf(count),
+            sizes = IntArray(count) { nativeSizes[typeScratch[it]] }
+        )
+        archetypeList.add(archetype)
+        archetypesByMask[archetype.mask] = archetype
+        for (query in queries) {
+            query.onArchetypeCreated(archetype)
+        }
+        return archetype
+    }
+    
+    fun archetypeWith(archetype: Archetype, type: ComponentType): Archetype {
+        if (archetype.has(type)) return archetype
+        return archetype.withEdges.getOrPut(type.id) {
+            val mask = archetype.mask.copy()
+            mask.set(type)
+            archetypeOf(mask).also { it.withoutEdges[type.id] = archetype }
+        }
+    }
+    
+    fun archetypeWithout(archetype: Archetype, type: ComponentType): Archetype {
+        if (!archetype.has(type)) return archetype
+        return archetype.withoutEdges.getOrPut(type.id) {
+            val mask = archetype.mask.copy()
+            mask.unset(type)
+            archetypeOf(mask).also { it.withEdges[type.id] = archetype }
+        }
+    }
+    
+    /**
+     * Registra la consulta y le pasa los archetypes que ya existen
+     */
+    fun register(query: EntityQuery) {
+        queries.add(query)
+        for (archetype in archetypeList) {
+            query.onArchetypeCreated(archetype)
+        }
+    }
+    
+    fun unregister(query: EntityQuery) {
+        queries.remove(query)
+    }
+    
+    /**
+     * Cierra la versión actual: lo escrito desde ahora es más nuevo que
+     * lo que vio quien la devuelve
+     */
+    @Synchronized
+    fun advanceChangeVersion(): Long = changeVersion++
+    
+    /**
+     * Etapa en paralelo: desde ahora cada hilo marca sus escrituras con la
+     * versión que le asigne setThreadWriteVersion()
+     */
+    fun beginParallelWrites() {
+        parallelWrites = true
+    }
+    
+    fun endParallelWrites() {
+        parallelWrites = false
+    }
+    
+    /**
+     * Versión de escritura del hilo actual (0 = la global)
+     */
+    fun setThreadWriteVersion(version: Long) {
+        threadWriteVersion.get()[0] = version
+    }
+    
+    fun threadWriteVersion(): Long = if (parallelWrites) threadWriteVersion.get()[0] else 0L
+    
+    /**
+     * Hay una etapa en paralelo en marcha: los workers recorren archetypes y
+     * consultas, así que no se pueden crear archetypes ni mover filas
+     */
+    val inParallelStage: Boolean get() = parallelWrites
+    
+    /**
+     * Bytes de la columna nativa del tipo; 0 si es gestionado
+     */
+    fun nativeSizeOf(type: ComponentType): Int {
+        registerType(type)
+        return nativeSizes[type.id]
+    }
+    
+    /**
+     * Añade la entidad al final del archetype; sus componentes quedan a
+     * null (gestionados) o a cero (nativos)
+     */
+    fun add(record: EntityRecord, archetype: Archetype) {
+        if (!nativeAddEntity(nativeHandle, archetype.id, record.entity.id, result)) chunkAllocationFailed()
+        place(record, archetype)
+    }
+    
+    /**
+     * Cambia la entidad de archetype conservando los componentes comunes
+     */
+    fun move(record: EntityRecord, archetype: Archetype) {
+        val source = record.chunk
+        val sourceRow = record.row
+        if (source.archetype === archetype) return
+        
+        if (!nativeMoveEntity(nativeHandle, source.id, sourceRow, archetype.id, result)) chunkAllocationFailed()
+        applyMove(record, archetype, source, sourceRow)
+    }
+    
+    fun remove(record: EntityRecord) {
+        val archetype = record.archetype
+        nativeRemoveEntity(nativeHandle, record.chunk.id, record.row, result)
+        fillHole(archetype)
+    }
+    
+    /**
+     * Añade count entidades al final del archetype con una llamada nativa
+     * (ids con memcpy y columnas nativas a cero por chunk)
+     */
+    fun addAll(records: Array<EntityRecord?>, count: Int, archetype: Archetype) {
+        if (count == 0) return
+        val ids = idsOf(records, count)
+        val newChunks = nativeAddEntities(nativeHandle, archetype.id, ids, count, newChunkScratchFor(count, archetype))
+        if (newChunks < 0) chunkAllocationFailed()
+        placeAll(records, count, archetype, newChunks)
+    }
+    
+    /**
+     * Añade count copias de la entidad source a su archetype: las columnas
+     * nativas se duplican con memcpy en nativo y los componentes gestionados
+     * se copian con Component.clone()
+     */
+    fun instantiate(source: EntityRecord, records: Array<EntityRecord?>, count: Int) {
+        if (count == 0) return
+        val archetype = source.archetype
+        val ids = idsOf(records, count)
+        val newChunks = nativeInstantiate(
+            nativeHandle, source.chunk.id, source.row, ids, count, newChunkScratchFor(count, archetype)
+        )
+        if (newChunks < 0) chunkAllocationFailed()
+        placeAll(records, count, archetype, newChunks)
+        
+        val sourceChunk = source.chunk
+        for (column in archetype.types.indices) {
+            val prototype = sourceChunk.components[column]?.get(source.row) as Component? ?: continue
+            for (i in 0 until count) {
+                val record = records[i]!!
+                record.chunk.components[column]!![record.row] = prototype.clone()
+            }
+        }
+    }
+    
+    /**
+     * move / remove en lote con una llamada nativa: records[i] pasa a
+     * targets[i], o se quita si es null. Se aplican de la última fila a la
+     * primera dentro de cada archetype origen para que las posiciones leídas
+     * antes de empezar sigan valiendo.
+     */
+    fun moveAll(records: Array<EntityRecord?>, targets: Array<Archetype?>, count: Int) {
+        val order = (0 until count)
+            .filter { targets[it] !== records[it]!!.archetype }
+            .sortedWith(compareBy<Int> { records[it]!!.archetype.id }.thenByDescending { rowIndexOf(records[it]!!) })
+        if (order.isEmpty()) return
+        
+        val size = order.size
+        if (chunkScratch.size < size) {
+            chunkScratch = IntArray(size)
+            rowScratch = IntArray(size)
+            archetypeScratch = IntArray(size)
+            batchResults = IntArray(size * RESULT_INTS)
+        }
+        for ((i, index) in order.withIndex()) {
+            val record = records[index]!!
+            chunkScratch[i] = record.chunk.id
+            rowScratch[i] = record.row
+            archetypeScratch[i] = targets[index]?.id ?: -1
+        }
+        val applied = nativeMoveEntities(nativeHandle, chunkScratch, rowScratch, archetypeScratch, size, batchResults)
+        
+        // Repetir cada resultado en el mismo orden que en nativo
+        for ((i, index) in order.withIndex()) {
+            if (i == applied) chunkAllocationFailed()
+            val record = records[index]!!
+            val target = targets[index]
+            java.lang.System.arraycopy(batchResults, i * RESULT_INTS, result, 0, RESULT_INTS)
+            if (target != null) {
+                applyMove(record, target, record.chunk, record.row)
+            } else {
+                fillHole(record.archetype)
+            }
+        }
+    }
+    
+    /**
+     * Aplica el resultado de mover la fila (source, sourceRow) a archetype
+     */
+    private fun applyMove(record: EntityRecord, archetype: Archetype, source: ArchetypeChunk, sourceRow: Int) {
+        val target = place(record, archetype)
+        
+        val from = source.archetype
+        for (column in archetype.types.indices) {
+            val components = target.components[column] ?: continue
+            val sourceColumn = from.columnOf(archetype.types[column])
+            if (sourceColumn >= 0) {
+                components[record.row] = source.components[sourceColumn]!![sourceRow]
+            }
+        }
+        fillHole(from)
+    }
+    
+    /**
+     * Quita todas las entidades; los archetypes se conservan
+     */
+    fun clear() {
+        nativeClear(nativeHandle)
+        for (archetype in archetypeList) {
+            archetype.chunks.forEach { it.release() }
+            archetype.chunks.clear()
+            archetype.entityCount = 0
+            archetype.structureVersion++
+        }
+    }
+    
+    override fun close() {
+        if (nativeHandle != 0L) {
+            nativeDestroy(nativeHandle)
+            nativeHandle = 0
+        }
+    }
+    
+    private fun registerType(type: ComponentType) {
+        if (registeredTypes[type.id]) return
+        val size = NativeComponent.sizeOf(ComponentType.classOf(type))
+        check(nativeRegisterType(nativeHandle, type.id, size)) { "Invalid native size $size for type ${type.id}" }
+        nativeSizes[type.id] = size
+        registeredTypes[type.id] = true
+    }
+    
+    // Nativo deja el almacén como estaba antes de la operación fallida
+    private fun chunkAllocationFailed(): Nothing =
+        throw OutOfMemoryError("Failed to allocate a $CHUNK_BYTES-byte ECS chunk")
+    
+    /**
+     * Aplica DST_* y NEW_CHUNK: la fila nueva de la entidad
+     */
+    private fun place(record: EntityRecord, archetype: Archetype): ArchetypeChunk {
+        val newChunk = result[NEW_CHUNK]
+        if (newChunk >= 0) {
+            addChunk(archetype, newChunk)
+        }
+        
+        val chunk = chunks[result[DST_CHUNK]]!!
+        val row = result[DST_ROW]
+        chunk.records[row] = record
+        chunk.count++
+        chunk.markAllChanged(changeVersion)
+        archetype.entityCount++
+        archetype.structureVersion++
+        record.chunk = chunk
+        record.row = row
+        return chunk
+    }
+    
+    /**
+     * Aplica HOLE_*, FROM_* y FREED_CHUNK: la última fila del archetype pasa
+     * al hueco y el chunk de repuesto sobrante vuelve al pool
+     */
+    private fun fillHole(archetype: Archetype) {
+        val hole = chunks[result[HOLE_CHUNK]]!!
+        val holeRow = result[HOLE_ROW]
+        
+        val fromIndex = result[FROM_CHUNK]
+        val from = if (fromIndex >= 0) chunks[fromIndex]!! else hole
+        val fromRow = if (fromIndex >= 0) result[FROM_ROW] else holeRow
+        
+        if (fromIndex >= 0) {
+            val moved = from.records[fromRow]!!
+            hole.records[holeRow] = moved
+            moved.chunk = hole
+            moved.row = holeRow
+            for (column in hole.components.indices) {
+                val components = hole.components[column] ?: continue
+                components[holeRow] = from.components[column]!![fromRow]
+            }
+            hole.markAllChanged(changeVersion)
+        }
+        from.records[fromRow] = null
+        for (components in from.components) {
+            components?.set(fromRow, null)
+        }
+        from.count--
+        archetype.entityCount--
+        archetype.structureVersion++
+        
+        val freed = result[FREED_CHUNK]
+        if (freed >= 0) {
+            val chunk = chunks[freed]!!
+            archetype.chunks.remove(chunk)
+            chunk.release()
+        }
+    }
+    
+    /**
+     * Aplica addAll / instantiate: las filas nuevas son las count siguientes
+     * del archetype y newChunks los chunks reservados en newChunkScratch
+     */
+    private fun placeAll(records: Array<EntityRecord?>, count: Int, archetype: Archetype, newChunks: Int) {
+        for (i in 0 until newChunks) {
+            addChunk(archetype, newChunkScratch[i])
+        }
+        
+        val first = archetype.entityCount
+        val capacity = archetype.capacity
+        for (i in 0 until count) {
+            val record = records[i]!!
+            val chunk = archetype.chunks[(first + i) / capacity]
+            val row = (first + i) % capacity
+            chunk.records[row] = record
+            chunk.count++
+            record.chunk = chunk
+            record.row = row
+        }
+        for (position in first / capacity..(first + count - 1) / capacity) {
+            archetype.chunks[position].markAllChanged(changeVersion)
+        }
+        archetype.entityCount += count
+        archetype.structureVersion++
+    }
+    
+    private fun addChunk(archetype: Archetype, index: Int) {
+        val chunk = chunkAt(index)
+        chunk.assign(archetype)
+        chunk.position = archetype.chunks.size
+        archetype.chunks.add(chunk)
+    }
+    
+    private fun rowIndexOf(record: EntityRecord): Int =
+        record.chunk.position * record.archetype.capacity + record.row
+    
+    private fun idsOf(records: Array<EntityRecord?>, count: Int): LongArray {
+        if (idScratch.size < count) idScratch = LongArray(count)
+        for (i in 0 until count) {
+            idScratch[i] = records[i]!!.entity.id
+        }
+        return idScratch
+    }
+    
+    private fun newChunkScratchFor(count: Int, archetype: Archetype): IntArray {
+        val needed = count / archetype.capacity + 2
+        if (newChunkScratch.size < needed) newChunkScratch = IntArray(needed)
+        return newChunkScratch
+    }
+    
+    private fun chunkAt(index: Int): ArchetypeChunk {
+        if (index >= chunks.size) {
+            chunks = chunks.copyOf(maxOf(index + 1, chunks.size * 2))
+        }
+        return chunks[index] ?: ArchetypeChunk(
+            index, nativeGetChunkMemory(nativeHandle, index).order(ByteOrder.nativeOrder()), this
+        ).also { chunks[index] = it }
+    }
+    
+    // ========== JNI Native Methods ==========
+    
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeClear(handle: Long)
+    
+    private external fun nativeRegisterType(handle: Long, type: Int, size: Int): Boolean
+    private external fun nativeGetArchetype(handle: Long, types: IntArray, count: Int): Int
+    private external fun nativeGetArchetypeLayout(handle: Long, archetype: Int, outOffsets: IntArray): Int
+    
+    private external fun nativeAddEntity(handle: Long, archetype: Int, entity: Long, outResult: IntArray): Boolean
+    private external fun nativeMoveEntity(handle: Long, chunk: Int, row: Int, archetype: Int, outResult: IntArray): Boolean
+    private external fun nativeRemoveEntity(handle: Long, chunk: Int, row: Int, outResult: IntArray)
+    
+    private external fun nativeGetChunkMemory(handle: Long, chunk: Int): ByteBuffer
+    
+    private external fun nativeAddEntities(
+        handle: Long, archetype: Int, entities: LongArray, count: Int, outNewChunks: IntArray
+    ): Int
+    private external fun nativeInstantiate(
+        handle: Long, chunk: Int, row: Int, entities: LongArray, count: Int, outNewChunks: IntArray
+    ): Int
+    private external fun nativeMoveEntities(
+        handle: Long, chunks: IntArray, rows: IntArray, archetypes: IntArray, count: Int, outResults: IntArray
+    ): Int
+}
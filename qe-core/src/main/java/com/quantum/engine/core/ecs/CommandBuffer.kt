@@ -0,0 +1,153 @@
+package com.quantum.engine.core.ecs
+
+/**
+ * EntityCommandBuffer - Cambios estructurales diferidos
+ *
+ * Graba creaciones, destrucciones y altas/bajas de componentes mientras los
+ * sistemas se ejecutan (quizá en paralelo) sin tocar el almacén; el
+ * EntityManager los reproduce en los puntos de sincronización con
+ * playbackCommands(). Cada thread tiene su propio buffer
+ * (EntityManager.commandBuffer()), así que grabar no necesita locks.
+ *
+ * Al reproducir, cada entidad se mueve una sola vez a su archetype final y
+ * las entidades nuevas que acaban en el mismo archetype se añaden con una
+ * sola llamada nativa; instantiate() copia un prefab con memcpy por bloques.
+ */
+class EntityCommandBuffer internal constructor() {
+    
+    // Comandos en orden de grabación, en arrays paralelos reutilizados
+    internal var size = 0
+        private set
+    internal var ops = IntArray(64)
+        private set
+    internal var entities = LongArray(64)
+        private set
+    internal var args = IntArray(64)                 // ComponentType.id o número de copias
+        private set
+    internal var payloads = arrayOfNulls<Any>(64)    // componente o nombre
+        private set
+    
+    val isEmpty: Boolean get() = size == 0
+    
+    companion object {
+        internal const val CREATE = 0
+        internal const val DESTROY = 1
+        internal const val ADD_COMPONENT = 2
+        internal const val REMOVE_COMPONENT = 3
+        internal const val INSTANTIATE = 4
+    }
+    
+    /**
+     * Reserva una entidad que existirá tras la reproducción; se le pueden
+     * grabar componentes desde ya
+     */
+    fun createEntity(name: String? = null): Entity {
+        val entity = Entity.create()
+        record(CREATE, entity, 0, name)
+        return entity
+    }
+    
+    /**
+     * Destruye la entidad (y sus hijos) al reproducir; gana a cualquier otro
+     * comando sobre ella
+     */
+    fun destroyEntity(entity: Entity) {
+        record(DESTROY, entity, 0, null)
+    }
+    
+    inline fun <reified T : Component> addComponent(entity: Entity, component: T): T {
+        addComponent(entity, ComponentType.of<T>(), component)
+        return component
+    }
+    
+    fun addComponent(entity: Entity, type: ComponentType, component: Component) {
+        record(ADD_COMPONENT, entity, type.id, component)
+    }
+    
+    inline fun <reified T : Component> removeComponent(entity: Entity) {
+        removeComponent(entity, ComponentType.of<T>())
+    }
+    
+    fun removeComponent(entity: Entity, type: ComponentType) {
+        record(REMOVE_COMPONENT, entity, type.id, null)
+    }
+    
+    /**
+     * Crea count copias de prefab (tal como esté al empezar la reproducción,
+     * antes del resto de comandos del buffer)
+     *
+     * @return La primera copia; las demás tienen IDs consecutivos
+     */
+    fun instantiate(prefab: Entity, count: Int): Entity {
+        require(count > 0) { "count must be positive" }
+        val first = Entity.createRange(count)
+        record(INSTANTIATE, prefab, count, first)
+        return first
+    }
+    
+    internal fun clear() {
+        payloads.fill(null, 0, size)
+        size = 0
+    }
+    
+    private fun record(op: Int, entity: Entity, arg: Int, payload: Any?) {
+        if (size == ops.size) {
+            val capacity = size * 2
+            ops = ops.copyOf(capacity)
+            entities = entities.copyOf(capacity)
+            args = args.copyOf(capacity)
+            payloads = payloads.copyOf(capacity)
+        }
+        ops[size] = op
+        entities[size] = entity.id
+        args[size] = arg
+        payloads[size] = payload
+        size++
+    }
+}
+
+/**
+ * Estado final de una entidad tras plegar los comandos de un buffer
+ */
+internal class PendingEntity {
+    var entity = Entity.NULL
+    var created = false
+    var destroyed = false
+    var name: String? = null
+    val mask = ComponentMask()
+    
+    // Componentes a escribir, por tipo (el último grabado gana)
+    val types = ArrayList<ComponentType>()
+    val components = ArrayList<Component>()
+    
+    fun reset(entity: Entity, created: Boolean, currentMask: ComponentMask?) {
+        this.entity = entity
+        this.created = created
+        destroyed = false
+        name = null
+        mask.clear()
+        currentMask?.let { mask.setAll(it) }
+        types.clear()
+        components.clear()
+    }
+    
+    fun add(type: ComponentType, component: Component) {
+        mask.set(type)
+        val index = types.indexOf(type)
+        if (index >= 0) {
+            components[index] = component
+        } else {
+            types.add(type)
+            components.add(component)
+        }
+    }
+    
+    fun remove(type: ComponentType) {
+        mask.unset(type)
+        val index = types.indexOf(type)
+        if (index >= 0) {
+            types.removeAt(index)
+            components.removeAt(index)
+        }
+    }
+}
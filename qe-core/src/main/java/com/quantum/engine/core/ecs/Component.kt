@@ -1,6 +1,7 @@
 package com.quantum.engine.core.ecs
 
 import kotlinx.serialization.Serializable
+import java.nio.ByteBuffer
 import kotlin.reflect.KClass
 
 /**
@@ -16,6 +17,48 @@ interface Component {
     fun clone(): Component = this
 }
 
+/**
+ * Componente blittable: vive en una columna SoA de memoria nativa del chunk
+ * (nativeSize bytes por entidad) en vez de como objeto, y los sistemas lo
+ * recorren con ArchetypeChunk.nativeColumn() sin pasar por objetos.
+ *
+ * Tiene semántica de valor: getComponent() devuelve una copia leída de la
+ * columna y los cambios se guardan con EntityManager.setComponent(). Necesita
+ * un constructor sin argumentos y el mismo nativeSize en todas las instancias.
+ */
+interface NativeComponent : Component {
+    /**
+     * Bytes por entidad en la columna (múltiplo de 4)
+     */
+    val nativeSize: Int
+    
+    /**
+     * Escribe el componente en buffer a partir de offset
+     */
+    fun write(buffer: ByteBuffer, offset: Int)
+    
+    /**
+     * Lee el componente de buffer a partir de offset
+     */
+    fun read(buffer: ByteBuffer, offset: Int)
+    
+    companion object {
+        /**
+         * nativeSize de la clase o 0 si no es un NativeComponent
+         */
+        fun sizeOf(klass: KClass<out Component>): Int {
+            if (!NativeComponent::class.java.isAssignableFrom(klass.java)) return 0
+            return (create(klass) as NativeComponent).nativeSize
+        }
+        
+        /**
+         * Instancia vacía para leer una fila de la columna
+         */
+        fun <T : Component> create(klass: KClass<out T>): T =
+            klass.java.getDeclaredConstructor().newInstance()
+    }
+}
+
 /**
  * ID de tipo de componente único generado en compile-time
  */
@@ -24,6 +67,7 @@ value class ComponentType(val id: Int) {
     companion object {
         private var nextId = 0
         private val typeMap = mutableMapOf<KClass<out Component>, ComponentType>()
+        private val classes = ArrayList<KClass<out Component>>()
         
         /**
          * Obtiene o crea el ComponentType para una clase
@@ -32,12 +76,20 @@ value class ComponentType(val id: Int) {
             return of(T::class)
         }
         
+        @Synchronized
         fun <T : Component> of(klass: KClass<T>): ComponentType {
             return typeMap.getOrPut(klass) {
+                classes.add(klass)
                 ComponentType(nextId++)
             }
         }
         
+        /**
+         * Clase registrada para un tipo
+         */
+        @Synchronized
+        fun classOf(type: ComponentType): KClass<out Component> = classes[type.id]
+        
         /**
          * Número total de tipos de componentes registrados
          */
@@ -122,6 +174,15 @@ data class ComponentMask(
         bits.fill(0L)
     }
     
+    /**
+     * Activa todos los tipos de mask
+     */
+    fun setAll(mask: ComponentMask) {
+        for (i in bits.indices) {
+            bits[i] = bits[i] or mask.bits[i]
+        }
+    }
+    
     fun copy(): ComponentMask = ComponentMask(bits.copyOf())
     
     override fun equals(other: Any?): Boolean {
@@ -132,117 +193,3 @@ data class ComponentMask(
     
     override fun hashCode(): Int = bits.contentHashCode()
 }
-
-/**
- * Archetype - Patrón de componentes compartido por múltiples entidades
- * 
- * Las entidades con los mismos componentes comparten el mismo Archetype
- * para optimizar el cache y permitir procesamiento por lotes.
- */
-data class Archetype(
-    val mask: ComponentMask,
-    val types: List<ComponentType>
-) {
-    val id: Int = nextId++
-    
-    companion object {
-        private var nextId = 0
-    }
-    
-    /**
-     * Verifica si este archetype coincide con los requisitos de un sistema
-     */
-    fun matches(
-        required: ComponentMask,
-        excluded: ComponentMask = ComponentMask()
-    ): Boolean {
-        return mask.hasAll(required) && mask.hasNone(excluded)
-    }
-}
-
-/**
- * Pool de componentes para un tipo específico
- * Almacenamiento denso para mejor cache locality
- */
-class ComponentPool<T : Component>(
-    val componentType: ComponentType,
-    initialCapacity: Int = 256
-) {
-    private val components = ArrayList<T>(initialCapacity)
-    private val entityToIndex = mutableMapOf<Entity, Int>()
-    private val indexToEntity = mutableMapOf<Int, Entity>()
-    
-    val size: Int get() = components.size
-    
-    /**
-     * Añade un componente para una entidad
-     */
-    fun add(entity: Entity, component: T) {
-        val index = components.size
-        components.add(component)
-        entityToIndex[entity] = index
-        indexToEntity[index] = entity
-    }
-    
-    /**
-     * Obtiene el componente de una entidad
-     */
-    fun get(entity: Entity): T? {
-        val index = entityToIndex[entity] ?: return null
-        return components.getOrNull(index)
-    }
-    
-    /**
-     * Elimina el componente de una entidad
-     */
-    fun remove(entity: Entity): T? {
-        val index = entityToIndex.remove(entity) ?: return null
-        val component = components[index]
-        
-        // Swap con el último elemento para mantener densidad
-        val lastIndex = components.lastIndex
-        if (index != lastIndex) {
-            val lastEntity = indexToEntity[lastIndex]!!
-            components[index] = components[lastIndex]
-            entityToIndex[lastEntity] = index
-            indexToEntity[index] = lastEntity
-        }
-        
-        components.removeAt(lastIndex)
-        indexToEntity.remove(lastIndex)
-        
-        return component
-    }
-    
-    /**
-     * Verifica si una entidad tiene este componente
-     */
-    fun has(entity: Entity): Boolean = entity in entityToIndex
-    
-    /**
-     * Itera sobre todos los componentes
-     */
-    inline fun forEach(action: (Entity, T) -> Unit) {
-        for (i in components.indices) {
-            val entity = indexToEntity[i] ?: continue
-            action(entity, components[i])
-        }
-    }
-    
-    /**
-     * Obtiene todos los componentes como lista
-     */
-    fun getAll(): List<Pair<Entity, T>> {
-        return components.indices.mapNotNull { i ->
-            indexToEntity[i]?.let { entity ->
-                entity to components[i]
-            }
-        }
-    }
-    
-    fun clear() {
-        components.clear()
-        entityToIndex.clear()
-        indexToEntity.clear()
-    }
-}
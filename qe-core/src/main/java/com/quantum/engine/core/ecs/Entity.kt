@@ -21,6 +21,11 @@ value class Entity(val id: Long) {
          */
         fun create(): Entity = Entity(nextId.getAndIncrement())
         
+        /**
+         * Reserva count IDs consecutivos y devuelve el primero
+         */
+        fun createRange(count: Int): Entity = Entity(nextId.getAndAdd(count.toLong()))
+        
         /**
          * Entity nula para representar ausencia
          */
@@ -2,47 +2,74 @@ package com.quantum.engine.core.ecs
 
 import timber.log.Timber
 import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.CopyOnWriteArrayList
 import kotlin.reflect.KClass
 
 /**
  * EntityManager - Gestor central del sistema ECS
- * 
+ *
  * Maneja la creación, destrucción y consulta de entidades y componentes.
- * Thread-safe para permitir creación/destrucción desde múltiples threads.
+ * Los componentes viven en chunks por archetype (ArchetypeStore): añadir o
+ * quitar un componente mueve la entidad de archetype, y los sistemas pueden
+ * recorrer los chunks con forEachChunk() sin búsquedas por entidad.
+ * Thread-safe para permitir creación/destrucción desde múltiples threads:
+ * los cambios estructurales se serializan sobre el store. Dentro de los
+ * sistemas se graban en el EntityCommandBuffer del thread (commandBuffer())
+ * y se aplican en lote en playbackCommands(). Durante una etapa en paralelo
+ * de SystemManager, createEntity(), addComponent() y removeComponent() se
+ * graban ahí solas: crear un archetype o mover filas mientras otros workers
+ * recorren chunks y consultas corrompería su recorrido.
  */
 class EntityManager {
     
-    // Almacenamiento de componentes por tipo
-    private val componentPools = ConcurrentHashMap<ComponentType, ComponentPool<*>>()
+    // Chunks por archetype en memoria nativa
+    private val store = ArchetypeStore()
     
-    // Máscara de componentes por entidad
-    private val entityMasks = ConcurrentHashMap<Entity, ComponentMask>()
+    // Ubicación (chunk, fila) de cada entidad viva
+    private val records = ConcurrentHashMap<Entity, EntityRecord>()
     
     // Metadatos de entidades
     private val entityMetadata = ConcurrentHashMap<Entity, EntityMetadata>()
     
-    // Entidades por archetype
-    private val archetypes = ConcurrentHashMap<ComponentMask, Archetype>()
-    private val entityToArchetype = ConcurrentHashMap<Entity, Archetype>()
+    // Buffers de comandos, uno por thread, en orden de creación
+    private val commandBuffers = CopyOnWriteArrayList<EntityCommandBuffer>()
+    private val threadCommandBuffers = ThreadLocal.withInitial {
+        EntityCommandBuffer().also { commandBuffers.add(it) }
+    }
     
-    // Entidades pendientes de destrucción
-    private val entitiesToDestroy = mutableSetOf<Entity>()
+    // Estado de la reproducción, reutilizado entre frames
+    private val pendingByEntity = HashMap<Entity, PendingEntity>()
+    private val pendingEntities = ArrayList<PendingEntity>()
+    private val pendingPool = ArrayList<PendingEntity>()
+    private val createdByArchetype = HashMap<Archetype, ArrayList<PendingEntity>>()
+    private var batchRecords = arrayOfNulls<EntityRecord>(64)
+    private var batchTargets = arrayOfNulls<Archetype>(64)
     
     // Estadísticas
-    var entityCount: Int = 0
-        private set
+    val entityCount: Int get() = records.size
+    
+    /**
+     * Archetypes creados hasta ahora, en orden de creación
+     */
+    val archetypes: List<Archetype> get() = store.archetypes
     
     /**
-     * Crea una nueva entidad
+     * Crea una nueva entidad; durante una etapa en paralelo sólo existe tras
+     * playbackCommands()
      */
     fun createEntity(name: String? = null): Entity {
+        if (store.inParallelStage) return commandBuffer().createEntity(name)
+        
         val entity = Entity.create()
-        entityMasks[entity] = ComponentMask()
+        val record = EntityRecord(entity)
+        synchronized(store) {
+            store.add(record, store.emptyArchetype)
+        }
+        records[entity] = record
         entityMetadata[entity] = EntityMetadata(
             entity = entity,
             name = name ?: "Entity_${entity.id}"
         )
-        entityCount++
         
         Timber.d("Created entity: ${entity.id} - ${entityMetadata[entity]?.name}")
         return entity
@@ -54,22 +81,161 @@ class EntityManager {
     fun destroyEntity(entity: Entity) {
         if (!isValid(entity)) return
         
-        // Marcar para destrucción al final del frame
-        entitiesToDestroy.add(entity)
+        // Marcar para destrucción en el próximo punto de sincronización
+        commandBuffer().destroyEntity(entity)
     }
     
     /**
-     * Destruye todas las entidades marcadas
+     * Destruye todas las entidades marcadas (y aplica el resto de comandos)
      * Debe llamarse al final de cada frame
      */
     fun processDestroyedEntities() {
-        for (entity in entitiesToDestroy) {
-            destroyEntityImmediate(entity)
+        playbackCommands()
+    }
+    
+    /**
+     * Buffer de comandos del thread actual; es lo que deben usar los sistemas
+     * para crear, destruir o cambiar componentes mientras se ejecutan
+     */
+    fun commandBuffer(): EntityCommandBuffer = threadCommandBuffers.get()
+    
+    /**
+     * Punto de sincronización: reproduce los buffers de todos los threads.
+     * No debe haber sistemas ejecutándose; SystemManager lo llama al final
+     * de update() y fixedUpdate().
+     */
+    fun playbackCommands() {
+        check(!store.inParallelStage) { "playbackCommands() during a parallel system stage" }
+        for (buffer in commandBuffers) {
+            if (buffer.isEmpty) continue
+            synchronized(store) {
+                playback(buffer)
+            }
+            buffer.clear()
+        }
+    }
+    
+    private fun playback(buffer: EntityCommandBuffer) {
+        // Copias de prefabs: antes que el resto de comandos
+        for (i in 0 until buffer.size) {
+            if (buffer.ops[i] == EntityCommandBuffer.INSTANTIATE) {
+                instantiateNow(Entity(buffer.entities[i]), buffer.payloads[i] as Entity, buffer.args[i])
+            }
+        }
+        
+        // Plegar los comandos en el estado final de cada entidad
+        for (i in 0 until buffer.size) {
+            val entity = Entity(buffer.entities[i])
+            when (buffer.ops[i]) {
+                EntityCommandBuffer.CREATE ->
+                    pendingFor(entity, created = true)?.name = buffer.payloads[i] as String?
+                EntityCommandBuffer.DESTROY ->
+                    pendingFor(entity)?.destroyed = true
+                EntityCommandBuffer.ADD_COMPONENT ->
+                    pendingFor(entity)?.add(ComponentType(buffer.args[i]), buffer.payloads[i] as Component)
+                EntityCommandBuffer.REMOVE_COMPONENT ->
+                    pendingFor(entity)?.remove(ComponentType(buffer.args[i]))
+            }
+        }
+        
+        playbackCreated()
+        playbackChanged()
+        playbackDestroyed()
+        
+        pendingPool.addAll(pendingEntities)
+        pendingEntities.clear()
+        pendingByEntity.clear()
+    }
+    
+    /**
+     * Entidades nuevas: una llamada nativa por archetype destino
+     */
+    private fun playbackCreated() {
+        for (pending in pendingEntities) {
+            if (!pending.created || pending.destroyed) continue
+            createdByArchetype.getOrPut(store.archetypeOf(pending.mask)) { ArrayList() }.add(pending)
+        }
+        
+        for ((archetype, group) in createdByArchetype) {
+            if (group.isEmpty()) continue
+            ensureBatchCapacity(group.size)
+            for (i in group.indices) {
+                batchRecords[i] = EntityRecord(group[i].entity)
+            }
+            store.addAll(batchRecords, group.size, archetype)
+            
+            for (i in group.indices) {
+                val pending = group[i]
+                val record = batchRecords[i]!!
+                records[pending.entity] = record
+                entityMetadata[pending.entity] = EntityMetadata(
+                    entity = pending.entity,
+                    name = pending.name ?: "Entity_${pending.entity.id}"
+                )
+                for (j in pending.types.indices) {
+                    writeComponent(record, pending.types[j], pending.components[j])
+                }
+            }
+            Timber.v("Created ${group.size} entities in $archetype")
+            group.clear()
+        }
+        batchRecords.fill(null)
+    }
+    
+    /**
+     * Entidades existentes: como mucho un movimiento por entidad, en lote
+     */
+    private fun playbackChanged() {
+        var count = 0
+        for (pending in pendingEntities) {
+            if (pending.created || pending.destroyed) continue
+            val record = records[pending.entity] ?: continue
+            ensureBatchCapacity(count + 1)
+            batchRecords[count] = record
+            batchTargets[count] = store.archetypeOf(pending.mask)
+            count++
+        }
+        store.moveAll(batchRecords, batchTargets, count)
+        batchRecords.fill(null)
+        batchTargets.fill(null)
+        
+        for (pending in pendingEntities) {
+            if (pending.created || pending.destroyed) continue
+            val record = records[pending.entity] ?: continue
+            for (j in pending.types.indices) {
+                writeComponent(record, pending.types[j], pending.components[j])
+            }
+        }
+    }
+    
+    /**
+     * Destrucciones (con los hijos), quitadas del store en lote
+     */
+    private fun playbackDestroyed() {
+        val destroyed = ArrayList<EntityRecord>()
+        for (pending in pendingEntities) {
+            if (pending.destroyed && !pending.created) {
+                collectDestroyed(pending.entity, destroyed)
+            }
+        }
+        if (destroyed.isEmpty()) return
+        
+        ensureBatchCapacity(destroyed.size)
+        for (i in destroyed.indices) {
+            batchRecords[i] = destroyed[i]
+            batchTargets[i] = null
         }
-        entitiesToDestroy.clear()
+        store.moveAll(batchRecords, batchTargets, destroyed.size)
+        batchRecords.fill(null)
+        
+        Timber.d("Destroyed ${destroyed.size} entities")
     }
     
-    private fun destroyEntityImmediate(entity: Entity) {
+    /**
+     * Quita la entidad y sus hijos de la jerarquía y de records; sus filas
+     * se añaden a out
+     */
+    private fun collectDestroyed(entity: Entity, out: MutableList<EntityRecord>) {
         // Eliminar de jerarquía
         val metadata = entityMetadata[entity]
         metadata?.parent?.let { parent ->
@@ -78,23 +244,67 @@ class EntityManager {
         
         // Destruir hijos recursivamente
         metadata?.children?.toList()?.forEach { child ->
-            destroyEntityImmediate(child)
+            collectDestroyed(child, out)
         }
         
-        // Eliminar todos los componentes
-        val mask = entityMasks[entity] ?: return
-        componentPools.values.forEach { pool ->
-            @Suppress("UNCHECKED_CAST")
-            (pool as ComponentPool<Component>).remove(entity)
+        // Eliminar la fila y con ella todos los componentes
+        val record = records.remove(entity) ?: return
+        entityMetadata.remove(entity)
+        out.add(record)
+    }
+    
+    /**
+     * count copias de prefab con IDs consecutivos desde first
+     */
+    private fun instantiateNow(prefab: Entity, first: Entity, count: Int) {
+        val source = records[prefab]
+        if (source == null) {
+            Timber.w("Cannot instantiate invalid entity: $prefab")
+            return
         }
         
-        // Limpiar referencias
-        entityMasks.remove(entity)
-        entityMetadata.remove(entity)
-        entityToArchetype.remove(entity)
-        entityCount--
+        ensureBatchCapacity(count)
+        for (i in 0 until count) {
+            batchRecords[i] = EntityRecord(Entity(first.id + i))
+        }
+        store.instantiate(source, batchRecords, count)
         
-        Timber.d("Destroyed entity: ${entity.id}")
+        val prefabMetadata = entityMetadata[prefab]
+        for (i in 0 until count) {
+            val record = batchRecords[i]!!
+            records[record.entity] = record
+            entityMetadata[record.entity] = EntityMetadata(
+                entity = record.entity,
+                tag = prefabMetadata?.tag ?: "",
+                layer = prefabMetadata?.layer ?: 0
+            )
+        }
+        batchRecords.fill(null)
+        
+        Timber.v("Instantiated $count copies of entity ${prefab.id}")
+    }
+    
+    /**
+     * Estado pendiente de la entidad; null si no existe y no se creó en
+     * este buffer
+     */
+    private fun pendingFor(entity: Entity, created: Boolean = false): PendingEntity? {
+        pendingByEntity[entity]?.let { return it }
+        
+        val currentMask = if (created) null else (records[entity]?.archetype?.mask ?: return null)
+        val pending = if (pendingPool.isEmpty()) PendingEntity() else pendingPool.removeAt(pendingPool.size - 1)
+        pending.reset(entity, created, currentMask)
+        pendingByEntity[entity] = pending
+        pendingEntities.add(pending)
+        return pending
+    }
+    
+    private fun ensureBatchCapacity(count: Int) {
+        if (batchRecords.size < count) {
+            val capacity = maxOf(count, batchRecords.size * 2)
+            batchRecords = batchRecords.copyOf(capacity)
+            batchTargets = batchTargets.copyOf(capacity)
+        }
     }
     
     /**
@@ -104,23 +314,24 @@ class EntityManager {
         return addComponent(entity, component, T::class)
     }
     
-    @Suppress("UNCHECKED_CAST")
+    /**
+     * Añade (o reemplaza) un componente: la entidad pasa al archetype con
+     * ese tipo. Durante una etapa en paralelo se graba en commandBuffer().
+     */
     fun <T : Component> addComponent(entity: Entity, component: T, klass: KClass<T>): T {
-        if (!isValid(entity)) {
-            throw IllegalStateException("Cannot add component to invalid entity: $entity")
+        if (store.inParallelStage) {
+            commandBuffer().addComponent(entity, ComponentType.of(klass), component)
+            return component
         }
         
-        val componentType = ComponentType.of(klass)
-        val pool = componentPools.getOrPut(componentType) {
-            ComponentPool<T>(componentType)
-        } as ComponentPool<T>
-        
-        pool.add(entity, component)
+        val record = records[entity]
+            ?: throw IllegalStateException("Cannot add component to invalid entity: $entity")
         
-        // Actualizar máscara y archetype
-        val mask = entityMasks[entity]!!
-        mask.set(componentType)
-        updateArchetype(entity, mask)
+        val componentType = ComponentType.of(klass)
+        synchronized(store) {
+            store.move(record, store.archetypeWith(record.archetype, componentType))
+            writeComponent(record, componentType, component)
+        }
         
         Timber.v("Added component ${klass.simpleName} to entity ${entity.id}")
         return component
@@ -133,13 +344,59 @@ class EntityManager {
         return getComponent(entity, T::class)
     }
     
+    /**
+     * Componente de la entidad; para un NativeComponent, una copia leída de
+     * su columna
+     */
     @Suppress("UNCHECKED_CAST")
     fun <T : Component> getComponent(entity: Entity, klass: KClass<T>): T? {
-        if (!isValid(entity)) return null
+        val record = records[entity] ?: return null
+        val chunk = record.chunk
+        val column = chunk.archetype.columnOf(ComponentType.of(klass))
+        if (column < 0) return null
         
+        val components = chunk.components[column] ?: return readNative(chunk, column, record.row, klass)
+        return components[record.row] as T?
+    }
+    
+    /**
+     * getComponent() para modificar el componente: marca su columna como
+     * cambiada en el chunk de la entidad. Para un NativeComponent devuelve
+     * una copia y el cambio se guarda con setComponent().
+     */
+    inline fun <reified T : Component> getComponentForWrite(entity: Entity): T? {
+        markChanged(entity, ComponentType.of<T>())
+        return getComponent(entity, T::class)
+    }
+    
+    /**
+     * Marca el componente de la entidad como cambiado (tras modificarlo a
+     * través de una referencia obtenida con getComponent())
+     */
+    inline fun <reified T : Component> markChanged(entity: Entity) {
+        markChanged(entity, ComponentType.of<T>())
+    }
+    
+    fun markChanged(entity: Entity, type: ComponentType) {
+        records[entity]?.chunk?.markChanged(type)
+    }
+    
+    /**
+     * Guarda un componente que la entidad ya tiene sin cambiarla de archetype;
+     * es como se escriben los NativeComponent leídos con getComponent()
+     */
+    inline fun <reified T : Component> setComponent(entity: Entity, component: T) {
+        setComponent(entity, component, T::class)
+    }
+    
+    fun <T : Component> setComponent(entity: Entity, component: T, klass: KClass<T>) {
+        val record = records[entity] ?: return
         val componentType = ComponentType.of(klass)
-        val pool = componentPools[componentType] as? ComponentPool<T> ?: return null
-        return pool.get(entity)
+        if (!record.archetype.has(componentType)) {
+            addComponent(entity, component, klass)
+            return
+        }
+        writeComponent(record, componentType, component)
     }
     
     /**
@@ -149,23 +406,27 @@ class EntityManager {
         return removeComponent(entity, T::class)
     }
     
-    @Suppress("UNCHECKED_CAST")
+    /**
+     * Quita el componente y lo devuelve. Durante una etapa en paralelo se
+     * graba en commandBuffer() y devuelve el valor actual.
+     */
     fun <T : Component> removeComponent(entity: Entity, klass: KClass<T>): T? {
-        if (!isValid(entity)) return null
-        
+        val record = records[entity] ?: return null
         val componentType = ComponentType.of(klass)
-        val pool = componentPools[componentType] as? ComponentPool<T> ?: return null
-        val component = pool.remove(entity)
         
-        if (component != null) {
-            // Actualizar máscara y archetype
-            val mask = entityMasks[entity]!!
-            mask.unset(componentType)
-            updateArchetype(entity, mask)
-            
-            Timber.v("Removed component ${klass.simpleName} from entity ${entity.id}")
+        if (store.inParallelStage) {
+            val component = getComponent(entity, klass) ?: return null
+            commandBuffer().removeComponent(entity, componentType)
+            return component
+        }
+        
+        val component = synchronized(store) {
+            val component = getComponent(entity, klass) ?: return null
+            store.move(record, store.archetypeWithout(record.archetype, componentType))
+            component
         }
         
+        Timber.v("Removed component ${klass.simpleName} from entity ${entity.id}")
         return component
     }
     
@@ -177,11 +438,8 @@ class EntityManager {
     }
     
     fun <T : Component> hasComponent(entity: Entity, klass: KClass<T>): Boolean {
-        if (!isValid(entity)) return false
-        
-        val componentType = ComponentType.of(klass)
-        val mask = entityMasks[entity] ?: return false
-        return mask.has(componentType)
+        val record = records[entity] ?: return false
+        return record.archetype.has(ComponentType.of(klass))
     }
     
     /**
@@ -198,14 +456,23 @@ class EntityManager {
      * Obtiene todos los componentes de una entidad
      */
     fun getAllComponents(entity: Entity): List<Component> {
-        if (!isValid(entity)) return emptyList()
-        
-        return componentPools.values.mapNotNull { pool ->
-            @Suppress("UNCHECKED_CAST")
-            (pool as ComponentPool<Component>).get(entity)
+        val record = records[entity] ?: return emptyList()
+        val chunk = record.chunk
+        return chunk.archetype.types.indices.mapNotNull { column ->
+            val components = chunk.components[column]
+            if (components != null) {
+                components[record.row] as Component?
+            } else {
+                readNative(chunk, column, record.row, ComponentType.classOf(chunk.archetype.types[column]))
+            }
         }
     }
     
+    /**
+     * Archetype actual de una entidad
+     */
+    fun getArchetype(entity: Entity): Archetype? = records[entity]?.archetype
+    
     /**
      * Obtiene metadatos de una entidad
      */
@@ -214,7 +481,7 @@ class EntityManager {
     /**
      * Verifica si una entidad es válida
      */
-    fun isValid(entity: Entity): Boolean = entity in entityMasks
+    fun isValid(entity: Entity): Boolean = entity in records
     
     /**
      * Establece la jerarquía padre-hijo
@@ -235,86 +502,287 @@ class EntityManager {
     }
     
     /**
-     * Actualiza el archetype de una entidad
+     * Recorre los chunks con entidades de los archetypes que tienen todos los
+     * tipos de required y ninguno de excluded
      */
-    private fun updateArchetype(entity: Entity, mask: ComponentMask) {
-        val archetype = archetypes.getOrPut(mask.copy()) {
-            val types = mutableListOf<ComponentType>()
-            for (i in 0 until ComponentType.count) {
-                val type = ComponentType(i)
-                if (mask.has(type)) {
-                    types.add(type)
+    inline fun forEachChunk(
+        required: ComponentMask,
+        excluded: ComponentMask = ComponentMask(),
+        action: (ArchetypeChunk) -> Unit
+    ) {
+        val archetypes = archetypes
+        for (i in 0 until archetypes.size) {
+            val archetype = archetypes[i]
+            if (archetype.entityCount == 0 || !archetype.matches(required, excluded)) continue
+            val chunks = archetype.chunks
+            for (j in 0 until chunks.size) {
+                val chunk = chunks[j]
+                if (chunk.count > 0) action(chunk)
+            }
+        }
+    }
+    
+    /**
+     * Entidades de los archetypes cuya máscara cumple predicate
+     */
+    fun query(predicate: (ComponentMask) -> Boolean): List<Entity> {
+        val result = ArrayList<Entity>()
+        for (archetype in archetypes) {
+            if (archetype.entityCount == 0 || !predicate(archetype.mask)) continue
+            for (chunk in archetype.chunks) {
+                for (row in 0 until chunk.count) {
+                    result.add(chunk.entity(row))
                 }
             }
-            Archetype(mask.copy(), types)
         }
-        
-        entityToArchetype[entity] = archetype
+        return result
     }
     
     /**
-     * Query builder para consultas de entidades
+     * Consulta cacheada: se construye una vez (normalmente al inicializar el
+     * sistema) y se recorre cada frame sin buscar archetypes
      */
     fun query(): EntityQuery = EntityQuery(this)
     
     /**
-     * Obtiene el pool de componentes de un tipo
+     * Versión actual de cambios del store (ver EntityQuery.changed)
      */
-    @Suppress("UNCHECKED_CAST")
-    fun <T : Component> getComponentPool(klass: KClass<T>): ComponentPool<T>? {
-        val componentType = ComponentType.of(klass)
-        return componentPools[componentType] as? ComponentPool<T>
+    val changeVersion: Long get() = store.changeVersion
+    
+    internal fun registerQuery(query: EntityQuery) {
+        synchronized(store) {
+            store.register(query)
+        }
+    }
+    
+    internal fun unregisterQuery(query: EntityQuery) {
+        synchronized(store) {
+            store.unregister(query)
+        }
     }
     
+    internal fun advanceChangeVersion(): Long = store.advanceChangeVersion()
+    
+    /**
+     * Cierra la ventana de cambios de una consulta: dentro de un sistema de
+     * una etapa en paralelo es la versión de ese sistema (como
+     * System.didChange), fuera avanza la global
+     */
+    internal fun closeChangeWindow(): Long {
+        val version = store.threadWriteVersion()
+        return if (version != 0L) version else store.advanceChangeVersion()
+    }
+    
+    internal fun beginParallelWrites() = store.beginParallelWrites()
+    
+    internal fun endParallelWrites() = store.endParallelWrites()
+    
+    internal fun setThreadWriteVersion(version: Long) = store.setThreadWriteVersion(version)
+    
     /**
      * Limpia todos los datos
      */
     fun clear() {
-        componentPools.values.forEach { it.clear() }
-        componentPools.clear()
-        entityMasks.clear()
+        synchronized(store) {
+            store.clear()
+        }
+        records.clear()
         entityMetadata.clear()
-        archetypes.clear()
-        entityToArchetype.clear()
-        entitiesToDestroy.clear()
-        entityCount = 0
+        commandBuffers.forEach { it.clear() }
         
         Timber.d("EntityManager cleared")
     }
+    
+    private fun writeComponent(record: EntityRecord, type: ComponentType, component: Component) {
+        val chunk = record.chunk
+        val column = chunk.archetype.columnOf(type)
+        val components = chunk.components[column]
+        if (components != null) {
+            components[record.row] = component
+        } else {
+            (component as NativeComponent).write(chunk.nativeColumn(type), record.row * chunk.archetype.sizes[column])
+        }
+        chunk.markChanged(column, store.writeVersion)
+    }
+    
+    private fun <T : Component> readNative(chunk: ArchetypeChunk, column: Int, row: Int, klass: KClass<out T>): T {
+        val component = NativeComponent.create(klass)
+        (component as NativeComponent).read(
+            chunk.nativeColumn(chunk.archetype.types[column]), row * chunk.archetype.sizes[column]
+        )
+        return component
+    }
 }
 
 /**
- * Builder para consultas de entidades
+ * EntityQuery - Consulta de entidades cacheada
+ *
+ * Se describe una vez con with/without/changed y queda registrada en el
+ * store al primer uso: desde entonces recibe cada archetype nuevo que cumple
+ * y recorrerla no reserva memoria ni compara máscaras, sólo pasa por los
+ * chunks de sus archetypes.
+ *
+ * Con changed<T>() sólo se visitan los chunks donde alguno de esos tipos se
+ * escribió o cambió de filas desde el recorrido anterior de esta consulta.
  */
 class EntityQuery(private val entityManager: EntityManager) {
-    private val requiredTypes = mutableListOf<ComponentType>()
-    private val excludedTypes = mutableListOf<ComponentType>()
+    private val requiredMask = ComponentMask()
+    private val excludedMask = ComponentMask()
+    private val changedTypes = mutableListOf<ComponentType>()
+    
+    private var registered = false
+    
+    // Archetypes que cumplen y, por cada uno, las columnas de changedTypes
+    @PublishedApi
+    internal val matchingArchetypes = ArrayList<Archetype>()
+    private val changedColumns = ArrayList<IntArray>()
+    
+    // Versión vista en el último recorrido con filtro de cambios
+    private var lastChangeVersion = 0L
     
-    inline fun <reified T : Component> with(): EntityQuery {
-        requiredTypes.add(ComponentType.of<T>())
+    inline fun <reified T : Component> with(): EntityQuery = with(ComponentType.of<T>())
+    
+    inline fun <reified T : Component> without(): EntityQuery = without(ComponentType.of<T>())
+    
+    /**
+     * Requiere T y además filtra por cambios en su columna
+     */
+    inline fun <reified T : Component> changed(): EntityQuery = changed(ComponentType.of<T>())
+    
+    fun with(type: ComponentType): EntityQuery {
+        checkNotRegistered()
+        requiredMask.set(type)
         return this
     }
     
-    inline fun <reified T : Component> without(): EntityQuery {
-        excludedTypes.add(ComponentType.of<T>())
+    fun without(type: ComponentType): EntityQuery {
+        checkNotRegistered()
+        excludedMask.set(type)
         return this
     }
     
+    fun changed(type: ComponentType): EntityQuery {
+        checkNotRegistered()
+        requiredMask.set(type)
+        changedTypes.add(type)
+        return this
+    }
+    
+    /**
+     * Archetypes que cumplen la consulta, en orden de creación
+     */
+    val archetypes: List<Archetype>
+        get() {
+            ensureRegistered()
+            return matchingArchetypes
+        }
+    
+    /**
+     * Entidades que cumplen (sin filtro de cambios)
+     */
+    val entityCount: Int
+        get() {
+            ensureRegistered()
+            var count = 0
+            for (i in 0 until matchingArchetypes.size) {
+                count += matchingArchetypes[i].entityCount
+            }
+            return count
+        }
+    
+    /**
+     * Cambia cuando entra o sale alguna entidad de la consulta
+     */
+    val structureVersion: Long
+        get() {
+            ensureRegistered()
+            var version = matchingArchetypes.size.toLong()
+            for (i in 0 until matchingArchetypes.size) {
+                version += matchingArchetypes[i].structureVersion
+            }
+            return version
+        }
+    
+    /**
+     * Recorre los chunks con entidades (sólo los cambiados si hay changed<T>())
+     */
+    inline fun forEachChunk(action: (ArchetypeChunk) -> Unit) {
+        ensureRegistered()
+        val archetypes = matchingArchetypes
+        for (i in 0 until archetypes.size) {
+            val archetype = archetypes[i]
+            if (archetype.entityCount == 0) continue
+            val chunks = archetype.chunks
+            for (j in 0 until chunks.size) {
+                val chunk = chunks[j]
+                if (chunk.count > 0 && isChanged(i, chunk)) action(chunk)
+            }
+        }
+        endIteration()
+    }
+    
+    /**
+     * Recorre las entidades en el orden de los chunks
+     */
+    inline fun forEach(action: (Entity) -> Unit) {
+        forEachChunk { chunk ->
+            for (row in 0 until chunk.count) {
+                action(chunk.entity(row))
+            }
+        }
+    }
+    
     fun execute(): List<Entity> {
-        val requiredMask = ComponentMask(*requiredTypes.toTypedArray())
-        val excludedMask = ComponentMask(*excludedTypes.toTypedArray())
-        
-        return entityManager.query {
-            it.hasAll(requiredMask) && it.hasNone(excludedMask)
+        val result = ArrayList<Entity>(entityCount)
+        forEach { result.add(it) }
+        return result
+    }
+    
+    /**
+     * Deja de recibir archetypes nuevos; la consulta se puede volver a usar
+     */
+    fun dispose() {
+        if (!registered) return
+        entityManager.unregisterQuery(this)
+        matchingArchetypes.clear()
+        changedColumns.clear()
+        registered = false
+    }
+    
+    @PublishedApi
+    internal fun ensureRegistered() {
+        if (registered) return
+        registered = true
+        entityManager.registerQuery(this)
+    }
+    
+    @PublishedApi
+    internal fun isChanged(archetypeIndex: Int, chunk: ArchetypeChunk): Boolean {
+        if (changedTypes.isEmpty()) return true
+        val columns = changedColumns[archetypeIndex]
+        val versions = chunk.changeVersions
+        for (column in columns) {
+            if (versions[column] > lastChangeVersion) return true
         }
+        return false
+    }
+    
+    @PublishedApi
+    internal fun endIteration() {
+        if (changedTypes.isEmpty()) return
+        lastChangeVersion = entityManager.closeChangeWindow()
+    }
+    
+    /**
+     * Llamado por el store con cada archetype (existente al registrarse o nuevo)
+     */
+    internal fun onArchetypeCreated(archetype: Archetype) {
+        if (!archetype.matches(requiredMask, excludedMask)) return
+        matchingArchetypes.add(archetype)
+        changedColumns.add(IntArray(changedTypes.size) { archetype.columnOf(changedTypes[it]) })
+    }
+    
+    private fun checkNotRegistered() {
+        check(!registered) { "EntityQuery is already in use" }
     }
-}
-
-/**
- * Extension para EntityManager para queries personalizadas
- */
-inline fun EntityManager.query(predicate: (ComponentMask) -> Boolean): List<Entity> {
-    // Implementación interna que accede a entityMasks
-    // Esta es una versión simplificada
-    return emptyList() // TODO: Implementar acceso interno
 }
@@ -1,5 +1,6 @@
 package com.quantum.engine.core.ecs
 
+import com.quantum.engine.jobs.NativeJobSystem
 import kotlinx.coroutines.*
 import timber.log.Timber
 import kotlin.system.measureTimeMillis
@@ -35,6 +36,53 @@ abstract class System {
      */
     open val parallelizable: Boolean = false
     
+    /**
+     * Componentes que el sistema lee y escribe en onUpdate / onFixedUpdate.
+     * SystemManager ejecuta a la vez los sistemas sin conflictos (ninguno
+     * escribe lo que el otro lee o escribe). Si ambos son null (lo que hace
+     * todo sistema que no los declara) el sistema es exclusivo: corre solo,
+     * en su turno de prioridad y en el hilo de juego, así que un sistema
+     * existente sin declarar nada se ejecuta como antes. Declarar una lista,
+     * aunque esté vacía, lo hace candidato a correr en paralelo.
+     */
+    open val readComponents: List<ComponentType>? = null
+    open val writeComponents: List<ComponentType>? = null
+    
+    /**
+     * Duración media de sus ejecuciones (ns), para ordenar por camino crítico
+     */
+    var averageNanos: Long = 0L
+        internal set
+    
+    /**
+     * Versión de cambios de la ejecución actual: lo que el sistema escribe
+     * ahora queda marcado con ella (la asigna SystemManager)
+     */
+    var systemVersion: Long = 0L
+        internal set
+    
+    /**
+     * systemVersion de la ejecución anterior: los chunks cuyas columnas
+     * tienen una versión mayor cambiaron desde entonces
+     */
+    var lastSystemVersion: Long = 0L
+        internal set
+    
+    /**
+     * ¿Cambió la columna del tipo en el chunk desde la ejecución anterior?
+     */
+    fun didChange(chunk: ArchetypeChunk, type: ComponentType): Boolean =
+        chunk.didChange(type, lastSystemVersion)
+    
+    internal fun beginUpdate(entityManager: EntityManager) {
+        lastSystemVersion = systemVersion
+        systemVersion = entityManager.advanceChangeVersion() + 1
+    }
+    
+    internal fun recordDuration(nanos: Long) {
+        averageNanos = if (averageNanos == 0L) nanos else (averageNanos * 7 + nanos) / 8
+    }
+    
     /**
      * Inicialización del sistema
      */
@@ -74,12 +122,21 @@ abstract class System {
 
 /**
  * Sistema que procesa entidades de forma iterativa
+ *
+ * Las entidades salen de una EntityQuery cacheada con requiredComponents y
+ * excludedComponents; se procesan en el orden de los chunks.
  */
 abstract class IteratingSystem : System() {
     
     // Cache de entidades que coinciden con este sistema
     protected val entities = mutableSetOf<Entity>()
     
+    // Consulta del sistema, creada en el primer update
+    private var query: EntityQuery? = null
+    private var queryManager: EntityManager? = null
+    private var seenStructureVersion = -1L
+    private val currentEntities = HashSet<Entity>()
+    
     override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
         if (!enabled) return
         
@@ -97,10 +154,8 @@ abstract class IteratingSystem : System() {
     }
     
     private fun processSequential(entityManager: EntityManager, deltaTime: Float) {
-        entities.forEach { entity ->
-            if (entityManager.isValid(entity)) {
-                processEntity(entity, entityManager, deltaTime)
-            }
+        queryFor(entityManager).forEach { entity ->
+            processEntity(entity, entityManager, deltaTime)
         }
     }
     
@@ -125,9 +180,54 @@ abstract class IteratingSystem : System() {
         deltaTime: Float
     )
     
-    private fun updateEntityList(entityManager: EntityManager) {
-        // TODO: Implementar actualización eficiente basada en archetypes
-        // Por ahora es una implementación básica
+    /**
+     * Consulta de requiredComponents / excludedComponents para entityManager
+     */
+    protected fun queryFor(entityManager: EntityManager): EntityQuery {
+        query?.let { if (queryManager === entityManager) return it }
+        query?.dispose()
+        
+        val newQuery = entityManager.query()
+        requiredComponents.forEach { newQuery.with(it) }
+        excludedComponents.forEach { newQuery.without(it) }
+        query = newQuery
+        queryManager = entityManager
+        seenStructureVersion = -1L
+        return newQuery
+    }
+    
+    /**
+     * Sincroniza entities con la consulta y llama a onEntityAdded /
+     * onEntityRemoved; sólo recorre la consulta si entró o salió alguna
+     * entidad de sus archetypes. Los sistemas que no usan onUpdate (p. ej.
+     * sólo onFixedUpdate) deben llamarlo antes de usar entities.
+     */
+    protected fun updateEntityList(entityManager: EntityManager) {
+        val query = queryFor(entityManager)
+        val structureVersion = query.structureVersion
+        if (structureVersion == seenStructureVersion) return
+        seenStructureVersion = structureVersion
+        
+        currentEntities.clear()
+        query.forEach { currentEntities.add(it) }
+        
+        val iterator = entities.iterator()
+        while (iterator.hasNext()) {
+            val entity = iterator.next()
+            if (entity !in currentEntities) {
+                iterator.remove()
+                onEntityRemoved(entity, entityManager)
+            }
+        }
+        for (entity in currentEntities) {
+            if (entity !in entities) onEntityAdded(entity, entityManager)
+        }
+    }
+    
+    override fun onShutdown(entityManager: EntityManager) {
+        query?.dispose()
+        query = null
+        queryManager = null
     }
     
     override fun onEntityAdded(entity: Entity, entityManager: EntityManager) {
@@ -141,6 +241,14 @@ abstract class IteratingSystem : System() {
 
 /**
  * SystemManager - Gestiona todos los sistemas del motor
+ *
+ * Con parallelStages y el pool nativo disponible, cada etapa (update y
+ * fixedUpdate) se ejecuta como un grafo de dependencias según
+ * readComponents / writeComponents: los sistemas sin conflictos corren a la
+ * vez en los workers, empezando por la cadena más larga. Las versiones de
+ * cambio se asignan en orden de prioridad antes de la etapa y cada hilo
+ * marca sus escrituras con la de su sistema, así que didChange() da lo
+ * mismo que en secuencial.
  */
 class SystemManager(private val entityManager: EntityManager) {
     
@@ -154,23 +262,38 @@ class SystemManager(private val entityManager: EntityManager) {
     // Métricas de performance
     private val systemTimings = mutableMapOf<String, Float>()
     
+    /**
+     * Ejecutar los sistemas sin conflictos en paralelo (si hay pool nativo)
+     */
+    var parallelStages = true
+    
+    private val scheduler = NativeJobSystem.shared
+    private val updateGraph = scheduler?.let { SystemGraph() }
+    private val fixedUpdateGraph = scheduler?.let { SystemGraph() }
+    private val stageSystems = ArrayList<System>()
+    
     /**
      * Registra un nuevo sistema
+     *
+     * Todo sistema entra en update(): onUpdate es abstracto, así que siempre
+     * está implementado, aunque sea en una clase base como IteratingSystem.
+     * Entra también en fixedUpdate() si alguna clase por debajo de System
+     * sobrescribe onFixedUpdate, incluida una clase base heredada. Antes sólo
+     * contaban los métodos declarados en la propia clase del sistema, y una
+     * subclase de IteratingSystem que sólo implementaba processEntity no se
+     * actualizaba nunca.
      */
     fun <T : System> registerSystem(system: T): T {
         systems.add(system)
         systemsByType[system::class.java] = system
         
         // Clasificar por tipo de update
-        if (system::class.java.declaredMethods.any { 
-            it.name == "onUpdate" && !it.isSynthetic 
-        }) {
-            updateSystems.add(system)
-        }
+        updateSystems.add(system)
         
-        if (system::class.java.declaredMethods.any { 
-            it.name == "onFixedUpdate" && !it.isSynthetic 
-        }) {
+        val fixedUpdate = system::class.java.getMethod(
+            "onFixedUpdate", EntityManager::class.java, Float::class.javaPrimitiveType
+        )
+        if (fixedUpdate.declaringClass != System::class.java) {
             fixedUpdateSystems.add(system)
         }
         
@@ -214,11 +337,20 @@ class SystemManager(private val entityManager: EntityManager) {
      * Actualiza todos los sistemas (variable timestep)
      */
     fun update(deltaTime: Float) {
+        if (runParallel(updateSystems, updateGraph) { it.onUpdate(entityManager, deltaTime) }) {
+            for (system in stageSystems) {
+                systemTimings[system.systemName] = system.averageNanos / 1_000_000_000f
+            }
+            entityManager.playbackCommands()
+            return
+        }
+        
         for (system in updateSystems) {
             if (!system.enabled) continue
             
             val time = measureTimeMillis {
                 try {
+                    system.beginUpdate(entityManager)
                     system.onUpdate(entityManager, deltaTime)
                 } catch (e: Exception) {
                     Timber.e(e, "Error updating system: ${system.systemName}")
@@ -227,21 +359,77 @@ class SystemManager(private val entityManager: EntityManager) {
             
             systemTimings[system.systemName] = time / 1000f
         }
+        
+        // Punto de sincronización: cambios estructurales grabados por los sistemas
+        entityManager.playbackCommands()
     }
     
     /**
      * Actualiza sistemas de física (fixed timestep)
      */
     fun fixedUpdate(fixedDeltaTime: Float) {
+        if (runParallel(fixedUpdateSystems, fixedUpdateGraph) { it.onFixedUpdate(entityManager, fixedDeltaTime) }) {
+            entityManager.playbackCommands()
+            return
+        }
+        
         for (system in fixedUpdateSystems) {
             if (!system.enabled) continue
             
             try {
+                system.beginUpdate(entityManager)
                 system.onFixedUpdate(entityManager, fixedDeltaTime)
             } catch (e: Exception) {
                 Timber.e(e, "Error in fixed update for system: ${system.systemName}")
             }
         }
+        
+        entityManager.playbackCommands()
+    }
+    
+    /**
+     * Ejecuta los sistemas activos de la etapa como grafo en el pool nativo;
+     * false si toca hacerlo en secuencial (sin pool o con menos de dos)
+     */
+    private inline fun runParallel(
+        stage: List<System>,
+        graph: SystemGraph?,
+        crossinline body: (System) -> Unit
+    ): Boolean {
+        val scheduler = scheduler ?: return false
+        if (graph == null || graph.isClosed || !parallelStages) return false
+        
+        stageSystems.clear()
+        for (system in stage) {
+            if (system.enabled) stageSystems.add(system)
+        }
+        if (stageSystems.size < 2) return false
+        
+        // Versiones en orden de prioridad, como en secuencial
+        for (system in stageSystems) {
+            system.beginUpdate(entityManager)
+        }
+        graph.build(stageSystems)
+        
+        entityManager.beginParallelWrites()
+        try {
+            graph.run(scheduler) { index, _ ->
+                val system = stageSystems[index]
+                entityManager.setThreadWriteVersion(system.systemVersion)
+                val start = java.lang.System.nanoTime()
+                try {
+                    body(system)
+                } catch (e: Exception) {
+                    Timber.e(e, "Error updating system: ${system.systemName}")
+                } finally {
+                    system.recordDuration(java.lang.System.nanoTime() - start)
+                    entityManager.setThreadWriteVersion(0L)
+                }
+            }
+        } finally {
+            entityManager.endParallelWrites()
+        }
+        return true
     }
     
     /**
@@ -260,17 +448,19 @@ class SystemManager(private val entityManager: EntityManager) {
     }
     
     private fun checkEntityMatchesSystem(entity: Entity, system: System): Boolean {
+        val mask = entityManager.getArchetype(entity)?.mask ?: return false
+        
         // Verificar componentes requeridos
         for (componentType in system.requiredComponents) {
-            // TODO: Implementar verificación real
+            if (!mask.has(componentType)) return false
         }
         
         // Verificar componentes excluidos
         for (componentType in system.excludedComponents) {
-            // TODO: Implementar verificación real
+            if (mask.has(componentType)) return false
         }
         
-        return true // Placeholder
+        return true
     }
     
     /**
@@ -290,6 +480,9 @@ class SystemManager(private val entityManager: EntityManager) {
         updateSystems.clear()
         fixedUpdateSystems.clear()
         systemTimings.clear()
+        stageSystems.clear()
+        updateGraph?.close()
+        fixedUpdateGraph?.close()
         
         Timber.d("SystemManager shutdown")
     }
@@ -306,6 +499,8 @@ class TransformSystem : IteratingSystem() {
     
     override val systemName = "TransformSystem"
     override val requiredComponents = listOf(ComponentType.of<com.quantum.engine.core.components.TransformComponent>())
+    override val readComponents = requiredComponents
+    override val writeComponents = requiredComponents
     override val priority = -100 // Alta prioridad
     
     override fun processEntity(
@@ -339,6 +534,14 @@ class TransformSystem : IteratingSystem() {
         
         if (transform.isDirty) {
             transform.updateMatrix()
+            transform.worldMatrix = if (metadata?.parent != null && metadata.parent != Entity.NULL) {
+                com.quantum.engine.math.Matrix4.trs(transform.worldPosition, transform.worldRotation, transform.worldScale)
+            } else {
+                transform.localMatrix
+            }
+            
+            // Sólo las transformaciones recalculadas cuentan como cambio
+            entityManager.markChanged<com.quantum.engine.core.components.TransformComponent>(entity)
         }
     }
 }
@@ -0,0 +1,98 @@
+package com.quantum.engine.core.ecs
+
+import com.quantum.engine.jobs.JobBody
+import com.quantum.engine.jobs.NativeJobSystem
+
+/**
+ * SystemGraph - Grafo de dependencias de una etapa de sistemas (nativo)
+ *
+ * build() pasa en una llamada JNI las máscaras de lectura / escritura y el
+ * coste medio de cada sistema; run() ejecuta body(i, i + 1) para cada uno
+ * en el pool nativo respetando los conflictos, con la cadena crítica
+ * primero (ver system_graph.h). Los sistemas sin readComponents ni
+ * writeComponents son exclusivos: corren en el hilo que llama a run(), sin
+ * nada más en marcha, como barrera entre los tramos paralelos.
+ */
+internal class SystemGraph : AutoCloseable {
+    
+    private var nativeHandle: Long = nativeCreate()
+    
+    private var reads = LongArray(0)
+    private var writes = LongArray(0)
+    private var exclusive = BooleanArray(0)
+    private var costs = LongArray(0)
+    
+    val isClosed: Boolean get() = nativeHandle == 0L
+    
+    /** Aristas del último build() (diagnóstico) */
+    val edgeCount: Int get() = nativeGetEdgeCount(nativeHandle)
+    
+    /** Coste del camino crítico del último build() en ns (diagnóstico) */
+    val criticalPathNanos: Long get() = nativeGetCriticalPath(nativeHandle)
+    
+    /**
+     * Sistemas en orden de prioridad
+     */
+    fun build(systems: List<System>) {
+        val count = systems.size
+        if (exclusive.size < count) {
+            reads = LongArray(count * MASK_WORDS)
+            writes = LongArray(count * MASK_WORDS)
+            exclusive = BooleanArray(count)
+            costs = LongArray(count)
+        }
+        
+        for (i in 0 until count) {
+            val system = systems[i]
+            val read = system.readComponents
+            val write = system.writeComponents
+            reads.fill(0L, i * MASK_WORDS, (i + 1) * MASK_WORDS)
+            writes.fill(0L, i * MASK_WORDS, (i + 1) * MASK_WORDS)
+            read?.forEach { setBit(reads, i, it) }
+            write?.forEach { setBit(writes, i, it) }
+            exclusive[i] = read == null && write == null
+            costs[i] = system.averageNanos
+        }
+        
+        nativeBuild(nativeHandle, count, reads, writes, exclusive, costs)
+    }
+    
+    /**
+     * Bloquea hasta que terminan todos; el hilo que llama también ejecuta
+     */
+    fun run(scheduler: NativeJobSystem, body: JobBody) {
+        nativeRun(nativeHandle, scheduler.handle, body)
+    }
+    
+    override fun close() {
+        if (nativeHandle != 0L) {
+            nativeDestroy(nativeHandle)
+            nativeHandle = 0L
+        }
+    }
+    
+    private fun setBit(masks: LongArray, system: Int, type: ComponentType) {
+        val word = system * MASK_WORDS + (type.id ushr 6)
+        masks[word] = masks[word] or (1L shl (type.id and 63))
+    }
+    
+    companion object {
+        // 256 tipos (ArchetypeStore.MAX_TYPES)
+        const val MASK_WORDS = 4
+        
+        init {
+            // Carga libquantum_core
+            NativeJobSystem.isAvailable
+        }
+    }
+    
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeBuild(
+        handle: Long, count: Int, reads: LongArray, writes: LongArray,
+        exclusive: BooleanArray, costs: LongArray
+    )
+    private external fun nativeRun(handle: Long, scheduler: Long, body: JobBody)
+    private external fun nativeGetEdgeCount(handle: Long): Int
+    private external fun nativeGetCriticalPath(handle: Long): Long
+}
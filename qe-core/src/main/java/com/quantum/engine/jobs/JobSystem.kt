@@ -15,12 +15,17 @@ import kotlin.system.measureTimeMillis
  * - Procesamiento por lotes
  * - SIMD-friendly data layout
  * - Zero allocation cuando es posible
+ *
+ * scheduleParallel() y scheduleTransformJob() van al scheduler nativo
+ * compartido (NativeJobSystem.shared) si está disponible: lotes repartidos
+ * por robo de trabajo en los mismos workers que física y culling.
  */
 class JobSystem(
     private val workerThreads: Int = Runtime.getRuntime().availableProcessors()
 ) {
     
     private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
+    private val native = NativeJobSystem.shared
     private val workers = mutableListOf<Worker>()
     private val jobQueue = Channel<Job>(Channel.UNLIMITED)
     private val completedJobs = ConcurrentHashMap<Long, JobResult>()
@@ -42,9 +47,8 @@ class JobSystem(
         val jobId = nextJobId.getAndIncrement().toLong()
         job.id = jobId
         
-        scope.launch {
-            jobQueue.send(job)
-        }
+        // Canal sin límite: trySend no falla ni necesita una coroutine
+        jobQueue.trySend(job)
         
         return JobHandle(jobId, this)
     }
@@ -57,6 +61,16 @@ class JobSystem(
         batchSize: Int = 64,
         operation: (T) -> Unit
     ): JobHandle<Unit> {
+        native?.let { scheduler ->
+            val counter = JobCounter()
+            scheduler.parallelFor(data.size, batchSize, counter) { begin, end ->
+                for (i in begin until end) {
+                    operation(data[i])
+                }
+            }
+            return JobHandle(nextJobId.getAndIncrement().toLong(), this, counter, data.size)
+        }
+        
         val parallelJob = ParallelJob(
             data = data,
             batchSize = batchSize,
@@ -96,7 +110,17 @@ class JobSystem(
         scales: FloatArray,
         matrices: Array<com.quantum.engine.math.Matrix4>
     ): JobHandle<Unit> {
-        return schedule(TransformJob(positions, rotations, scales, matrices))
+        val job = TransformJob(positions, rotations, scales, matrices)
+        native?.let { scheduler ->
+            val counter = JobCounter()
+            job.scheduleOn(scheduler, counter)
+            return JobHandle(nextJobId.getAndIncrement().toLong(), this, counter, positions.size / 3)
+        }
+        return schedule(job)
+    }
+    
+    internal fun waitNative(counter: JobCounter) {
+        native?.wait(counter)
     }
     
     internal fun getResult(jobId: Long): JobResult? = completedJobs[jobId]
@@ -159,6 +183,10 @@ class ParallelJob<T>(
 
 /**
  * TransformJob - Calcula matrices de transformación en batch
+ *
+ * positions y scales con 3 floats por objeto, rotations con quaternions xyzw
+ * (4 floats). Cada coroutine compone un bloque de TRANSFORM_BATCH_SIZE matrices
+ * con los kernels SIMD de NativeMath en una sola llamada JNI.
  */
 class TransformJob(
     private val positions: FloatArray,
@@ -169,40 +197,72 @@ class TransformJob(
     
     override suspend fun execute(): JobResult {
         val count = positions.size / 3
+        val batches = (count + TRANSFORM_BATCH_SIZE - 1) / TRANSFORM_BATCH_SIZE
+        val packed = FloatArray(count * 16)
         
         coroutineScope {
-            (0 until count).map { i ->
+            (0 until batches).map { batch ->
                 async {
-                    val pos = com.quantum.engine.math.Vector3(
-                        positions[i * 3],
-                        positions[i * 3 + 1],
-                        positions[i * 3 + 2]
-                    )
-                    
-                    // Simplified - en producción calcular quaternion
-                    val rot = com.quantum.engine.math.Quaternion.IDENTITY
-                    
-                    val scale = com.quantum.engine.math.Vector3(
-                        scales[i * 3],
-                        scales[i * 3 + 1],
-                        scales[i * 3 + 2]
-                    )
-                    
-                    matrices[i] = com.quantum.engine.math.Matrix4.trs(pos, rot, scale)
+                    val start = batch * TRANSFORM_BATCH_SIZE
+                    val end = minOf(start + TRANSFORM_BATCH_SIZE, count)
+                    composeBatch(start, end, packed)
                 }
             }.awaitAll()
         }
         
         return JobResult(success = true, itemsProcessed = count)
     }
+    
+    /**
+     * Mismos lotes en el scheduler nativo; counter llega a cero al terminar
+     */
+    internal fun scheduleOn(scheduler: NativeJobSystem, counter: JobCounter) {
+        val count = positions.size / 3
+        val packed = FloatArray(count * 16)
+        scheduler.parallelFor(count, TRANSFORM_BATCH_SIZE, counter) { start, end ->
+            composeBatch(start, end, packed)
+        }
+    }
+    
+    private fun composeBatch(start: Int, end: Int, packed: FloatArray) {
+        if (!com.quantum.engine.math.NativeMath.isAvailable) {
+            for (i in start until end) {
+                matrices[i] = com.quantum.engine.math.Matrix4.trs(
+                    com.quantum.engine.math.Vector3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]),
+                    com.quantum.engine.math.Quaternion(
+                        rotations[i * 4], rotations[i * 4 + 1], rotations[i * 4 + 2], rotations[i * 4 + 3]
+                    ),
+                    com.quantum.engine.math.Vector3(scales[i * 3], scales[i * 3 + 1], scales[i * 3 + 2])
+                )
+            }
+            return
+        }
+        
+        com.quantum.engine.math.NativeMath.composeTRS(
+            positions, rotations, scales, packed, offset = start, count = end - start
+        )
+        
+        for (i in start until end) {
+            matrices[i].set(packed, i * 16)
+        }
+    }
+    
+    companion object {
+        const val TRANSFORM_BATCH_SIZE = 1024
+    }
 }
 
 /**
  * JobHandle - Handle para esperar y obtener resultado
+ *
+ * Con counter, el job corre en el scheduler nativo: complete() espera
+ * ejecutando lotes en el hilo que llama.
  */
 class JobHandle<T>(
     private val jobId: Long,
-    private val jobSystem: JobSystem
+    private val jobSystem: JobSystem,
+    private val counter: JobCounter? = null,
+    private val items: Int = 0
 ) {
     private var completed = false
     private var result: JobResult? = null
@@ -213,6 +273,11 @@ class JobHandle<T>(
     suspend fun complete(): JobResult {
         if (completed) return result!!
         
+        counter?.let {
+            jobSystem.waitNative(it)
+            return finishNative(it)
+        }
+        
         // Polling hasta completar
         while (!completed) {
             jobSystem.getResult(jobId)?.let {
@@ -232,6 +297,11 @@ class JobHandle<T>(
     fun isCompleted(): Boolean {
         if (completed) return true
         
+        counter?.let {
+            if (it.isDone) finishNative(it)
+            return completed
+        }
+        
         jobSystem.getResult(jobId)?.let {
             result = it
             completed = true
@@ -239,6 +309,14 @@ class JobHandle<T>(
         
         return completed
     }
+    
+    private fun finishNative(counter: JobCounter): JobResult {
+        counter.close()
+        val done = JobResult(success = true, itemsProcessed = items)
+        result = done
+        completed = true
+        return done
+    }
 }
 
 /**
@@ -305,8 +383,8 @@ object JobSystemExamples {
     
     fun transformExample(jobSystem: JobSystem) {
         val positions = FloatArray(30000) // 10,000 objetos
-        val rotations = FloatArray(30000)
-        val scales = FloatArray(30000)
+        val rotations = FloatArray(40000) { if (it % 4 == 3) 1f else 0f } // quaternions identidad
+        val scales = FloatArray(30000) { 1f }
         val matrices = Array(10000) { com.quantum.engine.math.Matrix4.identity() }
         
         // Procesar en paralelo
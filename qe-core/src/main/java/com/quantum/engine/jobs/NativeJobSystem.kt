@@ -0,0 +1,139 @@
+package com.quantum.engine.jobs
+
+/**
+ * JobBody - Trabajo de Kotlin sobre el rango [begin, end)
+ */
+fun interface JobBody {
+    fun run(begin: Int, end: Int)
+}
+
+/**
+ * JobCounter - Contador nativo de jobs pendientes
+ *
+ * Cada job programado con él lo incrementa y lo decrementa al terminar.
+ * Sirve de dependencia para schedule(after = ...) y se puede reutilizar
+ * cuando vuelve a cero.
+ */
+class JobCounter : AutoCloseable {
+
+    internal var nativeHandle: Long = nativeCreate()
+        private set
+
+    /** true si no queda ningún job pendiente */
+    val isDone: Boolean
+        get() = nativeIsDone(nativeHandle)
+
+    override fun close() {
+        if (nativeHandle != 0L) {
+            nativeDestroy(nativeHandle)
+            nativeHandle = 0L
+        }
+    }
+
+    companion object {
+        init {
+            // Carga libquantum_core
+            NativeJobSystem.isAvailable
+        }
+    }
+
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(counter: Long)
+    private external fun nativeIsDone(counter: Long): Boolean
+}
+
+/**
+ * NativeJobSystem - Scheduler nativo con robo de trabajo (libquantum_core)
+ *
+ * Un deque Chase–Lev por worker: programar desde un worker no toma locks ni
+ * reserva memoria, y los hilos sin trabajo roban por delante de los demás.
+ * parallelFor() parte el rango sólo cuando hay hilos sin trabajo, siempre en
+ * lotes de batchSize. Las dependencias se expresan con JobCounter.
+ *
+ * handle es un JobScheduler* que las demás librerías nativas (física,
+ * culling, animación) pueden recibir para programar en los mismos workers;
+ * así el motor entero usa un solo pool sin sobresuscribir núcleos. shared es
+ * el pool de todo el motor.
+ *
+ * Los JobBody de Kotlin se ejecutan en los workers (adjuntados a la JVM la
+ * primera vez); una excepción dentro de uno se registra y se descarta. Cada
+ * job de Kotlin cuesta una referencia global y una llamada JNI: para lotes
+ * pequeños compensa más programar en nativo.
+ */
+class NativeJobSystem(
+    workerCount: Int = -1,
+    pinThreads: Boolean = false
+) : AutoCloseable {
+
+    /** JobScheduler* nativo */
+    var handle: Long = nativeCreate(workerCount, pinThreads)
+        private set
+
+    /** Workers además de los hilos que esperan, que también ejecutan jobs */
+    val workerCount: Int
+        get() = nativeGetWorkerCount(handle)
+
+    /**
+     * body(begin, end) en un worker, después de que after (si hay) llegue a
+     * cero; counter (si hay) se decrementa al terminar
+     */
+    fun schedule(
+        counter: JobCounter? = null,
+        after: JobCounter? = null,
+        begin: Int = 0,
+        end: Int = 0,
+        body: JobBody
+    ) {
+        nativeSchedule(handle, body, begin, end, after?.nativeHandle ?: 0L, counter?.nativeHandle ?: 0L)
+    }
+
+    /**
+     * body(begin, end) por lotes de batchSize sobre [0, count). Sin counter
+     * bloquea ayudando hasta el final; con counter vuelve en el acto y el
+     * contador llega a cero cuando terminan todos los lotes.
+     */
+    fun parallelFor(count: Int, batchSize: Int, counter: JobCounter? = null, body: JobBody) {
+        nativeParallelFor(handle, count, batchSize, body, counter?.nativeHandle ?: 0L)
+    }
+
+    /** Espera a counter ejecutando jobs mientras tanto */
+    fun wait(counter: JobCounter) {
+        nativeWait(handle, counter.nativeHandle)
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    companion object {
+        /**
+         * false si la librería nativa no está disponible (p. ej. tests en JVM)
+         */
+        val isAvailable: Boolean = try {
+            java.lang.System.loadLibrary("quantum_core")
+            true
+        } catch (e: UnsatisfiedLinkError) {
+            false
+        }
+
+        /** Pool de todo el motor: núcleos - 1 workers; null sin librería nativa */
+        val shared: NativeJobSystem? by lazy {
+            if (isAvailable) NativeJobSystem() else null
+        }
+    }
+
+    private external fun nativeCreate(workerCount: Int, pinThreads: Boolean): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeGetWorkerCount(handle: Long): Int
+
+    private external fun nativeSchedule(
+        handle: Long, body: JobBody, begin: Int, end: Int, dependency: Long, counter: Long
+    )
+    private external fun nativeParallelFor(
+        handle: Long, count: Int, batchSize: Int, body: JobBody, counter: Long
+    )
+    private external fun nativeWait(handle: Long, counter: Long)
+}
@@ -27,6 +27,9 @@ class ParallelProcessingSystem(
     var jobsProcessed = AtomicInteger(0)
     var totalProcessingTime = 0L
     
+    // Matrices empaquetadas de processTransforms(), reutilizadas entre frames
+    private var transformScratch = FloatArray(0)
+    
     /**
      * Procesa un array en paralelo dividiéndolo en chunks
      */
@@ -72,8 +75,33 @@ class ParallelProcessingSystem(
         }
     }
     
+    /**
+     * Procesa rangos [start, end) en paralelo, para kernels que trabajan por lotes
+     */
+    fun processChunks(
+        count: Int,
+        chunkSize: Int,
+        operation: (start: Int, end: Int) -> Unit
+    ) {
+        val chunks = (count + chunkSize - 1) / chunkSize
+        
+        runBlocking {
+            (0 until chunks).map { chunkIndex ->
+                async(Dispatchers.Default) {
+                    val start = chunkIndex * chunkSize
+                    operation(start, min(start + chunkSize, count))
+                }
+            }.awaitAll()
+        }
+        
+        jobsProcessed.addAndGet(chunks)
+    }
+    
     /**
      * Transform job - Optimizado para transformaciones masivas
+     *
+     * positions/scales de 3 floats y rotations quaternion xyzw de 4. Cada chunk
+     * compone sus matrices con NativeMath (SIMD) en una sola llamada JNI.
      */
     fun processTransforms(
         positions: FloatArray,
@@ -83,27 +111,76 @@ class ParallelProcessingSystem(
     ) {
         val count = positions.size / 3
         
-        processSOA(count) { i ->
-            val pos = com.quantum.engine.math.Vector3(
-                positions[i * 3],
-                positions[i * 3 + 1],
-                positions[i * 3 + 2]
-            )
-            
-            val rot = com.quantum.engine.math.Quaternion(
-                rotations[i * 4],
-                rotations[i * 4 + 1],
-                rotations[i * 4 + 2],
-                rotations[i * 4 + 3]
+        if (!com.quantum.engine.math.NativeMath.isAvailable) {
+            processSOA(count) { i ->
+                val pos = com.quantum.engine.math.Vector3(
+                    positions[i * 3],
+                    positions[i * 3 + 1],
+                    positions[i * 3 + 2]
+                )
+                
+                val rot = com.quantum.engine.math.Quaternion(
+                    rotations[i * 4],
+                    rotations[i * 4 + 1],
+                    rotations[i * 4 + 2],
+                    rotations[i * 4 + 3]
+                )
+                
+                val scale = com.quantum.engine.math.Vector3(
+                    scales[i * 3],
+                    scales[i * 3 + 1],
+                    scales[i * 3 + 2]
+                )
+                
+                matrices[i] = com.quantum.engine.math.Matrix4.trs(pos, rot, scale)
+            }
+            return
+        }
+        
+        if (transformScratch.size < count * 16) {
+            transformScratch = FloatArray(count * 16)
+        }
+        val packed = transformScratch
+        
+        processChunks(count, TRANSFORM_CHUNK_SIZE) { start, end ->
+            com.quantum.engine.math.NativeMath.composeTRS(
+                positions, rotations, scales, packed, offset = start, count = end - start
             )
-            
-            val scale = com.quantum.engine.math.Vector3(
-                scales[i * 3],
-                scales[i * 3 + 1],
-                scales[i * 3 + 2]
+            for (i in start until end) {
+                matrices[i].set(packed, i * 16)
+            }
+        }
+    }
+    
+    /**
+     * Igual que processTransforms() pero escribe matrices column-major empaquetadas
+     * (16 floats por objeto), listas para subir a GPU sin pasar por Matrix4
+     */
+    fun processTransforms(
+        positions: FloatArray,
+        rotations: FloatArray,
+        scales: FloatArray,
+        matrices: FloatArray
+    ) {
+        val count = positions.size / 3
+        
+        if (!com.quantum.engine.math.NativeMath.isAvailable) {
+            val objects = Array(count) { com.quantum.engine.math.Matrix4() }
+            processTransforms(positions, rotations, scales, objects)
+            for (i in 0 until count) {
+                for (column in 0..3) {
+                    for (row in 0..3) {
+                        matrices[i * 16 + column * 4 + row] = objects[i][column, row]
+                    }
+                }
+            }
+            return
+        }
+        
+        processChunks(count, TRANSFORM_CHUNK_SIZE) { start, end ->
+            com.quantum.engine.math.NativeMath.composeTRS(
+                positions, rotations, scales, matrices, offset = start, count = end - start
             )
-            
-            matrices[i] = com.quantum.engine.math.Matrix4.trs(pos, rot, scale)
         }
     }
     
@@ -135,6 +212,11 @@ class ParallelProcessingSystem(
         executor.shutdown()
         scope.cancel()
     }
+    
+    companion object {
+        // Suficiente para amortizar la llamada JNI y repartir entre núcleos
+        const val TRANSFORM_CHUNK_SIZE = 1024
+    }
 }
 
 /**
@@ -24,11 +24,20 @@ class ProceduralGenerationSystem(val seed: Long = Random.nextLong()) {
     private val perlin = PerlinNoise(seed)
     private val simplex = SimplexNoise(seed)
     
+    /**
+     * Alturas en [-1, 1] indexadas terrain[x][y]
+     * 
+     * offsetX/offsetY desplazan la muestra (0, 0): chunks contiguos de un
+     * mundo en streaming generados con offset = coordenada de chunk × (width - 1)
+     * comparten el borde y encajan sin costura.
+     */
     fun generateTerrain(
         width: Int,
         height: Int,
         scale: Float = 1f,
-        octaves: Int = 4
+        octaves: Int = 4,
+        offsetX: Int = 0,
+        offsetY: Int = 0
     ): Array<FloatArray> {
         val terrain = Array(width) { FloatArray(height) }
         
@@ -41,8 +50,8 @@ class ProceduralGenerationSystem(val seed: Long = Random.nextLong()) {
                 
                 // Octaves para detalle
                 repeat(octaves) {
-                    val sampleX = x / scale * frequency
-                    val sampleY = y / scale * frequency
+                    val sampleX = (x + offsetX) / scale * frequency
+                    val sampleY = (y + offsetY) / scale * frequency
                     
                     val noiseValue = perlin.noise(sampleX, sampleY)
                     elevation += noiseValue * amplitude
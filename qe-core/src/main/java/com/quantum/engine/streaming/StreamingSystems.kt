@@ -197,7 +197,10 @@ data class WorldChunk(
 /**
  * LODSystem - Sistema de Level of Detail automático
  * 
- * Ajusta la calidad de los modelos según la distancia
+ * Ajusta la calidad de los modelos según la distancia. Recorre los chunks
+ * de su consulta y, mientras la cámara no se mueva más de
+ * cameraMoveThreshold, sólo los que cambiaron de transformación o de
+ * LODGroup desde el frame anterior.
  */
 class LODSystem : IteratingSystem() {
     
@@ -206,31 +209,99 @@ class LODSystem : IteratingSystem() {
         ComponentType.of<com.quantum.engine.core.components.TransformComponent>(),
         ComponentType.of<LODGroupComponent>()
     )
+    override val readComponents = listOf(
+        ComponentType.of<com.quantum.engine.core.components.TransformComponent>(),
+        ComponentType.of<LODGroupComponent>(),
+        ComponentType.of<com.quantum.engine.core.components.MeshFilterComponent>()
+    )
+    override val writeComponents = listOf(
+        ComponentType.of<LODGroupComponent>(),
+        ComponentType.of<com.quantum.engine.core.components.MeshFilterComponent>()
+    )
+    
+    /**
+     * Posición de la cámara para las distancias de LOD
+     */
+    var cameraPosition = Vector3.ZERO
+    
+    /**
+     * Movimiento de cámara a partir del cual se reevalúan todos los chunks
+     */
+    var cameraMoveThreshold = 0.5f
     
-    private var cameraPosition = Vector3.ZERO
+    private var evaluatedCameraPosition: Vector3? = null
+    
+    private val transformType = ComponentType.of<com.quantum.engine.core.components.TransformComponent>()
+    private val lodGroupType = ComponentType.of<LODGroupComponent>()
+    private val meshFilterType = ComponentType.of<com.quantum.engine.core.components.MeshFilterComponent>()
+    
+    override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
+        if (!enabled) return
+        
+        val evaluated = evaluatedCameraPosition
+        val cameraMoved = evaluated == null ||
+            Vector3.distance(evaluated, cameraPosition) > cameraMoveThreshold
+        if (cameraMoved) evaluatedCameraPosition = cameraPosition
+        
+        queryFor(entityManager).forEachChunk { chunk ->
+            if (!cameraMoved && !didChange(chunk, transformType) && !didChange(chunk, lodGroupType)) {
+                return@forEachChunk
+            }
+            
+            val transforms = chunk.column<com.quantum.engine.core.components.TransformComponent>(transformType)
+            val lodGroups = chunk.column<LODGroupComponent>(lodGroupType)
+            val meshFilters = if (chunk.archetype.has(meshFilterType)) {
+                chunk.column<com.quantum.engine.core.components.MeshFilterComponent>(meshFilterType)
+            } else {
+                null
+            }
+            
+            var changed = false
+            for (row in 0 until chunk.count) {
+                val transform = transforms[row] ?: continue
+                val lodGroup = lodGroups[row] ?: continue
+                if (updateLOD(transform, lodGroup, meshFilters?.get(row))) changed = true
+            }
+            
+            if (changed) {
+                chunk.markChanged(lodGroupType)
+                if (meshFilters != null) chunk.markChanged(meshFilterType)
+            }
+        }
+    }
     
     override fun processEntity(entity: Entity, entityManager: EntityManager, deltaTime: Float) {
         val transform = entityManager.getComponent<com.quantum.engine.core.components.TransformComponent>(entity)!!
         val lodGroup = entityManager.getComponent<LODGroupComponent>(entity)!!
+        val meshFilter = entityManager.getComponent<com.quantum.engine.core.components.MeshFilterComponent>(entity)
         
+        if (updateLOD(transform, lodGroup, meshFilter)) {
+            entityManager.markChanged(entity, lodGroupType)
+            entityManager.markChanged(entity, meshFilterType)
+        }
+    }
+    
+    /**
+     * Determina el nivel de LOD y cambia el mesh si hace falta
+     *
+     * @return true si cambió el nivel
+     */
+    private fun updateLOD(
+        transform: com.quantum.engine.core.components.TransformComponent,
+        lodGroup: LODGroupComponent,
+        meshFilter: com.quantum.engine.core.components.MeshFilterComponent?
+    ): Boolean {
         val distance = Vector3.distance(transform.worldPosition, cameraPosition)
         
         // Determinar nivel de LOD
         val newLOD = lodGroup.getLODForDistance(distance)
+        if (newLOD == lodGroup.currentLOD) return false
         
-        if (newLOD != lodGroup.currentLOD) {
-            lodGroup.currentLOD = newLOD
-            updateMeshForLOD(entity, newLOD, entityManager)
-        }
-    }
-    
-    private fun updateMeshForLOD(entity: Entity, lod: Int, entityManager: EntityManager) {
-        val lodGroup = entityManager.getComponent<LODGroupComponent>(entity)!!
-        val meshFilter = entityManager.getComponent<com.quantum.engine.core.components.MeshFilterComponent>(entity)
-        
+        lodGroup.currentLOD = newLOD
         meshFilter?.let {
-            it.meshId = lodGroup.lods.getOrNull(lod)?.meshId ?: it.meshId
+            it.meshId = lodGroup.lods.getOrNull(newLOD)?.meshId ?: it.meshId
         }
+        return true
     }
 }
 
@@ -302,32 +373,166 @@ data class OccluderVolume(
 /**
  * InstancingSystem - Renderizado instanciado para objetos repetidos
  * 
- * Optimiza rendering de múltiples copias del mismo objeto
+ * Optimiza rendering de múltiples copias del mismo objeto: agrupa por mesh
+ * y material las entidades con TransformComponent, MeshFilterComponent y
+ * MeshRendererComponent y mantiene sus matrices empaquetadas por grupo.
+ *
+ * Los grupos sólo se rehacen si entra o sale una entidad o cambia un mesh o
+ * material; si no, sólo se copian las matrices de los chunks cuya
+ * transformación cambió desde el frame anterior. InstanceGroup.version
+ * cambia con su contenido, así que el renderer sólo vuelve a subir los
+ * grupos cuya versión difiere de la que subió.
  */
-class InstancingSystem : System() {
+class InstancingSystem : IteratingSystem() {
     
     override val systemName = "InstancingSystem"
-    override val requiredComponents = emptyList<ComponentType>()
+    override val requiredComponents = listOf(
+        ComponentType.of<com.quantum.engine.core.components.TransformComponent>(),
+        ComponentType.of<com.quantum.engine.core.components.MeshFilterComponent>(),
+        ComponentType.of<com.quantum.engine.core.components.MeshRendererComponent>()
+    )
+    override val readComponents = requiredComponents
+    override val writeComponents = emptyList<ComponentType>()
+    
+    private val instanceGroups = mutableMapOf<InstanceKey, InstanceGroup>()
     
-    private val instanceGroups = mutableMapOf<Long, InstanceGroup>()
+    /**
+     * Grupos actuales (incluidos los vacíos hasta el próximo rehacer)
+     */
+    val groups: Collection<InstanceGroup> get() = instanceGroups.values
+    
+    private val transformType = ComponentType.of<com.quantum.engine.core.components.TransformComponent>()
+    private val meshFilterType = ComponentType.of<com.quantum.engine.core.components.MeshFilterComponent>()
+    private val meshRendererType = ComponentType.of<com.quantum.engine.core.components.MeshRendererComponent>()
+    
+    // Por ArchetypeChunk.id: grupo y slot de cada fila; válidos mientras no
+    // cambie la estructura de la consulta
+    private var rowGroups = arrayOfNulls<Array<InstanceGroup?>>(0)
+    private var rowSlots = arrayOfNulls<IntArray>(0)
+    private var seenStructureVersion = -1L
     
     override fun onUpdate(entityManager: EntityManager, deltaTime: Float) {
-        instanceGroups.clear()
+        if (!enabled) return
         
-        // Agrupar entidades con el mismo mesh
-        // TODO: Crear batches de instancias
+        val query = queryFor(entityManager)
+        var rebuild = query.structureVersion != seenStructureVersion
+        if (!rebuild) {
+            query.forEachChunk { chunk ->
+                if (didChange(chunk, meshFilterType) || didChange(chunk, meshRendererType)) rebuild = true
+            }
+        }
+        if (rebuild) {
+            rebuildGroups(query)
+            seenStructureVersion = query.structureVersion
+            return
+        }
+        
+        // Sólo las matrices de los chunks con transformaciones nuevas
+        query.forEachChunk { chunk ->
+            if (!didChange(chunk, transformType)) return@forEachChunk
+            val transforms = chunk.column<com.quantum.engine.core.components.TransformComponent>(transformType)
+            val groups = rowGroups[chunk.id] ?: return@forEachChunk
+            val slots = rowSlots[chunk.id]!!
+            for (row in 0 until chunk.count) {
+                val group = groups[row] ?: continue
+                writeMatrix(transforms[row]!!.worldMatrix, group.matrices, slots[row])
+                group.version = systemVersion
+            }
+        }
+    }
+    
+    override fun processEntity(entity: Entity, entityManager: EntityManager, deltaTime: Float) {
+        // El procesamiento se hace por chunks en onUpdate
     }
     
     fun getInstanceCount(meshId: Long): Int {
-        return instanceGroups[meshId]?.instances?.size ?: 0
+        return instanceGroups.values.sumOf { if (it.meshId == meshId) it.count else 0 }
+    }
+    
+    private fun rebuildGroups(query: EntityQuery) {
+        for (group in instanceGroups.values) {
+            group.count = 0
+            group.version = systemVersion
+        }
+        
+        query.forEachChunk { chunk ->
+            if (chunk.id >= rowGroups.size) {
+                val size = maxOf(chunk.id + 1, rowGroups.size * 2)
+                rowGroups = rowGroups.copyOf(size)
+                rowSlots = rowSlots.copyOf(size)
+            }
+            val capacity = chunk.archetype.capacity
+            val groups = rowGroups[chunk.id]?.takeIf { it.size == capacity } ?: arrayOfNulls<InstanceGroup>(capacity)
+            val slots = rowSlots[chunk.id]?.takeIf { it.size == capacity } ?: IntArray(capacity)
+            rowGroups[chunk.id] = groups
+            rowSlots[chunk.id] = slots
+            
+            val transforms = chunk.column<com.quantum.engine.core.components.TransformComponent>(transformType)
+            val meshFilters = chunk.column<com.quantum.engine.core.components.MeshFilterComponent>(meshFilterType)
+            val renderers = chunk.column<com.quantum.engine.core.components.MeshRendererComponent>(meshRendererType)
+            for (row in 0 until chunk.count) {
+                val meshId = meshFilters[row]?.meshId ?: 0L
+                val materialId = renderers[row]?.materialIds?.firstOrNull() ?: 0L
+                val group = instanceGroups.getOrPut(InstanceKey(meshId, materialId)) {
+                    InstanceGroup(meshId, materialId)
+                }
+                val slot = group.count
+                group.ensureCapacity(slot + 1)
+                group.count++
+                group.version = systemVersion
+                writeMatrix(transforms[row]!!.worldMatrix, group.matrices, slot)
+                groups[row] = group
+                slots[row] = slot
+            }
+        }
+        
+        // Grupos que se quedaron sin instancias
+        instanceGroups.values.removeAll { it.count == 0 }
+    }
+    
+    private fun writeMatrix(matrix: com.quantum.engine.math.Matrix4, out: FloatArray, slot: Int) {
+        val base = slot * 16
+        for (column in 0..3) {
+            for (row in 0..3) {
+                out[base + column * 4 + row] = matrix[column, row]
+            }
+        }
     }
+    
+    private data class InstanceKey(val meshId: Long, val materialId: Long)
 }
 
-data class InstanceGroup(
+/**
+ * Instancias de un mesh con un material
+ */
+class InstanceGroup(
     val meshId: Long,
-    val materialId: Long,
-    val instances: MutableList<InstanceData> = mutableListOf()
-)
+    val materialId: Long
+) {
+    /**
+     * Número de instancias
+     */
+    var count = 0
+        internal set
+    
+    /**
+     * 16 floats por instancia (column-major), en [0, count * 16)
+     */
+    var matrices = FloatArray(16 * 16)
+        private set
+    
+    /**
+     * Cambia cada vez que cambian las matrices o el número de instancias
+     */
+    var version = 0L
+        internal set
+    
+    internal fun ensureCapacity(instances: Int) {
+        if (matrices.size < instances * 16) {
+            matrices = matrices.copyOf(maxOf(instances * 16, matrices.size * 2))
+        }
+    }
+}
 
 data class InstanceData(
     val transform: com.quantum.engine.math.Matrix4,
@@ -0,0 +1,176 @@
+// archetype_store_test.cpp - Movimientos, lotes y límites del almacén por archetype
+#include "archetype_store.h"
+#include "test_check.h"
+#include <cstring>
+
+namespace {
+
+constexpr int32_t HEALTH = 1;       // float
+constexpr int32_t VELOCITY = 2;     // 3 floats
+constexpr int32_t NAME = 3;         // gestionado
+
+void registerTypes(ArchetypeStore& store) {
+    CHECK(store.registerType(HEALTH, 4));
+    CHECK(store.registerType(VELOCITY, 12));
+    CHECK(store.registerType(NAME, 0));
+}
+
+float* health(ArchetypeStore& store, int32_t chunk, int32_t row) {
+    const ArchetypeStore::Archetype& a = store.getArchetypeInfo(store.getChunk(chunk).archetype);
+    for (size_t column = 0; column < a.types.size(); column++) {
+        if (a.types[column] == HEALTH) {
+            return reinterpret_cast<float*>(store.getChunkMemory(chunk) + a.offsets[column]) + row;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(rejectsUnknownTypesAndRowsThatDoNotFit) {
+    ArchetypeStore store;
+    registerTypes(store);
+    CHECK(!store.registerType(HEALTH, 8));
+    CHECK(!store.registerType(ArchetypeStore::MAX_TYPES, 4));
+
+    const int32_t unknown[] = { HEALTH, 42 };
+    CHECK(store.getArchetype(unknown, 2) == -1);
+
+    // 8 columnas de 2KB no caben en un chunk de 16KB
+    int32_t large[8];
+    for (int32_t i = 0; i < 8; i++) {
+        large[i] = 100 + i;
+        CHECK(store.registerType(large[i], ArchetypeStore::CHUNK_BYTES / 8));
+    }
+    CHECK(store.getArchetype(large, 8) == -1);
+    CHECK(store.getArchetype(large, 1) >= 0);
+
+    // El orden no crea archetypes nuevos
+    const int32_t a[] = { VELOCITY, HEALTH };
+    const int32_t b[] = { HEALTH, VELOCITY };
+    CHECK(store.getArchetype(a, 2) == store.getArchetype(b, 2));
+}
+
+TEST(moveCopiesCommonColumnsAndZeroesNewOnes) {
+    ArchetypeStore store;
+    registerTypes(store);
+    const int32_t from[] = { HEALTH, NAME };
+    const int32_t to[] = { HEALTH, VELOCITY };
+    const int32_t source = store.getArchetype(from, 2);
+    const int32_t target = store.getArchetype(to, 2);
+
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    CHECK(store.addEntity(source, 7, result));
+    CHECK(result[ArchetypeStore::NEW_CHUNK] == result[ArchetypeStore::DST_CHUNK]);
+    *health(store, result[ArchetypeStore::DST_CHUNK], result[ArchetypeStore::DST_ROW]) = 42.0f;
+
+    CHECK(store.moveEntity(result[ArchetypeStore::DST_CHUNK], result[ArchetypeStore::DST_ROW], target, result));
+    const int32_t chunk = result[ArchetypeStore::DST_CHUNK];
+    const int32_t row = result[ArchetypeStore::DST_ROW];
+    CHECK(store.getChunk(chunk).archetype == target);
+    CHECK(store.entities(chunk)[row] == 7);
+    CHECK(*health(store, chunk, row) == 42.0f);
+
+    const ArchetypeStore::Archetype& info = store.getArchetypeInfo(target);
+    const float* velocity = reinterpret_cast<const float*>(store.getChunkMemory(chunk) + info.offsets[1]) + row * 3;
+    CHECK(velocity[0] == 0.0f && velocity[1] == 0.0f && velocity[2] == 0.0f);
+
+    // Era la única fila: el origen queda vacío
+    CHECK(store.getArchetypeInfo(source).entityCount == 0);
+    CHECK(result[ArchetypeStore::FROM_CHUNK] == -1);
+}
+
+TEST(removeMovesTheLastRowIntoTheHole) {
+    ArchetypeStore store;
+    registerTypes(store);
+    const int32_t types[] = { HEALTH };
+    const int32_t archetype = store.getArchetype(types, 1);
+
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    for (int64_t id = 1; id <= 3; id++) {
+        CHECK(store.addEntity(archetype, id, result));
+        *health(store, result[ArchetypeStore::DST_CHUNK], result[ArchetypeStore::DST_ROW]) = static_cast<float>(id);
+    }
+    const int32_t chunk = result[ArchetypeStore::DST_CHUNK];
+
+    store.removeEntity(chunk, 0, result);
+    CHECK(result[ArchetypeStore::HOLE_ROW] == 0);
+    CHECK(result[ArchetypeStore::FROM_ROW] == 2);
+    CHECK(store.entities(chunk)[0] == 3);
+    CHECK(*health(store, chunk, 0) == 3.0f);
+    CHECK(store.getChunk(chunk).count == 2);
+}
+
+TEST(batchesSpanChunksAndInstantiateCopiesRows) {
+    ArchetypeStore store;
+    registerTypes(store);
+    const int32_t types[] = { HEALTH, VELOCITY };
+    const int32_t archetype = store.getArchetype(types, 2);
+    const int32_t capacity = store.getArchetypeInfo(archetype).capacity;
+    const int32_t count = capacity * 2 + 5;
+
+    std::vector<int64_t> ids(count);
+    for (int32_t i = 0; i < count; i++) ids[i] = 1000 + i;
+    std::vector<int32_t> newChunks(count / capacity + 1);
+    CHECK(store.addEntities(archetype, ids.data(), count, newChunks.data()) == 3);
+
+    const ArchetypeStore::Archetype& info = store.getArchetypeInfo(archetype);
+    CHECK(info.entityCount == count);
+    for (int32_t i = 0; i < count; i++) {
+        const int32_t chunk = info.chunks[i / capacity];
+        CHECK(store.entities(chunk)[i % capacity] == 1000 + i);
+        CHECK(*health(store, chunk, i % capacity) == 0.0f);
+    }
+
+    // Copias de la fila 3 hasta pasar al chunk siguiente
+    *health(store, info.chunks[0], 3) = 9.5f;
+    const int32_t copies = capacity;
+    std::vector<int64_t> copyIds(copies);
+    for (int32_t i = 0; i < copies; i++) copyIds[i] = 5000 + i;
+    CHECK(store.instantiate(info.chunks[0], 3, copyIds.data(), copies, newChunks.data()) == 1);
+    for (int32_t i = count; i < count + copies; i++) {
+        const int32_t chunk = info.chunks[i / capacity];
+        CHECK(store.entities(chunk)[i % capacity] == 5000 + i - count);
+        CHECK(*health(store, chunk, i % capacity) == 9.5f);
+    }
+}
+
+TEST(moveEntitiesAppliesEveryOperationInOrder) {
+    ArchetypeStore store;
+    registerTypes(store);
+    const int32_t from[] = { HEALTH };
+    const int32_t to[] = { HEALTH, VELOCITY };
+    const int32_t source = store.getArchetype(from, 1);
+    const int32_t target = store.getArchetype(to, 2);
+
+    int32_t result[ArchetypeStore::RESULT_INTS];
+    for (int64_t id = 0; id < 6; id++) {
+        CHECK(store.addEntity(source, id, result));
+        *health(store, result[ArchetypeStore::DST_CHUNK], result[ArchetypeStore::DST_ROW]) = static_cast<float>(id);
+    }
+    const int32_t chunk = result[ArchetypeStore::DST_CHUNK];
+
+    // De la última fila a la primera: las posiciones siguen valiendo
+    const int32_t chunks[] = { chunk, chunk, chunk };
+    const int32_t rows[] = { 5, 3, 1 };
+    const int32_t archetypes[] = { target, -1, target };
+    int32_t results[3 * ArchetypeStore::RESULT_INTS];
+    CHECK(store.moveEntities(chunks, rows, archetypes, 3, results) == 3);
+
+    CHECK(store.getArchetypeInfo(source).entityCount == 3);
+    CHECK(store.getArchetypeInfo(target).entityCount == 2);
+    const int32_t moved = results[ArchetypeStore::DST_CHUNK];
+    CHECK(store.entities(moved)[0] == 5);
+    CHECK(store.entities(moved)[1] == 1);
+    CHECK(*health(store, moved, 1) == 1.0f);
+    CHECK(results[ArchetypeStore::RESULT_INTS + ArchetypeStore::DST_CHUNK] == -1);
+
+    // Quedan 0, 2 y 4 en el origen, en cualquier orden
+    float sum = 0.0f;
+    for (int32_t row = 0; row < 3; row++) sum += *health(store, chunk, row);
+    CHECK(sum == 6.0f);
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,67 @@
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Tests nativos en el host (ctest)
+ *
+ * Cada archivo es un ejecutable: TEST(nombre) registra un caso y main()
+ * devuelve runTests(). El primer CHECK que falla imprime dónde y termina
+ * con 1, así ctest marca el test como fallido.
+ */
+
+struct TestCase {
+    const char* name;
+    void (*function)();
+};
+
+inline std::vector<TestCase>& testCases() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+struct TestRegistrar {
+    TestRegistrar(const char* name, void (*function)()) {
+        testCases().push_back({ name, function });
+    }
+};
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance) \
+    do { \
+        const double checkActual = static_cast<double>(actual); \
+        const double checkExpected = static_cast<double>(expected); \
+        if (!(std::fabs(checkActual - checkExpected) <= static_cast<double>(tolerance))) { \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, \
+                         #actual, #expected, checkActual, checkExpected); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+inline int runTests() {
+    for (const TestCase& test : testCases()) {
+        std::printf("[ RUN  ] %s\n", test.name);
+        std::fflush(stdout);
+        test.function();
+        std::printf("[   OK ] %s\n", test.name);
+    }
+    return 0;
+}
+
+#endif // TEST_CHECK_H
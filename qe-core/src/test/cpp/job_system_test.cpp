@@ -0,0 +1,145 @@
+// job_system_test.cpp - Dependencias, contadores y carreras de JobSystem
+#include "job_system.h"
+#include "test_check.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * Termina el proceso si un test se cuelga: un wait() que no vuelve es
+ * justo el fallo que se busca
+ */
+class Watchdog {
+public:
+    explicit Watchdog(int32_t seconds) : thread([this, seconds] {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+        while (!done.load(std::memory_order_relaxed)) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                std::fprintf(stderr, "timeout: wait() no volvió\n");
+                std::_Exit(1);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }) {}
+
+    ~Watchdog() {
+        done.store(true, std::memory_order_relaxed);
+        thread.join();
+    }
+
+private:
+    std::atomic<bool> done{false};
+    std::thread thread;
+};
+
+/** Como KotlinJob en job_jni.cpp: se libera en una continuación de su contador */
+struct PendingJob {
+    JobCounter pending;
+    std::atomic<int32_t>* ran;
+};
+
+void runPending(void* context, int32_t, int32_t) {
+    static_cast<PendingJob*>(context)->ran->fetch_add(1, std::memory_order_relaxed);
+}
+
+void releasePending(void* context, int32_t, int32_t) {
+    delete static_cast<PendingJob*>(context);
+}
+
+void increment(void* context, int32_t begin, int32_t end) {
+    static_cast<std::atomic<int32_t>*>(context)->fetch_add(end - begin, std::memory_order_relaxed);
+}
+
+} // namespace
+
+TEST(scheduleAfterRacingTheLastFinishIsNeverLost) {
+    // El job y la continuación compiten por el mismo contador, desde varios
+    // hilos a la vez: el patrón de nativeSchedule
+    Watchdog watchdog(60);
+    JobSystem system(3);
+    std::atomic<int32_t> ran{0};
+    constexpr int32_t ROUNDS = 2000;
+    constexpr int32_t THREADS = 3;
+
+    for (int32_t round = 0; round < ROUNDS; round++) {
+        JobCounter done;
+        std::vector<std::thread> producers;
+        for (int32_t t = 0; t < THREADS; t++) {
+            producers.emplace_back([&system, &ran, &done] {
+                PendingJob* job = new PendingJob();
+                job->ran = &ran;
+                system.schedule(runPending, job, 0, 1, &job->pending);
+                system.scheduleAfter(&job->pending, releasePending, job, 0, 0, &done);
+            });
+        }
+        for (std::thread& producer : producers) producer.join();
+        system.wait(&done);
+        CHECK(done.count.load() == 0);
+        CHECK(done.continuations.load() == nullptr);
+    }
+    CHECK(ran.load() == ROUNDS * THREADS);
+}
+
+TEST(continuationsWaitForEveryJobOfTheDependency) {
+    Watchdog watchdog(30);
+    JobSystem system(3);
+    std::atomic<int32_t> first{0};
+    std::atomic<int32_t> seen{-1};
+
+    for (int32_t round = 0; round < 200; round++) {
+        JobCounter dependency;
+        JobCounter done;
+        first.store(0);
+        std::atomic<int32_t>* values[] = { &first, &seen };
+        for (int32_t i = 0; i < 16; i++) {
+            system.schedule(increment, &first, 0, 1, &dependency);
+        }
+        system.scheduleAfter(&dependency, [](void* context, int32_t, int32_t) {
+            auto* values = static_cast<std::atomic<int32_t>**>(context);
+            values[1]->store(values[0]->load());
+        }, values, 0, 0, &done);
+        system.wait(&done);
+        CHECK(seen.load() == 16);
+    }
+}
+
+TEST(finishedCounterLaunchesContinuationAtOnceAndIsReusable) {
+    Watchdog watchdog(30);
+    JobSystem system(2);
+    JobCounter dependency;
+    JobCounter done;
+    std::atomic<int32_t> sum{0};
+
+    for (int32_t round = 0; round < 100; round++) {
+        // dependency ya está a cero: la continuación sale en el acto
+        system.scheduleAfter(&dependency, increment, &sum, 0, 1, &done);
+        system.wait(&done);
+        CHECK(dependency.count.load() == 0);
+
+        system.parallelFor(1000, 16, increment, &sum, &dependency);
+        system.wait(&dependency);
+    }
+    CHECK(sum.load() == 100 * 1001);
+}
+
+TEST(parallelForCoversTheRangeOnce) {
+    Watchdog watchdog(30);
+    JobSystem system(3);
+    constexpr int32_t COUNT = 100000;
+    std::vector<std::atomic<int32_t>> hits(COUNT);
+
+    system.parallelFor(COUNT, 64, [&hits](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) hits[i].fetch_add(1, std::memory_order_relaxed);
+    });
+    for (int32_t i = 0; i < COUNT; i++) {
+        CHECK(hits[i].load() == 1);
+    }
+}
+
+int main() {
+    return runTests();
+}
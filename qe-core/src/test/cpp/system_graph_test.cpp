@@ -0,0 +1,168 @@
+// system_graph_test.cpp - Aristas, tramos exclusivos y orden de SystemGraph
+#include "job_system.h"
+#include "system_graph.h"
+#include "test_check.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/** Un sistema por fila: bits de los tipos que lee y escribe */
+struct StageBuilder {
+    std::vector<uint64_t> reads;
+    std::vector<uint64_t> writes;
+    std::vector<uint8_t> exclusive;
+    std::vector<int64_t> costs;
+
+    void add(std::vector<int32_t> read, std::vector<int32_t> write, bool isExclusive = false,
+             int64_t cost = 1000) {
+        const size_t base = reads.size();
+        reads.resize(base + SystemGraph::MASK_WORDS, 0);
+        writes.resize(base + SystemGraph::MASK_WORDS, 0);
+        for (int32_t type : read) reads[base + type / 64] |= uint64_t(1) << (type % 64);
+        for (int32_t type : write) writes[base + type / 64] |= uint64_t(1) << (type % 64);
+        exclusive.push_back(isExclusive ? 1 : 0);
+        costs.push_back(cost);
+    }
+
+    void build(SystemGraph& graph) const {
+        graph.build(static_cast<int32_t>(exclusive.size()), reads.data(), writes.data(),
+                    exclusive.data(), costs.data());
+    }
+};
+
+/** Orden de ejecución, cuántos corrían a la vez y en qué hilo */
+struct Recorder {
+    std::mutex mutex;
+    std::vector<int32_t> order;
+    std::vector<int32_t> concurrentAtStart;
+    std::vector<std::thread::id> threads;
+    std::atomic<int32_t> running{0};
+
+    explicit Recorder(int32_t count) : concurrentAtStart(count), threads(count) {}
+
+    static void run(void* context, int32_t node, int32_t) {
+        Recorder* recorder = static_cast<Recorder*>(context);
+        const int32_t concurrent = recorder->running.fetch_add(1) + 1;
+        std::this_thread::yield();
+        {
+            std::lock_guard<std::mutex> lock(recorder->mutex);
+            recorder->order.push_back(node);
+            recorder->concurrentAtStart[node] = concurrent;
+            recorder->threads[node] = std::this_thread::get_id();
+        }
+        recorder->running.fetch_sub(1);
+    }
+
+    int32_t position(int32_t node) const {
+        for (size_t i = 0; i < order.size(); i++) {
+            if (order[i] == node) return static_cast<int32_t>(i);
+        }
+        return -1;
+    }
+};
+
+} // namespace
+
+TEST(conflictsBecomeEdgesInPriorityOrder) {
+    StageBuilder stage;
+    stage.add({}, { 1 });          // 0: escribe 1
+    stage.add({ 1 }, {});          // 1: lee 1 -> después de 0
+    stage.add({}, { 2 });          // 2: libre
+    stage.add({ 2 }, { 1 });       // 3: después de 0, 1 y 2
+    stage.add({ 3 }, {});          // 4: libre
+
+    SystemGraph graph;
+    stage.build(graph);
+    CHECK(graph.getCount() == 5);
+    CHECK(graph.getEdgeCount() == 4);
+
+    JobSystem system(3);
+    for (int32_t round = 0; round < 100; round++) {
+        Recorder recorder(5);
+        graph.run(system, Recorder::run, &recorder);
+        CHECK(recorder.order.size() == 5);
+        CHECK(recorder.position(0) < recorder.position(1));
+        CHECK(recorder.position(0) < recorder.position(3));
+        CHECK(recorder.position(1) < recorder.position(3));
+        CHECK(recorder.position(2) < recorder.position(3));
+    }
+}
+
+TEST(exclusiveSystemsRunAloneOnTheCallerBetweenSegments) {
+    StageBuilder stage;
+    stage.add({}, { 1 });
+    stage.add({}, { 2 });
+    stage.add({}, {}, true);       // 2: barrera
+    stage.add({}, { 1 });
+    stage.add({}, { 2 });
+
+    SystemGraph graph;
+    stage.build(graph);
+    CHECK(graph.getEdgeCount() == 0);
+
+    JobSystem system(3);
+    const std::thread::id caller = std::this_thread::get_id();
+    for (int32_t round = 0; round < 100; round++) {
+        Recorder recorder(5);
+        graph.run(system, Recorder::run, &recorder);
+        CHECK(recorder.position(2) == 2);
+        CHECK(recorder.concurrentAtStart[2] == 1);
+        CHECK(recorder.threads[2] == caller);
+    }
+}
+
+TEST(stagesWithoutDeclaredSetsKeepTheirOriginalOrder) {
+    // Sistemas sin readComponents ni writeComponents: todos exclusivos,
+    // en orden de prioridad y en el hilo que llama, como en secuencial
+    StageBuilder stage;
+    for (int32_t i = 0; i < 6; i++) {
+        stage.add({}, {}, true, 1000 * (6 - i));
+    }
+
+    SystemGraph graph;
+    stage.build(graph);
+    CHECK(graph.getEdgeCount() == 0);
+
+    JobSystem system(3);
+    const std::thread::id caller = std::this_thread::get_id();
+    for (int32_t round = 0; round < 50; round++) {
+        Recorder recorder(6);
+        graph.run(system, Recorder::run, &recorder);
+        CHECK(recorder.order.size() == 6);
+        for (int32_t i = 0; i < 6; i++) {
+            CHECK(recorder.order[i] == i);
+            CHECK(recorder.concurrentAtStart[i] == 1);
+            CHECK(recorder.threads[i] == caller);
+        }
+    }
+}
+
+TEST(rebuildReusesTheGraphWithFewerSystems) {
+    SystemGraph graph;
+    JobSystem system(2);
+
+    StageBuilder large;
+    for (int32_t i = 0; i < 32; i++) large.add({ i % 4 }, { (i + 1) % 4 });
+    large.build(graph);
+    Recorder first(32);
+    graph.run(system, Recorder::run, &first);
+    CHECK(first.order.size() == 32);
+
+    StageBuilder small;
+    small.add({}, { 1 });
+    small.add({ 1 }, {});
+    small.build(graph);
+    CHECK(graph.getCount() == 2);
+    CHECK(graph.getEdgeCount() == 1);
+    Recorder second(2);
+    graph.run(system, Recorder::run, &second);
+    CHECK(second.order.size() == 2);
+    CHECK(second.order[0] == 0 && second.order[1] == 1);
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,147 @@
+// culling_kernels.cpp - Frustum culling de 4 en 4 con simd::float4
+#include "culling_kernels.h"
+#include "simd_float4.h"
+#include <cmath>
+
+#if defined(QE_MATH_AVX2)
+// culling_kernels_avx2.cpp (8 objetos por iteración)
+namespace qemath {
+bool hasAvx2Kernels();
+int cullSpheresAvx2(const float* planes,
+                    const float* x, const float* y, const float* z, const float* radius,
+                    int first, int count, int* visible);
+int cullAABBsAvx2(const float* planes,
+                  const float* minX, const float* minY, const float* minZ,
+                  const float* maxX, const float* maxY, const float* maxZ,
+                  int first, int count, int* visible);
+}
+#endif
+
+namespace qemath {
+
+using namespace simd;
+
+// Escribe los índices de los lanes visibles sin saltos: cada lane escribe en
+// la posición actual y sólo avanza si es visible (nunca pasa de base + 4)
+static inline int appendVisible(int* visible, int written, int base, int bits, int lanes) {
+    for (int lane = 0; lane < lanes; lane++) {
+        visible[written] = base + lane;
+        written += (bits >> lane) & 1;
+    }
+    return written;
+}
+
+int cullSpheres(const float* planes,
+                const float* x, const float* y, const float* z, const float* radius,
+                int first, int count, int* visible) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        return cullSpheresAvx2(planes, x, y, z, radius, first, count, visible);
+    }
+#endif
+    float4 nx[FRUSTUM_PLANE_COUNT], ny[FRUSTUM_PLANE_COUNT], nz[FRUSTUM_PLANE_COUNT], nd[FRUSTUM_PLANE_COUNT];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        nx[p] = set1(planes[p * 4]);
+        ny[p] = set1(planes[p * 4 + 1]);
+        nz[p] = set1(planes[p * 4 + 2]);
+        nd[p] = set1(planes[p * 4 + 3]);
+    }
+
+    int end = first + count;
+    int written = 0;
+    int i = first;
+
+    for (; i + 4 <= end; i += 4) {
+        float4 cx = load(x + i);
+        float4 cy = load(y + i);
+        float4 cz = load(z + i);
+        float4 negRadius = sub(zero(), load(radius + i));
+
+        float4 outside = cmplt(sub(madd(nz[0], cz, madd(ny[0], cy, mul(nx[0], cx))), nd[0]), negRadius);
+        for (int p = 1; p < FRUSTUM_PLANE_COUNT; p++) {
+            float4 distance = sub(madd(nz[p], cz, madd(ny[p], cy, mul(nx[p], cx))), nd[p]);
+            outside = maskOr(outside, cmplt(distance, negRadius));
+        }
+
+        written = appendVisible(visible, written, i, ~maskBits(outside) & 0xF, 4);
+    }
+
+    // Resto escalar, mismo criterio que Frustum.intersectsSphere()
+    for (; i < end; i++) {
+        bool inside = true;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && inside; p++) {
+            const float* plane = planes + p * 4;
+            float distance = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] - plane[3];
+            inside = distance >= -radius[i];
+        }
+        visible[written] = i;
+        written += inside ? 1 : 0;
+    }
+
+    return written;
+}
+
+int cullAABBs(const float* planes,
+              const float* minX, const float* minY, const float* minZ,
+              const float* maxX, const float* maxY, const float* maxZ,
+              int first, int count, int* visible) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        return cullAABBsAvx2(planes, minX, minY, minZ, maxX, maxY, maxZ, first, count, visible);
+    }
+#endif
+    float4 nx[FRUSTUM_PLANE_COUNT], ny[FRUSTUM_PLANE_COUNT], nz[FRUSTUM_PLANE_COUNT], nd[FRUSTUM_PLANE_COUNT];
+    float4 ax[FRUSTUM_PLANE_COUNT], ay[FRUSTUM_PLANE_COUNT], az[FRUSTUM_PLANE_COUNT];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        nx[p] = set1(planes[p * 4]);
+        ny[p] = set1(planes[p * 4 + 1]);
+        nz[p] = set1(planes[p * 4 + 2]);
+        nd[p] = set1(planes[p * 4 + 3]);
+        ax[p] = abs(nx[p]);
+        ay[p] = abs(ny[p]);
+        az[p] = abs(nz[p]);
+    }
+
+    float4 half = set1(0.5f);
+    int end = first + count;
+    int written = 0;
+    int i = first;
+
+    for (; i + 4 <= end; i += 4) {
+        float4 lx = load(minX + i), ly = load(minY + i), lz = load(minZ + i);
+        float4 hx = load(maxX + i), hy = load(maxY + i), hz = load(maxZ + i);
+
+        // Centro / extents: distancia del centro contra el radio proyectado
+        float4 cx = mul(add(lx, hx), half), cy = mul(add(ly, hy), half), cz = mul(add(lz, hz), half);
+        float4 ex = mul(sub(hx, lx), half), ey = mul(sub(hy, ly), half), ez = mul(sub(hz, lz), half);
+
+        float4 outside = zero();
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+            float4 distance = sub(madd(nz[p], cz, madd(ny[p], cy, mul(nx[p], cx))), nd[p]);
+            float4 extent = madd(az[p], ez, madd(ay[p], ey, mul(ax[p], ex)));
+            outside = maskOr(outside, cmplt(distance, sub(zero(), extent)));
+        }
+
+        written = appendVisible(visible, written, i, ~maskBits(outside) & 0xF, 4);
+    }
+
+    // Resto escalar, mismo criterio que Frustum.intersectsAABB()
+    for (; i < end; i++) {
+        float cx = (minX[i] + maxX[i]) * 0.5f, cy = (minY[i] + maxY[i]) * 0.5f, cz = (minZ[i] + maxZ[i]) * 0.5f;
+        float ex = (maxX[i] - minX[i]) * 0.5f, ey = (maxY[i] - minY[i]) * 0.5f, ez = (maxZ[i] - minZ[i]) * 0.5f;
+
+        bool inside = true;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && inside; p++) {
+            const float* plane = planes + p * 4;
+            float r = std::fabs(ex * plane[0]) + std::fabs(ey * plane[1]) + std::fabs(ez * plane[2]);
+            float distance = plane[0] * cx + plane[1] * cy + plane[2] * cz - plane[3];
+            inside = distance >= -r;
+        }
+        visible[written] = i;
+        written += inside ? 1 : 0;
+    }
+
+    return written;
+}
+
+} // namespace qemath
@@ -0,0 +1,125 @@
+// culling_kernels_avx2.cpp - Frustum culling de 8 en 8 para x86_64 con AVX2 + FMA
+// Sólo se compila para x86_64 con -mavx2 -mfma; culling_kernels.cpp decide en
+// tiempo de ejecución si la CPU las soporta.
+#include "culling_kernels.h"
+#include <immintrin.h>
+#include <cmath>
+
+namespace qemath {
+
+static inline int appendVisible8(int* visible, int written, int base, int bits) {
+    for (int lane = 0; lane < 8; lane++) {
+        visible[written] = base + lane;
+        written += (bits >> lane) & 1;
+    }
+    return written;
+}
+
+static inline __m256 planeDistance(const __m256* plane, __m256 x, __m256 y, __m256 z) {
+    return _mm256_sub_ps(_mm256_fmadd_ps(plane[2], z, _mm256_fmadd_ps(plane[1], y, _mm256_mul_ps(plane[0], x))),
+                         plane[3]);
+}
+
+int cullSpheresAvx2(const float* planes,
+                    const float* x, const float* y, const float* z, const float* radius,
+                    int first, int count, int* visible) {
+    __m256 plane[FRUSTUM_PLANE_COUNT][4];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        for (int k = 0; k < 4; k++) {
+            plane[p][k] = _mm256_set1_ps(planes[p * 4 + k]);
+        }
+    }
+
+    __m256 zero = _mm256_setzero_ps();
+    int end = first + count;
+    int written = 0;
+    int i = first;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 cx = _mm256_loadu_ps(x + i);
+        __m256 cy = _mm256_loadu_ps(y + i);
+        __m256 cz = _mm256_loadu_ps(z + i);
+        __m256 negRadius = _mm256_sub_ps(zero, _mm256_loadu_ps(radius + i));
+
+        __m256 outside = zero;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(planeDistance(plane[p], cx, cy, cz), negRadius, _CMP_LT_OQ));
+        }
+
+        written = appendVisible8(visible, written, i, ~_mm256_movemask_ps(outside) & 0xFF);
+    }
+
+    for (; i < end; i++) {
+        bool inside = true;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && inside; p++) {
+            const float* n = planes + p * 4;
+            inside = n[0] * x[i] + n[1] * y[i] + n[2] * z[i] - n[3] >= -radius[i];
+        }
+        visible[written] = i;
+        written += inside ? 1 : 0;
+    }
+
+    return written;
+}
+
+int cullAABBsAvx2(const float* planes,
+                  const float* minX, const float* minY, const float* minZ,
+                  const float* maxX, const float* maxY, const float* maxZ,
+                  int first, int count, int* visible) {
+    __m256 plane[FRUSTUM_PLANE_COUNT][4];
+    __m256 absNormal[FRUSTUM_PLANE_COUNT][3];
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        for (int k = 0; k < 4; k++) {
+            plane[p][k] = _mm256_set1_ps(planes[p * 4 + k]);
+        }
+        for (int k = 0; k < 3; k++) {
+            absNormal[p][k] = _mm256_set1_ps(std::fabs(planes[p * 4 + k]));
+        }
+    }
+
+    __m256 zero = _mm256_setzero_ps();
+    __m256 half = _mm256_set1_ps(0.5f);
+    int end = first + count;
+    int written = 0;
+    int i = first;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 lx = _mm256_loadu_ps(minX + i), ly = _mm256_loadu_ps(minY + i), lz = _mm256_loadu_ps(minZ + i);
+        __m256 hx = _mm256_loadu_ps(maxX + i), hy = _mm256_loadu_ps(maxY + i), hz = _mm256_loadu_ps(maxZ + i);
+
+        __m256 cx = _mm256_mul_ps(_mm256_add_ps(lx, hx), half);
+        __m256 cy = _mm256_mul_ps(_mm256_add_ps(ly, hy), half);
+        __m256 cz = _mm256_mul_ps(_mm256_add_ps(lz, hz), half);
+        __m256 ex = _mm256_mul_ps(_mm256_sub_ps(hx, lx), half);
+        __m256 ey = _mm256_mul_ps(_mm256_sub_ps(hy, ly), half);
+        __m256 ez = _mm256_mul_ps(_mm256_sub_ps(hz, lz), half);
+
+        __m256 outside = zero;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+            __m256 extent = _mm256_fmadd_ps(absNormal[p][2], ez,
+                            _mm256_fmadd_ps(absNormal[p][1], ey, _mm256_mul_ps(absNormal[p][0], ex)));
+            __m256 distance = planeDistance(plane[p], cx, cy, cz);
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, _mm256_sub_ps(zero, extent), _CMP_LT_OQ));
+        }
+
+        written = appendVisible8(visible, written, i, ~_mm256_movemask_ps(outside) & 0xFF);
+    }
+
+    for (; i < end; i++) {
+        float cx = (minX[i] + maxX[i]) * 0.5f, cy = (minY[i] + maxY[i]) * 0.5f, cz = (minZ[i] + maxZ[i]) * 0.5f;
+        float ex = (maxX[i] - minX[i]) * 0.5f, ey = (maxY[i] - minY[i]) * 0.5f, ez = (maxZ[i] - minZ[i]) * 0.5f;
+
+        bool inside = true;
+        for (int p = 0; p < FRUSTUM_PLANE_COUNT && inside; p++) {
+            const float* n = planes + p * 4;
+            float r = std::fabs(ex * n[0]) + std::fabs(ey * n[1]) + std::fabs(ez * n[2]);
+            inside = n[0] * cx + n[1] * cy + n[2] * cz - n[3] >= -r;
+        }
+        visible[written] = i;
+        written += inside ? 1 : 0;
+    }
+
+    return written;
+}
+
+} // namespace qemath
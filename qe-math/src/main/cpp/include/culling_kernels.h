@@ -0,0 +1,29 @@
+#ifndef CULLING_KERNELS_H
+#define CULLING_KERNELS_H
+
+/**
+ * Frustum culling por lotes sobre bounds en SoA
+ *
+ * planes: 6 planos (nx, ny, nz, distance) con la convención de Plane:
+ * distancia signada = dot(n, p) - distance, dentro si >= 0.
+ * Cada llamada procesa [first, first + count) y escribe en visible los
+ * índices absolutos de los objetos visibles, en orden. Devuelve cuántos.
+ * visible necesita espacio para count índices. Rangos disjuntos pueden
+ * procesarse en hilos distintos.
+ */
+namespace qemath {
+
+static const int FRUSTUM_PLANE_COUNT = 6;
+
+int cullSpheres(const float* planes,
+                const float* x, const float* y, const float* z, const float* radius,
+                int first, int count, int* visible);
+
+int cullAABBs(const float* planes,
+              const float* minX, const float* minY, const float* minZ,
+              const float* maxX, const float* maxY, const float* maxZ,
+              int first, int count, int* visible);
+
+} // namespace qemath
+
+#endif // CULLING_KERNELS_H
@@ -0,0 +1,73 @@
+#ifndef MATH_KERNELS_H
+#define MATH_KERNELS_H
+
+/**
+ * Kernels matemáticos por lotes
+ *
+ * Trabajan sobre arrays planos (los mismos FloatArray que llegan por JNI):
+ * matrices column-major de 16 floats, puntos/normales de 3, quaternions xyzw
+ * de 4, AABBs min/max de 6 y TRS posición/rotación/escala de 10.
+ * NEON en ARM, SSE en x86 y AVX2+FMA en x86_64 cuando la CPU lo soporta
+ * (detectado en tiempo de ejecución). Todos admiten out == entrada.
+ */
+namespace qemath {
+
+// out[i] = a[i] * b[i]
+void mat4MulBatch(const float* a, const float* b, float* out, int count);
+
+// out[i] = left * b[i] (p. ej. viewProjection * model)
+void mat4PreMulBatch(const float* left, const float* b, float* out, int count);
+
+// Puntos con matriz afín (fila w = 0, 0, 0, 1): sin división perspectiva
+void transformPoints(const float* matrix, const float* points, float* out, int count);
+
+// Direcciones con la parte 3x3; normalize = true para normales
+void transformNormals(const float* matrix, const float* normals, float* out, int count, bool normalize);
+
+// out[i] = slerp(a[i], b[i], t[i]) con la misma semántica que Quaternion.slerp()
+void slerpBatch(const float* a, const float* b, const float* t, float* out, int count);
+
+// AABB local (min, max) de cada objeto por su matriz world afín
+void transformAABBs(const float* matrices, const float* boxes, float* out, int count);
+
+// Origen de posición (3), rotación xyzw (4) y escala (3) con stride en floats
+struct TRSLayout {
+    const float* position;
+    const float* rotation;
+    const float* scale;
+    int positionStride;
+    int rotationStride;
+    int scaleStride;
+};
+
+// Copia el transform index a la columna lane de un buffer SoA (uso interno de los kernels)
+template <int Lanes>
+inline void gatherTRS(const TRSLayout& layout, int index, float (&soa)[10][Lanes], int lane) {
+    const float* p = layout.position + index * layout.positionStride;
+    const float* r = layout.rotation + index * layout.rotationStride;
+    const float* s = layout.scale + index * layout.scaleStride;
+    soa[0][lane] = p[0]; soa[1][lane] = p[1]; soa[2][lane] = p[2];
+    soa[3][lane] = r[0]; soa[4][lane] = r[1]; soa[5][lane] = r[2]; soa[6][lane] = r[3];
+    soa[7][lane] = s[0]; soa[8][lane] = s[1]; soa[9][lane] = s[2];
+}
+
+// Matrices T * R * S, igual que Matrix4.trs()
+void composeTRSBatch(const TRSLayout& layout, float* out, int count);
+
+// TRS intercalado: 10 floats por transform
+inline void composeTRSBatch(const float* trs, float* out, int count) {
+    composeTRSBatch(TRSLayout{ trs, trs + 3, trs + 7, 10, 10, 10 }, out, count);
+}
+
+// Arrays separados: posiciones de 3, rotaciones de 4 y escalas de 3
+inline void composeTRSBatch(const float* positions, const float* rotations, const float* scales,
+                            float* out, int count) {
+    composeTRSBatch(TRSLayout{ positions, rotations, scales, 3, 4, 3 }, out, count);
+}
+
+// "NEON", "SSE", "AVX2" o "Scalar"
+const char* getKernelBackend();
+
+} // namespace qemath
+
+#endif // MATH_KERNELS_H
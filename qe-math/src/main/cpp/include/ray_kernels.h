@@ -0,0 +1,60 @@
+#ifndef RAY_KERNELS_H
+#define RAY_KERNELS_H
+
+/**
+ * Raycasts por lotes contra bounds en SoA (método de slabs para AABBs)
+ *
+ * ray: 6 floats (origen xyz, dirección xyz normalizada).
+ * Distancias con la misma semántica que Ray.intersectSphere/intersectAABB:
+ * - Esfera: primer impacto con t >= 0 (origen dentro = sin impacto)
+ * - AABB: entrada si t >= 0, si no la salida (origen dentro)
+ * Sólo cuentan impactos con distancia < maxDistance.
+ *
+ * layers (opcional, puede ser nullptr): capa 0..31 de cada objeto; se
+ * ignoran los objetos cuya capa no esté en layerMask o esté fuera de rango.
+ * Con empates gana el índice menor.
+ */
+namespace qemath {
+
+static const int RAY_FLOATS = 6;
+static const int NO_HIT = -1;
+
+// ========== Un rayo contra muchos objetos ==========
+
+/**
+ * Índice del objeto más cercano en [first, first + count) o NO_HIT.
+ * Si hay impacto escribe su distancia en hitDistance.
+ */
+int raycastSpheres(const float* ray, float maxDistance,
+                   const float* x, const float* y, const float* z, const float* radius,
+                   const int* layers, int layerMask,
+                   int first, int count, float* hitDistance);
+
+int raycastAABBs(const float* ray, float maxDistance,
+                 const float* minX, const float* minY, const float* minZ,
+                 const float* maxX, const float* maxY, const float* maxZ,
+                 const int* layers, int layerMask,
+                 int first, int count, float* hitDistance);
+
+// ========== Paquetes de rayos ==========
+
+/**
+ * rayCount rayos (RAY_FLOATS cada uno) contra los objetos [first, first + count),
+ * 4 rayos por instrucción. Para cada rayo escribe el índice más cercano
+ * (o NO_HIT) en hitIndices y su distancia en hitDistances.
+ * maxDistances: límite por rayo.
+ */
+void raycastPacketSpheres(const float* rays, const float* maxDistances, int rayCount,
+                          const float* x, const float* y, const float* z, const float* radius,
+                          const int* layers, int layerMask,
+                          int first, int count, int* hitIndices, float* hitDistances);
+
+void raycastPacketAABBs(const float* rays, const float* maxDistances, int rayCount,
+                        const float* minX, const float* minY, const float* minZ,
+                        const float* maxX, const float* maxY, const float* maxZ,
+                        const int* layers, int layerMask,
+                        int first, int count, int* hitIndices, float* hitDistances);
+
+} // namespace qemath
+
+#endif // RAY_KERNELS_H
@@ -0,0 +1,199 @@
+#ifndef SIMD_FLOAT4_H
+#define SIMD_FLOAT4_H
+
+// Vector de 4 floats: NEON en ARM, SSE en x86, escalar como fallback
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define QE_SIMD_NEON 1
+#elif defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define QE_SIMD_SSE 1
+#else
+#include <cmath>
+#endif
+
+namespace simd {
+
+#if defined(QE_SIMD_NEON)
+
+typedef float32x4_t float4;
+
+inline float4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, float4 v) { vst1q_f32(p, v); }
+inline float4 set1(float s) { return vdupq_n_f32(s); }
+inline float4 zero() { return vdupq_n_f32(0.0f); }
+inline float4 add(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+// a * b + c
+inline float4 madd(float4 a, float4 b, float4 c) { return vmlaq_f32(c, a, b); }
+inline float4 min(float4 a, float4 b) { return vminq_f32(a, b); }
+inline float4 max(float4 a, float4 b) { return vmaxq_f32(a, b); }
+inline float4 abs(float4 a) { return vabsq_f32(a); }
+
+#if defined(__aarch64__)
+inline float4 div(float4 a, float4 b) { return vdivq_f32(a, b); }
+inline float4 sqrt(float4 a) { return vsqrtq_f32(a); }
+#else
+// ARMv7 no tiene división ni raíz vectorial: estimación + Newton-Raphson
+inline float4 div(float4 a, float4 b) {
+    float32x4_t r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+}
+inline float4 sqrt(float4 a) {
+    float32x4_t r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    // sqrt(0) = 0 en lugar de 0 * inf
+    uint32x4_t zeroMask = vceqq_f32(a, vdupq_n_f32(0.0f));
+    return vbslq_f32(zeroMask, vdupq_n_f32(0.0f), vmulq_f32(a, r));
+}
+#endif
+
+// Máscaras: todos los bits a 1 en los lanes que cumplen
+inline float4 cmplt(float4 a, float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline float4 cmpgt(float4 a, float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline float4 select(float4 mask, float4 a, float4 b) {
+    return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+}
+inline float4 maskOr(float4 a, float4 b) {
+    return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+}
+// Bit i = lane i de la máscara
+inline int maskBits(float4 mask) {
+    static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+    uint32x4_t bits = vandq_u32(vreinterpretq_u32_f32(mask), vld1q_u32(laneBits));
+#if defined(__aarch64__)
+    return static_cast<int>(vaddvq_u32(bits));
+#else
+    uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+    return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+#endif
+}
+
+template <int Lane>
+inline float4 splat(float4 v) { return vdupq_n_f32(vgetq_lane_f32(v, Lane)); }
+
+inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+#elif defined(QE_SIMD_SSE)
+
+typedef __m128 float4;
+
+inline float4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, float4 v) { _mm_storeu_ps(p, v); }
+inline float4 set1(float s) { return _mm_set1_ps(s); }
+inline float4 zero() { return _mm_setzero_ps(); }
+inline float4 add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 madd(float4 a, float4 b, float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline float4 min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+inline float4 max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+inline float4 abs(float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+inline float4 div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 sqrt(float4 a) { return _mm_sqrt_ps(a); }
+
+// Máscaras: todos los bits a 1 en los lanes que cumplen
+inline float4 cmplt(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+inline float4 cmpgt(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+inline float4 select(float4 mask, float4 a, float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline float4 maskOr(float4 a, float4 b) { return _mm_or_ps(a, b); }
+// Bit i = lane i de la máscara
+inline int maskBits(float4 mask) { return _mm_movemask_ps(mask); }
+
+template <int Lane>
+inline float4 splat(float4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane)); }
+
+inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+
+#else
+
+struct float4 {
+    float v[4];
+};
+
+inline float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store(float* p, float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline float4 set1(float s) { return {{s, s, s, s}}; }
+inline float4 zero() { return set1(0.0f); }
+inline float4 add(float4 a, float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline float4 sub(float4 a, float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline float4 mul(float4 a, float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline float4 madd(float4 a, float4 b, float4 c) { return add(mul(a, b), c); }
+inline float4 min(float4 a, float4 b) {
+    return {{std::fmin(a.v[0], b.v[0]), std::fmin(a.v[1], b.v[1]), std::fmin(a.v[2], b.v[2]), std::fmin(a.v[3], b.v[3])}};
+}
+inline float4 max(float4 a, float4 b) {
+    return {{std::fmax(a.v[0], b.v[0]), std::fmax(a.v[1], b.v[1]), std::fmax(a.v[2], b.v[2]), std::fmax(a.v[3], b.v[3])}};
+}
+inline float4 abs(float4 a) { return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}}; }
+inline float4 div(float4 a, float4 b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+inline float4 sqrt(float4 a) { return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+
+// Máscaras: 1.0 / 0.0 por lane en el fallback escalar
+inline float4 cmplt(float4 a, float4 b) {
+    return {{a.v[0] < b.v[0] ? 1.0f : 0.0f, a.v[1] < b.v[1] ? 1.0f : 0.0f,
+             a.v[2] < b.v[2] ? 1.0f : 0.0f, a.v[3] < b.v[3] ? 1.0f : 0.0f}};
+}
+inline float4 cmpgt(float4 a, float4 b) { return cmplt(b, a); }
+inline float4 select(float4 mask, float4 a, float4 b) {
+    return {{mask.v[0] != 0.0f ? a.v[0] : b.v[0], mask.v[1] != 0.0f ? a.v[1] : b.v[1],
+             mask.v[2] != 0.0f ? a.v[2] : b.v[2], mask.v[3] != 0.0f ? a.v[3] : b.v[3]}};
+}
+inline float4 maskOr(float4 a, float4 b) {
+    return {{(a.v[0] != 0.0f || b.v[0] != 0.0f) ? 1.0f : 0.0f, (a.v[1] != 0.0f || b.v[1] != 0.0f) ? 1.0f : 0.0f,
+             (a.v[2] != 0.0f || b.v[2] != 0.0f) ? 1.0f : 0.0f, (a.v[3] != 0.0f || b.v[3] != 0.0f) ? 1.0f : 0.0f}};
+}
+inline int maskBits(float4 mask) {
+    return (mask.v[0] != 0.0f ? 1 : 0) | (mask.v[1] != 0.0f ? 2 : 0) |
+           (mask.v[2] != 0.0f ? 4 : 0) | (mask.v[3] != 0.0f ? 8 : 0);
+}
+
+template <int Lane>
+inline float4 splat(float4 a) { return set1(a.v[Lane]); }
+
+inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3) {
+    float4 c0 = {{r0.v[0], r1.v[0], r2.v[0], r3.v[0]}};
+    float4 c1 = {{r0.v[1], r1.v[1], r2.v[1], r3.v[1]}};
+    float4 c2 = {{r0.v[2], r1.v[2], r2.v[2], r3.v[2]}};
+    float4 c3 = {{r0.v[3], r1.v[3], r2.v[3], r3.v[3]}};
+    r0 = c0; r1 = c1; r2 = c2; r3 = c3;
+}
+
+#endif
+
+// Multiplica matrices 4x4 column-major: out = a * b
+inline void mat4Mul(const float* a, const float* b, float* out) {
+    float4 a0 = load(a);
+    float4 a1 = load(a + 4);
+    float4 a2 = load(a + 8);
+    float4 a3 = load(a + 12);
+
+    for (int c = 0; c < 4; c++) {
+        float4 col = load(b + c * 4);
+        float4 r = mul(a0, splat<0>(col));
+        r = madd(a1, splat<1>(col), r);
+        r = madd(a2, splat<2>(col), r);
+        r = madd(a3, splat<3>(col), r);
+        store(out + c * 4, r);
+    }
+}
+
+} // namespace simd
+
+#endif // SIMD_FLOAT4_H
@@ -0,0 +1,59 @@
+#ifndef SIMD_TRANSFORM_H
+#define SIMD_TRANSFORM_H
+
+#include "simd_float4.h"
+
+namespace simd {
+
+/**
+ * Compone 4 matrices T * R * S a la vez, igual que Matrix4.trs()
+ *
+ * Entrada en SoA (un lane por transform), salida 4 matrices column-major
+ * consecutivas (64 floats).
+ */
+inline void composeTRS4(float4 px, float4 py, float4 pz,
+                        float4 x, float4 y, float4 z, float4 w,
+                        float4 sx, float4 sy, float4 sz,
+                        float* out) {
+    float4 one = set1(1.0f);
+    float4 two = set1(2.0f);
+
+    float4 xx = mul(x, x), yy = mul(y, y), zz = mul(z, z);
+    float4 xy = mul(x, y), xz = mul(x, z), yz = mul(y, z);
+    float4 wx = mul(w, x), wy = mul(w, y), wz = mul(w, z);
+
+    float4 c0x = mul(sub(one, mul(two, add(yy, zz))), sx);
+    float4 c0y = mul(mul(two, add(xy, wz)), sx);
+    float4 c0z = mul(mul(two, sub(xz, wy)), sx);
+    float4 c0w = zero();
+
+    float4 c1x = mul(mul(two, sub(xy, wz)), sy);
+    float4 c1y = mul(sub(one, mul(two, add(xx, zz))), sy);
+    float4 c1z = mul(mul(two, add(yz, wx)), sy);
+    float4 c1w = zero();
+
+    float4 c2x = mul(mul(two, add(xz, wy)), sz);
+    float4 c2y = mul(mul(two, sub(yz, wx)), sz);
+    float4 c2z = mul(sub(one, mul(two, add(xx, yy))), sz);
+    float4 c2w = zero();
+
+    float4 c3x = px;
+    float4 c3y = py;
+    float4 c3z = pz;
+    float4 c3w = one;
+
+    // SoA -> una matriz por transform
+    transpose(c0x, c0y, c0z, c0w);
+    transpose(c1x, c1y, c1z, c1w);
+    transpose(c2x, c2y, c2z, c2w);
+    transpose(c3x, c3y, c3z, c3w);
+
+    store(out + 0, c0x);  store(out + 4, c1x);  store(out + 8, c2x);  store(out + 12, c3x);
+    store(out + 16, c0y); store(out + 20, c1y); store(out + 24, c2y); store(out + 28, c3y);
+    store(out + 32, c0z); store(out + 36, c1z); store(out + 40, c2z); store(out + 44, c3z);
+    store(out + 48, c0w); store(out + 52, c1w); store(out + 56, c2w); store(out + 60, c3w);
+}
+
+} // namespace simd
+
+#endif // SIMD_TRANSFORM_H
@@ -0,0 +1,347 @@
+#include <jni.h>
+#include <android/log.h>
+#include "math_kernels.h"
+#include "culling_kernels.h"
+#include "ray_kernels.h"
+
+#define LOG_TAG "MathJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * Acceso crítico a un array primitivo durante un kernel
+ *
+ * Los kernels no llaman a JNI ni bloquean, así que se evita la copia de
+ * Get/Release<Type>ArrayElements. Las entradas se liberan con JNI_ABORT.
+ * Un array null deja get() a nullptr (parámetros opcionales).
+ */
+template <typename T>
+class CriticalArray {
+public:
+    CriticalArray(JNIEnv* env, jarray array, bool writable)
+        : env(env), array(array), writable(writable) {
+        if (array) {
+            data = static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr));
+        }
+    }
+
+    ~CriticalArray() {
+        if (data) {
+            env->ReleasePrimitiveArrayCritical(array, data, writable ? 0 : JNI_ABORT);
+        }
+    }
+
+    T* get() const { return data; }
+
+private:
+    JNIEnv* env;
+    jarray array;
+    bool writable;
+    T* data = nullptr;
+};
+
+typedef CriticalArray<float> CriticalFloats;
+typedef CriticalArray<jint> CriticalInts;
+
+extern "C" {
+
+// ========== Matrices ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeMat4MulBatch(
+    JNIEnv* env, jobject obj, jfloatArray a, jfloatArray b, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats left(env, a, false);
+    CriticalFloats right(env, b, false);
+    if (!left.get() || !right.get() || !dst.get()) {
+        LOGE("Failed to access arrays for mat4MulBatch");
+        return;
+    }
+
+    qemath::mat4MulBatch(left.get() + offset * 16, right.get() + offset * 16,
+                         dst.get() + offset * 16, count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeMat4PreMulBatch(
+    JNIEnv* env, jobject obj, jfloatArray left, jfloatArray b, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats matrix(env, left, false);
+    CriticalFloats right(env, b, false);
+    if (!matrix.get() || !right.get() || !dst.get()) {
+        LOGE("Failed to access arrays for mat4PreMulBatch");
+        return;
+    }
+
+    qemath::mat4PreMulBatch(matrix.get(), right.get() + offset * 16,
+                            dst.get() + offset * 16, count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeComposeTRS(
+    JNIEnv* env, jobject obj, jfloatArray trs, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats src(env, trs, false);
+    if (!src.get() || !dst.get()) {
+        LOGE("Failed to access arrays for composeTRS");
+        return;
+    }
+
+    qemath::composeTRSBatch(src.get() + offset * 10, dst.get() + offset * 16, count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeComposeTRSSplit(
+    JNIEnv* env, jobject obj, jfloatArray positions, jfloatArray rotations, jfloatArray scales,
+    jfloatArray out, jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats pos(env, positions, false);
+    CriticalFloats rot(env, rotations, false);
+    CriticalFloats scl(env, scales, false);
+    if (!pos.get() || !rot.get() || !scl.get() || !dst.get()) {
+        LOGE("Failed to access arrays for composeTRS");
+        return;
+    }
+
+    qemath::composeTRSBatch(pos.get() + offset * 3, rot.get() + offset * 4, scl.get() + offset * 3,
+                            dst.get() + offset * 16, count);
+}
+
+// ========== Puntos y normales ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeTransformPoints(
+    JNIEnv* env, jobject obj, jfloatArray matrix, jfloatArray points, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats m(env, matrix, false);
+    CriticalFloats src(env, points, false);
+    if (!m.get() || !src.get() || !dst.get()) {
+        LOGE("Failed to access arrays for transformPoints");
+        return;
+    }
+
+    qemath::transformPoints(m.get(), src.get() + offset * 3, dst.get() + offset * 3, count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeTransformNormals(
+    JNIEnv* env, jobject obj, jfloatArray matrix, jfloatArray normals, jfloatArray out,
+    jint offset, jint count, jboolean normalize) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats m(env, matrix, false);
+    CriticalFloats src(env, normals, false);
+    if (!m.get() || !src.get() || !dst.get()) {
+        LOGE("Failed to access arrays for transformNormals");
+        return;
+    }
+
+    qemath::transformNormals(m.get(), src.get() + offset * 3, dst.get() + offset * 3,
+                             count, normalize == JNI_TRUE);
+}
+
+// ========== Quaternions ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeSlerpBatch(
+    JNIEnv* env, jobject obj, jfloatArray a, jfloatArray b, jfloatArray t, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats from(env, a, false);
+    CriticalFloats to(env, b, false);
+    CriticalFloats factors(env, t, false);
+    if (!from.get() || !to.get() || !factors.get() || !dst.get()) {
+        LOGE("Failed to access arrays for slerpBatch");
+        return;
+    }
+
+    qemath::slerpBatch(from.get() + offset * 4, to.get() + offset * 4, factors.get() + offset,
+                       dst.get() + offset * 4, count);
+}
+
+// ========== Bounding Volumes ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeTransformAABBs(
+    JNIEnv* env, jobject obj, jfloatArray matrices, jfloatArray boxes, jfloatArray out,
+    jint offset, jint count) {
+    CriticalFloats dst(env, out, true);
+    CriticalFloats m(env, matrices, false);
+    CriticalFloats src(env, boxes, false);
+    if (!m.get() || !src.get() || !dst.get()) {
+        LOGE("Failed to access arrays for transformAABBs");
+        return;
+    }
+
+    qemath::transformAABBs(m.get() + offset * 16, src.get() + offset * 6,
+                           dst.get() + offset * 6, count);
+}
+
+// ========== Culling ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeCullSpheres(
+    JNIEnv* env, jobject obj, jfloatArray planes,
+    jfloatArray x, jfloatArray y, jfloatArray z, jfloatArray radius,
+    jint first, jint count, jintArray visible, jint visibleOffset) {
+    CriticalInts out(env, visible, true);
+    CriticalFloats frustum(env, planes, false);
+    CriticalFloats cx(env, x, false);
+    CriticalFloats cy(env, y, false);
+    CriticalFloats cz(env, z, false);
+    CriticalFloats r(env, radius, false);
+    if (!out.get() || !frustum.get() || !cx.get() || !cy.get() || !cz.get() || !r.get()) {
+        LOGE("Failed to access arrays for cullSpheres");
+        return 0;
+    }
+
+    return qemath::cullSpheres(frustum.get(), cx.get(), cy.get(), cz.get(), r.get(),
+                               first, count, out.get() + visibleOffset);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeCullAABBs(
+    JNIEnv* env, jobject obj, jfloatArray planes,
+    jfloatArray minX, jfloatArray minY, jfloatArray minZ,
+    jfloatArray maxX, jfloatArray maxY, jfloatArray maxZ,
+    jint first, jint count, jintArray visible, jint visibleOffset) {
+    CriticalInts out(env, visible, true);
+    CriticalFloats frustum(env, planes, false);
+    CriticalFloats lx(env, minX, false);
+    CriticalFloats ly(env, minY, false);
+    CriticalFloats lz(env, minZ, false);
+    CriticalFloats hx(env, maxX, false);
+    CriticalFloats hy(env, maxY, false);
+    CriticalFloats hz(env, maxZ, false);
+    if (!out.get() || !frustum.get() || !lx.get() || !ly.get() || !lz.get() ||
+        !hx.get() || !hy.get() || !hz.get()) {
+        LOGE("Failed to access arrays for cullAABBs");
+        return 0;
+    }
+
+    return qemath::cullAABBs(frustum.get(), lx.get(), ly.get(), lz.get(), hx.get(), hy.get(), hz.get(),
+                             first, count, out.get() + visibleOffset);
+}
+
+// ========== Raycasts ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeRaycastSpheres(
+    JNIEnv* env, jobject obj, jfloatArray ray, jfloat maxDistance, jfloatArray hitDistance,
+    jfloatArray x, jfloatArray y, jfloatArray z, jfloatArray radius,
+    jintArray layers, jint layerMask, jint first, jint count) {
+    CriticalFloats result(env, hitDistance, true);
+    CriticalFloats r(env, ray, false);
+    CriticalFloats cx(env, x, false);
+    CriticalFloats cy(env, y, false);
+    CriticalFloats cz(env, z, false);
+    CriticalFloats rad(env, radius, false);
+    CriticalInts objectLayers(env, layers, false);
+    if (!result.get() || !r.get() || !cx.get() || !cy.get() || !cz.get() || !rad.get() ||
+        (layers && !objectLayers.get())) {
+        LOGE("Failed to access arrays for raycastSpheres");
+        return qemath::NO_HIT;
+    }
+
+    return qemath::raycastSpheres(r.get(), maxDistance, cx.get(), cy.get(), cz.get(), rad.get(),
+                                  objectLayers.get(), layerMask, first, count, result.get());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeRaycastAABBs(
+    JNIEnv* env, jobject obj, jfloatArray ray, jfloat maxDistance, jfloatArray hitDistance,
+    jfloatArray minX, jfloatArray minY, jfloatArray minZ,
+    jfloatArray maxX, jfloatArray maxY, jfloatArray maxZ,
+    jintArray layers, jint layerMask, jint first, jint count) {
+    CriticalFloats result(env, hitDistance, true);
+    CriticalFloats r(env, ray, false);
+    CriticalFloats lx(env, minX, false);
+    CriticalFloats ly(env, minY, false);
+    CriticalFloats lz(env, minZ, false);
+    CriticalFloats hx(env, maxX, false);
+    CriticalFloats hy(env, maxY, false);
+    CriticalFloats hz(env, maxZ, false);
+    CriticalInts objectLayers(env, layers, false);
+    if (!result.get() || !r.get() || !lx.get() || !ly.get() || !lz.get() ||
+        !hx.get() || !hy.get() || !hz.get() || (layers && !objectLayers.get())) {
+        LOGE("Failed to access arrays for raycastAABBs");
+        return qemath::NO_HIT;
+    }
+
+    return qemath::raycastAABBs(r.get(), maxDistance, lx.get(), ly.get(), lz.get(),
+                                hx.get(), hy.get(), hz.get(),
+                                objectLayers.get(), layerMask, first, count, result.get());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeRaycastPacketSpheres(
+    JNIEnv* env, jobject obj, jfloatArray rays, jfloatArray maxDistances, jint rayOffset, jint rayCount,
+    jfloatArray x, jfloatArray y, jfloatArray z, jfloatArray radius,
+    jintArray layers, jint layerMask, jint first, jint count,
+    jintArray hitIndices, jfloatArray hitDistances) {
+    CriticalInts indices(env, hitIndices, true);
+    CriticalFloats distances(env, hitDistances, true);
+    CriticalFloats r(env, rays, false);
+    CriticalFloats limits(env, maxDistances, false);
+    CriticalFloats cx(env, x, false);
+    CriticalFloats cy(env, y, false);
+    CriticalFloats cz(env, z, false);
+    CriticalFloats rad(env, radius, false);
+    CriticalInts objectLayers(env, layers, false);
+    if (!indices.get() || !distances.get() || !r.get() || !limits.get() ||
+        !cx.get() || !cy.get() || !cz.get() || !rad.get() || (layers && !objectLayers.get())) {
+        LOGE("Failed to access arrays for raycastPacketSpheres");
+        return;
+    }
+
+    qemath::raycastPacketSpheres(r.get() + rayOffset * qemath::RAY_FLOATS, limits.get() + rayOffset, rayCount,
+                                 cx.get(), cy.get(), cz.get(), rad.get(),
+                                 objectLayers.get(), layerMask, first, count,
+                                 indices.get() + rayOffset, distances.get() + rayOffset);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeRaycastPacketAABBs(
+    JNIEnv* env, jobject obj, jfloatArray rays, jfloatArray maxDistances, jint rayOffset, jint rayCount,
+    jfloatArray minX, jfloatArray minY, jfloatArray minZ,
+    jfloatArray maxX, jfloatArray maxY, jfloatArray maxZ,
+    jintArray layers, jint layerMask, jint first, jint count,
+    jintArray hitIndices, jfloatArray hitDistances) {
+    CriticalInts indices(env, hitIndices, true);
+    CriticalFloats distances(env, hitDistances, true);
+    CriticalFloats r(env, rays, false);
+    CriticalFloats limits(env, maxDistances, false);
+    CriticalFloats lx(env, minX, false);
+    CriticalFloats ly(env, minY, false);
+    CriticalFloats lz(env, minZ, false);
+    CriticalFloats hx(env, maxX, false);
+    CriticalFloats hy(env, maxY, false);
+    CriticalFloats hz(env, maxZ, false);
+    CriticalInts objectLayers(env, layers, false);
+    if (!indices.get() || !distances.get() || !r.get() || !limits.get() ||
+        !lx.get() || !ly.get() || !lz.get() || !hx.get() || !hy.get() || !hz.get() ||
+        (layers && !objectLayers.get())) {
+        LOGE("Failed to access arrays for raycastPacketAABBs");
+        return;
+    }
+
+    qemath::raycastPacketAABBs(r.get() + rayOffset * qemath::RAY_FLOATS, limits.get() + rayOffset, rayCount,
+                               lx.get(), ly.get(), lz.get(), hx.get(), hy.get(), hz.get(),
+                               objectLayers.get(), layerMask, first, count,
+                               indices.get() + rayOffset, distances.get() + rayOffset);
+}
+
+// ========== Info ==========
+
+JNIEXPORT jstring JNICALL
+Java_com_quantum_engine_math_NativeMath_nativeGetBackend(
+    JNIEnv* env, jobject obj) {
+    const char* backend = qemath::getKernelBackend();
+    LOGI("Math kernels backend: %s", backend);
+    return env->NewStringUTF(backend);
+}
+
+} // extern "C"
@@ -0,0 +1,366 @@
+// math_kernels.cpp - Kernels por lotes con simd::float4 (NEON / SSE / escalar)
+#include "math_kernels.h"
+#include "simd_transform.h"
+#include <android/log.h>
+#include <cmath>
+#include <cstring>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "MathKernels", __VA_ARGS__)
+
+// Mismo EPSILON que MathUtils
+static const float MATH_EPSILON = 0.00001f;
+
+#if defined(QE_MATH_AVX2)
+// math_kernels_avx2.cpp (compilado con -mavx2 -mfma)
+namespace qemath {
+void mat4MulBatchAvx2(const float* a, const float* b, float* out, int count);
+void mat4PreMulBatchAvx2(const float* left, const float* b, float* out, int count);
+void composeTRSBatchAvx2(const TRSLayout& layout, float* out, int count);
+}
+
+static bool detectAvx2() {
+    __builtin_cpu_init();
+    bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    LOGI("AVX2+FMA %s", supported ? "disponible" : "no disponible, usando SSE");
+    return supported;
+}
+
+namespace qemath {
+// Compartido con culling_kernels.cpp y ray_kernels.cpp
+bool hasAvx2Kernels() {
+    static const bool supported = detectAvx2();
+    return supported;
+}
+}
+#endif
+
+namespace qemath {
+
+using namespace simd;
+
+// ========== Matrices ==========
+
+void mat4MulBatch(const float* a, const float* b, float* out, int count) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        mat4MulBatchAvx2(a, b, out, count);
+        return;
+    }
+#endif
+    for (int i = 0; i < count; i++) {
+        mat4Mul(a + i * 16, b + i * 16, out + i * 16);
+    }
+}
+
+void mat4PreMulBatch(const float* left, const float* b, float* out, int count) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        mat4PreMulBatchAvx2(left, b, out, count);
+        return;
+    }
+#endif
+    float4 a0 = load(left);
+    float4 a1 = load(left + 4);
+    float4 a2 = load(left + 8);
+    float4 a3 = load(left + 12);
+
+    for (int i = 0; i < count; i++) {
+        const float* src = b + i * 16;
+        float* dst = out + i * 16;
+
+        for (int c = 0; c < 4; c++) {
+            float4 col = load(src + c * 4);
+            float4 r = mul(a0, splat<0>(col));
+            r = madd(a1, splat<1>(col), r);
+            r = madd(a2, splat<2>(col), r);
+            r = madd(a3, splat<3>(col), r);
+            store(dst + c * 4, r);
+        }
+    }
+}
+
+void composeTRSBatch(const TRSLayout& layout, float* out, int count) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        composeTRSBatchAvx2(layout, out, count);
+        return;
+    }
+#endif
+    // AoS -> SoA de 4 lanes
+    alignas(16) float soa[10][4];
+    alignas(16) float tail[64];
+
+    for (int first = 0; first < count; first += 4) {
+        int lanes = count - first < 4 ? count - first : 4;
+
+        for (int lane = 0; lane < 4; lane++) {
+            // Los lanes sobrantes del último grupo repiten el último transform
+            gatherTRS(layout, first + (lane < lanes ? lane : lanes - 1), soa, lane);
+        }
+
+        float* dst = lanes == 4 ? out + first * 16 : tail;
+        composeTRS4(load(soa[0]), load(soa[1]), load(soa[2]),
+                    load(soa[3]), load(soa[4]), load(soa[5]), load(soa[6]),
+                    load(soa[7]), load(soa[8]), load(soa[9]),
+                    dst);
+
+        if (lanes < 4) {
+            memcpy(out + first * 16, tail, sizeof(float) * 16 * lanes);
+        }
+    }
+}
+
+// ========== Puntos y normales ==========
+
+// Carga 4 vectores xyz consecutivos como SoA
+static inline void loadVec3x4(const float* p, float4& x, float4& y, float4& z) {
+    alignas(16) float a[4], b[4], c[4];
+    for (int i = 0; i < 4; i++) {
+        a[i] = p[i * 3];
+        b[i] = p[i * 3 + 1];
+        c[i] = p[i * 3 + 2];
+    }
+    x = load(a);
+    y = load(b);
+    z = load(c);
+}
+
+static inline void storeVec3x4(float* p, float4 x, float4 y, float4 z) {
+    alignas(16) float a[4], b[4], c[4];
+    store(a, x);
+    store(b, y);
+    store(c, z);
+    for (int i = 0; i < 4; i++) {
+        p[i * 3] = a[i];
+        p[i * 3 + 1] = b[i];
+        p[i * 3 + 2] = c[i];
+    }
+}
+
+// Procesa en grupos de 4; el resto pasa por un buffer con padding
+template <typename Kernel>
+static void forEachVec3x4(const float* in, float* out, int count, Kernel kernel) {
+    int full = count & ~3;
+    for (int i = 0; i < full; i += 4) {
+        float4 x, y, z;
+        loadVec3x4(in + i * 3, x, y, z);
+        kernel(x, y, z);
+        storeVec3x4(out + i * 3, x, y, z);
+    }
+
+    int rest = count - full;
+    if (rest > 0) {
+        float tmp[12] = {};
+        memcpy(tmp, in + full * 3, sizeof(float) * 3 * rest);
+        float4 x, y, z;
+        loadVec3x4(tmp, x, y, z);
+        kernel(x, y, z);
+        storeVec3x4(tmp, x, y, z);
+        memcpy(out + full * 3, tmp, sizeof(float) * 3 * rest);
+    }
+}
+
+void transformPoints(const float* matrix, const float* points, float* out, int count) {
+    float4 m00 = set1(matrix[0]), m01 = set1(matrix[1]), m02 = set1(matrix[2]);
+    float4 m10 = set1(matrix[4]), m11 = set1(matrix[5]), m12 = set1(matrix[6]);
+    float4 m20 = set1(matrix[8]), m21 = set1(matrix[9]), m22 = set1(matrix[10]);
+    float4 m30 = set1(matrix[12]), m31 = set1(matrix[13]), m32 = set1(matrix[14]);
+
+    forEachVec3x4(points, out, count, [&](float4& x, float4& y, float4& z) {
+        float4 rx = madd(m20, z, madd(m10, y, madd(m00, x, m30)));
+        float4 ry = madd(m21, z, madd(m11, y, madd(m01, x, m31)));
+        float4 rz = madd(m22, z, madd(m12, y, madd(m02, x, m32)));
+        x = rx;
+        y = ry;
+        z = rz;
+    });
+}
+
+void transformNormals(const float* matrix, const float* normals, float* out, int count, bool normalize) {
+    float4 m00 = set1(matrix[0]), m01 = set1(matrix[1]), m02 = set1(matrix[2]);
+    float4 m10 = set1(matrix[4]), m11 = set1(matrix[5]), m12 = set1(matrix[6]);
+    float4 m20 = set1(matrix[8]), m21 = set1(matrix[9]), m22 = set1(matrix[10]);
+    float4 epsilon = set1(MATH_EPSILON);
+
+    forEachVec3x4(normals, out, count, [&](float4& x, float4& y, float4& z) {
+        float4 rx = madd(m20, z, madd(m10, y, mul(m00, x)));
+        float4 ry = madd(m21, z, madd(m11, y, mul(m01, x)));
+        float4 rz = madd(m22, z, madd(m12, y, mul(m02, x)));
+
+        if (normalize) {
+            // Como Vector3.normalized: longitud <= EPSILON da cero
+            float4 length = sqrt(madd(rz, rz, madd(ry, ry, mul(rx, rx))));
+            float4 valid = cmpgt(length, epsilon);
+            float4 inv = select(valid, div(set1(1.0f), max(length, epsilon)), zero());
+            rx = mul(rx, inv);
+            ry = mul(ry, inv);
+            rz = mul(rz, inv);
+        }
+
+        x = rx;
+        y = ry;
+        z = rz;
+    });
+}
+
+// ========== Quaternions ==========
+
+void slerpBatch(const float* a, const float* b, const float* t, float* out, int count) {
+    float4 zeroV = zero();
+    float4 oneV = set1(1.0f);
+    float4 epsilon = set1(MATH_EPSILON);
+
+    alignas(16) float tmpA[16], tmpB[16], tmpT[4], tmpOut[16];
+    alignas(16) float cosines[4], ratiosA[4], ratiosB[4], renormalize[4];
+
+    for (int first = 0; first < count; first += 4) {
+        int lanes = count - first < 4 ? count - first : 4;
+
+        const float* srcA = a + first * 4;
+        const float* srcB = b + first * 4;
+        const float* srcT = t + first;
+        float* dst = out + first * 4;
+
+        if (lanes < 4) {
+            // Padding con identidad
+            for (int i = 0; i < 16; i++) {
+                tmpA[i] = tmpB[i] = (i & 3) == 3 ? 1.0f : 0.0f;
+            }
+            memset(tmpT, 0, sizeof(tmpT));
+            memcpy(tmpA, srcA, sizeof(float) * 4 * lanes);
+            memcpy(tmpB, srcB, sizeof(float) * 4 * lanes);
+            memcpy(tmpT, srcT, sizeof(float) * lanes);
+            srcA = tmpA;
+            srcB = tmpB;
+            srcT = tmpT;
+            dst = tmpOut;
+        }
+
+        float4 ax = load(srcA), ay = load(srcA + 4), az = load(srcA + 8), aw = load(srcA + 12);
+        float4 bx = load(srcB), by = load(srcB + 4), bz = load(srcB + 8), bw = load(srcB + 12);
+        transpose(ax, ay, az, aw);
+        transpose(bx, by, bz, bw);
+
+        float4 tv = min(max(load(srcT), zeroV), oneV);
+
+        // Camino más corto
+        float4 cosHalf = madd(aw, bw, madd(az, bz, madd(ay, by, mul(ax, bx))));
+        float4 flip = cmplt(cosHalf, zeroV);
+        bx = select(flip, sub(zeroV, bx), bx);
+        by = select(flip, sub(zeroV, by), by);
+        bz = select(flip, sub(zeroV, bz), bz);
+        bw = select(flip, sub(zeroV, bw), bw);
+        cosHalf = abs(cosHalf);
+
+        // acos/sin por lane, con las mismas ramas que Quaternion.slerp()
+        alignas(16) float ts[4];
+        store(cosines, cosHalf);
+        store(ts, tv);
+        for (int lane = 0; lane < 4; lane++) {
+            float cosine = cosines[lane];
+            float s = ts[lane];
+
+            if (cosine >= 1.0f - MATH_EPSILON) {
+                ratiosA[lane] = 1.0f - s;
+                ratiosB[lane] = s;
+                renormalize[lane] = 1.0f;
+                continue;
+            }
+
+            float halfTheta = std::acos(cosine);
+            float sinHalfTheta = std::sqrt(1.0f - cosine * cosine);
+            renormalize[lane] = 0.0f;
+
+            if (std::fabs(sinHalfTheta) < MATH_EPSILON) {
+                ratiosA[lane] = 0.5f;
+                ratiosB[lane] = 0.5f;
+            } else {
+                ratiosA[lane] = std::sin((1.0f - s) * halfTheta) / sinHalfTheta;
+                ratiosB[lane] = std::sin(s * halfTheta) / sinHalfTheta;
+            }
+        }
+
+        float4 ra = load(ratiosA);
+        float4 rb = load(ratiosB);
+        float4 rx = madd(bx, rb, mul(ax, ra));
+        float4 ry = madd(by, rb, mul(ay, ra));
+        float4 rz = madd(bz, rb, mul(az, ra));
+        float4 rw = madd(bw, rb, mul(aw, ra));
+
+        // Rama lerp: normalized, con identidad si la magnitud es ~0
+        float4 magnitude = sqrt(madd(rw, rw, madd(rz, rz, madd(ry, ry, mul(rx, rx)))));
+        float4 lerpLanes = cmpgt(load(renormalize), zeroV);
+        float4 valid = cmpgt(magnitude, epsilon);
+        float4 inv = div(oneV, max(magnitude, epsilon));
+        float4 nx = select(valid, mul(rx, inv), zeroV);
+        float4 ny = select(valid, mul(ry, inv), zeroV);
+        float4 nz = select(valid, mul(rz, inv), zeroV);
+        float4 nw = select(valid, mul(rw, inv), oneV);
+        rx = select(lerpLanes, nx, rx);
+        ry = select(lerpLanes, ny, ry);
+        rz = select(lerpLanes, nz, rz);
+        rw = select(lerpLanes, nw, rw);
+
+        transpose(rx, ry, rz, rw);
+        store(dst, rx);
+        store(dst + 4, ry);
+        store(dst + 8, rz);
+        store(dst + 12, rw);
+
+        if (lanes < 4) {
+            memcpy(out + first * 4, tmpOut, sizeof(float) * 4 * lanes);
+        }
+    }
+}
+
+// ========== Bounding volumes ==========
+
+void transformAABBs(const float* matrices, const float* boxes, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* m = matrices + i * 16;
+        const float* box = boxes + i * 6;
+
+        // Centro/extensión (Arvo): equivale a transformar las 8 esquinas
+        float cx = (box[0] + box[3]) * 0.5f;
+        float cy = (box[1] + box[4]) * 0.5f;
+        float cz = (box[2] + box[5]) * 0.5f;
+        float ex = (box[3] - box[0]) * 0.5f;
+        float ey = (box[4] - box[1]) * 0.5f;
+        float ez = (box[5] - box[2]) * 0.5f;
+
+        float4 c0 = load(m);
+        float4 c1 = load(m + 4);
+        float4 c2 = load(m + 8);
+        float4 c3 = load(m + 12);
+
+        float4 center = madd(c2, set1(cz), madd(c1, set1(cy), madd(c0, set1(cx), c3)));
+        float4 extent = madd(abs(c2), set1(ez), madd(abs(c1), set1(ey), mul(abs(c0), set1(ex))));
+
+        alignas(16) float minV[4], maxV[4];
+        store(minV, sub(center, extent));
+        store(maxV, add(center, extent));
+
+        float* dst = out + i * 6;
+        dst[0] = minV[0];
+        dst[1] = minV[1];
+        dst[2] = minV[2];
+        dst[3] = maxV[0];
+        dst[4] = maxV[1];
+        dst[5] = maxV[2];
+    }
+}
+
+const char* getKernelBackend() {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) return "AVX2";
+#endif
+#if defined(QE_SIMD_NEON)
+    return "NEON";
+#elif defined(QE_SIMD_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
+
+} // namespace qemath
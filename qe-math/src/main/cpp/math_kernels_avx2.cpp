@@ -0,0 +1,132 @@
+// math_kernels_avx2.cpp - Variantes de 8 lanes para x86_64 con AVX2 + FMA
+// Sólo se compila para x86_64 con -mavx2 -mfma; math_kernels.cpp decide en
+// tiempo de ejecución si la CPU las soporta.
+#include "math_kernels.h"
+#include <immintrin.h>
+#include <cstring>
+
+namespace qemath {
+
+// Transpone dos bloques 4x4 a la vez (uno por cada mitad de 128 bits)
+static inline void transpose8(__m256& r0, __m256& r1, __m256& r2, __m256& r3) {
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    r0 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)));
+    r1 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t0), _mm256_castps_pd(t2)));
+    r2 = _mm256_castpd_ps(_mm256_unpacklo_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)));
+    r3 = _mm256_castpd_ps(_mm256_unpackhi_pd(_mm256_castps_pd(t1), _mm256_castps_pd(t3)));
+}
+
+// Dos columnas de b por registro: cada mitad multiplica a por una columna
+static inline void mat4MulAvx2(__m256 a0, __m256 a1, __m256 a2, __m256 a3, const float* b, float* out) {
+    __m256 b01 = _mm256_loadu_ps(b);
+    __m256 b23 = _mm256_loadu_ps(b + 8);
+
+    __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+    r01 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b01, 0x55), r01);
+    r01 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b01, 0xAA), r01);
+    r01 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b01, 0xFF), r01);
+
+    __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+    r23 = _mm256_fmadd_ps(a1, _mm256_permute_ps(b23, 0x55), r23);
+    r23 = _mm256_fmadd_ps(a2, _mm256_permute_ps(b23, 0xAA), r23);
+    r23 = _mm256_fmadd_ps(a3, _mm256_permute_ps(b23, 0xFF), r23);
+
+    _mm256_storeu_ps(out, r01);
+    _mm256_storeu_ps(out + 8, r23);
+}
+
+static inline __m256 broadcastColumn(const float* column) {
+    return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(column));
+}
+
+void mat4MulBatchAvx2(const float* a, const float* b, float* out, int count) {
+    for (int i = 0; i < count; i++) {
+        const float* left = a + i * 16;
+        mat4MulAvx2(broadcastColumn(left), broadcastColumn(left + 4),
+                    broadcastColumn(left + 8), broadcastColumn(left + 12),
+                    b + i * 16, out + i * 16);
+    }
+}
+
+void mat4PreMulBatchAvx2(const float* left, const float* b, float* out, int count) {
+    __m256 a0 = broadcastColumn(left);
+    __m256 a1 = broadcastColumn(left + 4);
+    __m256 a2 = broadcastColumn(left + 8);
+    __m256 a3 = broadcastColumn(left + 12);
+
+    for (int i = 0; i < count; i++) {
+        mat4MulAvx2(a0, a1, a2, a3, b + i * 16, out + i * 16);
+    }
+}
+
+// Guarda 4 columnas transpuestas: la mitad baja son las matrices 0-3 y la alta las 4-7
+static inline void storeColumns8(float* out, int column, __m256 r0, __m256 r1, __m256 r2, __m256 r3) {
+    const __m256 rows[4] = { r0, r1, r2, r3 };
+    for (int m = 0; m < 4; m++) {
+        _mm_storeu_ps(out + m * 16 + column * 4, _mm256_castps256_ps128(rows[m]));
+        _mm_storeu_ps(out + (m + 4) * 16 + column * 4, _mm256_extractf128_ps(rows[m], 1));
+    }
+}
+
+void composeTRSBatchAvx2(const TRSLayout& layout, float* out, int count) {
+    alignas(32) float soa[10][8];
+    alignas(32) float tail[128];
+
+    for (int first = 0; first < count; first += 8) {
+        int lanes = count - first < 8 ? count - first : 8;
+
+        for (int lane = 0; lane < 8; lane++) {
+            gatherTRS(layout, first + (lane < lanes ? lane : lanes - 1), soa, lane);
+        }
+
+        __m256 px = _mm256_load_ps(soa[0]), py = _mm256_load_ps(soa[1]), pz = _mm256_load_ps(soa[2]);
+        __m256 x = _mm256_load_ps(soa[3]), y = _mm256_load_ps(soa[4]);
+        __m256 z = _mm256_load_ps(soa[5]), w = _mm256_load_ps(soa[6]);
+        __m256 sx = _mm256_load_ps(soa[7]), sy = _mm256_load_ps(soa[8]), sz = _mm256_load_ps(soa[9]);
+
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 two = _mm256_set1_ps(2.0f);
+        __m256 zero = _mm256_setzero_ps();
+
+        __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+        __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+        __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+        __m256 c0x = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx);
+        __m256 c0y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx);
+        __m256 c0z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx);
+        __m256 c0w = zero;
+
+        __m256 c1x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy);
+        __m256 c1y = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy);
+        __m256 c1z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy);
+        __m256 c1w = zero;
+
+        __m256 c2x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz);
+        __m256 c2y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz);
+        __m256 c2z = _mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz);
+        __m256 c2w = zero;
+
+        __m256 c3x = px, c3y = py, c3z = pz, c3w = one;
+
+        transpose8(c0x, c0y, c0z, c0w);
+        transpose8(c1x, c1y, c1z, c1w);
+        transpose8(c2x, c2y, c2z, c2w);
+        transpose8(c3x, c3y, c3z, c3w);
+
+        float* dst = lanes == 8 ? out + first * 16 : tail;
+        storeColumns8(dst, 0, c0x, c0y, c0z, c0w);
+        storeColumns8(dst, 1, c1x, c1y, c1z, c1w);
+        storeColumns8(dst, 2, c2x, c2y, c2z, c2w);
+        storeColumns8(dst, 3, c3x, c3y, c3z, c3w);
+
+        if (lanes < 8) {
+            memcpy(out + first * 16, tail, sizeof(float) * 16 * lanes);
+        }
+    }
+}
+
+} // namespace qemath
@@ -0,0 +1,304 @@
+// ray_kernels.cpp - Raycasts de 4 en 4 con simd::float4
+#include "ray_kernels.h"
+#include "simd_float4.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+// Componentes de dirección por debajo de esto se tratan como paralelas al slab
+static const float RAY_EPSILON = 1e-8f;
+
+#if defined(QE_MATH_AVX2)
+// ray_kernels_avx2.cpp (8 objetos por iteración)
+namespace qemath {
+bool hasAvx2Kernels();
+int raycastSpheresAvx2(const float* ray, float maxDistance,
+                       const float* x, const float* y, const float* z, const float* radius,
+                       const int* layers, int layerMask,
+                       int first, int count, float* hitDistance);
+int raycastAABBsAvx2(const float* ray, float maxDistance,
+                     const float* minX, const float* minY, const float* minZ,
+                     const float* maxX, const float* maxY, const float* maxZ,
+                     const int* layers, int layerMask,
+                     int first, int count, float* hitDistance);
+}
+#endif
+
+namespace qemath {
+
+using namespace simd;
+
+// ========== Helpers ==========
+
+// Inversa finita: evita inf/NaN (compilamos con -ffast-math)
+static inline float safeInverse(float d) {
+    if (std::fabs(d) > RAY_EPSILON) return 1.0f / d;
+    return d >= 0.0f ? 1.0f / RAY_EPSILON : -1.0f / RAY_EPSILON;
+}
+
+// Capas fuera de 0..31 no pasan ningún filtro (y el desplazamiento queda definido)
+static inline bool layerAccepted(const int* layers, int layerMask, int index) {
+    if (!layers) return true;
+    uint32_t layer = static_cast<uint32_t>(layers[index]);
+    return layer < 32u && ((static_cast<uint32_t>(layerMask) >> layer) & 1u) != 0;
+}
+
+// Distancia de impacto o FLT_MAX, igual que Ray.intersectSphere()
+static inline float sphereDistance(const float* ray, float cx, float cy, float cz, float r) {
+    float ocx = ray[0] - cx, ocy = ray[1] - cy, ocz = ray[2] - cz;
+    float b = ocx * ray[3] + ocy * ray[4] + ocz * ray[5];
+    float c = ocx * ocx + ocy * ocy + ocz * ocz - r * r;
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f) return FLT_MAX;
+    float t = -b - std::sqrt(discriminant);
+    return t >= 0.0f ? t : FLT_MAX;
+}
+
+// Igual que Ray.intersectAABB(); invDir precalculada con safeInverse()
+static inline float aabbDistance(const float* ray, const float* invDir,
+                                 float lx, float ly, float lz, float hx, float hy, float hz) {
+    float t1 = (lx - ray[0]) * invDir[0], t2 = (hx - ray[0]) * invDir[0];
+    float t3 = (ly - ray[1]) * invDir[1], t4 = (hy - ray[1]) * invDir[1];
+    float t5 = (lz - ray[2]) * invDir[2], t6 = (hz - ray[2]) * invDir[2];
+    float tmin = std::fmax(std::fmax(std::fmin(t1, t2), std::fmin(t3, t4)), std::fmin(t5, t6));
+    float tmax = std::fmin(std::fmin(std::fmax(t1, t2), std::fmax(t3, t4)), std::fmax(t5, t6));
+    if (tmax < 0.0f || tmin > tmax) return FLT_MAX;
+    return tmin >= 0.0f ? tmin : tmax;
+}
+
+// Recorre los lanes con impacto más cercano que best (en orden, así con
+// empates gana el índice menor) y aplica el filtro de capas
+static inline void takeNearest(float4 distances, int bits, int base,
+                               const int* layers, int layerMask, float& best, int& bestIndex) {
+    float lanes[4];
+    store(lanes, distances);
+    for (int lane = 0; lane < 4; lane++) {
+        if (((bits >> lane) & 1) && lanes[lane] < best && layerAccepted(layers, layerMask, base + lane)) {
+            best = lanes[lane];
+            bestIndex = base + lane;
+        }
+    }
+}
+
+// ========== Un rayo contra muchos objetos ==========
+
+int raycastSpheres(const float* ray, float maxDistance,
+                   const float* x, const float* y, const float* z, const float* radius,
+                   const int* layers, int layerMask,
+                   int first, int count, float* hitDistance) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        return raycastSpheresAvx2(ray, maxDistance, x, y, z, radius, layers, layerMask,
+                                  first, count, hitDistance);
+    }
+#endif
+    float4 ox = set1(ray[0]), oy = set1(ray[1]), oz = set1(ray[2]);
+    float4 dx = set1(ray[3]), dy = set1(ray[4]), dz = set1(ray[5]);
+    float4 noHit = set1(FLT_MAX);
+    float4 zeros = zero();
+
+    float best = maxDistance;
+    int bestIndex = NO_HIT;
+    int end = first + count;
+    int i = first;
+
+    for (; i + 4 <= end; i += 4) {
+        float4 ocx = sub(ox, load(x + i));
+        float4 ocy = sub(oy, load(y + i));
+        float4 ocz = sub(oz, load(z + i));
+        float4 r = load(radius + i);
+
+        float4 b = madd(ocz, dz, madd(ocy, dy, mul(ocx, dx)));
+        float4 c = sub(madd(ocz, ocz, madd(ocy, ocy, mul(ocx, ocx))), mul(r, r));
+        float4 discriminant = sub(mul(b, b), c);
+        float4 t = sub(sub(zeros, b), sqrt(max(discriminant, zeros)));
+
+        float4 miss = maskOr(cmplt(discriminant, zeros), cmplt(t, zeros));
+        float4 distance = select(miss, noHit, t);
+        int bits = maskBits(cmplt(distance, set1(best)));
+        if (bits) {
+            takeNearest(distance, bits, i, layers, layerMask, best, bestIndex);
+        }
+    }
+
+    for (; i < end; i++) {
+        float distance = sphereDistance(ray, x[i], y[i], z[i], radius[i]);
+        if (distance < best && layerAccepted(layers, layerMask, i)) {
+            best = distance;
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex != NO_HIT) *hitDistance = best;
+    return bestIndex;
+}
+
+int raycastAABBs(const float* ray, float maxDistance,
+                 const float* minX, const float* minY, const float* minZ,
+                 const float* maxX, const float* maxY, const float* maxZ,
+                 const int* layers, int layerMask,
+                 int first, int count, float* hitDistance) {
+#if defined(QE_MATH_AVX2)
+    if (hasAvx2Kernels()) {
+        return raycastAABBsAvx2(ray, maxDistance, minX, minY, minZ, maxX, maxY, maxZ,
+                                layers, layerMask, first, count, hitDistance);
+    }
+#endif
+    float invDir[3] = { safeInverse(ray[3]), safeInverse(ray[4]), safeInverse(ray[5]) };
+
+    float4 ox = set1(ray[0]), oy = set1(ray[1]), oz = set1(ray[2]);
+    float4 ix = set1(invDir[0]), iy = set1(invDir[1]), iz = set1(invDir[2]);
+    float4 noHit = set1(FLT_MAX);
+    float4 zeros = zero();
+
+    float best = maxDistance;
+    int bestIndex = NO_HIT;
+    int end = first + count;
+    int i = first;
+
+    for (; i + 4 <= end; i += 4) {
+        float4 t1 = mul(sub(load(minX + i), ox), ix), t2 = mul(sub(load(maxX + i), ox), ix);
+        float4 t3 = mul(sub(load(minY + i), oy), iy), t4 = mul(sub(load(maxY + i), oy), iy);
+        float4 t5 = mul(sub(load(minZ + i), oz), iz), t6 = mul(sub(load(maxZ + i), oz), iz);
+
+        float4 tmin = max(max(min(t1, t2), min(t3, t4)), min(t5, t6));
+        float4 tmax = min(min(max(t1, t2), max(t3, t4)), max(t5, t6));
+
+        float4 miss = maskOr(cmplt(tmax, zeros), cmpgt(tmin, tmax));
+        float4 distance = select(miss, noHit, select(cmplt(tmin, zeros), tmax, tmin));
+        int bits = maskBits(cmplt(distance, set1(best)));
+        if (bits) {
+            takeNearest(distance, bits, i, layers, layerMask, best, bestIndex);
+        }
+    }
+
+    for (; i < end; i++) {
+        float distance = aabbDistance(ray, invDir, minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i]);
+        if (distance < best && layerAccepted(layers, layerMask, i)) {
+            best = distance;
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex != NO_HIT) *hitDistance = best;
+    return bestIndex;
+}
+
+// ========== Paquetes de rayos ==========
+
+// 4 rayos transpuestos a SoA; los lanes sobrantes tienen maxDistance 0 y
+// nunca registran impacto
+struct RayPacket4 {
+    float4 ox, oy, oz;
+    float4 dx, dy, dz;
+    float4 best;
+    float4 index;
+    int lanes;
+};
+
+static inline RayPacket4 loadPacket(const float* rays, const float* maxDistances, int rayIndex, int rayCount,
+                                    bool inverseDirection) {
+    float o[3][4] = {}, d[3][4] = {}, best[4] = {};
+    int lanes = rayCount - rayIndex < 4 ? rayCount - rayIndex : 4;
+    for (int lane = 0; lane < lanes; lane++) {
+        const float* ray = rays + (rayIndex + lane) * RAY_FLOATS;
+        for (int axis = 0; axis < 3; axis++) {
+            o[axis][lane] = ray[axis];
+            d[axis][lane] = inverseDirection ? safeInverse(ray[3 + axis]) : ray[3 + axis];
+        }
+        best[lane] = maxDistances[rayIndex + lane];
+    }
+
+    RayPacket4 packet;
+    packet.ox = load(o[0]); packet.oy = load(o[1]); packet.oz = load(o[2]);
+    packet.dx = load(d[0]); packet.dy = load(d[1]); packet.dz = load(d[2]);
+    packet.best = load(best);
+    packet.index = set1(static_cast<float>(NO_HIT));
+    packet.lanes = lanes;
+    return packet;
+}
+
+// Los índices viajan como float (exactos hasta 2^24 objetos)
+static inline void storePacket(const RayPacket4& packet, int rayIndex, int* hitIndices, float* hitDistances) {
+    float best[4], index[4];
+    store(best, packet.best);
+    store(index, packet.index);
+    for (int lane = 0; lane < packet.lanes; lane++) {
+        hitIndices[rayIndex + lane] = static_cast<int>(index[lane]);
+        hitDistances[rayIndex + lane] = best[lane];
+    }
+}
+
+void raycastPacketSpheres(const float* rays, const float* maxDistances, int rayCount,
+                          const float* x, const float* y, const float* z, const float* radius,
+                          const int* layers, int layerMask,
+                          int first, int count, int* hitIndices, float* hitDistances) {
+    float4 noHit = set1(FLT_MAX);
+    float4 zeros = zero();
+    int end = first + count;
+
+    for (int r = 0; r < rayCount; r += 4) {
+        RayPacket4 packet = loadPacket(rays, maxDistances, r, rayCount, false);
+
+        for (int i = first; i < end; i++) {
+            if (!layerAccepted(layers, layerMask, i)) continue;
+
+            float4 ocx = sub(packet.ox, set1(x[i]));
+            float4 ocy = sub(packet.oy, set1(y[i]));
+            float4 ocz = sub(packet.oz, set1(z[i]));
+            float4 radiusSq = set1(radius[i] * radius[i]);
+
+            float4 b = madd(ocz, packet.dz, madd(ocy, packet.dy, mul(ocx, packet.dx)));
+            float4 c = sub(madd(ocz, ocz, madd(ocy, ocy, mul(ocx, ocx))), radiusSq);
+            float4 discriminant = sub(mul(b, b), c);
+            float4 t = sub(sub(zeros, b), sqrt(max(discriminant, zeros)));
+
+            float4 miss = maskOr(cmplt(discriminant, zeros), cmplt(t, zeros));
+            float4 distance = select(miss, noHit, t);
+            float4 closer = cmplt(distance, packet.best);
+            packet.best = select(closer, distance, packet.best);
+            packet.index = select(closer, set1(static_cast<float>(i)), packet.index);
+        }
+
+        storePacket(packet, r, hitIndices, hitDistances);
+    }
+}
+
+void raycastPacketAABBs(const float* rays, const float* maxDistances, int rayCount,
+                        const float* minX, const float* minY, const float* minZ,
+                        const float* maxX, const float* maxY, const float* maxZ,
+                        const int* layers, int layerMask,
+                        int first, int count, int* hitIndices, float* hitDistances) {
+    float4 noHit = set1(FLT_MAX);
+    float4 zeros = zero();
+    int end = first + count;
+
+    for (int r = 0; r < rayCount; r += 4) {
+        // dx/dy/dz guardan la dirección inversa
+        RayPacket4 packet = loadPacket(rays, maxDistances, r, rayCount, true);
+
+        for (int i = first; i < end; i++) {
+            if (!layerAccepted(layers, layerMask, i)) continue;
+
+            float4 t1 = mul(sub(set1(minX[i]), packet.ox), packet.dx);
+            float4 t2 = mul(sub(set1(maxX[i]), packet.ox), packet.dx);
+            float4 t3 = mul(sub(set1(minY[i]), packet.oy), packet.dy);
+            float4 t4 = mul(sub(set1(maxY[i]), packet.oy), packet.dy);
+            float4 t5 = mul(sub(set1(minZ[i]), packet.oz), packet.dz);
+            float4 t6 = mul(sub(set1(maxZ[i]), packet.oz), packet.dz);
+
+            float4 tmin = max(max(min(t1, t2), min(t3, t4)), min(t5, t6));
+            float4 tmax = min(min(max(t1, t2), max(t3, t4)), max(t5, t6));
+
+            float4 miss = maskOr(cmplt(tmax, zeros), cmpgt(tmin, tmax));
+            float4 distance = select(miss, noHit, select(cmplt(tmin, zeros), tmax, tmin));
+            float4 closer = cmplt(distance, packet.best);
+            packet.best = select(closer, distance, packet.best);
+            packet.index = select(closer, set1(static_cast<float>(i)), packet.index);
+        }
+
+        storePacket(packet, r, hitIndices, hitDistances);
+    }
+}
+
+} // namespace qemath
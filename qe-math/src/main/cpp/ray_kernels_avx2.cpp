@@ -0,0 +1,144 @@
+// ray_kernels_avx2.cpp - Raycast de un rayo contra 8 objetos por iteración (AVX2 + FMA)
+// Sólo se compila para x86_64 con -mavx2 -mfma; ray_kernels.cpp decide en
+// tiempo de ejecución si la CPU las soporta.
+#include "ray_kernels.h"
+#include <immintrin.h>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+namespace qemath {
+
+static const float RAY_EPSILON_AVX2 = 1e-8f;
+
+static inline float safeInverseAvx2(float d) {
+    if (std::fabs(d) > RAY_EPSILON_AVX2) return 1.0f / d;
+    return d >= 0.0f ? 1.0f / RAY_EPSILON_AVX2 : -1.0f / RAY_EPSILON_AVX2;
+}
+
+// Capas fuera de 0..31 no pasan ningún filtro (y el desplazamiento queda definido)
+static inline bool layerAcceptedAvx2(const int* layers, int layerMask, int index) {
+    if (!layers) return true;
+    uint32_t layer = static_cast<uint32_t>(layers[index]);
+    return layer < 32u && ((static_cast<uint32_t>(layerMask) >> layer) & 1u) != 0;
+}
+
+static inline void takeNearest8(__m256 distances, int bits, int base,
+                                const int* layers, int layerMask, float& best, int& bestIndex) {
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, distances);
+    for (int lane = 0; lane < 8; lane++) {
+        if (((bits >> lane) & 1) && lanes[lane] < best && layerAcceptedAvx2(layers, layerMask, base + lane)) {
+            best = lanes[lane];
+            bestIndex = base + lane;
+        }
+    }
+}
+
+int raycastSpheresAvx2(const float* ray, float maxDistance,
+                       const float* x, const float* y, const float* z, const float* radius,
+                       const int* layers, int layerMask,
+                       int first, int count, float* hitDistance) {
+    __m256 ox = _mm256_set1_ps(ray[0]), oy = _mm256_set1_ps(ray[1]), oz = _mm256_set1_ps(ray[2]);
+    __m256 dx = _mm256_set1_ps(ray[3]), dy = _mm256_set1_ps(ray[4]), dz = _mm256_set1_ps(ray[5]);
+    __m256 noHit = _mm256_set1_ps(FLT_MAX);
+    __m256 zero = _mm256_setzero_ps();
+
+    float best = maxDistance;
+    int bestIndex = NO_HIT;
+    int end = first + count;
+    int i = first;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 ocx = _mm256_sub_ps(ox, _mm256_loadu_ps(x + i));
+        __m256 ocy = _mm256_sub_ps(oy, _mm256_loadu_ps(y + i));
+        __m256 ocz = _mm256_sub_ps(oz, _mm256_loadu_ps(z + i));
+        __m256 r = _mm256_loadu_ps(radius + i);
+
+        __m256 b = _mm256_fmadd_ps(ocz, dz, _mm256_fmadd_ps(ocy, dy, _mm256_mul_ps(ocx, dx)));
+        __m256 lengthSq = _mm256_fmadd_ps(ocz, ocz, _mm256_fmadd_ps(ocy, ocy, _mm256_mul_ps(ocx, ocx)));
+        __m256 c = _mm256_fnmadd_ps(r, r, lengthSq);
+        __m256 discriminant = _mm256_fmsub_ps(b, b, c);
+        __m256 t = _mm256_sub_ps(_mm256_sub_ps(zero, b), _mm256_sqrt_ps(_mm256_max_ps(discriminant, zero)));
+
+        __m256 miss = _mm256_or_ps(_mm256_cmp_ps(discriminant, zero, _CMP_LT_OQ), _mm256_cmp_ps(t, zero, _CMP_LT_OQ));
+        __m256 distance = _mm256_blendv_ps(t, noHit, miss);
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_set1_ps(best), _CMP_LT_OQ));
+        if (bits) {
+            takeNearest8(distance, bits, i, layers, layerMask, best, bestIndex);
+        }
+    }
+
+    for (; i < end; i++) {
+        float ocx = ray[0] - x[i], ocy = ray[1] - y[i], ocz = ray[2] - z[i];
+        float b = ocx * ray[3] + ocy * ray[4] + ocz * ray[5];
+        float c = ocx * ocx + ocy * ocy + ocz * ocz - radius[i] * radius[i];
+        float discriminant = b * b - c;
+        if (discriminant < 0.0f) continue;
+        float t = -b - std::sqrt(discriminant);
+        if (t >= 0.0f && t < best && layerAcceptedAvx2(layers, layerMask, i)) {
+            best = t;
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex != NO_HIT) *hitDistance = best;
+    return bestIndex;
+}
+
+int raycastAABBsAvx2(const float* ray, float maxDistance,
+                     const float* minX, const float* minY, const float* minZ,
+                     const float* maxX, const float* maxY, const float* maxZ,
+                     const int* layers, int layerMask,
+                     int first, int count, float* hitDistance) {
+    float invDir[3] = { safeInverseAvx2(ray[3]), safeInverseAvx2(ray[4]), safeInverseAvx2(ray[5]) };
+
+    __m256 ox = _mm256_set1_ps(ray[0]), oy = _mm256_set1_ps(ray[1]), oz = _mm256_set1_ps(ray[2]);
+    __m256 ix = _mm256_set1_ps(invDir[0]), iy = _mm256_set1_ps(invDir[1]), iz = _mm256_set1_ps(invDir[2]);
+    __m256 noHit = _mm256_set1_ps(FLT_MAX);
+    __m256 zero = _mm256_setzero_ps();
+
+    float best = maxDistance;
+    int bestIndex = NO_HIT;
+    int end = first + count;
+    int i = first;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(minX + i), ox), ix);
+        __m256 t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(maxX + i), ox), ix);
+        __m256 t3 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(minY + i), oy), iy);
+        __m256 t4 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(maxY + i), oy), iy);
+        __m256 t5 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(minZ + i), oz), iz);
+        __m256 t6 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(maxZ + i), oz), iz);
+
+        __m256 tmin = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(t1, t2), _mm256_min_ps(t3, t4)), _mm256_min_ps(t5, t6));
+        __m256 tmax = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(t1, t2), _mm256_max_ps(t3, t4)), _mm256_max_ps(t5, t6));
+
+        __m256 miss = _mm256_or_ps(_mm256_cmp_ps(tmax, zero, _CMP_LT_OQ), _mm256_cmp_ps(tmin, tmax, _CMP_GT_OQ));
+        __m256 t = _mm256_blendv_ps(tmin, tmax, _mm256_cmp_ps(tmin, zero, _CMP_LT_OQ));
+        __m256 distance = _mm256_blendv_ps(t, noHit, miss);
+        int bits = _mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_set1_ps(best), _CMP_LT_OQ));
+        if (bits) {
+            takeNearest8(distance, bits, i, layers, layerMask, best, bestIndex);
+        }
+    }
+
+    for (; i < end; i++) {
+        float t1 = (minX[i] - ray[0]) * invDir[0], t2 = (maxX[i] - ray[0]) * invDir[0];
+        float t3 = (minY[i] - ray[1]) * invDir[1], t4 = (maxY[i] - ray[1]) * invDir[1];
+        float t5 = (minZ[i] - ray[2]) * invDir[2], t6 = (maxZ[i] - ray[2]) * invDir[2];
+        float tmin = std::fmax(std::fmax(std::fmin(t1, t2), std::fmin(t3, t4)), std::fmin(t5, t6));
+        float tmax = std::fmin(std::fmin(std::fmax(t1, t2), std::fmax(t3, t4)), std::fmax(t5, t6));
+        if (tmax < 0.0f || tmin > tmax) continue;
+        float t = tmin >= 0.0f ? tmin : tmax;
+        if (t < best && layerAcceptedAvx2(layers, layerMask, i)) {
+            best = t;
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex != NO_HIT) *hitDistance = best;
+    return bestIndex;
+}
+
+} // namespace qemath
@@ -487,46 +487,61 @@ class Frustum {
     fun extractPlanes(viewProjection: Matrix4) {
         val m = viewProjection
         
+        // Gribb-Hartmann da ax + by + cz + d >= 0; Plane usa dot(n, p) - distance
+        
         // Left
         planes[0] = Plane(
             Vector3(m[0, 3] + m[0, 0], m[1, 3] + m[1, 0], m[2, 3] + m[2, 0]),
-            m[3, 3] + m[3, 0]
+            -(m[3, 3] + m[3, 0])
         )
         
         // Right
         planes[1] = Plane(
             Vector3(m[0, 3] - m[0, 0], m[1, 3] - m[1, 0], m[2, 3] - m[2, 0]),
-            m[3, 3] - m[3, 0]
+            -(m[3, 3] - m[3, 0])
         )
         
         // Bottom
         planes[2] = Plane(
             Vector3(m[0, 3] + m[0, 1], m[1, 3] + m[1, 1], m[2, 3] + m[2, 1]),
-            m[3, 3] + m[3, 1]
+            -(m[3, 3] + m[3, 1])
         )
         
         // Top
         planes[3] = Plane(
             Vector3(m[0, 3] - m[0, 1], m[1, 3] - m[1, 1], m[2, 3] - m[2, 1]),
-            m[3, 3] - m[3, 1]
+            -(m[3, 3] - m[3, 1])
         )
         
         // Near
         planes[4] = Plane(
             Vector3(m[0, 3] + m[0, 2], m[1, 3] + m[1, 2], m[2, 3] + m[2, 2]),
-            m[3, 3] + m[3, 2]
+            -(m[3, 3] + m[3, 2])
         )
         
         // Far
         planes[5] = Plane(
             Vector3(m[0, 3] - m[0, 2], m[1, 3] - m[1, 2], m[2, 3] - m[2, 2]),
-            m[3, 3] - m[3, 2]
+            -(m[3, 3] - m[3, 2])
         )
         
         // Normalizar planos
         planes.forEach { it.normalize() }
     }
     
+    /**
+     * Copia los 6 planos como (nx, ny, nz, distance) para NativeMath/FrustumCuller
+     */
+    fun getPlanes(out: FloatArray) {
+        for (i in 0 until 6) {
+            val plane = planes[i]
+            out[i * 4] = plane.normal.x
+            out[i * 4 + 1] = plane.normal.y
+            out[i * 4 + 2] = plane.normal.z
+            out[i * 4 + 3] = plane.distance
+        }
+    }
+    
     /**
      * Comprueba si un punto está dentro del frustum
      */
@@ -0,0 +1,224 @@
+package com.quantum.engine.math
+
+import java.util.concurrent.Callable
+import java.util.concurrent.ExecutorService
+import java.util.concurrent.ForkJoinPool
+import java.util.concurrent.Future
+
+/**
+ * SphereBoundsArray - Esferas en SoA para culling por lotes
+ */
+class SphereBoundsArray(initialCapacity: Int = 1024) {
+
+    var x = FloatArray(initialCapacity)
+        private set
+    var y = FloatArray(initialCapacity)
+        private set
+    var z = FloatArray(initialCapacity)
+        private set
+    var radius = FloatArray(initialCapacity)
+        private set
+
+    var size = 0
+        private set
+
+    fun add(center: Vector3, radius: Float): Int {
+        ensureCapacity(size + 1)
+        set(size, center, radius)
+        return size++
+    }
+
+    fun add(sphere: Sphere): Int = add(sphere.center, sphere.radius)
+
+    fun set(index: Int, center: Vector3, radius: Float) {
+        x[index] = center.x
+        y[index] = center.y
+        z[index] = center.z
+        this.radius[index] = radius
+    }
+
+    fun clear() {
+        size = 0
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= x.size) return
+        val newCapacity = maxOf(capacity, x.size * 2)
+        x = x.copyOf(newCapacity)
+        y = y.copyOf(newCapacity)
+        z = z.copyOf(newCapacity)
+        radius = radius.copyOf(newCapacity)
+    }
+}
+
+/**
+ * AABBBoundsArray - AABBs en SoA (min/max por eje) para culling por lotes
+ */
+class AABBBoundsArray(initialCapacity: Int = 1024) {
+
+    var minX = FloatArray(initialCapacity)
+        private set
+    var minY = FloatArray(initialCapacity)
+        private set
+    var minZ = FloatArray(initialCapacity)
+        private set
+    var maxX = FloatArray(initialCapacity)
+        private set
+    var maxY = FloatArray(initialCapacity)
+        private set
+    var maxZ = FloatArray(initialCapacity)
+        private set
+
+    var size = 0
+        private set
+
+    fun add(aabb: AABB): Int {
+        ensureCapacity(size + 1)
+        set(size, aabb)
+        return size++
+    }
+
+    fun set(index: Int, aabb: AABB) {
+        minX[index] = aabb.min.x
+        minY[index] = aabb.min.y
+        minZ[index] = aabb.min.z
+        maxX[index] = aabb.max.x
+        maxY[index] = aabb.max.y
+        maxZ[index] = aabb.max.z
+    }
+
+    fun clear() {
+        size = 0
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= minX.size) return
+        val newCapacity = maxOf(capacity, minX.size * 2)
+        minX = minX.copyOf(newCapacity)
+        minY = minY.copyOf(newCapacity)
+        minZ = minZ.copyOf(newCapacity)
+        maxX = maxX.copyOf(newCapacity)
+        maxY = maxY.copyOf(newCapacity)
+        maxZ = maxZ.copyOf(newCapacity)
+    }
+}
+
+/**
+ * FrustumCuller - Frustum culling SIMD de bounds empaquetados
+ *
+ * Divide los objetos en chunks de chunkSize que se testean en paralelo con
+ * NativeMath (4 u 8 objetos por instrucción contra los 6 planos). Cada chunk
+ * escribe sus índices visibles en su propia zona de visible y al final se
+ * compactan en orden, así el resultado es el mismo que en un solo hilo.
+ */
+class FrustumCuller(
+    private val chunkSize: Int = DEFAULT_CHUNK_SIZE,
+    private val executor: ExecutorService = ForkJoinPool.commonPool()
+) {
+
+    private val planes = FloatArray(NativeMath.FRUSTUM_PLANE_COUNT * 4)
+    private var chunkCounts = IntArray(0)
+    private val pending = ArrayList<Future<Int>>()
+
+    /**
+     * Escribe en visible (tamaño >= spheres.size) los índices de las esferas
+     * visibles y devuelve cuántas son
+     */
+    fun cull(frustum: Frustum, spheres: SphereBoundsArray, visible: IntArray): Int {
+        frustum.getPlanes(planes)
+        return cullChunked(spheres.size, visible) { first, count ->
+            if (NativeMath.isAvailable) {
+                NativeMath.cullSpheres(
+                    planes, spheres.x, spheres.y, spheres.z, spheres.radius,
+                    first, count, visible, first
+                )
+            } else {
+                cullSpheresKotlin(frustum, spheres, first, count, visible)
+            }
+        }
+    }
+
+    /**
+     * Igual que cull() para AABBs
+     */
+    fun cull(frustum: Frustum, boxes: AABBBoundsArray, visible: IntArray): Int {
+        frustum.getPlanes(planes)
+        return cullChunked(boxes.size, visible) { first, count ->
+            if (NativeMath.isAvailable) {
+                NativeMath.cullAABBs(
+                    planes, boxes.minX, boxes.minY, boxes.minZ, boxes.maxX, boxes.maxY, boxes.maxZ,
+                    first, count, visible, first
+                )
+            } else {
+                cullAABBsKotlin(frustum, boxes, first, count, visible)
+            }
+        }
+    }
+
+    private inline fun cullChunked(count: Int, visible: IntArray, crossinline kernel: (Int, Int) -> Int): Int {
+        require(visible.size >= count) { "visible must hold $count indices" }
+
+        val chunks = (count + chunkSize - 1) / chunkSize
+        if (chunks <= 1) {
+            return kernel(0, count)
+        }
+
+        if (chunkCounts.size < chunks) {
+            chunkCounts = IntArray(chunks)
+        }
+
+        // El chunk 0 en el hilo llamador, el resto en el executor
+        pending.clear()
+        for (chunk in 1 until chunks) {
+            val first = chunk * chunkSize
+            val chunkCount = minOf(chunkSize, count - first)
+            pending.add(executor.submit(Callable { kernel(first, chunkCount) }))
+        }
+        chunkCounts[0] = kernel(0, minOf(chunkSize, count))
+        for (chunk in 1 until chunks) {
+            chunkCounts[chunk] = pending[chunk - 1].get()
+        }
+        pending.clear()
+
+        // Compactar: cada chunk escribió desde su primer índice
+        var total = chunkCounts[0]
+        for (chunk in 1 until chunks) {
+            val chunkVisible = chunkCounts[chunk]
+            if (chunkVisible > 0) {
+                System.arraycopy(visible, chunk * chunkSize, visible, total, chunkVisible)
+            }
+            total += chunkVisible
+        }
+        return total
+    }
+
+    private fun cullSpheresKotlin(frustum: Frustum, spheres: SphereBoundsArray, first: Int, count: Int, visible: IntArray): Int {
+        var written = 0
+        for (i in first until first + count) {
+            val sphere = Sphere(Vector3(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.radius[i])
+            if (frustum.intersectsSphere(sphere)) {
+                visible[first + written++] = i
+            }
+        }
+        return written
+    }
+
+    private fun cullAABBsKotlin(frustum: Frustum, boxes: AABBBoundsArray, first: Int, count: Int, visible: IntArray): Int {
+        var written = 0
+        for (i in first until first + count) {
+            val aabb = AABB(
+                min = Vector3(boxes.minX[i], boxes.minY[i], boxes.minZ[i]),
+                max = Vector3(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i])
+            )
+            if (frustum.intersectsAABB(aabb)) {
+                visible[first + written++] = i
+            }
+        }
+        return written
+    }
+
+    companion object {
+        // ~16k objetos por tarea: suficiente trabajo para amortizar el reparto
+        const val DEFAULT_CHUNK_SIZE = 16384
+    }
+}
@@ -0,0 +1,165 @@
+package com.quantum.engine.math
+
+import kotlin.random.Random
+
+/**
+ * MathBenchmark - Compara los kernels de NativeMath con las clases Kotlin
+ *
+ * Pensado para lanzarse desde una pantalla de debug o el profiler en el
+ * dispositivo: los datos se generan una vez y cada kernel se mide como la
+ * mediana de varias iteraciones tras un calentamiento.
+ */
+object MathBenchmark {
+
+    data class Result(
+        val name: String,
+        val count: Int,
+        val kotlinMs: Float,
+        val nativeMs: Float
+    ) {
+        val speedup: Float get() = if (nativeMs > 0f) kotlinMs / nativeMs else 0f
+
+        override fun toString(): String =
+            "%-18s n=%d  kotlin=%.3fms  native=%.3fms  x%.1f".format(name, count, kotlinMs, nativeMs, speedup)
+    }
+
+    fun run(count: Int = 10_000, iterations: Int = 20, seed: Int = 42): List<Result> {
+        if (!NativeMath.isAvailable) return emptyList()
+
+        val random = Random(seed)
+        fun next(scale: Float = 1f) = (random.nextFloat() * 2f - 1f) * scale
+
+        // Datos empaquetados para nativo
+        val trs = FloatArray(count * NativeMath.TRS_FLOATS)
+        val quatsA = FloatArray(count * NativeMath.QUATERNION_FLOATS)
+        val quatsB = FloatArray(count * NativeMath.QUATERNION_FLOATS)
+        val factors = FloatArray(count) { random.nextFloat() }
+        val points = FloatArray(count * NativeMath.VECTOR_FLOATS) { next(10f) }
+        val boxes = FloatArray(count * NativeMath.AABB_FLOATS)
+
+        for (i in 0 until count) {
+            val a = Quaternion(next(), next(), next(), next()).normalized
+            val b = Quaternion(next(), next(), next(), next()).normalized
+            val base = i * NativeMath.TRS_FLOATS
+            trs[base] = next(50f); trs[base + 1] = next(50f); trs[base + 2] = next(50f)
+            trs[base + 3] = a.x; trs[base + 4] = a.y; trs[base + 5] = a.z; trs[base + 6] = a.w
+            trs[base + 7] = 1f + random.nextFloat(); trs[base + 8] = 1f + random.nextFloat(); trs[base + 9] = 1f + random.nextFloat()
+
+            writeQuaternion(quatsA, i, a)
+            writeQuaternion(quatsB, i, b)
+
+            val boxBase = i * NativeMath.AABB_FLOATS
+            for (axis in 0..2) {
+                boxes[boxBase + axis] = -1f - random.nextFloat()
+                boxes[boxBase + 3 + axis] = 1f + random.nextFloat()
+            }
+        }
+
+        // Los mismos datos como objetos Kotlin
+        val positions = Array(count) { i -> readVector(trs, i * NativeMath.TRS_FLOATS) }
+        val rotations = Array(count) { i -> readQuaternion(quatsA, i) }
+        val targets = Array(count) { i -> readQuaternion(quatsB, i) }
+        val scales = Array(count) { i -> readVector(trs, i * NativeMath.TRS_FLOATS + 7) }
+        val vectors = Array(count) { i -> readVector(points, i * NativeMath.VECTOR_FLOATS) }
+        val aabbs = Array(count) { i ->
+            AABB(
+                min = readVector(boxes, i * NativeMath.AABB_FLOATS),
+                max = readVector(boxes, i * NativeMath.AABB_FLOATS + 3)
+            )
+        }
+
+        val matrices = FloatArray(count * NativeMath.MATRIX_FLOATS)
+        val products = FloatArray(count * NativeMath.MATRIX_FLOATS)
+        val quatOut = FloatArray(count * NativeMath.QUATERNION_FLOATS)
+        val pointOut = FloatArray(count * NativeMath.VECTOR_FLOATS)
+        val boxOut = FloatArray(count * NativeMath.AABB_FLOATS)
+        NativeMath.composeTRS(trs, matrices, 0, count)
+        val matrixObjects = Array(count) { i -> Matrix4(matrices.copyOfRange(i * 16, i * 16 + 16)) }
+        val viewProjection = Matrix4.perspective(60f, 16f / 9f, 0.1f, 1000f)
+        val viewProjectionArray = viewProjection.toArray()
+        val model = matrixObjects[0]
+        val modelArray = model.toArray()
+
+        val results = ArrayList<Result>()
+
+        results += measure("composeTRS", count, iterations,
+            kotlin = { for (i in 0 until count) Matrix4.trs(positions[i], rotations[i], scales[i]) },
+            native = { NativeMath.composeTRS(trs, matrices, 0, count) })
+
+        results += measure("mat4MulBatch", count, iterations,
+            kotlin = { for (i in 0 until count) matrixObjects[i] * matrixObjects[i] },
+            native = { NativeMath.mat4MulBatch(matrices, matrices, products, 0, count) })
+
+        results += measure("mat4PreMulBatch", count, iterations,
+            kotlin = { for (i in 0 until count) viewProjection * matrixObjects[i] },
+            native = { NativeMath.mat4PreMulBatch(viewProjectionArray, matrices, products, 0, count) })
+
+        results += measure("transformPoints", count, iterations,
+            kotlin = { for (i in 0 until count) model * vectors[i] },
+            native = { NativeMath.transformPoints(modelArray, points, pointOut, 0, count) })
+
+        results += measure("transformNormals", count, iterations,
+            kotlin = { for (i in 0 until count) model.transformDirection(vectors[i]).normalized },
+            native = { NativeMath.transformNormals(modelArray, points, pointOut, 0, count) })
+
+        results += measure("slerpBatch", count, iterations,
+            kotlin = { for (i in 0 until count) Quaternion.slerp(rotations[i], targets[i], factors[i]) },
+            native = { NativeMath.slerpBatch(quatsA, quatsB, factors, quatOut, 0, count) })
+
+        results += measure("transformAABBs", count, iterations,
+            kotlin = { for (i in 0 until count) transformAABB(aabbs[i], matrixObjects[i]) },
+            native = { NativeMath.transformAABBs(matrices, boxes, boxOut, 0, count) })
+
+        return results
+    }
+
+    private inline fun measure(
+        name: String,
+        count: Int,
+        iterations: Int,
+        kotlin: () -> Unit,
+        native: () -> Unit
+    ): Result {
+        return Result(name, count, median(iterations, kotlin), median(iterations, native))
+    }
+
+    private inline fun median(iterations: Int, block: () -> Unit): Float {
+        // Calentamiento (JIT / caches)
+        repeat(3) { block() }
+
+        val samples = FloatArray(iterations)
+        for (i in 0 until iterations) {
+            val start = System.nanoTime()
+            block()
+            samples[i] = (System.nanoTime() - start) / 1_000_000f
+        }
+        samples.sort()
+        return samples[iterations / 2]
+    }
+
+    // Referencia Kotlin: 8 esquinas transformadas
+    private fun transformAABB(aabb: AABB, matrix: Matrix4): AABB {
+        val corners = aabb.getCorners()
+        val result = AABB(min = matrix * corners[0], max = matrix * corners[0])
+        for (i in 1 until corners.size) {
+            result.encapsulate(matrix * corners[i])
+        }
+        return result
+    }
+
+    private fun writeQuaternion(array: FloatArray, index: Int, q: Quaternion) {
+        val base = index * NativeMath.QUATERNION_FLOATS
+        array[base] = q.x
+        array[base + 1] = q.y
+        array[base + 2] = q.z
+        array[base + 3] = q.w
+    }
+
+    private fun readQuaternion(array: FloatArray, index: Int): Quaternion {
+        val base = index * NativeMath.QUATERNION_FLOATS
+        return Quaternion(array[base], array[base + 1], array[base + 2], array[base + 3])
+    }
+
+    private fun readVector(array: FloatArray, base: Int): Vector3 =
+        Vector3(array[base], array[base + 1], array[base + 2])
+}
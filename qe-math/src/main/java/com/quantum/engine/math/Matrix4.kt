@@ -46,6 +46,19 @@ class Matrix4 {
         return this
     }
     
+    /**
+     * Copia 16 valores column-major desde un array plano (p. ej. salida de NativeMath)
+     */
+    fun set(values: FloatArray, offset: Int = 0): Matrix4 {
+        var index = offset
+        for (i in 0..3) {
+            for (j in 0..3) {
+                m[i][j] = values[index++]
+            }
+        }
+        return this
+    }
+    
     /**
      * Establece como matriz cero
      */
@@ -291,14 +304,20 @@ class Matrix4 {
      * Convierte a array (column-major)
      */
     fun toArray(): FloatArray {
-        val array = FloatArray(16)
-        var index = 0
+        return toArray(FloatArray(16))
+    }
+    
+    /**
+     * Escribe en out a partir de offset (column-major) sin reservar memoria
+     */
+    fun toArray(out: FloatArray, offset: Int = 0): FloatArray {
+        var index = offset
         for (i in 0..3) {
             for (j in 0..3) {
-                array[index++] = m[i][j]
+                out[index++] = m[i][j]
             }
         }
-        return array
+        return out
     }
     
     override fun toString(): String {
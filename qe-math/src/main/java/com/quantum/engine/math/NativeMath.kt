@@ -0,0 +1,373 @@
+package com.quantum.engine.math
+
+/**
+ * NativeMath - Kernels matemáticos por lotes en nativo
+ *
+ * Procesa arrays planos completos con una sola llamada JNI (NEON en ARM,
+ * SSE/AVX2 en x86_64). Formatos:
+ * - Matrices: 16 floats column-major (igual que Matrix4.toArray())
+ * - Puntos/normales: 3 floats (x, y, z)
+ * - Quaternions: 4 floats (x, y, z, w)
+ * - AABBs: 6 floats (min xyz, max xyz)
+ * - TRS: 10 floats (posición xyz, rotación xyzw, escala xyz)
+ * - Rayos: 6 floats (origen xyz, dirección xyz normalizada)
+ *
+ * offset y count se expresan en elementos, no en floats. La salida puede ser
+ * el mismo array que la entrada.
+ */
+object NativeMath {
+
+    const val MATRIX_FLOATS = 16
+    const val VECTOR_FLOATS = 3
+    const val QUATERNION_FLOATS = 4
+    const val AABB_FLOATS = 6
+    const val TRS_FLOATS = 10
+    const val FRUSTUM_PLANE_COUNT = 6
+    const val RAY_FLOATS = 6
+    const val NO_HIT = -1
+
+    /**
+     * false si la librería nativa no está disponible (p. ej. tests en JVM);
+     * los llamadores deben usar su camino Kotlin en ese caso
+     */
+    val isAvailable: Boolean = try {
+        System.loadLibrary("quantum_math")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        false
+    }
+
+    /**
+     * Backend SIMD activo: "NEON", "SSE", "AVX2" o "Scalar"
+     */
+    val backend: String by lazy {
+        if (isAvailable) nativeGetBackend() else "Kotlin"
+    }
+
+    // ========== Matrices ==========
+
+    /**
+     * out[i] = a[i] * b[i]
+     */
+    fun mat4MulBatch(a: FloatArray, b: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(a, offset, count, MATRIX_FLOATS)
+        checkRange(b, offset, count, MATRIX_FLOATS)
+        checkRange(out, offset, count, MATRIX_FLOATS)
+        if (count > 0) nativeMat4MulBatch(a, b, out, offset, count)
+    }
+
+    /**
+     * out[i] = left * b[i] (p. ej. viewProjection * model)
+     */
+    fun mat4PreMulBatch(left: FloatArray, b: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(left, 0, 1, MATRIX_FLOATS)
+        checkRange(b, offset, count, MATRIX_FLOATS)
+        checkRange(out, offset, count, MATRIX_FLOATS)
+        if (count > 0) nativeMat4PreMulBatch(left, b, out, offset, count)
+    }
+
+    /**
+     * Matrices T * R * S desde TRS empaquetados, igual que Matrix4.trs()
+     */
+    fun composeTRS(trs: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(trs, offset, count, TRS_FLOATS)
+        checkRange(out, offset, count, MATRIX_FLOATS)
+        if (count > 0) nativeComposeTRS(trs, out, offset, count)
+    }
+
+    /**
+     * Igual que composeTRS() con posiciones (3), rotaciones (4) y escalas (3)
+     * en arrays separados
+     */
+    fun composeTRS(
+        positions: FloatArray,
+        rotations: FloatArray,
+        scales: FloatArray,
+        out: FloatArray,
+        offset: Int = 0,
+        count: Int
+    ) {
+        checkRange(positions, offset, count, VECTOR_FLOATS)
+        checkRange(rotations, offset, count, QUATERNION_FLOATS)
+        checkRange(scales, offset, count, VECTOR_FLOATS)
+        checkRange(out, offset, count, MATRIX_FLOATS)
+        if (count > 0) nativeComposeTRSSplit(positions, rotations, scales, out, offset, count)
+    }
+
+    // ========== Puntos y normales ==========
+
+    /**
+     * Transforma puntos por una matriz afín (sin división perspectiva)
+     */
+    fun transformPoints(matrix: FloatArray, points: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(matrix, 0, 1, MATRIX_FLOATS)
+        checkRange(points, offset, count, VECTOR_FLOATS)
+        checkRange(out, offset, count, VECTOR_FLOATS)
+        if (count > 0) nativeTransformPoints(matrix, points, out, offset, count)
+    }
+
+    /**
+     * Transforma direcciones con la parte 3x3 (para normales con escala no
+     * uniforme, pasar la inversa transpuesta)
+     */
+    fun transformNormals(
+        matrix: FloatArray,
+        normals: FloatArray,
+        out: FloatArray,
+        offset: Int = 0,
+        count: Int,
+        normalize: Boolean = true
+    ) {
+        checkRange(matrix, 0, 1, MATRIX_FLOATS)
+        checkRange(normals, offset, count, VECTOR_FLOATS)
+        checkRange(out, offset, count, VECTOR_FLOATS)
+        if (count > 0) nativeTransformNormals(matrix, normals, out, offset, count, normalize)
+    }
+
+    // ========== Quaternions ==========
+
+    /**
+     * out[i] = Quaternion.slerp(a[i], b[i], t[i])
+     */
+    fun slerpBatch(a: FloatArray, b: FloatArray, t: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(a, offset, count, QUATERNION_FLOATS)
+        checkRange(b, offset, count, QUATERNION_FLOATS)
+        checkRange(t, offset, count, 1)
+        checkRange(out, offset, count, QUATERNION_FLOATS)
+        if (count > 0) nativeSlerpBatch(a, b, t, out, offset, count)
+    }
+
+    // ========== Bounding Volumes ==========
+
+    /**
+     * AABB local de cada objeto transformado por su matriz world
+     */
+    fun transformAABBs(matrices: FloatArray, boxes: FloatArray, out: FloatArray, offset: Int = 0, count: Int) {
+        checkRange(matrices, offset, count, MATRIX_FLOATS)
+        checkRange(boxes, offset, count, AABB_FLOATS)
+        checkRange(out, offset, count, AABB_FLOATS)
+        if (count > 0) nativeTransformAABBs(matrices, boxes, out, offset, count)
+    }
+
+    // ========== Culling ==========
+
+    /**
+     * Esferas SoA [first, first + count) contra 6 planos (nx, ny, nz, distance).
+     * Escribe los índices visibles en visible desde visibleOffset y devuelve cuántos.
+     */
+    fun cullSpheres(
+        planes: FloatArray,
+        x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        first: Int, count: Int,
+        visible: IntArray, visibleOffset: Int = 0
+    ): Int {
+        checkRange(planes, 0, FRUSTUM_PLANE_COUNT, 4)
+        checkRange(x, first, count, 1)
+        checkRange(y, first, count, 1)
+        checkRange(z, first, count, 1)
+        checkRange(radius, first, count, 1)
+        require(visibleOffset >= 0 && visibleOffset + count <= visible.size) { "visible too small" }
+        return if (count > 0) nativeCullSpheres(planes, x, y, z, radius, first, count, visible, visibleOffset) else 0
+    }
+
+    /**
+     * Igual que cullSpheres() con AABBs SoA (min/max por eje)
+     */
+    fun cullAABBs(
+        planes: FloatArray,
+        minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        first: Int, count: Int,
+        visible: IntArray, visibleOffset: Int = 0
+    ): Int {
+        checkRange(planes, 0, FRUSTUM_PLANE_COUNT, 4)
+        checkRange(minX, first, count, 1)
+        checkRange(minY, first, count, 1)
+        checkRange(minZ, first, count, 1)
+        checkRange(maxX, first, count, 1)
+        checkRange(maxY, first, count, 1)
+        checkRange(maxZ, first, count, 1)
+        require(visibleOffset >= 0 && visibleOffset + count <= visible.size) { "visible too small" }
+        return if (count > 0) {
+            nativeCullAABBs(planes, minX, minY, minZ, maxX, maxY, maxZ, first, count, visible, visibleOffset)
+        } else {
+            0
+        }
+    }
+
+    // ========== Raycasts ==========
+
+    /**
+     * Un rayo contra las esferas SoA [first, first + count). Devuelve el índice
+     * de la más cercana con distancia < maxDistance (o NO_HIT) y escribe la
+     * distancia en hitDistance[0]. Misma semántica que Ray.intersectSphere().
+     * layers: capa de cada objeto (null = sin filtrar)
+     */
+    fun raycastSpheres(
+        ray: FloatArray, maxDistance: Float,
+        x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        first: Int, count: Int, hitDistance: FloatArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ): Int {
+        checkRange(ray, 0, 1, RAY_FLOATS)
+        checkRange(x, first, count, 1)
+        checkRange(y, first, count, 1)
+        checkRange(z, first, count, 1)
+        checkRange(radius, first, count, 1)
+        checkRange(hitDistance, 0, 1, 1)
+        if (layers != null) checkRange(layers, first, count, 1)
+        return if (count > 0) {
+            nativeRaycastSpheres(ray, maxDistance, hitDistance, x, y, z, radius, layers, layerMask, first, count)
+        } else {
+            NO_HIT
+        }
+    }
+
+    /**
+     * Igual que raycastSpheres() con AABBs SoA (slabs, como Ray.intersectAABB())
+     */
+    fun raycastAABBs(
+        ray: FloatArray, maxDistance: Float,
+        minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        first: Int, count: Int, hitDistance: FloatArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ): Int {
+        checkRange(ray, 0, 1, RAY_FLOATS)
+        checkRange(minX, first, count, 1)
+        checkRange(minY, first, count, 1)
+        checkRange(minZ, first, count, 1)
+        checkRange(maxX, first, count, 1)
+        checkRange(maxY, first, count, 1)
+        checkRange(maxZ, first, count, 1)
+        checkRange(hitDistance, 0, 1, 1)
+        if (layers != null) checkRange(layers, first, count, 1)
+        return if (count > 0) {
+            nativeRaycastAABBs(ray, maxDistance, hitDistance, minX, minY, minZ, maxX, maxY, maxZ, layers, layerMask, first, count)
+        } else {
+            NO_HIT
+        }
+    }
+
+    /**
+     * Paquete de rayos [rayOffset, rayOffset + rayCount) contra las esferas
+     * [first, first + count), 4 rayos por instrucción. Por rayo escribe el
+     * índice más cercano (o NO_HIT) en hitIndices y su distancia en hitDistances.
+     */
+    fun raycastPacketSpheres(
+        rays: FloatArray, maxDistances: FloatArray, rayOffset: Int = 0, rayCount: Int,
+        x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        first: Int, count: Int,
+        hitIndices: IntArray, hitDistances: FloatArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ) {
+        checkRange(rays, rayOffset, rayCount, RAY_FLOATS)
+        checkRange(maxDistances, rayOffset, rayCount, 1)
+        checkRange(hitIndices, rayOffset, rayCount, 1)
+        checkRange(hitDistances, rayOffset, rayCount, 1)
+        checkRange(x, first, count, 1)
+        checkRange(y, first, count, 1)
+        checkRange(z, first, count, 1)
+        checkRange(radius, first, count, 1)
+        if (layers != null) checkRange(layers, first, count, 1)
+        if (rayCount > 0) {
+            nativeRaycastPacketSpheres(
+                rays, maxDistances, rayOffset, rayCount, x, y, z, radius,
+                layers, layerMask, first, count, hitIndices, hitDistances
+            )
+        }
+    }
+
+    /**
+     * Igual que raycastPacketSpheres() con AABBs SoA
+     */
+    fun raycastPacketAABBs(
+        rays: FloatArray, maxDistances: FloatArray, rayOffset: Int = 0, rayCount: Int,
+        minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        first: Int, count: Int,
+        hitIndices: IntArray, hitDistances: FloatArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ) {
+        checkRange(rays, rayOffset, rayCount, RAY_FLOATS)
+        checkRange(maxDistances, rayOffset, rayCount, 1)
+        checkRange(hitIndices, rayOffset, rayCount, 1)
+        checkRange(hitDistances, rayOffset, rayCount, 1)
+        checkRange(minX, first, count, 1)
+        checkRange(minY, first, count, 1)
+        checkRange(minZ, first, count, 1)
+        checkRange(maxX, first, count, 1)
+        checkRange(maxY, first, count, 1)
+        checkRange(maxZ, first, count, 1)
+        if (layers != null) checkRange(layers, first, count, 1)
+        if (rayCount > 0) {
+            nativeRaycastPacketAABBs(
+                rays, maxDistances, rayOffset, rayCount, minX, minY, minZ, maxX, maxY, maxZ,
+                layers, layerMask, first, count, hitIndices, hitDistances
+            )
+        }
+    }
+
+    // ========== Helpers ==========
+
+    private fun checkRange(array: FloatArray, offset: Int, count: Int, stride: Int) {
+        require(offset >= 0 && count >= 0 && (offset + count) * stride <= array.size) {
+            "Range [$offset, ${offset + count}) x $stride out of bounds for array of ${array.size}"
+        }
+    }
+
+    private fun checkRange(array: IntArray, offset: Int, count: Int, stride: Int) {
+        require(offset >= 0 && count >= 0 && (offset + count) * stride <= array.size) {
+            "Range [$offset, ${offset + count}) x $stride out of bounds for array of ${array.size}"
+        }
+    }
+
+    // ========== JNI Native Methods ==========
+
+    private external fun nativeMat4MulBatch(a: FloatArray, b: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeMat4PreMulBatch(left: FloatArray, b: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeComposeTRS(trs: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeComposeTRSSplit(
+        positions: FloatArray, rotations: FloatArray, scales: FloatArray, out: FloatArray, offset: Int, count: Int
+    )
+    private external fun nativeTransformPoints(matrix: FloatArray, points: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeTransformNormals(
+        matrix: FloatArray, normals: FloatArray, out: FloatArray, offset: Int, count: Int, normalize: Boolean
+    )
+    private external fun nativeSlerpBatch(a: FloatArray, b: FloatArray, t: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeTransformAABBs(matrices: FloatArray, boxes: FloatArray, out: FloatArray, offset: Int, count: Int)
+    private external fun nativeCullSpheres(
+        planes: FloatArray, x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        first: Int, count: Int, visible: IntArray, visibleOffset: Int
+    ): Int
+    private external fun nativeCullAABBs(
+        planes: FloatArray, minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        first: Int, count: Int, visible: IntArray, visibleOffset: Int
+    ): Int
+    private external fun nativeRaycastSpheres(
+        ray: FloatArray, maxDistance: Float, hitDistance: FloatArray,
+        x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        layers: IntArray?, layerMask: Int, first: Int, count: Int
+    ): Int
+    private external fun nativeRaycastAABBs(
+        ray: FloatArray, maxDistance: Float, hitDistance: FloatArray,
+        minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        layers: IntArray?, layerMask: Int, first: Int, count: Int
+    ): Int
+    private external fun nativeRaycastPacketSpheres(
+        rays: FloatArray, maxDistances: FloatArray, rayOffset: Int, rayCount: Int,
+        x: FloatArray, y: FloatArray, z: FloatArray, radius: FloatArray,
+        layers: IntArray?, layerMask: Int, first: Int, count: Int,
+        hitIndices: IntArray, hitDistances: FloatArray
+    )
+    private external fun nativeRaycastPacketAABBs(
+        rays: FloatArray, maxDistances: FloatArray, rayOffset: Int, rayCount: Int,
+        minX: FloatArray, minY: FloatArray, minZ: FloatArray,
+        maxX: FloatArray, maxY: FloatArray, maxZ: FloatArray,
+        layers: IntArray?, layerMask: Int, first: Int, count: Int,
+        hitIndices: IntArray, hitDistances: FloatArray
+    )
+    private external fun nativeGetBackend(): String
+}
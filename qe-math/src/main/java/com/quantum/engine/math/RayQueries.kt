@@ -0,0 +1,239 @@
+package com.quantum.engine.math
+
+import kotlin.math.abs
+import kotlin.math.sqrt
+
+/**
+ * RayPacket - Lote de rayos empaquetados (6 floats por rayo) con sus resultados
+ *
+ * Tras RayCaster.cast(), hitIndices[i] es el índice del objeto más cercano
+ * del rayo i (o NativeMath.NO_HIT) y hitDistances[i] su distancia.
+ */
+class RayPacket(initialCapacity: Int = 256) {
+
+    var rays = FloatArray(initialCapacity * NativeMath.RAY_FLOATS)
+        private set
+    var maxDistances = FloatArray(initialCapacity)
+        private set
+    var hitIndices = IntArray(initialCapacity)
+        private set
+    var hitDistances = FloatArray(initialCapacity)
+        private set
+
+    var size = 0
+        private set
+
+    /**
+     * Añade un rayo (la dirección se normaliza) y devuelve su índice
+     */
+    fun add(origin: Vector3, direction: Vector3, maxDistance: Float = Float.MAX_VALUE): Int {
+        ensureCapacity(size + 1)
+        val base = size * NativeMath.RAY_FLOATS
+        val length = direction.magnitude
+        val inverseLength = if (length > MathUtils.EPSILON) 1f / length else 0f
+        rays[base] = origin.x
+        rays[base + 1] = origin.y
+        rays[base + 2] = origin.z
+        rays[base + 3] = direction.x * inverseLength
+        rays[base + 4] = direction.y * inverseLength
+        rays[base + 5] = direction.z * inverseLength
+        maxDistances[size] = maxDistance
+        hitIndices[size] = NativeMath.NO_HIT
+        return size++
+    }
+
+    fun add(ray: Ray, maxDistance: Float = Float.MAX_VALUE): Int = add(ray.origin, ray.direction, maxDistance)
+
+    fun hasHit(index: Int): Boolean = hitIndices[index] != NativeMath.NO_HIT
+
+    fun clear() {
+        size = 0
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= maxDistances.size) return
+        val newCapacity = maxOf(capacity, maxDistances.size * 2)
+        rays = rays.copyOf(newCapacity * NativeMath.RAY_FLOATS)
+        maxDistances = maxDistances.copyOf(newCapacity)
+        hitIndices = hitIndices.copyOf(newCapacity)
+        hitDistances = hitDistances.copyOf(newCapacity)
+    }
+}
+
+/**
+ * RayCaster - Raycasts por lotes contra SphereBoundsArray / AABBBoundsArray
+ *
+ * nearest() lanza un rayo contra todos los objetos (4-8 por instrucción) y
+ * cast() un paquete de rayos (4 rayos por instrucción). Misma semántica que
+ * Ray.intersectSphere() / Ray.intersectAABB(); layers (opcional) es la capa
+ * de cada objeto, filtrada con layerMask.
+ *
+ * Guarda estado del último resultado: usar una instancia por hilo.
+ */
+class RayCaster {
+
+    private val ray = FloatArray(NativeMath.RAY_FLOATS)
+    private val hit = FloatArray(1)
+
+    /**
+     * Distancia del último impacto de nearest()
+     */
+    var hitDistance = 0f
+        private set
+
+    /**
+     * Índice de la esfera más cercana con distancia < maxDistance, o NativeMath.NO_HIT
+     */
+    fun nearest(
+        origin: Vector3, direction: Vector3, maxDistance: Float,
+        spheres: SphereBoundsArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ): Int {
+        setRay(origin, direction)
+        val index = if (NativeMath.isAvailable) {
+            NativeMath.raycastSpheres(
+                ray, maxDistance, spheres.x, spheres.y, spheres.z, spheres.radius,
+                0, spheres.size, hit, layers, layerMask
+            )
+        } else {
+            nearestSphereKotlin(maxDistance, spheres, layers, layerMask)
+        }
+        if (index != NativeMath.NO_HIT) hitDistance = hit[0]
+        return index
+    }
+
+    /**
+     * Igual que nearest() para AABBs
+     */
+    fun nearest(
+        origin: Vector3, direction: Vector3, maxDistance: Float,
+        boxes: AABBBoundsArray,
+        layers: IntArray? = null, layerMask: Int = -1
+    ): Int {
+        setRay(origin, direction)
+        val index = if (NativeMath.isAvailable) {
+            NativeMath.raycastAABBs(
+                ray, maxDistance, boxes.minX, boxes.minY, boxes.minZ, boxes.maxX, boxes.maxY, boxes.maxZ,
+                0, boxes.size, hit, layers, layerMask
+            )
+        } else {
+            nearestAABBKotlin(maxDistance, boxes, layers, layerMask)
+        }
+        if (index != NativeMath.NO_HIT) hitDistance = hit[0]
+        return index
+    }
+
+    /**
+     * Lanza todos los rayos del paquete contra las esferas
+     */
+    fun cast(packet: RayPacket, spheres: SphereBoundsArray, layers: IntArray? = null, layerMask: Int = -1) {
+        if (NativeMath.isAvailable) {
+            NativeMath.raycastPacketSpheres(
+                packet.rays, packet.maxDistances, 0, packet.size,
+                spheres.x, spheres.y, spheres.z, spheres.radius, 0, spheres.size,
+                packet.hitIndices, packet.hitDistances, layers, layerMask
+            )
+            return
+        }
+        for (i in 0 until packet.size) {
+            System.arraycopy(packet.rays, i * NativeMath.RAY_FLOATS, ray, 0, NativeMath.RAY_FLOATS)
+            packet.hitIndices[i] = nearestSphereKotlin(packet.maxDistances[i], spheres, layers, layerMask)
+            packet.hitDistances[i] = hit[0]
+        }
+    }
+
+    /**
+     * Lanza todos los rayos del paquete contra las AABBs
+     */
+    fun cast(packet: RayPacket, boxes: AABBBoundsArray, layers: IntArray? = null, layerMask: Int = -1) {
+        if (NativeMath.isAvailable) {
+            NativeMath.raycastPacketAABBs(
+                packet.rays, packet.maxDistances, 0, packet.size,
+                boxes.minX, boxes.minY, boxes.minZ, boxes.maxX, boxes.maxY, boxes.maxZ, 0, boxes.size,
+                packet.hitIndices, packet.hitDistances, layers, layerMask
+            )
+            return
+        }
+        for (i in 0 until packet.size) {
+            System.arraycopy(packet.rays, i * NativeMath.RAY_FLOATS, ray, 0, NativeMath.RAY_FLOATS)
+            packet.hitIndices[i] = nearestAABBKotlin(packet.maxDistances[i], boxes, layers, layerMask)
+            packet.hitDistances[i] = hit[0]
+        }
+    }
+
+    private fun setRay(origin: Vector3, direction: Vector3) {
+        val length = direction.magnitude
+        val inverseLength = if (length > MathUtils.EPSILON) 1f / length else 0f
+        ray[0] = origin.x
+        ray[1] = origin.y
+        ray[2] = origin.z
+        ray[3] = direction.x * inverseLength
+        ray[4] = direction.y * inverseLength
+        ray[5] = direction.z * inverseLength
+    }
+
+    // ========== Fallback Kotlin (sin librería nativa) ==========
+
+    private fun accepts(layers: IntArray?, layerMask: Int, index: Int): Boolean =
+        layers == null || (layerMask ushr layers[index]) and 1 != 0
+
+    private fun nearestSphereKotlin(maxDistance: Float, spheres: SphereBoundsArray, layers: IntArray?, layerMask: Int): Int {
+        var best = maxDistance
+        var bestIndex = NativeMath.NO_HIT
+        for (i in 0 until spheres.size) {
+            if (!accepts(layers, layerMask, i)) continue
+            val ocx = ray[0] - spheres.x[i]
+            val ocy = ray[1] - spheres.y[i]
+            val ocz = ray[2] - spheres.z[i]
+            val b = ocx * ray[3] + ocy * ray[4] + ocz * ray[5]
+            val c = ocx * ocx + ocy * ocy + ocz * ocz - spheres.radius[i] * spheres.radius[i]
+            val discriminant = b * b - c
+            if (discriminant < 0f) continue
+            val t = -b - sqrt(discriminant)
+            if (t >= 0f && t < best) {
+                best = t
+                bestIndex = i
+            }
+        }
+        hit[0] = best
+        return bestIndex
+    }
+
+    private fun nearestAABBKotlin(maxDistance: Float, boxes: AABBBoundsArray, layers: IntArray?, layerMask: Int): Int {
+        val invX = safeInverse(ray[3])
+        val invY = safeInverse(ray[4])
+        val invZ = safeInverse(ray[5])
+        var best = maxDistance
+        var bestIndex = NativeMath.NO_HIT
+        for (i in 0 until boxes.size) {
+            if (!accepts(layers, layerMask, i)) continue
+            val t1 = (boxes.minX[i] - ray[0]) * invX
+            val t2 = (boxes.maxX[i] - ray[0]) * invX
+            val t3 = (boxes.minY[i] - ray[1]) * invY
+            val t4 = (boxes.maxY[i] - ray[1]) * invY
+            val t5 = (boxes.minZ[i] - ray[2]) * invZ
+            val t6 = (boxes.maxZ[i] - ray[2]) * invZ
+            val tmin = maxOf(minOf(t1, t2), minOf(t3, t4), minOf(t5, t6))
+            val tmax = minOf(maxOf(t1, t2), maxOf(t3, t4), maxOf(t5, t6))
+            if (tmax < 0f || tmin > tmax) continue
+            val t = if (tmin >= 0f) tmin else tmax
+            if (t < best) {
+                best = t
+                bestIndex = i
+            }
+        }
+        hit[0] = best
+        return bestIndex
+    }
+
+    private fun safeInverse(d: Float): Float = when {
+        abs(d) > RAY_EPSILON -> 1f / d
+        d >= 0f -> 1f / RAY_EPSILON
+        else -> -1f / RAY_EPSILON
+    }
+
+    companion object {
+        // Igual que ray_kernels.cpp
+        private const val RAY_EPSILON = 1e-8f
+    }
+}
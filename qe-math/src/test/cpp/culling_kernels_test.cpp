@@ -0,0 +1,183 @@
+// culling_kernels_test.cpp - Frustum culling por lotes contra el criterio de Frustum
+#include "culling_kernels.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace qemath;
+
+namespace {
+
+enum Expected : uint8_t { HIDDEN = 0, VISIBLE = 1, EITHER = 2 };
+
+/** Generador fijo: los fallos se reproducen */
+struct Random {
+    uint32_t state = 777u;
+
+    float next(float lo, float hi) {
+        state = state * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+    }
+};
+
+/**
+ * Frustum de perspectiva mirando a -z (fov 90°, de 1 a 50) con la
+ * convención de Plane: dot(n, p) - distance >= 0 dentro
+ */
+void perspectivePlanes(float* planes) {
+    const float s = std::sqrt(0.5f);
+    const float values[FRUSTUM_PLANE_COUNT * 4] = {
+        s, 0.0f, -s, 0.0f,          // izquierda: x >= z
+        -s, 0.0f, -s, 0.0f,         // derecha
+        0.0f, s, -s, 0.0f,          // abajo
+        0.0f, -s, -s, 0.0f,         // arriba
+        0.0f, 0.0f, -1.0f, 1.0f,    // cerca: z <= -1
+        0.0f, 0.0f, 1.0f, -50.0f    // lejos: z >= -50
+    };
+    for (int i = 0; i < FRUSTUM_PLANE_COUNT * 4; i++) planes[i] = values[i];
+}
+
+/** Distancia menos el radio proyectado en cada plano; cerca de 0 vale cualquier respuesta */
+Expected classify(const float* planes, const float* center, const float* extents, float radius) {
+    Expected result = VISIBLE;
+    for (int p = 0; p < FRUSTUM_PLANE_COUNT; p++) {
+        const float* plane = planes + p * 4;
+        const float r = radius + std::fabs(extents[0] * plane[0]) + std::fabs(extents[1] * plane[1]) +
+                        std::fabs(extents[2] * plane[2]);
+        const float margin = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] - plane[3] + r;
+        if (margin < -1e-3f) return HIDDEN;
+        if (margin < 1e-3f) result = EITHER;
+    }
+    return result;
+}
+
+/** visible: índices en orden, dentro del rango, y los que el criterio fija */
+void checkVisible(const std::vector<int>& visible, int written, const std::vector<Expected>& expected,
+                  int first, int count) {
+    CHECK(written >= 0 && written <= count);
+    std::vector<uint8_t> seen(expected.size(), 0);
+    for (int i = 0; i < written; i++) {
+        CHECK(visible[i] >= first && visible[i] < first + count);
+        if (i > 0) CHECK(visible[i] > visible[i - 1]);
+        seen[visible[i]] = 1;
+    }
+    for (int i = first; i < first + count; i++) {
+        if (expected[i] != EITHER) CHECK(seen[i] == expected[i]);
+    }
+}
+
+/** Esferas y cajas por dentro, por fuera y cortando los planos */
+struct Scene {
+    std::vector<float> x, y, z, radius;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    std::vector<Expected> spheres, boxes;
+
+    Scene(const float* planes, int count) {
+        Random random;
+        for (int i = 0; i < count; i++) {
+            const float center[3] = { random.next(-60.0f, 60.0f), random.next(-60.0f, 60.0f),
+                                      random.next(-70.0f, 10.0f) };
+            const float r = random.next(0.1f, 8.0f);
+            const float extents[3] = { random.next(0.1f, 8.0f), random.next(0.1f, 8.0f), random.next(0.1f, 8.0f) };
+            const float none[3] = { 0.0f, 0.0f, 0.0f };
+            x.push_back(center[0]);
+            y.push_back(center[1]);
+            z.push_back(center[2]);
+            radius.push_back(r);
+            minX.push_back(center[0] - extents[0]);
+            minY.push_back(center[1] - extents[1]);
+            minZ.push_back(center[2] - extents[2]);
+            maxX.push_back(center[0] + extents[0]);
+            maxY.push_back(center[1] + extents[1]);
+            maxZ.push_back(center[2] + extents[2]);
+            spheres.push_back(classify(planes, center, none, r));
+            boxes.push_back(classify(planes, center, extents, 0.0f));
+        }
+    }
+
+    int cullSpheres(const float* planes, int first, int count, int* visible) const {
+        return qemath::cullSpheres(planes, x.data(), y.data(), z.data(), radius.data(), first, count, visible);
+    }
+
+    int cullAABBs(const float* planes, int first, int count, int* visible) const {
+        return qemath::cullAABBs(planes, minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(),
+                                 maxZ.data(), first, count, visible);
+    }
+};
+
+} // namespace
+
+TEST(visibleListsMatchTheFrustumCriterion) {
+    float planes[FRUSTUM_PLANE_COUNT * 4];
+    perspectivePlanes(planes);
+    const Scene scene(planes, 1000);
+
+    int visibleSpheres = 0;
+    for (Expected expected : scene.spheres) visibleSpheres += expected == VISIBLE ? 1 : 0;
+    CHECK(visibleSpheres > 50 && visibleSpheres < 950);
+
+    // Rangos con inicio y tamaño sin alinear: restos de 4 y de 8
+    const int ranges[][2] = { { 0, 1000 }, { 3, 997 }, { 1, 7 }, { 17, 13 }, { 999, 1 }, { 500, 0 } };
+    for (const auto& range : ranges) {
+        const int first = range[0];
+        const int count = range[1];
+        // Justo count casillas y un centinela: nunca escribe de más
+        std::vector<int> visible(count + 1, -7);
+        int written = scene.cullSpheres(planes, first, count, visible.data());
+        checkVisible(visible, written, scene.spheres, first, count);
+        CHECK(visible[count] == -7);
+
+        std::fill(visible.begin(), visible.end(), -7);
+        written = scene.cullAABBs(planes, first, count, visible.data());
+        checkVisible(visible, written, scene.boxes, first, count);
+        CHECK(visible[count] == -7);
+    }
+}
+
+TEST(containingAndSeparatedObjectsAreExact) {
+    float planes[FRUSTUM_PLANE_COUNT * 4];
+    perspectivePlanes(planes);
+    // 0: dentro; 1: envuelve todo el frustum; 2: detrás de la cámara;
+    // 3: más allá del lejano; 4: fuera por la derecha; 5 a 7 dentro, para
+    // llenar 8 lanes
+    const float x[] = { 0.0f, 0.0f, 0.0f, 0.0f, 30.0f, 0.0f, 0.0f, 0.0f };
+    const float y[] = { 0.0f, 0.0f, 0.0f, 0.0f, 30.0f, 0.0f, 0.0f, 0.0f };
+    const float z[] = { -10.0f, -20.0f, 5.0f, -60.0f, -20.0f, -10.0f, -10.0f, -10.0f };
+    const float radius[] = { 1.0f, 200.0f, 1.0f, 5.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    int visible[8];
+    const int written = cullSpheres(planes, x, y, z, radius, 0, 8, visible);
+    CHECK(written == 5);
+    CHECK(visible[0] == 0 && visible[1] == 1 && visible[2] == 5 && visible[3] == 6 && visible[4] == 7);
+}
+
+TEST(disjointRangesOnThreadsJoinToTheWholeList) {
+    float planes[FRUSTUM_PLANE_COUNT * 4];
+    perspectivePlanes(planes);
+    const Scene scene(planes, 4096);
+
+    std::vector<int> whole(4096);
+    const int total = scene.cullAABBs(planes, 0, 4096, whole.data());
+
+    constexpr int THREADS = 4;
+    constexpr int SLICE = 1024;
+    std::vector<int> slices[THREADS];
+    int written[THREADS];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        slices[t].resize(SLICE);
+        threads.emplace_back([&, t] { written[t] = scene.cullAABBs(planes, t * SLICE, SLICE, slices[t].data()); });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    std::vector<int> joined;
+    for (int t = 0; t < THREADS; t++) joined.insert(joined.end(), slices[t].begin(), slices[t].begin() + written[t]);
+    CHECK(static_cast<int>(joined.size()) == total);
+    for (int i = 0; i < total; i++) CHECK(joined[i] == whole[i]);
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,20 @@
+#ifndef QE_MATH_TEST_ANDROID_LOG_H
+#define QE_MATH_TEST_ANDROID_LOG_H
+
+/**
+ * Sustituto de <android/log.h> para los tests en el host: los kernels sólo
+ * registran qué backend eligieron
+ */
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6
+};
+
+inline int __android_log_print(int, const char*, const char*, ...) {
+    return 0;
+}
+
+#endif // QE_MATH_TEST_ANDROID_LOG_H
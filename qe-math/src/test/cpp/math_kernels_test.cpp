@@ -0,0 +1,264 @@
+// math_kernels_test.cpp - Kernels por lotes contra una referencia escalar
+#include "math_kernels.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace qemath;
+
+namespace {
+
+// Tamaños que dejan restos de 4 (NEON/SSE) y de 8 (AVX2)
+const int COUNTS[] = { 1, 3, 4, 7, 8, 13, 64 };
+
+/** Generador fijo: los fallos se reproducen */
+struct Random {
+    uint32_t state = 12345u;
+
+    float next(float lo, float hi) {
+        state = state * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+    }
+
+    void fill(std::vector<float>& values, float lo, float hi) {
+        for (float& value : values) value = next(lo, hi);
+    }
+
+    void quaternions(float* out, int count) {
+        for (int i = 0; i < count; i++) {
+            float* q = out + i * 4;
+            float length = 0.0f;
+            for (int k = 0; k < 4; k++) {
+                q[k] = next(-1.0f, 1.0f);
+                length += q[k] * q[k];
+            }
+            length = std::sqrt(length);
+            for (int k = 0; k < 4; k++) q[k] /= length;
+        }
+    }
+
+    /** Matrices afines TRS: fila w = 0, 0, 0, 1 */
+    void affine(float* out, int count) {
+        std::vector<float> trs(static_cast<size_t>(count) * 10);
+        for (int i = 0; i < count; i++) {
+            float* t = &trs[i * 10];
+            for (int k = 0; k < 3; k++) t[k] = next(-10.0f, 10.0f);
+            quaternions(t + 3, 1);
+            for (int k = 7; k < 10; k++) t[k] = next(0.5f, 2.0f);
+        }
+        for (int i = 0; i < count; i++) referenceTRS(&trs[i * 10], out + i * 16);
+    }
+
+    static void referenceTRS(const float* trs, float* m) {
+        const float x = trs[3], y = trs[4], z = trs[5], w = trs[6];
+        const float r[9] = {
+            1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w),
+            2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+            2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y)
+        };
+        for (int c = 0; c < 3; c++) {
+            for (int k = 0; k < 3; k++) m[c * 4 + k] = r[c * 3 + k] * trs[7 + c];
+            m[c * 4 + 3] = 0.0f;
+        }
+        m[12] = trs[0];
+        m[13] = trs[1];
+        m[14] = trs[2];
+        m[15] = 1.0f;
+    }
+};
+
+// ========== Referencia escalar ==========
+
+void referenceMul(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+void referenceTransform(const float* m, const float* v, float w, float* out) {
+    for (int r = 0; r < 3; r++) {
+        out[r] = m[r] * v[0] + m[4 + r] * v[1] + m[8 + r] * v[2] + m[12 + r] * w;
+    }
+}
+
+void referenceSlerp(const float* a, const float* b, float t, float* out) {
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    float cosine = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const float sign = cosine < 0.0f ? -1.0f : 1.0f;
+    cosine *= sign;
+    if (cosine >= 1.0f - 0.00001f) {
+        float length = 0.0f;
+        for (int k = 0; k < 4; k++) {
+            out[k] = a[k] + (sign * b[k] - a[k]) * t;
+            length += out[k] * out[k];
+        }
+        for (int k = 0; k < 4; k++) out[k] /= std::sqrt(length);
+        return;
+    }
+    const float halfTheta = std::acos(cosine);
+    const float sinHalfTheta = std::sqrt(1.0f - cosine * cosine);
+    const float ratioA = std::sin((1.0f - t) * halfTheta) / sinHalfTheta;
+    const float ratioB = std::sin(t * halfTheta) / sinHalfTheta;
+    for (int k = 0; k < 4; k++) out[k] = a[k] * ratioA + sign * b[k] * ratioB;
+}
+
+void checkAll(const std::vector<float>& actual, const std::vector<float>& expected, float tolerance) {
+    CHECK(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); i++) {
+        CHECK_NEAR(actual[i], expected[i], tolerance * (1.0f + std::fabs(expected[i])));
+    }
+}
+
+} // namespace
+
+TEST(backendMatchesTheBuild) {
+    const char* backend = getKernelBackend();
+#if defined(QE_MATH_AVX2)
+    __builtin_cpu_init();
+    const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    CHECK(std::strcmp(backend, avx2 ? "AVX2" : "SSE") == 0);
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    CHECK(std::strcmp(backend, "NEON") == 0);
+#elif defined(__SSE2__)
+    CHECK(std::strcmp(backend, "SSE") == 0);
+#else
+    CHECK(std::strcmp(backend, "Scalar") == 0);
+#endif
+}
+
+TEST(matrixProductsMatchTheReference) {
+    Random random;
+    for (int count : COUNTS) {
+        std::vector<float> a(count * 16), b(count * 16), out(count * 16), expected(count * 16);
+        random.fill(a, -2.0f, 2.0f);
+        random.fill(b, -2.0f, 2.0f);
+
+        for (int i = 0; i < count; i++) referenceMul(&a[i * 16], &b[i * 16], &expected[i * 16]);
+        mat4MulBatch(a.data(), b.data(), out.data(), count);
+        checkAll(out, expected, 1e-5f);
+
+        for (int i = 0; i < count; i++) referenceMul(a.data(), &b[i * 16], &expected[i * 16]);
+        mat4PreMulBatch(a.data(), b.data(), out.data(), count);
+        checkAll(out, expected, 1e-5f);
+
+        // out == entrada
+        mat4PreMulBatch(a.data(), b.data(), b.data(), count);
+        checkAll(b, expected, 1e-5f);
+    }
+}
+
+TEST(pointsNormalsAndBoxesFollowTheMatrix) {
+    Random random;
+    for (int count : COUNTS) {
+        std::vector<float> matrix(16);
+        random.affine(matrix.data(), 1);
+        std::vector<float> points(count * 3), out(count * 3), expected(count * 3);
+        random.fill(points, -5.0f, 5.0f);
+
+        for (int i = 0; i < count; i++) referenceTransform(matrix.data(), &points[i * 3], 1.0f, &expected[i * 3]);
+        transformPoints(matrix.data(), points.data(), out.data(), count);
+        checkAll(out, expected, 1e-5f);
+
+        for (int i = 0; i < count; i++) {
+            float* n = &expected[i * 3];
+            referenceTransform(matrix.data(), &points[i * 3], 0.0f, n);
+            const float length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; k++) n[k] /= length;
+        }
+        transformNormals(matrix.data(), points.data(), out.data(), count, true);
+        checkAll(out, expected, 1e-5f);
+
+        // Una AABB por objeto: la de sus 8 esquinas transformadas
+        std::vector<float> matrices(count * 16), boxes(count * 6), bounds(count * 6), reference(count * 6);
+        random.affine(matrices.data(), count);
+        for (int i = 0; i < count; i++) {
+            float* box = &boxes[i * 6];
+            for (int k = 0; k < 3; k++) {
+                const float a = random.next(-3.0f, 3.0f), b = random.next(-3.0f, 3.0f);
+                box[k] = std::fmin(a, b);
+                box[3 + k] = std::fmax(a, b);
+            }
+            float* r = &reference[i * 6];
+            for (int k = 0; k < 3; k++) {
+                r[k] = 1e30f;
+                r[3 + k] = -1e30f;
+            }
+            for (int corner = 0; corner < 8; corner++) {
+                const float p[3] = { box[corner & 1 ? 3 : 0], box[corner & 2 ? 4 : 1], box[corner & 4 ? 5 : 2] };
+                float q[3];
+                referenceTransform(&matrices[i * 16], p, 1.0f, q);
+                for (int k = 0; k < 3; k++) {
+                    r[k] = std::fmin(r[k], q[k]);
+                    r[3 + k] = std::fmax(r[3 + k], q[k]);
+                }
+            }
+        }
+        transformAABBs(matrices.data(), boxes.data(), bounds.data(), count);
+        checkAll(bounds, reference, 1e-5f);
+    }
+}
+
+TEST(zeroNormalsStayZero) {
+    const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+    const float normals[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 3.0f, 0.0f };
+    float out[6];
+    transformNormals(identity, normals, out, 2, true);
+    CHECK(out[0] == 0.0f && out[1] == 0.0f && out[2] == 0.0f);
+    CHECK_NEAR(out[4], 1.0f, 1e-6f);
+}
+
+TEST(slerpFollowsQuaternionSlerp) {
+    Random random;
+    for (int count : COUNTS) {
+        std::vector<float> a(count * 4), b(count * 4), t(count), out(count * 4), expected(count * 4);
+        random.quaternions(a.data(), count);
+        random.quaternions(b.data(), count);
+        random.fill(t, -0.2f, 1.2f);
+        // Casi iguales y opuestos: las ramas de lerp y de camino corto
+        std::memcpy(&b[0], &a[0], sizeof(float) * 4);
+        if (count > 1) {
+            for (int k = 0; k < 4; k++) b[4 + k] = -a[4 + k];
+        }
+
+        for (int i = 0; i < count; i++) referenceSlerp(&a[i * 4], &b[i * 4], t[i], &expected[i * 4]);
+        slerpBatch(a.data(), b.data(), t.data(), out.data(), count);
+        checkAll(out, expected, 1e-4f);
+    }
+}
+
+TEST(composeTRSMatchesMatrixTrsInEveryLayout) {
+    Random random;
+    for (int count : COUNTS) {
+        std::vector<float> trs(count * 10), expected(count * 16), out(count * 16);
+        for (int i = 0; i < count; i++) {
+            float* t = &trs[i * 10];
+            for (int k = 0; k < 3; k++) t[k] = random.next(-10.0f, 10.0f);
+            random.quaternions(t + 3, 1);
+            for (int k = 7; k < 10; k++) t[k] = random.next(0.1f, 3.0f);
+            Random::referenceTRS(t, &expected[i * 16]);
+        }
+        composeTRSBatch(trs.data(), out.data(), count);
+        checkAll(out, expected, 1e-5f);
+
+        std::vector<float> positions(count * 3), rotations(count * 4), scales(count * 3);
+        for (int i = 0; i < count; i++) {
+            std::memcpy(&positions[i * 3], &trs[i * 10], sizeof(float) * 3);
+            std::memcpy(&rotations[i * 4], &trs[i * 10 + 3], sizeof(float) * 4);
+            std::memcpy(&scales[i * 3], &trs[i * 10 + 7], sizeof(float) * 3);
+        }
+        std::fill(out.begin(), out.end(), 0.0f);
+        composeTRSBatch(positions.data(), rotations.data(), scales.data(), out.data(), count);
+        checkAll(out, expected, 1e-5f);
+    }
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,250 @@
+// ray_kernels_test.cpp - Raycasts por lotes y por paquetes contra Ray.intersect*
+#include "ray_kernels.h"
+#include "test_check.h"
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace qemath;
+
+namespace {
+
+/** Generador fijo: los fallos se reproducen */
+struct Random {
+    uint32_t state = 4242u;
+
+    float next(float lo, float hi) {
+        state = state * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+    }
+
+    void ray(float* out) {
+        for (int k = 0; k < 3; k++) out[k] = next(-40.0f, 40.0f);
+        float length = 0.0f;
+        for (int k = 3; k < 6; k++) {
+            out[k] = next(-1.0f, 1.0f);
+            length += out[k] * out[k];
+        }
+        length = std::sqrt(length);
+        for (int k = 3; k < 6; k++) out[k] /= length;
+        // Alguno alineado con un eje: slabs con dirección 0
+        if (next(0.0f, 1.0f) < 0.1f) {
+            out[3] = 0.0f;
+            out[4] = 0.0f;
+            out[5] = out[5] < 0.0f ? -1.0f : 1.0f;
+        }
+    }
+};
+
+// ========== Referencia escalar (Ray.intersectSphere / intersectAABB) ==========
+
+float referenceSphere(const float* ray, float cx, float cy, float cz, float r) {
+    const float ocx = ray[0] - cx, ocy = ray[1] - cy, ocz = ray[2] - cz;
+    const float b = ocx * ray[3] + ocy * ray[4] + ocz * ray[5];
+    const float discriminant = b * b - (ocx * ocx + ocy * ocy + ocz * ocz - r * r);
+    if (discriminant < 0.0f) return FLT_MAX;
+    const float t = -b - std::sqrt(discriminant);
+    return t >= 0.0f ? t : FLT_MAX;
+}
+
+float referenceAABB(const float* ray, const float* box) {
+    float tmin = -FLT_MAX, tmax = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        if (ray[3 + axis] == 0.0f) {
+            if (ray[axis] < box[axis] || ray[axis] > box[3 + axis]) return FLT_MAX;
+            continue;
+        }
+        float t1 = (box[axis] - ray[axis]) / ray[3 + axis];
+        float t2 = (box[3 + axis] - ray[axis]) / ray[3 + axis];
+        tmin = std::fmax(tmin, std::fmin(t1, t2));
+        tmax = std::fmin(tmax, std::fmax(t1, t2));
+    }
+    if (tmax < 0.0f || tmin > tmax) return FLT_MAX;
+    return tmin >= 0.0f ? tmin : tmax;
+}
+
+/** Objetos en SoA: esferas (x, y, z, radius) y cajas (min, max) */
+struct Scene {
+    std::vector<float> x, y, z, radius;
+    std::vector<float> minX, minY, minZ, maxX, maxY, maxZ;
+    std::vector<int> layers;
+
+    explicit Scene(int count) {
+        Random random;
+        for (int i = 0; i < count; i++) {
+            x.push_back(random.next(-30.0f, 30.0f));
+            y.push_back(random.next(-30.0f, 30.0f));
+            z.push_back(random.next(-30.0f, 30.0f));
+            radius.push_back(random.next(0.2f, 3.0f));
+            float lo[3], hi[3];
+            for (int k = 0; k < 3; k++) {
+                const float a = random.next(-30.0f, 30.0f);
+                lo[k] = a;
+                hi[k] = a + random.next(0.2f, 6.0f);
+            }
+            minX.push_back(lo[0]); minY.push_back(lo[1]); minZ.push_back(lo[2]);
+            maxX.push_back(hi[0]); maxY.push_back(hi[1]); maxZ.push_back(hi[2]);
+            // Incluye capas fuera de 0..31, que ninguna máscara acepta
+            const int layer = static_cast<int>(random.next(0.0f, 36.0f)) - 2;
+            layers.push_back(layer);
+        }
+    }
+
+    float sphere(const float* ray, int i) const { return referenceSphere(ray, x[i], y[i], z[i], radius[i]); }
+
+    float box(const float* ray, int i) const {
+        const float bounds[6] = { minX[i], minY[i], minZ[i], maxX[i], maxY[i], maxZ[i] };
+        return referenceAABB(ray, bounds);
+    }
+
+    bool accepted(const int* filter, int mask, int i) const {
+        return filter == nullptr || (filter[i] >= 0 && filter[i] < 32 && ((static_cast<uint32_t>(mask) >> filter[i]) & 1u));
+    }
+};
+
+/**
+ * Índice y distancia del kernel contra la referencia: si otro objeto queda
+ * a menos de 1e-3 del más cercano cualquiera de los dos vale
+ */
+template <typename Distance>
+void checkNearest(int index, float distance, Distance reference, int first, int count, float maxDistance) {
+    int expected = NO_HIT;
+    float best = maxDistance;
+    for (int i = first; i < first + count; i++) {
+        const float t = reference(i);
+        if (t < best) {
+            best = t;
+            expected = i;
+        }
+    }
+    if (expected == NO_HIT) {
+        // Sin impacto claro: o nada, o uno justo en el límite
+        CHECK(index == NO_HIT || std::fabs(reference(index) - maxDistance) < 1e-3f);
+        return;
+    }
+    CHECK(index != NO_HIT);
+    CHECK_NEAR(distance, best, 1e-3f * (1.0f + best));
+    if (index != expected) {
+        CHECK(index >= first && index < first + count);
+        CHECK_NEAR(reference(index), best, 1e-3f * (1.0f + best));
+    }
+}
+
+} // namespace
+
+TEST(singleRaysFindTheNearestSphereAndBox) {
+    const Scene scene(301);
+    Random random;
+    int sphereHits = 0;
+    int boxHits = 0;
+    for (int r = 0; r < 400; r++) {
+        float ray[RAY_FLOATS];
+        random.ray(ray);
+        const float maxDistance = r % 5 == 0 ? 10.0f : 200.0f;
+        const int first = r % 7;
+        const int count = 301 - first - r % 11;
+
+        float distance = -1.0f;
+        int index = raycastSpheres(ray, maxDistance, scene.x.data(), scene.y.data(), scene.z.data(),
+                                   scene.radius.data(), nullptr, 0, first, count, &distance);
+        checkNearest(index, distance, [&](int i) { return scene.sphere(ray, i); }, first, count, maxDistance);
+        sphereHits += index != NO_HIT ? 1 : 0;
+
+        index = raycastAABBs(ray, maxDistance, scene.minX.data(), scene.minY.data(), scene.minZ.data(),
+                             scene.maxX.data(), scene.maxY.data(), scene.maxZ.data(), nullptr, 0,
+                             first, count, &distance);
+        checkNearest(index, distance, [&](int i) { return scene.box(ray, i); }, first, count, maxDistance);
+        boxHits += index != NO_HIT ? 1 : 0;
+    }
+    // La escena no es trivial en ningún sentido
+    CHECK(sphereHits > 40 && sphereHits < 360);
+    CHECK(boxHits > 40 && boxHits < 360);
+}
+
+TEST(originInsideFollowsRayIntersect) {
+    const float ray[RAY_FLOATS] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    // Esfera que contiene el origen: sin impacto; caja: la salida
+    const float x[] = { 0.0f, 10.0f }, y[] = { 0.0f, 0.0f }, z[] = { 0.0f, 0.0f }, r[] = { 2.0f, 1.0f };
+    float distance = -1.0f;
+    CHECK(raycastSpheres(ray, 100.0f, x, y, z, r, nullptr, 0, 0, 1, &distance) == NO_HIT);
+    CHECK(raycastSpheres(ray, 100.0f, x, y, z, r, nullptr, 0, 0, 2, &distance) == 1);
+    CHECK_NEAR(distance, 9.0f, 1e-5f);
+
+    const float lo[] = { -1.0f }, hi[] = { 3.0f };
+    CHECK(raycastAABBs(ray, 100.0f, lo, lo, lo, hi, hi, hi, nullptr, 0, 0, 1, &distance) == 0);
+    CHECK_NEAR(distance, 3.0f, 1e-5f);
+    // Sólo cuenta por debajo de maxDistance
+    CHECK(raycastAABBs(ray, 3.0f, lo, lo, lo, hi, hi, hi, nullptr, 0, 0, 1, &distance) == NO_HIT);
+}
+
+TEST(tiesGoToTheLowerIndex) {
+    const float ray[RAY_FLOATS] = { 0.0f, 0.0f, -10.0f, 0.0f, 0.0f, 1.0f };
+    // Esferas 1..8 iguales, en lanes y bloques distintos; la 0 fuera del rayo
+    std::vector<float> x(9, 0.0f), y(9, 0.0f), z(9, 0.0f), r(9, 1.0f);
+    x[0] = 50.0f;
+    float distance;
+    CHECK(raycastSpheres(ray, 100.0f, x.data(), y.data(), z.data(), r.data(), nullptr, 0, 0, 9, &distance) == 1);
+    CHECK(raycastSpheres(ray, 100.0f, x.data(), y.data(), z.data(), r.data(), nullptr, 0, 3, 6, &distance) == 3);
+}
+
+TEST(layerMaskSkipsFilteredAndOutOfRangeLayers) {
+    const Scene scene(301);
+    Random random;
+    const int masks[] = { -1, 1, 0x5555, static_cast<int>(0x80000000u) };
+    for (int mask : masks) {
+        for (int r = 0; r < 100; r++) {
+            float ray[RAY_FLOATS];
+            random.ray(ray);
+            float distance;
+            int index = raycastSpheres(ray, 200.0f, scene.x.data(), scene.y.data(), scene.z.data(),
+                                       scene.radius.data(), scene.layers.data(), mask, 0, 301, &distance);
+            checkNearest(index, distance, [&](int i) {
+                return scene.accepted(scene.layers.data(), mask, i) ? scene.sphere(ray, i) : FLT_MAX;
+            }, 0, 301, 200.0f);
+
+            index = raycastAABBs(ray, 200.0f, scene.minX.data(), scene.minY.data(), scene.minZ.data(),
+                                 scene.maxX.data(), scene.maxY.data(), scene.maxZ.data(), scene.layers.data(), mask,
+                                 0, 301, &distance);
+            checkNearest(index, distance, [&](int i) {
+                return scene.accepted(scene.layers.data(), mask, i) ? scene.box(ray, i) : FLT_MAX;
+            }, 0, 301, 200.0f);
+        }
+    }
+}
+
+TEST(packetsMatchTheReference) {
+    const Scene scene(157);
+    Random random;
+    // 4 en 4 (8 en 8 con AVX2) más un resto
+    constexpr int RAYS = 23;
+    std::vector<float> rays(RAYS * RAY_FLOATS), maxDistances(RAYS);
+    for (int r = 0; r < RAYS; r++) {
+        random.ray(&rays[r * RAY_FLOATS]);
+        maxDistances[r] = r % 3 == 0 ? 15.0f : 200.0f;
+    }
+
+    std::vector<int> indices(RAYS);
+    std::vector<float> distances(RAYS);
+    raycastPacketSpheres(rays.data(), maxDistances.data(), RAYS, scene.x.data(), scene.y.data(), scene.z.data(),
+                         scene.radius.data(), scene.layers.data(), 0x0f0f0f0f, 5, 150, indices.data(),
+                         distances.data());
+    for (int r = 0; r < RAYS; r++) {
+        const float* ray = &rays[r * RAY_FLOATS];
+        checkNearest(indices[r], distances[r], [&](int i) {
+            return scene.accepted(scene.layers.data(), 0x0f0f0f0f, i) ? scene.sphere(ray, i) : FLT_MAX;
+        }, 5, 150, maxDistances[r]);
+    }
+
+    raycastPacketAABBs(rays.data(), maxDistances.data(), RAYS, scene.minX.data(), scene.minY.data(),
+                       scene.minZ.data(), scene.maxX.data(), scene.maxY.data(), scene.maxZ.data(), nullptr, 0,
+                       5, 150, indices.data(), distances.data());
+    for (int r = 0; r < RAYS; r++) {
+        const float* ray = &rays[r * RAY_FLOATS];
+        checkNearest(indices[r], distances[r], [&](int i) { return scene.box(ray, i); }, 5, 150, maxDistances[r]);
+    }
+}
+
+int main() {
+    return runTests();
+}
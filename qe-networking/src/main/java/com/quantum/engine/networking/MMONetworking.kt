@@ -1,5 +1,6 @@
 package com.quantum.engine.networking
 
+import com.quantum.engine.physics.PhysicsSystem
 import kotlinx.coroutines.*
 import kotlinx.coroutines.flow.*
 import java.nio.ByteBuffer
@@ -14,8 +15,11 @@ import java.util.concurrent.ConcurrentHashMap
  * - Delta compression
  * - Client prediction
  * - Server reconciliation
- * - Lag compensation
+ * - Lag compensation (rewind de las entidades visibles sobre el historial
+ *   de snapshots nativo de PhysicsSystem)
  * - Priority-based updates
+ *
+ * El id de NetworkEntity es el de la entidad ECS de su cuerpo físico.
  */
 class MMONetworkingSystem : System() {
     
@@ -28,11 +32,23 @@ class MMONetworkingSystem : System() {
     var maxPlayers = 5000
     var interestRadius = 100f // Radio de interés en metros
     
+    // Lag compensation: hasta dónde se rebobina (ms) y la física del
+    // servidor cuyo historial se usa; sin ella los inputs se procesan sobre
+    // el estado actual
+    var lagCompensationWindowMs = 1000L
+    var physics: PhysicsSystem? = null
+        set(value) {
+            field = value
+            value?.let { it.snapshotFrames = historyFrames(it.fixedTimeStep) }
+        }
+    
     // Estado
     private val connectedClients = ConcurrentHashMap<Long, NetworkClient>()
     private val entities = ConcurrentHashMap<Long, NetworkEntity>()
     private val zones = ConcurrentHashMap<ZoneId, Zone>()
     
+    private var rewindIds = LongArray(64)
+    
     // Estadísticas
     private var bytesSent = 0L
     private var bytesReceived = 0L
@@ -139,14 +155,14 @@ class MMONetworkingSystem : System() {
             client.inputQueue.clear()
             
             inputs.forEach { input ->
-                // Rewind server state al timestamp del input
-                val rewindState = rewindToTimestamp(input.timestamp)
+                // Rewind de lo que el cliente veía al timestamp del input
+                val rewound = rewindToTimestamp(client, input.timestamp)
                 
                 // Procesar input
                 processInput(client, input)
                 
                 // Restaurar estado actual
-                restoreState(rewindState)
+                if (rewound) restoreState()
             }
         }
     }
@@ -180,26 +196,34 @@ class MMONetworkingSystem : System() {
     }
     
     /**
-     * Rewind state para lag compensation
+     * Rewind para lag compensation: sólo las entidades visibles del cliente
+     * vuelven a su pose en el snapshot del timestamp; el resto del mundo
+     * sigue en el presente
+     *
+     * @return false sin física o si el historial no llega tan atrás
      */
-    private fun rewindToTimestamp(timestamp: Long): ServerState {
-        // Guardar estado actual
-        val currentState = captureState()
+    private fun rewindToTimestamp(client: NetworkClient, timestamp: Long): Boolean {
+        val physics = physics ?: return false
         
-        // TODO: Restaurar estado histórico al timestamp
+        val count = client.visibleEntities.size
+        if (count > rewindIds.size) {
+            rewindIds = LongArray(maxOf(count, rewindIds.size * 2))
+        }
+        var i = 0
+        client.visibleEntities.forEach { rewindIds[i++] = it }
         
-        return currentState
+        return physics.rewind(timestamp, rewindIds, count) >= 0
     }
     
-    private fun captureState(): ServerState {
-        return ServerState(
-            entities = entities.mapValues { it.value.getState() }
-        )
+    private fun restoreState() {
+        physics?.endRewind()
     }
     
-    private fun restoreState(state: ServerState) {
-        // TODO: Restaurar estado
-    }
+    /**
+     * Steps fijos que cubren lagCompensationWindowMs
+     */
+    private fun historyFrames(fixedTimeStep: Float): Int =
+        (lagCompensationWindowMs / (fixedTimeStep * 1000f)).toInt() + 1
     
     private fun processInput(client: NetworkClient, input: PlayerInput) {
         // TODO: Procesar input del jugador
@@ -377,13 +401,6 @@ enum class NetworkProtocol {
     WEBSOCKET
 }
 
-/**
- * ServerState - Estado del servidor (para rewind)
- */
-data class ServerState(
-    val entities: Map<Long, EntityState>
-)
-
 /**
  * NetworkStats - Estadísticas de red
  */
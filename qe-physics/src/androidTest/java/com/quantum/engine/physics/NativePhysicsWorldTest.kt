@@ -0,0 +1,161 @@
+package com.quantum.engine.physics
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import com.quantum.engine.math.Vector3
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * Sueño de islas, rollback de snapshots y raycast de heightfields del mundo
+ * nativo
+ */
+@RunWith(AndroidJUnit4::class)
+class NativePhysicsWorldTest {
+
+    private lateinit var world: NativePhysicsWorld
+
+    @Before
+    fun setUp() {
+        world = NativePhysicsWorld()
+    }
+
+    @After
+    fun tearDown() {
+        world.close()
+    }
+
+    private fun addBody(
+        slot: Int,
+        position: Vector3,
+        velocityX: Float = 0f,
+        inverseMass: Float = 1f,
+        shape: Int = NativePhysicsWorld.SHAPE_SPHERE,
+        hull: Int = -1
+    ) {
+        world.setShape(slot, shape, Vector3.ZERO, Vector3(0.5f, 0.5f, 0.5f), hull)
+        world.setProperties(slot, floatArrayOf(
+            inverseMass, inverseMass, inverseMass, inverseMass,
+            0f, 0f, 1f,
+            1f, 1f, 1f,
+            1f, 1f, 1f,
+            NativePhysicsWorld.COLLISION_DISCRETE.toFloat()
+        ))
+        world.setState(slot, floatArrayOf(
+            position.x, position.y, position.z,
+            0f, 0f, 0f, 1f,
+            velocityX, 0f, 0f,
+            0f, 0f, 0f
+        ))
+    }
+
+    private fun changedIndex(slot: Int): Int {
+        for (i in 0 until world.changedCount) {
+            if (world.changedSlots[i] == slot) return i
+        }
+        return -1
+    }
+
+    @Test
+    fun restingIslandSleepsAndWakesOnForce() {
+        world.setSleepParameters(0.05f, 0.05f, 0.5f)
+        addBody(0, Vector3.ZERO)
+
+        repeat(60) { world.step(1f / 60f, Vector3.ZERO, 4) }
+        assertTrue(world.isSleeping(0))
+        assertEquals(1, world.sleepingCount)
+
+        // Dormido: no se integra ni vuelve en changedSlots
+        assertEquals(0, world.step(1f / 60f, Vector3.ZERO, 4))
+
+        world.addForce(0, Vector3(0f, 50f, 0f), Vector3.ZERO)
+        world.step(1f / 60f, Vector3.ZERO, 4)
+        assertFalse(world.isSleeping(0))
+        val index = changedIndex(0)
+        assertTrue(index >= 0)
+        assertTrue(world.changedStates[index * NativePhysicsWorld.STATE_FLOATS + 1] > 0f)
+
+        // En movimiento no vuelve a dormirse
+        repeat(120) { world.step(1f / 60f, Vector3.ZERO, 4) }
+        assertFalse(world.isSleeping(0))
+    }
+
+    @Test
+    fun wakeBodyWakesTheSleepingIsland() {
+        world.setSleepParameters(0.05f, 0.05f, 0.5f)
+        addBody(0, Vector3.ZERO)
+        repeat(60) { world.step(1f / 60f, Vector3.ZERO, 4) }
+        assertTrue(world.isSleeping(0))
+
+        world.wakeBody(0)
+        assertFalse(world.isSleeping(0))
+        assertEquals(0, world.sleepingCount)
+    }
+
+    @Test
+    fun restoreSnapshotRollsTheWorldBack() {
+        world.snapshotCapacity = 8
+        addBody(0, Vector3.ZERO, velocityX = 2f)
+
+        world.step(0.1f, Vector3.ZERO, 1)
+        world.captureSnapshot(1)
+        val captured = world.changedStates[changedIndex(0) * NativePhysicsWorld.STATE_FLOATS]
+        for (timestamp in 2L..6L) {
+            world.step(0.1f, Vector3.ZERO, 1)
+            world.captureSnapshot(timestamp)
+        }
+
+        // Más atrás que el historial
+        assertFalse(world.restoreSnapshot(0))
+
+        assertTrue(world.restoreSnapshot(1))
+        val index = changedIndex(0)
+        assertTrue(index >= 0)
+        val base = index * NativePhysicsWorld.STATE_FLOATS
+        assertEquals(captured, world.changedStates[base], 1e-5f)
+        assertEquals(2f, world.changedStates[base + 7], 1e-5f)
+
+        // Resimular desde el rollback da lo mismo que la primera vez
+        val replayed = FloatArray(5)
+        for (i in 0 until 5) {
+            world.step(0.1f, Vector3.ZERO, 1)
+            replayed[i] = world.changedStates[changedIndex(0) * NativePhysicsWorld.STATE_FLOATS]
+        }
+        assertEquals(captured + 1f, replayed[4], 1e-4f)
+    }
+
+    @Test
+    fun heightfieldRaycastHitsTheSurface() {
+        // 4 × 4 muestras a altura 1 centradas en el cuerpo (x de 8.5 a 11.5)
+        world.setHeightfield(0, FloatArray(16) { 1f }, 4, 4, 1f)
+        addBody(0, Vector3(10f, 0f, 0f), inverseMass = 0f, shape = NativePhysicsWorld.SHAPE_HEIGHTFIELD, hull = 0)
+        world.step(1f / 60f, Vector3(0f, -9.81f, 0f), 1)
+
+        val normal = FloatArray(3)
+        val down = Vector3(0f, -1f, 0f)
+        val distance = world.raycastHeightfield(0, Vector3(10.2f, 5f, 0.3f), down, 100f, normal)
+        assertEquals(4f, distance, 0.01f)
+        assertEquals(1f, normal[1], 1e-4f)
+
+        // Fuera de la rejilla o sin llegar a la superficie
+        assertEquals(-1f, world.raycastHeightfield(0, Vector3(20f, 5f, 0f), down, 100f, normal), 0f)
+        assertEquals(-1f, world.raycastHeightfield(0, Vector3(10.2f, 5f, 0.3f), down, 3f, normal), 0f)
+
+        val rays = floatArrayOf(
+            10f, 5f, 0f, 0f, -1f, 0f,
+            30f, 5f, 0f, 0f, -1f, 0f
+        )
+        val distances = FloatArray(2)
+        world.raycastHeightfieldBatch(0, rays, 2, floatArrayOf(100f, 100f), distances)
+        assertEquals(4f, distances[0], 0.01f)
+        assertEquals(-1f, distances[1], 0f)
+
+        // Chunk descargado: deja de colisionar
+        world.clearHeightfield(0)
+        assertEquals(-1f, world.raycastHeightfield(0, Vector3(10.2f, 5f, 0.3f), down, 100f, normal), 0f)
+    }
+}
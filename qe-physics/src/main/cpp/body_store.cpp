@@ -0,0 +1,458 @@
+// body_store.cpp - Cuerpos rígidos en SoA e integrador SIMD (NEON / SSE / escalar)
+#include "body_store.h"
+#include "simd_float4.h"
+#include <algorithm>
+#include <initializer_list>
+
+using namespace simd;
+
+void BodyStore::ensureCapacity(int32_t slot) {
+    if (slot < getCapacity()) return;
+
+    // Múltiplo de 4 para que el integrador lea el último grupo completo
+    size_t padded = (static_cast<size_t>(slot) + 4) & ~static_cast<size_t>(3);
+    padded = std::max(padded, shapeType.size() * 2);
+
+    for (std::vector<float>* column : {
+             &posX, &posY, &posZ, &rotX, &rotY, &rotZ,
+             &velX, &velY, &velZ, &angX, &angY, &angZ,
+             &forceX, &forceY, &forceZ, &torqueX, &torqueY, &torqueZ,
+             &invMass, &invInertiaX, &invInertiaY, &invInertiaZ,
+             &drag, &angularDrag, &gravityScale,
+             &linearFactorX, &linearFactorY, &linearFactorZ,
+             &angularFactorX, &angularFactorY, &angularFactorZ,
+             &friction, &staticFriction, &restitution,
+             &shapeCenterX, &shapeCenterY, &shapeCenterZ,
+             &shapeExtentX, &shapeExtentY, &shapeExtentZ,
+             &awake, &sleepTime }) {
+        column->resize(padded, 0.0f);
+    }
+    rotW.resize(padded, 1.0f);
+    frictionCombine.resize(padded, 0);
+    restitutionCombine.resize(padded, 0);
+    trigger.resize(padded, 0);
+    layer.resize(padded, 0);
+    collisionMode.resize(padded, COLLISION_DISCRETE);
+    shapeType.resize(padded, SHAPE_NONE);
+    shapeHull.resize(padded, -1);
+    proxy.resize(padded, -1);
+    changed.resize(padded, 0);
+    movedLanes.resize(padded / 4, 0);
+    generation.resize(padded, 1u);          // impar: sin cuerpo
+}
+
+std::vector<float>* BodyStore::stateColumn(int32_t index) {
+    std::vector<float>* const columns[STATE_FLOATS] = {
+        &posX, &posY, &posZ, &rotX, &rotY, &rotZ, &rotW,
+        &velX, &velY, &velZ, &angX, &angY, &angZ
+    };
+    return columns[index];
+}
+
+// Primera escritura de un slot libre: cuerpo nuevo
+void BodyStore::reuse(int32_t slot) {
+    if (generation[slot] & 1u) {
+        generation[slot]++;
+    }
+}
+
+void BodyStore::markChanged(int32_t slot) {
+    if (!changed[slot]) {
+        changed[slot] = 1;
+        changedBodies.push_back(slot);
+    }
+}
+
+void BodyStore::wake(int32_t slot) {
+    if (awake[slot] == 0.0f) {
+        awake[slot] = 1.0f;
+        sleepTime[slot] = 0.0f;
+        wokenBodies.push_back(slot);
+    }
+}
+
+void BodyStore::setAwake(int32_t slot, bool value) {
+    awake[slot] = value ? 1.0f : 0.0f;
+    sleepTime[slot] = 0.0f;
+    if (!value) {
+        setVelocities(slot, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f));
+    }
+}
+
+void BodyStore::clearChanged() {
+    for (int32_t slot : changedBodies) {
+        changed[slot] = 0;
+    }
+    changedBodies.clear();
+}
+
+// ========== Sincronización ==========
+
+void BodyStore::setStates(const int32_t* slots, const float* states, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = slots[i];
+        ensureCapacity(slot);
+        reuse(slot);
+
+        const float* s = states + i * STATE_FLOATS;
+        posX[slot] = s[0];
+        posY[slot] = s[1];
+        posZ[slot] = s[2];
+        rotX[slot] = s[3];
+        rotY[slot] = s[4];
+        rotZ[slot] = s[5];
+        rotW[slot] = s[6];
+        velX[slot] = s[7];
+        velY[slot] = s[8];
+        velZ[slot] = s[9];
+        angX[slot] = s[10];
+        angY[slot] = s[11];
+        angZ[slot] = s[12];
+        markChanged(slot);
+        wake(slot);
+    }
+}
+
+void BodyStore::setProperties(const int32_t* slots, const float* properties, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = slots[i];
+        ensureCapacity(slot);
+
+        const float* p = properties + i * PROPERTY_FLOATS;
+        invMass[slot] = p[0];
+        invInertiaX[slot] = p[1];
+        invInertiaY[slot] = p[2];
+        invInertiaZ[slot] = p[3];
+        drag[slot] = p[4];
+        angularDrag[slot] = p[5];
+        gravityScale[slot] = p[6];
+        linearFactorX[slot] = p[7];
+        linearFactorY[slot] = p[8];
+        linearFactorZ[slot] = p[9];
+        angularFactorX[slot] = p[10];
+        angularFactorY[slot] = p[11];
+        angularFactorZ[slot] = p[12];
+        collisionMode[slot] = static_cast<uint8_t>(p[13]);
+        wake(slot);
+    }
+}
+
+void BodyStore::addForces(const int32_t* slots, const float* forces, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = slots[i];
+        ensureCapacity(slot);
+
+        const float* f = forces + i * FORCE_FLOATS;
+        forceX[slot] += f[0];
+        forceY[slot] += f[1];
+        forceZ[slot] += f[2];
+        torqueX[slot] += f[3];
+        torqueY[slot] += f[4];
+        torqueZ[slot] += f[5];
+        if (f[0] != 0.0f || f[1] != 0.0f || f[2] != 0.0f || f[3] != 0.0f || f[4] != 0.0f || f[5] != 0.0f) {
+            wake(slot);
+        }
+    }
+}
+
+void BodyStore::setMaterials(const int32_t* slots, const float* materials, int32_t count) {
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = slots[i];
+        ensureCapacity(slot);
+
+        const float* m = materials + i * MATERIAL_FLOATS;
+        friction[slot] = m[0];
+        staticFriction[slot] = m[1];
+        restitution[slot] = m[2];
+        frictionCombine[slot] = static_cast<int32_t>(m[3]);
+        restitutionCombine[slot] = static_cast<int32_t>(m[4]);
+        trigger[slot] = m[5] != 0.0f ? 1 : 0;
+        // Capas fuera de 0..31 no caben en la máscara de consulta: se ignoran
+        if (m[6] >= 0.0f && m[6] < 32.0f) {
+            layer[slot] = static_cast<uint8_t>(m[6]);
+        }
+    }
+}
+
+bool BodyStore::setShape(int32_t slot, int32_t type, int32_t hull, const float* shape) {
+    ensureCapacity(slot);
+    reuse(slot);
+
+    bool typeChanged = shapeType[slot] != type;
+    shapeType[slot] = type;
+    shapeHull[slot] = type == SHAPE_CONVEX || type == SHAPE_HEIGHTFIELD ? hull : -1;
+    shapeCenterX[slot] = shape[0];
+    shapeCenterY[slot] = shape[1];
+    shapeCenterZ[slot] = shape[2];
+    shapeExtentX[slot] = shape[3];
+    shapeExtentY[slot] = shape[4];
+    shapeExtentZ[slot] = shape[5];
+    markChanged(slot);
+    wake(slot);
+    return typeChanged;
+}
+
+void BodyStore::removeBody(int32_t slot) {
+    if (slot >= getCapacity()) return;
+
+    // Un slot vacío no se mueve: masa inversa y factores a 0
+    static const float EMPTY_STATE[STATE_FLOATS] = {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f
+    };
+    static const float EMPTY_PROPERTIES[PROPERTY_FLOATS] = {};
+
+    setStates(&slot, EMPTY_STATE, 1);
+    setProperties(&slot, EMPTY_PROPERTIES, 1);
+    forceX[slot] = forceY[slot] = forceZ[slot] = 0.0f;
+    torqueX[slot] = torqueY[slot] = torqueZ[slot] = 0.0f;
+    friction[slot] = staticFriction[slot] = restitution[slot] = 0.0f;
+    frictionCombine[slot] = restitutionCombine[slot] = 0;
+    trigger[slot] = 0;
+    layer[slot] = 0;
+    shapeType[slot] = SHAPE_NONE;
+    shapeHull[slot] = -1;
+    proxy[slot] = -1;
+    awake[slot] = 0.0f;
+    sleepTime[slot] = 0.0f;
+    generation[slot] |= 1u;
+}
+
+void BodyStore::setPose(int32_t slot, Vec3 position, Quat rotation) {
+    posX[slot] = position.x;
+    posY[slot] = position.y;
+    posZ[slot] = position.z;
+    rotX[slot] = rotation.x;
+    rotY[slot] = rotation.y;
+    rotZ[slot] = rotation.z;
+    rotW[slot] = rotation.w;
+}
+
+void BodyStore::setVelocities(int32_t slot, Vec3 velocity, Vec3 angularVelocity) {
+    velX[slot] = velocity.x;
+    velY[slot] = velocity.y;
+    velZ[slot] = velocity.z;
+    angX[slot] = angularVelocity.x;
+    angY[slot] = angularVelocity.y;
+    angZ[slot] = angularVelocity.z;
+}
+
+void BodyStore::getState(int32_t slot, float* out) const {
+    out[0] = posX[slot];
+    out[1] = posY[slot];
+    out[2] = posZ[slot];
+    out[3] = rotX[slot];
+    out[4] = rotY[slot];
+    out[5] = rotZ[slot];
+    out[6] = rotW[slot];
+    out[7] = velX[slot];
+    out[8] = velY[slot];
+    out[9] = velZ[slot];
+    out[10] = angX[slot];
+    out[11] = angY[slot];
+    out[12] = angZ[slot];
+}
+
+void BodyStore::loadState(int32_t slot, const float* state) {
+    setPose(slot, vec3(state[0], state[1], state[2]), { state[3], state[4], state[5], state[6] });
+    setVelocities(slot, vec3(state[7], state[8], state[9]), vec3(state[10], state[11], state[12]));
+}
+
+Bounds BodyStore::getWorldBounds(int32_t slot) const {
+    Quat q = { rotX[slot], rotY[slot], rotZ[slot], rotW[slot] };
+    Vec3 offset = vec3(shapeCenterX[slot], shapeCenterY[slot], shapeCenterZ[slot]);
+    Vec3 center = vec3(posX[slot], posY[slot], posZ[slot]) + rotate(q, offset);
+    Vec3 extents = vec3(shapeExtentX[slot], shapeExtentY[slot], shapeExtentZ[slot]);
+
+    // Caja/cápsula/convexa rotada: semiejes world = |R| · semiejes locales
+    if (shapeType[slot] != SHAPE_SPHERE) {
+        Vec3 axisX = vabs(rotate(q, vec3(1.0f, 0.0f, 0.0f)));
+        Vec3 axisY = vabs(rotate(q, vec3(0.0f, 1.0f, 0.0f)));
+        Vec3 axisZ = vabs(rotate(q, vec3(0.0f, 0.0f, 1.0f)));
+        extents = axisX * extents.x + axisY * extents.y + axisZ * extents.z;
+    }
+
+    return { center - extents, center + extents };
+}
+
+// ========== Integración ==========
+
+// (x, y, z) rotado por (qx, qy, qz, qw), 4 cuerpos a la vez
+static inline void rotate4(float4 qx, float4 qy, float4 qz, float4 qw,
+                           float4& x, float4& y, float4& z) {
+    const float4 two = set1(2.0f);
+    float4 tx = mul(two, sub(mul(qy, z), mul(qz, y)));
+    float4 ty = mul(two, sub(mul(qz, x), mul(qx, z)));
+    float4 tz = mul(two, sub(mul(qx, y), mul(qy, x)));
+    float4 rx = add(madd(qw, tx, x), sub(mul(qy, tz), mul(qz, ty)));
+    float4 ry = add(madd(qw, ty, y), sub(mul(qz, tx), mul(qx, tz)));
+    float4 rz = add(madd(qw, tz, z), sub(mul(qx, ty), mul(qy, tx)));
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+void BodyStore::integrateVelocities(float dt, Vec3 gravity, int32_t begin, int32_t end) {
+    end = std::min(end, getCapacity());
+    const float4 vdt = set1(dt);
+    const float4 one = set1(1.0f);
+    const float4 zeros = zero();
+    const float4 gx = set1(gravity.x);
+    const float4 gy = set1(gravity.y);
+    const float4 gz = set1(gravity.z);
+
+    for (int32_t i = begin; i < end; i += 4) {
+        // Grupo dormido entero: nada que integrar
+        float4 aw = load(&awake[i]);
+        if (maskBits(cmpgt(aw, zeros)) == 0) continue;
+
+        // Los dormidos del grupo, con factores a 0, no cambian
+        float4 lfx = mul(load(&linearFactorX[i]), aw);
+        float4 lfy = mul(load(&linearFactorY[i]), aw);
+        float4 lfz = mul(load(&linearFactorZ[i]), aw);
+        float4 afx = mul(load(&angularFactorX[i]), aw);
+        float4 afy = mul(load(&angularFactorY[i]), aw);
+        float4 afz = mul(load(&angularFactorZ[i]), aw);
+
+        // Velocidad lineal: v += (g·escala + F/m) dt en los ejes libres
+        float4 im = load(&invMass[i]);
+        float4 gs = load(&gravityScale[i]);
+        float4 vx = load(&velX[i]);
+        float4 vy = load(&velY[i]);
+        float4 vz = load(&velZ[i]);
+        vx = madd(mul(madd(load(&forceX[i]), im, mul(gx, gs)), lfx), vdt, vx);
+        vy = madd(mul(madd(load(&forceY[i]), im, mul(gy, gs)), lfy), vdt, vy);
+        vz = madd(mul(madd(load(&forceZ[i]), im, mul(gz, gs)), lfz), vdt, vz);
+
+        // Drag: v *= max(0, 1 - drag·dt), sólo en los ejes libres
+        float4 damp = sub(max(zeros, sub(one, mul(load(&drag[i]), vdt))), one);
+        vx = mul(vx, madd(lfx, damp, one));
+        vy = mul(vy, madd(lfy, damp, one));
+        vz = mul(vz, madd(lfz, damp, one));
+
+        // Velocidad angular: torque a local, inercia inversa diagonal, vuelta a world
+        float4 qx = load(&rotX[i]);
+        float4 qy = load(&rotY[i]);
+        float4 qz = load(&rotZ[i]);
+        float4 qw = load(&rotW[i]);
+        float4 tx = load(&torqueX[i]);
+        float4 ty = load(&torqueY[i]);
+        float4 tz = load(&torqueZ[i]);
+        rotate4(sub(zeros, qx), sub(zeros, qy), sub(zeros, qz), qw, tx, ty, tz);
+        tx = mul(tx, load(&invInertiaX[i]));
+        ty = mul(ty, load(&invInertiaY[i]));
+        tz = mul(tz, load(&invInertiaZ[i]));
+        rotate4(qx, qy, qz, qw, tx, ty, tz);
+
+        float4 wx = madd(mul(tx, afx), vdt, load(&angX[i]));
+        float4 wy = madd(mul(ty, afy), vdt, load(&angY[i]));
+        float4 wz = madd(mul(tz, afz), vdt, load(&angZ[i]));
+        float4 angularDamp = sub(max(zeros, sub(one, mul(load(&angularDrag[i]), vdt))), one);
+        wx = mul(wx, madd(afx, angularDamp, one));
+        wy = mul(wy, madd(afy, angularDamp, one));
+        wz = mul(wz, madd(afz, angularDamp, one));
+
+        store(&velX[i], vx);
+        store(&velY[i], vy);
+        store(&velZ[i], vz);
+        store(&angX[i], wx);
+        store(&angY[i], wy);
+        store(&angZ[i], wz);
+    }
+}
+
+// Las fuerzas se acumulan por step
+void BodyStore::clearForces() {
+    std::fill(forceX.begin(), forceX.end(), 0.0f);
+    std::fill(forceY.begin(), forceY.end(), 0.0f);
+    std::fill(forceZ.begin(), forceZ.end(), 0.0f);
+    std::fill(torqueX.begin(), torqueX.end(), 0.0f);
+    std::fill(torqueY.begin(), torqueY.end(), 0.0f);
+    std::fill(torqueZ.begin(), torqueZ.end(), 0.0f);
+}
+
+void BodyStore::integratePositions(float dt, int32_t begin, int32_t end) {
+    end = std::min(end, getCapacity());
+    const float4 vdt = set1(dt);
+    const float4 halfDt = set1(0.5f * dt);
+    const float4 zeros = zero();
+
+    for (int32_t i = begin; i < end; i += 4) {
+        float4 aw = load(&awake[i]);
+        if (maskBits(cmpgt(aw, zeros)) == 0) continue;
+
+        // Posición con la velocidad ya resuelta
+        float4 mvx = mul(mul(load(&velX[i]), load(&linearFactorX[i])), aw);
+        float4 mvy = mul(mul(load(&velY[i]), load(&linearFactorY[i])), aw);
+        float4 mvz = mul(mul(load(&velZ[i]), load(&linearFactorZ[i])), aw);
+        store(&posX[i], madd(mvx, vdt, load(&posX[i])));
+        store(&posY[i], madd(mvy, vdt, load(&posY[i])));
+        store(&posZ[i], madd(mvz, vdt, load(&posZ[i])));
+
+        // Rotación: q += ½ dt (ω ⊗ q) y renormalizar
+        float4 qx = load(&rotX[i]);
+        float4 qy = load(&rotY[i]);
+        float4 qz = load(&rotZ[i]);
+        float4 qw = load(&rotW[i]);
+        float4 ex = mul(mul(load(&angX[i]), load(&angularFactorX[i])), aw);
+        float4 ey = mul(mul(load(&angY[i]), load(&angularFactorY[i])), aw);
+        float4 ez = mul(mul(load(&angZ[i]), load(&angularFactorZ[i])), aw);
+        float4 dqx = sub(madd(ex, qw, mul(ey, qz)), mul(ez, qy));
+        float4 dqy = sub(madd(ey, qw, mul(ez, qx)), mul(ex, qz));
+        float4 dqz = sub(madd(ez, qw, mul(ex, qy)), mul(ey, qx));
+        float4 dqw = sub(zeros, madd(ex, qx, madd(ey, qy, mul(ez, qz))));
+        qx = madd(dqx, halfDt, qx);
+        qy = madd(dqy, halfDt, qy);
+        qz = madd(dqz, halfDt, qz);
+        qw = madd(dqw, halfDt, qw);
+        float4 length = sqrt(madd(qx, qx, madd(qy, qy, madd(qz, qz, mul(qw, qw)))));
+        store(&rotX[i], div(qx, length));
+        store(&rotY[i], div(qy, length));
+        store(&rotZ[i], div(qz, length));
+        store(&rotW[i], div(qw, length));
+
+        // Movidos: velocidad lineal o angular efectiva distinta de 0
+        float4 motion = add(add(abs(mvx), abs(mvy)), add(abs(mvz),
+                        add(add(abs(ex), abs(ey)), abs(ez))));
+        movedLanes[i / 4] |= static_cast<uint8_t>(maskBits(cmpgt(motion, zeros)));
+    }
+}
+
+void BodyStore::markMoved() {
+    const int32_t groups = static_cast<int32_t>(movedLanes.size());
+    for (int32_t group = 0; group < groups; group++) {
+        int moved = movedLanes[group];
+        if (moved == 0) continue;
+        movedLanes[group] = 0;
+        while (moved) {
+            int lane = __builtin_ctz(moved);
+            markChanged(group * 4 + lane);
+            moved &= moved - 1;
+        }
+    }
+}
+
+void BodyStore::updateSleepTimers(float dt, float linearThreshold, float angularThreshold) {
+    const int32_t capacity = getCapacity();
+    const float4 vdt = set1(dt);
+    const float4 zeros = zero();
+    const float4 linearSq = set1(linearThreshold * linearThreshold);
+    const float4 angularSq = set1(angularThreshold * angularThreshold);
+
+    for (int32_t i = 0; i < capacity; i += 4) {
+        float4 aw = load(&awake[i]);
+        if (maskBits(cmpgt(aw, zeros)) == 0) continue;
+
+        float4 vx = mul(load(&velX[i]), load(&linearFactorX[i]));
+        float4 vy = mul(load(&velY[i]), load(&linearFactorY[i]));
+        float4 vz = mul(load(&velZ[i]), load(&linearFactorZ[i]));
+        float4 wx = mul(load(&angX[i]), load(&angularFactorX[i]));
+        float4 wy = mul(load(&angY[i]), load(&angularFactorY[i]));
+        float4 wz = mul(load(&angZ[i]), load(&angularFactorZ[i]));
+        float4 moving = maskOr(cmpgt(madd(vx, vx, madd(vy, vy, mul(vz, vz))), linearSq),
+                               cmpgt(madd(wx, wx, madd(wy, wy, mul(wz, wz))), angularSq));
+
+        // Los dormidos conservan su tiempo (0 desde setAwake)
+        float4 time = add(load(&sleepTime[i]), mul(vdt, aw));
+        store(&sleepTime[i], select(moving, zeros, time));
+    }
+}
@@ -0,0 +1,103 @@
+// broadphase.cpp - Pares persistentes sobre el árbol dinámico
+#include "broadphase.h"
+#include <algorithm>
+#include <iterator>
+
+int32_t Broadphase::createProxy(const Bounds& bounds, int32_t userData) {
+    int32_t proxy = tree.createProxy(bounds, userData);
+    bufferMove(proxy);
+    return proxy;
+}
+
+void Broadphase::destroyProxy(int32_t proxy) {
+    if (static_cast<size_t>(proxy) < moved.size() && moved[proxy]) {
+        moved[proxy] = 0;
+        std::replace(moveBuffer.begin(), moveBuffer.end(), proxy, DynamicTree::NULL_NODE);
+    }
+
+    // El id se puede reutilizar: quitar ya sus pares
+    pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [proxy](const BroadphasePair& pair) {
+        return pair.proxyA == proxy || pair.proxyB == proxy;
+    }), pairs.end());
+
+    tree.destroyProxy(proxy);
+}
+
+void Broadphase::moveProxy(int32_t proxy, const Bounds& bounds, Vec3 displacement) {
+    if (tree.moveProxy(proxy, bounds, displacement)) {
+        bufferMove(proxy);
+    }
+}
+
+void Broadphase::touchProxy(int32_t proxy) {
+    bufferMove(proxy);
+}
+
+void Broadphase::bufferMove(int32_t proxy) {
+    if (static_cast<size_t>(proxy) >= moved.size()) {
+        moved.resize(proxy + 1, 0);
+    }
+    if (!moved[proxy]) {
+        moved[proxy] = 1;
+        moveBuffer.push_back(proxy);
+    }
+}
+
+void Broadphase::updatePairs(JobPool& jobs) {
+    // 1. Pares nuevos: sólo consultan los proxies reinsertados, por lotes en
+    //    paralelo, cada lote a su buffer (el orden lo fija el sort de después)
+    const int32_t moveCount = static_cast<int32_t>(moveBuffer.size());
+    const size_t batchCount = static_cast<size_t>((moveCount + QUERY_BATCH - 1) / QUERY_BATCH);
+    if (batchPairs.size() < batchCount) {
+        batchPairs.resize(batchCount);
+    }
+
+    jobs.parallelFor(moveCount, QUERY_BATCH, [this](int32_t begin, int32_t end) {
+        std::vector<BroadphasePair>& out = batchPairs[begin / QUERY_BATCH];
+        out.clear();
+        for (int32_t i = begin; i < end; i++) {
+            int32_t proxy = moveBuffer[i];
+            if (proxy == DynamicTree::NULL_NODE) continue;
+
+            const Bounds& fat = tree.getFatBounds(proxy);
+            tree.query(fat, [&](int32_t other) {
+                if (other == proxy) return true;
+                // Si los dos se movieron, el par lo añade el de id mayor
+                if (moved[other] && other > proxy) return true;
+
+                out.push_back({ std::min(proxy, other), std::max(proxy, other) });
+                return true;
+            });
+        }
+    });
+
+    newPairs.clear();
+    for (size_t batch = 0; batch < batchCount; batch++) {
+        newPairs.insert(newPairs.end(), batchPairs[batch].begin(), batchPairs[batch].end());
+    }
+
+    // 2. Descartar pares que dejaron de solaparse (sólo pueden ser de proxies movidos)
+    if (!moveBuffer.empty()) {
+        pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [this](const BroadphasePair& pair) {
+            if (!moved[pair.proxyA] && !moved[pair.proxyB]) return false;
+            return !tree.getFatBounds(pair.proxyA).overlaps(tree.getFatBounds(pair.proxyB));
+        }), pairs.end());
+    }
+
+    // 3. Unir manteniendo el orden y sin duplicados
+    if (!newPairs.empty()) {
+        std::sort(newPairs.begin(), newPairs.end());
+        newPairs.erase(std::unique(newPairs.begin(), newPairs.end()), newPairs.end());
+
+        merged.clear();
+        merged.reserve(pairs.size() + newPairs.size());
+        std::set_union(pairs.begin(), pairs.end(), newPairs.begin(), newPairs.end(),
+                       std::back_inserter(merged));
+        pairs.swap(merged);
+    }
+
+    for (int32_t proxy : moveBuffer) {
+        if (proxy != DynamicTree::NULL_NODE) moved[proxy] = 0;
+    }
+    moveBuffer.clear();
+}
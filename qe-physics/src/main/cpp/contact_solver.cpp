@@ -0,0 +1,406 @@
+// contact_solver.cpp - Impulsos secuenciales con substeps, warm starting y coloreado
+#include "contact_solver.h"
+#include <algorithm>
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static inline Vec3 mulAxes(Vec3 a, Vec3 b) {
+    return vec3(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+// Base ortonormal (t1, t2) perpendicular a n
+static void tangentBasis(Vec3 n, Vec3& t1, Vec3& t2) {
+    if (std::fabs(n.x) >= 0.57735f) {
+        t1 = vec3(n.y, -n.x, 0.0f);
+    } else {
+        t1 = vec3(0.0f, n.z, -n.y);
+    }
+    t1 = t1 * (1.0f / length(t1));
+    t2 = cross(n, t1);
+}
+
+// ========== Preparación ==========
+
+int32_t ContactSolver::addBody(const BodyStore& bodies, int32_t slot) {
+    if (bodyIndex[slot] >= 0) return bodyIndex[slot];
+
+    SolverBody body;
+    body.slot = slot;
+    body.velocity = bodies.getVelocity(slot);
+    body.angularVelocity = bodies.getAngularVelocity(slot);
+    body.position = bodies.getPosition(slot);
+    body.rotation = bodies.getRotation(slot);
+    body.invMass = mulAxes(bodies.getLinearFactor(slot), vec3(1.0f, 1.0f, 1.0f) * bodies.getInvMass(slot));
+
+    // I⁻¹ world = R diag(I⁻¹ local) Rᵀ, con los ejes bloqueados a 0
+    Quat q = body.rotation;
+    Vec3 axes[3] = {
+        rotate(q, vec3(1.0f, 0.0f, 0.0f)),
+        rotate(q, vec3(0.0f, 1.0f, 0.0f)),
+        rotate(q, vec3(0.0f, 0.0f, 1.0f))
+    };
+    Vec3 local = bodies.getInvInertia(slot);
+    Vec3 factor = bodies.getAngularFactor(slot);
+    float inertia[3] = { local.x, local.y, local.z };
+    Mat3 m = { vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f) };
+    for (int32_t k = 0; k < 3; k++) {
+        Vec3 a = axes[k];
+        m.c0 += a * (inertia[k] * a.x);
+        m.c1 += a * (inertia[k] * a.y);
+        m.c2 += a * (inertia[k] * a.z);
+    }
+    m.c0 = mulAxes(m.c0, factor) * factor.x;
+    m.c1 = mulAxes(m.c1, factor) * factor.y;
+    m.c2 = mulAxes(m.c2, factor) * factor.z;
+    body.invInertia = m;
+
+    body.dynamic = lengthSq(body.invMass) > 0.0f ||
+                   lengthSq(m.c0) + lengthSq(m.c1) + lengthSq(m.c2) > 0.0f;
+
+    int32_t index = static_cast<int32_t>(solverBodies.size());
+    solverBodies.push_back(body);
+    bodyColors.push_back(0);
+    bodyIndex[slot] = index;
+    return index;
+}
+
+/**
+ * Muelle amortiguado discreto: fracción de la penetración que se corrige por
+ * segundo y escalas de masa/impulso acumulado del contacto blando
+ */
+static void contactSoftness(float hertz, float h, float& biasRate, float& massScale, float& impulseScale) {
+    const float omega = 2.0f * 3.14159265f * hertz;
+    const float a1 = 2.0f * ContactSolver::CONTACT_DAMPING_RATIO + h * omega;
+    const float a2 = h * omega * a1;
+    const float a3 = 1.0f / (1.0f + a2);
+    biasRate = omega / a1;
+    massScale = a2 * a3;
+    impulseScale = a3;
+}
+
+void ContactSolver::prepare(const BodyStore& bodies, const std::vector<Manifold>& manifolds, float h) {
+    solverBodies.clear();
+    solverManifolds.clear();
+    bodyColors.clear();
+    bodyIndex.assign(bodies.getCapacity(), -1);
+
+    invH = h > 0.0f ? 1.0f / h : 0.0f;
+
+    // Rigidez limitada por el substep: por encima de ~1/5 de su frecuencia el muelle
+    // discreto deja de ser estable. Contra estáticos el doble: sólo se mueve un lado.
+    const float hertz = std::fmin(CONTACT_HERTZ, 0.2f * invH);
+    float biasRate, massScale, impulseScale;
+    float staticBiasRate, staticMassScale, staticImpulseScale;
+    contactSoftness(hertz, h, biasRate, massScale, impulseScale);
+    contactSoftness(std::fmin(2.0f * CONTACT_HERTZ, 0.2f * invH), h, staticBiasRate, staticMassScale, staticImpulseScale);
+
+    for (size_t index = 0; index < manifolds.size(); index++) {
+        const Manifold& manifold = manifolds[index];
+        // Islas dormidas (o contra estáticos dormidos): fuera del solver
+        if (!bodies.isAwake(manifold.bodyA) && !bodies.isAwake(manifold.bodyB)) continue;
+
+        SolverManifold sm;
+        sm.manifold = static_cast<int32_t>(index);
+        sm.bodyA = addBody(bodies, manifold.bodyA);
+        sm.bodyB = addBody(bodies, manifold.bodyB);
+        const SolverBody& a = solverBodies[sm.bodyA];
+        const SolverBody& b = solverBodies[sm.bodyB];
+
+        sm.normal = rotate(a.rotation, manifold.localNormal);
+        tangentBasis(sm.normal, sm.tangent1, sm.tangent2);
+        sm.restitution = manifold.restitution;
+        sm.pointCount = manifold.pointCount;
+
+        bool againstStatic = !a.dynamic || !b.dynamic;
+        sm.biasRate = againstStatic ? staticBiasRate : biasRate;
+        sm.massScale = againstStatic ? staticMassScale : massScale;
+        sm.impulseScale = againstStatic ? staticImpulseScale : impulseScale;
+
+        float tangentSpeed = 0.0f;
+        for (int32_t i = 0; i < manifold.pointCount; i++) {
+            const ContactPoint& cp = manifold.points[i];
+            SolverPoint& sp = sm.points[i];
+
+            sp.localA = cp.localA;
+            sp.localB = cp.localB;
+            Vec3 pointA = a.position + rotate(a.rotation, cp.localA);
+            Vec3 pointB = b.position + rotate(b.rotation, cp.localB);
+            Vec3 point = (pointA + pointB) * 0.5f;
+            sp.anchorA = point - a.position;
+            sp.anchorB = point - b.position;
+
+            Vec3 rnA = cross(sp.anchorA, sm.normal);
+            Vec3 rnB = cross(sp.anchorB, sm.normal);
+            float kNormal = dot(sm.normal, mulAxes(a.invMass + b.invMass, sm.normal)) +
+                            dot(rnA, a.invInertia * rnA) + dot(rnB, b.invInertia * rnB);
+            sp.normalMass = kNormal > 0.0f ? 1.0f / kNormal : 0.0f;
+
+            Vec3 rt1A = cross(sp.anchorA, sm.tangent1), rt1B = cross(sp.anchorB, sm.tangent1);
+            Vec3 rt2A = cross(sp.anchorA, sm.tangent2), rt2B = cross(sp.anchorB, sm.tangent2);
+            float kTangent1 = dot(sm.tangent1, mulAxes(a.invMass + b.invMass, sm.tangent1)) +
+                              dot(rt1A, a.invInertia * rt1A) + dot(rt1B, b.invInertia * rt1B);
+            float kTangent2 = dot(sm.tangent2, mulAxes(a.invMass + b.invMass, sm.tangent2)) +
+                              dot(rt2A, a.invInertia * rt2A) + dot(rt2B, b.invInertia * rt2B);
+            sp.tangentMass1 = kTangent1 > 0.0f ? 1.0f / kTangent1 : 0.0f;
+            sp.tangentMass2 = kTangent2 > 0.0f ? 1.0f / kTangent2 : 0.0f;
+
+            Vec3 dv = b.velocity + cross(b.angularVelocity, sp.anchorB) -
+                      a.velocity - cross(a.angularVelocity, sp.anchorA);
+            sp.relativeVelocity = dot(dv, sm.normal);
+            tangentSpeed = std::fmax(tangentSpeed, length(dv - sm.normal * sp.relativeVelocity));
+
+            sp.normalImpulse = cp.normalImpulse;
+            sp.tangentImpulse1 = cp.tangentImpulse1;
+            sp.tangentImpulse2 = cp.tangentImpulse2;
+            sp.maxNormalImpulse = 0.0f;
+        }
+
+        sm.friction = tangentSpeed < STATIC_FRICTION_SPEED ? manifold.staticFriction : manifold.friction;
+        solverManifolds.push_back(sm);
+    }
+
+    colorManifolds();
+}
+
+/**
+ * Coloreado greedy: cada manifold toma el primer color que no usa ninguno de
+ * sus cuerpos dinámicos. Los estáticos/cinemáticos no se escriben, así que no
+ * restringen el color.
+ */
+void ContactSolver::colorManifolds() {
+    const int32_t count = static_cast<int32_t>(solverManifolds.size());
+    manifoldColors.resize(count);
+    std::fill(colorOffsets, colorOffsets + MAX_COLORS + 2, 0);
+    colorCount = 0;
+
+    for (int32_t i = 0; i < count; i++) {
+        const SolverManifold& m = solverManifolds[i];
+        bool dynamicA = solverBodies[m.bodyA].dynamic;
+        bool dynamicB = solverBodies[m.bodyB].dynamic;
+        uint64_t used = (dynamicA ? bodyColors[m.bodyA] : 0) | (dynamicB ? bodyColors[m.bodyB] : 0);
+
+        int32_t color = MAX_COLORS;
+        if (used != ~0ull) {
+            color = __builtin_ctzll(~used);
+            uint64_t bit = 1ull << color;
+            if (dynamicA) bodyColors[m.bodyA] |= bit;
+            if (dynamicB) bodyColors[m.bodyB] |= bit;
+        }
+        manifoldColors[i] = color;
+        colorOffsets[color + 1]++;
+        colorCount = std::max(colorCount, color + 1);
+    }
+
+    // Counting sort estable: dentro de un color se mantiene el orden de pares
+    for (int32_t c = 0; c <= MAX_COLORS; c++) {
+        colorOffsets[c + 1] += colorOffsets[c];
+    }
+    colorOrder.resize(count);
+    int32_t cursor[MAX_COLORS + 1];
+    std::copy(colorOffsets, colorOffsets + MAX_COLORS + 1, cursor);
+    for (int32_t i = 0; i < count; i++) {
+        colorOrder[cursor[manifoldColors[i]]++] = i;
+    }
+}
+
+// ========== Velocidades ==========
+
+void ContactSolver::loadBodies(const BodyStore& bodies, JobPool& jobs) {
+    jobs.parallelFor(static_cast<int32_t>(solverBodies.size()), BODY_BATCH, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) {
+            SolverBody& body = solverBodies[i];
+            body.velocity = bodies.getVelocity(body.slot);
+            body.angularVelocity = bodies.getAngularVelocity(body.slot);
+            body.position = bodies.getPosition(body.slot);
+            body.rotation = bodies.getRotation(body.slot);
+        }
+    });
+}
+
+void ContactSolver::storeVelocities(BodyStore& bodies, JobPool& jobs) const {
+    jobs.parallelFor(static_cast<int32_t>(solverBodies.size()), BODY_BATCH, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) {
+            const SolverBody& body = solverBodies[i];
+            if (body.dynamic) {
+                bodies.setVelocities(body.slot, body.velocity, body.angularVelocity);
+            }
+        }
+    });
+}
+
+/**
+ * Manifolds de un color por lotes en paralelo: no comparten cuerpo dinámico,
+ * así que el orden entre lotes no cambia el resultado. El color de desborde
+ * (MAX_COLORS) sí los comparte y va en orden en un solo hilo.
+ */
+template <typename F>
+void ContactSolver::forEachColor(JobPool& jobs, F&& body) {
+    for (int32_t c = 0; c < colorCount; c++) {
+        const int32_t offset = colorOffsets[c];
+        const int32_t count = colorOffsets[c + 1] - offset;
+        if (c == MAX_COLORS) {
+            for (int32_t k = 0; k < count; k++) {
+                body(solverManifolds[colorOrder[offset + k]]);
+            }
+            continue;
+        }
+        jobs.parallelFor(count, MANIFOLD_BATCH, [&](int32_t begin, int32_t end) {
+            for (int32_t k = begin; k < end; k++) {
+                body(solverManifolds[colorOrder[offset + k]]);
+            }
+        });
+    }
+}
+
+void ContactSolver::warmStart(JobPool& jobs) {
+    forEachColor(jobs, [this](SolverManifold& m) {
+        SolverBody& a = solverBodies[m.bodyA];
+        SolverBody& b = solverBodies[m.bodyB];
+
+        for (int32_t i = 0; i < m.pointCount; i++) {
+            const SolverPoint& sp = m.points[i];
+            Vec3 impulse = m.normal * sp.normalImpulse + m.tangent1 * sp.tangentImpulse1 +
+                           m.tangent2 * sp.tangentImpulse2;
+            if (a.dynamic) {
+                a.velocity -= mulAxes(a.invMass, impulse);
+                a.angularVelocity -= a.invInertia * cross(sp.anchorA, impulse);
+            }
+            if (b.dynamic) {
+                b.velocity += mulAxes(b.invMass, impulse);
+                b.angularVelocity += b.invInertia * cross(sp.anchorB, impulse);
+            }
+        }
+    });
+}
+
+void ContactSolver::solveManifold(SolverManifold& m, bool useBias) {
+    SolverBody& a = solverBodies[m.bodyA];
+    SolverBody& b = solverBodies[m.bodyB];
+    Vec3 vA = a.velocity, wA = a.angularVelocity;
+    Vec3 vB = b.velocity, wB = b.angularVelocity;
+
+    // Normal primero: la fricción usa el impulso normal actualizado
+    for (int32_t i = 0; i < m.pointCount; i++) {
+        SolverPoint& sp = m.points[i];
+
+        // Separación con las poses actuales
+        Vec3 pointA = a.position + rotate(a.rotation, sp.localA);
+        Vec3 pointB = b.position + rotate(b.rotation, sp.localB);
+        float separation = dot(pointB - pointA, m.normal);
+
+        // Especulativo: puede acercarse lo que falta para tocar en este substep.
+        // Penetrando: contacto blando, salvo en la relajación.
+        float bias = 0.0f;
+        float massScale = 1.0f;
+        float impulseScale = 0.0f;
+        if (separation > 0.0f) {
+            bias = separation * invH;
+        } else if (useBias) {
+            bias = std::fmax(m.biasRate * std::fmin(separation + LINEAR_SLOP, 0.0f), -MAX_PUSHOUT_SPEED);
+            massScale = m.massScale;
+            impulseScale = m.impulseScale;
+        }
+
+        Vec3 dv = vB + cross(wB, sp.anchorB) - vA - cross(wA, sp.anchorA);
+        float vn = dot(dv, m.normal);
+
+        float lambda = -sp.normalMass * massScale * (vn + bias) - impulseScale * sp.normalImpulse;
+        float total = std::fmax(sp.normalImpulse + lambda, 0.0f);
+        lambda = total - sp.normalImpulse;
+        sp.normalImpulse = total;
+        sp.maxNormalImpulse = std::fmax(sp.maxNormalImpulse, lambda);
+
+        Vec3 impulse = m.normal * lambda;
+        vA -= mulAxes(a.invMass, impulse);
+        wA -= a.invInertia * cross(sp.anchorA, impulse);
+        vB += mulAxes(b.invMass, impulse);
+        wB += b.invInertia * cross(sp.anchorB, impulse);
+    }
+
+    // Fricción: cada tangente por separado, acotada a μ·λn del punto
+    for (int32_t i = 0; i < m.pointCount; i++) {
+        SolverPoint& sp = m.points[i];
+        float maxFriction = m.friction * sp.normalImpulse;
+
+        for (int32_t axis = 0; axis < 2; axis++) {
+            Vec3 tangent = axis == 0 ? m.tangent1 : m.tangent2;
+            float& accumulated = axis == 0 ? sp.tangentImpulse1 : sp.tangentImpulse2;
+            float mass = axis == 0 ? sp.tangentMass1 : sp.tangentMass2;
+
+            Vec3 dv = vB + cross(wB, sp.anchorB) - vA - cross(wA, sp.anchorA);
+            float total = clampf(accumulated - mass * dot(dv, tangent), -maxFriction, maxFriction);
+            Vec3 impulse = tangent * (total - accumulated);
+            accumulated = total;
+
+            vA -= mulAxes(a.invMass, impulse);
+            wA -= a.invInertia * cross(sp.anchorA, impulse);
+            vB += mulAxes(b.invMass, impulse);
+            wB += b.invInertia * cross(sp.anchorB, impulse);
+        }
+    }
+
+    // Los no dinámicos no se escriben: un color puede compartirlos
+    if (a.dynamic) {
+        a.velocity = vA;
+        a.angularVelocity = wA;
+    }
+    if (b.dynamic) {
+        b.velocity = vB;
+        b.angularVelocity = wB;
+    }
+}
+
+void ContactSolver::solve(bool useBias, JobPool& jobs) {
+    forEachColor(jobs, [this, useBias](SolverManifold& m) {
+        solveManifold(m, useBias);
+    });
+}
+
+/**
+ * Rebote al final del step, sobre la velocidad de aproximación que había al
+ * preparar: dentro de los substeps el contacto blando lo absorbería
+ */
+void ContactSolver::applyRestitution(JobPool& jobs) {
+    forEachColor(jobs, [this](SolverManifold& m) {
+        if (m.restitution == 0.0f) return;
+
+        SolverBody& a = solverBodies[m.bodyA];
+        SolverBody& b = solverBodies[m.bodyB];
+        for (int32_t i = 0; i < m.pointCount; i++) {
+            SolverPoint& sp = m.points[i];
+            if (sp.relativeVelocity > -RESTITUTION_THRESHOLD || sp.maxNormalImpulse == 0.0f) continue;
+
+            Vec3 dv = b.velocity + cross(b.angularVelocity, sp.anchorB) -
+                      a.velocity - cross(a.angularVelocity, sp.anchorA);
+            float vn = dot(dv, m.normal);
+            float lambda = -sp.normalMass * (vn + m.restitution * sp.relativeVelocity);
+            float total = std::fmax(sp.normalImpulse + lambda, 0.0f);
+            lambda = total - sp.normalImpulse;
+            sp.normalImpulse = total;
+
+            Vec3 impulse = m.normal * lambda;
+            if (a.dynamic) {
+                a.velocity -= mulAxes(a.invMass, impulse);
+                a.angularVelocity -= a.invInertia * cross(sp.anchorA, impulse);
+            }
+            if (b.dynamic) {
+                b.velocity += mulAxes(b.invMass, impulse);
+                b.angularVelocity += b.invInertia * cross(sp.anchorB, impulse);
+            }
+        }
+    });
+}
+
+void ContactSolver::storeImpulses(std::vector<Manifold>& manifolds) const {
+    for (size_t m = 0; m < solverManifolds.size(); m++) {
+        const SolverManifold& sm = solverManifolds[m];
+        for (int32_t i = 0; i < sm.pointCount; i++) {
+            ContactPoint& cp = manifolds[sm.manifold].points[i];
+            cp.normalImpulse = sm.points[i].normalImpulse;
+            cp.tangentImpulse1 = sm.points[i].tangentImpulse1;
+            cp.tangentImpulse2 = sm.points[i].tangentImpulse2;
+        }
+    }
+}
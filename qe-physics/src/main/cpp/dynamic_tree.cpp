@@ -0,0 +1,364 @@
+// dynamic_tree.cpp - BVH incremental con inserción y rotaciones SAH
+#include "dynamic_tree.h"
+#include <algorithm>
+#include <cfloat>
+
+DynamicTree::DynamicTree() {
+    nodes.reserve(256);
+}
+
+// ========== Nodos ==========
+
+int32_t DynamicTree::allocateNode() {
+    if (freeList == NULL_NODE) {
+        nodes.push_back(Node());
+        freeList = static_cast<int32_t>(nodes.size()) - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+
+    int32_t node = freeList;
+    freeList = nodes[node].parent;
+
+    Node& n = nodes[node];
+    n.parent = NULL_NODE;
+    n.child1 = NULL_NODE;
+    n.child2 = NULL_NODE;
+    n.height = 0;
+    n.userData = -1;
+    return node;
+}
+
+void DynamicTree::freeNode(int32_t node) {
+    nodes[node].parent = freeList;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+Bounds DynamicTree::fatten(const Bounds& bounds, Vec3 displacement) const {
+    Bounds fat;
+    fat.min = bounds.min - vec3(FAT_MARGIN, FAT_MARGIN, FAT_MARGIN);
+    fat.max = bounds.max + vec3(FAT_MARGIN, FAT_MARGIN, FAT_MARGIN);
+
+    // Extender en la dirección del movimiento previsto
+    Vec3 d = displacement * DISPLACEMENT_MULTIPLIER;
+    if (d.x < 0.0f) fat.min.x += d.x; else fat.max.x += d.x;
+    if (d.y < 0.0f) fat.min.y += d.y; else fat.max.y += d.y;
+    if (d.z < 0.0f) fat.min.z += d.z; else fat.max.z += d.z;
+    return fat;
+}
+
+// ========== Proxies ==========
+
+int32_t DynamicTree::createProxy(const Bounds& bounds, int32_t userData) {
+    int32_t proxy = allocateNode();
+    nodes[proxy].bounds = fatten(bounds, vec3(0.0f, 0.0f, 0.0f));
+    nodes[proxy].userData = userData;
+
+    insertLeaf(proxy);
+    proxyCount++;
+    return proxy;
+}
+
+void DynamicTree::destroyProxy(int32_t proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    proxyCount--;
+}
+
+bool DynamicTree::moveProxy(int32_t proxy, const Bounds& bounds, Vec3 displacement) {
+    Bounds fat = fatten(bounds, displacement);
+    const Bounds& current = nodes[proxy].bounds;
+
+    // Sigue dentro y la AABB gorda no es desproporcionada (tras frenar en
+    // seco). La holgura incluye el desplazamiento previsto en ambos sentidos
+    // para que el lado de atrás de un cuerpo en movimiento no fuerce reinserciones.
+    if (current.contains(bounds)) {
+        Vec3 d = displacement * DISPLACEMENT_MULTIPLIER;
+        Vec3 hugeMargin = vec3(4.0f * FAT_MARGIN + std::fabs(d.x),
+                               4.0f * FAT_MARGIN + std::fabs(d.y),
+                               4.0f * FAT_MARGIN + std::fabs(d.z));
+        Bounds huge = { fat.min - hugeMargin, fat.max + hugeMargin };
+        if (huge.contains(current)) {
+            return false;
+        }
+    }
+
+    removeLeaf(proxy);
+    nodes[proxy].bounds = fat;
+    insertLeaf(proxy);
+    return true;
+}
+
+// ========== Inserción / borrado ==========
+
+void DynamicTree::insertLeaf(int32_t leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    Bounds leafBounds = nodes[leaf].bounds;
+    int32_t sibling = findBestSibling(leafBounds);
+
+    // Nuevo padre para hoja + hermano (allocateNode puede mover el vector)
+    int32_t oldParent = nodes[sibling].parent;
+    int32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].bounds = Bounds::merge(leafBounds, nodes[sibling].bounds);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+
+    // Subir reequilibrando y ajustando bounds
+    int32_t index = nodes[leaf].parent;
+    while (index != NULL_NODE) {
+        refit(index);
+        rotate(index);
+        index = nodes[index].parent;
+    }
+}
+
+// Baja por el hijo de menor coste SAH acotando con el coste heredado: cada
+// nodo de la ruta es candidato a hermano y se para cuando ningún hijo puede
+// mejorar el mejor coste encontrado.
+int32_t DynamicTree::findBestSibling(const Bounds& leafBounds) const {
+    float leafArea = leafBounds.halfArea();
+
+    int32_t index = root;
+    float areaBase = nodes[root].bounds.halfArea();
+    float directCost = Bounds::merge(nodes[root].bounds, leafBounds).halfArea();
+    float inheritedCost = 0.0f;
+
+    int32_t bestSibling = root;
+    float bestCost = directCost;
+
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+
+        // Coste de colgar la hoja como hermana de este nodo
+        float cost = directCost + inheritedCost;
+        if (cost < bestCost) {
+            bestSibling = index;
+            bestCost = cost;
+        }
+
+        // Bajar hace crecer este nodo
+        inheritedCost += directCost - areaBase;
+
+        const Node& c1 = nodes[node.child1];
+        const Node& c2 = nodes[node.child2];
+        float direct1 = Bounds::merge(c1.bounds, leafBounds).halfArea();
+        float direct2 = Bounds::merge(c2.bounds, leafBounds).halfArea();
+        float area1 = c1.bounds.halfArea();
+        float area2 = c2.bounds.halfArea();
+
+        float lowerCost1 = FLT_MAX;
+        if (c1.isLeaf()) {
+            float cost1 = direct1 + inheritedCost;
+            if (cost1 < bestCost) {
+                bestSibling = node.child1;
+                bestCost = cost1;
+            }
+        } else {
+            lowerCost1 = inheritedCost + direct1 + std::min(leafArea - area1, 0.0f);
+        }
+
+        float lowerCost2 = FLT_MAX;
+        if (c2.isLeaf()) {
+            float cost2 = direct2 + inheritedCost;
+            if (cost2 < bestCost) {
+                bestSibling = node.child2;
+                bestCost = cost2;
+            }
+        } else {
+            lowerCost2 = inheritedCost + direct2 + std::min(leafArea - area2, 0.0f);
+        }
+
+        if (c1.isLeaf() && c2.isLeaf()) break;
+        if (bestCost <= lowerCost1 && bestCost <= lowerCost2) break;
+
+        if (lowerCost1 <= lowerCost2 && !c1.isLeaf()) {
+            index = node.child1;
+            areaBase = area1;
+            directCost = direct1;
+        } else {
+            index = node.child2;
+            areaBase = area2;
+            directCost = direct2;
+        }
+    }
+    return bestSibling;
+}
+
+void DynamicTree::removeLeaf(int32_t leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = nodes[leaf].parent;
+    int32_t grandParent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    // El hermano ocupa el lugar del padre
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    } else {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int32_t index = grandParent;
+    while (index != NULL_NODE) {
+        refit(index);
+        rotate(index);
+        index = nodes[index].parent;
+    }
+}
+
+void DynamicTree::refit(int32_t node) {
+    Node& n = nodes[node];
+    const Node& c1 = nodes[n.child1];
+    const Node& c2 = nodes[n.child2];
+    n.bounds = Bounds::merge(c1.bounds, c2.bounds);
+    n.height = 1 + std::max(c1.height, c2.height);
+}
+
+// ========== Rotaciones ==========
+
+// Rotación por superficie: intercambia un hijo de A con un nieto si eso
+// reduce el área de los nodos internos afectados. La AABB de A no cambia.
+void DynamicTree::rotate(int32_t iA) {
+    Node& A = nodes[iA];
+    if (A.height < 2) return;
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node& B = nodes[iB];
+    Node& C = nodes[iC];
+
+    if (B.isLeaf()) {
+        // C es interno: probar B <-> F y B <-> G
+        int32_t iF = C.child1;
+        int32_t iG = C.child2;
+        float costBF = Bounds::merge(B.bounds, nodes[iG].bounds).halfArea();
+        float costBG = Bounds::merge(B.bounds, nodes[iF].bounds).halfArea();
+        float areaC = C.bounds.halfArea();
+        if (costBF >= areaC && costBG >= areaC) return;
+
+        if (costBF < costBG) {
+            swapChild(iA, iB, iC, iF);
+        } else {
+            swapChild(iA, iB, iC, iG);
+        }
+        return;
+    }
+
+    if (C.isLeaf()) {
+        // B es interno: probar C <-> D y C <-> E
+        int32_t iD = B.child1;
+        int32_t iE = B.child2;
+        float costCD = Bounds::merge(C.bounds, nodes[iE].bounds).halfArea();
+        float costCE = Bounds::merge(C.bounds, nodes[iD].bounds).halfArea();
+        float areaB = B.bounds.halfArea();
+        if (costCD >= areaB && costCE >= areaB) return;
+
+        if (costCD < costCE) {
+            swapChild(iA, iC, iB, iD);
+        } else {
+            swapChild(iA, iC, iB, iE);
+        }
+        return;
+    }
+
+    int32_t iD = B.child1;
+    int32_t iE = B.child2;
+    int32_t iF = C.child1;
+    int32_t iG = C.child2;
+    const Bounds& bD = nodes[iD].bounds;
+    const Bounds& bE = nodes[iE].bounds;
+    const Bounds& bF = nodes[iF].bounds;
+    const Bounds& bG = nodes[iG].bounds;
+
+    float areaB = B.bounds.halfArea();
+    float areaC = C.bounds.halfArea();
+
+    // Coste total (área de B + área de C) tras cada intercambio
+    float costs[6] = {
+        areaB + Bounds::merge(B.bounds, bG).halfArea(),      // B <-> F
+        areaB + Bounds::merge(B.bounds, bF).halfArea(),      // B <-> G
+        areaC + Bounds::merge(C.bounds, bE).halfArea(),      // C <-> D
+        areaC + Bounds::merge(C.bounds, bD).halfArea(),      // C <-> E
+        Bounds::merge(bF, bE).halfArea() + Bounds::merge(bD, bG).halfArea(),  // D <-> F
+        Bounds::merge(bG, bE).halfArea() + Bounds::merge(bF, bD).halfArea()   // D <-> G
+    };
+
+    int best = -1;
+    float bestCost = areaB + areaC;
+    for (int i = 0; i < 6; i++) {
+        if (costs[i] < bestCost) {
+            bestCost = costs[i];
+            best = i;
+        }
+    }
+
+    switch (best) {
+        case 0: swapChild(iA, iB, iC, iF); break;
+        case 1: swapChild(iA, iB, iC, iG); break;
+        case 2: swapChild(iA, iC, iB, iD); break;
+        case 3: swapChild(iA, iC, iB, iE); break;
+        case 4: swapGrandChildren(iB, iD, iC, iF); break;
+        case 5: swapGrandChildren(iB, iD, iC, iG); break;
+        default: break;
+    }
+}
+
+// Intercambia el hijo child de A con el nieto grandChild (hijo de other)
+void DynamicTree::swapChild(int32_t iA, int32_t child, int32_t other, int32_t grandChild) {
+    Node& A = nodes[iA];
+    Node& O = nodes[other];
+
+    if (A.child1 == child) A.child1 = grandChild; else A.child2 = grandChild;
+    if (O.child1 == grandChild) O.child1 = child; else O.child2 = child;
+    nodes[child].parent = other;
+    nodes[grandChild].parent = iA;
+
+    refit(other);
+    refit(iA);
+}
+
+// Intercambia el nieto x (hijo de X) con el nieto y (hijo de Y)
+void DynamicTree::swapGrandChildren(int32_t iX, int32_t x, int32_t iY, int32_t y) {
+    Node& X = nodes[iX];
+    Node& Y = nodes[iY];
+
+    if (X.child1 == x) X.child1 = y; else X.child2 = y;
+    if (Y.child1 == y) Y.child1 = x; else Y.child2 = x;
+    nodes[x].parent = iY;
+    nodes[y].parent = iX;
+
+    refit(iX);
+    refit(iY);
+    refit(nodes[iX].parent);
+}
@@ -0,0 +1,469 @@
+// gjk.cpp - Distancia (GJK) y penetración (EPA) entre formas convexas
+#include "gjk.h"
+#include <algorithm>
+#include <cfloat>
+
+static constexpr int32_t GJK_MAX_ITERATIONS = 32;
+// Progreso relativo mínimo por iteración: por debajo, v ya es la distancia
+static constexpr float GJK_RELATIVE_TOLERANCE = 1e-6f;
+static constexpr float GJK_OVERLAP_DISTANCE_SQ = 1e-10f;
+
+static constexpr int32_t EPA_MAX_VERTICES = 64;
+static constexpr int32_t EPA_MAX_FACES = 2 * EPA_MAX_VERTICES;
+static constexpr int32_t EPA_MAX_EDGES = 3 * EPA_MAX_VERTICES;
+static constexpr float EPA_TOLERANCE = 1e-4f;
+
+// ========== Función soporte ==========
+
+Vec3 SupportShape::support(Vec3 direction) const {
+    Vec3 d = rotate(conjugate(rotation), direction);
+    Vec3 local = vec3(0.0f, 0.0f, 0.0f);
+
+    switch (core) {
+        case CORE_SEGMENT:
+            local = dot(d, extents) >= 0.0f ? extents : -extents;
+            break;
+        case CORE_BOX:
+            local = vec3(d.x >= 0.0f ? extents.x : -extents.x,
+                         d.y >= 0.0f ? extents.y : -extents.y,
+                         d.z >= 0.0f ? extents.z : -extents.z);
+            break;
+        case CORE_HULL: {
+            float best = -FLT_MAX;
+            for (int32_t i = 0; i < vertexCount; i++) {
+                float projection = dot(vertices[i], d);
+                if (projection > best) {
+                    best = projection;
+                    local = vertices[i];
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return position + rotate(rotation, local);
+}
+
+static GjkVertex supportVertex(const SupportShape& a, const SupportShape& b, Vec3 direction) {
+    GjkVertex vertex;
+    vertex.a = a.support(direction);
+    vertex.b = b.support(-direction);
+    vertex.w = vertex.a - vertex.b;
+    vertex.lambda = 1.0f;
+    return vertex;
+}
+
+// ========== Punto más cercano al origen (GJK) ==========
+// Cada caso reduce el simplex a la característica que contiene el punto más
+// cercano y deja sus coordenadas baricéntricas en lambda (Ericson, cap. 5).
+
+static void keepVertex(GjkSimplex& simplex, int32_t index) {
+    simplex.vertices[0] = simplex.vertices[index];
+    simplex.vertices[0].lambda = 1.0f;
+    simplex.count = 1;
+}
+
+static void keepEdge(GjkSimplex& simplex, int32_t i, int32_t j, float t) {
+    GjkVertex a = simplex.vertices[i];
+    GjkVertex b = simplex.vertices[j];
+    a.lambda = 1.0f - t;
+    b.lambda = t;
+    simplex.vertices[0] = a;
+    simplex.vertices[1] = b;
+    simplex.count = 2;
+}
+
+static void solveSegment(GjkSimplex& simplex) {
+    Vec3 a = simplex.vertices[0].w;
+    Vec3 ab = simplex.vertices[1].w - a;
+    float denom = lengthSq(ab);
+    float t = denom > 0.0f ? -dot(a, ab) / denom : 0.0f;
+
+    if (t <= 0.0f) keepVertex(simplex, 0);
+    else if (t >= 1.0f) keepVertex(simplex, 1);
+    else keepEdge(simplex, 0, 1, t);
+}
+
+static void solveTriangle(GjkSimplex& simplex) {
+    Vec3 a = simplex.vertices[0].w;
+    Vec3 b = simplex.vertices[1].w;
+    Vec3 c = simplex.vertices[2].w;
+    Vec3 ab = b - a;
+    Vec3 ac = c - a;
+
+    float d1 = -dot(ab, a);
+    float d2 = -dot(ac, a);
+    if (d1 <= 0.0f && d2 <= 0.0f) { keepVertex(simplex, 0); return; }
+
+    float d3 = -dot(ab, b);
+    float d4 = -dot(ac, b);
+    if (d3 >= 0.0f && d4 <= d3) { keepVertex(simplex, 1); return; }
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) { keepEdge(simplex, 0, 1, d1 / (d1 - d3)); return; }
+
+    float d5 = -dot(ab, c);
+    float d6 = -dot(ac, c);
+    if (d6 >= 0.0f && d5 <= d6) { keepVertex(simplex, 2); return; }
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) { keepEdge(simplex, 0, 2, d2 / (d2 - d6)); return; }
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        keepEdge(simplex, 1, 2, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        return;
+    }
+
+    float denom = va + vb + vc;
+    if (denom <= 0.0f) {
+        // Triángulo degenerado: la mejor de sus aristas
+        keepEdge(simplex, 0, 1, 0.5f);
+        solveSegment(simplex);
+        return;
+    }
+    float v = vb / denom;
+    float w = vc / denom;
+    simplex.vertices[0].lambda = 1.0f - v - w;
+    simplex.vertices[1].lambda = v;
+    simplex.vertices[2].lambda = w;
+    simplex.count = 3;
+}
+
+static Vec3 closestPoint(const GjkSimplex& simplex) {
+    Vec3 point = vec3(0.0f, 0.0f, 0.0f);
+    for (int32_t i = 0; i < simplex.count; i++) {
+        point += simplex.vertices[i].w * simplex.vertices[i].lambda;
+    }
+    return point;
+}
+
+// true si el origen está dentro del tetraedro (el simplex queda con 4 vértices)
+static bool solveTetrahedron(GjkSimplex& simplex) {
+    static const int32_t FACES[4][4] = {
+        { 0, 1, 2, 3 }, { 0, 2, 3, 1 }, { 0, 3, 1, 2 }, { 1, 3, 2, 0 }
+    };
+
+    GjkSimplex best = simplex;
+    float bestDistanceSq = FLT_MAX;
+    bool outside = false;
+
+    for (int32_t f = 0; f < 4; f++) {
+        const GjkVertex& a = simplex.vertices[FACES[f][0]];
+        const GjkVertex& b = simplex.vertices[FACES[f][1]];
+        const GjkVertex& c = simplex.vertices[FACES[f][2]];
+        const GjkVertex& opposite = simplex.vertices[FACES[f][3]];
+
+        Vec3 n = cross(b.w - a.w, c.w - a.w);
+        float signOrigin = -dot(n, a.w);
+        float signOpposite = dot(n, opposite.w - a.w);
+        // Con el tetraedro plano (signOpposite ~ 0) se prueban todas las caras
+        bool degenerate = signOpposite * signOpposite <= 1e-12f * lengthSq(n);
+        if (!degenerate && signOrigin * signOpposite >= 0.0f) continue;
+        outside = true;
+
+        GjkSimplex face;
+        face.vertices[0] = a;
+        face.vertices[1] = b;
+        face.vertices[2] = c;
+        face.count = 3;
+        solveTriangle(face);
+        float distanceSq = lengthSq(closestPoint(face));
+        if (distanceSq < bestDistanceSq) {
+            bestDistanceSq = distanceSq;
+            best = face;
+        }
+    }
+
+    if (!outside) {
+        return true;
+    }
+    simplex = best;
+    return false;
+}
+
+bool gjkDistance(const SupportShape& a, const SupportShape& b, GjkSimplex& simplex, GjkResult& out) {
+    Vec3 v = a.position - b.position;
+    if (lengthSq(v) < GJK_OVERLAP_DISTANCE_SQ) {
+        v = vec3(1.0f, 0.0f, 0.0f);
+    }
+
+    simplex.count = 0;
+    bool overlap = false;
+    int32_t iteration = 0;
+
+    for (; iteration < GJK_MAX_ITERATIONS; iteration++) {
+        GjkVertex vertex = supportVertex(a, b, -v);
+
+        if (simplex.count > 0) {
+            float vv = lengthSq(v);
+            if (vv - dot(v, vertex.w) <= GJK_RELATIVE_TOLERANCE * vv) {
+                break;
+            }
+            bool duplicate = false;
+            for (int32_t i = 0; i < simplex.count; i++) {
+                if (lengthSq(simplex.vertices[i].w - vertex.w) < GJK_OVERLAP_DISTANCE_SQ) {
+                    duplicate = true;
+                }
+            }
+            if (duplicate) {
+                break;
+            }
+        }
+
+        simplex.vertices[simplex.count++] = vertex;
+
+        switch (simplex.count) {
+            case 1: simplex.vertices[0].lambda = 1.0f; break;
+            case 2: solveSegment(simplex); break;
+            case 3: solveTriangle(simplex); break;
+            default: overlap = solveTetrahedron(simplex); break;
+        }
+        if (overlap) {
+            break;
+        }
+
+        v = closestPoint(simplex);
+        if (lengthSq(v) < GJK_OVERLAP_DISTANCE_SQ) {
+            overlap = true;
+            break;
+        }
+    }
+
+    out.pointA = vec3(0.0f, 0.0f, 0.0f);
+    out.pointB = vec3(0.0f, 0.0f, 0.0f);
+    for (int32_t i = 0; i < simplex.count; i++) {
+        const GjkVertex& vertex = simplex.vertices[i];
+        float lambda = overlap ? 1.0f / static_cast<float>(simplex.count) : vertex.lambda;
+        out.pointA += vertex.a * lambda;
+        out.pointB += vertex.b * lambda;
+    }
+    out.distance = overlap ? 0.0f : length(v);
+    out.iterations = iteration;
+    return overlap;
+}
+
+// ========== EPA ==========
+
+namespace {
+
+struct EpaFace {
+    int32_t v[3];
+    Vec3 normal;
+    float distance;
+    bool removed;
+};
+
+struct EpaPolytope {
+    GjkVertex vertices[EPA_MAX_VERTICES];
+    EpaFace faces[EPA_MAX_FACES];
+    int32_t vertexCount = 0;
+    int32_t faceCount = 0;
+
+    bool addFace(int32_t a, int32_t b, int32_t c) {
+        if (faceCount == EPA_MAX_FACES) {
+            return false;
+        }
+        Vec3 n = cross(vertices[b].w - vertices[a].w, vertices[c].w - vertices[a].w);
+        float len = length(n);
+        if (len < 1e-12f) {
+            return false;
+        }
+        EpaFace& face = faces[faceCount++];
+        face.v[0] = a;
+        face.v[1] = b;
+        face.v[2] = c;
+        face.normal = n * (1.0f / len);
+        face.distance = dot(face.normal, vertices[a].w);
+        face.removed = false;
+        return true;
+    }
+};
+
+} // namespace
+
+// Lleva un simplex de GJK con solape a tetraedro, añadiendo vértices soporte
+// en direcciones que lo despeguen de su punto, recta o plano
+static bool expandSimplex(const SupportShape& a, const SupportShape& b, GjkSimplex& simplex) {
+    static const Vec3 AXES[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+    static constexpr float MIN_EXTENT_SQ = 1e-10f;
+
+    if (simplex.count == 1) {
+        for (int32_t i = 0; i < 6 && simplex.count == 1; i++) {
+            Vec3 direction = i < 3 ? AXES[i] : -AXES[i - 3];
+            GjkVertex vertex = supportVertex(a, b, direction);
+            if (lengthSq(vertex.w - simplex.vertices[0].w) > MIN_EXTENT_SQ) {
+                simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+        if (simplex.count == 1) return false;
+    }
+
+    if (simplex.count == 2) {
+        Vec3 line = simplex.vertices[1].w - simplex.vertices[0].w;
+        Vec3 l = vabs(line);
+        int32_t axis = (l.x <= l.y && l.x <= l.z) ? 0 : (l.y <= l.z ? 1 : 2);
+        Vec3 perpendicular = cross(line, AXES[axis]);
+        Vec3 other = cross(line, perpendicular);
+
+        // Seis direcciones alrededor de la recta
+        for (int32_t i = 0; i < 6 && simplex.count == 2; i++) {
+            float angle = static_cast<float>(i) * 1.04719755f;
+            Vec3 direction = perpendicular * std::cos(angle) + other * std::sin(angle);
+            GjkVertex vertex = supportVertex(a, b, direction);
+            Vec3 offset = cross(vertex.w - simplex.vertices[0].w, line);
+            if (lengthSq(offset) > MIN_EXTENT_SQ * lengthSq(line)) {
+                simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+        if (simplex.count == 2) return false;
+    }
+
+    if (simplex.count == 3) {
+        Vec3 n = cross(simplex.vertices[1].w - simplex.vertices[0].w,
+                       simplex.vertices[2].w - simplex.vertices[0].w);
+        for (int32_t i = 0; i < 2 && simplex.count == 3; i++) {
+            GjkVertex vertex = supportVertex(a, b, i == 0 ? n : -n);
+            float height = dot(n, vertex.w - simplex.vertices[0].w);
+            if (height * height > MIN_EXTENT_SQ * lengthSq(n)) {
+                simplex.vertices[simplex.count++] = vertex;
+            }
+        }
+        if (simplex.count == 3) return false;
+    }
+
+    return true;
+}
+
+static void addHorizonEdge(int32_t (*edges)[2], int32_t& edgeCount, int32_t from, int32_t to) {
+    // Una arista compartida por dos caras visibles no es horizonte
+    for (int32_t i = 0; i < edgeCount; i++) {
+        if (edges[i][0] == to && edges[i][1] == from) {
+            edges[i][0] = edges[edgeCount - 1][0];
+            edges[i][1] = edges[edgeCount - 1][1];
+            edgeCount--;
+            return;
+        }
+    }
+    if (edgeCount < EPA_MAX_EDGES) {
+        edges[edgeCount][0] = from;
+        edges[edgeCount][1] = to;
+        edgeCount++;
+    }
+}
+
+bool epaPenetration(const SupportShape& a, const SupportShape& b, GjkSimplex& simplex,
+                    Vec3& normal, float& depth, Vec3& pointA, Vec3& pointB) {
+    if (!expandSimplex(a, b, simplex)) {
+        return false;
+    }
+
+    EpaPolytope polytope;
+    for (int32_t i = 0; i < 4; i++) {
+        polytope.vertices[i] = simplex.vertices[i];
+    }
+    polytope.vertexCount = 4;
+
+    // Orientación: normales hacia fuera del tetraedro
+    Vec3 n = cross(simplex.vertices[1].w - simplex.vertices[0].w, simplex.vertices[2].w - simplex.vertices[0].w);
+    if (dot(n, simplex.vertices[3].w - simplex.vertices[0].w) > 0.0f) {
+        std::swap(polytope.vertices[1], polytope.vertices[2]);
+    }
+    if (!polytope.addFace(0, 1, 2) || !polytope.addFace(0, 3, 1) ||
+        !polytope.addFace(0, 2, 3) || !polytope.addFace(1, 3, 2)) {
+        return false;
+    }
+
+    int32_t edges[EPA_MAX_EDGES][2];
+    int32_t closest = 0;
+
+    while (true) {
+        closest = -1;
+        float closestDistance = FLT_MAX;
+        for (int32_t i = 0; i < polytope.faceCount; i++) {
+            const EpaFace& face = polytope.faces[i];
+            if (!face.removed && face.distance < closestDistance) {
+                closestDistance = face.distance;
+                closest = i;
+            }
+        }
+        if (closest < 0) {
+            return false;
+        }
+
+        EpaFace face = polytope.faces[closest];
+        GjkVertex vertex = supportVertex(a, b, face.normal);
+        if (dot(vertex.w, face.normal) - face.distance < EPA_TOLERANCE ||
+            polytope.vertexCount == EPA_MAX_VERTICES) {
+            break;
+        }
+
+        int32_t newIndex = polytope.vertexCount++;
+        polytope.vertices[newIndex] = vertex;
+
+        int32_t edgeCount = 0;
+        for (int32_t i = 0; i < polytope.faceCount; i++) {
+            EpaFace& visible = polytope.faces[i];
+            if (visible.removed) continue;
+            if (dot(visible.normal, vertex.w - polytope.vertices[visible.v[0]].w) <= 0.0f) continue;
+
+            visible.removed = true;
+            addHorizonEdge(edges, edgeCount, visible.v[0], visible.v[1]);
+            addHorizonEdge(edges, edgeCount, visible.v[1], visible.v[2]);
+            addHorizonEdge(edges, edgeCount, visible.v[2], visible.v[0]);
+        }
+
+        // Compacta las caras quitadas antes de añadir las nuevas
+        int32_t kept = 0;
+        for (int32_t i = 0; i < polytope.faceCount; i++) {
+            if (!polytope.faces[i].removed) {
+                polytope.faces[kept++] = polytope.faces[i];
+            }
+        }
+        polytope.faceCount = kept;
+
+        bool complete = true;
+        for (int32_t i = 0; i < edgeCount; i++) {
+            complete &= polytope.addFace(edges[i][0], edges[i][1], newIndex);
+        }
+        if (!complete) {
+            // Polítopo sin cerrar: la cara de esta iteración es la mejor estimación
+            polytope.faces[0] = face;
+            polytope.faceCount = 1;
+            closest = 0;
+            break;
+        }
+    }
+
+    const EpaFace& face = polytope.faces[closest];
+    const GjkVertex& v0 = polytope.vertices[face.v[0]];
+    const GjkVertex& v1 = polytope.vertices[face.v[1]];
+    const GjkVertex& v2 = polytope.vertices[face.v[2]];
+
+    // Baricéntricas de la proyección del origen sobre la cara
+    Vec3 p = face.normal * face.distance;
+    Vec3 e0 = v1.w - v0.w;
+    Vec3 e1 = v2.w - v0.w;
+    Vec3 e2 = p - v0.w;
+    float d00 = dot(e0, e0);
+    float d01 = dot(e0, e1);
+    float d11 = dot(e1, e1);
+    float d20 = dot(e2, e0);
+    float d21 = dot(e2, e1);
+    float denom = d00 * d11 - d01 * d01;
+    float u = 1.0f / 3.0f;
+    float w = 1.0f / 3.0f;
+    if (denom > 1e-12f) {
+        u = (d11 * d20 - d01 * d21) / denom;
+        w = (d00 * d21 - d01 * d20) / denom;
+    }
+    float t = 1.0f - u - w;
+
+    normal = face.normal;
+    depth = face.distance > 0.0f ? face.distance : 0.0f;
+    pointA = v0.a * t + v1.a * u + v2.a * w;
+    pointB = v0.b * t + v1.b * u + v2.b * w;
+    return true;
+}
@@ -0,0 +1,197 @@
+// heightfield.cpp - Terreno por rejilla de alturas cuantizadas
+#include "heightfield.h"
+#include <algorithm>
+#include <cfloat>
+
+static constexpr float QUANTIZATION_STEPS = 65535.0f;
+
+void Heightfield::build(const float* heights, int32_t columnCount, int32_t rowCount, float size) {
+    if (columnCount < 2 || rowCount < 2 || heights == nullptr) {
+        clear();
+        return;
+    }
+    columns = columnCount;
+    rows = rowCount;
+    cellSize = size > 0.0f ? size : 1.0f;
+
+    const int32_t count = columns * rows;
+    float lo = heights[0], hi = heights[0];
+    for (int32_t i = 1; i < count; i++) {
+        lo = std::min(lo, heights[i]);
+        hi = std::max(hi, heights[i]);
+    }
+    minHeight = lo;
+    heightScale = (hi - lo) / QUANTIZATION_STEPS;
+
+    samples.resize(count);
+    const float inverseScale = heightScale > 0.0f ? 1.0f / heightScale : 0.0f;
+    for (int32_t i = 0; i < count; i++) {
+        float q = (heights[i] - lo) * inverseScale + 0.5f;
+        samples[i] = static_cast<uint16_t>(std::min(q, QUANTIZATION_STEPS));
+    }
+}
+
+void Heightfield::clear() {
+    columns = 0;
+    rows = 0;
+    minHeight = 0.0f;
+    heightScale = 0.0f;
+    // Descargar un chunk devuelve la memoria
+    std::vector<uint16_t>().swap(samples);
+}
+
+Bounds Heightfield::localBounds() const {
+    float maxHeight = minHeight + heightScale * QUANTIZATION_STEPS;
+    return { vec3(originX(), minHeight, originZ()), vec3(-originX(), maxHeight, -originZ()) };
+}
+
+void Heightfield::cellTriangle(int32_t x, int32_t z, int32_t tri, Vec3 out[3]) const {
+    if (tri == 0) {
+        out[0] = vertex(x, z);
+        out[1] = vertex(x, z + 1);
+        out[2] = vertex(x + 1, z);
+    } else {
+        out[0] = vertex(x + 1, z);
+        out[1] = vertex(x, z + 1);
+        out[2] = vertex(x + 1, z + 1);
+    }
+}
+
+bool Heightfield::cellRange(const Bounds& local, int32_t& x0, int32_t& z0, int32_t& x1, int32_t& z1) const {
+    if (empty() || !localBounds().overlaps(local)) return false;
+
+    const float inverseCell = 1.0f / cellSize;
+    x0 = std::max(static_cast<int32_t>(std::floor((local.min.x - originX()) * inverseCell)), 0);
+    z0 = std::max(static_cast<int32_t>(std::floor((local.min.z - originZ()) * inverseCell)), 0);
+    x1 = std::min(static_cast<int32_t>(std::floor((local.max.x - originX()) * inverseCell)) + 1, columns - 1);
+    z1 = std::min(static_cast<int32_t>(std::floor((local.max.z - originZ()) * inverseCell)) + 1, rows - 1);
+    return x0 < x1 && z0 < z1;
+}
+
+bool Heightfield::surfaceAt(float x, float z, float& surface, Vec3& normal, int32_t& triangle) const {
+    if (empty()) return false;
+
+    float fx = (x - originX()) / cellSize;
+    float fz = (z - originZ()) / cellSize;
+    if (fx < 0.0f || fz < 0.0f || fx > static_cast<float>(columns - 1) || fz > static_cast<float>(rows - 1)) {
+        return false;
+    }
+    int32_t cx = std::min(static_cast<int32_t>(fx), columns - 2);
+    int32_t cz = std::min(static_cast<int32_t>(fz), rows - 2);
+    float u = fx - static_cast<float>(cx);
+    float v = fz - static_cast<float>(cz);
+
+    int32_t tri = u + v <= 1.0f ? 0 : 1;
+    Vec3 t[3];
+    cellTriangle(cx, cz, tri, t);
+    Vec3 n = cross(t[1] - t[0], t[2] - t[0]);
+    normal = n * (1.0f / length(n));
+
+    // Plano del triángulo en (x, z); la normal siempre tiene y > 0
+    surface = t[0].y - (normal.x * (x - t[0].x) + normal.z * (z - t[0].z)) / normal.y;
+    triangle = (cz * (columns - 1) + cx) * 2 + tri;
+    return true;
+}
+
+// Möller-Trumbore por las dos caras
+static bool rayTriangle(Vec3 origin, Vec3 direction, const Vec3 t[3], float& distance) {
+    Vec3 e1 = t[1] - t[0];
+    Vec3 e2 = t[2] - t[0];
+    Vec3 p = cross(direction, e2);
+    float det = dot(e1, p);
+    if (std::fabs(det) < 1e-12f) return false;
+
+    float inverse = 1.0f / det;
+    Vec3 s = origin - t[0];
+    float u = dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) return false;
+    Vec3 q = cross(s, e1);
+    float v = dot(direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) return false;
+
+    distance = dot(e2, q) * inverse;
+    return true;
+}
+
+bool Heightfield::raycast(Vec3 origin, Vec3 direction, float maxDistance, float& distance, Vec3& normal) const {
+    if (empty()) return false;
+
+    // Recorte contra la AABB local (slabs)
+    Bounds bounds = localBounds();
+    float tEnter = 0.0f, tExit = maxDistance;
+    for (int32_t axis = 0; axis < 3; axis++) {
+        float o = axis == 0 ? origin.x : (axis == 1 ? origin.y : origin.z);
+        float d = axis == 0 ? direction.x : (axis == 1 ? direction.y : direction.z);
+        float lo = axis == 0 ? bounds.min.x : (axis == 1 ? bounds.min.y : bounds.min.z);
+        float hi = axis == 0 ? bounds.max.x : (axis == 1 ? bounds.max.y : bounds.max.z);
+        if (std::fabs(d) < 1e-12f) {
+            if (o < lo || o > hi) return false;
+            continue;
+        }
+        float t0 = (lo - o) / d;
+        float t1 = (hi - o) / d;
+        tEnter = std::max(tEnter, std::min(t0, t1));
+        tExit = std::min(tExit, std::max(t0, t1));
+    }
+    if (tEnter > tExit) return false;
+
+    // DDA sobre las celdas en x/z desde el punto de entrada
+    const float ox = originX(), oz = originZ();
+    Vec3 entry = origin + direction * tEnter;
+    int32_t cx = std::clamp(static_cast<int32_t>(std::floor((entry.x - ox) / cellSize)), 0, columns - 2);
+    int32_t cz = std::clamp(static_cast<int32_t>(std::floor((entry.z - oz) / cellSize)), 0, rows - 2);
+
+    const int32_t stepX = direction.x > 0.0f ? 1 : -1;
+    const int32_t stepZ = direction.z > 0.0f ? 1 : -1;
+    const bool movesX = std::fabs(direction.x) > 1e-12f;
+    const bool movesZ = std::fabs(direction.z) > 1e-12f;
+    float tMaxX = movesX ? (ox + static_cast<float>(cx + (stepX > 0 ? 1 : 0)) * cellSize - origin.x) / direction.x : FLT_MAX;
+    float tMaxZ = movesZ ? (oz + static_cast<float>(cz + (stepZ > 0 ? 1 : 0)) * cellSize - origin.z) / direction.z : FLT_MAX;
+    const float tDeltaX = movesX ? cellSize / std::fabs(direction.x) : FLT_MAX;
+    const float tDeltaZ = movesZ ? cellSize / std::fabs(direction.z) : FLT_MAX;
+
+    float tCell = tEnter;
+    while (true) {
+        float tNext = std::min(std::min(tMaxX, tMaxZ), tExit);
+
+        // El rayo entero por encima o por debajo de la celda: ni se prueba
+        float h00 = height(cx, cz), h10 = height(cx + 1, cz);
+        float h01 = height(cx, cz + 1), h11 = height(cx + 1, cz + 1);
+        float cellMin = std::min(std::min(h00, h10), std::min(h01, h11));
+        float cellMax = std::max(std::max(h00, h10), std::max(h01, h11));
+        float yA = origin.y + direction.y * tCell;
+        float yB = origin.y + direction.y * tNext;
+        if (std::min(yA, yB) <= cellMax && std::max(yA, yB) >= cellMin) {
+            float best = FLT_MAX;
+            Vec3 bestNormal = vec3(0.0f, 1.0f, 0.0f);
+            for (int32_t tri = 0; tri < 2; tri++) {
+                Vec3 t[3];
+                cellTriangle(cx, cz, tri, t);
+                float hit;
+                if (rayTriangle(origin, direction, t, hit) && hit >= 0.0f && hit <= maxDistance && hit < best) {
+                    best = hit;
+                    bestNormal = cross(t[1] - t[0], t[2] - t[0]);
+                }
+            }
+            if (best < FLT_MAX) {
+                normal = bestNormal * (1.0f / length(bestNormal));
+                if (dot(normal, direction) > 0.0f) normal = -normal;
+                distance = best;
+                return true;
+            }
+        }
+
+        if (tNext >= tExit) return false;
+        if (tMaxX < tMaxZ) {
+            cx += stepX;
+            tCell = tMaxX;
+            tMaxX += tDeltaX;
+            if (cx < 0 || cx >= columns - 1) return false;
+        } else {
+            cz += stepZ;
+            tCell = tMaxZ;
+            tMaxZ += tDeltaZ;
+            if (cz < 0 || cz >= rows - 1) return false;
+        }
+    }
+}
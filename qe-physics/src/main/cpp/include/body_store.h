@@ -0,0 +1,219 @@
+#ifndef BODY_STORE_H
+#define BODY_STORE_H
+
+#include "physics_types.h"
+#include <vector>
+
+/**
+ * Cuerpos rígidos nativos en SoA
+ *
+ * Indexados por el slot de cuerpo de PhysicsSystem (estable mientras la
+ * entidad exista; los slots libres se reutilizan). La capacidad se redondea a
+ * múltiplo de 4 y el integrador procesa 4 cuerpos por instrucción: los slots
+ * vacíos tienen masa inversa y factores a 0, así que no se mueven.
+ *
+ * Kotlin sólo envía lo que cambió (estado, propiedades, forma, fuerzas) y
+ * sólo recibe los cuerpos que se movieron en el último integrate().
+ *
+ * Los cuerpos dormidos (awake a 0) no integran ni se marcan como movidos; un
+ * grupo de 4 dormidos se salta entero. Cualquier escritura desde Kotlin
+ * (estado, propiedades, forma o una fuerza distinta de 0) los despierta y los
+ * deja en getWokenBodies() para que PhysicsWorld despierte su isla.
+ */
+class BodyStore {
+public:
+    // Estado: posición (3), rotación xyzw (4), velocidad (3), velocidad angular (3)
+    static constexpr int32_t STATE_FLOATS = 13;
+    // Propiedades: masa inversa, inercia inversa local (3), drag, angularDrag,
+    // escala de gravedad, factores lineales (3), factores angulares (3),
+    // modo de colisión (CollisionMode)
+    static constexpr int32_t PROPERTY_FLOATS = 14;
+    // Fuerzas: fuerza (3), torque (3)
+    static constexpr int32_t FORCE_FLOATS = 6;
+    // Forma: offset del centro (3), semiejes locales (3). Cápsula: el eje
+    // mayor es el de la cápsula y el menor el radio. Convexa: semiejes de la
+    // AABB local del hull, con el hull centrado en el offset. Heightfield:
+    // semiejes de la rejilla y del rango de alturas, centrada en el offset.
+    static constexpr int32_t SHAPE_FLOATS = 6;
+    // Material: fricción dinámica, fricción estática, rebote, combinación de
+    // fricción, combinación de rebote, trigger (0/1), capa (0-31) para las
+    // consultas de escena
+    static constexpr int32_t MATERIAL_FLOATS = 7;
+
+    enum ShapeType : int32_t {
+        SHAPE_NONE = -1,
+        SHAPE_SPHERE = 0,
+        SHAPE_BOX = 1,
+        SHAPE_CAPSULE = 2,
+        SHAPE_CONVEX = 3,
+        SHAPE_HEIGHTFIELD = 4,
+        SHAPE_COUNT = 5
+    };
+
+    // CollisionDetectionMode de Kotlin
+    enum CollisionMode : int32_t {
+        COLLISION_DISCRETE = 0,
+        COLLISION_CONTINUOUS = 1,           // continuo contra cuerpos sin masa
+        COLLISION_CONTINUOUS_DYNAMIC = 2    // continuo contra todos
+    };
+
+    void setStates(const int32_t* slots, const float* states, int32_t count);
+    void setProperties(const int32_t* slots, const float* properties, int32_t count);
+    void addForces(const int32_t* slots, const float* forces, int32_t count);
+    void setMaterials(const int32_t* slots, const float* materials, int32_t count);
+
+    /**
+     * @param hull Hull convexo (SHAPE_CONVEX) o heightfield (SHAPE_HEIGHTFIELD)
+     *             de PhysicsWorld, -1 si no
+     * @return true si el tipo de forma cambió
+     */
+    bool setShape(int32_t slot, int32_t type, int32_t hull, const float* shape);
+    void removeBody(int32_t slot);
+
+    /**
+     * Euler semi-implícito en dos fases, con el solver entre medias (una vez
+     * por substep): integrateVelocities() aplica fuerzas, gravedad y drag;
+     * integratePositions() mueve posición y rotación con la velocidad resuelta
+     * y anota los cuerpos que se movieron, que markMoved() pasa a
+     * getChangedBodies(). Las fuerzas se mantienen durante todo el step hasta
+     * clearForces().
+     *
+     * Ambas trabajan sobre los slots [begin, end) (múltiplos de 4) y sólo
+     * escriben en ellos: rangos disjuntos pueden ir en hilos distintos.
+     * markMoved() es secuencial y añade en orden de slot.
+     */
+    void integrateVelocities(float dt, Vec3 gravity, int32_t begin, int32_t end);
+    void integratePositions(float dt, int32_t begin, int32_t end);
+    void markMoved();
+    void clearForces();
+
+    /**
+     * Tiempo en reposo de los cuerpos despiertos: suma dt si la velocidad
+     * efectiva lineal y angular quedan bajo los umbrales, si no vuelve a 0
+     */
+    void updateSleepTimers(float dt, float linearThreshold, float angularThreshold);
+
+    bool isAwake(int32_t slot) const { return awake[slot] != 0.0f; }
+    float getSleepTime(int32_t slot) const { return sleepTime[slot]; }
+
+    /**
+     * Duerme (velocidades a 0) o despierta un cuerpo sin pasar por
+     * getWokenBodies(): lo usa PhysicsWorld con islas enteras
+     */
+    void setAwake(int32_t slot, bool value);
+
+    // Dormidos despertados desde Kotlin desde el último clearWoken()
+    const std::vector<int32_t>& getWokenBodies() const { return wokenBodies; }
+    void clearWoken() { wokenBodies.clear(); }
+
+    // Cuerpos movidos en el step o escritos con setStates()/setShape()
+    const std::vector<int32_t>& getChangedBodies() const { return changedBodies; }
+    void markChanged(int32_t slot);
+    void clearChanged();
+
+    void getState(int32_t slot, float* out) const;
+    Bounds getWorldBounds(int32_t slot) const;
+
+    /**
+     * Escribe STATE_FLOATS floats sin marcar el cuerpo como cambiado ni
+     * despertarlo: poses temporales del rewind de snapshots
+     */
+    void loadState(int32_t slot, const float* state);
+
+    /**
+     * Columna index del estado, en el orden de STATE_FLOATS, con
+     * getCapacity() floats: los snapshots la copian con un memcpy
+     */
+    float* getStateColumn(int32_t index) { return stateColumn(index)->data(); }
+    const float* getStateColumn(int32_t index) const {
+        return const_cast<BodyStore*>(this)->stateColumn(index)->data();
+    }
+
+    /**
+     * Generación de cada slot: impar sin cuerpo (nunca usado o eliminado) y
+     * par cuando se vuelve a escribir. Un estado guardado sólo vale para el
+     * slot si la generación no cambió desde entonces.
+     */
+    const uint32_t* getGenerations() const { return generation.data(); }
+
+    // Acceso por cuerpo (solver, narrowphase)
+    Vec3 getPosition(int32_t slot) const { return vec3(posX[slot], posY[slot], posZ[slot]); }
+    Quat getRotation(int32_t slot) const { return { rotX[slot], rotY[slot], rotZ[slot], rotW[slot] }; }
+    Vec3 getVelocity(int32_t slot) const { return vec3(velX[slot], velY[slot], velZ[slot]); }
+    Vec3 getAngularVelocity(int32_t slot) const { return vec3(angX[slot], angY[slot], angZ[slot]); }
+    float getInvMass(int32_t slot) const { return invMass[slot]; }
+    Vec3 getInvInertia(int32_t slot) const { return vec3(invInertiaX[slot], invInertiaY[slot], invInertiaZ[slot]); }
+    Vec3 getLinearFactor(int32_t slot) const { return vec3(linearFactorX[slot], linearFactorY[slot], linearFactorZ[slot]); }
+    Vec3 getAngularFactor(int32_t slot) const { return vec3(angularFactorX[slot], angularFactorY[slot], angularFactorZ[slot]); }
+    int32_t getCollisionMode(int32_t slot) const { return collisionMode[slot]; }
+    bool isDynamic(int32_t slot) const {
+        return invMass[slot] > 0.0f || invInertiaX[slot] > 0.0f || invInertiaY[slot] > 0.0f || invInertiaZ[slot] > 0.0f;
+    }
+
+    void setPose(int32_t slot, Vec3 position, Quat rotation);
+    void setVelocities(int32_t slot, Vec3 velocity, Vec3 angularVelocity);
+
+    float getFriction(int32_t slot) const { return friction[slot]; }
+    float getStaticFriction(int32_t slot) const { return staticFriction[slot]; }
+    float getRestitution(int32_t slot) const { return restitution[slot]; }
+    int32_t getFrictionCombine(int32_t slot) const { return frictionCombine[slot]; }
+    int32_t getRestitutionCombine(int32_t slot) const { return restitutionCombine[slot]; }
+    bool isTrigger(int32_t slot) const { return trigger[slot] != 0; }
+    int32_t getLayer(int32_t slot) const { return layer[slot]; }
+
+    Vec3 getShapeCenter(int32_t slot) const { return vec3(shapeCenterX[slot], shapeCenterY[slot], shapeCenterZ[slot]); }
+    Vec3 getShapeExtents(int32_t slot) const { return vec3(shapeExtentX[slot], shapeExtentY[slot], shapeExtentZ[slot]); }
+
+    int32_t getShapeType(int32_t slot) const { return shapeType[slot]; }
+    int32_t getShapeHull(int32_t slot) const { return shapeHull[slot]; }
+    int32_t getProxy(int32_t slot) const { return proxy[slot]; }
+    void setProxy(int32_t slot, int32_t id) { proxy[slot] = id; }
+
+    int32_t getCapacity() const { return static_cast<int32_t>(shapeType.size()); }
+
+private:
+    // SoA por slot (capacidad múltiplo de 4)
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> rotX, rotY, rotZ, rotW;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> angX, angY, angZ;
+    std::vector<float> forceX, forceY, forceZ;
+    std::vector<float> torqueX, torqueY, torqueZ;
+    std::vector<float> invMass;
+    std::vector<float> invInertiaX, invInertiaY, invInertiaZ;
+    std::vector<float> drag, angularDrag, gravityScale;
+    std::vector<float> linearFactorX, linearFactorY, linearFactorZ;
+    std::vector<float> angularFactorX, angularFactorY, angularFactorZ;
+    std::vector<uint8_t> collisionMode;
+
+    // Material
+    std::vector<float> friction, staticFriction, restitution;
+    std::vector<int32_t> frictionCombine, restitutionCombine;
+    std::vector<uint8_t> trigger;
+    std::vector<uint8_t> layer;
+
+    // Forma y proxy del broadphase
+    std::vector<int32_t> shapeType;
+    std::vector<int32_t> shapeHull;             // hull o heightfield de PhysicsWorld
+    std::vector<float> shapeCenterX, shapeCenterY, shapeCenterZ;
+    std::vector<float> shapeExtentX, shapeExtentY, shapeExtentZ;
+    std::vector<int32_t> proxy;
+
+    std::vector<uint8_t> changed;
+    std::vector<int32_t> changedBodies;
+    std::vector<uint8_t> movedLanes;            // por grupo de 4: bit por carril movido
+
+    // Sueño: awake 1/0 en float para enmascarar el integrador
+    std::vector<float> awake;
+    std::vector<float> sleepTime;
+    std::vector<int32_t> wokenBodies;
+
+    std::vector<uint32_t> generation;
+
+    void ensureCapacity(int32_t slot);
+    std::vector<float>* stateColumn(int32_t index);
+    void reuse(int32_t slot);
+    void wake(int32_t slot);
+};
+
+#endif // BODY_STORE_H
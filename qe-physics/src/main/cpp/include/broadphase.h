@@ -0,0 +1,71 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include "dynamic_tree.h"
+#include "job_pool.h"
+#include <vector>
+
+/**
+ * Par de proxies cuyas AABBs gordas se solapan (proxyA < proxyB)
+ */
+struct BroadphasePair {
+    int32_t proxyA;
+    int32_t proxyB;
+
+    bool operator<(const BroadphasePair& other) const {
+        return proxyA < other.proxyA || (proxyA == other.proxyA && proxyB < other.proxyB);
+    }
+    bool operator==(const BroadphasePair& other) const {
+        return proxyA == other.proxyA && proxyB == other.proxyB;
+    }
+};
+
+/**
+ * Broadphase incremental sobre DynamicTree
+ *
+ * Mantiene el conjunto persistente de pares solapados: en cada updatePairs()
+ * sólo los proxies reinsertados (que salieron de su AABB gorda) consultan el
+ * árbol, y se descartan los pares que dejaron de solaparse. El coste es
+ * proporcional a lo que se mueve, no al número total de proxies. Las
+ * consultas van en paralelo en el JobPool; el árbol sólo se lee.
+ */
+class Broadphase {
+public:
+    int32_t createProxy(const Bounds& bounds, int32_t userData);
+    void destroyProxy(int32_t proxy);
+    void moveProxy(int32_t proxy, const Bounds& bounds, Vec3 displacement);
+
+    /**
+     * Fuerza a buscar de nuevo los pares del proxy en el siguiente update
+     */
+    void touchProxy(int32_t proxy);
+
+    /**
+     * Actualiza el conjunto de pares: ordenado por (proxyA, proxyB) y sin duplicados
+     */
+    void updatePairs(JobPool& jobs);
+
+    const std::vector<BroadphasePair>& getPairs() const { return pairs; }
+    int32_t getUserData(int32_t proxy) const { return tree.getUserData(proxy); }
+    const Bounds& getFatBounds(int32_t proxy) const { return tree.getFatBounds(proxy); }
+    int32_t getProxyCount() const { return tree.getProxyCount(); }
+    int32_t getTreeHeight() const { return tree.getHeight(); }
+
+    const DynamicTree& getTree() const { return tree; }
+
+private:
+    static constexpr int32_t QUERY_BATCH = 32;
+
+    DynamicTree tree;
+
+    std::vector<int32_t> moveBuffer;
+    std::vector<uint8_t> moved;          // por proxy: está en moveBuffer
+    std::vector<BroadphasePair> pairs;
+    std::vector<BroadphasePair> newPairs;
+    std::vector<std::vector<BroadphasePair>> batchPairs;    // por lote de consultas
+    std::vector<BroadphasePair> merged;
+
+    void bufferMove(int32_t proxy);
+};
+
+#endif // BROADPHASE_H
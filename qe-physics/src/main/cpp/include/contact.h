@@ -0,0 +1,56 @@
+#ifndef CONTACT_H
+#define CONTACT_H
+
+#include "physics_types.h"
+
+/**
+ * Contactos persistentes entre dos cuerpos
+ *
+ * Un manifold por par del broadphase que se toca (o está a menos de
+ * SPECULATIVE_DISTANCE). Los puntos guardan las anclas en espacio local de cada
+ * cuerpo, así la corrección de posición puede recalcular la separación sin
+ * volver a la narrowphase, y un id de feature para emparejarlos con los del
+ * step anterior y reutilizar sus impulsos (warm starting).
+ */
+
+static constexpr int32_t MAX_MANIFOLD_POINTS = 4;
+
+// Distancia a la que ya se generan contactos (especulativos si s > 0)
+static constexpr float SPECULATIVE_DISTANCE = 0.02f;
+
+// Contactos acumulados (GJK/EPA): un punto anterior se descarta si sus anclas
+// se desplazan tangencialmente más de CONTACT_BREAKING_DISTANCE; a menos de
+// CONTACT_MERGE_DISTANCE del punto nuevo, éste lo sustituye y hereda su id
+static constexpr float CONTACT_BREAKING_DISTANCE = 0.02f;
+static constexpr float CONTACT_MERGE_DISTANCE = 0.02f;
+
+struct ContactPoint {
+    Vec3 localA;            // punto en la superficie de A, local de A
+    Vec3 localB;            // punto en la superficie de B, local de B
+    float separation;       // < 0 penetración
+    uint32_t id;            // feature id
+
+    // Impulsos acumulados (warm starting)
+    float normalImpulse;
+    float tangentImpulse1;
+    float tangentImpulse2;
+};
+
+struct Manifold {
+    int32_t bodyA;          // slot, bodyA < bodyB
+    int32_t bodyB;
+    Vec3 localNormal;       // normal de A hacia B, local de A
+    int32_t pointCount;
+    ContactPoint points[MAX_MANIFOLD_POINTS];
+
+    // Material combinado del par
+    float friction;
+    float staticFriction;
+    float restitution;
+
+    bool operator<(const Manifold& other) const {
+        return bodyA < other.bodyA || (bodyA == other.bodyA && bodyB < other.bodyB);
+    }
+};
+
+#endif // CONTACT_H
@@ -0,0 +1,145 @@
+#ifndef CONTACT_SOLVER_H
+#define CONTACT_SOLVER_H
+
+#include "body_store.h"
+#include "contact.h"
+#include "job_pool.h"
+#include <vector>
+
+/**
+ * Solver de contactos por impulsos secuenciales con substeps (soft step)
+ *
+ * Por step: prepare() reúne en AoS los cuerpos que tocan algún manifold, fija
+ * normales, anclas y masas efectivas, y colorea los manifolds (greedy sobre el
+ * grafo de cuerpos dinámicos: dos manifolds del mismo color nunca comparten
+ * cuerpo dinámico). Después, por substep, PhysicsWorld integra velocidades,
+ * llama a warmStart() y solve(true), integra posiciones y relaja con
+ * solve(false); al final applyRestitution() y storeImpulses().
+ *
+ * La penetración se corrige con contactos blandos (muelle amortiguado a
+ * CONTACT_HERTZ) en vez de Baumgarte rígido o NGS: la corrección no mete
+ * energía y el paso de relajación quita la velocidad que añadió, lo que
+ * mantiene estables las pilas a 30Hz. La separación se recalcula en cada
+ * iteración desde las poses actuales, sin volver a la narrowphase.
+ *
+ * Los colores se resuelven en orden y los manifolds de un color son
+ * independientes entre sí: cada color se reparte por lotes en el JobPool y
+ * el resultado no depende del número de hilos. El último color recoge los
+ * que no caben en MAX_COLORS y va en un solo hilo.
+ */
+class ContactSolver {
+public:
+    static constexpr int32_t MAX_COLORS = 64;
+
+    // Lotes del JobPool
+    static constexpr int32_t BODY_BATCH = 128;
+    static constexpr int32_t MANIFOLD_BATCH = 32;
+
+    // Penetración permitida: mantiene los contactos en reposo entre steps
+    static constexpr float LINEAR_SLOP = 0.005f;
+
+    // Contactos blandos: frecuencia máxima (Hz) y amortiguamiento relativo
+    static constexpr float CONTACT_HERTZ = 30.0f;
+    static constexpr float CONTACT_DAMPING_RATIO = 10.0f;
+    // Velocidad máxima con la que se separa una penetración (m/s)
+    static constexpr float MAX_PUSHOUT_SPEED = 3.0f;
+
+    // Rebote sólo por encima de esta velocidad de aproximación (m/s)
+    static constexpr float RESTITUTION_THRESHOLD = 1.0f;
+    // Fricción estática por debajo de esta velocidad tangencial (m/s)
+    static constexpr float STATIC_FRICTION_SPEED = 0.05f;
+
+    /**
+     * Los manifolds sin ningún cuerpo despierto se quedan fuera del step
+     *
+     * @param h Duración de un substep
+     */
+    void prepare(const BodyStore& bodies, const std::vector<Manifold>& manifolds, float h);
+
+    /**
+     * Copia velocidades y poses actuales de BodyStore (tras cada integración)
+     * y devuelve las velocidades resueltas
+     */
+    void loadBodies(const BodyStore& bodies, JobPool& jobs);
+    void storeVelocities(BodyStore& bodies, JobPool& jobs) const;
+
+    void warmStart(JobPool& jobs);
+
+    /**
+     * @param useBias true: corrige penetración con el contacto blando;
+     *                false: relajación, sólo restricciones de velocidad
+     */
+    void solve(bool useBias, JobPool& jobs);
+
+    void applyRestitution(JobPool& jobs);
+
+    /** Impulsos acumulados a los manifolds para el warm starting del siguiente step */
+    void storeImpulses(std::vector<Manifold>& manifolds) const;
+
+    int32_t getColorCount() const { return colorCount; }
+
+private:
+    struct SolverBody {
+        Vec3 velocity;
+        Vec3 angularVelocity;
+        Vec3 position;
+        Quat rotation;
+        Vec3 invMass;           // masa inversa por eje (factores lineales)
+        Mat3 invInertia;        // world, proyectada con los factores angulares
+        int32_t slot;
+        bool dynamic;
+    };
+
+    struct SolverPoint {
+        Vec3 anchorA;           // punto de contacto relativo a cada cuerpo (fijo en el step)
+        Vec3 anchorB;
+        Vec3 localA;            // para recalcular la separación con las poses actuales
+        Vec3 localB;
+        float normalMass;
+        float tangentMass1;
+        float tangentMass2;
+        float relativeVelocity; // vn al preparar, para la restitución
+        float normalImpulse;
+        float tangentImpulse1;
+        float tangentImpulse2;
+        float maxNormalImpulse;
+    };
+
+    struct SolverManifold {
+        int32_t manifold;       // índice en el vector de prepare()
+        int32_t bodyA;          // índice en solverBodies
+        int32_t bodyB;
+        Vec3 normal;
+        Vec3 tangent1;
+        Vec3 tangent2;
+        float friction;
+        float restitution;
+        // Contacto blando (más rígido contra estáticos)
+        float biasRate;
+        float massScale;
+        float impulseScale;
+        int32_t pointCount;
+        SolverPoint points[MAX_MANIFOLD_POINTS];
+    };
+
+    std::vector<SolverBody> solverBodies;
+    std::vector<SolverManifold> solverManifolds;
+    std::vector<int32_t> bodyIndex;             // slot -> solverBodies, -1 si no está
+    std::vector<uint64_t> bodyColors;           // colores usados por cuerpo
+    float invH = 0.0f;
+
+    // Manifolds ordenados por color; color c en [colorOffsets[c], colorOffsets[c + 1])
+    std::vector<int32_t> colorOrder;
+    std::vector<int32_t> manifoldColors;
+    int32_t colorOffsets[MAX_COLORS + 2] = {};
+    int32_t colorCount = 0;
+
+    int32_t addBody(const BodyStore& bodies, int32_t slot);
+    void colorManifolds();
+    void solveManifold(SolverManifold& manifold, bool useBias);
+
+    template <typename F>
+    void forEachColor(JobPool& jobs, F&& body);
+};
+
+#endif // CONTACT_SOLVER_H
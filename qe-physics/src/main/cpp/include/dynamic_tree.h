@@ -0,0 +1,180 @@
+#ifndef DYNAMIC_TREE_H
+#define DYNAMIC_TREE_H
+
+#include "physics_types.h"
+#include <algorithm>
+#include <vector>
+
+/**
+ * Árbol dinámico de AABBs (BVH incremental)
+ *
+ * Cada proxy guarda una AABB "gorda" (margen + desplazamiento previsto), así
+ * un cuerpo que se mueve poco no toca el árbol. Al salirse se reinserta con
+ * la heurística de superficie (SAH) y en la subida se aplican rotaciones que
+ * reducen el área de los nodos internos, así las consultas siguen siendo
+ * baratas aunque se mezclen objetos enormes y diminutos.
+ *
+ * Los ids de proxy son índices de nodo estables mientras el proxy exista.
+ */
+class DynamicTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    // Margen fijo y factor del desplazamiento previsto de las AABBs gordas
+    static constexpr float FAT_MARGIN = 0.1f;
+    static constexpr float DISPLACEMENT_MULTIPLIER = 4.0f;
+    static constexpr int32_t QUERY_STACK_SIZE = 256;
+
+    DynamicTree();
+
+    int32_t createProxy(const Bounds& bounds, int32_t userData);
+    void destroyProxy(int32_t proxy);
+
+    /**
+     * Actualiza la AABB del proxy. Devuelve true si se salió de su AABB gorda
+     * y se reinsertó (sólo entonces puede tener pares nuevos).
+     */
+    bool moveProxy(int32_t proxy, const Bounds& bounds, Vec3 displacement);
+
+    const Bounds& getFatBounds(int32_t proxy) const { return nodes[proxy].bounds; }
+    int32_t getUserData(int32_t proxy) const { return nodes[proxy].userData; }
+
+    int32_t getProxyCount() const { return proxyCount; }
+    int32_t getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+    /**
+     * Llama a callback(proxy) por cada hoja cuya AABB gorda solapa bounds.
+     * Si callback devuelve false la búsqueda se detiene.
+     */
+    template <typename Callback>
+    void query(const Bounds& bounds, Callback&& callback) const;
+
+    /**
+     * Hojas cuya AABB gorda, ampliada en extents, cruza el segmento
+     * origin + direction · t con t en [0, maxDistance]: con extents la AABB
+     * de una forma centrada en origin, las que puede tocar al barrerla.
+     * callback(proxy, maxDistance) devuelve la nueva distancia máxima (la
+     * del impacto para quedarse con el más cercano, < 0 para parar).
+     */
+    template <typename Callback>
+    void raycast(Vec3 origin, Vec3 direction, float maxDistance, Vec3 extents, Callback&& callback) const;
+
+private:
+    struct Node {
+        Bounds bounds;
+        int32_t parent;      // o siguiente libre
+        int32_t child1;
+        int32_t child2;
+        int32_t height;      // 0 = hoja, -1 = libre
+        int32_t userData;
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    int32_t proxyCount = 0;
+
+    int32_t allocateNode();
+    void freeNode(int32_t node);
+    int32_t findBestSibling(const Bounds& leafBounds) const;
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    void refit(int32_t node);
+    void rotate(int32_t node);
+    void swapChild(int32_t node, int32_t child, int32_t other, int32_t grandChild);
+    void swapGrandChildren(int32_t nodeX, int32_t x, int32_t nodeY, int32_t y);
+    Bounds fatten(const Bounds& bounds, Vec3 displacement) const;
+};
+
+template <typename Callback>
+void DynamicTree::query(const Bounds& bounds, Callback&& callback) const {
+    if (root == NULL_NODE) return;
+
+    // Pila en stack; las rotaciones SAH no acotan la altura, así que si se
+    // llena se pasa al heap
+    int32_t fixedStack[QUERY_STACK_SIZE];
+    std::vector<int32_t> heapStack;
+    int32_t* stack = fixedStack;
+    int32_t capacity = QUERY_STACK_SIZE;
+    int32_t top = 0;
+    stack[top++] = root;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!node.bounds.overlaps(bounds)) continue;
+
+        if (node.isLeaf()) {
+            if (!callback(static_cast<int32_t>(&node - nodes.data()))) return;
+            continue;
+        }
+
+        if (top + 2 > capacity) {
+            heapStack.resize(capacity * 2);
+            if (stack == fixedStack) {
+                std::copy(fixedStack, fixedStack + top, heapStack.begin());
+            }
+            stack = heapStack.data();
+            capacity *= 2;
+        }
+        stack[top++] = node.child1;
+        stack[top++] = node.child2;
+    }
+}
+
+// Slabs contra la AABB ampliada; inverse con componentes enormes en vez de
+// infinitas para que un rayo paralelo a una cara no dé NaN
+static inline bool segmentHitsBounds(Vec3 origin, Vec3 inverse, float maxDistance, const Bounds& bounds,
+                                     Vec3 extents) {
+    Vec3 a = bounds.min - extents - origin;
+    Vec3 b = bounds.max + extents - origin;
+    Vec3 t0 = vec3(a.x * inverse.x, a.y * inverse.y, a.z * inverse.z);
+    Vec3 t1 = vec3(b.x * inverse.x, b.y * inverse.y, b.z * inverse.z);
+    Vec3 lo = vmin(t0, t1);
+    Vec3 hi = vmax(t0, t1);
+    float enter = std::max(std::max(lo.x, lo.y), std::max(lo.z, 0.0f));
+    float exit = std::min(std::min(hi.x, hi.y), std::min(hi.z, maxDistance));
+    return enter <= exit;
+}
+
+template <typename Callback>
+void DynamicTree::raycast(Vec3 origin, Vec3 direction, float maxDistance, Vec3 extents, Callback&& callback) const {
+    if (root == NULL_NODE) return;
+
+    const float HUGE_INVERSE = 1e30f;
+    Vec3 inverse = vec3(direction.x != 0.0f ? 1.0f / direction.x : HUGE_INVERSE,
+                        direction.y != 0.0f ? 1.0f / direction.y : HUGE_INVERSE,
+                        direction.z != 0.0f ? 1.0f / direction.z : HUGE_INVERSE);
+
+    int32_t fixedStack[QUERY_STACK_SIZE];
+    std::vector<int32_t> heapStack;
+    int32_t* stack = fixedStack;
+    int32_t capacity = QUERY_STACK_SIZE;
+    int32_t top = 0;
+    stack[top++] = root;
+
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        if (!segmentHitsBounds(origin, inverse, maxDistance, node.bounds, extents)) continue;
+
+        if (node.isLeaf()) {
+            maxDistance = callback(static_cast<int32_t>(&node - nodes.data()), maxDistance);
+            if (maxDistance < 0.0f) return;
+            continue;
+        }
+
+        if (top + 2 > capacity) {
+            heapStack.resize(capacity * 2);
+            if (stack == fixedStack) {
+                std::copy(fixedStack, fixedStack + top, heapStack.begin());
+            }
+            stack = heapStack.data();
+            capacity *= 2;
+        }
+        stack[top++] = node.child1;
+        stack[top++] = node.child2;
+    }
+}
+
+#endif // DYNAMIC_TREE_H
@@ -0,0 +1,71 @@
+#ifndef GJK_H
+#define GJK_H
+
+#include "physics_types.h"
+
+/**
+ * Forma convexa por función soporte para GJK/EPA
+ *
+ * Núcleo (punto, segmento, caja o nube de vértices) más un radio: esferas y
+ * cápsulas son un punto y un segmento con radio. GJK trabaja sobre los
+ * núcleos y el radio se suma después, así los contactos poco profundos de
+ * formas redondeadas no necesitan EPA.
+ */
+struct SupportShape {
+    enum Core : int32_t {
+        CORE_POINT = 0,
+        CORE_SEGMENT = 1,
+        CORE_BOX = 2,
+        CORE_HULL = 3
+    };
+
+    int32_t core;
+    Vec3 position;
+    Quat rotation;
+    Vec3 extents;               // caja: semiejes; segmento: medio segmento (local)
+    const Vec3* vertices;       // hull: vértices locales
+    int32_t vertexCount;
+    float radius;
+
+    /** Punto del núcleo más lejano en direction (world) */
+    Vec3 support(Vec3 direction) const;
+};
+
+struct GjkVertex {
+    Vec3 w;                     // a - b
+    Vec3 a;
+    Vec3 b;
+    float lambda;               // coordenada baricéntrica del punto más cercano
+};
+
+struct GjkSimplex {
+    GjkVertex vertices[4];
+    int32_t count;
+};
+
+struct GjkResult {
+    Vec3 pointA;                // puntos más cercanos entre núcleos
+    Vec3 pointB;
+    float distance;
+    int32_t iterations;
+};
+
+/**
+ * Distancia entre núcleos
+ *
+ * @param simplex Simplex final; si hay solape contiene el origen y es el
+ *                punto de partida de epaPenetration()
+ * @return true si los núcleos se solapan (distance 0)
+ */
+bool gjkDistance(const SupportShape& a, const SupportShape& b, GjkSimplex& simplex, GjkResult& out);
+
+/**
+ * Penetración entre núcleos solapados (Expanding Polytope Algorithm)
+ *
+ * @param normal Normal de A hacia B: desplazar B depth a lo largo de ella los separa
+ * @return false si el simplex es degenerado y no se pudo expandir
+ */
+bool epaPenetration(const SupportShape& a, const SupportShape& b, GjkSimplex& simplex,
+                    Vec3& normal, float& depth, Vec3& pointA, Vec3& pointB);
+
+#endif // GJK_H
@@ -0,0 +1,82 @@
+#ifndef HEIGHTFIELD_H
+#define HEIGHTFIELD_H
+
+#include "physics_types.h"
+#include <vector>
+
+/**
+ * Heightfield de terreno con alturas cuantizadas a 16 bits
+ *
+ * Rejilla de columns × rows muestras (x, z) separadas cellSize, centrada en
+ * el centro de la forma: la muestra (0, 0) está en
+ * (-(columns - 1) · cellSize / 2, h, -(rows - 1) · cellSize / 2). Las
+ * alturas se guardan como minHeight + q · heightScale, 2 bytes por muestra
+ * en vez de los 36 de dos triángulos de malla por celda.
+ *
+ * Cada celda son dos triángulos con la normal hacia +y, partidos por la
+ * diagonal (x, z + 1) - (x + 1, z):
+ *   0: (x, z), (x, z + 1), (x + 1, z)
+ *   1: (x + 1, z), (x, z + 1), (x + 1, z + 1)
+ *
+ * Todo en el espacio local de la forma; PhysicsWorld aplica la pose del cuerpo.
+ */
+struct Heightfield {
+    int32_t columns = 0;            // muestras en x
+    int32_t rows = 0;               // muestras en z
+    float cellSize = 1.0f;
+    float minHeight = 0.0f;
+    float heightScale = 0.0f;       // metros por paso de cuantización
+    std::vector<uint16_t> samples;  // fila z, columna x
+
+    /**
+     * Cuantiza columns × rows alturas (heights[z * columns + x]); con
+     * menos de 2 × 2 muestras queda vacío y libera la memoria
+     */
+    void build(const float* heights, int32_t columns, int32_t rows, float cellSize);
+    void clear();
+    bool empty() const { return columns < 2 || rows < 2; }
+
+    float originX() const { return -0.5f * static_cast<float>(columns - 1) * cellSize; }
+    float originZ() const { return -0.5f * static_cast<float>(rows - 1) * cellSize; }
+
+    float height(int32_t x, int32_t z) const {
+        return minHeight + static_cast<float>(samples[z * columns + x]) * heightScale;
+    }
+
+    Vec3 vertex(int32_t x, int32_t z) const {
+        return vec3(originX() + static_cast<float>(x) * cellSize, height(x, z),
+                    originZ() + static_cast<float>(z) * cellSize);
+    }
+
+    /** Vértices del triángulo tri (0/1) de la celda (x, z) */
+    void cellTriangle(int32_t x, int32_t z, int32_t tri, Vec3 out[3]) const;
+
+    /**
+     * Celdas [x0, x1) × [z0, z1) bajo la AABB local
+     *
+     * @return false si no toca ninguna (fuera de la rejilla o del rango de alturas)
+     */
+    bool cellRange(const Bounds& local, int32_t& x0, int32_t& z0, int32_t& x1, int32_t& z1) const;
+
+    /**
+     * Triángulo bajo el punto local (x, z) y su altura
+     *
+     * @return false fuera de la rejilla
+     */
+    bool surfaceAt(float x, float z, float& height, Vec3& normal, int32_t& cell) const;
+
+    /**
+     * Rayo local: recorre las celdas que cruza la proyección del rayo en x/z
+     * (DDA), descarta las que el rayo pasa por encima o por debajo de sus 4
+     * alturas y prueba sus dos triángulos. La primera celda con impacto es
+     * la más cercana.
+     *
+     * @param direction Normalizada
+     * @return false sin impacto antes de maxDistance
+     */
+    bool raycast(Vec3 origin, Vec3 direction, float maxDistance, float& distance, Vec3& normal) const;
+
+    Bounds localBounds() const;
+};
+
+#endif // HEIGHTFIELD_H
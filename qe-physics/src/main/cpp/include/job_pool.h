@@ -0,0 +1,115 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include "job_scheduler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Pool de workers nativo con colas por worker y robo de trabajo
+ *
+ * parallelFor() parte [0, count) en lotes de tamaño fijo, los reparte
+ * round-robin entre las colas (una por worker más la del hilo que llama) y
+ * trabaja también hasta que se terminan todos. Cada hilo saca de su cola por
+ * detrás y, sin trabajo propio, roba por delante de las demás.
+ *
+ * El reparto en lotes no depende del número de hilos: si cada lote escribe
+ * sólo en salidas indexadas por elemento o por lote y las uniones se hacen
+ * después en orden, el resultado es idéntico con cualquier número de workers
+ * (0 = todo en el hilo que llama). Un solo parallelFor a la vez, sin anidar.
+ *
+ * Con setScheduler() los workers propios se paran y parallelFor() reparte
+ * los mismos lotes en el JobScheduler compartido del motor (libquantum_core).
+ */
+class JobPool {
+public:
+    /**
+     * @param workerCount Hilos además del que llama; -1 = núcleos - 1, hasta MAX_DEFAULT_WORKERS
+     */
+    explicit JobPool(int32_t workerCount = -1);
+    ~JobPool();
+
+    JobPool(const JobPool&) = delete;
+    JobPool& operator=(const JobPool&) = delete;
+
+    static constexpr int32_t MAX_DEFAULT_WORKERS = 3;
+
+    /** Para los workers actuales y arranca count nuevos (-1: por defecto); deja el scheduler compartido */
+    void setWorkerCount(int32_t count);
+    int32_t getWorkerCount() const {
+        return scheduler ? scheduler->getWorkerCount() : static_cast<int32_t>(workers.size());
+    }
+
+    /** Scheduler compartido en lugar de workers propios; nullptr vuelve a los propios */
+    void setScheduler(JobScheduler* shared);
+
+    /**
+     * body(begin, end) para cada lote de batchSize elementos de [0, count)
+     */
+    template <typename F>
+    void parallelFor(int32_t count, int32_t batchSize, F&& body) {
+        if (count <= 0) return;
+        batchSize = batchSize > 0 ? batchSize : 1;
+
+        if (scheduler) {
+            scheduler->parallelFor(count, batchSize, body);
+            return;
+        }
+
+        // Sin workers o un solo lote: mismos lotes, en orden, sin sincronizar
+        if (workers.empty() || count <= batchSize) {
+            for (int32_t begin = 0; begin < count; begin += batchSize) {
+                body(begin, begin + batchSize < count ? begin + batchSize : count);
+            }
+            return;
+        }
+
+        using Body = typename std::remove_reference<F>::type;
+        run(count, batchSize, [](void* context, int32_t begin, int32_t end) {
+            (*static_cast<Body*>(context))(begin, end);
+        }, const_cast<void*>(static_cast<const void*>(&body)));
+    }
+
+private:
+    typedef void (*BatchFunction)(void* context, int32_t begin, int32_t end);
+
+    struct Batch {
+        int32_t begin;
+        int32_t end;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Batch> batches;
+    };
+
+    JobScheduler* scheduler = nullptr;
+    int32_t ownWorkerCount = -1;
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;     // workers + hilo que llama (último)
+
+    // Trabajo en curso
+    BatchFunction function = nullptr;
+    void* context = nullptr;
+    std::atomic<int32_t> remaining{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    void run(int32_t count, int32_t batchSize, BatchFunction batchFunction, void* batchContext);
+    void workerLoop(int32_t index);
+    bool popBatch(int32_t index, Batch& out);
+    void runBatches(int32_t index);
+    void stopWorkers();
+};
+
+#endif // JOB_POOL_H
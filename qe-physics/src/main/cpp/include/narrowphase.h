@@ -0,0 +1,93 @@
+#ifndef NARROWPHASE_H
+#define NARROWPHASE_H
+
+#include "contact.h"
+#include "heightfield.h"
+#include <vector>
+
+/**
+ * Envolvente convexa: vértices locales centrados en el centro de la forma
+ */
+struct ConvexHull {
+    std::vector<Vec3> vertices;
+};
+
+/**
+ * Forma de un cuerpo en world para la narrowphase
+ */
+struct ShapeInstance {
+    int32_t type;           // BodyStore::ShapeType
+    Vec3 position;          // centro de la forma (posición + offset rotado)
+    Quat rotation;
+    Vec3 extents;           // semiejes locales (esfera: radio en x)
+    const ConvexHull* hull; // SHAPE_CONVEX; sin hull se trata como su caja
+    const Heightfield* heightfield; // SHAPE_HEIGHTFIELD; sin muestras no colisiona
+};
+
+/**
+ * Contactos de un par en world: normal de A hacia B y, por punto, el punto
+ * medio entre las dos superficies y la separación
+ */
+struct ContactResult {
+    Vec3 normal;
+    int32_t pointCount;
+    Vec3 points[MAX_MANIFOLD_POINTS];
+    float separations[MAX_MANIFOLD_POINTS];
+    uint32_t ids[MAX_MANIFOLD_POINTS];
+    // GJK/EPA da un único punto por step: PhysicsWorld lo acumula con los
+    // puntos aún válidos del manifold anterior
+    bool incremental;
+};
+
+/**
+ * Narrowphase por tabla de funciones [tipoA][tipoB]:
+ * - esfera-esfera, esfera-caja, esfera-cápsula y cápsula-cápsula analíticos
+ * - caja-caja por SAT de caras con recorte de la cara incidente
+ * - cápsula-caja por GJK/EPA sobre el segmento, recortado contra la cara
+ *   cuando el segmento queda paralelo a ella (dos puntos)
+ * - convexas contra cualquier forma por GJK (separadas) o EPA (solapadas)
+ * - cualquier forma contra heightfield por triángulos de las celdas que
+ *   cubre, de una cara (hacia +y local), más los vértices del núcleo
+ *   contra la superficie bajo ellos
+ *
+ * @param margin Separación máxima a la que se generan puntos
+ * @return true si hay al menos un punto
+ */
+bool collideShapes(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out);
+
+/**
+ * Tiempo de impacto por avance conservador (CCD)
+ *
+ * A va de a0 a a1 (centro lineal, rotación nlerp) con B quieto. t avanza la
+ * distancia GJK entre superficies dividida por la cota de acercamiento
+ * (traslación sobre la normal más giro por el radio envolvente) hasta quedar
+ * a menos de target.
+ *
+ * Contra un heightfield (no convexo) el centro de A recorre la rejilla por
+ * raycast y se detiene a su semieje menor de la superficie.
+ *
+ * @return t en [0, 1); 1 si no llega a target o si ya estaba a menos de
+ *         target en t = 0 (de eso se encarga la narrowphase discreta)
+ */
+float timeOfImpact(const ShapeInstance& a0, const ShapeInstance& a1, const ShapeInstance& b, float target);
+
+/** AABB world de la forma (heightfield: la de su rejilla entera) */
+Bounds shapeBounds(const ShapeInstance& shape);
+
+/**
+ * Deja como mucho MAX_MANIFOLD_POINTS de count: el más profundo, el más
+ * lejano a él y los dos que más área añaden a cada lado de esa diagonal
+ */
+void reduceContacts(const Vec3* points, const float* separations, const uint32_t* ids, int32_t count,
+                    Vec3 normal, ContactResult& out);
+
+/**
+ * Rendimiento de collideShapes() para un par de tipos sobre count pares
+ * aleatorios a distancias en torno al contacto
+ *
+ * @return Mediana de iterations pasadas en ns por par; hitRatio: fracción con contacto
+ */
+float benchmarkNarrowphase(int32_t typeA, int32_t typeB, int32_t count, int32_t iterations,
+                           uint32_t seed, float& hitRatio);
+
+#endif // NARROWPHASE_H
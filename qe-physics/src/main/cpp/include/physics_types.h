@@ -0,0 +1,111 @@
+#ifndef PHYSICS_TYPES_H
+#define PHYSICS_TYPES_H
+
+#include <cmath>
+#include <cstdint>
+
+/**
+ * Tipos básicos de la física nativa
+ *
+ * Vec3 es un POD de 3 floats con operadores inline; los datos en bloque
+ * (cuerpos, contactos) se guardan en SoA y sólo usan Vec3 en los cálculos
+ * por elemento.
+ */
+
+struct Vec3 {
+    float x, y, z;
+};
+
+inline Vec3 vec3(float x, float y, float z) { return { x, y, z }; }
+inline Vec3 operator+(Vec3 a, Vec3 b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+inline Vec3 operator-(Vec3 a, Vec3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+inline Vec3 operator-(Vec3 a) { return { -a.x, -a.y, -a.z }; }
+inline Vec3 operator*(Vec3 a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+inline Vec3 operator*(float s, Vec3 a) { return { a.x * s, a.y * s, a.z * s }; }
+inline Vec3& operator+=(Vec3& a, Vec3 b) { a.x += b.x; a.y += b.y; a.z += b.z; return a; }
+inline Vec3& operator-=(Vec3& a, Vec3 b) { a.x -= b.x; a.y -= b.y; a.z -= b.z; return a; }
+inline float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3 cross(Vec3 a, Vec3 b) {
+    return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+inline float lengthSq(Vec3 a) { return dot(a, a); }
+inline float length(Vec3 a) { return std::sqrt(dot(a, a)); }
+inline Vec3 vmin(Vec3 a, Vec3 b) { return { std::fmin(a.x, b.x), std::fmin(a.y, b.y), std::fmin(a.z, b.z) }; }
+inline Vec3 vmax(Vec3 a, Vec3 b) { return { std::fmax(a.x, b.x), std::fmax(a.y, b.y), std::fmax(a.z, b.z) }; }
+
+inline Vec3 vabs(Vec3 a) { return { std::fabs(a.x), std::fabs(a.y), std::fabs(a.z) }; }
+
+/**
+ * Quaternion xyzw (mismo orden que Quaternion de Kotlin)
+ */
+struct Quat {
+    float x, y, z, w;
+};
+
+inline Quat conjugate(Quat q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+// v' = v + w·t + q × t, con t = 2 (q × v)
+inline Vec3 rotate(Quat q, Vec3 v) {
+    Vec3 u = { q.x, q.y, q.z };
+    Vec3 t = cross(u, v) * 2.0f;
+    return v + t * q.w + cross(u, t);
+}
+
+// Interpolación normalizada por el camino corto (CCD)
+inline Quat nlerp(Quat a, Quat b, float t) {
+    float sign = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w < 0.0f ? -1.0f : 1.0f;
+    Quat q = {
+        a.x + (sign * b.x - a.x) * t,
+        a.y + (sign * b.y - a.y) * t,
+        a.z + (sign * b.z - a.z) * t,
+        a.w + (sign * b.w - a.w) * t
+    };
+    float invLength = 1.0f / std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return { q.x * invLength, q.y * invLength, q.z * invLength, q.w * invLength };
+}
+
+// Ángulo de la rotación de a a b (radianes)
+inline float rotationAngle(Quat a, Quat b) {
+    float cosHalf = std::fabs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+    return 2.0f * std::acos(cosHalf < 1.0f ? cosHalf : 1.0f);
+}
+
+/**
+ * Matriz 3x3 por columnas (inercia inversa en world)
+ */
+struct Mat3 {
+    Vec3 c0, c1, c2;
+};
+
+inline Vec3 operator*(const Mat3& m, Vec3 v) { return m.c0 * v.x + m.c1 * v.y + m.c2 * v.z; }
+
+/**
+ * AABB (min / max)
+ */
+struct Bounds {
+    Vec3 min;
+    Vec3 max;
+
+    bool overlaps(const Bounds& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y &&
+               min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    bool contains(const Bounds& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    // Mitad de la superficie (coste SAH del árbol)
+    float halfArea() const {
+        float dx = max.x - min.x, dy = max.y - min.y, dz = max.z - min.z;
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    static Bounds merge(const Bounds& a, const Bounds& b) {
+        return { vmin(a.min, b.min), vmax(a.max, b.max) };
+    }
+};
+
+#endif // PHYSICS_TYPES_H
@@ -0,0 +1,287 @@
+#ifndef PHYSICS_WORLD_H
+#define PHYSICS_WORLD_H
+
+#include "body_store.h"
+#include "broadphase.h"
+#include "contact_solver.h"
+#include "job_pool.h"
+#include "narrowphase.h"
+#include "scene_query.h"
+#include "snapshot_ring.h"
+#include <vector>
+
+/**
+ * Mundo físico nativo
+ *
+ * Dueño del estado de la simulación que vive en nativo: los cuerpos en SoA,
+ * el broadphase y los manifolds de contacto persistentes. Cuerpos y proxies se identifican por el slot de cuerpo de
+ * PhysicsSystem (userData de cada proxy).
+ *
+ * Islas: al final de cada step, union-find sobre los cuerpos dinámicos
+ * despiertos unidos por manifolds o joints (los estáticos no unen islas). Una
+ * isla cuyos cuerpos llevan todos timeToSleep en reposo se duerme entera y
+ * se guarda su lista de cuerpos; dormida no integra, no mueve proxies, no
+ * pasa por la narrowphase (conserva sus manifolds) ni por el solver. Se
+ * despierta entera cuando un cuerpo despierto la toca o une por joint, al
+ * escribir cualquiera de sus cuerpos desde Kotlin, con wakeBody() o al
+ * eliminar un cuerpo que la tocaba.
+ *
+ * Snapshots: captureSnapshot() guarda el estado de todos los cuerpos en un
+ * anillo por timestamp. rewind() lleva sólo los cuerpos indicados a un
+ * instante pasado para validar impactos contra el broadphase y endRewind()
+ * los devuelve; restoreSnapshot() hace rollback del mundo entero.
+ *
+ * Consultas de escena: queryScene() resuelve lotes de rayos, barridos y
+ * solapes contra el árbol del broadphase, repartidos en el JobPool.
+ *
+ * Hilos: la narrowphase por lotes de pares, la integración por grupos de
+ * cuerpos, el solver por colores, las AABB de los proxies y las consultas
+ * de pares del broadphase se reparten en un JobPool (workers propios o el
+ * JobScheduler compartido del motor). Cada lote escribe en su casilla y
+ * las uniones son secuenciales en orden, así que el step da el mismo
+ * resultado con cualquier número de workers.
+ */
+class PhysicsWorld {
+public:
+    BodyStore& getBodies() { return bodies; }
+
+    /** Workers además del hilo que llama a step(); -1 = por defecto según núcleos */
+    void setWorkerCount(int32_t count) { jobs.setWorkerCount(count); }
+    int32_t getWorkerCount() const { return jobs.getWorkerCount(); }
+
+    /** Step en el scheduler compartido del motor (nullptr: workers propios) */
+    void setJobScheduler(JobScheduler* scheduler) { jobs.setScheduler(scheduler); }
+    Broadphase& getBroadphase() { return broadphase; }
+
+    /**
+     * Cambia la forma de un cuerpo; SHAPE_NONE le quita el proxy
+     *
+     * @param hull Índice de setConvexHull() para SHAPE_CONVEX o de
+     *             setHeightfield() para SHAPE_HEIGHTFIELD, -1 si no
+     */
+    void setShape(int32_t slot, int32_t type, int32_t hull, const float* shape);
+
+    /**
+     * Sube (o reemplaza) la envolvente convexa hull: count vértices xyz
+     * locales, centrados en el centro de la forma
+     */
+    void setConvexHull(int32_t hull, const float* vertices, int32_t count);
+
+    /**
+     * Sube (o reemplaza) el heightfield index: columns × rows alturas
+     * (heights[z * columns + x]) relativas al centro de la forma, separadas
+     * cellSize. Con menos de 2 × 2 se libera (chunk descargado) y los
+     * cuerpos que lo usan dejan de colisionar.
+     */
+    void setHeightfield(int32_t index, const float* heights, int32_t columns, int32_t rows, float cellSize);
+
+    /**
+     * Raycast world contra el heightfield del cuerpo slot por recorrido de celdas
+     *
+     * @param direction Normalizada
+     * @return false si el cuerpo no es un heightfield o no hay impacto
+     */
+    bool raycastHeightfield(int32_t slot, Vec3 origin, Vec3 direction, float maxDistance,
+                            float& distance, Vec3& normal) const;
+
+    /**
+     * count rayos (origen xyz, dirección normalizada xyz) contra el
+     * heightfield del cuerpo slot
+     *
+     * @param distances Distancia de impacto de cada rayo, -1 si no hay
+     */
+    void raycastHeightfieldBatch(int32_t slot, const float* rays, int32_t count, const float* maxDistances,
+                                 float* distances) const;
+    void removeBody(int32_t slot);
+
+    /**
+     * Step fijo: contactos de los pares actuales (despertando las islas que
+     * toquen) y, por substep, velocidades, solver, posiciones y relajación; al
+     * final rebotes, CCD de los cuerpos continuos, islas que se duermen y
+     * proxies y pares de los cuerpos cambiados. Los cuerpos cambiados quedan en
+     * getChangedSlots()/getChangedStates() para devolverlos a Kotlin.
+     *
+     * @param subSteps Substeps del solver (una iteración de contactos cada uno)
+     * @return Número de cuerpos cambiados
+     */
+    int32_t step(float dt, Vec3 gravity, int32_t subSteps);
+
+    const std::vector<int32_t>& getChangedSlots() const { return changedSlots; }
+    const std::vector<float>& getChangedStates() const { return changedStates; }
+
+    /**
+     * Actualiza el broadphase y empaqueta los pares como (userA, userB) con
+     * userA < userB, en el mismo orden que Broadphase::getPairs()
+     */
+    int32_t updatePairs();
+    const std::vector<int32_t>& getPairBuffer() const { return pairBuffer; }
+
+    const std::vector<Manifold>& getManifolds() const { return manifolds; }
+    int32_t getContactCount() const;
+
+    // ========== Islas y sueño ==========
+
+    /**
+     * @param linearVelocity  Umbral de reposo lineal (m/s)
+     * @param angularVelocity Umbral de reposo angular (rad/s)
+     * @param timeToSleep     Segundos en reposo antes de dormir; <= 0 desactiva el sueño
+     */
+    void setSleepParameters(float linearVelocity, float angularVelocity, float timeToSleep);
+
+    /**
+     * Aristas de joints para las islas: count pares (slotA, slotB). Reemplaza
+     * las anteriores.
+     */
+    void setJointLinks(const int32_t* links, int32_t count);
+
+    /** Despierta el cuerpo y toda su isla */
+    void wakeBody(int32_t slot);
+    bool isSleeping(int32_t slot) const;
+    int32_t getSleepingCount() const { return sleepingCount; }
+
+    // ========== Snapshots ==========
+
+    /** Frames del historial; 0 lo desactiva. Descarta lo capturado. */
+    void setSnapshotCapacity(int32_t frames) { snapshots.setCapacity(frames); }
+    int32_t getSnapshotCount() const { return snapshots.getCount(); }
+
+    /** Guarda el estado de todos los cuerpos (tras el step) con su timestamp */
+    void captureSnapshot(int64_t timestamp) { snapshots.capture(timestamp, bodies); }
+
+    /**
+     * Lag compensation: lleva los cuerpos slots al último snapshot con
+     * timestamp <= el dado y mueve sus proxies, sin marcarlos como cambiados
+     * ni despertarlos; el resto del mundo no se toca. Las consultas ven la
+     * pose rebobinada hasta endRewind(), que devuelve el estado guardado.
+     * Un rewind() sin endRewind() deshace antes el anterior.
+     *
+     * @return Cuerpos rebobinados (los que cambiaron de cuerpo desde el
+     *         snapshot se quedan como están); -1 si no hay snapshot tan antiguo
+     */
+    int32_t rewind(int64_t timestamp, const int32_t* slots, int32_t count);
+    void endRewind();
+
+    /**
+     * Estado de los cuerpos slots en el snapshot vigente en timestamp, sin
+     * tocar el mundo: STATE_FLOATS por cuerpo, posición x NaN si el slot
+     * cambió de cuerpo desde entonces
+     *
+     * @return false si no hay snapshot tan antiguo
+     */
+    bool readSnapshot(int64_t timestamp, const int32_t* slots, int32_t count, float* states) const;
+
+    /**
+     * Rollback de todos los cuerpos al snapshot vigente en timestamp:
+     * despiertos, marcados como cambiados y en getChangedSlots() /
+     * getChangedStates() como tras un step. Los manifolds se conservan como
+     * caché de contactos; la siguiente captura descarta los snapshots
+     * posteriores.
+     *
+     * @return Cuerpos restaurados; -1 si no hay snapshot tan antiguo
+     */
+    int32_t restoreSnapshot(int64_t timestamp);
+
+    // ========== Consultas de escena ==========
+
+    /**
+     * count consultas empaquetadas (ver SceneQuery) en paralelo por lotes.
+     * Cada una recorre el árbol del broadphase con su rayo, barrido o AABB y
+     * filtra por capa, slot ignorado y triggers antes de la prueba exacta.
+     * Fuera de step(): ven la pose del último step (o la rebobinada).
+     *
+     * @param results     RESULT_INTS por consulta
+     * @param resultFloats RESULT_FLOATS por consulta
+     * @return Slots solapados en total, en getOverlapSlots() por consulta en
+     *         orden y, dentro de cada una, por slot
+     */
+    int32_t queryScene(const int32_t* queries, const float* params, int32_t count,
+                       int32_t* results, float* resultFloats);
+    const std::vector<int32_t>& getOverlapSlots() const { return overlapSlots; }
+
+private:
+    // Lotes del JobPool: fijos, no dependen del número de workers
+    static constexpr int32_t PAIR_BATCH = 32;
+    static constexpr int32_t BODY_GROUP_BATCH = 64;     // grupos de 4 cuerpos
+    static constexpr int32_t PROXY_BATCH = 128;
+    static constexpr int32_t QUERY_BATCH = 16;
+
+    JobPool jobs;
+    BodyStore bodies;
+    Broadphase broadphase;
+    std::vector<int32_t> pairBuffer;
+
+    // Manifolds ordenados por (bodyA, bodyB)
+    std::vector<Manifold> manifolds;
+    std::vector<Manifold> newManifolds;
+    std::vector<Manifold> pairManifolds;        // narrowphase por par
+    std::vector<uint8_t> pairContacts;
+    std::vector<Bounds> proxyBounds;            // AABB de los cuerpos cambiados
+    ContactSolver solver;
+    std::vector<ConvexHull> hulls;
+    std::vector<Heightfield> heightfields;
+
+    std::vector<int32_t> changedSlots;
+    std::vector<float> changedStates;
+    float lastDt = 0.0f;
+
+    SnapshotRing snapshots;
+    std::vector<int32_t> rewoundSlots;
+    std::vector<float> rewoundStates;          // estado actual de rewoundSlots
+    std::vector<int32_t> restoredSlots;
+
+    std::vector<std::vector<int32_t>> overlapBatches;  // solapes de cada lote de consultas
+    std::vector<int32_t> overlapSlots;
+
+    void runQuery(const int32_t* query, const float* params, int32_t* result, float* resultFloats,
+                  std::vector<int32_t>& overlaps) const;
+    bool acceptsQuery(int32_t slot, const int32_t* query) const;
+
+    void updateProxies(float dt);
+    Bounds sweptBounds(int32_t slot, float dt) const;
+    void refreshProxy(int32_t slot);
+    void packStates(const std::vector<int32_t>& slots);
+    void updateContacts();
+    bool collidePair(int32_t slotA, int32_t slotB, Manifold& out) const;
+    void mergeCachedPoints(const Manifold& previous, ContactResult& result) const;
+    const Manifold* findManifold(int32_t slotA, int32_t slotB) const;
+
+    // ========== Islas ==========
+
+    float sleepLinearVelocity = 0.05f;
+    float sleepAngularVelocity = 0.05f;
+    float timeToSleep = 0.5f;
+
+    std::vector<int32_t> jointLinks;
+    std::vector<int32_t> islandParent;          // union-find del step, por slot
+    std::vector<float> islandSleepTime;         // mínimo de la isla, en su raíz
+    std::vector<int32_t> islandRoots;           // raíz -> isla dormida nueva
+    std::vector<int32_t> awakeBodies;           // dinámicos despiertos del step
+
+    // Islas dormidas: cuerpos de cada una y la de cada slot (-1 despierto)
+    std::vector<std::vector<int32_t>> sleepingIslands;
+    std::vector<int32_t> freeIslands;
+    std::vector<int32_t> bodyIsland;
+    int32_t sleepingCount = 0;
+
+    int32_t findIsland(int32_t slot);
+    void uniteIslands(int32_t slotA, int32_t slotB);
+    void wakeIsland(int32_t slot);
+    void wakeTouching();
+    void updateSleep(float dt);
+
+    // ========== CCD ==========
+
+    struct ContinuousBody {
+        int32_t slot;
+        Vec3 position;          // pose al empezar el step
+        Quat rotation;
+    };
+    std::vector<ContinuousBody> continuousBodies;
+    std::vector<int32_t> continuousCandidates;
+
+    void beginContinuous();
+    void solveContinuous();
+    ShapeInstance getShapeInstance(int32_t slot) const;
+};
+
+#endif // PHYSICS_WORLD_H
@@ -0,0 +1,72 @@
+#ifndef SCENE_QUERY_H
+#define SCENE_QUERY_H
+
+#include "narrowphase.h"
+
+/**
+ * Consultas de escena por lotes (PhysicsWorld::queryScene)
+ *
+ * Cada consulta son QUERY_INTS enteros y QUERY_FLOATS floats:
+ *   enteros: tipo | flags, máscara de capas, slot a ignorar (-1 ninguno)
+ *   floats:  origen (3), dirección normalizada (3), distancia máxima,
+ *            semiejes de la forma (3), rotación xyzw (4)
+ *
+ * Forma: esfera radio en x; cápsula radio en x y medio segmento en y (eje y
+ * local); caja semiejes. Los rayos y barridos que empiezan dentro de un
+ * collider no lo cuentan, como en Unity.
+ *
+ * Resultado por consulta, RESULT_INTS enteros y RESULT_FLOATS floats:
+ *   rayo / barrido: slot del impacto más cercano (-1 sin impacto), 1/0;
+ *                   distancia, punto (3), normal de la superficie (3)
+ *   solape:         primer índice y número de slots en la lista de solapes
+ */
+struct SceneQuery {
+    enum Type : int32_t {
+        RAYCAST = 0,
+        SPHERE_CAST = 1,
+        CAPSULE_CAST = 2,
+        OVERLAP_SPHERE = 3,
+        OVERLAP_CAPSULE = 4,
+        OVERLAP_BOX = 5,
+        TYPE_MASK = 0xff,
+        HIT_TRIGGERS = 0x100        // flag: los triggers también cuentan
+    };
+
+    static constexpr int32_t QUERY_INTS = 3;
+    static constexpr int32_t QUERY_FLOATS = 14;
+    static constexpr int32_t RESULT_INTS = 2;
+    static constexpr int32_t RESULT_FLOATS = 7;
+
+    // Distancia a la que el avance conservador da por tocada la superficie
+    static constexpr float TOLERANCE = 1e-3f;
+
+    /**
+     * Forma world de la consulta (esfera, cápsula o caja según el tipo)
+     */
+    static ShapeInstance queryShape(int32_t type, const float* params);
+
+    static bool isOverlap(int32_t type) { return type >= OVERLAP_SPHERE && type <= OVERLAP_BOX; }
+};
+
+/**
+ * Rayo contra una forma: esfera, caja y cápsula analíticos, heightfield por
+ * celdas y convexa por avance conservador de un punto
+ *
+ * @param direction Normalizada
+ * @return false sin impacto o con el origen dentro de la forma
+ */
+bool raycastShape(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                  float& distance, Vec3& normal);
+
+/**
+ * Barrido de caster a lo largo de direction contra target: avance
+ * conservador (timeOfImpact) y, contra un heightfield, pasos del semieje
+ * menor refinados por bisección. Punto y normal salen de la narrowphase en
+ * la pose del impacto.
+ *
+ * @return false sin impacto antes de maxDistance o si ya se tocaban al empezar
+ */
+bool sweepShape(const ShapeInstance& caster, Vec3 direction, float maxDistance, const ShapeInstance& target,
+                float& distance, Vec3& point, Vec3& normal);
+
+#endif // SCENE_QUERY_H
@@ -0,0 +1,71 @@
+#ifndef SNAPSHOT_RING_H
+#define SNAPSHOT_RING_H
+
+#include "body_store.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Historial del estado de los cuerpos para rollback y lag compensation
+ *
+ * Anillo de frames con las 13 columnas de estado de BodyStore (posición,
+ * rotación, velocidades) y la generación de cada slot, copiadas tal cual con
+ * un memcpy por columna: capturar N cuerpos cuesta lo que copiar
+ * 13 · 4 · N bytes. El más antiguo se sobrescribe al llenarse.
+ *
+ * Los timestamps van en aumento; find() busca por bisección el snapshot
+ * vigente en un instante. Capturar con un timestamp no posterior al último
+ * descarta los que quedaron por delante (resimulación tras un rollback).
+ *
+ * Un slot sólo se restaura sobre el mismo cuerpo que había al capturar: si
+ * se eliminó o se reutilizó desde entonces su generación no coincide y se
+ * deja como está.
+ */
+class SnapshotRing {
+public:
+    /** Frames del anillo; 0 desactiva. Descarta lo capturado. */
+    void setCapacity(int32_t frames);
+    int32_t getCapacity() const { return static_cast<int32_t>(frames.size()); }
+    int32_t getCount() const { return count; }
+    void clear() { count = 0; }
+
+    void capture(int64_t timestamp, const BodyStore& bodies);
+
+    /**
+     * @return Índice (0 = el más antiguo) del último snapshot con timestamp
+     *         <= el dado, -1 si todos son posteriores o no hay ninguno
+     */
+    int32_t find(int64_t timestamp) const;
+    int64_t getTimestamp(int32_t index) const { return at(index).timestamp; }
+
+    /**
+     * Estado del slot en el snapshot index (STATE_FLOATS floats)
+     *
+     * @return false si el slot no tenía ese mismo cuerpo
+     */
+    bool read(int32_t index, int32_t slot, const BodyStore& bodies, float* out) const;
+
+    /**
+     * Vuelve todos los cuerpos al snapshot index: memcpy de las columnas si
+     * ningún slot cambió de cuerpo, si no cuerpo a cuerpo
+     *
+     * @param restored Slots escritos
+     */
+    void restore(int32_t index, BodyStore& bodies, std::vector<int32_t>& restored) const;
+
+private:
+    struct Frame {
+        int64_t timestamp = 0;
+        int32_t bodyCount = 0;
+        std::vector<float> columns;         // STATE_FLOATS columnas de bodyCount floats
+        std::vector<uint32_t> generations;
+    };
+
+    std::vector<Frame> frames;
+    int32_t head = 0;                       // siguiente frame a escribir
+    int32_t count = 0;
+
+    const Frame& at(int32_t index) const;
+};
+
+#endif // SNAPSHOT_RING_H
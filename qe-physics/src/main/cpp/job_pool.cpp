@@ -0,0 +1,133 @@
+// job_pool.cpp - Workers con colas por hilo y robo de trabajo
+#include "job_pool.h"
+#include <algorithm>
+
+JobPool::JobPool(int32_t workerCount) {
+    setWorkerCount(workerCount);
+}
+
+JobPool::~JobPool() {
+    stopWorkers();
+}
+
+void JobPool::setWorkerCount(int32_t count) {
+    stopWorkers();
+    scheduler = nullptr;
+    ownWorkerCount = count;
+
+    if (count < 0) {
+        int32_t cores = static_cast<int32_t>(std::thread::hardware_concurrency());
+        count = std::min(std::max(cores - 1, 0), MAX_DEFAULT_WORKERS);
+    }
+
+    queues.clear();
+    for (int32_t i = 0; i <= count; i++) {
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    stopping = false;
+    for (int32_t i = 0; i < count; i++) {
+        workers.emplace_back(&JobPool::workerLoop, this, i);
+    }
+}
+
+void JobPool::setScheduler(JobScheduler* shared) {
+    if (!shared) {
+        setWorkerCount(ownWorkerCount);
+        return;
+    }
+    stopWorkers();
+    scheduler = shared;
+}
+
+void JobPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void JobPool::run(int32_t count, int32_t batchSize, BatchFunction batchFunction, void* batchContext) {
+    const int32_t batchCount = (count + batchSize - 1) / batchSize;
+    const int32_t queueCount = static_cast<int32_t>(queues.size());
+
+    function = batchFunction;
+    context = batchContext;
+    remaining.store(batchCount, std::memory_order_relaxed);
+
+    for (int32_t i = 0; i < batchCount; i++) {
+        int32_t begin = i * batchSize;
+        Queue& queue = *queues[i % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.batches.push_back({ begin, std::min(begin + batchSize, count) });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    // El hilo que llama trabaja con la última cola y espera a los lotes robados
+    const int32_t self = queueCount - 1;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        runBatches(self);
+        if (remaining.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobPool::workerLoop(int32_t index) {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runBatches(index);
+    }
+}
+
+/**
+ * Propia por detrás (lo último repartido, aún en caché) y si no, robo por
+ * delante empezando por la cola siguiente
+ */
+bool JobPool::popBatch(int32_t index, Batch& out) {
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.batches.empty()) {
+            out = own.batches.back();
+            own.batches.pop_back();
+            return true;
+        }
+    }
+
+    const int32_t queueCount = static_cast<int32_t>(queues.size());
+    for (int32_t offset = 1; offset < queueCount; offset++) {
+        Queue& victim = *queues[(index + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.batches.empty()) {
+            out = victim.batches.front();
+            victim.batches.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobPool::runBatches(int32_t index) {
+    Batch batch;
+    while (popBatch(index, batch)) {
+        function(context, batch.begin, batch.end);
+        remaining.fetch_sub(1, std::memory_order_release);
+    }
+}
@@ -0,0 +1,934 @@
+// narrowphase.cpp - Puntos de contacto por par de formas
+#include "narrowphase.h"
+#include "body_store.h"
+#include "gjk.h"
+
+// Como mucho 4 vértices de la cara incidente + 1 por plano de recorte
+static constexpr int32_t MAX_CLIP_VERTICES = 8;
+
+// Vértices a menos de esto fuera de un lado no se recortan: con caras
+// alineadas (pilas de cajas iguales) los ids no cambian por ruido numérico
+static constexpr float CLIP_TOLERANCE = 0.005f;
+
+struct ClipVertex {
+    Vec3 position;
+    uint32_t id;
+};
+
+static inline Vec3 axisOf(Quat q, int32_t axis) {
+    Vec3 unit = vec3(axis == 0 ? 1.0f : 0.0f, axis == 1 ? 1.0f : 0.0f, axis == 2 ? 1.0f : 0.0f);
+    return rotate(q, unit);
+}
+
+static inline float component(Vec3 v, int32_t axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void addPoint(ContactResult& out, Vec3 point, float separation, uint32_t id) {
+    out.points[out.pointCount] = point;
+    out.separations[out.pointCount] = separation;
+    out.ids[out.pointCount] = id;
+    out.pointCount++;
+}
+
+// ========== Reducción ==========
+
+void reduceContacts(const Vec3* points, const float* separations, const uint32_t* ids, int32_t count,
+                    Vec3 normal, ContactResult& out) {
+    out.pointCount = 0;
+    if (count <= MAX_MANIFOLD_POINTS) {
+        for (int32_t i = 0; i < count; i++) addPoint(out, points[i], separations[i], ids[i]);
+        return;
+    }
+
+    int32_t chosen[MAX_MANIFOLD_POINTS] = { 0, -1, -1, -1 };
+    for (int32_t i = 1; i < count; i++) {
+        if (separations[i] < separations[chosen[0]]) chosen[0] = i;
+    }
+
+    Vec3 first = points[chosen[0]];
+    float best = -1.0f;
+    for (int32_t i = 0; i < count; i++) {
+        float d = lengthSq(points[i] - first);
+        if (d > best) {
+            best = d;
+            chosen[1] = i;
+        }
+    }
+
+    Vec3 diagonal = points[chosen[1]] - first;
+    float maxArea = 0.0f, minArea = 0.0f;
+    for (int32_t i = 0; i < count; i++) {
+        float area = dot(cross(diagonal, points[i] - first), normal);
+        if (area > maxArea) {
+            maxArea = area;
+            chosen[2] = i;
+        } else if (area < minArea) {
+            minArea = area;
+            chosen[3] = i;
+        }
+    }
+
+    for (int32_t c : chosen) {
+        if (c >= 0) addPoint(out, points[c], separations[c], ids[c]);
+    }
+}
+
+// ========== Esferas ==========
+
+static bool collideSpheres(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    Vec3 d = b.position - a.position;
+    float distance = length(d);
+    float separation = distance - a.extents.x - b.extents.x;
+    if (separation > margin) return false;
+
+    out.normal = distance > 1e-6f ? d * (1.0f / distance) : vec3(0.0f, 1.0f, 0.0f);
+    out.pointCount = 0;
+    addPoint(out, a.position + out.normal * (a.extents.x + 0.5f * separation), separation, 0);
+    return true;
+}
+
+/**
+ * Esfera (A) contra caja (B)
+ */
+static bool collideSphereBox(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    float radius = a.extents.x;
+    Quat inverse = conjugate(b.rotation);
+    Vec3 local = rotate(inverse, a.position - b.position);
+    Vec3 e = b.extents;
+
+    Vec3 closest = vec3(clampf(local.x, -e.x, e.x), clampf(local.y, -e.y, e.y), clampf(local.z, -e.z, e.z));
+    Vec3 d = local - closest;
+    float distanceSq = lengthSq(d);
+
+    Vec3 localNormal;        // de la caja hacia la esfera
+    float separation;
+    if (distanceSq > 1e-12f) {
+        float distance = std::sqrt(distanceSq);
+        localNormal = d * (1.0f / distance);
+        separation = distance - radius;
+    } else {
+        // Centro dentro de la caja: sale por la cara más cercana
+        int32_t axis = 0;
+        float depth = e.x - std::fabs(local.x);
+        for (int32_t i = 1; i < 3; i++) {
+            float faceDepth = component(e, i) - std::fabs(component(local, i));
+            if (faceDepth < depth) {
+                depth = faceDepth;
+                axis = i;
+            }
+        }
+        float sign = component(local, axis) < 0.0f ? -1.0f : 1.0f;
+        localNormal = vec3(axis == 0 ? sign : 0.0f, axis == 1 ? sign : 0.0f, axis == 2 ? sign : 0.0f);
+        if (axis == 0) closest.x = sign * e.x;
+        if (axis == 1) closest.y = sign * e.y;
+        if (axis == 2) closest.z = sign * e.z;
+        separation = -depth - radius;
+    }
+    if (separation > margin) return false;
+
+    // Normal de A (esfera) hacia B (caja)
+    out.normal = -rotate(b.rotation, localNormal);
+    Vec3 onBox = b.position + rotate(b.rotation, closest);
+    out.pointCount = 0;
+    addPoint(out, onBox + out.normal * (0.5f * separation), separation, 0);
+    return true;
+}
+
+// ========== Cajas ==========
+
+/**
+ * Sutherland-Hodgman contra el plano dot(x, normal) <= offset. Los puntos
+ * nuevos toman un id derivado del vértice interior y del plano, estable
+ * mientras la configuración de caras no cambie.
+ */
+static int32_t clipPolygon(const ClipVertex* in, int32_t count, Vec3 normal, float offset,
+                           uint32_t plane, ClipVertex* out) {
+    int32_t outCount = 0;
+    for (int32_t i = 0; i < count; i++) {
+        const ClipVertex& a = in[i];
+        const ClipVertex& b = in[(i + 1) % count];
+        float da = dot(a.position, normal) - offset - CLIP_TOLERANCE;
+        float db = dot(b.position, normal) - offset - CLIP_TOLERANCE;
+
+        if (da <= 0.0f) {
+            out[outCount++] = a;
+        }
+        if ((da <= 0.0f) != (db <= 0.0f) && outCount < MAX_CLIP_VERTICES) {
+            float t = da / (da - db);
+            const ClipVertex& inside = da <= 0.0f ? a : b;
+            uint32_t direction = da <= 0.0f ? 0u : 1u;
+            out[outCount++] = {
+                a.position + (b.position - a.position) * t,
+                4u + inside.id * 8u + plane * 2u + direction
+            };
+        }
+    }
+    return outCount;
+}
+
+/**
+ * Caja contra caja: SAT sobre los 6 ejes de cara y recorte de la cara
+ * incidente contra los lados de la cara de referencia
+ */
+static bool collideBoxes(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    Vec3 axesA[3] = { axisOf(a.rotation, 0), axisOf(a.rotation, 1), axisOf(a.rotation, 2) };
+    Vec3 axesB[3] = { axisOf(b.rotation, 0), axisOf(b.rotation, 1), axisOf(b.rotation, 2) };
+    Vec3 t = b.position - a.position;
+
+    float separationA = -3.4e38f, separationB = -3.4e38f;
+    int32_t axisA = 0, axisB = 0;
+    for (int32_t i = 0; i < 3; i++) {
+        float radiusB = 0.0f;
+        for (int32_t j = 0; j < 3; j++) radiusB += std::fabs(dot(axesA[i], axesB[j])) * component(b.extents, j);
+        float s = std::fabs(dot(t, axesA[i])) - component(a.extents, i) - radiusB;
+        if (s > separationA) {
+            separationA = s;
+            axisA = i;
+        }
+    }
+    if (separationA > margin) return false;
+
+    for (int32_t i = 0; i < 3; i++) {
+        float radiusA = 0.0f;
+        for (int32_t j = 0; j < 3; j++) radiusA += std::fabs(dot(axesB[i], axesA[j])) * component(a.extents, j);
+        float s = std::fabs(dot(t, axesB[i])) - component(b.extents, i) - radiusA;
+        if (s > separationB) {
+            separationB = s;
+            axisB = i;
+        }
+    }
+    if (separationB > margin) return false;
+
+    // Preferir A salvo mejora clara: evita que la referencia salte entre steps
+    bool referenceIsA = separationB <= 0.98f * separationA + 0.001f;
+    const ShapeInstance& ref = referenceIsA ? a : b;
+    const ShapeInstance& inc = referenceIsA ? b : a;
+    const Vec3* refAxes = referenceIsA ? axesA : axesB;
+    const Vec3* incAxes = referenceIsA ? axesB : axesA;
+    int32_t refAxis = referenceIsA ? axisA : axisB;
+
+    // Normal de la referencia hacia la incidente
+    Vec3 normal = refAxes[refAxis];
+    if (dot(inc.position - ref.position, normal) < 0.0f) normal = -normal;
+    Vec3 refCenter = ref.position + normal * component(ref.extents, refAxis);
+
+    // Cara incidente: la más opuesta a la normal
+    int32_t incAxis = 0;
+    float maxDot = -1.0f;
+    for (int32_t i = 0; i < 3; i++) {
+        float d = std::fabs(dot(incAxes[i], normal));
+        if (d > maxDot) {
+            maxDot = d;
+            incAxis = i;
+        }
+    }
+    float incSign = dot(incAxes[incAxis], normal) > 0.0f ? -1.0f : 1.0f;
+    Vec3 incCenter = inc.position + incAxes[incAxis] * (incSign * component(inc.extents, incAxis));
+    Vec3 incU = incAxes[(incAxis + 1) % 3] * component(inc.extents, (incAxis + 1) % 3);
+    Vec3 incV = incAxes[(incAxis + 2) % 3] * component(inc.extents, (incAxis + 2) % 3);
+
+    ClipVertex polygon[MAX_CLIP_VERTICES] = {
+        { incCenter + incU + incV, 0 },
+        { incCenter - incU + incV, 1 },
+        { incCenter - incU - incV, 2 },
+        { incCenter + incU - incV, 3 }
+    };
+    int32_t count = 4;
+
+    // Recortar contra los 4 lados de la cara de referencia
+    ClipVertex clipped[MAX_CLIP_VERTICES];
+    for (int32_t side = 0; side < 2 && count > 0; side++) {
+        int32_t axis = (refAxis + 1 + side) % 3;
+        Vec3 sideNormal = refAxes[axis];
+        float extent = component(ref.extents, axis);
+        float center = dot(ref.position, sideNormal);
+
+        count = clipPolygon(polygon, count, sideNormal, center + extent, side * 2, clipped);
+        if (count == 0) break;
+        count = clipPolygon(clipped, count, -sideNormal, extent - center, side * 2 + 1, polygon);
+    }
+    if (count == 0) return false;
+
+    // Puntos por debajo del margen sobre la cara de referencia; el punto
+    // medio queda a media separación de la cara incidente
+    uint32_t featureKey = (referenceIsA ? 0u : 1u) << 31 |
+                          static_cast<uint32_t>(refAxis) << 28 | static_cast<uint32_t>(incAxis) << 26;
+    Vec3 points[MAX_CLIP_VERTICES];
+    float separations[MAX_CLIP_VERTICES];
+    uint32_t ids[MAX_CLIP_VERTICES];
+    int32_t keptCount = 0;
+    for (int32_t i = 0; i < count; i++) {
+        float s = dot(polygon[i].position - refCenter, normal);
+        if (s > margin) continue;
+        points[keptCount] = polygon[i].position - normal * (0.5f * s);
+        separations[keptCount] = s;
+        ids[keptCount] = featureKey | (polygon[i].id & 0x3FFFFFFu);
+        keptCount++;
+    }
+    if (keptCount == 0) return false;
+
+    reduceContacts(points, separations, ids, keptCount, normal, out);
+    out.normal = referenceIsA ? normal : -normal;
+    return true;
+}
+
+// ========== Cápsulas ==========
+
+// Cápsula: radio = semieje menor, segmento a lo largo del semieje mayor
+static void capsuleSegment(const ShapeInstance& shape, Vec3& halfSegment, float& radius) {
+    Vec3 e = shape.extents;
+    int32_t axis = (e.x >= e.y && e.x >= e.z) ? 0 : (e.y >= e.z ? 1 : 2);
+    radius = std::fmin(e.x, std::fmin(e.y, e.z));
+    float half = std::fmax(component(e, axis) - radius, 0.0f);
+    halfSegment = vec3(axis == 0 ? half : 0.0f, axis == 1 ? half : 0.0f, axis == 2 ? half : 0.0f);
+}
+
+static Vec3 closestOnSegment(Vec3 p, Vec3 q, Vec3 point, float& t) {
+    Vec3 d = q - p;
+    float dd = lengthSq(d);
+    t = dd > 1e-12f ? clampf(dot(point - p, d) / dd, 0.0f, 1.0f) : 0.0f;
+    return p + d * t;
+}
+
+// Puntos más cercanos entre los segmentos p1q1 y p2q2 (Ericson 5.1.9)
+static void closestSegments(Vec3 p1, Vec3 q1, Vec3 p2, Vec3 q2, Vec3& c1, Vec3& c2) {
+    Vec3 d1 = q1 - p1;
+    Vec3 d2 = q2 - p2;
+    Vec3 r = p1 - p2;
+    float a = lengthSq(d1);
+    float e = lengthSq(d2);
+    float f = dot(d2, r);
+    float s = 0.0f, t = 0.0f;
+
+    if (a <= 1e-12f && e <= 1e-12f) {
+        c1 = p1;
+        c2 = p2;
+        return;
+    }
+    if (a <= 1e-12f) {
+        t = clampf(f / e, 0.0f, 1.0f);
+    } else {
+        float c = dot(d1, r);
+        if (e <= 1e-12f) {
+            s = clampf(-c / a, 0.0f, 1.0f);
+        } else {
+            float b = dot(d1, d2);
+            float denom = a * e - b * b;
+            s = denom > 1e-12f ? clampf((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = clampf(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = clampf((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    c1 = p1 + d1 * s;
+    c2 = p2 + d2 * t;
+}
+
+static Vec3 anyPerpendicular(Vec3 v) {
+    Vec3 n = std::fabs(v.x) < 0.57f ? cross(v, vec3(1.0f, 0.0f, 0.0f)) : cross(v, vec3(0.0f, 1.0f, 0.0f));
+    float len = length(n);
+    return len > 1e-12f ? n * (1.0f / len) : vec3(0.0f, 1.0f, 0.0f);
+}
+
+/**
+ * Esfera (A) contra cápsula (B): esfera contra el punto más cercano del segmento
+ */
+static bool collideSphereCapsule(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    Vec3 half;
+    float radius;
+    capsuleSegment(b, half, radius);
+    Vec3 offset = rotate(b.rotation, half);
+
+    float t;
+    Vec3 core = closestOnSegment(b.position + offset, b.position - offset, a.position, t);
+    Vec3 d = core - a.position;
+    float distance = length(d);
+    float separation = distance - a.extents.x - radius;
+    if (separation > margin) return false;
+
+    out.normal = distance > 1e-6f ? d * (1.0f / distance) : anyPerpendicular(offset);
+    out.pointCount = 0;
+    addPoint(out, a.position + out.normal * (a.extents.x + 0.5f * separation), separation, 0);
+    return true;
+}
+
+/**
+ * Cápsula contra cápsula: segmento contra segmento; con los ejes casi
+ * paralelos, dos puntos en los extremos del solape de las proyecciones
+ */
+static bool collideCapsules(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    Vec3 halfA, halfB;
+    float radiusA, radiusB;
+    capsuleSegment(a, halfA, radiusA);
+    capsuleSegment(b, halfB, radiusB);
+    Vec3 offsetA = rotate(a.rotation, halfA);
+    Vec3 offsetB = rotate(b.rotation, halfB);
+    Vec3 p1 = a.position + offsetA, q1 = a.position - offsetA;
+    Vec3 p2 = b.position + offsetB, q2 = b.position - offsetB;
+
+    Vec3 c1, c2;
+    closestSegments(p1, q1, p2, q2, c1, c2);
+    Vec3 d = c2 - c1;
+    float distance = length(d);
+    float radii = radiusA + radiusB;
+    if (distance - radii > margin) return false;
+
+    Vec3 normal;
+    if (distance > 1e-6f) {
+        normal = d * (1.0f / distance);
+    } else {
+        // Ejes que se cortan: normal perpendicular a ambos
+        Vec3 n = cross(offsetA, offsetB);
+        normal = lengthSq(n) > 1e-12f ? n * (1.0f / length(n)) : anyPerpendicular(offsetA);
+        if (dot(normal, b.position - a.position) < 0.0f) normal = -normal;
+    }
+    out.normal = normal;
+    out.pointCount = 0;
+
+    Vec3 axisA = q1 - p1;
+    Vec3 axisB = q2 - p2;
+    float lenA = lengthSq(axisA), lenB = lengthSq(axisB);
+    if (lenA > 1e-8f && lenB > 1e-8f) {
+        float alignment = dot(axisA, axisB);
+        // ~3 grados: los extremos del solape dan dos puntos estables
+        if (alignment * alignment > 0.997f * lenA * lenB) {
+            float t0 = dot(p2 - p1, axisA) / lenA;
+            float t1 = dot(q2 - p1, axisA) / lenA;
+            float lo = clampf(std::fmin(t0, t1), 0.0f, 1.0f);
+            float hi = clampf(std::fmax(t0, t1), 0.0f, 1.0f);
+            if (hi - lo > 1e-3f) {
+                for (int32_t i = 0; i < 2; i++) {
+                    Vec3 onA = p1 + axisA * (i == 0 ? lo : hi);
+                    float t;
+                    Vec3 onB = closestOnSegment(p2, q2, onA, t);
+                    float separation = dot(onB - onA, normal) - radii;
+                    if (separation > margin) continue;
+                    Vec3 surfaceA = onA + normal * radiusA;
+                    Vec3 surfaceB = onB - normal * radiusB;
+                    addPoint(out, (surfaceA + surfaceB) * 0.5f, separation, static_cast<uint32_t>(i));
+                }
+                if (out.pointCount > 0) return true;
+            }
+        }
+    }
+
+    float separation = distance - radii;
+    addPoint(out, (c1 + normal * radiusA + c2 - normal * radiusB) * 0.5f, separation, 2);
+    return true;
+}
+
+// ========== GJK/EPA ==========
+
+static SupportShape supportShape(const ShapeInstance& shape) {
+    SupportShape support;
+    support.position = shape.position;
+    support.rotation = shape.rotation;
+    support.extents = shape.extents;
+    support.vertices = nullptr;
+    support.vertexCount = 0;
+    support.radius = 0.0f;
+
+    switch (shape.type) {
+        case BodyStore::SHAPE_SPHERE:
+            support.core = SupportShape::CORE_POINT;
+            support.radius = shape.extents.x;
+            break;
+        case BodyStore::SHAPE_CAPSULE:
+            support.core = SupportShape::CORE_SEGMENT;
+            capsuleSegment(shape, support.extents, support.radius);
+            break;
+        case BodyStore::SHAPE_CONVEX:
+            if (shape.hull != nullptr && !shape.hull->vertices.empty()) {
+                support.core = SupportShape::CORE_HULL;
+                support.vertices = shape.hull->vertices.data();
+                support.vertexCount = static_cast<int32_t>(shape.hull->vertices.size());
+                break;
+            }
+            support.core = SupportShape::CORE_BOX;
+            break;
+        default:
+            support.core = SupportShape::CORE_BOX;
+            break;
+    }
+    return support;
+}
+
+// Por debajo de esta distancia entre núcleos la normal de GJK no es fiable y se usa EPA
+static constexpr float GJK_CONTACT_DISTANCE = 1e-4f;
+
+/**
+ * Núcleos por GJK; si se solapan (o casi), penetración por EPA
+ *
+ * @return false si no hay contacto dentro de margin
+ */
+static bool coreContact(const SupportShape& a, const SupportShape& b, float margin,
+                        Vec3& normal, float& coreSeparation, Vec3& pointA, Vec3& pointB) {
+    GjkSimplex simplex;
+    GjkResult result;
+    bool overlap = gjkDistance(a, b, simplex, result);
+    float radii = a.radius + b.radius;
+
+    if (!overlap && result.distance - radii > margin) return false;
+
+    if (overlap || result.distance < GJK_CONTACT_DISTANCE) {
+        float depth;
+        if (epaPenetration(a, b, simplex, normal, depth, pointA, pointB)) {
+            coreSeparation = -depth;
+            return true;
+        }
+        if (overlap || result.distance < 1e-6f) return false;
+    }
+
+    normal = (result.pointB - result.pointA) * (1.0f / result.distance);
+    coreSeparation = result.distance;
+    pointA = result.pointA;
+    pointB = result.pointB;
+    return true;
+}
+
+/**
+ * Cápsula (A) contra caja (B): segmento contra caja por GJK/EPA. Si la
+ * normal sale por una cara de la caja y el segmento queda paralelo a ella,
+ * se recorta contra el rectángulo de la cara para dar dos puntos.
+ */
+static bool collideCapsuleBox(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    SupportShape segment = supportShape(a);
+    SupportShape box = supportShape(b);
+    float radius = segment.radius;
+
+    Vec3 normal, pointA, pointB;
+    float coreSeparation;
+    if (!coreContact(segment, box, margin, normal, coreSeparation, pointA, pointB)) return false;
+
+    out.normal = normal;
+    out.pointCount = 0;
+
+    // Caja local: cara más alineada con la normal (mirando a la cápsula)
+    Quat inverse = conjugate(b.rotation);
+    Vec3 localNormal = rotate(inverse, -normal);
+    Vec3 ln = vabs(localNormal);
+    int32_t faceAxis = (ln.x >= ln.y && ln.x >= ln.z) ? 0 : (ln.y >= ln.z ? 1 : 2);
+    Vec3 offset = rotate(a.rotation, segment.extents);
+    Vec3 localP = rotate(inverse, a.position + offset - b.position);
+    Vec3 localQ = rotate(inverse, a.position - offset - b.position);
+    Vec3 localAxis = localQ - localP;
+    float axisLengthSq = lengthSq(localAxis);
+    float faceAlignment = component(ln, faceAxis);
+    float axisAlongFace = component(localAxis, faceAxis);
+
+    if (faceAlignment > 0.98f && axisLengthSq > 1e-8f && axisAlongFace * axisAlongFace < 0.01f * axisLengthSq) {
+        float sign = component(localNormal, faceAxis) > 0.0f ? 1.0f : -1.0f;
+        float faceExtent = component(b.extents, faceAxis);
+
+        // Liang-Barsky del segmento contra el rectángulo de la cara
+        float lo = 0.0f, hi = 1.0f;
+        for (int32_t k = 1; k < 3; k++) {
+            int32_t axis = (faceAxis + k) % 3;
+            float p = component(localP, axis);
+            float d = component(localAxis, axis);
+            float e = component(b.extents, axis);
+            if (std::fabs(d) < 1e-8f) {
+                if (p < -e || p > e) hi = -1.0f;
+                continue;
+            }
+            float t0 = (-e - p) / d;
+            float t1 = (e - p) / d;
+            lo = std::fmax(lo, std::fmin(t0, t1));
+            hi = std::fmin(hi, std::fmax(t0, t1));
+        }
+
+        if (hi - lo > 1e-3f) {
+            Vec3 faceNormal = rotate(b.rotation, vec3(faceAxis == 0 ? sign : 0.0f,
+                                                      faceAxis == 1 ? sign : 0.0f,
+                                                      faceAxis == 2 ? sign : 0.0f));
+            for (int32_t i = 0; i < 2; i++) {
+                float t = i == 0 ? lo : hi;
+                Vec3 local = localP + localAxis * t;
+                float separation = sign * component(local, faceAxis) - faceExtent - radius;
+                if (separation > margin) continue;
+                Vec3 core = b.position + rotate(b.rotation, local);
+                addPoint(out, core - faceNormal * (radius + 0.5f * separation), separation,
+                         static_cast<uint32_t>(i + 1) | static_cast<uint32_t>(faceAxis) << 2);
+            }
+            if (out.pointCount > 0) {
+                out.normal = -faceNormal;
+                return true;
+            }
+        }
+    }
+
+    float separation = coreSeparation - radius;
+    addPoint(out, (pointA + normal * radius + pointB) * 0.5f, separation, 0);
+    return true;
+}
+
+/**
+ * Cualquier par con una convexa: un punto por GJK/EPA, acumulado entre
+ * steps en PhysicsWorld (incremental) salvo con esferas, que sólo tocan en uno
+ */
+static bool collideConvex(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    SupportShape sa = supportShape(a);
+    SupportShape sb = supportShape(b);
+
+    Vec3 normal, pointA, pointB;
+    float coreSeparation;
+    if (!coreContact(sa, sb, margin, normal, coreSeparation, pointA, pointB)) return false;
+
+    float separation = coreSeparation - sa.radius - sb.radius;
+    if (separation > margin) return false;
+
+    out.normal = normal;
+    out.pointCount = 0;
+    addPoint(out, (pointA + normal * sa.radius + pointB - normal * sb.radius) * 0.5f, separation, 0);
+    out.incremental = a.type != BodyStore::SHAPE_SPHERE && b.type != BodyStore::SHAPE_SPHERE;
+    return true;
+}
+
+// ========== Heightfield ==========
+
+// Candidatos antes de reducir: una caja o un hull sobre varias celdas
+static constexpr int32_t MAX_HEIGHTFIELD_POINTS = 32;
+// Candidatos más cerca se funden (diagonal compartida, vértice y triángulo)
+static constexpr float HEIGHTFIELD_MERGE_DISTANCE = 0.02f;
+// Vértices del núcleo contra la superficie; el resto de un hull mayor sólo por triángulos
+static constexpr int32_t MAX_CORE_VERTICES = 64;
+
+static constexpr uint32_t HEIGHTFIELD_TRIANGLE_ID = 0x80000000u;
+static constexpr uint32_t HEIGHTFIELD_VERTEX_ID = 0x40000000u;
+
+namespace {
+
+struct HeightfieldPoints {
+    Vec3 points[MAX_HEIGHTFIELD_POINTS];
+    Vec3 normals[MAX_HEIGHTFIELD_POINTS];
+    float separations[MAX_HEIGHTFIELD_POINTS];
+    uint32_t ids[MAX_HEIGHTFIELD_POINTS];
+    int32_t count = 0;
+
+    // Con la lista llena sustituye al menos profundo
+    void add(Vec3 point, Vec3 normal, float separation, uint32_t id) {
+        int32_t index = -1;
+        for (int32_t i = 0; i < count; i++) {
+            if (lengthSq(points[i] - point) < HEIGHTFIELD_MERGE_DISTANCE * HEIGHTFIELD_MERGE_DISTANCE) {
+                if (separation >= separations[i]) return;
+                index = i;
+                break;
+            }
+        }
+        if (index < 0 && count < MAX_HEIGHTFIELD_POINTS) {
+            index = count++;
+        } else if (index < 0) {
+            index = 0;
+            for (int32_t i = 1; i < count; i++) {
+                if (separations[i] > separations[index]) index = i;
+            }
+            if (separation >= separations[index]) return;
+        }
+        points[index] = point;
+        normals[index] = normal;
+        separations[index] = separation;
+        ids[index] = id;
+    }
+};
+
+} // namespace
+
+Bounds shapeBounds(const ShapeInstance& shape) {
+    Vec3 e = shape.extents;
+    if (shape.type == BodyStore::SHAPE_SPHERE) {
+        e = vec3(e.x, e.x, e.x);
+    } else {
+        e = vabs(axisOf(shape.rotation, 0)) * e.x + vabs(axisOf(shape.rotation, 1)) * e.y +
+            vabs(axisOf(shape.rotation, 2)) * e.z;
+    }
+    return { shape.position - e, shape.position + e };
+}
+
+/**
+ * Vértices world del núcleo: centro, extremos del segmento, esquinas de la
+ * caja o vértices del hull
+ *
+ * @return Número de vértices escritos, como mucho capacity
+ */
+static int32_t coreVertices(const SupportShape& core, Vec3* out, int32_t capacity) {
+    int32_t count = 0;
+    switch (core.core) {
+        case SupportShape::CORE_POINT:
+            out[count++] = core.position;
+            break;
+        case SupportShape::CORE_SEGMENT: {
+            Vec3 offset = rotate(core.rotation, core.extents);
+            out[count++] = core.position + offset;
+            out[count++] = core.position - offset;
+            break;
+        }
+        case SupportShape::CORE_BOX:
+            for (int32_t i = 0; i < 8 && count < capacity; i++) {
+                Vec3 corner = vec3(i & 1 ? core.extents.x : -core.extents.x,
+                                   i & 2 ? core.extents.y : -core.extents.y,
+                                   i & 4 ? core.extents.z : -core.extents.z);
+                out[count++] = core.position + rotate(core.rotation, corner);
+            }
+            break;
+        case SupportShape::CORE_HULL:
+            for (int32_t i = 0; i < core.vertexCount && count < capacity; i++) {
+                out[count++] = core.position + rotate(core.rotation, core.vertices[i]);
+            }
+            break;
+        default:
+            break;
+    }
+    return count;
+}
+
+/**
+ * Cualquier forma (A) contra heightfield (B)
+ *
+ * Por cada triángulo de las celdas bajo la AABB de A: con los núcleos
+ * separados, el par más cercano de GJK si A queda por delante de la cara;
+ * solapados, el punto de A más hundido a lo largo de la normal de la cara
+ * si cae sobre ese triángulo. Además, cada vértice del núcleo contra la
+ * superficie bajo él, que da las cuatro esquinas de una caja apoyada. La
+ * normal del manifold es la del punto más profundo.
+ */
+static bool collideHeightfield(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    const Heightfield& field = *b.heightfield;
+    SupportShape sa = supportShape(a);
+    const float radius = sa.radius;
+    Quat inverse = conjugate(b.rotation);
+
+    // AABB de A en el espacio local del heightfield
+    Bounds world = shapeBounds(a);
+    Vec3 center = rotate(inverse, (world.min + world.max) * 0.5f - b.position);
+    Vec3 half = (world.max - world.min) * 0.5f;
+    Vec3 e = vabs(rotate(inverse, vec3(1.0f, 0.0f, 0.0f))) * half.x +
+             vabs(rotate(inverse, vec3(0.0f, 1.0f, 0.0f))) * half.y +
+             vabs(rotate(inverse, vec3(0.0f, 0.0f, 1.0f))) * half.z + vec3(margin, margin, margin);
+    int32_t x0, z0, x1, z1;
+    if (!field.cellRange({ center - e, center + e }, x0, z0, x1, z1)) return false;
+
+    HeightfieldPoints candidates;
+
+    // Triángulos de las celdas
+    SupportShape triangle;
+    triangle.core = SupportShape::CORE_HULL;
+    triangle.position = b.position;
+    triangle.rotation = b.rotation;
+    triangle.extents = vec3(0.0f, 0.0f, 0.0f);
+    triangle.vertexCount = 3;
+    triangle.radius = 0.0f;
+    for (int32_t z = z0; z < z1; z++) {
+        for (int32_t x = x0; x < x1; x++) {
+            for (int32_t tri = 0; tri < 2; tri++) {
+                Vec3 t[3];
+                field.cellTriangle(x, z, tri, t);
+                triangle.vertices = t;
+                Vec3 faceNormal = cross(t[1] - t[0], t[2] - t[0]);
+                Vec3 up = rotate(b.rotation, faceNormal * (1.0f / length(faceNormal)));
+                uint32_t id = HEIGHTFIELD_TRIANGLE_ID | static_cast<uint32_t>((z * (field.columns - 1) + x) * 2 + tri);
+
+                GjkSimplex simplex;
+                GjkResult result;
+                bool overlap = gjkDistance(sa, triangle, simplex, result);
+                if (!overlap && result.distance > GJK_CONTACT_DISTANCE) {
+                    float separation = result.distance - radius;
+                    if (separation > margin) continue;
+                    Vec3 normal = (result.pointB - result.pointA) * (1.0f / result.distance);
+                    // A por detrás de la cara: el terreno sólo empuja hacia arriba
+                    if (dot(normal, up) > 0.0f) continue;
+                    candidates.add((result.pointA + normal * radius + result.pointB) * 0.5f, normal, separation, id);
+                    continue;
+                }
+
+                // Núcleos solapados: por la normal de la cara, si lo más hundido cae sobre ella
+                Vec3 deepest = sa.support(-up);
+                Vec3 local = rotate(inverse, deepest - b.position);
+                float surface;
+                Vec3 surfaceNormal;
+                int32_t below;
+                if (!field.surfaceAt(local.x, local.z, surface, surfaceNormal, below)) continue;
+                if (static_cast<uint32_t>(below) != (id & ~HEIGHTFIELD_TRIANGLE_ID)) continue;
+                Vec3 onA = deepest - up * radius;
+                float separation = dot(onA - (b.position + rotate(b.rotation, t[0])), up);
+                if (separation > margin) continue;
+                candidates.add(onA - up * (0.5f * separation), -up, separation, id);
+            }
+        }
+    }
+
+    // Vértices del núcleo contra la superficie bajo cada uno
+    Vec3 vertices[MAX_CORE_VERTICES];
+    int32_t vertexCount = coreVertices(sa, vertices, MAX_CORE_VERTICES);
+    for (int32_t i = 0; i < vertexCount; i++) {
+        Vec3 local = rotate(inverse, vertices[i] - b.position);
+        float surface;
+        Vec3 surfaceNormal;
+        int32_t below;
+        if (!field.surfaceAt(local.x, local.z, surface, surfaceNormal, below)) continue;
+        float separation = (local.y - surface) * surfaceNormal.y - radius;
+        if (separation > margin) continue;
+        Vec3 up = rotate(b.rotation, surfaceNormal);
+        Vec3 onA = vertices[i] - up * radius;
+        candidates.add(onA - up * (0.5f * separation), -up, separation, HEIGHTFIELD_VERTEX_ID | static_cast<uint32_t>(i));
+    }
+    if (candidates.count == 0) return false;
+
+    int32_t deepest = 0;
+    for (int32_t i = 1; i < candidates.count; i++) {
+        if (candidates.separations[i] < candidates.separations[deepest]) deepest = i;
+    }
+    out.normal = candidates.normals[deepest];
+    reduceContacts(candidates.points, candidates.separations, candidates.ids, candidates.count, out.normal, out);
+    return true;
+}
+
+static bool collideNone(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    return false;
+}
+
+// ========== CCD ==========
+
+static constexpr int32_t TOI_MAX_ITERATIONS = 20;
+
+// Distancia entre superficies; < 0 si los núcleos se solapan (normal sin definir)
+static float surfaceDistance(const ShapeInstance& a, const ShapeInstance& b, Vec3& normal) {
+    SupportShape sa = supportShape(a);
+    SupportShape sb = supportShape(b);
+    GjkSimplex simplex;
+    GjkResult result;
+    if (gjkDistance(sa, sb, simplex, result) || result.distance < 1e-6f) {
+        return -1.0f;
+    }
+    normal = (result.pointB - result.pointA) * (1.0f / result.distance);
+    return result.distance - sa.radius - sb.radius;
+}
+
+/**
+ * Centro de A por raycast contra el heightfield B; se detiene a su semieje
+ * menor de la superficie, medido a lo largo del rayo. El centro nunca la
+ * atraviesa: lo que el solver no frene en un step vuelve a pararse en el
+ * siguiente en vez de acabar bajo el terreno.
+ */
+static float heightfieldTimeOfImpact(const ShapeInstance& a0, const ShapeInstance& a1, const ShapeInstance& b,
+                                     float target) {
+    const Heightfield& field = *b.heightfield;
+    Quat inverse = conjugate(b.rotation);
+    Vec3 p0 = rotate(inverse, a0.position - b.position);
+    Vec3 p1 = rotate(inverse, a1.position - b.position);
+    Vec3 d = p1 - p0;
+    float travel = length(d);
+    if (travel < 1e-6f) return 1.0f;
+
+    Vec3 e = a0.extents;
+    float inner = a0.type == BodyStore::SHAPE_SPHERE ? e.x : std::fmin(e.x, std::fmin(e.y, e.z));
+
+    Vec3 direction = d * (1.0f / travel);
+    float distance;
+    Vec3 normal;
+    if (!field.raycast(p0, direction, travel + inner, distance, normal)) return 1.0f;
+
+    // Rasante: la distancia a lo largo del rayo se acota. Ya a menos de eso
+    // al empezar, el centro sólo avanza hasta medio camino de la superficie
+    // si fuera a atravesarla; si no, queda para la narrowphase discreta
+    float backOff = (inner + target) / std::fmax(-dot(direction, normal), 0.2f);
+    float t;
+    if (distance > backOff + 0.25f * target) {
+        t = (distance - backOff) / travel;
+    } else if (distance < travel) {
+        t = 0.5f * distance / travel;
+    } else {
+        return 1.0f;
+    }
+    return t < 1.0f ? t : 1.0f;
+}
+
+float timeOfImpact(const ShapeInstance& a0, const ShapeInstance& a1, const ShapeInstance& b, float target) {
+    if (b.type == BodyStore::SHAPE_HEIGHTFIELD) {
+        return b.heightfield != nullptr && !b.heightfield->empty() ? heightfieldTimeOfImpact(a0, a1, b, target) : 1.0f;
+    }
+    if (a0.type == BodyStore::SHAPE_HEIGHTFIELD) return 1.0f;
+
+    const float tolerance = 0.25f * target;
+    Vec3 translation = a1.position - a0.position;
+    float sweepRadius = rotationAngle(a0.rotation, a1.rotation) * length(a0.extents);
+
+    ShapeInstance a = a0;
+    Vec3 normal;
+    float distance = surfaceDistance(a, b, normal);
+    if (distance < target + tolerance) return 1.0f;
+
+    float t = 0.0f;
+    for (int32_t iteration = 0; iteration < TOI_MAX_ITERATIONS; iteration++) {
+        float approach = dot(translation, normal) + sweepRadius;
+        if (approach <= 0.0f) return 1.0f;
+
+        t += (distance - target) / approach;
+        if (t >= 1.0f) return 1.0f;
+
+        a.position = a0.position + translation * t;
+        a.rotation = nlerp(a0.rotation, a1.rotation, t);
+        distance = surfaceDistance(a, b, normal);
+        if (distance < target + tolerance) break;
+    }
+    return t;
+}
+
+// ========== Dispatch ==========
+
+typedef bool (*CollideFn)(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out);
+
+// Par (B, A) resuelto con la función de (A, B) y la normal invertida
+template <CollideFn FN>
+static bool collideFlipped(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    if (!FN(b, a, margin, out)) return false;
+    out.normal = -out.normal;
+    return true;
+}
+
+static const CollideFn COLLIDE_TABLE[BodyStore::SHAPE_COUNT][BodyStore::SHAPE_COUNT] = {
+    // SHAPE_SPHERE
+    { collideSpheres, collideSphereBox, collideSphereCapsule, collideConvex, collideHeightfield },
+    // SHAPE_BOX
+    { collideFlipped<collideSphereBox>, collideBoxes, collideFlipped<collideCapsuleBox>, collideConvex,
+      collideHeightfield },
+    // SHAPE_CAPSULE
+    { collideFlipped<collideSphereCapsule>, collideCapsuleBox, collideCapsules, collideConvex, collideHeightfield },
+    // SHAPE_CONVEX
+    { collideConvex, collideConvex, collideConvex, collideConvex, collideHeightfield },
+    // SHAPE_HEIGHTFIELD: terreno estático, nunca contra otro terreno
+    { collideFlipped<collideHeightfield>, collideFlipped<collideHeightfield>, collideFlipped<collideHeightfield>,
+      collideFlipped<collideHeightfield>, collideNone }
+};
+
+static inline int32_t narrowType(const ShapeInstance& shape) {
+    // Convexa sin hull subido: su caja
+    if (shape.type == BodyStore::SHAPE_CONVEX && (shape.hull == nullptr || shape.hull->vertices.empty())) {
+        return BodyStore::SHAPE_BOX;
+    }
+    // Heightfield sin muestras (chunk descargado): no colisiona
+    if (shape.type == BodyStore::SHAPE_HEIGHTFIELD && (shape.heightfield == nullptr || shape.heightfield->empty())) {
+        return BodyStore::SHAPE_NONE;
+    }
+    return shape.type;
+}
+
+bool collideShapes(const ShapeInstance& a, const ShapeInstance& b, float margin, ContactResult& out) {
+    int32_t typeA = narrowType(a);
+    int32_t typeB = narrowType(b);
+    if (typeA < 0 || typeA >= BodyStore::SHAPE_COUNT || typeB < 0 || typeB >= BodyStore::SHAPE_COUNT) {
+        return false;
+    }
+
+    out.incremental = false;
+    return COLLIDE_TABLE[typeA][typeB](a, b, margin, out);
+}
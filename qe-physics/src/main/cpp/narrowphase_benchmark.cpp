@@ -0,0 +1,115 @@
+// narrowphase_benchmark.cpp - Coste de collideShapes() por par de tipos
+#include "narrowphase.h"
+#include "body_store.h"
+#include <algorithm>
+#include <chrono>
+
+static constexpr int32_t HULL_VERTICES = 32;
+static constexpr int32_t HEIGHTFIELD_SAMPLES = 9;     // 8 × 8 celdas de 0.125
+
+namespace {
+
+// xorshift32: mismos pares para la misma semilla en cualquier plataforma
+struct BenchmarkRandom {
+    uint32_t state;
+
+    float next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float range(float lo, float hi) { return lo + (hi - lo) * next(); }
+
+    Vec3 direction() {
+        Vec3 v;
+        do {
+            v = vec3(range(-1.0f, 1.0f), range(-1.0f, 1.0f), range(-1.0f, 1.0f));
+        } while (lengthSq(v) < 1e-4f || lengthSq(v) > 1.0f);
+        return v * (1.0f / length(v));
+    }
+
+    Quat rotation() {
+        Vec3 axis = direction();
+        float half = range(0.0f, 3.14159265f);
+        float s = std::sin(half);
+        return { axis.x * s, axis.y * s, axis.z * s, std::cos(half) };
+    }
+};
+
+} // namespace
+
+// Semiejes por tipo; la convexa es una nube de puntos sobre un elipsoide y el
+// heightfield un terreno ondulado de 1 × 1
+static Vec3 benchmarkExtents(int32_t type) {
+    switch (type) {
+        case BodyStore::SHAPE_SPHERE: return vec3(0.5f, 0.5f, 0.5f);
+        case BodyStore::SHAPE_CAPSULE: return vec3(0.3f, 0.8f, 0.3f);
+        case BodyStore::SHAPE_HEIGHTFIELD: return vec3(0.5f, 0.1f, 0.5f);
+        default: return vec3(0.5f, 0.4f, 0.3f);
+    }
+}
+
+float benchmarkNarrowphase(int32_t typeA, int32_t typeB, int32_t count, int32_t iterations,
+                           uint32_t seed, float& hitRatio) {
+    hitRatio = 0.0f;
+    if (count <= 0 || iterations <= 0 ||
+        typeA < 0 || typeA >= BodyStore::SHAPE_COUNT || typeB < 0 || typeB >= BodyStore::SHAPE_COUNT) {
+        return 0.0f;
+    }
+
+    BenchmarkRandom random = { seed != 0 ? seed : 1u };
+
+    ConvexHull hull;
+    Vec3 hullExtents = benchmarkExtents(BodyStore::SHAPE_CONVEX);
+    for (int32_t i = 0; i < HULL_VERTICES; i++) {
+        Vec3 d = random.direction();
+        hull.vertices.push_back(vec3(d.x * hullExtents.x, d.y * hullExtents.y, d.z * hullExtents.z));
+    }
+
+    Heightfield field;
+    float heights[HEIGHTFIELD_SAMPLES * HEIGHTFIELD_SAMPLES];
+    for (int32_t z = 0; z < HEIGHTFIELD_SAMPLES; z++) {
+        for (int32_t x = 0; x < HEIGHTFIELD_SAMPLES; x++) {
+            heights[z * HEIGHTFIELD_SAMPLES + x] = 0.1f * std::sin(0.8f * static_cast<float>(x)) *
+                                                   std::cos(0.8f * static_cast<float>(z));
+        }
+    }
+    field.build(heights, HEIGHTFIELD_SAMPLES, HEIGHTFIELD_SAMPLES, 1.0f / static_cast<float>(HEIGHTFIELD_SAMPLES - 1));
+
+    // B a una distancia de A entre el 40% y el 80% de la suma de radios envolventes
+    std::vector<ShapeInstance> shapesA(count), shapesB(count);
+    float reach = length(benchmarkExtents(typeA)) + length(benchmarkExtents(typeB));
+    for (int32_t i = 0; i < count; i++) {
+        shapesA[i] = { typeA, vec3(0.0f, 0.0f, 0.0f), random.rotation(), benchmarkExtents(typeA), &hull, &field };
+        shapesB[i] = { typeB, random.direction() * (reach * random.range(0.4f, 0.8f)), random.rotation(),
+                       benchmarkExtents(typeB), &hull, &field };
+    }
+
+    ContactResult result;
+    int32_t hits = 0;
+    std::vector<float> samples(iterations);
+
+    // Calentamiento (caches); cuenta también los pares con contacto
+    for (int32_t i = 0; i < count; i++) {
+        if (collideShapes(shapesA[i], shapesB[i], SPECULATIVE_DISTANCE, result)) hits++;
+    }
+    hitRatio = static_cast<float>(hits) / static_cast<float>(count);
+
+    for (int32_t iteration = 0; iteration < iterations; iteration++) {
+        auto start = std::chrono::steady_clock::now();
+        int32_t sink = 0;
+        for (int32_t i = 0; i < count; i++) {
+            sink += collideShapes(shapesA[i], shapesB[i], SPECULATIVE_DISTANCE, result) ? result.pointCount : 0;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        samples[iteration] = static_cast<float>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                             static_cast<float>(count);
+        // Evita que el compilador descarte el bucle
+        if (sink < 0) hitRatio = -1.0f;
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + iterations / 2, samples.end());
+    return samples[iterations / 2];
+}
@@ -0,0 +1,405 @@
+#include <jni.h>
+#include <android/log.h>
+#include "physics_world.h"
+
+#define LOG_TAG "PhysicsJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+/**
+ * Acceso crítico a un array primitivo (ver math_jni.cpp)
+ */
+template <typename T>
+class CriticalArray {
+public:
+    CriticalArray(JNIEnv* env, jarray array, bool writable)
+        : env(env), array(array), writable(writable) {
+        if (array) {
+            data = static_cast<T*>(env->GetPrimitiveArrayCritical(array, nullptr));
+        }
+    }
+
+    ~CriticalArray() {
+        if (data) {
+            env->ReleasePrimitiveArrayCritical(array, data, writable ? 0 : JNI_ABORT);
+        }
+    }
+
+    T* get() const { return data; }
+
+private:
+    JNIEnv* env;
+    jarray array;
+    bool writable;
+    T* data = nullptr;
+};
+
+typedef CriticalArray<float> CriticalFloats;
+typedef CriticalArray<jint> CriticalInts;
+
+static inline PhysicsWorld* getWorld(jlong handle) {
+    return reinterpret_cast<PhysicsWorld*>(handle);
+}
+
+extern "C" {
+
+// ========== Lifecycle ==========
+
+JNIEXPORT jlong JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeCreate(
+    JNIEnv* env, jobject obj) {
+    LOGI("Creating native PhysicsWorld");
+    return reinterpret_cast<jlong>(new PhysicsWorld());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeDestroy(
+    JNIEnv* env, jobject obj, jlong handle) {
+    delete getWorld(handle);
+}
+
+// ========== Cuerpos ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetBodyStates(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray states, jint count) {
+    CriticalInts ids(env, slots, false);
+    CriticalFloats data(env, states, false);
+    if (!ids.get() || !data.get()) {
+        LOGE("Failed to access arrays for setBodyStates");
+        return;
+    }
+    getWorld(handle)->getBodies().setStates(ids.get(), data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetBodyProperties(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray properties, jint count) {
+    CriticalInts ids(env, slots, false);
+    CriticalFloats data(env, properties, false);
+    if (!ids.get() || !data.get()) {
+        LOGE("Failed to access arrays for setBodyProperties");
+        return;
+    }
+    getWorld(handle)->getBodies().setProperties(ids.get(), data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeAddBodyForces(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray forces, jint count) {
+    CriticalInts ids(env, slots, false);
+    CriticalFloats data(env, forces, false);
+    if (!ids.get() || !data.get()) {
+        LOGE("Failed to access arrays for addBodyForces");
+        return;
+    }
+    getWorld(handle)->getBodies().addForces(ids.get(), data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetBodyMaterials(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray materials, jint count) {
+    CriticalInts ids(env, slots, false);
+    CriticalFloats data(env, materials, false);
+    if (!ids.get() || !data.get()) {
+        LOGE("Failed to access arrays for setBodyMaterials");
+        return;
+    }
+    getWorld(handle)->getBodies().setMaterials(ids.get(), data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetBodyShapes(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jintArray types, jintArray hulls, jfloatArray shapes, jint count) {
+    CriticalInts ids(env, slots, false);
+    CriticalInts shapeTypes(env, types, false);
+    CriticalInts shapeHulls(env, hulls, false);
+    CriticalFloats data(env, shapes, false);
+    if (!ids.get() || !shapeTypes.get() || !shapeHulls.get() || !data.get()) {
+        LOGE("Failed to access arrays for setBodyShapes");
+        return;
+    }
+
+    PhysicsWorld* world = getWorld(handle);
+    for (jint i = 0; i < count; i++) {
+        world->setShape(ids.get()[i], shapeTypes.get()[i], shapeHulls.get()[i],
+                        data.get() + i * BodyStore::SHAPE_FLOATS);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetConvexHull(
+    JNIEnv* env, jobject obj, jlong handle, jint hull, jfloatArray vertices, jint count) {
+    CriticalFloats data(env, vertices, false);
+    if (!data.get()) {
+        LOGE("Failed to access arrays for setConvexHull");
+        return;
+    }
+    getWorld(handle)->setConvexHull(hull, data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetHeightfield(
+    JNIEnv* env, jobject obj, jlong handle, jint index, jfloatArray heights, jint columns, jint rows,
+    jfloat cellSize) {
+    // Sin alturas: libera el heightfield
+    if (heights == nullptr || columns < 2 || rows < 2) {
+        getWorld(handle)->setHeightfield(index, nullptr, 0, 0, cellSize);
+        return;
+    }
+    if (env->GetArrayLength(heights) < columns * rows) {
+        LOGE("Heightfield needs %d samples", columns * rows);
+        return;
+    }
+    CriticalFloats data(env, heights, false);
+    if (!data.get()) {
+        LOGE("Failed to access arrays for setHeightfield");
+        return;
+    }
+    getWorld(handle)->setHeightfield(index, data.get(), columns, rows, cellSize);
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeRaycastHeightfield(
+    JNIEnv* env, jobject obj, jlong handle, jint slot,
+    jfloat originX, jfloat originY, jfloat originZ,
+    jfloat directionX, jfloat directionY, jfloat directionZ,
+    jfloat maxDistance, jfloatArray outNormal) {
+    float distance;
+    Vec3 normal;
+    if (!getWorld(handle)->raycastHeightfield(slot, vec3(originX, originY, originZ),
+                                              vec3(directionX, directionY, directionZ),
+                                              maxDistance, distance, normal)) {
+        return -1.0f;
+    }
+    const float values[3] = { normal.x, normal.y, normal.z };
+    env->SetFloatArrayRegion(outNormal, 0, 3, values);
+    return distance;
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeRaycastHeightfieldBatch(
+    JNIEnv* env, jobject obj, jlong handle, jint slot, jfloatArray rays, jint count,
+    jfloatArray maxDistances, jfloatArray outDistances) {
+    CriticalFloats rayData(env, rays, false);
+    CriticalFloats limits(env, maxDistances, false);
+    CriticalFloats distances(env, outDistances, true);
+    if (!rayData.get() || !limits.get() || !distances.get()) {
+        LOGE("Failed to access arrays for raycastHeightfieldBatch");
+        return;
+    }
+    getWorld(handle)->raycastHeightfieldBatch(slot, rayData.get(), count, limits.get(), distances.get());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeRemoveBody(
+    JNIEnv* env, jobject obj, jlong handle, jint slot) {
+    getWorld(handle)->removeBody(slot);
+}
+
+// ========== Simulación ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeStep(
+    JNIEnv* env, jobject obj, jlong handle,
+    jfloat dt, jfloat gravityX, jfloat gravityY, jfloat gravityZ, jint subSteps) {
+    return getWorld(handle)->step(dt, vec3(gravityX, gravityY, gravityZ), subSteps);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetChangedBodies(
+    JNIEnv* env, jobject obj, jlong handle, jintArray outSlots, jfloatArray outStates) {
+    PhysicsWorld* world = getWorld(handle);
+    const std::vector<int32_t>& slots = world->getChangedSlots();
+    const std::vector<float>& states = world->getChangedStates();
+
+    jsize count = static_cast<jsize>(slots.size());
+    if (env->GetArrayLength(outSlots) < count ||
+        env->GetArrayLength(outStates) < count * BodyStore::STATE_FLOATS) {
+        LOGE("Output arrays too small for %d changed bodies", count);
+        return;
+    }
+    env->SetIntArrayRegion(outSlots, 0, count, slots.data());
+    env->SetFloatArrayRegion(outStates, 0, count * BodyStore::STATE_FLOATS, states.data());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetPairCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return static_cast<jint>(getWorld(handle)->getPairBuffer().size() / 2);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetPairs(
+    JNIEnv* env, jobject obj, jlong handle, jintArray out) {
+    const std::vector<int32_t>& pairs = getWorld(handle)->getPairBuffer();
+    jsize capacity = env->GetArrayLength(out);
+    jsize count = static_cast<jsize>(pairs.size()) < capacity ? static_cast<jsize>(pairs.size()) : capacity;
+    env->SetIntArrayRegion(out, 0, count, pairs.data());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetContactCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getWorld(handle)->getContactCount();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetTreeHeight(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getWorld(handle)->getBroadphase().getTreeHeight();
+}
+
+// ========== Workers ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetWorkerCount(
+    JNIEnv* env, jobject obj, jlong handle, jint count) {
+    getWorld(handle)->setWorkerCount(count);
+    LOGI("Physics workers: %d", getWorld(handle)->getWorkerCount());
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetWorkerCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getWorld(handle)->getWorkerCount();
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetJobScheduler(
+    JNIEnv* env, jobject obj, jlong handle, jlong scheduler) {
+    getWorld(handle)->setJobScheduler(reinterpret_cast<JobScheduler*>(scheduler));
+}
+
+// ========== Islas y sueño ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetSleepParameters(
+    JNIEnv* env, jobject obj, jlong handle,
+    jfloat linearVelocity, jfloat angularVelocity, jfloat timeToSleep) {
+    getWorld(handle)->setSleepParameters(linearVelocity, angularVelocity, timeToSleep);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetJointLinks(
+    JNIEnv* env, jobject obj, jlong handle, jintArray links, jint count) {
+    CriticalInts data(env, links, false);
+    if (!data.get()) {
+        LOGE("Failed to access arrays for setJointLinks");
+        return;
+    }
+    getWorld(handle)->setJointLinks(data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeWakeBody(
+    JNIEnv* env, jobject obj, jlong handle, jint slot) {
+    getWorld(handle)->wakeBody(slot);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeIsSleeping(
+    JNIEnv* env, jobject obj, jlong handle, jint slot) {
+    return getWorld(handle)->isSleeping(slot) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetSleepingCount(
+    JNIEnv* env, jobject obj, jlong handle) {
+    return getWorld(handle)->getSleepingCount();
+}
+
+// ========== Snapshots ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeSetSnapshotCapacity(
+    JNIEnv* env, jobject obj, jlong handle, jint frames) {
+    getWorld(handle)->setSnapshotCapacity(frames);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeCaptureSnapshot(
+    JNIEnv* env, jobject obj, jlong handle, jlong timestamp) {
+    getWorld(handle)->captureSnapshot(timestamp);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeRewind(
+    JNIEnv* env, jobject obj, jlong handle, jlong timestamp, jintArray slots, jint count) {
+    CriticalInts data(env, slots, false);
+    if (!data.get()) {
+        LOGE("Failed to access arrays for rewind");
+        return -1;
+    }
+    return getWorld(handle)->rewind(timestamp, data.get(), count);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeEndRewind(
+    JNIEnv* env, jobject obj, jlong handle) {
+    getWorld(handle)->endRewind();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeReadSnapshot(
+    JNIEnv* env, jobject obj, jlong handle, jlong timestamp, jintArray slots, jint count, jfloatArray outStates) {
+    CriticalInts slotData(env, slots, false);
+    CriticalFloats stateData(env, outStates, true);
+    if (!slotData.get() || !stateData.get()) {
+        LOGE("Failed to access arrays for readSnapshot");
+        return JNI_FALSE;
+    }
+    return getWorld(handle)->readSnapshot(timestamp, slotData.get(), count, stateData.get()) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeRestoreSnapshot(
+    JNIEnv* env, jobject obj, jlong handle, jlong timestamp) {
+    return getWorld(handle)->restoreSnapshot(timestamp);
+}
+
+// ========== Consultas de escena ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeQueryScene(
+    JNIEnv* env, jobject obj, jlong handle, jintArray queries, jfloatArray params, jint count,
+    jintArray outResults, jfloatArray outResultFloats) {
+    CriticalInts queryData(env, queries, false);
+    CriticalFloats paramData(env, params, false);
+    CriticalInts resultData(env, outResults, true);
+    CriticalFloats resultFloatData(env, outResultFloats, true);
+    if (!queryData.get() || !paramData.get() || !resultData.get() || !resultFloatData.get()) {
+        LOGE("Failed to access arrays for queryScene");
+        return 0;
+    }
+    return getWorld(handle)->queryScene(queryData.get(), paramData.get(), count,
+                                        resultData.get(), resultFloatData.get());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_physics_NativePhysicsWorld_nativeGetOverlapSlots(
+    JNIEnv* env, jobject obj, jlong handle, jintArray out) {
+    const std::vector<int32_t>& slots = getWorld(handle)->getOverlapSlots();
+    jsize capacity = env->GetArrayLength(out);
+    jsize count = static_cast<jsize>(slots.size()) < capacity ? static_cast<jsize>(slots.size()) : capacity;
+    env->SetIntArrayRegion(out, 0, count, slots.data());
+}
+
+// ========== Benchmark ==========
+
+JNIEXPORT jfloat JNICALL
+Java_com_quantum_engine_physics_PhysicsBenchmark_nativeBenchmarkNarrowphase(
+    JNIEnv* env, jobject obj, jint typeA, jint typeB, jint count, jint iterations, jint seed,
+    jfloatArray hitRatio) {
+    float ratio = 0.0f;
+    float nsPerPair = benchmarkNarrowphase(typeA, typeB, count, iterations, static_cast<uint32_t>(seed), ratio);
+    env->SetFloatArrayRegion(hitRatio, 0, 1, &ratio);
+    return nsPerPair;
+}
+
+} // extern "C"
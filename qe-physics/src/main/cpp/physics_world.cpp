@@ -0,0 +1,833 @@
+// physics_world.cpp
+#include "physics_world.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Combinación de material de Unity: gana el modo de mayor prioridad
+ * (0 media, 1 mínimo, 2 producto, 3 máximo)
+ */
+static float combineMaterial(float a, float b, int32_t modeA, int32_t modeB) {
+    switch (std::max(modeA, modeB)) {
+        case 1: return std::min(a, b);
+        case 2: return a * b;
+        case 3: return std::max(a, b);
+        default: return 0.5f * (a + b);
+    }
+}
+
+void PhysicsWorld::setShape(int32_t slot, int32_t type, int32_t hull, const float* shape) {
+    bodies.setShape(slot, type, hull, shape);
+
+    int32_t proxy = bodies.getProxy(slot);
+    if (type == BodyStore::SHAPE_NONE && proxy != DynamicTree::NULL_NODE) {
+        broadphase.destroyProxy(proxy);
+        bodies.setProxy(slot, DynamicTree::NULL_NODE);
+    }
+}
+
+void PhysicsWorld::setConvexHull(int32_t hull, const float* vertices, int32_t count) {
+    if (hull < 0) return;
+    if (hull >= static_cast<int32_t>(hulls.size())) {
+        hulls.resize(hull + 1);
+    }
+
+    std::vector<Vec3>& hullVertices = hulls[hull].vertices;
+    hullVertices.resize(count);
+    for (int32_t i = 0; i < count; i++) {
+        hullVertices[i] = vec3(vertices[i * 3], vertices[i * 3 + 1], vertices[i * 3 + 2]);
+    }
+}
+
+void PhysicsWorld::setHeightfield(int32_t index, const float* heights, int32_t columns, int32_t rows,
+                                  float cellSize) {
+    if (index < 0) return;
+    if (index >= static_cast<int32_t>(heightfields.size())) {
+        heightfields.resize(index + 1);
+    }
+    heightfields[index].build(heights, columns, rows, cellSize);
+
+    // Lo que descansaba sobre el terreno anterior tiene que volver a simularse
+    const int32_t capacity = bodies.getCapacity();
+    for (int32_t slot = 0; slot < capacity; slot++) {
+        if (bodies.getShapeType(slot) != BodyStore::SHAPE_HEIGHTFIELD || bodies.getShapeHull(slot) != index) continue;
+        for (const Manifold& m : manifolds) {
+            if (m.bodyA == slot) wakeIsland(m.bodyB);
+            else if (m.bodyB == slot) wakeIsland(m.bodyA);
+        }
+    }
+}
+
+bool PhysicsWorld::raycastHeightfield(int32_t slot, Vec3 origin, Vec3 direction, float maxDistance,
+                                      float& distance, Vec3& normal) const {
+    if (slot < 0 || slot >= bodies.getCapacity() || bodies.getShapeType(slot) != BodyStore::SHAPE_HEIGHTFIELD) {
+        return false;
+    }
+    ShapeInstance shape = getShapeInstance(slot);
+    if (shape.heightfield == nullptr) return false;
+
+    Quat inverse = conjugate(shape.rotation);
+    Vec3 localNormal;
+    if (!shape.heightfield->raycast(rotate(inverse, origin - shape.position), rotate(inverse, direction),
+                                    maxDistance, distance, localNormal)) {
+        return false;
+    }
+    normal = rotate(shape.rotation, localNormal);
+    return true;
+}
+
+void PhysicsWorld::raycastHeightfieldBatch(int32_t slot, const float* rays, int32_t count,
+                                           const float* maxDistances, float* distances) const {
+    for (int32_t i = 0; i < count; i++) {
+        const float* ray = rays + i * 6;
+        float distance;
+        Vec3 normal;
+        bool hit = raycastHeightfield(slot, vec3(ray[0], ray[1], ray[2]), vec3(ray[3], ray[4], ray[5]),
+                                      maxDistances[i], distance, normal);
+        distances[i] = hit ? distance : -1.0f;
+    }
+}
+
+void PhysicsWorld::removeBody(int32_t slot) {
+    if (slot >= bodies.getCapacity()) return;
+    endRewind();
+
+    // Lo que dormía apoyado en el cuerpo tiene que volver a simularse
+    wakeIsland(slot);
+    for (const Manifold& m : manifolds) {
+        if (m.bodyA == slot) wakeIsland(m.bodyB);
+        else if (m.bodyB == slot) wakeIsland(m.bodyA);
+    }
+
+    int32_t proxy = bodies.getProxy(slot);
+    if (proxy != DynamicTree::NULL_NODE) {
+        broadphase.destroyProxy(proxy);
+    }
+    bodies.removeBody(slot);
+
+    // El slot se reutiliza: no heredar impulsos
+    manifolds.erase(std::remove_if(manifolds.begin(), manifolds.end(), [slot](const Manifold& m) {
+        return m.bodyA == slot || m.bodyB == slot;
+    }), manifolds.end());
+}
+
+int32_t PhysicsWorld::step(float dt, Vec3 gravity, int32_t subSteps) {
+    // Nunca se simula sobre poses rebobinadas
+    endRewind();
+    lastDt = dt;
+    bodyIsland.resize(bodies.getCapacity(), -1);
+
+    // Dormidos escritos desde Kotlin: despierta su isla entera
+    for (int32_t slot : bodies.getWokenBodies()) {
+        wakeIsland(slot);
+    }
+    bodies.clearWoken();
+
+    // Cuerpos creados o movidos desde Kotlin desde el último step: proxies y
+    // pares al día antes de la narrowphase, así un proyectil recién creado
+    // ya tiene candidatos para la CCD en su primer step
+    if (!bodies.getChangedBodies().empty()) {
+        updateProxies(dt);
+        updatePairs();
+    }
+
+    updateContacts();
+    wakeTouching();
+    beginContinuous();
+
+    subSteps = std::max(subSteps, 1);
+    const float h = dt / static_cast<float>(subSteps);
+    solver.prepare(bodies, manifolds, h);
+
+    const int32_t groups = bodies.getCapacity() / 4;
+    for (int32_t i = 0; i < subSteps; i++) {
+        jobs.parallelFor(groups, BODY_GROUP_BATCH, [&](int32_t begin, int32_t end) {
+            bodies.integrateVelocities(h, gravity, begin * 4, end * 4);
+        });
+        solver.loadBodies(bodies, jobs);
+        solver.warmStart(jobs);
+        solver.solve(true, jobs);
+        solver.storeVelocities(bodies, jobs);
+
+        jobs.parallelFor(groups, BODY_GROUP_BATCH, [&](int32_t begin, int32_t end) {
+            bodies.integratePositions(h, begin * 4, end * 4);
+        });
+        solver.loadBodies(bodies, jobs);
+        solver.solve(false, jobs);
+        solver.storeVelocities(bodies, jobs);
+    }
+    bodies.markMoved();
+
+    solver.applyRestitution(jobs);
+    solver.storeVelocities(bodies, jobs);
+    solver.storeImpulses(manifolds);
+    bodies.clearForces();
+    solveContinuous();
+    updateSleep(dt);
+
+    updateProxies(dt);
+    updatePairs();
+
+    // Devolver sólo los cuerpos cambiados
+    packStates(bodies.getChangedBodies());
+    bodies.clearChanged();
+
+    return static_cast<int32_t>(changedSlots.size());
+}
+
+void PhysicsWorld::packStates(const std::vector<int32_t>& slots) {
+    changedSlots.assign(slots.begin(), slots.end());
+    changedStates.resize(slots.size() * BodyStore::STATE_FLOATS);
+    for (size_t i = 0; i < slots.size(); i++) {
+        bodies.getState(slots[i], &changedStates[i * BodyStore::STATE_FLOATS]);
+    }
+}
+
+Bounds PhysicsWorld::sweptBounds(int32_t slot, float dt) const {
+    Bounds bounds = bodies.getWorldBounds(slot);
+    // Continuos: la AABB barrida del próximo step tiene que quedar dentro
+    // de la gorda, si no lo que atraviesen no llega a la narrowphase
+    if (bodies.getCollisionMode(slot) != BodyStore::COLLISION_DISCRETE) {
+        Vec3 displacement = bodies.getVelocity(slot) * dt;
+        bounds = Bounds::merge(bounds, { bounds.min + displacement, bounds.max + displacement });
+    }
+    return bounds;
+}
+
+/**
+ * AABB de los cuerpos cambiados en paralelo; el árbol se modifica después en
+ * un solo hilo y en el orden de getChangedBodies()
+ */
+void PhysicsWorld::updateProxies(float dt) {
+    const std::vector<int32_t>& changed = bodies.getChangedBodies();
+    const int32_t count = static_cast<int32_t>(changed.size());
+    proxyBounds.resize(count);
+
+    jobs.parallelFor(count, PROXY_BATCH, [&](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) {
+            int32_t slot = changed[i];
+            if (bodies.getShapeType(slot) == BodyStore::SHAPE_NONE) continue;
+
+            proxyBounds[i] = sweptBounds(slot, dt);
+        }
+    });
+
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = changed[i];
+        if (bodies.getShapeType(slot) == BodyStore::SHAPE_NONE) continue;
+
+        const Bounds& bounds = proxyBounds[i];
+        Vec3 displacement = bodies.getVelocity(slot) * dt;
+        int32_t proxy = bodies.getProxy(slot);
+        if (proxy == DynamicTree::NULL_NODE) {
+            bodies.setProxy(slot, broadphase.createProxy(bounds, slot));
+        } else {
+            broadphase.moveProxy(proxy, bounds, displacement);
+        }
+    }
+}
+
+int32_t PhysicsWorld::updatePairs() {
+    broadphase.updatePairs(jobs);
+
+    const std::vector<BroadphasePair>& pairs = broadphase.getPairs();
+    pairBuffer.resize(pairs.size() * 2);
+    for (size_t i = 0; i < pairs.size(); i++) {
+        int32_t userA = broadphase.getUserData(pairs[i].proxyA);
+        int32_t userB = broadphase.getUserData(pairs[i].proxyB);
+        pairBuffer[i * 2] = std::min(userA, userB);
+        pairBuffer[i * 2 + 1] = std::max(userA, userB);
+    }
+    return static_cast<int32_t>(pairs.size());
+}
+
+ShapeInstance PhysicsWorld::getShapeInstance(int32_t slot) const {
+    Quat rotation = bodies.getRotation(slot);
+    int32_t type = bodies.getShapeType(slot);
+    int32_t hull = bodies.getShapeHull(slot);
+    bool heightfield = type == BodyStore::SHAPE_HEIGHTFIELD;
+    return {
+        type,
+        bodies.getPosition(slot) + rotate(rotation, bodies.getShapeCenter(slot)),
+        rotation,
+        bodies.getShapeExtents(slot),
+        !heightfield && hull >= 0 && hull < static_cast<int32_t>(hulls.size()) ? &hulls[hull] : nullptr,
+        heightfield && hull >= 0 && hull < static_cast<int32_t>(heightfields.size()) ? &heightfields[hull] : nullptr
+    };
+}
+
+/**
+ * GJK/EPA da un punto por step: se completa con los puntos del manifold
+ * anterior que siguen dentro del margen y no se han desplazado
+ * tangencialmente, y se reduce a MAX_MANIFOLD_POINTS
+ */
+void PhysicsWorld::mergeCachedPoints(const Manifold& previous, ContactResult& result) const {
+    Vec3 positionA = bodies.getPosition(previous.bodyA);
+    Vec3 positionB = bodies.getPosition(previous.bodyB);
+    Quat rotationA = bodies.getRotation(previous.bodyA);
+    Quat rotationB = bodies.getRotation(previous.bodyB);
+    Vec3 normal = result.normal;
+
+    Vec3 points[MAX_MANIFOLD_POINTS + 1];
+    float separations[MAX_MANIFOLD_POINTS + 1];
+    uint32_t ids[MAX_MANIFOLD_POINTS + 1];
+    int32_t count = 0;
+    uint32_t usedIds = 0;
+
+    Vec3 fresh = result.points[0];
+    float freshSeparation = result.separations[0];
+    uint32_t freshId = UINT32_MAX;
+
+    for (int32_t i = 0; i < previous.pointCount; i++) {
+        const ContactPoint& cp = previous.points[i];
+        Vec3 pointA = positionA + rotate(rotationA, cp.localA);
+        Vec3 pointB = positionB + rotate(rotationB, cp.localB);
+        Vec3 d = pointB - pointA;
+        float separation = dot(d, normal);
+        if (separation > SPECULATIVE_DISTANCE) continue;
+        if (lengthSq(d - normal * separation) > CONTACT_BREAKING_DISTANCE * CONTACT_BREAKING_DISTANCE) continue;
+
+        Vec3 midpoint = (pointA + pointB) * 0.5f;
+        if (freshId == UINT32_MAX && lengthSq(midpoint - fresh) < CONTACT_MERGE_DISTANCE * CONTACT_MERGE_DISTANCE) {
+            freshId = cp.id;
+            continue;
+        }
+        points[count] = midpoint;
+        separations[count] = separation;
+        ids[count] = cp.id;
+        usedIds |= 1u << (cp.id & 31u);
+        count++;
+    }
+
+    if (freshId == UINT32_MAX) {
+        freshId = 0;
+        while (usedIds & (1u << freshId)) freshId++;
+    }
+    points[count] = fresh;
+    separations[count] = freshSeparation;
+    ids[count] = freshId;
+    count++;
+
+    reduceContacts(points, separations, ids, count, normal, result);
+}
+
+const Manifold* PhysicsWorld::findManifold(int32_t slotA, int32_t slotB) const {
+    Manifold key;
+    key.bodyA = slotA;
+    key.bodyB = slotB;
+    auto found = std::lower_bound(manifolds.begin(), manifolds.end(), key);
+    if (found != manifolds.end() && found->bodyA == slotA && found->bodyB == slotB) {
+        return &*found;
+    }
+    return nullptr;
+}
+
+/**
+ * Narrowphase de un par en el manifold out (sin impulsos); false si no hay
+ * contacto. Sólo lee el estado del mundo: los pares van en paralelo.
+ */
+bool PhysicsWorld::collidePair(int32_t slotA, int32_t slotB, Manifold& out) const {
+    const int32_t capacity = bodies.getCapacity();
+    if (slotA >= capacity || slotB >= capacity) return false;
+    if (bodies.isTrigger(slotA) || bodies.isTrigger(slotB)) return false;
+
+    // Dos cuerpos sin masa inversa no generan impulsos
+    if (!bodies.isDynamic(slotA) && !bodies.isDynamic(slotB)) return false;
+
+    // Ninguno despierto: no se movieron, se conserva el manifold anterior
+    if (!bodies.isAwake(slotA) && !bodies.isAwake(slotB)) {
+        const Manifold* previous = findManifold(slotA, slotB);
+        if (previous == nullptr) return false;
+        out = *previous;
+        return true;
+    }
+
+    ContactResult result;
+    if (!collideShapes(getShapeInstance(slotA), getShapeInstance(slotB), SPECULATIVE_DISTANCE, result)) {
+        return false;
+    }
+
+    const Manifold* previous = findManifold(slotA, slotB);
+    if (result.incremental && previous != nullptr) {
+        mergeCachedPoints(*previous, result);
+    }
+
+    Manifold& m = out;
+    m.bodyA = slotA;
+    m.bodyB = slotB;
+
+    Vec3 positionA = bodies.getPosition(slotA);
+    Vec3 positionB = bodies.getPosition(slotB);
+    Quat inverseA = conjugate(bodies.getRotation(slotA));
+    Quat inverseB = conjugate(bodies.getRotation(slotB));
+    m.localNormal = rotate(inverseA, result.normal);
+    m.pointCount = result.pointCount;
+    for (int32_t p = 0; p < result.pointCount; p++) {
+        Vec3 half = result.normal * (0.5f * result.separations[p]);
+        ContactPoint& cp = m.points[p];
+        cp.localA = rotate(inverseA, result.points[p] - half - positionA);
+        cp.localB = rotate(inverseB, result.points[p] + half - positionB);
+        cp.separation = result.separations[p];
+        cp.id = result.ids[p];
+        cp.normalImpulse = 0.0f;
+        cp.tangentImpulse1 = 0.0f;
+        cp.tangentImpulse2 = 0.0f;
+
+        // Warm starting: mismo id de feature que en el step anterior
+        if (previous == nullptr) continue;
+        for (int32_t q = 0; q < previous->pointCount; q++) {
+            const ContactPoint& old = previous->points[q];
+            if (old.id != cp.id) continue;
+            cp.normalImpulse = old.normalImpulse;
+            cp.tangentImpulse1 = old.tangentImpulse1;
+            cp.tangentImpulse2 = old.tangentImpulse2;
+            break;
+        }
+    }
+
+    m.friction = combineMaterial(bodies.getFriction(slotA), bodies.getFriction(slotB),
+                                 bodies.getFrictionCombine(slotA), bodies.getFrictionCombine(slotB));
+    m.staticFriction = combineMaterial(bodies.getStaticFriction(slotA), bodies.getStaticFriction(slotB),
+                                       bodies.getFrictionCombine(slotA), bodies.getFrictionCombine(slotB));
+    m.restitution = combineMaterial(bodies.getRestitution(slotA), bodies.getRestitution(slotB),
+                                    bodies.getRestitutionCombine(slotA), bodies.getRestitutionCombine(slotB));
+    return true;
+}
+
+/**
+ * Narrowphase sobre los pares del broadphase y emparejado con los manifolds
+ * del step anterior: mismo par y mismo id de feature conservan sus impulsos.
+ * Los pares van por lotes en paralelo, cada uno a su casilla de
+ * pairManifolds; la compactación es secuencial en orden de par.
+ */
+void PhysicsWorld::updateContacts() {
+    const int32_t pairCount = static_cast<int32_t>(pairBuffer.size() / 2);
+    pairManifolds.resize(pairCount);
+    pairContacts.resize(pairCount);
+
+    jobs.parallelFor(pairCount, PAIR_BATCH, [this](int32_t begin, int32_t end) {
+        for (int32_t i = begin; i < end; i++) {
+            pairContacts[i] = collidePair(pairBuffer[i * 2], pairBuffer[i * 2 + 1], pairManifolds[i]) ? 1 : 0;
+        }
+    });
+
+    newManifolds.clear();
+    for (int32_t i = 0; i < pairCount; i++) {
+        if (pairContacts[i]) newManifolds.push_back(pairManifolds[i]);
+    }
+
+    // Pares en orden de proxy: a orden de slots para findManifold() y el solver
+    std::sort(newManifolds.begin(), newManifolds.end());
+    manifolds.swap(newManifolds);
+}
+
+// ========== Islas ==========
+
+void PhysicsWorld::setSleepParameters(float linearVelocity, float angularVelocity, float sleepDelay) {
+    sleepLinearVelocity = linearVelocity;
+    sleepAngularVelocity = angularVelocity;
+    timeToSleep = sleepDelay;
+
+    // Sueño desactivado: nada puede quedarse dormido
+    if (timeToSleep <= 0.0f) {
+        for (int32_t slot = 0; slot < static_cast<int32_t>(bodyIsland.size()); slot++) {
+            wakeIsland(slot);
+        }
+    }
+}
+
+void PhysicsWorld::setJointLinks(const int32_t* links, int32_t count) {
+    jointLinks.assign(links, links + count * 2);
+}
+
+void PhysicsWorld::wakeBody(int32_t slot) {
+    if (slot >= bodies.getCapacity()) return;
+    bodies.setAwake(slot, true);
+    wakeIsland(slot);
+}
+
+bool PhysicsWorld::isSleeping(int32_t slot) const {
+    return slot < static_cast<int32_t>(bodyIsland.size()) && bodyIsland[slot] >= 0;
+}
+
+int32_t PhysicsWorld::findIsland(int32_t slot) {
+    // Path halving
+    while (islandParent[slot] != slot) {
+        islandParent[slot] = islandParent[islandParent[slot]];
+        slot = islandParent[slot];
+    }
+    return slot;
+}
+
+void PhysicsWorld::uniteIslands(int32_t slotA, int32_t slotB) {
+    int32_t rootA = findIsland(slotA);
+    int32_t rootB = findIsland(slotB);
+    // Raíz el slot menor: mismas islas para el mismo orden de cuerpos
+    if (rootA < rootB) islandParent[rootB] = rootA;
+    else if (rootB < rootA) islandParent[rootA] = rootB;
+}
+
+void PhysicsWorld::wakeIsland(int32_t slot) {
+    if (slot >= static_cast<int32_t>(bodyIsland.size())) return;
+    int32_t island = bodyIsland[slot];
+    if (island < 0) return;
+
+    // Un slot eliminado y reutilizado ya no pertenece a la isla
+    for (int32_t body : sleepingIslands[island]) {
+        if (bodyIsland[body] != island) continue;
+        bodyIsland[body] = -1;
+        bodies.setAwake(body, true);
+        sleepingCount--;
+    }
+    sleepingIslands[island].clear();
+    freeIslands.push_back(island);
+}
+
+/**
+ * Tras la narrowphase: un manifold o joint entre un cuerpo despierto y uno
+ * dormido despierta la isla del dormido, que se resuelve ya en este step
+ */
+void PhysicsWorld::wakeTouching() {
+    for (const Manifold& m : manifolds) {
+        bool awakeA = bodies.isAwake(m.bodyA);
+        if (awakeA != bodies.isAwake(m.bodyB)) {
+            wakeIsland(awakeA ? m.bodyB : m.bodyA);
+        }
+    }
+
+    const int32_t capacity = bodies.getCapacity();
+    for (size_t i = 0; i + 1 < jointLinks.size(); i += 2) {
+        int32_t slotA = jointLinks[i];
+        int32_t slotB = jointLinks[i + 1];
+        if (slotA >= capacity || slotB >= capacity) continue;
+        bool awakeA = bodies.isAwake(slotA);
+        if (awakeA != bodies.isAwake(slotB)) {
+            wakeIsland(awakeA ? slotB : slotA);
+        }
+    }
+}
+
+/**
+ * Temporizadores de reposo e islas del step: union-find sobre los dinámicos
+ * despiertos y duerme las islas cuyo cuerpo más reciente en moverse lleva
+ * timeToSleep en reposo
+ */
+void PhysicsWorld::updateSleep(float dt) {
+    if (timeToSleep <= 0.0f) return;
+    bodies.updateSleepTimers(dt, sleepLinearVelocity, sleepAngularVelocity);
+
+    const int32_t capacity = bodies.getCapacity();
+    islandParent.resize(capacity);
+    islandSleepTime.resize(capacity);
+    islandRoots.resize(capacity);
+    awakeBodies.clear();
+
+    for (int32_t slot = 0; slot < capacity; slot++) {
+        if (!bodies.isAwake(slot)) continue;
+        if (!bodies.isDynamic(slot)) {
+            // Sin masa: no integra, así que parado duerme ya y setStates() lo
+            // despierta; un cinemático con velocidad sigue despierto y
+            // despierta lo que toca
+            if (lengthSq(bodies.getVelocity(slot)) == 0.0f && lengthSq(bodies.getAngularVelocity(slot)) == 0.0f) {
+                bodies.setAwake(slot, false);
+            }
+            continue;
+        }
+        islandParent[slot] = slot;
+        islandSleepTime[slot] = bodies.getSleepTime(slot);
+        islandRoots[slot] = -1;
+        awakeBodies.push_back(slot);
+    }
+    if (awakeBodies.empty()) return;
+
+    // Los estáticos no unen islas: una pila en el suelo no arrastra a otra
+    for (const Manifold& m : manifolds) {
+        if (bodies.isAwake(m.bodyA) && bodies.isDynamic(m.bodyA) &&
+            bodies.isAwake(m.bodyB) && bodies.isDynamic(m.bodyB)) {
+            uniteIslands(m.bodyA, m.bodyB);
+        }
+    }
+    for (size_t i = 0; i + 1 < jointLinks.size(); i += 2) {
+        int32_t slotA = jointLinks[i];
+        int32_t slotB = jointLinks[i + 1];
+        if (slotA >= capacity || slotB >= capacity) continue;
+        if (bodies.isAwake(slotA) && bodies.isDynamic(slotA) &&
+            bodies.isAwake(slotB) && bodies.isDynamic(slotB)) {
+            uniteIslands(slotA, slotB);
+        }
+    }
+
+    for (int32_t slot : awakeBodies) {
+        int32_t root = findIsland(slot);
+        islandSleepTime[root] = std::min(islandSleepTime[root], bodies.getSleepTime(slot));
+    }
+
+    for (int32_t slot : awakeBodies) {
+        int32_t root = findIsland(slot);
+        if (islandSleepTime[root] < timeToSleep) continue;
+
+        int32_t& island = islandRoots[root];
+        if (island < 0) {
+            if (!freeIslands.empty()) {
+                island = freeIslands.back();
+                freeIslands.pop_back();
+            } else {
+                island = static_cast<int32_t>(sleepingIslands.size());
+                sleepingIslands.emplace_back();
+            }
+        }
+        sleepingIslands[island].push_back(slot);
+        bodyIsland[slot] = island;
+        bodies.setAwake(slot, false);
+        // Kotlin recibe las velocidades a 0
+        bodies.markChanged(slot);
+        sleepingCount++;
+    }
+}
+
+// ========== CCD ==========
+
+// Movimiento (en fracción del semieje menor) a partir del cual un cuerpo
+// continuo pasa por el avance conservador; por debajo basta la discreta
+static constexpr float CONTINUOUS_MIN_MOTION = 0.5f;
+
+/**
+ * Pose al empezar el step de los cuerpos dinámicos con CollisionMode continuo
+ */
+void PhysicsWorld::beginContinuous() {
+    continuousBodies.clear();
+    const int32_t capacity = bodies.getCapacity();
+    for (int32_t slot = 0; slot < capacity; slot++) {
+        if (bodies.getCollisionMode(slot) == BodyStore::COLLISION_DISCRETE) continue;
+        if (bodies.getShapeType(slot) == BodyStore::SHAPE_NONE || bodies.isTrigger(slot)) continue;
+        if (bodies.getInvMass(slot) == 0.0f || !bodies.isAwake(slot)) continue;
+        continuousBodies.push_back({ slot, bodies.getPosition(slot), bodies.getRotation(slot) });
+    }
+}
+
+/**
+ * CCD por avance conservador tras el solver: cada cuerpo continuo que se
+ * movió más de lo que la narrowphase discreta recoge consulta el árbol con
+ * la AABB barrida del step y, contra cada candidato en su pose final, busca
+ * el tiempo de impacto. El cuerpo se queda en el primero, con su velocidad:
+ * el contacto del siguiente step lo frena. CONTINUOUS sólo mira cuerpos sin
+ * masa; CONTINUOUS_DYNAMIC también los dinámicos.
+ */
+void PhysicsWorld::solveContinuous() {
+    for (const ContinuousBody& body : continuousBodies) {
+        const int32_t slot = body.slot;
+        ShapeInstance end = getShapeInstance(slot);
+        ShapeInstance start = end;
+        start.position = body.position + rotate(body.rotation, bodies.getShapeCenter(slot));
+        start.rotation = body.rotation;
+
+        Vec3 e = end.extents;
+        float radius = length(e);
+        float minExtent = end.type == BodyStore::SHAPE_SPHERE ? e.x : std::min(e.x, std::min(e.y, e.z));
+        float motion = length(end.position - start.position) + rotationAngle(start.rotation, end.rotation) * radius;
+        if (motion < CONTINUOUS_MIN_MOTION * minExtent) continue;
+
+        // AABB barrida: esfera envolvente en la pose inicial y en la final
+        Vec3 r = vec3(radius, radius, radius);
+        Bounds sweep = Bounds::merge({ start.position - r, start.position + r }, { end.position - r, end.position + r });
+        continuousCandidates.clear();
+        broadphase.getTree().query(sweep, [&](int32_t proxy) {
+            continuousCandidates.push_back(broadphase.getUserData(proxy));
+            return true;
+        });
+
+        bool againstDynamic = bodies.getCollisionMode(slot) == BodyStore::COLLISION_CONTINUOUS_DYNAMIC;
+        float minT = 1.0f;
+        for (int32_t other : continuousCandidates) {
+            if (other == slot || bodies.isTrigger(other)) continue;
+            bool dynamic = bodies.isDynamic(other);
+            if (dynamic && !againstDynamic) continue;
+
+            minT = std::min(minT, timeOfImpact(start, end, getShapeInstance(other), ContactSolver::LINEAR_SLOP));
+        }
+        if (minT >= 1.0f) continue;
+
+        Vec3 position = body.position + (bodies.getPosition(slot) - body.position) * minT;
+        bodies.setPose(slot, position, nlerp(body.rotation, end.rotation, minT));
+    }
+}
+
+int32_t PhysicsWorld::getContactCount() const {
+    int32_t count = 0;
+    for (const Manifold& m : manifolds) {
+        count += m.pointCount;
+    }
+    return count;
+}
+
+// ========== Snapshots ==========
+
+void PhysicsWorld::refreshProxy(int32_t slot) {
+    int32_t proxy = bodies.getProxy(slot);
+    if (proxy == DynamicTree::NULL_NODE) return;
+    broadphase.moveProxy(proxy, sweptBounds(slot, lastDt), bodies.getVelocity(slot) * lastDt);
+}
+
+int32_t PhysicsWorld::rewind(int64_t timestamp, const int32_t* slots, int32_t count) {
+    endRewind();
+    int32_t index = snapshots.find(timestamp);
+    if (index < 0) return -1;
+
+    float past[BodyStore::STATE_FLOATS];
+    for (int32_t i = 0; i < count; i++) {
+        int32_t slot = slots[i];
+        if (!snapshots.read(index, slot, bodies, past)) continue;
+
+        size_t base = rewoundStates.size();
+        rewoundStates.resize(base + BodyStore::STATE_FLOATS);
+        bodies.getState(slot, &rewoundStates[base]);
+        rewoundSlots.push_back(slot);
+
+        bodies.loadState(slot, past);
+        refreshProxy(slot);
+    }
+    return static_cast<int32_t>(rewoundSlots.size());
+}
+
+void PhysicsWorld::endRewind() {
+    for (size_t i = 0; i < rewoundSlots.size(); i++) {
+        bodies.loadState(rewoundSlots[i], &rewoundStates[i * BodyStore::STATE_FLOATS]);
+        refreshProxy(rewoundSlots[i]);
+    }
+    rewoundSlots.clear();
+    rewoundStates.clear();
+}
+
+bool PhysicsWorld::readSnapshot(int64_t timestamp, const int32_t* slots, int32_t count, float* states) const {
+    int32_t index = snapshots.find(timestamp);
+    if (index < 0) return false;
+
+    for (int32_t i = 0; i < count; i++) {
+        float* out = states + i * BodyStore::STATE_FLOATS;
+        if (!snapshots.read(index, slots[i], bodies, out)) {
+            out[0] = NAN;
+        }
+    }
+    return true;
+}
+
+int32_t PhysicsWorld::restoreSnapshot(int64_t timestamp) {
+    endRewind();
+    int32_t index = snapshots.find(timestamp);
+    if (index < 0) return -1;
+
+    snapshots.restore(index, bodies, restoredSlots);
+    bodyIsland.resize(bodies.getCapacity(), -1);
+    for (int32_t slot : restoredSlots) {
+        wakeIsland(slot);
+        bodies.markChanged(slot);
+    }
+
+    // Las consultas antes del próximo step ya deben ver el estado restaurado
+    updateProxies(lastDt);
+    packStates(restoredSlots);
+    return static_cast<int32_t>(changedSlots.size());
+}
+
+// ========== Consultas de escena ==========
+
+int32_t PhysicsWorld::queryScene(const int32_t* queries, const float* params, int32_t count,
+                                 int32_t* results, float* resultFloats) {
+    const int32_t batches = (count + QUERY_BATCH - 1) / QUERY_BATCH;
+    if (static_cast<int32_t>(overlapBatches.size()) < batches) {
+        overlapBatches.resize(batches);
+    }
+
+    jobs.parallelFor(count, QUERY_BATCH, [&](int32_t begin, int32_t end) {
+        std::vector<int32_t>& overlaps = overlapBatches[begin / QUERY_BATCH];
+        overlaps.clear();
+        for (int32_t i = begin; i < end; i++) {
+            runQuery(queries + i * SceneQuery::QUERY_INTS, params + i * SceneQuery::QUERY_FLOATS,
+                     results + i * SceneQuery::RESULT_INTS, resultFloats + i * SceneQuery::RESULT_FLOATS, overlaps);
+        }
+    });
+
+    // Solapes de cada lote uno detrás de otro: el índice de cada consulta
+    // pasa de relativo a su lote a absoluto
+    overlapSlots.clear();
+    for (int32_t batch = 0; batch < batches; batch++) {
+        const int32_t base = static_cast<int32_t>(overlapSlots.size());
+        const int32_t end = std::min((batch + 1) * QUERY_BATCH, count);
+        for (int32_t i = batch * QUERY_BATCH; i < end; i++) {
+            if (SceneQuery::isOverlap(queries[i * SceneQuery::QUERY_INTS] & SceneQuery::TYPE_MASK)) {
+                results[i * SceneQuery::RESULT_INTS] += base;
+            }
+        }
+        overlapSlots.insert(overlapSlots.end(), overlapBatches[batch].begin(), overlapBatches[batch].end());
+    }
+    return static_cast<int32_t>(overlapSlots.size());
+}
+
+bool PhysicsWorld::acceptsQuery(int32_t slot, const int32_t* query) const {
+    if (slot == query[2] || bodies.getShapeType(slot) == BodyStore::SHAPE_NONE) return false;
+    // setMaterials sólo guarda capas 0..31: el desplazamiento está definido
+    if (((static_cast<uint32_t>(query[1]) >> (bodies.getLayer(slot) & 31)) & 1u) == 0) return false;
+    return (query[0] & SceneQuery::HIT_TRIGGERS) != 0 || !bodies.isTrigger(slot);
+}
+
+void PhysicsWorld::runQuery(const int32_t* query, const float* params, int32_t* result, float* resultFloats,
+                            std::vector<int32_t>& overlaps) const {
+    const int32_t type = query[0] & SceneQuery::TYPE_MASK;
+    const ShapeInstance shape = SceneQuery::queryShape(type, params);
+    const DynamicTree& tree = broadphase.getTree();
+
+    if (SceneQuery::isOverlap(type)) {
+        const int32_t first = static_cast<int32_t>(overlaps.size());
+        tree.query(shapeBounds(shape), [&](int32_t proxy) {
+            int32_t slot = broadphase.getUserData(proxy);
+            ContactResult contact;
+            if (acceptsQuery(slot, query) && collideShapes(shape, getShapeInstance(slot), 0.0f, contact)) {
+                overlaps.push_back(slot);
+            }
+            return true;
+        });
+        std::sort(overlaps.begin() + first, overlaps.end());
+        result[0] = first;
+        result[1] = static_cast<int32_t>(overlaps.size()) - first;
+        return;
+    }
+
+    const Vec3 direction = vec3(params[3], params[4], params[5]);
+    Bounds bounds = shapeBounds(shape);
+    Vec3 extents = (bounds.max - bounds.min) * 0.5f;
+
+    int32_t hitSlot = -1;
+    float hitDistance = 0.0f;
+    Vec3 hitPoint = vec3(0.0f, 0.0f, 0.0f), hitNormal = vec3(0.0f, 0.0f, 0.0f);
+    tree.raycast(shape.position, direction, params[6], extents, [&](int32_t proxy, float limit) {
+        int32_t slot = broadphase.getUserData(proxy);
+        if (!acceptsQuery(slot, query)) return limit;
+
+        ShapeInstance target = getShapeInstance(slot);
+        float distance;
+        Vec3 point, normal;
+        if (type == SceneQuery::RAYCAST) {
+            if (!raycastShape(target, shape.position, direction, limit, distance, normal)) return limit;
+            point = shape.position + direction * distance;
+        } else if (!sweepShape(shape, direction, limit, target, distance, point, normal)) {
+            return limit;
+        }
+        if (distance >= limit) return limit;
+
+        hitSlot = slot;
+        hitDistance = distance;
+        hitPoint = point;
+        hitNormal = normal;
+        return distance;
+    });
+
+    result[0] = hitSlot;
+    result[1] = hitSlot >= 0 ? 1 : 0;
+    resultFloats[0] = hitDistance;
+    resultFloats[1] = hitPoint.x;
+    resultFloats[2] = hitPoint.y;
+    resultFloats[3] = hitPoint.z;
+    resultFloats[4] = hitNormal.x;
+    resultFloats[5] = hitNormal.y;
+    resultFloats[6] = hitNormal.z;
+}
@@ -0,0 +1,308 @@
+// scene_query.cpp - Rayos, barridos y solapes contra formas de la escena
+#include "scene_query.h"
+#include "body_store.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <initializer_list>
+
+// Separación máxima a la que se buscan punto y normal tras el impacto
+static constexpr float CONTACT_MARGIN = 0.01f;
+// Paso mínimo y refinado del barrido contra heightfields
+static constexpr float MIN_HEIGHTFIELD_STEP = 0.05f;
+static constexpr int32_t BISECTION_ITERATIONS = 12;
+
+static inline float component(Vec3 v, int32_t axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+ShapeInstance SceneQuery::queryShape(int32_t type, const float* params) {
+    ShapeInstance shape;
+    shape.position = vec3(params[0], params[1], params[2]);
+    shape.rotation = { params[10], params[11], params[12], params[13] };
+    if (shape.rotation.x == 0.0f && shape.rotation.y == 0.0f && shape.rotation.z == 0.0f &&
+        shape.rotation.w == 0.0f) {
+        shape.rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    }
+    shape.hull = nullptr;
+    shape.heightfield = nullptr;
+
+    const float radius = params[7];
+    switch (type & TYPE_MASK) {
+        case SPHERE_CAST:
+        case OVERLAP_SPHERE:
+            shape.type = BodyStore::SHAPE_SPHERE;
+            shape.extents = vec3(radius, radius, radius);
+            break;
+        case CAPSULE_CAST:
+        case OVERLAP_CAPSULE:
+            shape.type = BodyStore::SHAPE_CAPSULE;
+            shape.extents = vec3(radius, params[8] + radius, radius);
+            break;
+        case OVERLAP_BOX:
+            shape.type = BodyStore::SHAPE_BOX;
+            shape.extents = vec3(params[7], params[8], params[9]);
+            break;
+        default:
+            // Rayo: un punto
+            shape.type = BodyStore::SHAPE_SPHERE;
+            shape.extents = vec3(0.0f, 0.0f, 0.0f);
+            break;
+    }
+    return shape;
+}
+
+// ========== Rayos ==========
+
+static bool raySphere(Vec3 center, float radius, Vec3 origin, Vec3 direction, float maxDistance,
+                      float& distance, Vec3& normal) {
+    Vec3 m = origin - center;
+    float c = dot(m, m) - radius * radius;
+    float b = dot(m, direction);
+    if (c <= 0.0f || b > 0.0f) return false;
+
+    float discriminant = b * b - c;
+    if (discriminant < 0.0f) return false;
+    float t = -b - std::sqrt(discriminant);
+    if (t > maxDistance) return false;
+
+    distance = t;
+    normal = (m + direction * t) * (1.0f / radius);
+    return true;
+}
+
+// Slabs en el espacio local; el eje por el que entra da la normal
+static bool rayBox(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                   float& distance, Vec3& normal) {
+    Quat inverse = conjugate(shape.rotation);
+    Vec3 o = rotate(inverse, origin - shape.position);
+    Vec3 d = rotate(inverse, direction);
+
+    float enter = -FLT_MAX, exit = maxDistance;
+    int32_t enterAxis = -1;
+    float enterSign = 0.0f;
+    for (int32_t axis = 0; axis < 3; axis++) {
+        float oa = component(o, axis), da = component(d, axis), e = component(shape.extents, axis);
+        if (std::fabs(da) < 1e-12f) {
+            if (oa < -e || oa > e) return false;
+            continue;
+        }
+        float t0 = (-e - oa) / da;
+        float t1 = (e - oa) / da;
+        if (std::fmin(t0, t1) > enter) {
+            enter = std::fmin(t0, t1);
+            enterAxis = axis;
+            enterSign = da > 0.0f ? -1.0f : 1.0f;
+        }
+        exit = std::fmin(exit, std::fmax(t0, t1));
+    }
+    if (enterAxis < 0 || enter < 0.0f || enter > exit) return false;
+
+    distance = enter;
+    Vec3 local = vec3(enterAxis == 0 ? enterSign : 0.0f, enterAxis == 1 ? enterSign : 0.0f,
+                      enterAxis == 2 ? enterSign : 0.0f);
+    normal = rotate(shape.rotation, local);
+    return true;
+}
+
+// Cilindro del segmento y, si no, la esfera de cada extremo
+static bool rayCapsule(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                       float& distance, Vec3& normal) {
+    Vec3 e = shape.extents;
+    int32_t axis = (e.x >= e.y && e.x >= e.z) ? 0 : (e.y >= e.z ? 1 : 2);
+    float radius = std::fmin(e.x, std::fmin(e.y, e.z));
+    float half = std::fmax(component(e, axis) - radius, 0.0f);
+    Vec3 localAxis = vec3(axis == 0 ? 1.0f : 0.0f, axis == 1 ? 1.0f : 0.0f, axis == 2 ? 1.0f : 0.0f);
+    Vec3 segment = rotate(shape.rotation, localAxis) * half;
+    Vec3 pa = shape.position - segment;
+    Vec3 pb = shape.position + segment;
+
+    Vec3 ba = pb - pa;
+    Vec3 oa = origin - pa;
+    float baba = dot(ba, ba);
+    float bard = dot(ba, direction);
+    float baoa = dot(ba, oa);
+
+    float best = FLT_MAX;
+    float a = baba - bard * bard;
+    if (a > 1e-8f * std::fmax(baba, 1e-8f)) {
+        float b = baba * dot(direction, oa) - baoa * bard;
+        float c = baba * dot(oa, oa) - baoa * baoa - radius * radius * baba;
+        float h = b * b - a * c;
+        if (c <= 0.0f && baoa >= 0.0f && baoa <= baba) return false;      // dentro del cilindro
+        if (h >= 0.0f) {
+            float t = (-b - std::sqrt(h)) / a;
+            float y = baoa + t * bard;
+            if (t >= 0.0f && y > 0.0f && y < baba) best = t;
+        }
+    }
+    if (best == FLT_MAX) {
+        float t;
+        Vec3 n;
+        for (Vec3 cap : { pa, pb }) {
+            if (lengthSq(origin - cap) <= radius * radius) return false;
+            if (raySphere(cap, radius, origin, direction, maxDistance, t, n) && t < best) best = t;
+        }
+    }
+    if (best > maxDistance) return false;
+
+    Vec3 point = origin + direction * best;
+    float s = baba > 1e-12f ? std::fmin(std::fmax(dot(point - pa, ba) / baba, 0.0f), 1.0f) : 0.0f;
+    Vec3 offset = point - (pa + ba * s);
+    float length = std::sqrt(lengthSq(offset));
+    distance = best;
+    normal = length > 1e-12f ? offset * (1.0f / length) : -direction;
+    return true;
+}
+
+static bool rayHeightfield(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                           float& distance, Vec3& normal) {
+    Quat inverse = conjugate(shape.rotation);
+    Vec3 localNormal;
+    if (!shape.heightfield->raycast(rotate(inverse, origin - shape.position), rotate(inverse, direction),
+                                    maxDistance, distance, localNormal)) {
+        return false;
+    }
+    normal = rotate(shape.rotation, localNormal);
+    return true;
+}
+
+/**
+ * Punto y normal (de la superficie de target hacia caster) en la pose del
+ * impacto; sin contacto, la normal opuesta al movimiento
+ */
+static void contactAt(const ShapeInstance& caster, const ShapeInstance& target, Vec3 direction,
+                      Vec3& point, Vec3& normal) {
+    ContactResult contact;
+    if (collideShapes(caster, target, CONTACT_MARGIN, contact) && contact.pointCount > 0) {
+        int32_t deepest = 0;
+        for (int32_t i = 1; i < contact.pointCount; i++) {
+            if (contact.separations[i] < contact.separations[deepest]) deepest = i;
+        }
+        point = contact.points[deepest];
+        normal = -contact.normal;
+        return;
+    }
+    point = caster.position;
+    normal = -direction;
+}
+
+// Hull: avance conservador de un punto
+static bool rayConvex(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                      float& distance, Vec3& normal) {
+    ShapeInstance start;
+    start.type = BodyStore::SHAPE_SPHERE;
+    start.position = origin;
+    start.rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    start.extents = vec3(0.0f, 0.0f, 0.0f);
+    start.hull = nullptr;
+    start.heightfield = nullptr;
+    ShapeInstance end = start;
+    end.position = origin + direction * maxDistance;
+
+    float t = timeOfImpact(start, end, shape, SceneQuery::TOLERANCE);
+    if (t >= 1.0f) return false;
+
+    distance = t * maxDistance;
+    start.position = origin + direction * distance;
+    Vec3 point;
+    contactAt(start, shape, direction, point, normal);
+    return true;
+}
+
+bool raycastShape(const ShapeInstance& shape, Vec3 origin, Vec3 direction, float maxDistance,
+                  float& distance, Vec3& normal) {
+    switch (shape.type) {
+        case BodyStore::SHAPE_SPHERE:
+            return raySphere(shape.position, shape.extents.x, origin, direction, maxDistance, distance, normal);
+        case BodyStore::SHAPE_BOX:
+            return rayBox(shape, origin, direction, maxDistance, distance, normal);
+        case BodyStore::SHAPE_CAPSULE:
+            return rayCapsule(shape, origin, direction, maxDistance, distance, normal);
+        case BodyStore::SHAPE_CONVEX:
+            // Sin hull subido se trata como su caja, igual que la narrowphase
+            if (shape.hull == nullptr || shape.hull->vertices.empty()) {
+                return rayBox(shape, origin, direction, maxDistance, distance, normal);
+            }
+            return rayConvex(shape, origin, direction, maxDistance, distance, normal);
+        case BodyStore::SHAPE_HEIGHTFIELD:
+            if (shape.heightfield == nullptr || shape.heightfield->empty()) return false;
+            return rayHeightfield(shape, origin, direction, maxDistance, distance, normal);
+        default:
+            return false;
+    }
+}
+
+// ========== Barridos ==========
+
+/**
+ * Contra un heightfield (no convexo) el avance conservador no vale: pasos
+ * del semieje menor del caster dentro de la AABB del terreno hasta el
+ * primero que toca, y bisección entre ese y el anterior
+ */
+static bool sweepHeightfield(const ShapeInstance& caster, Vec3 direction, float maxDistance,
+                             const ShapeInstance& target, float& distance) {
+    ContactResult contact;
+    if (collideShapes(caster, target, 0.0f, contact)) return false;
+
+    // Tramo del barrido dentro de la AABB del terreno ampliada por la del caster
+    Bounds casterBounds = shapeBounds(caster);
+    Vec3 reach = (casterBounds.max - casterBounds.min) * 0.5f;
+    Bounds field = shapeBounds(target);
+    float enter = 0.0f, exit = maxDistance;
+    for (int32_t axis = 0; axis < 3; axis++) {
+        float o = component(caster.position, axis), d = component(direction, axis);
+        float lo = component(field.min, axis) - component(reach, axis);
+        float hi = component(field.max, axis) + component(reach, axis);
+        if (std::fabs(d) < 1e-12f) {
+            if (o < lo || o > hi) return false;
+            continue;
+        }
+        float t0 = (lo - o) / d, t1 = (hi - o) / d;
+        enter = std::fmax(enter, std::fmin(t0, t1));
+        exit = std::fmin(exit, std::fmax(t0, t1));
+    }
+    if (enter > exit) return false;
+
+    Vec3 e = caster.extents;
+    float step = std::fmax(std::fmin(e.x, std::fmin(e.y, e.z)), MIN_HEIGHTFIELD_STEP);
+    ShapeInstance moved = caster;
+    float previous = enter;
+    for (float at = enter; ; at += step) {
+        at = std::fmin(at, exit);
+        moved.position = caster.position + direction * at;
+        if (collideShapes(moved, target, 0.0f, contact)) {
+            float lo = previous, hi = at;
+            for (int32_t i = 0; i < BISECTION_ITERATIONS; i++) {
+                float mid = 0.5f * (lo + hi);
+                moved.position = caster.position + direction * mid;
+                if (collideShapes(moved, target, 0.0f, contact)) hi = mid;
+                else lo = mid;
+            }
+            distance = lo;
+            return true;
+        }
+        previous = at;
+        if (at >= exit) return false;
+    }
+}
+
+bool sweepShape(const ShapeInstance& caster, Vec3 direction, float maxDistance, const ShapeInstance& target,
+                float& distance, Vec3& point, Vec3& normal) {
+    if (target.type == BodyStore::SHAPE_NONE) return false;
+    if (target.type == BodyStore::SHAPE_HEIGHTFIELD) {
+        if (target.heightfield == nullptr || target.heightfield->empty()) return false;
+        if (!sweepHeightfield(caster, direction, maxDistance, target, distance)) return false;
+    } else {
+        ShapeInstance end = caster;
+        end.position = caster.position + direction * maxDistance;
+        float t = timeOfImpact(caster, end, target, SceneQuery::TOLERANCE);
+        if (t >= 1.0f) return false;
+        distance = t * maxDistance;
+    }
+
+    ShapeInstance moved = caster;
+    moved.position = caster.position + direction * distance;
+    contactAt(moved, target, direction, point, normal);
+    return true;
+}
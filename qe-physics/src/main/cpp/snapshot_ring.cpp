@@ -0,0 +1,92 @@
+// snapshot_ring.cpp - Historial de estado de los cuerpos en columnas
+#include "snapshot_ring.h"
+#include <algorithm>
+#include <cstring>
+
+void SnapshotRing::setCapacity(int32_t capacity) {
+    frames.clear();
+    frames.resize(std::max(capacity, 0));
+    head = 0;
+    count = 0;
+}
+
+const SnapshotRing::Frame& SnapshotRing::at(int32_t index) const {
+    const int32_t capacity = getCapacity();
+    return frames[(head - count + index + capacity) % capacity];
+}
+
+void SnapshotRing::capture(int64_t timestamp, const BodyStore& bodies) {
+    const int32_t capacity = getCapacity();
+    if (capacity == 0) return;
+
+    // Tiempo hacia atrás: lo posterior ya no es historia
+    while (count > 0 && at(count - 1).timestamp >= timestamp) {
+        head = (head - 1 + capacity) % capacity;
+        count--;
+    }
+
+    Frame& frame = frames[head];
+    const int32_t bodyCount = bodies.getCapacity();
+    frame.timestamp = timestamp;
+    frame.bodyCount = bodyCount;
+    // Sólo crece: en régimen estable capturar no reserva memoria
+    frame.columns.resize(static_cast<size_t>(BodyStore::STATE_FLOATS) * bodyCount);
+    frame.generations.resize(bodyCount);
+
+    const size_t bytes = sizeof(float) * bodyCount;
+    for (int32_t c = 0; c < BodyStore::STATE_FLOATS; c++) {
+        std::memcpy(&frame.columns[static_cast<size_t>(c) * bodyCount], bodies.getStateColumn(c), bytes);
+    }
+    std::memcpy(frame.generations.data(), bodies.getGenerations(), sizeof(uint32_t) * bodyCount);
+
+    head = (head + 1) % capacity;
+    count = std::min(count + 1, capacity);
+}
+
+int32_t SnapshotRing::find(int64_t timestamp) const {
+    int32_t lo = 0, hi = count;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (at(mid).timestamp <= timestamp) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo - 1;
+}
+
+bool SnapshotRing::read(int32_t index, int32_t slot, const BodyStore& bodies, float* out) const {
+    const Frame& frame = at(index);
+    if (slot < 0 || slot >= frame.bodyCount || slot >= bodies.getCapacity() ||
+        frame.generations[slot] != bodies.getGenerations()[slot] || (frame.generations[slot] & 1u)) {
+        return false;
+    }
+    for (int32_t c = 0; c < BodyStore::STATE_FLOATS; c++) {
+        out[c] = frame.columns[static_cast<size_t>(c) * frame.bodyCount + slot];
+    }
+    return true;
+}
+
+void SnapshotRing::restore(int32_t index, BodyStore& bodies, std::vector<int32_t>& restored) const {
+    const Frame& frame = at(index);
+    const int32_t bodyCount = std::min(frame.bodyCount, bodies.getCapacity());
+    restored.clear();
+
+    const uint32_t* generations = bodies.getGenerations();
+    if (std::memcmp(frame.generations.data(), generations, sizeof(uint32_t) * bodyCount) == 0) {
+        const size_t bytes = sizeof(float) * bodyCount;
+        for (int32_t c = 0; c < BodyStore::STATE_FLOATS; c++) {
+            std::memcpy(bodies.getStateColumn(c), &frame.columns[static_cast<size_t>(c) * frame.bodyCount], bytes);
+        }
+        for (int32_t slot = 0; slot < bodyCount; slot++) {
+            if (!(generations[slot] & 1u)) restored.push_back(slot);
+        }
+        return;
+    }
+
+    float state[BodyStore::STATE_FLOATS];
+    for (int32_t slot = 0; slot < bodyCount; slot++) {
+        if (read(index, slot, bodies, state)) {
+            bodies.loadState(slot, state);
+            restored.push_back(slot);
+        }
+    }
+}
@@ -0,0 +1,625 @@
+package com.quantum.engine.physics
+
+import com.quantum.engine.math.Vector3
+
+/**
+ * NativePhysicsWorld - Mundo físico nativo (libquantum_physics)
+ *
+ * Cuerpos rígidos en SoA con integrador SIMD, broadphase de árbol dinámico,
+ * narrowphase y solver de contactos con manifolds persistentes. Cuerpos y
+ * proxies se identifican por el slot de cuerpo de PhysicsSystem.
+ *
+ * Sólo se envía lo que cambió: set*() y addForce() se acumulan y se mandan
+ * en una llamada JNI por tipo al hacer step(). Tras el step, changedSlots /
+ * changedStates tienen los cuerpos que se movieron, y pairs los pares del
+ * broadphase como (slotA, slotB) con slotA < slotB, ordenados y sin duplicados.
+ *
+ * El step reparte narrowphase, integración, solver y broadphase entre
+ * workers nativos con el mismo resultado para cualquier número de hilos.
+ *
+ * Los heightfields de terreno (setHeightfield) guardan las alturas
+ * cuantizadas a 16 bits y se cargan y liberan por chunk.
+ *
+ * Las islas en reposo se duermen en nativo: no integran, no pasan por la
+ * narrowphase ni el solver y no aparecen en changedSlots. Cualquier set*()
+ * o una fuerza distinta de 0 las despierta.
+ *
+ * Con snapshotCapacity > 0 guarda tras cada captureSnapshot() el estado de
+ * todos los cuerpos en un anillo nativo (un memcpy por columna): rewind()
+ * rebobina sólo algunos cuerpos para lag compensation y restoreSnapshot()
+ * hace rollback del mundo entero.
+ *
+ * queryScene() resuelve lotes de rayos, barridos y solapes contra el árbol
+ * del broadphase en una llamada, con el estado del último step().
+ */
+class NativePhysicsWorld : AutoCloseable {
+
+    private var nativeHandle: Long = nativeCreate()
+
+    private val states = BodyBatch(STATE_FLOATS)
+    private val properties = BodyBatch(PROPERTY_FLOATS)
+    private val forces = BodyBatch(FORCE_FLOATS)
+    private val shapes = BodyBatch(SHAPE_FLOATS)
+    private val materials = BodyBatch(MATERIAL_FLOATS)
+    private var shapeTypes = IntArray(64)
+    private var shapeHulls = IntArray(64)
+
+    /**
+     * Cuerpos cambiados en el último step(): estado de STATE_FLOATS por cuerpo
+     */
+    var changedSlots = IntArray(256)
+        private set
+    var changedStates = FloatArray(256 * STATE_FLOATS)
+        private set
+    var changedCount = 0
+        private set
+
+    /**
+     * Pares del último step(): [slotA0, slotB0, slotA1, slotB1, ...]
+     */
+    var pairs = IntArray(512)
+        private set
+    var pairCount = 0
+        private set
+
+    /**
+     * Slots solapados del último queryScene(), por consulta en orden de slot
+     */
+    var overlapSlots = IntArray(64)
+        private set
+    var overlapCount = 0
+        private set
+
+    /**
+     * Puntos de contacto del último step (diagnóstico)
+     */
+    val contactCount: Int
+        get() = nativeGetContactCount(nativeHandle)
+
+    /**
+     * Altura del árbol del broadphase (diagnóstico)
+     */
+    val treeHeight: Int
+        get() = nativeGetTreeHeight(nativeHandle)
+
+    /**
+     * Cuerpos dinámicos dormidos (diagnóstico)
+     */
+    val sleepingCount: Int
+        get() = nativeGetSleepingCount(nativeHandle)
+
+    /**
+     * Workers nativos del step además del hilo que llama; -1 = según núcleos
+     */
+    var workerCount: Int
+        get() = nativeGetWorkerCount(nativeHandle)
+        set(value) = nativeSetWorkerCount(nativeHandle, value)
+
+    /**
+     * JobScheduler* nativo compartido (NativeJobSystem.handle) en el que
+     * correr el step en lugar de workers propios; 0 = workers propios
+     */
+    var jobScheduler: Long = 0L
+        set(value) {
+            field = value
+            nativeSetJobScheduler(nativeHandle, value)
+        }
+
+    /**
+     * Frames del historial de snapshots; 0 lo desactiva. Cambiarlo descarta
+     * lo capturado.
+     */
+    var snapshotCapacity = 0
+        set(value) {
+            if (field != value) {
+                field = value
+                nativeSetSnapshotCapacity(nativeHandle, value)
+            }
+        }
+
+    private var sleepLinearVelocity = Float.NaN
+    private var sleepAngularVelocity = Float.NaN
+    private var timeToSleep = Float.NaN
+    private var jointLinks = IntArray(0)
+    private var jointLinkCount = 0
+
+    companion object {
+        // Posición (3), rotación xyzw (4), velocidad (3), velocidad angular (3)
+        const val STATE_FLOATS = 13
+        // Masa inversa, inercia inversa local (3), drag, angularDrag, escala de
+        // gravedad, factores lineales (3), factores angulares (3), modo de
+        // colisión (COLLISION_*)
+        const val PROPERTY_FLOATS = 14
+        // Fuerza (3), torque (3)
+        const val FORCE_FLOATS = 6
+        // Offset del centro (3), semiejes locales (3)
+        const val SHAPE_FLOATS = 6
+        // Fricción dinámica, fricción estática, rebote, combinación de
+        // fricción, combinación de rebote, trigger (0/1), capa (0-31)
+        const val MATERIAL_FLOATS = 7
+
+        // Códigos de combinación nativos: gana el mayor
+        const val COMBINE_AVERAGE = 0
+        const val COMBINE_MINIMUM = 1
+        const val COMBINE_MULTIPLY = 2
+        const val COMBINE_MAXIMUM = 3
+
+        // CollisionDetectionMode: los continuos pasan por la CCD nativa
+        const val COLLISION_DISCRETE = 0
+        const val COLLISION_CONTINUOUS = 1
+        const val COLLISION_CONTINUOUS_DYNAMIC = 2
+
+        const val SHAPE_NONE = -1
+        const val SHAPE_SPHERE = 0
+        const val SHAPE_BOX = 1
+        const val SHAPE_CAPSULE = 2
+        const val SHAPE_CONVEX = 3
+        const val SHAPE_HEIGHTFIELD = 4
+
+        // Consultas de escena: tipo | flags, máscara de capas, slot ignorado
+        const val QUERY_INTS = 3
+        // Origen (3), dirección (3), distancia máxima, semiejes (3), rotación xyzw (4)
+        const val QUERY_FLOATS = 14
+        // Slot del impacto y 1/0, o primer índice y número de solapes
+        const val RESULT_INTS = 2
+        // Distancia, punto (3), normal (3)
+        const val RESULT_FLOATS = 7
+
+        const val QUERY_RAYCAST = 0
+        const val QUERY_SPHERE_CAST = 1
+        const val QUERY_CAPSULE_CAST = 2
+        const val QUERY_OVERLAP_SPHERE = 3
+        const val QUERY_OVERLAP_CAPSULE = 4
+        const val QUERY_OVERLAP_BOX = 5
+        const val QUERY_HIT_TRIGGERS = 0x100
+
+        init {
+            System.loadLibrary("quantum_physics")
+        }
+    }
+
+    /**
+     * @param values STATE_FLOATS valores empezando en offset
+     */
+    fun setState(slot: Int, values: FloatArray, offset: Int = 0) {
+        val base = states.add(slot)
+        values.copyInto(states.data, base, offset, offset + STATE_FLOATS)
+    }
+
+    /**
+     * @param values PROPERTY_FLOATS valores empezando en offset
+     */
+    fun setProperties(slot: Int, values: FloatArray, offset: Int = 0) {
+        val base = properties.add(slot)
+        values.copyInto(properties.data, base, offset, offset + PROPERTY_FLOATS)
+    }
+
+    fun addForce(slot: Int, force: Vector3, torque: Vector3) {
+        val data = forces.data
+        val base = forces.add(slot)
+        data[base] = force.x
+        data[base + 1] = force.y
+        data[base + 2] = force.z
+        data[base + 3] = torque.x
+        data[base + 4] = torque.y
+        data[base + 5] = torque.z
+    }
+
+    /**
+     * @param hull Envolvente de setConvexHull() para SHAPE_CONVEX o
+     *             heightfield de setHeightfield() para SHAPE_HEIGHTFIELD, -1 si no
+     */
+    fun setShape(slot: Int, type: Int, center: Vector3, extents: Vector3, hull: Int = -1) {
+        val index = shapes.count
+        val base = shapes.add(slot)
+        if (index >= shapeTypes.size) {
+            shapeTypes = shapeTypes.copyOf(shapeTypes.size * 2)
+            shapeHulls = shapeHulls.copyOf(shapeHulls.size * 2)
+        }
+        shapeTypes[index] = type
+        shapeHulls[index] = hull
+
+        val data = shapes.data
+        data[base] = center.x
+        data[base + 1] = center.y
+        data[base + 2] = center.z
+        data[base + 3] = extents.x
+        data[base + 4] = extents.y
+        data[base + 5] = extents.z
+    }
+
+    /**
+     * Sube (o reemplaza) una envolvente convexa. Se envía en el momento: los
+     * setShape() que la usan van en el siguiente step().
+     *
+     * @param vertices count vértices xyz locales, centrados en el centro de la forma
+     */
+    fun setConvexHull(hull: Int, vertices: FloatArray, count: Int) {
+        nativeSetConvexHull(nativeHandle, hull, vertices, count)
+    }
+
+    /**
+     * Sube (o reemplaza) un heightfield. Se envía en el momento, como
+     * setConvexHull().
+     *
+     * @param heights columns × rows alturas, heights[z * columns + x],
+     *                relativas al centro de la forma
+     */
+    fun setHeightfield(index: Int, heights: FloatArray, columns: Int, rows: Int, cellSize: Float) {
+        nativeSetHeightfield(nativeHandle, index, heights, columns, rows, cellSize)
+    }
+
+    /**
+     * Libera las alturas de un heightfield; sus cuerpos dejan de colisionar
+     */
+    fun clearHeightfield(index: Int) {
+        nativeSetHeightfield(nativeHandle, index, null, 0, 0, 0f)
+    }
+
+    /**
+     * Raycast contra el heightfield del cuerpo slot, recorriendo sus celdas
+     *
+     * @param direction Normalizada
+     * @param outNormal Normal del impacto (3 floats)
+     * @return Distancia del impacto o -1 si no hay
+     */
+    fun raycastHeightfield(slot: Int, origin: Vector3, direction: Vector3, maxDistance: Float, outNormal: FloatArray): Float =
+        nativeRaycastHeightfield(
+            nativeHandle, slot,
+            origin.x, origin.y, origin.z,
+            direction.x, direction.y, direction.z,
+            maxDistance, outNormal
+        )
+
+    /**
+     * count rayos empaquetados (RayPacket.rays) contra el heightfield del
+     * cuerpo slot; outDistances[i] = distancia o -1
+     */
+    fun raycastHeightfieldBatch(slot: Int, rays: FloatArray, count: Int, maxDistances: FloatArray, outDistances: FloatArray) {
+        nativeRaycastHeightfieldBatch(nativeHandle, slot, rays, count, maxDistances, outDistances)
+    }
+
+    /**
+     * Material y capa de consultas del cuerpo; la capa debe estar en 0..31
+     * (un bit de LayerMask)
+     */
+    fun setMaterial(
+        slot: Int,
+        dynamicFriction: Float,
+        staticFriction: Float,
+        bounciness: Float,
+        frictionCombine: Int,
+        bounceCombine: Int,
+        isTrigger: Boolean,
+        layer: Int
+    ) {
+        require(layer in 0..31) { "Physics layer must be in 0..31, was $layer" }
+        
+        val data = materials.data
+        val base = materials.add(slot)
+        data[base] = dynamicFriction
+        data[base + 1] = staticFriction
+        data[base + 2] = bounciness
+        data[base + 3] = frictionCombine.toFloat()
+        data[base + 4] = bounceCombine.toFloat()
+        data[base + 5] = if (isTrigger) 1f else 0f
+        data[base + 6] = layer.toFloat()
+    }
+
+    /**
+     * Libera el cuerpo y su proxy. Lo pendiente de este slot se aplica antes,
+     * así un slot reutilizado en el mismo frame no hereda nada.
+     */
+    fun removeBody(slot: Int) {
+        flush()
+        nativeRemoveBody(nativeHandle, slot)
+    }
+
+    /**
+     * Umbrales de reposo; sólo se envían si cambian
+     *
+     * @param timeToSleep Segundos en reposo antes de dormir una isla; <= 0 desactiva el sueño
+     */
+    fun setSleepParameters(linearVelocity: Float, angularVelocity: Float, timeToSleep: Float) {
+        if (linearVelocity == sleepLinearVelocity && angularVelocity == sleepAngularVelocity &&
+            timeToSleep == this.timeToSleep
+        ) {
+            return
+        }
+        sleepLinearVelocity = linearVelocity
+        sleepAngularVelocity = angularVelocity
+        this.timeToSleep = timeToSleep
+        nativeSetSleepParameters(nativeHandle, linearVelocity, angularVelocity, timeToSleep)
+    }
+
+    /**
+     * Joints como aristas de las islas: count pares (slotA, slotB) que se
+     * duermen y despiertan juntos. Sólo se envían si cambian.
+     */
+    fun setJointLinks(links: IntArray, count: Int) {
+        if (count == jointLinkCount && (0 until count * 2).all { links[it] == jointLinks[it] }) return
+        jointLinks = links.copyOf(count * 2)
+        jointLinkCount = count
+        nativeSetJointLinks(nativeHandle, jointLinks, count)
+    }
+
+    /**
+     * Despierta el cuerpo y su isla en el momento
+     */
+    fun wakeBody(slot: Int) {
+        nativeWakeBody(nativeHandle, slot)
+    }
+
+    fun isSleeping(slot: Int): Boolean = nativeIsSleeping(nativeHandle, slot)
+
+    /**
+     * Guarda el estado actual de todos los cuerpos; los timestamps van en
+     * aumento y uno no posterior al último descarta los que quedaron delante
+     */
+    fun captureSnapshot(timestamp: Long) {
+        if (snapshotCapacity > 0) {
+            nativeCaptureSnapshot(nativeHandle, timestamp)
+        }
+    }
+
+    /**
+     * Lleva los cuerpos slots al último snapshot con timestamp <= el dado,
+     * proxies incluidos, sin despertarlos ni devolverlos en changedSlots.
+     * El resto del mundo no se toca. Dura hasta endRewind() o el siguiente
+     * step().
+     *
+     * @return Cuerpos rebobinados; -1 si el historial no llega tan atrás
+     */
+    fun rewind(timestamp: Long, slots: IntArray, count: Int): Int {
+        flush()
+        return nativeRewind(nativeHandle, timestamp, slots, count)
+    }
+
+    /**
+     * Devuelve los cuerpos del último rewind() a su estado actual
+     */
+    fun endRewind() {
+        nativeEndRewind(nativeHandle)
+    }
+
+    /**
+     * Estado de los cuerpos slots en el snapshot vigente en timestamp, sin
+     * tocar el mundo: STATE_FLOATS por cuerpo, NaN en el primero si el slot
+     * era de otro cuerpo
+     *
+     * @return false si el historial no llega tan atrás
+     */
+    fun readSnapshot(timestamp: Long, slots: IntArray, count: Int, outStates: FloatArray): Boolean =
+        nativeReadSnapshot(nativeHandle, timestamp, slots, count, outStates)
+
+    /**
+     * Rollback: todos los cuerpos al snapshot vigente en timestamp. Los
+     * restaurados quedan en changedSlots / changedStates como tras un step().
+     *
+     * @return false si el historial no llega tan atrás
+     */
+    fun restoreSnapshot(timestamp: Long): Boolean {
+        flush()
+        val count = nativeRestoreSnapshot(nativeHandle, timestamp)
+        if (count < 0) return false
+        fetchChangedBodies(count)
+        return true
+    }
+
+    /**
+     * Resuelve count consultas (QUERY_INTS / QUERY_FLOATS cada una) y escribe
+     * RESULT_INTS / RESULT_FLOATS por consulta. Los slots solapados quedan en
+     * overlapSlots.
+     *
+     * @return Slots solapados en total
+     */
+    fun queryScene(
+        queries: IntArray,
+        params: FloatArray,
+        count: Int,
+        outResults: IntArray,
+        outResultFloats: FloatArray
+    ): Int {
+        flush()
+        overlapCount = nativeQueryScene(nativeHandle, queries, params, count, outResults, outResultFloats)
+        if (overlapCount > overlapSlots.size) {
+            overlapSlots = IntArray(maxOf(overlapCount, overlapSlots.size * 2))
+        }
+        if (overlapCount > 0) {
+            nativeGetOverlapSlots(nativeHandle, overlapSlots)
+        }
+        return overlapCount
+    }
+
+    /**
+     * Envía los cambios pendientes, resuelve contactos, integra y actualiza el
+     * broadphase
+     *
+     * @param subSteps Substeps del solver de contactos
+     * @return Número de cuerpos cambiados
+     */
+    fun step(deltaTime: Float, gravity: Vector3, subSteps: Int): Int {
+        flush()
+
+        fetchChangedBodies(nativeStep(nativeHandle, deltaTime, gravity.x, gravity.y, gravity.z, subSteps))
+
+        pairCount = nativeGetPairCount(nativeHandle)
+        if (pairCount * 2 > pairs.size) {
+            pairs = IntArray(maxOf(pairCount * 2, pairs.size * 2))
+        }
+        if (pairCount > 0) {
+            nativeGetPairs(nativeHandle, pairs)
+        }
+        return changedCount
+    }
+
+    private fun fetchChangedBodies(count: Int) {
+        changedCount = count
+        if (changedCount > changedSlots.size) {
+            val capacity = maxOf(changedCount, changedSlots.size * 2)
+            changedSlots = IntArray(capacity)
+            changedStates = FloatArray(capacity * STATE_FLOATS)
+        }
+        if (changedCount > 0) {
+            nativeGetChangedBodies(nativeHandle, changedSlots, changedStates)
+        }
+    }
+
+    private fun flush() {
+        if (shapes.count > 0) {
+            nativeSetBodyShapes(nativeHandle, shapes.slots, shapeTypes, shapeHulls, shapes.data, shapes.count)
+            shapes.clear()
+        }
+        if (properties.count > 0) {
+            nativeSetBodyProperties(nativeHandle, properties.slots, properties.data, properties.count)
+            properties.clear()
+        }
+        if (states.count > 0) {
+            nativeSetBodyStates(nativeHandle, states.slots, states.data, states.count)
+            states.clear()
+        }
+        if (forces.count > 0) {
+            nativeAddBodyForces(nativeHandle, forces.slots, forces.data, forces.count)
+            forces.clear()
+        }
+        if (materials.count > 0) {
+            nativeSetBodyMaterials(nativeHandle, materials.slots, materials.data, materials.count)
+            materials.clear()
+        }
+    }
+
+    override fun close() {
+        if (nativeHandle != 0L) {
+            nativeDestroy(nativeHandle)
+            nativeHandle = 0
+        }
+    }
+
+    /**
+     * Lote de slots con stride floats por cuerpo
+     */
+    private class BodyBatch(private val stride: Int) {
+        var slots = IntArray(64)
+            private set
+        var data = FloatArray(64 * stride)
+            private set
+        var count = 0
+            private set
+
+        /**
+         * @return Offset en data de los floats del cuerpo añadido
+         */
+        fun add(slot: Int): Int {
+            if (count == slots.size) {
+                slots = slots.copyOf(slots.size * 2)
+                data = data.copyOf(data.size * 2)
+            }
+            slots[count] = slot
+            return count++ * stride
+        }
+
+        fun clear() {
+            count = 0
+        }
+    }
+
+    // ========== JNI Native Methods ==========
+
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+
+    private external fun nativeSetBodyStates(handle: Long, slots: IntArray, states: FloatArray, count: Int)
+    private external fun nativeSetBodyProperties(handle: Long, slots: IntArray, properties: FloatArray, count: Int)
+    private external fun nativeAddBodyForces(handle: Long, slots: IntArray, forces: FloatArray, count: Int)
+    private external fun nativeSetBodyMaterials(handle: Long, slots: IntArray, materials: FloatArray, count: Int)
+    private external fun nativeSetBodyShapes(
+        handle: Long,
+        slots: IntArray,
+        types: IntArray,
+        hulls: IntArray,
+        shapes: FloatArray,
+        count: Int
+    )
+    private external fun nativeSetConvexHull(handle: Long, hull: Int, vertices: FloatArray, count: Int)
+    private external fun nativeSetHeightfield(
+        handle: Long,
+        index: Int,
+        heights: FloatArray?,
+        columns: Int,
+        rows: Int,
+        cellSize: Float
+    )
+    private external fun nativeRaycastHeightfield(
+        handle: Long,
+        slot: Int,
+        originX: Float,
+        originY: Float,
+        originZ: Float,
+        directionX: Float,
+        directionY: Float,
+        directionZ: Float,
+        maxDistance: Float,
+        outNormal: FloatArray
+    ): Float
+    private external fun nativeRaycastHeightfieldBatch(
+        handle: Long,
+        slot: Int,
+        rays: FloatArray,
+        count: Int,
+        maxDistances: FloatArray,
+        outDistances: FloatArray
+    )
+    private external fun nativeRemoveBody(handle: Long, slot: Int)
+
+    private external fun nativeStep(
+        handle: Long,
+        dt: Float,
+        gravityX: Float,
+        gravityY: Float,
+        gravityZ: Float,
+        subSteps: Int
+    ): Int
+    private external fun nativeGetChangedBodies(handle: Long, outSlots: IntArray, outStates: FloatArray)
+    private external fun nativeGetPairCount(handle: Long): Int
+    private external fun nativeGetPairs(handle: Long, out: IntArray)
+    private external fun nativeGetContactCount(handle: Long): Int
+    private external fun nativeGetTreeHeight(handle: Long): Int
+
+    private external fun nativeSetWorkerCount(handle: Long, count: Int)
+    private external fun nativeGetWorkerCount(handle: Long): Int
+    private external fun nativeSetJobScheduler(handle: Long, scheduler: Long)
+
+    private external fun nativeSetSleepParameters(
+        handle: Long,
+        linearVelocity: Float,
+        angularVelocity: Float,
+        timeToSleep: Float
+    )
+    private external fun nativeSetJointLinks(handle: Long, links: IntArray, count: Int)
+    private external fun nativeWakeBody(handle: Long, slot: Int)
+    private external fun nativeIsSleeping(handle: Long, slot: Int): Boolean
+    private external fun nativeGetSleepingCount(handle: Long): Int
+
+    private external fun nativeSetSnapshotCapacity(handle: Long, frames: Int)
+    private external fun nativeCaptureSnapshot(handle: Long, timestamp: Long)
+    private external fun nativeRewind(handle: Long, timestamp: Long, slots: IntArray, count: Int): Int
+    private external fun nativeEndRewind(handle: Long)
+    private external fun nativeReadSnapshot(
+        handle: Long,
+        timestamp: Long,
+        slots: IntArray,
+        count: Int,
+        outStates: FloatArray
+    ): Boolean
+    private external fun nativeRestoreSnapshot(handle: Long, timestamp: Long): Int
+
+    private external fun nativeQueryScene(
+        handle: Long,
+        queries: IntArray,
+        params: FloatArray,
+        count: Int,
+        outResults: IntArray,
+        outResultFloats: FloatArray
+    ): Int
+    private external fun nativeGetOverlapSlots(handle: Long, out: IntArray)
+}
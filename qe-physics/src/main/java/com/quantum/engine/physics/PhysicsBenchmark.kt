@@ -0,0 +1,52 @@
+package com.quantum.engine.physics
+
+/**
+ * PhysicsBenchmark - Rendimiento de la narrowphase nativa por par de formas
+ *
+ * Como MathBenchmark: pensado para una pantalla de debug o el profiler en el
+ * dispositivo. Los pares se generan en nativo (misma semilla, mismos pares)
+ * y cada par de tipos se mide como la mediana de varias iteraciones.
+ */
+object PhysicsBenchmark {
+
+    data class Result(
+        val name: String,
+        val count: Int,
+        val nsPerPair: Float,
+        val hitRatio: Float
+    ) {
+        override fun toString(): String =
+            "%-18s n=%d  %.1fns/par  contacto=%.0f%%".format(name, count, nsPerPair, hitRatio * 100f)
+    }
+
+    private val SHAPE_NAMES = arrayOf("sphere", "box", "capsule", "convex", "heightfield")
+
+    init {
+        System.loadLibrary("quantum_physics")
+    }
+
+    /**
+     * Todas las combinaciones de SHAPE_SPHERE..SHAPE_CONVEX, y cada una
+     * contra SHAPE_HEIGHTFIELD
+     */
+    fun runNarrowphase(count: Int = 4096, iterations: Int = 20, seed: Int = 42): List<Result> {
+        val results = ArrayList<Result>()
+        val hitRatio = FloatArray(1)
+        for (typeA in NativePhysicsWorld.SHAPE_SPHERE..NativePhysicsWorld.SHAPE_CONVEX) {
+            for (typeB in typeA..NativePhysicsWorld.SHAPE_HEIGHTFIELD) {
+                val ns = nativeBenchmarkNarrowphase(typeA, typeB, count, iterations, seed, hitRatio)
+                results += Result("${SHAPE_NAMES[typeA]}-${SHAPE_NAMES[typeB]}", count, ns, hitRatio[0])
+            }
+        }
+        return results
+    }
+
+    private external fun nativeBenchmarkNarrowphase(
+        typeA: Int,
+        typeB: Int,
+        count: Int,
+        iterations: Int,
+        seed: Int,
+        hitRatio: FloatArray
+    ): Float
+}
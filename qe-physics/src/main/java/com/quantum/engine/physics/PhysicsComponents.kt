@@ -127,6 +127,22 @@ data class MeshColliderComponent(
     override fun clone(): Component = copy()
 }
 
+/**
+ * Heightfield Collider - Terreno por rejilla de alturas
+ * 
+ * Referencia un heightfield registrado con PhysicsSystem.registerHeightfield
+ * (por ejemplo el de un WorldChunk). Siempre estático: el Rigidbody de la
+ * entidad no integra, sea cual sea su masa.
+ */
+data class HeightfieldColliderComponent(
+    override var isTrigger: Boolean = false,
+    override var center: Vector3 = Vector3.ZERO,
+    override var material: PhysicMaterial? = null,
+    var heightfieldId: Long = 0
+) : ColliderComponent() {
+    override fun clone(): Component = copy()
+}
+
 /**
  * Material físico - Define propiedades de fricción y rebote
  */
@@ -236,8 +252,8 @@ enum class ForceMode {
  */
 enum class CollisionDetectionMode {
     DISCRETE,           // Detección discreta (más rápida)
-    CONTINUOUS,         // Detección continua (más precisa)
-    CONTINUOUS_DYNAMIC  // Continua solo con objetos dinámicos
+    CONTINUOUS,         // Continua contra cuerpos estáticos y cinemáticos
+    CONTINUOUS_DYNAMIC  // Continua también contra cuerpos dinámicos
 }
 
 /**
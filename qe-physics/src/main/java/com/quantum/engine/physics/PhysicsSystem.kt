@@ -1,17 +1,35 @@
 package com.quantum.engine.physics
 
+import com.quantum.engine.core.components.TransformComponent
 import com.quantum.engine.core.ecs.*
+import com.quantum.engine.jobs.NativeJobSystem
+import com.quantum.engine.math.NativeMath
+import com.quantum.engine.math.Quaternion
+import com.quantum.engine.math.RayPacket
 import com.quantum.engine.math.Vector3
+import com.quantum.engine.streaming.ChunkCoord
+import com.quantum.engine.streaming.WorldChunk
 import timber.log.Timber
-import kotlin.math.sqrt
 
 /**
  * PhysicsSystem - Sistema de física 3D
  * 
  * Maneja:
  * - Integración de velocidad y posición
- * - Detección de colisiones
- * - Resolución de colisiones
+ * - Detección de colisiones (broadphase y narrowphase nativas; esferas,
+ *   cajas, cápsulas, mallas convexas registradas con registerConvexMesh y
+ *   terreno por heightfield registrado con registerHeightfield, cargable
+ *   por WorldChunk)
+ * - CCD por avance conservador para cuerpos con CollisionDetectionMode continuo
+ * - Islas (contactos y joints) que se duermen en reposo y se despiertan al
+ *   tocarlas, moverlas o aplicarles fuerzas
+ * - Resolución de colisiones (solver de contactos nativo con PhysicMaterial)
+ * - Step nativo en paralelo (narrowphase, integración, solver por colores,
+ *   broadphase) y determinista con cualquier número de workers
+ * - Historial de snapshots nativo para lag compensation (rewind de las
+ *   entidades implicadas) y rollback
+ * - Consultas de escena nativas por lotes (rayos, barridos y solapes con
+ *   LayerMask) contra el árbol del broadphase
  * - Gravedad
  * - Fuerzas y torques
  */
@@ -23,48 +41,130 @@ class PhysicsSystem : IteratingSystem() {
         ComponentType.of<RigidbodyComponent>()
     )
     override val priority = -50 // Alta prioridad, después de Transform
+    override val readComponents = listOf(
+        ComponentType.of<TransformComponent>(),
+        ComponentType.of<RigidbodyComponent>(),
+        ComponentType.of<BoxColliderComponent>(),
+        ComponentType.of<SphereColliderComponent>(),
+        ComponentType.of<CapsuleColliderComponent>(),
+        ComponentType.of<MeshColliderComponent>(),
+        ComponentType.of<HeightfieldColliderComponent>(),
+        ComponentType.of<FixedJointComponent>(),
+        ComponentType.of<HingeJointComponent>(),
+        ComponentType.of<SpringJointComponent>()
+    )
+    override val writeComponents = listOf(
+        ComponentType.of<TransformComponent>(),
+        ComponentType.of<RigidbodyComponent>()
+    )
     
     // Configuración de física
     var gravity = Vector3(0f, -9.81f, 0f)
     var fixedTimeStep = 1f / 60f
+    // Substeps del solver de contactos por step fijo; 4 mantiene estables las
+    // pilas a 30Hz
+    var solverSubSteps = 4
+    
+    // Sueño: una isla cuyos cuerpos llevan timeToSleep segundos bajo ambos
+    // umbrales deja de simularse; timeToSleep <= 0 lo desactiva
+    var sleepLinearVelocity = 0.05f
+    var sleepAngularVelocity = 0.05f
+    var timeToSleep = 0.5f
+    
+    // Workers nativos del step además del hilo de juego; -1 = según núcleos.
+    // Sólo con sharedJobs = false. El resultado no depende del número de hilos.
+    var workerThreads = -1
+        set(value) {
+            if (field != value) {
+                field = value
+                if (!sharedJobs) physicsWorld.workerCount = value
+            }
+        }
+    
+    // El step corre en el pool nativo del motor (NativeJobSystem.shared)
+    // junto a culling y animación, en vez de en workers propios
+    var sharedJobs = true
+        set(value) {
+            if (field != value) {
+                field = value
+                applyJobScheduler()
+            }
+        }
+    
+    // Historial de snapshots: steps fijos que se guardan (0 = desactivado),
+    // etiquetados con snapshotClock en ms
+    var snapshotFrames = 0
+        set(value) {
+            if (field != value) {
+                field = value
+                physicsWorld.snapshotCapacity = value
+            }
+        }
+    var snapshotClock: () -> Long = { System.currentTimeMillis() }
     
-    // Spatial partitioning para optimización
-    private val spatialGrid = SpatialGrid()
+    // Mundo nativo: cuerpos en SoA + broadphase de árbol dinámico
+    private val physicsWorld = NativePhysicsWorld()
+    private val bodySlots = BodySlots()
+    private val stateScratch = FloatArray(NativePhysicsWorld.STATE_FLOATS)
+    private val propertyScratch = FloatArray(NativePhysicsWorld.PROPERTY_FLOATS)
+    private val materialScratch = FloatArray(NativePhysicsWorld.MATERIAL_FLOATS)
+    private var jointLinks = IntArray(32)
+    private var jointLinkCount = 0
+    private var snapshotSlots = IntArray(64)
     
-    // Collision pairs para esta frame
-    private val collisionPairs = mutableSetOf<Pair<Long, Long>>()
+    // Mallas convexas registradas: meshId -> envolvente nativa
+    private val convexMeshes = HashMap<Long, ConvexMesh>()
+    
+    // Heightfields registrados: id -> índice nativo; los índices de los
+    // chunks descargados se reutilizan
+    private val heightfields = HashMap<Long, TerrainHeightfield>()
+    private val freeHeightfields = ArrayDeque<Int>()
+    private var heightfieldCount = 0
+    
+    // Lotes reutilizados por raycast() y raycastBatch()
+    private val singleQuery = SceneQueryBatch(1)
+    private val rayBatch = SceneQueryBatch()
     
     override fun onInitialize(entityManager: EntityManager) {
+        applyJobScheduler()
         Timber.i("PhysicsSystem initialized - Gravity: $gravity")
     }
     
-    override fun onFixedUpdate(entityManager: EntityManager, fixedDeltaTime: Float) {
-        // Fase 1: Aplicar fuerzas
-        entities.forEach { entity ->
-            applyForces(entity, entityManager, fixedDeltaTime)
-        }
-        
-        // Fase 2: Integración (actualizar velocidades y posiciones)
-        entities.forEach { entity ->
-            integrate(entity, entityManager, fixedDeltaTime)
+    private fun applyJobScheduler() {
+        val shared = if (sharedJobs) NativeJobSystem.shared else null
+        if (shared != null) {
+            physicsWorld.jobScheduler = shared.handle
+        } else {
+            physicsWorld.jobScheduler = 0L
+            physicsWorld.workerCount = workerThreads
         }
+    }
+    
+    override fun onEntityRemoved(entity: Entity, entityManager: EntityManager) {
+        super.onEntityRemoved(entity, entityManager)
+        releaseBody(entity)
+    }
+    
+    override fun onFixedUpdate(entityManager: EntityManager, fixedDeltaTime: Float) {
+        // Altas y bajas de cuerpos desde la consulta del sistema
+        updateEntityList(entityManager)
         
-        // Fase 3: Detección de colisiones
-        spatialGrid.clear()
+        // Fase 1: Enviar a nativo lo que cambió en Kotlin (gameplay)
         entities.forEach { entity ->
-            spatialGrid.insert(entity, entityManager)
+            syncBody(entity, entityManager)
         }
-        
-        detectCollisions(entityManager)
-        
-        // Fase 4: Resolución de colisiones
-        resolveCollisions(entityManager)
-        
-        // Fase 5: Limpiar fuerzas
+        jointLinkCount = 0
         entities.forEach { entity ->
-            val rb = entityManager.getComponent<RigidbodyComponent>(entity)
-            rb?.clearForces()
+            collectJointLink(entity, entityManager)
         }
+        physicsWorld.setJointLinks(jointLinks, jointLinkCount)
+        physicsWorld.setSleepParameters(sleepLinearVelocity, sleepAngularVelocity, timeToSleep)
+        
+        // Fase 2: Contactos, fuerzas, gravedad, solver, integración y
+        // broadphase en nativo
+        physicsWorld.step(fixedDeltaTime, gravity, solverSubSteps)
+        applyChangedBodies(entityManager)
+        physicsWorld.captureSnapshot(snapshotClock())
     }
     
     override fun processEntity(
@@ -76,213 +176,274 @@ class PhysicsSystem : IteratingSystem() {
     }
     
     /**
-     * Aplica fuerzas acumuladas y gravedad
+     * Envía al cuerpo nativo el estado, las propiedades, la forma y el
+     * material que hayan cambiado desde el último step, y las fuerzas
+     * acumuladas
      */
-    private fun applyForces(
-        entity: Entity,
-        entityManager: EntityManager,
-        deltaTime: Float
-    ) {
+    private fun syncBody(entity: Entity, entityManager: EntityManager) {
         val rb = entityManager.getComponent<RigidbodyComponent>(entity) ?: return
+        val transform = entityManager.getComponent<TransformComponent>(entity) ?: return
+        val collider = getCollider(entity, entityManager)
+        val slot = bodySlots.acquire(entity)
         
-        if (rb.isKinematic) return
+        writeState(transform, rb, stateScratch)
+        if (bodySlots.updateState(slot, stateScratch, 0)) {
+            physicsWorld.setState(slot, stateScratch)
+        }
         
-        // Gravedad
-        if (rb.useGravity) {
-            rb.addForce(gravity * rb.mass, ForceMode.FORCE)
+        writeProperties(rb, collider, propertyScratch)
+        if (bodySlots.updateProperties(slot, propertyScratch)) {
+            physicsWorld.setProperties(slot, propertyScratch)
         }
         
-        // Aplicar fuerzas acumuladas
-        val acceleration = rb.force * rb.inverseMass
-        rb.velocity += acceleration * deltaTime
+        val convexMesh = convexMeshOf(collider)
+        val heightfield = heightfieldOf(collider)
+        val shapeType = when (collider) {
+            is SphereColliderComponent -> NativePhysicsWorld.SHAPE_SPHERE
+            is BoxColliderComponent -> NativePhysicsWorld.SHAPE_BOX
+            is CapsuleColliderComponent -> NativePhysicsWorld.SHAPE_CAPSULE
+            is MeshColliderComponent ->
+                if (convexMesh != null) NativePhysicsWorld.SHAPE_CONVEX else NativePhysicsWorld.SHAPE_NONE
+            is HeightfieldColliderComponent ->
+                if (heightfield != null) NativePhysicsWorld.SHAPE_HEIGHTFIELD else NativePhysicsWorld.SHAPE_NONE
+            else -> NativePhysicsWorld.SHAPE_NONE
+        }
+        val hull = convexMesh?.hull ?: heightfield?.index ?: -1
+        val center = when {
+            collider == null -> Vector3.ZERO
+            convexMesh != null -> collider.center + convexMesh.center
+            heightfield != null -> collider.center + heightfield.center
+            else -> collider.center
+        }
+        val extents = if (collider != null) colliderExtents(collider) else Vector3.ZERO
+        if (bodySlots.updateShape(slot, shapeType, hull, center, extents)) {
+            physicsWorld.setShape(slot, shapeType, center, extents, hull)
+        }
         
-        // Drag (resistencia del aire)
-        rb.velocity *= (1f - rb.drag * deltaTime).coerceAtLeast(0f)
+        writeMaterial(collider, rb.layer, materialScratch)
+        if (bodySlots.updateMaterial(slot, materialScratch)) {
+            val m = materialScratch
+            physicsWorld.setMaterial(slot, m[0], m[1], m[2], m[3].toInt(), m[4].toInt(), m[5] != 0f, m[6].toInt())
+        }
         
-        // Angular drag
-        rb.angularVelocity *= (1f - rb.angularDrag * deltaTime).coerceAtLeast(0f)
+        if (!isZero(rb.force) || !isZero(rb.torque)) {
+            physicsWorld.addForce(slot, rb.force, rb.torque)
+            rb.clearForces()
+        }
     }
     
     /**
-     * Integración de Euler semi-implícita
+     * Un joint con cuerpo conectado une las islas de ambos cuerpos
      */
-    private fun integrate(
-        entity: Entity,
-        entityManager: EntityManager,
-        deltaTime: Float
-    ) {
-        val rb = entityManager.getComponent<RigidbodyComponent>(entity) ?: return
-        val transform = entityManager.getComponent<TransformComponent>(entity) ?: return
-        
-        if (rb.isKinematic) return
-        
-        // Actualizar posición
-        transform.localPosition += rb.velocity * deltaTime
-        
-        // Actualizar rotación (simplificado)
-        if (!rb.freezeRotation) {
-            // TODO: Integración de rotación con quaternions
+    private fun collectJointLink(entity: Entity, entityManager: EntityManager) {
+        val connected = entityManager.getComponent<FixedJointComponent>(entity)?.connectedBody
+            ?: entityManager.getComponent<HingeJointComponent>(entity)?.connectedBody
+            ?: entityManager.getComponent<SpringJointComponent>(entity)?.connectedBody
+            ?: return
+        val slotA = bodySlots.slotOf(entity.id)
+        val slotB = bodySlots.slotOf(connected)
+        if (slotA == NO_SLOT || slotB == NO_SLOT) return
+        
+        if (jointLinkCount * 2 == jointLinks.size) {
+            jointLinks = jointLinks.copyOf(jointLinks.size * 2)
         }
-        
-        transform.isDirty = true
+        jointLinks[jointLinkCount * 2] = slotA
+        jointLinks[jointLinkCount * 2 + 1] = slotB
+        jointLinkCount++
     }
     
     /**
-     * Detecta colisiones entre entidades
+     * true si el cuerpo de la entidad está en una isla dormida
      */
-    private fun detectCollisions(entityManager: EntityManager) {
-        collisionPairs.clear()
-        
-        entities.forEach { entityA ->
-            val potentialCollisions = spatialGrid.query(entityA, entityManager)
-            
-            potentialCollisions.forEach { entityB ->
-                if (entityA.id < entityB.id) { // Evitar duplicados
-                    if (checkCollision(entityA, entityB, entityManager)) {
-                        collisionPairs.add(Pair(entityA.id, entityB.id))
-                    }
-                }
-            }
+    fun isSleeping(entity: Entity): Boolean {
+        val slot = bodySlots.slotOf(entity.id)
+        return slot != NO_SLOT && physicsWorld.isSleeping(slot)
+    }
+    
+    /**
+     * Despierta el cuerpo de la entidad y su isla
+     */
+    fun wakeUp(entity: Entity) {
+        val slot = bodySlots.slotOf(entity.id)
+        if (slot != NO_SLOT) {
+            physicsWorld.wakeBody(slot)
         }
     }
     
     /**
-     * Verifica colisión entre dos entidades
+     * Copia a los componentes los cuerpos que se movieron en nativo
      */
-    private fun checkCollision(
-        entityA: Entity,
-        entityB: Entity,
-        entityManager: EntityManager
-    ): Boolean {
-        val colliderA = getCollider(entityA, entityManager) ?: return false
-        val colliderB = getCollider(entityB, entityManager) ?: return false
-        
-        val transformA = entityManager.getComponent<TransformComponent>(entityA) ?: return false
-        val transformB = entityManager.getComponent<TransformComponent>(entityB) ?: return false
-        
-        // Detección por tipo de collider
-        return when {
-            colliderA is SphereColliderComponent && colliderB is SphereColliderComponent ->
-                sphereVsSphere(colliderA, transformA, colliderB, transformB)
-            
-            colliderA is BoxColliderComponent && colliderB is BoxColliderComponent ->
-                boxVsBox(colliderA, transformA, colliderB, transformB)
+    private fun applyChangedBodies(entityManager: EntityManager) {
+        val states = physicsWorld.changedStates
+        for (i in 0 until physicsWorld.changedCount) {
+            val slot = physicsWorld.changedSlots[i]
+            val id = bodySlots.entities[slot]
+            if (id == Entity.NULL.id) continue
             
-            colliderA is SphereColliderComponent && colliderB is BoxColliderComponent ->
-                sphereVsBox(colliderA, transformA, colliderB, transformB)
+            val entity = Entity(id)
+            val rb = entityManager.getComponent<RigidbodyComponent>(entity) ?: continue
+            val transform = entityManager.getComponent<TransformComponent>(entity) ?: continue
             
-            colliderA is BoxColliderComponent && colliderB is SphereColliderComponent ->
-                sphereVsBox(colliderB, transformB, colliderA, transformA)
+            val base = i * NativePhysicsWorld.STATE_FLOATS
+            transform.localPosition = Vector3(states[base], states[base + 1], states[base + 2])
+            transform.localRotation = Quaternion(states[base + 3], states[base + 4], states[base + 5], states[base + 6])
+            transform.isDirty = true
+            rb.velocity = Vector3(states[base + 7], states[base + 8], states[base + 9])
+            rb.angularVelocity = Vector3(states[base + 10], states[base + 11], states[base + 12])
             
-            else -> false // Otros tipos no implementados aún
+            // Lo escrito coincide con nativo: no se reenvía en el siguiente step
+            bodySlots.updateState(slot, states, base)
         }
     }
     
+    private fun writeState(transform: TransformComponent, rb: RigidbodyComponent, out: FloatArray) {
+        val position = transform.localPosition
+        val rotation = transform.localRotation
+        out[0] = position.x
+        out[1] = position.y
+        out[2] = position.z
+        out[3] = rotation.x
+        out[4] = rotation.y
+        out[5] = rotation.z
+        out[6] = rotation.w
+        out[7] = rb.velocity.x
+        out[8] = rb.velocity.y
+        out[9] = rb.velocity.z
+        out[10] = rb.angularVelocity.x
+        out[11] = rb.angularVelocity.y
+        out[12] = rb.angularVelocity.z
+    }
+    
     /**
-     * Colisión esfera vs esfera
+     * Propiedades del cuerpo nativo (ver NativePhysicsWorld.PROPERTY_FLOATS)
+     * 
+     * Un cuerpo cinemático no integra: masa/inercia inversas y factores a 0.
+     * El terreno (heightfield) tampoco, aunque su Rigidbody tenga masa.
      */
-    private fun sphereVsSphere(
-        a: SphereColliderComponent,
-        transformA: TransformComponent,
-        b: SphereColliderComponent,
-        transformB: TransformComponent
-    ): Boolean {
-        val centerA = transformA.localPosition + a.center
-        val centerB = transformB.localPosition + b.center
-        val distance = Vector3.distance(centerA, centerB)
-        val radiusSum = a.radius + b.radius
-        
-        return distance < radiusSum
+    private fun writeProperties(rb: RigidbodyComponent, collider: ColliderComponent?, out: FloatArray) {
+        val dynamic = !rb.isKinematic && rb.mass > 0f && collider !is HeightfieldColliderComponent
+        val rotates = dynamic && !rb.freezeRotation
+        val inertia = localInertia(rb.mass, collider)
+        
+        out[0] = if (dynamic) rb.inverseMass else 0f
+        out[1] = if (rotates && inertia.x > 0f) 1f / inertia.x else 0f
+        out[2] = if (rotates && inertia.y > 0f) 1f / inertia.y else 0f
+        out[3] = if (rotates && inertia.z > 0f) 1f / inertia.z else 0f
+        out[4] = rb.drag
+        out[5] = rb.angularDrag
+        out[6] = if (dynamic && rb.useGravity) 1f else 0f
+        
+        val c = rb.constraints
+        val freezePosition = c == RigidbodyConstraints.FREEZE_POSITION || c == RigidbodyConstraints.FREEZE_ALL
+        val freezeRotation = c == RigidbodyConstraints.FREEZE_ROTATION || c == RigidbodyConstraints.FREEZE_ALL
+        out[7] = axisFactor(dynamic, freezePosition || c == RigidbodyConstraints.FREEZE_POSITION_X)
+        out[8] = axisFactor(dynamic, freezePosition || c == RigidbodyConstraints.FREEZE_POSITION_Y)
+        out[9] = axisFactor(dynamic, freezePosition || c == RigidbodyConstraints.FREEZE_POSITION_Z)
+        out[10] = axisFactor(rotates, freezeRotation || c == RigidbodyConstraints.FREEZE_ROTATION_X)
+        out[11] = axisFactor(rotates, freezeRotation || c == RigidbodyConstraints.FREEZE_ROTATION_Y)
+        out[12] = axisFactor(rotates, freezeRotation || c == RigidbodyConstraints.FREEZE_ROTATION_Z)
+        out[13] = when (rb.collisionDetection) {
+            CollisionDetectionMode.DISCRETE -> NativePhysicsWorld.COLLISION_DISCRETE
+            CollisionDetectionMode.CONTINUOUS -> NativePhysicsWorld.COLLISION_CONTINUOUS
+            CollisionDetectionMode.CONTINUOUS_DYNAMIC -> NativePhysicsWorld.COLLISION_CONTINUOUS_DYNAMIC
+        }.toFloat()
     }
     
+    private fun axisFactor(free: Boolean, frozen: Boolean): Float = if (free && !frozen) 1f else 0f
+    
     /**
-     * Colisión caja vs caja (AABB simplificado)
+     * Material del collider (ver NativePhysicsWorld.MATERIAL_FLOATS); sin
+     * material, los valores por defecto de PhysicMaterial. La capa del
+     * Rigidbody va con el material para filtrar las consultas en nativo.
      */
-    private fun boxVsBox(
-        a: BoxColliderComponent,
-        transformA: TransformComponent,
-        b: BoxColliderComponent,
-        transformB: TransformComponent
-    ): Boolean {
-        val minA = transformA.localPosition + a.center - a.size * 0.5f
-        val maxA = transformA.localPosition + a.center + a.size * 0.5f
-        
-        val minB = transformB.localPosition + b.center - b.size * 0.5f
-        val maxB = transformB.localPosition + b.center + b.size * 0.5f
-        
-        return (minA.x <= maxB.x && maxA.x >= minB.x) &&
-               (minA.y <= maxB.y && maxA.y >= minB.y) &&
-               (minA.z <= maxB.z && maxA.z >= minB.z)
+    private fun writeMaterial(collider: ColliderComponent?, layer: Int, out: FloatArray) {
+        val material = collider?.material ?: DEFAULT_MATERIAL
+        out[0] = material.dynamicFriction
+        out[1] = material.staticFriction
+        out[2] = material.bounciness
+        out[3] = combineCode(material.frictionCombine).toFloat()
+        out[4] = combineCode(material.bounceCombine).toFloat()
+        out[5] = if (collider?.isTrigger == true) 1f else 0f
+        out[6] = layer.toFloat()
+    }
+    
+    // El orden del enum no es el de prioridad que usa nativo
+    private fun combineCode(combine: PhysicMaterialCombine): Int = when (combine) {
+        PhysicMaterialCombine.AVERAGE -> NativePhysicsWorld.COMBINE_AVERAGE
+        PhysicMaterialCombine.MINIMUM -> NativePhysicsWorld.COMBINE_MINIMUM
+        PhysicMaterialCombine.MULTIPLY -> NativePhysicsWorld.COMBINE_MULTIPLY
+        PhysicMaterialCombine.MAXIMUM -> NativePhysicsWorld.COMBINE_MAXIMUM
     }
     
     /**
-     * Colisión esfera vs caja
+     * Tensor de inercia diagonal en espacio local según la forma del collider
      */
-    private fun sphereVsBox(
-        sphere: SphereColliderComponent,
-        sphereTransform: TransformComponent,
-        box: BoxColliderComponent,
-        boxTransform: TransformComponent
-    ): Boolean {
-        val sphereCenter = sphereTransform.localPosition + sphere.center
-        val boxCenter = boxTransform.localPosition + box.center
-        val halfSize = box.size * 0.5f
-        
-        // Punto más cercano en la caja
-        val closestPoint = Vector3(
-            sphereCenter.x.coerceIn(boxCenter.x - halfSize.x, boxCenter.x + halfSize.x),
-            sphereCenter.y.coerceIn(boxCenter.y - halfSize.y, boxCenter.y + halfSize.y),
-            sphereCenter.z.coerceIn(boxCenter.z - halfSize.z, boxCenter.z + halfSize.z)
-        )
-        
-        val distance = Vector3.distance(sphereCenter, closestPoint)
-        return distance < sphere.radius
+    private fun localInertia(mass: Float, collider: ColliderComponent?): Vector3 {
+        return when (collider) {
+            is SphereColliderComponent -> {
+                val i = 0.4f * mass * collider.radius * collider.radius
+                Vector3(i, i, i)
+            }
+            is BoxColliderComponent -> boxInertia(mass, collider.size)
+            is CapsuleColliderComponent -> {
+                // Aproximada como cilindro de la altura total
+                val r = collider.radius
+                val h = collider.height
+                val axial = 0.5f * mass * r * r
+                val lateral = mass / 12f * (3f * r * r + h * h)
+                when (collider.direction) {
+                    CapsuleDirection.X_AXIS -> Vector3(axial, lateral, lateral)
+                    CapsuleDirection.Y_AXIS -> Vector3(lateral, axial, lateral)
+                    CapsuleDirection.Z_AXIS -> Vector3(lateral, lateral, axial)
+                }
+            }
+            // Malla convexa: la caja de sus bounds
+            is MeshColliderComponent -> {
+                val mesh = convexMeshOf(collider)
+                if (mesh != null) boxInertia(mass, mesh.halfExtents * 2f) else Vector3(mass / 6f, mass / 6f, mass / 6f)
+            }
+            // Cubo unidad
+            else -> Vector3(mass / 6f, mass / 6f, mass / 6f)
+        }
     }
     
+    private fun boxInertia(mass: Float, s: Vector3): Vector3 = Vector3(
+        mass / 12f * (s.y * s.y + s.z * s.z),
+        mass / 12f * (s.x * s.x + s.z * s.z),
+        mass / 12f * (s.x * s.x + s.y * s.y)
+    )
+    
+    private fun isZero(v: Vector3): Boolean = v.x == 0f && v.y == 0f && v.z == 0f
+    
     /**
-     * Resuelve colisiones aplicando impulsos
+     * Semiejes de la AABB local del collider
      */
-    private fun resolveCollisions(entityManager: EntityManager) {
-        collisionPairs.forEach { (idA, idB) ->
-            val entityA = Entity(idA)
-            val entityB = Entity(idB)
-            
-            val rbA = entityManager.getComponent<RigidbodyComponent>(entityA)
-            val rbB = entityManager.getComponent<RigidbodyComponent>(entityB)
-            
-            if (rbA == null || rbB == null) return@forEach
-            if (rbA.isKinematic && rbB.isKinematic) return@forEach
-            
-            // Calcular normal y penetración (simplificado)
-            val transformA = entityManager.getComponent<TransformComponent>(entityA) ?: return@forEach
-            val transformB = entityManager.getComponent<TransformComponent>(entityB) ?: return@forEach
-            
-            val normal = (transformB.localPosition - transformA.localPosition).normalized
-            
-            // Velocidad relativa
-            val relativeVelocity = rbB.velocity - rbA.velocity
-            val velocityAlongNormal = relativeVelocity dot normal
-            
-            // No resolver si se están separando
-            if (velocityAlongNormal > 0) return@forEach
-            
-            // Coeficiente de restitución (bounciness)
-            val restitution = 0.5f // TODO: Obtener del material
-            
-            // Calcular impulso
-            val invMassSum = rbA.inverseMass + rbB.inverseMass
-            if (invMassSum < 0.0001f) return@forEach
-            
-            val j = -(1 + restitution) * velocityAlongNormal / invMassSum
-            val impulse = normal * j
-            
-            // Aplicar impulso
-            if (!rbA.isKinematic) {
-                rbA.velocity -= impulse * rbA.inverseMass
-            }
-            if (!rbB.isKinematic) {
-                rbB.velocity += impulse * rbB.inverseMass
+    private fun colliderExtents(collider: ColliderComponent): Vector3 {
+        return when (collider) {
+            is SphereColliderComponent -> Vector3(collider.radius, collider.radius, collider.radius)
+            is BoxColliderComponent -> collider.size * 0.5f
+            is CapsuleColliderComponent -> {
+                val r = collider.radius
+                val axis = maxOf(collider.height * 0.5f, r)
+                when (collider.direction) {
+                    CapsuleDirection.X_AXIS -> Vector3(axis, r, r)
+                    CapsuleDirection.Y_AXIS -> Vector3(r, axis, r)
+                    CapsuleDirection.Z_AXIS -> Vector3(r, r, axis)
+                }
             }
+            is MeshColliderComponent -> convexMeshOf(collider)?.halfExtents ?: Vector3.ONE
+            is HeightfieldColliderComponent -> heightfieldOf(collider)?.halfExtents ?: Vector3.ZERO
+            else -> Vector3.ONE
+        }
+    }
+    
+    /**
+     * Libera el slot y el cuerpo nativo de una entidad
+     */
+    private fun releaseBody(entity: Entity) {
+        val slot = bodySlots.release(entity)
+        if (slot != NO_SLOT) {
+            physicsWorld.removeBody(slot)
         }
     }
     
@@ -293,148 +454,470 @@ class PhysicsSystem : IteratingSystem() {
         return entityManager.getComponent<SphereColliderComponent>(entity)
             ?: entityManager.getComponent<BoxColliderComponent>(entity)
             ?: entityManager.getComponent<CapsuleColliderComponent>(entity)
+            ?: entityManager.getComponent<MeshColliderComponent>(entity)
+            ?: entityManager.getComponent<HeightfieldColliderComponent>(entity)
     }
     
+    // ========== Snapshots ==========
+    
     /**
-     * Realiza un raycast en el mundo físico
+     * Lag compensation: lleva los cuerpos de las entidades a su estado en el
+     * último snapshot con timestamp <= el dado, sin tocar sus componentes ni
+     * el resto del mundo, hasta endRewind() o el siguiente step
+     *
+     * @return Cuerpos rebobinados; -1 si el historial no llega tan atrás
      */
-    fun raycast(
-        origin: Vector3,
-        direction: Vector3,
-        maxDistance: Float = Float.POSITIVE_INFINITY,
-        layerMask: LayerMask = LayerMask.ALL,
-        entityManager: EntityManager
-    ): RaycastHit? {
-        var closestHit: RaycastHit? = null
-        var closestDistance = maxDistance
+    fun rewind(timestamp: Long, entityIds: LongArray, count: Int): Int {
+        if (snapshotFrames <= 0) return -1
+        val slotCount = collectSnapshotSlots(entityIds, count)
+        return physicsWorld.rewind(timestamp, snapshotSlots, slotCount)
+    }
+    
+    /**
+     * Devuelve los cuerpos rebobinados a su estado actual
+     */
+    fun endRewind() {
+        physicsWorld.endRewind()
+    }
+    
+    /**
+     * Estado de las entidades en el snapshot vigente en timestamp, sin tocar
+     * el mundo: STATE_FLOATS por entidad, NaN en el primero si no tenía cuerpo
+     *
+     * @return false si el historial no llega tan atrás
+     */
+    fun readSnapshot(timestamp: Long, entityIds: LongArray, count: Int, outStates: FloatArray): Boolean {
+        if (snapshotFrames <= 0) return false
+        val slotCount = collectSnapshotSlots(entityIds, count)
+        return physicsWorld.readSnapshot(timestamp, snapshotSlots, slotCount, outStates)
+    }
+    
+    /**
+     * Rollback de todo el mundo al snapshot vigente en timestamp; los
+     * componentes de los cuerpos restaurados se actualizan en el momento.
+     * Los steps siguientes vuelven a capturar y descartan los posteriores.
+     */
+    fun rollback(timestamp: Long, entityManager: EntityManager): Boolean {
+        if (snapshotFrames <= 0 || !physicsWorld.restoreSnapshot(timestamp)) return false
+        applyChangedBodies(entityManager)
+        return true
+    }
+    
+    /**
+     * Slots de las entidades en snapshotSlots; sin cuerpo quedan como
+     * NO_SLOT, que nativo no restaura
+     */
+    private fun collectSnapshotSlots(entityIds: LongArray, count: Int): Int {
+        if (count > snapshotSlots.size) {
+            snapshotSlots = IntArray(maxOf(count, snapshotSlots.size * 2))
+        }
+        for (i in 0 until count) {
+            snapshotSlots[i] = bodySlots.slotOf(entityIds[i])
+        }
+        return count
+    }
+    
+    // ========== Mallas convexas ==========
+    
+    /**
+     * Registra los vértices de una malla para los MeshColliderComponent
+     * convexos que la referencian. La envolvente nativa usa los vértices
+     * centrados en sus bounds; volver a registrar un meshId la reemplaza.
+     * Las mallas cóncavas (convex = false) no colisionan.
+     *
+     * @param vertices xyz por vértice, en el espacio local de la malla
+     */
+    fun registerConvexMesh(meshId: Long, vertices: FloatArray) {
+        val count = vertices.size / 3
+        if (count == 0) return
+        
+        var minX = Float.MAX_VALUE; var minY = Float.MAX_VALUE; var minZ = Float.MAX_VALUE
+        var maxX = -Float.MAX_VALUE; var maxY = -Float.MAX_VALUE; var maxZ = -Float.MAX_VALUE
+        for (i in 0 until count) {
+            minX = minOf(minX, vertices[i * 3]); maxX = maxOf(maxX, vertices[i * 3])
+            minY = minOf(minY, vertices[i * 3 + 1]); maxY = maxOf(maxY, vertices[i * 3 + 1])
+            minZ = minOf(minZ, vertices[i * 3 + 2]); maxZ = maxOf(maxZ, vertices[i * 3 + 2])
+        }
+        val center = Vector3((minX + maxX) * 0.5f, (minY + maxY) * 0.5f, (minZ + maxZ) * 0.5f)
+        val halfExtents = Vector3((maxX - minX) * 0.5f, (maxY - minY) * 0.5f, (maxZ - minZ) * 0.5f)
+        
+        val centered = FloatArray(count * 3)
+        for (i in 0 until count) {
+            centered[i * 3] = vertices[i * 3] - center.x
+            centered[i * 3 + 1] = vertices[i * 3 + 1] - center.y
+            centered[i * 3 + 2] = vertices[i * 3 + 2] - center.z
+        }
         
-        entities.forEach { entity ->
-            val rb = entityManager.getComponent<RigidbodyComponent>(entity) ?: return@forEach
-            if (!layerMask.contains(rb.layer)) return@forEach
-            
-            val collider = getCollider(entity, entityManager) ?: return@forEach
-            val transform = entityManager.getComponent<TransformComponent>(entity) ?: return@forEach
-            
-            // Raycast por tipo de collider
-            val hit = when (collider) {
-                is SphereColliderComponent -> {
-                    raycastSphere(origin, direction, collider, transform)
-                }
-                is BoxColliderComponent -> {
-                    raycastBox(origin, direction, collider, transform)
-                }
-                else -> null
+        val hull = convexMeshes[meshId]?.hull ?: convexMeshes.size
+        physicsWorld.setConvexHull(hull, centered, count)
+        convexMeshes[meshId] = ConvexMesh(hull, center, halfExtents)
+    }
+    
+    private fun convexMeshOf(collider: ColliderComponent?): ConvexMesh? {
+        val mesh = collider as? MeshColliderComponent ?: return null
+        return if (mesh.convex) convexMeshes[mesh.meshId] else null
+    }
+    
+    private class ConvexMesh(val hull: Int, val center: Vector3, val halfExtents: Vector3)
+    
+    // ========== Terreno ==========
+    
+    /**
+     * Registra un heightfield de terreno para los HeightfieldColliderComponent
+     * que lo referencian; volver a registrar un id lo reemplaza
+     * 
+     * La rejilla queda centrada en la entidad: la muestra [0][0] está en
+     * (-(columnas - 1) · cellSize / 2, altura, -(filas - 1) · cellSize / 2).
+     * Nativo guarda las alturas cuantizadas a 16 bits (2 bytes por muestra).
+     *
+     * @param heights Alturas indexadas heights[x][z], como las de
+     *                ProceduralGenerationSystem.generateTerrain
+     * @param cellSize Separación entre muestras en metros
+     * @param heightScale Metros por unidad de altura
+     */
+    fun registerHeightfield(id: Long, heights: Array<FloatArray>, cellSize: Float, heightScale: Float = 1f) {
+        val columns = heights.size
+        val rows = if (columns > 0) heights[0].size else 0
+        if (columns < 2 || rows < 2) return
+        
+        var minHeight = Float.MAX_VALUE
+        var maxHeight = -Float.MAX_VALUE
+        for (x in 0 until columns) {
+            for (z in 0 until rows) {
+                val h = heights[x][z] * heightScale
+                minHeight = minOf(minHeight, h)
+                maxHeight = maxOf(maxHeight, h)
             }
-            
-            if (hit != null && hit.distance < closestDistance) {
-                closestDistance = hit.distance
-                closestHit = hit.copy(
-                    entity = entity.id,
-                    collider = collider
-                )
+        }
+        val middle = (minHeight + maxHeight) * 0.5f
+        
+        // Nativo: fila z, columna x, relativas al centro de la forma
+        val samples = FloatArray(columns * rows)
+        for (x in 0 until columns) {
+            for (z in 0 until rows) {
+                samples[z * columns + x] = heights[x][z] * heightScale - middle
             }
         }
         
-        return closestHit
+        val index = heightfields[id]?.index ?: freeHeightfields.removeFirstOrNull() ?: heightfieldCount++
+        physicsWorld.setHeightfield(index, samples, columns, rows, cellSize)
+        heightfields[id] = TerrainHeightfield(
+            index,
+            center = Vector3(0f, middle, 0f),
+            halfExtents = Vector3(
+                (columns - 1) * cellSize * 0.5f,
+                (maxHeight - minHeight) * 0.5f,
+                (rows - 1) * cellSize * 0.5f
+            ),
+            sampleCount = columns * rows
+        )
     }
     
     /**
-     * Raycast contra esfera
+     * Libera las alturas nativas de un heightfield; los colliders que aún lo
+     * referencian dejan de colisionar
      */
-    private fun raycastSphere(
-        origin: Vector3,
-        direction: Vector3,
-        sphere: SphereColliderComponent,
-        transform: TransformComponent
-    ): RaycastHit? {
-        val center = transform.localPosition + sphere.center
-        val oc = origin - center
-        
-        val a = direction dot direction
-        val b = 2f * (oc dot direction)
-        val c = (oc dot oc) - sphere.radius * sphere.radius
-        
-        val discriminant = b * b - 4 * a * c
-        if (discriminant < 0) return null
+    fun unregisterHeightfield(id: Long) {
+        val heightfield = heightfields.remove(id) ?: return
+        physicsWorld.clearHeightfield(heightfield.index)
+        freeHeightfields.addLast(heightfield.index)
+    }
+    
+    /**
+     * Terreno de un chunk de streaming: registra heights como heightfield
+     * (id de terrainChunkId) y crea la entidad estática que lo colisiona,
+     * centrada en center y añadida a chunk.entities
+     */
+    fun loadTerrainChunk(
+        chunk: WorldChunk,
+        heights: Array<FloatArray>,
+        cellSize: Float,
+        center: Vector3,
+        entityManager: EntityManager,
+        heightScale: Float = 1f
+    ): Entity {
+        val id = terrainChunkId(chunk.coord)
+        registerHeightfield(id, heights, cellSize, heightScale)
+        
+        val entity = entityManager.createEntity("Terrain_${chunk.coord.x}_${chunk.coord.z}")
+        entityManager.addComponent(entity, TransformComponent(localPosition = center))
+        entityManager.addComponent(entity, RigidbodyComponent(mass = 0f, useGravity = false, isKinematic = true))
+        entityManager.addComponent(entity, HeightfieldColliderComponent(heightfieldId = id))
+        chunk.entities.add(entity)
+        
+        val samples = heightfields[id]?.sampleCount ?: 0
+        chunk.memoryUsageMB += samples * HEIGHTFIELD_SAMPLE_BYTES / (1024f * 1024f)
+        return entity
+    }
+    
+    /**
+     * Destruye la entidad de terreno del chunk y libera su heightfield
+     */
+    fun unloadTerrainChunk(chunk: WorldChunk, entityManager: EntityManager) {
+        val id = terrainChunkId(chunk.coord)
+        val iterator = chunk.entities.iterator()
+        while (iterator.hasNext()) {
+            val entity = iterator.next()
+            if (entityManager.getComponent<HeightfieldColliderComponent>(entity)?.heightfieldId == id) {
+                entityManager.destroyEntity(entity)
+                iterator.remove()
+            }
+        }
         
-        val t = (-b - sqrt(discriminant)) / (2f * a)
-        if (t < 0) return null
+        val samples = heightfields[id]?.sampleCount ?: 0
+        chunk.memoryUsageMB = maxOf(0f, chunk.memoryUsageMB - samples * HEIGHTFIELD_SAMPLE_BYTES / (1024f * 1024f))
+        unregisterHeightfield(id)
+    }
+    
+    /**
+     * Id de heightfield del terreno de un chunk: (x, z) empaquetado en 64 bits
+     */
+    fun terrainChunkId(coord: ChunkCoord): Long =
+        (coord.x.toLong() shl 32) or (coord.z.toLong() and 0xFFFFFFFFL)
+    
+    private fun heightfieldOf(collider: ColliderComponent?): TerrainHeightfield? {
+        val terrain = collider as? HeightfieldColliderComponent ?: return null
+        return heightfields[terrain.heightfieldId]
+    }
+    
+    private class TerrainHeightfield(
+        val index: Int,
+        val center: Vector3,
+        val halfExtents: Vector3,
+        val sampleCount: Int
+    )
+    
+    // ========== Consultas de escena ==========
+    
+    /**
+     * Resuelve todas las consultas del lote en una llamada nativa
+     * 
+     * Las consultas ven los cuerpos como quedaron tras el último step fijo
+     * (o rewind/rollback): un transform movido fuera de la física cuenta
+     * desde el siguiente step, como en Unity sin autoSyncTransforms.
+     * ignoreEntity de cada consulta se traduce a su slot y los slots de los
+     * resultados a hitEntities / overlapEntities.
+     */
+    fun queryScene(batch: SceneQueryBatch) {
+        val count = batch.size
+        if (count == 0) return
+        val queries = batch.queries
+        for (i in 0 until count) {
+            val ignore = batch.ignoreEntities[i]
+            queries[i * NativePhysicsWorld.QUERY_INTS + 2] =
+                if (ignore == Entity.NULL.id) NO_SLOT else bodySlots.slotOf(ignore)
+        }
         
-        val point = origin + direction * t
-        val normal = (point - center).normalized
+        val overlapCount = physicsWorld.queryScene(queries, batch.params, count, batch.results, batch.resultFloats)
         
-        return RaycastHit(
-            entity = null,
-            point = point,
-            normal = normal,
-            distance = t,
-            collider = null
-        )
+        val results = batch.results
+        for (i in 0 until count) {
+            val type = queries[i * NativePhysicsWorld.QUERY_INTS] and QUERY_TYPE_MASK
+            val slot = results[i * NativePhysicsWorld.RESULT_INTS]
+            batch.hitEntities[i] = if (type < NativePhysicsWorld.QUERY_OVERLAP_SPHERE && slot != NO_SLOT) {
+                bodySlots.entities[slot]
+            } else {
+                Entity.NULL.id
+            }
+        }
+        batch.ensureOverlapCapacity(overlapCount)
+        val overlapSlots = physicsWorld.overlapSlots
+        for (i in 0 until overlapCount) {
+            batch.overlapEntities[i] = bodySlots.entities[overlapSlots[i]]
+        }
     }
     
     /**
-     * Raycast contra caja (simplificado)
+     * Realiza un raycast en el mundo físico
+     * 
+     * Un rayo por el árbol del broadphase contra las formas reales (esferas,
+     * cajas y cápsulas orientadas, convexas y terreno)
      */
-    private fun raycastBox(
+    fun raycast(
         origin: Vector3,
         direction: Vector3,
-        box: BoxColliderComponent,
-        transform: TransformComponent
+        maxDistance: Float = Float.POSITIVE_INFINITY,
+        layerMask: LayerMask = LayerMask.ALL,
+        entityManager: EntityManager
     ): RaycastHit? {
-        // Implementación simplificada AABB
-        // TODO: Implementación completa
-        return null
+        singleQuery.clear()
+        singleQuery.raycast(origin, direction, maxDistance, layerMask)
+        queryScene(singleQuery)
+        if (!singleQuery.hasHit(0)) return null
+        
+        val entityId = singleQuery.hitEntity(0)
+        return RaycastHit(
+            entity = entityId,
+            point = singleQuery.point(0),
+            normal = singleQuery.normal(0),
+            distance = singleQuery.distance(0),
+            collider = getCollider(Entity(entityId), entityManager)
+        )
+    }
+    
+    /**
+     * Raycasts por lotes (IA, line-of-sight, balas)
+     * 
+     * Lanza todos los rayos de packet en una consulta de escena nativa y
+     * escribe en hitEntities el id de la entidad más cercana de cada rayo
+     * (Entity.NULL.id = sin impacto), su slot de cuerpo en packet.hitIndices
+     * y su distancia en packet.hitDistances. packet.maxDistances queda
+     * acotado a cada impacto.
+     */
+    fun raycastBatch(
+        packet: RayPacket,
+        hitEntities: LongArray,
+        layerMask: LayerMask = LayerMask.ALL,
+        entityManager: EntityManager
+    ) {
+        require(hitEntities.size >= packet.size) { "hitEntities must hold ${packet.size} ids" }
+        val batch = rayBatch
+        batch.clear()
+        val rays = packet.rays
+        for (i in 0 until packet.size) {
+            val base = i * NativeMath.RAY_FLOATS
+            batch.raycast(
+                Vector3(rays[base], rays[base + 1], rays[base + 2]),
+                Vector3(rays[base + 3], rays[base + 4], rays[base + 5]),
+                packet.maxDistances[i], layerMask
+            )
+        }
+        queryScene(batch)
+        
+        for (i in 0 until packet.size) {
+            hitEntities[i] = batch.hitEntity(i)
+            if (batch.hasHit(i)) {
+                packet.hitIndices[i] = batch.results[i * NativePhysicsWorld.RESULT_INTS]
+                packet.hitDistances[i] = batch.distance(i)
+                packet.maxDistances[i] = batch.distance(i)
+            } else {
+                packet.hitIndices[i] = NativeMath.NO_HIT
+            }
+        }
+    }
+    
+    companion object {
+        private val DEFAULT_MATERIAL = PhysicMaterial()
+        private const val HEIGHTFIELD_SAMPLE_BYTES = 2
+        private const val QUERY_TYPE_MASK = 0xff
     }
 }
 
+private const val NO_SLOT = -1
+
 /**
- * Spatial Grid para optimización de detección de colisiones
- * Divide el espacio en celdas para reducir chequeos O(n²) a O(n)
+ * Slots de cuerpo: índice estable por entidad para el mundo nativo
+ * 
+ * El mundo nativo devuelve slots; entities[slot] traduce de vuelta a la
+ * entidad. Los slots libres se reutilizan. Guarda además la última copia de
+ * estado, propiedades, forma y material enviada o recibida de nativo, para
+ * sincronizar sólo lo que cambió.
  */
-private class SpatialGrid(
-    val cellSize: Float = 10f
-) {
-    private val grid = mutableMapOf<GridCell, MutableList<Entity>>()
+private class BodySlots {
     
-    data class GridCell(val x: Int, val y: Int, val z: Int)
+    var entities = LongArray(64)
+        private set
     
-    fun clear() {
-        grid.clear()
-    }
+    private var states = FloatArray(64 * NativePhysicsWorld.STATE_FLOATS)
+    private var properties = FloatArray(64 * NativePhysicsWorld.PROPERTY_FLOATS)
+    private var shapes = FloatArray(64 * SHAPE_MIRROR_FLOATS)
+    private var materials = FloatArray(64 * NativePhysicsWorld.MATERIAL_FLOATS)
     
-    fun insert(entity: Entity, entityManager: EntityManager) {
-        val transform = entityManager.getComponent<TransformComponent>(entity) ?: return
-        val cell = getCell(transform.localPosition)
-        
-        grid.getOrPut(cell) { mutableListOf() }.add(entity)
-    }
+    private val slotsByEntity = HashMap<Long, Int>()
+    private var freeSlots = IntArray(16)
+    private var freeCount = 0
+    private var slotCount = 0
     
-    fun query(entity: Entity, entityManager: EntityManager): List<Entity> {
-        val transform = entityManager.getComponent<TransformComponent>(entity) ?: return emptyList()
-        val cell = getCell(transform.localPosition)
+    fun acquire(entity: Entity): Int {
+        slotsByEntity[entity.id]?.let { return it }
+        
+        val slot = if (freeCount > 0) freeSlots[--freeCount] else slotCount++
+        if (slot >= entities.size) {
+            val capacity = entities.size * 2
+            entities = entities.copyOf(capacity)
+            states = states.copyOf(capacity * NativePhysicsWorld.STATE_FLOATS)
+            properties = properties.copyOf(capacity * NativePhysicsWorld.PROPERTY_FLOATS)
+            shapes = shapes.copyOf(capacity * SHAPE_MIRROR_FLOATS)
+            materials = materials.copyOf(capacity * NativePhysicsWorld.MATERIAL_FLOATS)
+        }
+        entities[slot] = entity.id
         
-        val result = mutableListOf<Entity>()
+        // NaN nunca es igual: el primer sync lo envía todo
+        states.fill(Float.NaN, slot * NativePhysicsWorld.STATE_FLOATS, (slot + 1) * NativePhysicsWorld.STATE_FLOATS)
+        properties.fill(Float.NaN, slot * NativePhysicsWorld.PROPERTY_FLOATS, (slot + 1) * NativePhysicsWorld.PROPERTY_FLOATS)
+        shapes.fill(Float.NaN, slot * SHAPE_MIRROR_FLOATS, (slot + 1) * SHAPE_MIRROR_FLOATS)
+        materials.fill(Float.NaN, slot * NativePhysicsWorld.MATERIAL_FLOATS, (slot + 1) * NativePhysicsWorld.MATERIAL_FLOATS)
         
-        // Buscar en celda actual y vecinas
-        for (dx in -1..1) {
-            for (dy in -1..1) {
-                for (dz in -1..1) {
-                    val neighborCell = GridCell(cell.x + dx, cell.y + dy, cell.z + dz)
-                    grid[neighborCell]?.let { entities ->
-                        result.addAll(entities.filter { it.id != entity.id })
-                    }
-                }
+        slotsByEntity[entity.id] = slot
+        return slot
+    }
+    
+    fun slotOf(entityId: Long): Int = slotsByEntity[entityId] ?: NO_SLOT
+    
+    /**
+     * @return El slot liberado o NO_SLOT si la entidad no tenía
+     */
+    fun release(entity: Entity): Int {
+        val slot = slotsByEntity.remove(entity.id) ?: return NO_SLOT
+        if (freeCount == freeSlots.size) {
+            freeSlots = freeSlots.copyOf(freeSlots.size * 2)
+        }
+        freeSlots[freeCount++] = slot
+        entities[slot] = Entity.NULL.id
+        return slot
+    }
+    
+    /**
+     * Guarda el estado si difiere del último; true si cambió
+     */
+    fun updateState(slot: Int, values: FloatArray, offset: Int): Boolean {
+        return updateMirror(states, slot * NativePhysicsWorld.STATE_FLOATS, values, offset, NativePhysicsWorld.STATE_FLOATS)
+    }
+    
+    fun updateProperties(slot: Int, values: FloatArray): Boolean {
+        return updateMirror(properties, slot * NativePhysicsWorld.PROPERTY_FLOATS, values, 0, NativePhysicsWorld.PROPERTY_FLOATS)
+    }
+    
+    fun updateMaterial(slot: Int, values: FloatArray): Boolean {
+        return updateMirror(materials, slot * NativePhysicsWorld.MATERIAL_FLOATS, values, 0, NativePhysicsWorld.MATERIAL_FLOATS)
+    }
+    
+    fun updateShape(slot: Int, type: Int, hull: Int, center: Vector3, extents: Vector3): Boolean {
+        val base = slot * SHAPE_MIRROR_FLOATS
+        val mirror = shapes
+        if (mirror[base] == type.toFloat() && mirror[base + 1] == hull.toFloat() &&
+            mirror[base + 2] == center.x && mirror[base + 3] == center.y && mirror[base + 4] == center.z &&
+            mirror[base + 5] == extents.x && mirror[base + 6] == extents.y && mirror[base + 7] == extents.z
+        ) {
+            return false
+        }
+        mirror[base] = type.toFloat()
+        mirror[base + 1] = hull.toFloat()
+        mirror[base + 2] = center.x
+        mirror[base + 3] = center.y
+        mirror[base + 4] = center.z
+        mirror[base + 5] = extents.x
+        mirror[base + 6] = extents.y
+        mirror[base + 7] = extents.z
+        return true
+    }
+    
+    private fun updateMirror(mirror: FloatArray, base: Int, values: FloatArray, offset: Int, count: Int): Boolean {
+        var changed = false
+        for (i in 0 until count) {
+            if (mirror[base + i] != values[offset + i]) {
+                changed = true
+                break
             }
         }
-        
-        return result
+        if (changed) {
+            values.copyInto(mirror, base, offset, offset + count)
+        }
+        return changed
     }
     
-    private fun getCell(position: Vector3): GridCell {
-        return GridCell(
-            (position.x / cellSize).toInt(),
-            (position.y / cellSize).toInt(),
-            (position.z / cellSize).toInt()
-        )
+    companion object {
+        // Tipo + hull + offset (3) + semiejes (3)
+        const val SHAPE_MIRROR_FLOATS = 8
     }
 }
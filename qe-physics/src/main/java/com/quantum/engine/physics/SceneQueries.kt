@@ -0,0 +1,243 @@
+package com.quantum.engine.physics
+
+import com.quantum.engine.core.ecs.Entity
+import com.quantum.engine.math.MathUtils
+import com.quantum.engine.math.Quaternion
+import com.quantum.engine.math.Vector3
+
+/**
+ * SceneQueryBatch - Lote de consultas de escena para PhysicsSystem.queryScene()
+ *
+ * Rayos, barridos (esfera, cápsula) y solapes (esfera, cápsula, caja) se
+ * empaquetan en arrays planos y se resuelven en una sola llamada JNI contra
+ * el árbol del broadphase, repartidos entre los workers nativos. Cada
+ * consulta filtra por LayerMask, puede ignorar una entidad (el que dispara)
+ * y deja fuera los triggers con hitTriggers = false (por defecto cuentan,
+ * como Physics.queriesHitTriggers).
+ *
+ * Tras queryScene(): hasHit / hitEntity / distance / point / normal para
+ * rayos y barridos; overlapCount / overlapEntity para solapes, en orden de
+ * slot. Los barridos que empiezan tocando un collider no lo cuentan.
+ *
+ * Se reutiliza entre frames: clear() y volver a añadir.
+ */
+class SceneQueryBatch(initialCapacity: Int = 64) {
+
+    internal var queries = IntArray(initialCapacity * NativePhysicsWorld.QUERY_INTS)
+        private set
+    internal var params = FloatArray(initialCapacity * NativePhysicsWorld.QUERY_FLOATS)
+        private set
+    internal var results = IntArray(initialCapacity * NativePhysicsWorld.RESULT_INTS)
+        private set
+    internal var resultFloats = FloatArray(initialCapacity * NativePhysicsWorld.RESULT_FLOATS)
+        private set
+    internal var ignoreEntities = LongArray(initialCapacity)
+        private set
+
+    /**
+     * Entidad del impacto de cada rayo o barrido (Entity.NULL.id = sin impacto)
+     */
+    var hitEntities = LongArray(initialCapacity)
+        private set
+
+    /**
+     * Entidades solapadas de todas las consultas; cada una tiene su tramo
+     */
+    var overlapEntities = LongArray(64)
+        private set
+
+    var size = 0
+        private set
+
+    /**
+     * @param direction Se normaliza
+     * @return Índice de la consulta
+     */
+    fun raycast(
+        origin: Vector3,
+        direction: Vector3,
+        maxDistance: Float = Float.MAX_VALUE,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = add(
+        NativePhysicsWorld.QUERY_RAYCAST, origin, direction, maxDistance,
+        0f, 0f, 0f, Quaternion.IDENTITY, layerMask, ignoreEntity, hitTriggers
+    )
+
+    /**
+     * Barrido de una esfera desde origin (su centro)
+     */
+    fun sphereCast(
+        origin: Vector3,
+        radius: Float,
+        direction: Vector3,
+        maxDistance: Float = Float.MAX_VALUE,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = add(
+        NativePhysicsWorld.QUERY_SPHERE_CAST, origin, direction, maxDistance,
+        radius, 0f, 0f, Quaternion.IDENTITY, layerMask, ignoreEntity, hitTriggers
+    )
+
+    /**
+     * Barrido de la cápsula de centros de casquete point1 y point2, como
+     * Physics.CapsuleCast
+     */
+    fun capsuleCast(
+        point1: Vector3,
+        point2: Vector3,
+        radius: Float,
+        direction: Vector3,
+        maxDistance: Float = Float.MAX_VALUE,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = addCapsule(
+        NativePhysicsWorld.QUERY_CAPSULE_CAST, point1, point2, radius, direction, maxDistance,
+        layerMask, ignoreEntity, hitTriggers
+    )
+
+    fun overlapSphere(
+        center: Vector3,
+        radius: Float,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = add(
+        NativePhysicsWorld.QUERY_OVERLAP_SPHERE, center, Vector3.ZERO, 0f,
+        radius, 0f, 0f, Quaternion.IDENTITY, layerMask, ignoreEntity, hitTriggers
+    )
+
+    fun overlapCapsule(
+        point1: Vector3,
+        point2: Vector3,
+        radius: Float,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = addCapsule(
+        NativePhysicsWorld.QUERY_OVERLAP_CAPSULE, point1, point2, radius, Vector3.ZERO, 0f,
+        layerMask, ignoreEntity, hitTriggers
+    )
+
+    fun overlapBox(
+        center: Vector3,
+        halfExtents: Vector3,
+        rotation: Quaternion = Quaternion.IDENTITY,
+        layerMask: LayerMask = LayerMask.ALL,
+        ignoreEntity: Long = Entity.NULL.id,
+        hitTriggers: Boolean = true
+    ): Int = add(
+        NativePhysicsWorld.QUERY_OVERLAP_BOX, center, Vector3.ZERO, 0f,
+        halfExtents.x, halfExtents.y, halfExtents.z, rotation, layerMask, ignoreEntity, hitTriggers
+    )
+
+    fun hasHit(index: Int): Boolean = results[index * NativePhysicsWorld.RESULT_INTS + 1] != 0
+
+    fun hitEntity(index: Int): Long = hitEntities[index]
+
+    fun distance(index: Int): Float = resultFloats[index * NativePhysicsWorld.RESULT_FLOATS]
+
+    fun point(index: Int): Vector3 {
+        val base = index * NativePhysicsWorld.RESULT_FLOATS
+        return Vector3(resultFloats[base + 1], resultFloats[base + 2], resultFloats[base + 3])
+    }
+
+    fun normal(index: Int): Vector3 {
+        val base = index * NativePhysicsWorld.RESULT_FLOATS
+        return Vector3(resultFloats[base + 4], resultFloats[base + 5], resultFloats[base + 6])
+    }
+
+    fun overlapCount(index: Int): Int = results[index * NativePhysicsWorld.RESULT_INTS + 1]
+
+    fun overlapEntity(index: Int, overlap: Int): Long =
+        overlapEntities[results[index * NativePhysicsWorld.RESULT_INTS] + overlap]
+
+    fun clear() {
+        size = 0
+    }
+
+    // Cápsula world: centro en el punto medio y eje y local hacia point2
+    private fun addCapsule(
+        type: Int,
+        point1: Vector3,
+        point2: Vector3,
+        radius: Float,
+        direction: Vector3,
+        maxDistance: Float,
+        layerMask: LayerMask,
+        ignoreEntity: Long,
+        hitTriggers: Boolean
+    ): Int {
+        val axis = point2 - point1
+        val halfSegment = axis.magnitude * 0.5f
+        val rotation = if (halfSegment > MathUtils.EPSILON) {
+            Quaternion.fromToRotation(Vector3.UP, axis)
+        } else {
+            Quaternion.IDENTITY
+        }
+        return add(
+            type, (point1 + point2) * 0.5f, direction, maxDistance,
+            radius, halfSegment, 0f, rotation, layerMask, ignoreEntity, hitTriggers
+        )
+    }
+
+    private fun add(
+        type: Int,
+        origin: Vector3,
+        direction: Vector3,
+        maxDistance: Float,
+        extentX: Float,
+        extentY: Float,
+        extentZ: Float,
+        rotation: Quaternion,
+        layerMask: LayerMask,
+        ignoreEntity: Long,
+        hitTriggers: Boolean
+    ): Int {
+        ensureCapacity(size + 1)
+        val intBase = size * NativePhysicsWorld.QUERY_INTS
+        queries[intBase] = if (hitTriggers) type or NativePhysicsWorld.QUERY_HIT_TRIGGERS else type
+        queries[intBase + 1] = layerMask.mask
+        queries[intBase + 2] = -1
+        ignoreEntities[size] = ignoreEntity
+
+        val length = direction.magnitude
+        val inverseLength = if (length > MathUtils.EPSILON) 1f / length else 0f
+        val base = size * NativePhysicsWorld.QUERY_FLOATS
+        params[base] = origin.x
+        params[base + 1] = origin.y
+        params[base + 2] = origin.z
+        params[base + 3] = direction.x * inverseLength
+        params[base + 4] = direction.y * inverseLength
+        params[base + 5] = direction.z * inverseLength
+        params[base + 6] = maxDistance.coerceAtMost(Float.MAX_VALUE)
+        params[base + 7] = extentX
+        params[base + 8] = extentY
+        params[base + 9] = extentZ
+        params[base + 10] = rotation.x
+        params[base + 11] = rotation.y
+        params[base + 12] = rotation.z
+        params[base + 13] = rotation.w
+        return size++
+    }
+
+    internal fun ensureOverlapCapacity(capacity: Int) {
+        if (capacity > overlapEntities.size) {
+            overlapEntities = LongArray(maxOf(capacity, overlapEntities.size * 2))
+        }
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= hitEntities.size) return
+        val newCapacity = maxOf(capacity, hitEntities.size * 2)
+        queries = queries.copyOf(newCapacity * NativePhysicsWorld.QUERY_INTS)
+        params = params.copyOf(newCapacity * NativePhysicsWorld.QUERY_FLOATS)
+        results = results.copyOf(newCapacity * NativePhysicsWorld.RESULT_INTS)
+        resultFloats = resultFloats.copyOf(newCapacity * NativePhysicsWorld.RESULT_FLOATS)
+        ignoreEntities = ignoreEntities.copyOf(newCapacity)
+        hitEntities = hitEntities.copyOf(newCapacity)
+    }
+}
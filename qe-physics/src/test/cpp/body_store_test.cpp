@@ -0,0 +1,158 @@
+// body_store_test.cpp - Integrador SoA, sueño y generaciones de BodyStore
+#include "body_store.h"
+#include "test_check.h"
+#include <vector>
+
+namespace {
+
+const Vec3 GRAVITY = { 0.0f, -10.0f, 0.0f };
+
+void addBody(BodyStore& bodies, int32_t slot, Vec3 position, Vec3 velocity, float invMass = 1.0f,
+             Vec3 linearFactor = { 1.0f, 1.0f, 1.0f }, float drag = 0.0f) {
+    const float state[BodyStore::STATE_FLOATS] = {
+        position.x, position.y, position.z,
+        0.0f, 0.0f, 0.0f, 1.0f,
+        velocity.x, velocity.y, velocity.z,
+        0.0f, 0.0f, 0.0f
+    };
+    const float properties[BodyStore::PROPERTY_FLOATS] = {
+        invMass, invMass, invMass, invMass,
+        drag, 0.0f, 1.0f,
+        linearFactor.x, linearFactor.y, linearFactor.z,
+        1.0f, 1.0f, 1.0f,
+        static_cast<float>(BodyStore::COLLISION_DISCRETE)
+    };
+    bodies.setStates(&slot, state, 1);
+    bodies.setProperties(&slot, properties, 1);
+}
+
+void step(BodyStore& bodies, float dt) {
+    bodies.integrateVelocities(dt, GRAVITY, 0, bodies.getCapacity());
+    bodies.integratePositions(dt, 0, bodies.getCapacity());
+    bodies.markMoved();
+}
+
+} // namespace
+
+TEST(semiImplicitEulerUsesTheNewVelocity) {
+    BodyStore bodies;
+    addBody(bodies, 0, vec3(0.0f, 10.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f));
+    CHECK(bodies.getCapacity() % 4 == 0);
+
+    step(bodies, 0.1f);
+    CHECK_NEAR(bodies.getVelocity(0).y, -1.0f, 1e-6f);
+    CHECK_NEAR(bodies.getPosition(0).y, 9.9f, 1e-5f);
+    CHECK_NEAR(bodies.getPosition(0).x, 0.1f, 1e-6f);
+
+    // Fuerza de un step: F/m·dt, y se mantiene hasta clearForces()
+    const int32_t slot = 0;
+    const float force[BodyStore::FORCE_FLOATS] = { 20.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    bodies.addForces(&slot, force, 1);
+    step(bodies, 0.1f);
+    CHECK_NEAR(bodies.getVelocity(0).x, 3.0f, 1e-5f);
+    bodies.clearForces();
+    step(bodies, 0.1f);
+    CHECK_NEAR(bodies.getVelocity(0).x, 3.0f, 1e-5f);
+}
+
+TEST(factorsDragAndEmptySlotsMaskTheIntegration) {
+    BodyStore bodies;
+    addBody(bodies, 0, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f), 1.0f, vec3(1.0f, 0.0f, 1.0f));
+    addBody(bodies, 1, vec3(0.0f, 0.0f, 0.0f), vec3(10.0f, 0.0f, 0.0f), 1.0f, vec3(1.0f, 1.0f, 1.0f), 5.0f);
+    addBody(bodies, 6, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f), 0.0f, vec3(0.0f, 0.0f, 0.0f));
+    bodies.clearChanged();
+
+    step(bodies, 0.1f);
+
+    // Eje y bloqueado: sin gravedad
+    CHECK(bodies.getVelocity(0).y == 0.0f);
+    CHECK(bodies.getPosition(0).y == 0.0f);
+
+    // Drag: v *= 1 - drag·dt
+    CHECK_NEAR(bodies.getVelocity(1).x, 5.0f, 1e-5f);
+
+    // Estático y slots vacíos del relleno quietos; sólo el 1 se movió
+    CHECK(bodies.getPosition(6).y == 0.0f);
+    CHECK(bodies.getChangedBodies().size() == 1);
+    CHECK(bodies.getChangedBodies()[0] == 1);
+}
+
+TEST(disjointRangesGiveTheSameResultAsOnePass) {
+    BodyStore whole;
+    BodyStore split;
+    for (int32_t slot = 0; slot < 16; slot++) {
+        const Vec3 velocity = vec3(0.1f * slot, 0.5f, -0.2f * slot);
+        addBody(whole, slot, vec3(float(slot), 0.0f, 0.0f), velocity, 1.0f / (1 + slot));
+        addBody(split, slot, vec3(float(slot), 0.0f, 0.0f), velocity, 1.0f / (1 + slot));
+    }
+
+    for (int32_t i = 0; i < 10; i++) {
+        whole.integrateVelocities(1.0f / 60.0f, GRAVITY, 0, 16);
+        whole.integratePositions(1.0f / 60.0f, 0, 16);
+        for (int32_t begin = 0; begin < 16; begin += 4) {
+            split.integrateVelocities(1.0f / 60.0f, GRAVITY, begin, begin + 4);
+            split.integratePositions(1.0f / 60.0f, begin, begin + 4);
+        }
+    }
+
+    float a[BodyStore::STATE_FLOATS];
+    float b[BodyStore::STATE_FLOATS];
+    for (int32_t slot = 0; slot < 16; slot++) {
+        whole.getState(slot, a);
+        split.getState(slot, b);
+        for (int32_t i = 0; i < BodyStore::STATE_FLOATS; i++) {
+            CHECK(a[i] == b[i]);
+        }
+    }
+}
+
+TEST(sleepingBodiesStayPutUntilWokenFromKotlin) {
+    BodyStore bodies;
+    addBody(bodies, 0, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f));
+    addBody(bodies, 1, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f));
+    bodies.clearWoken();
+
+    // Quietos bajo el umbral: el tiempo en reposo crece
+    bodies.updateSleepTimers(0.25f, 0.1f, 0.1f);
+    bodies.updateSleepTimers(0.25f, 0.1f, 0.1f);
+    CHECK_NEAR(bodies.getSleepTime(0), 0.5f, 1e-6f);
+
+    bodies.setAwake(0, false);
+    bodies.clearChanged();
+    step(bodies, 0.1f);
+    CHECK(!bodies.isAwake(0));
+    CHECK(bodies.getPosition(0).y == 0.0f);
+    CHECK(bodies.getPosition(1).y < 0.0f);
+    CHECK(bodies.getChangedBodies().size() == 1);
+
+    // Una fuerza nula no lo despierta; una real sí, y queda en getWokenBodies()
+    const int32_t slot = 0;
+    const float none[BodyStore::FORCE_FLOATS] = {};
+    bodies.addForces(&slot, none, 1);
+    CHECK(!bodies.isAwake(0));
+    const float push[BodyStore::FORCE_FLOATS] = { 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    bodies.addForces(&slot, push, 1);
+    CHECK(bodies.isAwake(0));
+    CHECK(bodies.getWokenBodies().size() == 1 && bodies.getWokenBodies()[0] == 0);
+    CHECK(bodies.getSleepTime(0) == 0.0f);
+}
+
+TEST(removedSlotsChangeGeneration) {
+    BodyStore bodies;
+    addBody(bodies, 2, vec3(1.0f, 2.0f, 3.0f), vec3(0.0f, 0.0f, 0.0f));
+    const uint32_t first = bodies.getGenerations()[2];
+    CHECK((first & 1u) == 0);
+
+    bodies.removeBody(2);
+    CHECK((bodies.getGenerations()[2] & 1u) == 1);
+    CHECK(!bodies.isDynamic(2));
+    CHECK(bodies.getShapeType(2) == BodyStore::SHAPE_NONE);
+
+    addBody(bodies, 2, vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f));
+    CHECK(bodies.getGenerations()[2] != first);
+    CHECK((bodies.getGenerations()[2] & 1u) == 0);
+}
+
+int main() {
+    return runTests();
+}
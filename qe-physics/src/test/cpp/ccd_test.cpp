@@ -0,0 +1,98 @@
+// ccd_test.cpp - Tiempo de impacto y túneles de cuerpos rápidos
+#include "narrowphase.h"
+#include "test_bodies.h"
+#include "test_check.h"
+
+namespace {
+
+const Vec3 NO_GRAVITY = { 0.0f, 0.0f, 0.0f };
+const Quat IDENTITY = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+ShapeInstance sphere(Vec3 position, float radius) {
+    return { BodyStore::SHAPE_SPHERE, position, IDENTITY, vec3(radius, radius, radius), nullptr, nullptr };
+}
+
+/** Pared fina en x = 0 y una bala de 0.1 m a 300 m/s hacia ella */
+void addWallAndBullet(PhysicsWorld& world, int32_t mode) {
+    TestBody wall;
+    wall.extents = vec3(0.05f, 2.0f, 2.0f);
+    wall.invMass = 0.0f;
+    addTestBody(world, 0, wall);
+
+    TestBody bullet;
+    bullet.shape = BodyStore::SHAPE_SPHERE;
+    bullet.extents = vec3(0.1f, 0.1f, 0.1f);
+    bullet.position = vec3(-2.0f, 0.0f, 0.0f);
+    bullet.velocity = vec3(300.0f, 0.0f, 0.0f);
+    bullet.collisionMode = mode;
+    addTestBody(world, 1, bullet);
+}
+
+} // namespace
+
+TEST(timeOfImpactStopsAtTheTargetDistance) {
+    const ShapeInstance wall = { BodyStore::SHAPE_BOX, vec3(0.0f, 0.0f, 0.0f), IDENTITY,
+                                 vec3(0.05f, 2.0f, 2.0f), nullptr, nullptr };
+    // Superficie de la bala de x = -3.9 a x = 4.1: toca la pared (x = -0.05) en t = 3.85 / 8
+    const float t = timeOfImpact(sphere(vec3(-4.0f, 0.0f, 0.0f), 0.1f), sphere(vec3(4.0f, 0.0f, 0.0f), 0.1f),
+                                 wall, 0.01f);
+    CHECK(t < 1.0f);
+    CHECK_NEAR(t, (3.85f - 0.01f) / 8.0f, 0.01f);
+
+    // Pasa por encima: no llega
+    CHECK(timeOfImpact(sphere(vec3(-4.0f, 3.0f, 0.0f), 0.1f), sphere(vec3(4.0f, 3.0f, 0.0f), 0.1f),
+                       wall, 0.01f) == 1.0f);
+    // Ya en contacto en t = 0: cosa de la narrowphase discreta
+    CHECK(timeOfImpact(sphere(vec3(-0.1f, 0.0f, 0.0f), 0.1f), sphere(vec3(4.0f, 0.0f, 0.0f), 0.1f),
+                       wall, 0.01f) == 1.0f);
+}
+
+TEST(discreteBulletTunnelsThroughAThinWall) {
+    PhysicsWorld world;
+    addWallAndBullet(world, BodyStore::COLLISION_DISCRETE);
+    for (int32_t i = 0; i < 2; i++) world.step(1.0f / 60.0f, NO_GRAVITY, 1);
+    CHECK(world.getBodies().getPosition(1).x > 2.0f);
+}
+
+TEST(continuousBulletStopsAtAThinWall) {
+    PhysicsWorld world;
+    addWallAndBullet(world, BodyStore::COLLISION_CONTINUOUS);
+    for (int32_t i = 0; i < 10; i++) world.step(1.0f / 60.0f, NO_GRAVITY, 1);
+    const BodyStore& bodies = world.getBodies();
+    CHECK(bodies.getPosition(1).x < -0.05f);
+    CHECK(bodies.getPosition(1).x > -0.3f);
+    CHECK(bodies.getVelocity(1).x < 1.0f);
+}
+
+TEST(continuousModeIgnoresDynamicBodiesUnlessAskedTo) {
+    // Caja dinámica fina en el camino: sólo CONTINUOUS_DYNAMIC la ve
+    for (int32_t mode : { BodyStore::COLLISION_CONTINUOUS, BodyStore::COLLISION_CONTINUOUS_DYNAMIC }) {
+        PhysicsWorld world;
+        TestBody plate;
+        plate.extents = vec3(0.05f, 2.0f, 2.0f);
+        addTestBody(world, 0, plate);
+        TestBody bullet;
+        bullet.shape = BodyStore::SHAPE_SPHERE;
+        bullet.extents = vec3(0.1f, 0.1f, 0.1f);
+        bullet.position = vec3(-2.0f, 0.0f, 0.0f);
+        bullet.velocity = vec3(300.0f, 0.0f, 0.0f);
+        bullet.collisionMode = mode;
+        addTestBody(world, 1, bullet);
+
+        world.step(1.0f / 60.0f, NO_GRAVITY, 1);
+        const float x = world.getBodies().getPosition(1).x;
+        if (mode == BodyStore::COLLISION_CONTINUOUS) {
+            CHECK(x > 2.0f);
+        } else {
+            // Se queda ante la placa y el contacto del step siguiente la empuja
+            CHECK(x < -0.05f && x > -0.3f);
+            world.step(1.0f / 60.0f, NO_GRAVITY, 1);
+            CHECK(world.getBodies().getVelocity(0).x > 0.0f);
+            CHECK(world.getBodies().getVelocity(1).x < 300.0f);
+        }
+    }
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,155 @@
+// contact_solver_test.cpp - Reposo, pilas, fricción, rebote y colores del solver
+#include "contact_solver.h"
+#include "test_bodies.h"
+#include "test_check.h"
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const Vec3 GRAVITY = { 0.0f, -9.81f, 0.0f };
+
+void simulate(PhysicsWorld& world, int32_t steps, float dt = 1.0f / 60.0f, int32_t subSteps = 4) {
+    for (int32_t i = 0; i < steps; i++) {
+        world.step(dt, GRAVITY, subSteps);
+    }
+}
+
+Manifold makeManifold(int32_t a, int32_t b) {
+    Manifold m;
+    std::memset(&m, 0, sizeof(m));
+    m.bodyA = a;
+    m.bodyB = b;
+    m.localNormal = vec3(0.0f, 1.0f, 0.0f);
+    m.pointCount = 1;
+    m.points[0].separation = -0.01f;
+    m.friction = 0.5f;
+    m.staticFriction = 0.5f;
+    return m;
+}
+
+} // namespace
+
+TEST(boxComesToRestOnTheGround) {
+    PhysicsWorld world;
+    world.setSleepParameters(0.05f, 0.05f, 0.0f);
+    addTestGround(world, 0);
+    TestBody box;
+    box.position = vec3(0.0f, 1.0f, 0.0f);
+    addTestBody(world, 1, box);
+
+    simulate(world, 120);
+    const BodyStore& bodies = world.getBodies();
+    CHECK_NEAR(bodies.getPosition(1).y, 0.5f, 0.01f);
+    CHECK_NEAR(bodies.getPosition(1).x, 0.0f, 1e-3f);
+    CHECK(length(bodies.getVelocity(1)) < 0.01f);
+    CHECK(length(bodies.getAngularVelocity(1)) < 0.01f);
+
+    // Warm starting: el impulso guardado sostiene el peso de un substep
+    CHECK(world.getManifolds().size() == 1);
+    const Manifold& manifold = world.getManifolds()[0];
+    CHECK(manifold.pointCount == 4);
+    float impulse = 0.0f;
+    for (int32_t i = 0; i < manifold.pointCount; i++) impulse += manifold.points[i].normalImpulse;
+    CHECK_NEAR(impulse, 9.81f / 60.0f / 4.0f, 0.25f * 9.81f / 60.0f / 4.0f);
+}
+
+TEST(stackStaysUprightAtThirtyHertz) {
+    PhysicsWorld world;
+    world.setSleepParameters(0.05f, 0.05f, 0.0f);
+    addTestGround(world, 0);
+    constexpr int32_t BOXES = 6;
+    for (int32_t i = 0; i < BOXES; i++) {
+        TestBody box;
+        box.position = vec3(0.0f, 0.5f + static_cast<float>(i) * 1.0f, 0.0f);
+        addTestBody(world, 1 + i, box);
+    }
+
+    simulate(world, 300, 1.0f / 30.0f, 4);
+    const BodyStore& bodies = world.getBodies();
+    for (int32_t i = 0; i < BOXES; i++) {
+        const Vec3 position = bodies.getPosition(1 + i);
+        CHECK_NEAR(position.y, 0.5f + static_cast<float>(i) * 1.0f, 0.05f);
+        CHECK(std::fabs(position.x) < 0.01f && std::fabs(position.z) < 0.01f);
+    }
+}
+
+TEST(frictionStopsASlidingBox) {
+    PhysicsWorld world;
+    world.setSleepParameters(0.05f, 0.05f, 0.0f);
+    addTestGround(world, 0);
+    TestBody rough;
+    rough.position = vec3(-5.0f, 0.5f, 0.0f);
+    rough.velocity = vec3(3.0f, 0.0f, 0.0f);
+    addTestBody(world, 1, rough);
+    TestBody slick = rough;
+    slick.position = vec3(-5.0f, 0.5f, 5.0f);
+    slick.friction = 0.0f;
+    addTestBody(world, 2, slick);
+
+    // Suelo con fricción 0.5 y combinación media: 0.5 y 0.25
+    simulate(world, 120);
+    const BodyStore& bodies = world.getBodies();
+    CHECK(std::fabs(bodies.getVelocity(1).x) < 0.01f);
+    // v² / (2 μ g) = 9 / (2 · 0.5 · 9.81)
+    CHECK_NEAR(bodies.getPosition(1).x, -5.0f + 9.0f / 9.81f, 0.15f);
+    CHECK(bodies.getVelocity(2).x > 0.0f);
+    CHECK(bodies.getPosition(2).x > bodies.getPosition(1).x);
+}
+
+TEST(restitutionBouncesAboveTheThreshold) {
+    PhysicsWorld world;
+    world.setSleepParameters(0.05f, 0.05f, 0.0f);
+    addTestGround(world, 0);
+    TestBody ball;
+    ball.shape = BodyStore::SHAPE_SPHERE;
+    ball.position = vec3(0.0f, 0.6f, 0.0f);
+    ball.velocity = vec3(0.0f, -5.0f, 0.0f);
+    ball.restitution = 1.0f;
+    addTestBody(world, 1, ball);
+
+    float upward = 0.0f;
+    for (int32_t i = 0; i < 10 && upward <= 0.0f; i++) {
+        world.step(1.0f / 60.0f, GRAVITY, 4);
+        upward = world.getBodies().getVelocity(1).y;
+    }
+    // Combinación media con el suelo (0): rebote 0.5
+    CHECK_NEAR(upward, 2.5f, 0.5f);
+}
+
+TEST(staticBodiesDoNotConstrainColors) {
+    BodyStore bodies;
+    const float dynamicProperties[BodyStore::PROPERTY_FLOATS] = {
+        1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f
+    };
+    const float staticProperties[BodyStore::PROPERTY_FLOATS] = {};
+    const float state[BodyStore::STATE_FLOATS] = { 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0 };
+    for (int32_t slot = 0; slot < 9; slot++) {
+        bodies.setStates(&slot, state, 1);
+        bodies.setProperties(&slot, slot == 0 ? staticProperties : dynamicProperties, 1);
+    }
+
+    ContactSolver solver;
+
+    // Cuatro cajas sobre el mismo estático: un solo color
+    std::vector<Manifold> ground;
+    for (int32_t slot = 1; slot <= 4; slot++) ground.push_back(makeManifold(0, slot));
+    solver.prepare(bodies, ground, 1.0f / 240.0f);
+    CHECK(solver.getColorCount() == 1);
+
+    // Cadena 1-2-3-4-5: dos colores alternos
+    std::vector<Manifold> chain;
+    for (int32_t slot = 1; slot < 5; slot++) chain.push_back(makeManifold(slot, slot + 1));
+    solver.prepare(bodies, chain, 1.0f / 240.0f);
+    CHECK(solver.getColorCount() == 2);
+
+    // Estrella sobre el cuerpo 1: un color por manifold
+    std::vector<Manifold> star;
+    for (int32_t slot = 2; slot < 9; slot++) star.push_back(makeManifold(1, slot));
+    solver.prepare(bodies, star, 1.0f / 240.0f);
+    CHECK(solver.getColorCount() == 7);
+}
+
+int main() {
+    return runTests();
+}
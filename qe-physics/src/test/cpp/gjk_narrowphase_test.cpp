@@ -0,0 +1,159 @@
+// gjk_narrowphase_test.cpp - Distancia GJK, penetración EPA y manifolds de la narrowphase
+#include "body_store.h"
+#include "gjk.h"
+#include "narrowphase.h"
+#include "test_check.h"
+#include <cmath>
+
+namespace {
+
+const Quat IDENTITY = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+Quat aroundZ(float angle) {
+    return { 0.0f, 0.0f, std::sin(angle * 0.5f), std::cos(angle * 0.5f) };
+}
+
+SupportShape boxCore(Vec3 position, Vec3 extents, Quat rotation = IDENTITY) {
+    return { SupportShape::CORE_BOX, position, rotation, extents, nullptr, 0, 0.0f };
+}
+
+ShapeInstance shape(int32_t type, Vec3 position, Vec3 extents, Quat rotation = IDENTITY,
+                    const ConvexHull* hull = nullptr) {
+    return { type, position, rotation, extents, hull, nullptr };
+}
+
+ConvexHull unitCubeHull() {
+    ConvexHull hull;
+    for (int32_t i = 0; i < 8; i++) {
+        hull.vertices.push_back(vec3(i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f));
+    }
+    return hull;
+}
+
+} // namespace
+
+TEST(gjkMeasuresTheDistanceBetweenSeparatedCores) {
+    GjkSimplex simplex;
+    GjkResult result;
+    const SupportShape a = boxCore(vec3(0.0f, 0.0f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+
+    CHECK(!gjkDistance(a, boxCore(vec3(3.0f, 0.2f, -0.1f), vec3(0.5f, 0.5f, 0.5f)), simplex, result));
+    CHECK_NEAR(result.distance, 2.0f, 1e-4f);
+    CHECK_NEAR(result.pointA.x, 0.5f, 1e-4f);
+    CHECK_NEAR(result.pointB.x, 2.5f, 1e-4f);
+
+    // Caja girada 45°: su arista queda a √0.5 del centro
+    CHECK(!gjkDistance(a, boxCore(vec3(3.0f, 0.0f, 0.0f), vec3(0.5f, 0.5f, 0.5f), aroundZ(0.785398f)),
+                       simplex, result));
+    CHECK_NEAR(result.distance, 2.5f - std::sqrt(0.5f), 1e-3f);
+
+    // Punto contra segmento: el radio de esfera y cápsula se suma fuera
+    const SupportShape point = { SupportShape::CORE_POINT, vec3(0.0f, 2.0f, 0.0f), IDENTITY,
+                                 vec3(0.0f, 0.0f, 0.0f), nullptr, 0, 0.5f };
+    const SupportShape segment = { SupportShape::CORE_SEGMENT, vec3(0.0f, 0.0f, 0.0f), IDENTITY,
+                                   vec3(1.0f, 0.0f, 0.0f), nullptr, 0, 0.5f };
+    CHECK(!gjkDistance(point, segment, simplex, result));
+    CHECK_NEAR(result.distance, 2.0f, 1e-4f);
+    CHECK(result.iterations > 0);
+}
+
+TEST(epaFindsTheShallowestAxisOfOverlappingCores) {
+    GjkSimplex simplex;
+    GjkResult result;
+    const SupportShape a = boxCore(vec3(0.0f, 0.0f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+    const SupportShape b = boxCore(vec3(0.8f, 0.1f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+    CHECK(gjkDistance(a, b, simplex, result));
+    CHECK(result.distance == 0.0f);
+
+    Vec3 normal, pointA, pointB;
+    float depth = 0.0f;
+    CHECK(epaPenetration(a, b, simplex, normal, depth, pointA, pointB));
+    CHECK_NEAR(depth, 0.2f, 1e-3f);
+    CHECK_NEAR(normal.x, 1.0f, 1e-3f);
+    CHECK_NEAR(pointA.x, 0.5f, 1e-3f);
+    CHECK_NEAR(pointB.x, 0.3f, 1e-3f);
+}
+
+TEST(boxOnBoxGivesAFourPointFaceManifold) {
+    const ShapeInstance ground = shape(BodyStore::SHAPE_BOX, vec3(0.0f, -0.5f, 0.0f), vec3(5.0f, 0.5f, 5.0f));
+    const ShapeInstance box = shape(BodyStore::SHAPE_BOX, vec3(0.0f, 0.45f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+    ContactResult contact;
+    CHECK(collideShapes(ground, box, 0.02f, contact));
+    CHECK(contact.pointCount == 4);
+    CHECK_NEAR(contact.normal.y, 1.0f, 1e-4f);
+    for (int32_t i = 0; i < contact.pointCount; i++) {
+        CHECK_NEAR(contact.separations[i], -0.05f, 1e-4f);
+        CHECK_NEAR(std::fabs(contact.points[i].x), 0.5f, 1e-4f);
+        CHECK_NEAR(std::fabs(contact.points[i].z), 0.5f, 1e-4f);
+    }
+    // Ids de rasgo distintos: el warm starting empareja por id
+    for (int32_t i = 0; i < contact.pointCount; i++) {
+        for (int32_t j = i + 1; j < contact.pointCount; j++) CHECK(contact.ids[i] != contact.ids[j]);
+    }
+
+    // Fuera del margen no hay contacto
+    const ShapeInstance far = shape(BodyStore::SHAPE_BOX, vec3(0.0f, 0.6f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+    CHECK(!collideShapes(ground, far, 0.02f, contact));
+}
+
+TEST(capsuleLyingOnABoxIsClippedToTwoPoints) {
+    const ShapeInstance ground = shape(BodyStore::SHAPE_BOX, vec3(0.0f, -0.5f, 0.0f), vec3(5.0f, 0.5f, 5.0f));
+    // Eje mayor en x: segmento de ±0.75 y radio 0.25
+    const ShapeInstance capsule = shape(BodyStore::SHAPE_CAPSULE, vec3(0.0f, 0.24f, 0.0f),
+                                        vec3(1.0f, 0.25f, 0.25f));
+    ContactResult contact;
+    CHECK(collideShapes(capsule, ground, 0.02f, contact));
+    CHECK(contact.pointCount == 2);
+    CHECK_NEAR(contact.normal.y, -1.0f, 1e-3f);
+    CHECK_NEAR(std::fabs(contact.points[0].x), 0.75f, 1e-3f);
+    CHECK_NEAR(contact.points[0].x, -contact.points[1].x, 1e-3f);
+    CHECK_NEAR(contact.separations[0], -0.01f, 1e-3f);
+}
+
+TEST(convexHullMatchesItsBoxThroughEpa) {
+    const ConvexHull cube = unitCubeHull();
+    const ShapeInstance ground = shape(BodyStore::SHAPE_BOX, vec3(0.0f, -0.5f, 0.0f), vec3(5.0f, 0.5f, 5.0f));
+    const ShapeInstance hull = shape(BodyStore::SHAPE_CONVEX, vec3(1.0f, 0.4f, 0.0f), vec3(0.5f, 0.5f, 0.5f),
+                                     IDENTITY, &cube);
+    ContactResult contact;
+    CHECK(collideShapes(hull, ground, 0.02f, contact));
+    CHECK(contact.pointCount == 1);
+    CHECK(contact.incremental);
+    CHECK_NEAR(contact.normal.y, -1.0f, 1e-3f);
+    CHECK_NEAR(contact.separations[0], -0.1f, 1e-3f);
+
+    // Separada: GJK sin EPA, dentro del margen
+    const ShapeInstance hovering = shape(BodyStore::SHAPE_CONVEX, vec3(1.0f, 0.51f, 0.0f),
+                                         vec3(0.5f, 0.5f, 0.5f), IDENTITY, &cube);
+    CHECK(collideShapes(hovering, ground, 0.02f, contact));
+    CHECK_NEAR(contact.separations[0], 0.01f, 1e-3f);
+
+    // Sin hull subido se trata como su caja: cuatro puntos
+    const ShapeInstance empty = shape(BodyStore::SHAPE_CONVEX, vec3(1.0f, 0.4f, 0.0f), vec3(0.5f, 0.5f, 0.5f));
+    CHECK(collideShapes(empty, ground, 0.02f, contact));
+    CHECK(contact.pointCount == 4);
+}
+
+TEST(reduceContactsKeepsTheDeepestAndTheWidestSpread) {
+    Vec3 points[9];
+    float separations[9];
+    uint32_t ids[9];
+    for (int32_t i = 0; i < 9; i++) {
+        points[i] = vec3(static_cast<float>(i % 3) - 1.0f, 0.0f, static_cast<float>(i / 3) - 1.0f);
+        separations[i] = -0.01f;
+        ids[i] = static_cast<uint32_t>(i);
+    }
+    separations[4] = -0.05f;
+
+    ContactResult contact;
+    contact.pointCount = 0;
+    reduceContacts(points, separations, ids, 9, vec3(0.0f, 1.0f, 0.0f), contact);
+    CHECK(contact.pointCount == MAX_MANIFOLD_POINTS);
+    bool keptDeepest = false;
+    for (int32_t i = 0; i < contact.pointCount; i++) keptDeepest |= contact.ids[i] == 4;
+    CHECK(keptDeepest);
+}
+
+int main() {
+    return runTests();
+}
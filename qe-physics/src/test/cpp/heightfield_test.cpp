@@ -0,0 +1,156 @@
+// heightfield_test.cpp - Cuantización, raycast y contactos de heightfields
+#include "heightfield.h"
+#include "test_bodies.h"
+#include "test_check.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const Vec3 GRAVITY = { 0.0f, -9.81f, 0.0f };
+const Vec3 DOWN = { 0.0f, -1.0f, 0.0f };
+
+/** Rampa en x: altura = 0.5 · x local, 9 × 9 muestras de 1 m */
+std::vector<float> rampHeights() {
+    std::vector<float> heights(81);
+    for (int32_t z = 0; z < 9; z++) {
+        for (int32_t x = 0; x < 9; x++) heights[z * 9 + x] = 0.5f * static_cast<float>(x - 4);
+    }
+    return heights;
+}
+
+/**
+ * Terreno del heightfield 0 en el slot 0, centrado en center; semiejes de
+ * la rejilla como en PhysicsSystem, que son la AABB del broadphase
+ */
+void addTerrain(PhysicsWorld& world, const std::vector<float>& heights, int32_t columns, int32_t rows,
+                Vec3 center) {
+    world.setHeightfield(0, heights.data(), columns, rows, 1.0f);
+    float low = heights[0];
+    float high = heights[0];
+    for (float height : heights) {
+        low = std::fmin(low, height);
+        high = std::fmax(high, height);
+    }
+    TestBody terrain;
+    terrain.shape = BodyStore::SHAPE_HEIGHTFIELD;
+    terrain.hull = 0;
+    terrain.invMass = 0.0f;
+    terrain.position = center;
+    terrain.extents = vec3(0.5f * static_cast<float>(columns - 1), 0.5f * (high - low),
+                           0.5f * static_cast<float>(rows - 1));
+    addTestBody(world, 0, terrain);
+}
+
+} // namespace
+
+TEST(samplesAreQuantizedWithinOneStep) {
+    Heightfield field;
+    std::vector<float> heights(16);
+    for (int32_t i = 0; i < 16; i++) heights[i] = std::sin(static_cast<float>(i)) * 20.0f;
+    field.build(heights.data(), 4, 4, 2.0f);
+    CHECK(!field.empty());
+    CHECK(field.samples.size() == 16);
+    for (int32_t z = 0; z < 4; z++) {
+        for (int32_t x = 0; x < 4; x++) {
+            CHECK_NEAR(field.height(x, z), heights[z * 4 + x], field.heightScale);
+        }
+    }
+    // Centrada: la muestra (0, 0) en -(4 - 1) · 2 / 2
+    CHECK_NEAR(field.vertex(0, 0).x, -3.0f, 1e-6f);
+    CHECK_NEAR(field.vertex(3, 3).z, 3.0f, 1e-6f);
+
+    // Menos de 2 × 2: vacío
+    field.build(heights.data(), 1, 4, 2.0f);
+    CHECK(field.empty());
+    CHECK(field.samples.empty());
+}
+
+TEST(surfaceAndRaycastFollowTheTriangles) {
+    Heightfield field;
+    const std::vector<float> heights = rampHeights();
+    field.build(heights.data(), 9, 9, 1.0f);
+
+    float height;
+    Vec3 normal;
+    int32_t cell;
+    CHECK(field.surfaceAt(1.3f, -0.7f, height, normal, cell));
+    CHECK_NEAR(height, 0.65f, 1e-3f);
+    // Pendiente 0.5: normal (-0.5, 1, 0) normalizada
+    CHECK_NEAR(normal.x, -0.5f / std::sqrt(1.25f), 1e-3f);
+    CHECK_NEAR(normal.y, 1.0f / std::sqrt(1.25f), 1e-3f);
+    CHECK(!field.surfaceAt(4.5f, 0.0f, height, normal, cell));
+
+    float distance;
+    CHECK(field.raycast(vec3(2.0f, 10.0f, 0.5f), DOWN, 100.0f, distance, normal));
+    CHECK_NEAR(distance, 9.0f, 1e-3f);
+
+    // Rayo casi horizontal que cruza varias celdas antes de dar con la rampa
+    const Vec3 direction = vec3(1.0f, -0.1f, 0.0f) * (1.0f / std::sqrt(1.01f));
+    CHECK(field.raycast(vec3(-4.0f, 1.0f, 0.2f), direction, 100.0f, distance, normal));
+    const Vec3 hit = vec3(-4.0f, 1.0f, 0.2f) + direction * distance;
+    CHECK_NEAR(hit.y, 0.5f * hit.x, 1e-3f);
+    // 1 - 0.1 (x + 4) = 0.5 x
+    CHECK_NEAR(hit.x, 1.0f, 1e-2f);
+
+    // Por encima del rango de alturas o hacia arriba: nada
+    CHECK(!field.raycast(vec3(0.0f, 10.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), 100.0f, distance, normal));
+    CHECK(!field.raycast(vec3(0.0f, 10.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), 100.0f, distance, normal));
+}
+
+TEST(worldRaycastAppliesTheBodyPose) {
+    PhysicsWorld world;
+    const std::vector<float> flat(16, 1.0f);
+    addTerrain(world, flat, 4, 4, vec3(10.0f, 0.0f, 0.0f));
+    world.step(1.0f / 60.0f, GRAVITY, 1);
+
+    float distance;
+    Vec3 normal;
+    CHECK(world.raycastHeightfield(0, vec3(10.2f, 5.0f, 0.3f), DOWN, 100.0f, distance, normal));
+    CHECK_NEAR(distance, 4.0f, 0.01f);
+    CHECK_NEAR(normal.y, 1.0f, 1e-4f);
+    CHECK(!world.raycastHeightfield(0, vec3(20.0f, 5.0f, 0.0f), DOWN, 100.0f, distance, normal));
+    CHECK(!world.raycastHeightfield(0, vec3(10.2f, 5.0f, 0.3f), DOWN, 3.0f, distance, normal));
+
+    const float rays[] = {
+        10.0f, 5.0f, 0.0f, 0.0f, -1.0f, 0.0f,
+        30.0f, 5.0f, 0.0f, 0.0f, -1.0f, 0.0f
+    };
+    const float maxDistances[] = { 100.0f, 100.0f };
+    float distances[2];
+    world.raycastHeightfieldBatch(0, rays, 2, maxDistances, distances);
+    CHECK_NEAR(distances[0], 4.0f, 0.01f);
+    CHECK(distances[1] == -1.0f);
+
+    // Chunk descargado: deja de colisionar
+    world.setHeightfield(0, nullptr, 0, 0, 1.0f);
+    CHECK(!world.raycastHeightfield(0, vec3(10.2f, 5.0f, 0.3f), DOWN, 100.0f, distance, normal));
+}
+
+TEST(bodiesRestOnTheTerrainAndFallWhenItUnloads) {
+    PhysicsWorld world;
+    world.setSleepParameters(0.05f, 0.05f, 0.0f);
+    const std::vector<float> flat(81, 0.0f);
+    addTerrain(world, flat, 9, 9, vec3(0.0f, 0.0f, 0.0f));
+
+    TestBody box;
+    box.position = vec3(0.3f, 1.0f, -0.4f);
+    addTestBody(world, 1, box);
+    TestBody ball;
+    ball.shape = BodyStore::SHAPE_SPHERE;
+    ball.position = vec3(-2.2f, 1.0f, 1.7f);
+    addTestBody(world, 2, ball);
+
+    for (int32_t i = 0; i < 120; i++) world.step(1.0f / 60.0f, GRAVITY, 4);
+    CHECK_NEAR(world.getBodies().getPosition(1).y, 0.5f, 0.02f);
+    CHECK_NEAR(world.getBodies().getPosition(2).y, 0.5f, 0.02f);
+
+    world.setHeightfield(0, nullptr, 0, 0, 1.0f);
+    for (int32_t i = 0; i < 30; i++) world.step(1.0f / 60.0f, GRAVITY, 4);
+    CHECK(world.getBodies().getPosition(1).y < 0.0f);
+    CHECK(world.getBodies().getPosition(2).y < 0.0f);
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,80 @@
+#ifndef TEST_BODIES_H
+#define TEST_BODIES_H
+
+#include "physics_world.h"
+
+/**
+ * Cuerpo de prueba para PhysicsWorld, en el mismo orden que PhysicsSystem
+ * (forma, propiedades, material y estado)
+ */
+struct TestBody {
+    int32_t shape = BodyStore::SHAPE_BOX;
+    Vec3 position = { 0.0f, 0.0f, 0.0f };
+    Quat rotation = { 0.0f, 0.0f, 0.0f, 1.0f };
+    Vec3 velocity = { 0.0f, 0.0f, 0.0f };
+    Vec3 angularVelocity = { 0.0f, 0.0f, 0.0f };
+    Vec3 extents = { 0.5f, 0.5f, 0.5f };     // esfera: radio en x
+    float invMass = 1.0f;                     // 0 = estático
+    int32_t hull = -1;
+    int32_t collisionMode = BodyStore::COLLISION_DISCRETE;
+    float friction = 0.5f;
+    float restitution = 0.0f;
+    bool trigger = false;
+    int32_t layer = 0;
+};
+
+/** Inercia inversa de la caja (o de la esfera) de semiejes extents */
+inline Vec3 testInvInertia(const TestBody& body) {
+    if (body.invMass == 0.0f) return vec3(0.0f, 0.0f, 0.0f);
+    const Vec3 e = body.extents;
+    if (body.shape == BodyStore::SHAPE_SPHERE) {
+        const float i = 2.5f * body.invMass / (e.x * e.x);
+        return vec3(i, i, i);
+    }
+    return vec3(3.0f * body.invMass / (e.y * e.y + e.z * e.z),
+                3.0f * body.invMass / (e.x * e.x + e.z * e.z),
+                3.0f * body.invMass / (e.x * e.x + e.y * e.y));
+}
+
+inline void addTestBody(PhysicsWorld& world, int32_t slot, const TestBody& body) {
+    const float shape[BodyStore::SHAPE_FLOATS] = {
+        0.0f, 0.0f, 0.0f, body.extents.x, body.extents.y, body.extents.z
+    };
+    world.setShape(slot, body.shape, body.hull, shape);
+
+    const Vec3 invInertia = testInvInertia(body);
+    const float factor = body.invMass > 0.0f ? 1.0f : 0.0f;
+    const float properties[BodyStore::PROPERTY_FLOATS] = {
+        body.invMass, invInertia.x, invInertia.y, invInertia.z,
+        0.0f, 0.0f, 1.0f,
+        factor, factor, factor,
+        factor, factor, factor,
+        static_cast<float>(body.collisionMode)
+    };
+    world.getBodies().setProperties(&slot, properties, 1);
+
+    const float material[BodyStore::MATERIAL_FLOATS] = {
+        body.friction, body.friction, body.restitution, 0.0f, 0.0f,
+        body.trigger ? 1.0f : 0.0f, static_cast<float>(body.layer)
+    };
+    world.getBodies().setMaterials(&slot, material, 1);
+
+    const float state[BodyStore::STATE_FLOATS] = {
+        body.position.x, body.position.y, body.position.z,
+        body.rotation.x, body.rotation.y, body.rotation.z, body.rotation.w,
+        body.velocity.x, body.velocity.y, body.velocity.z,
+        body.angularVelocity.x, body.angularVelocity.y, body.angularVelocity.z
+    };
+    world.getBodies().setStates(&slot, state, 1);
+}
+
+/** Suelo estático: caja de 40 × 1 × 40 con la cara superior en y = 0 */
+inline void addTestGround(PhysicsWorld& world, int32_t slot) {
+    TestBody ground;
+    ground.position = vec3(0.0f, -0.5f, 0.0f);
+    ground.extents = vec3(20.0f, 0.5f, 20.0f);
+    ground.invMass = 0.0f;
+    addTestBody(world, slot, ground);
+}
+
+#endif // TEST_BODIES_H
@@ -0,0 +1,88 @@
+// parallel_step_test.cpp - El step da los mismos bits con cualquier número de hilos
+#include "job_system.h"
+#include "test_bodies.h"
+#include "test_check.h"
+#include <vector>
+
+namespace {
+
+const Vec3 GRAVITY = { 0.0f, -9.81f, 0.0f };
+
+/**
+ * Suelo y 8 columnas de 6 cajas algo desplazadas y giradas: colores, islas y
+ * lotes de narrowphase de sobra para repartir entre hilos
+ */
+void addPiles(PhysicsWorld& world) {
+    addTestGround(world, 0);
+    int32_t slot = 1;
+    for (int32_t pile = 0; pile < 8; pile++) {
+        for (int32_t level = 0; level < 6; level++) {
+            TestBody box;
+            const float jitter = 0.03f * static_cast<float>((pile * 7 + level * 3) % 5) - 0.06f;
+            box.position = vec3(static_cast<float>(pile % 4) * 3.0f - 4.5f + jitter,
+                                0.5f + static_cast<float>(level) * 1.01f,
+                                static_cast<float>(pile / 4) * 3.0f - 1.5f - jitter);
+            box.rotation = { 0.0f, 0.05f * jitter, 0.0f, 1.0f };
+            box.angularVelocity = vec3(0.0f, jitter, 0.0f);
+            box.shape = level == 5 ? BodyStore::SHAPE_SPHERE : BodyStore::SHAPE_BOX;
+            addTestBody(world, slot++, box);
+        }
+    }
+}
+
+std::vector<float> simulate(PhysicsWorld& world, int32_t steps) {
+    addPiles(world);
+    for (int32_t i = 0; i < steps; i++) world.step(1.0f / 60.0f, GRAVITY, 4);
+
+    BodyStore& bodies = world.getBodies();
+    std::vector<float> states(static_cast<size_t>(bodies.getCapacity()) * BodyStore::STATE_FLOATS);
+    for (int32_t slot = 0; slot < bodies.getCapacity(); slot++) {
+        bodies.getState(slot, &states[static_cast<size_t>(slot) * BodyStore::STATE_FLOATS]);
+    }
+    return states;
+}
+
+bool identical(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(workerCountDoesNotChangeTheResult) {
+    PhysicsWorld serial;
+    serial.setWorkerCount(0);
+    const std::vector<float> expected = simulate(serial, 180);
+    CHECK(serial.getContactCount() > 0);
+
+    for (int32_t workers : { 1, 3 }) {
+        for (int32_t run = 0; run < 3; run++) {
+            PhysicsWorld parallel;
+            parallel.setWorkerCount(workers);
+            CHECK(parallel.getWorkerCount() == workers);
+            CHECK(identical(simulate(parallel, 180), expected));
+            CHECK(parallel.getContactCount() == serial.getContactCount());
+        }
+    }
+}
+
+TEST(sharedSchedulerGivesTheSameResultAsOwnWorkers) {
+    PhysicsWorld serial;
+    serial.setWorkerCount(0);
+    const std::vector<float> expected = simulate(serial, 120);
+
+    JobSystem system(3);
+    for (int32_t run = 0; run < 3; run++) {
+        PhysicsWorld shared;
+        shared.setJobScheduler(&system);
+        CHECK(identical(simulate(shared, 120), expected));
+        shared.setJobScheduler(nullptr);
+    }
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,193 @@
+// scene_query_test.cpp - Rayos, barridos y solapes por lotes de queryScene
+#include "scene_query.h"
+#include "test_bodies.h"
+#include "test_check.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const Vec3 NO_GRAVITY = { 0.0f, 0.0f, 0.0f };
+
+/** Lote de consultas en el formato de queryScene */
+struct QueryBatch {
+    std::vector<int32_t> ints;
+    std::vector<float> floats;
+    std::vector<int32_t> results;
+    std::vector<float> resultFloats;
+
+    int32_t add(int32_t type, Vec3 origin, Vec3 direction, float maxDistance, Vec3 extents = { 0.0f, 0.0f, 0.0f },
+                int32_t layerMask = -1, int32_t ignore = -1) {
+        ints.insert(ints.end(), { type, layerMask, ignore });
+        floats.insert(floats.end(), {
+            origin.x, origin.y, origin.z, direction.x, direction.y, direction.z, maxDistance,
+            extents.x, extents.y, extents.z, 0.0f, 0.0f, 0.0f, 1.0f
+        });
+        return static_cast<int32_t>(ints.size()) / SceneQuery::QUERY_INTS - 1;
+    }
+
+    int32_t run(PhysicsWorld& world) {
+        const int32_t count = static_cast<int32_t>(ints.size()) / SceneQuery::QUERY_INTS;
+        results.assign(static_cast<size_t>(count) * SceneQuery::RESULT_INTS, 0);
+        resultFloats.assign(static_cast<size_t>(count) * SceneQuery::RESULT_FLOATS, 0.0f);
+        return world.queryScene(ints.data(), floats.data(), count, results.data(), resultFloats.data());
+    }
+
+    int32_t slot(int32_t query) const { return results[query * SceneQuery::RESULT_INTS]; }
+    float distance(int32_t query) const { return resultFloats[query * SceneQuery::RESULT_FLOATS]; }
+    Vec3 normal(int32_t query) const {
+        const float* f = &resultFloats[query * SceneQuery::RESULT_FLOATS];
+        return vec3(f[4], f[5], f[6]);
+    }
+};
+
+/**
+ * Estáticos en el eje x: trigger (slot 2) a 2.5, caja (0) a 5, esfera de
+ * la capa 1 (1) a 10; y una caja (3) en z = 5
+ */
+void addScene(PhysicsWorld& world) {
+    TestBody box;
+    box.invMass = 0.0f;
+    box.position = vec3(5.0f, 0.0f, 0.0f);
+    addTestBody(world, 0, box);
+
+    TestBody sphere = box;
+    sphere.shape = BodyStore::SHAPE_SPHERE;
+    sphere.position = vec3(10.0f, 0.0f, 0.0f);
+    sphere.layer = 1;
+    addTestBody(world, 1, sphere);
+
+    TestBody trigger = box;
+    trigger.position = vec3(2.5f, 0.0f, 0.0f);
+    trigger.extents = vec3(0.25f, 0.25f, 0.25f);
+    trigger.trigger = true;
+    addTestBody(world, 2, trigger);
+
+    TestBody side = box;
+    side.position = vec3(0.0f, 0.0f, 5.0f);
+    addTestBody(world, 3, side);
+
+    // Los proxies se crean en el step
+    world.step(1.0f / 60.0f, NO_GRAVITY, 1);
+}
+
+} // namespace
+
+TEST(raycastsReturnTheClosestAcceptedHit) {
+    PhysicsWorld world;
+    addScene(world);
+    const Vec3 origin = vec3(0.0f, 0.0f, 0.0f);
+    const Vec3 right = vec3(1.0f, 0.0f, 0.0f);
+
+    QueryBatch batch;
+    const int32_t plain = batch.add(SceneQuery::RAYCAST, origin, right, 100.0f);
+    const int32_t triggers = batch.add(SceneQuery::RAYCAST | SceneQuery::HIT_TRIGGERS, origin, right, 100.0f);
+    const int32_t ignoring = batch.add(SceneQuery::RAYCAST, origin, right, 100.0f, vec3(0.0f, 0.0f, 0.0f), -1, 0);
+    const int32_t layerOne = batch.add(SceneQuery::RAYCAST, origin, right, 100.0f, vec3(0.0f, 0.0f, 0.0f), 1 << 1);
+    const int32_t shortRay = batch.add(SceneQuery::RAYCAST, origin, right, 4.0f);
+    const int32_t away = batch.add(SceneQuery::RAYCAST, origin, vec3(-1.0f, 0.0f, 0.0f), 100.0f);
+    const int32_t inside = batch.add(SceneQuery::RAYCAST, vec3(5.0f, 0.0f, 0.0f), right, 100.0f);
+    CHECK(batch.run(world) == 0);
+
+    CHECK(batch.slot(plain) == 0);
+    CHECK(batch.results[plain * SceneQuery::RESULT_INTS + 1] == 1);
+    CHECK_NEAR(batch.distance(plain), 4.5f, 1e-4f);
+    CHECK_NEAR(batch.normal(plain).x, -1.0f, 1e-4f);
+    CHECK_NEAR(batch.resultFloats[plain * SceneQuery::RESULT_FLOATS + 1], 4.5f, 1e-4f);
+
+    CHECK(batch.slot(triggers) == 2);
+    CHECK_NEAR(batch.distance(triggers), 2.25f, 1e-4f);
+    CHECK(batch.slot(ignoring) == 1);
+    CHECK_NEAR(batch.distance(ignoring), 9.5f, 1e-4f);
+    CHECK(batch.slot(layerOne) == 1);
+    CHECK(batch.slot(shortRay) == -1);
+    CHECK(batch.results[shortRay * SceneQuery::RESULT_INTS + 1] == 0);
+    CHECK(batch.slot(away) == -1);
+    // Empieza dentro de la caja: no la cuenta
+    CHECK(batch.slot(inside) == 1);
+    CHECK_NEAR(batch.distance(inside), 4.5f, 1e-4f);
+}
+
+TEST(sweepsStopWhereTheShapeTouches) {
+    PhysicsWorld world;
+    addScene(world);
+    QueryBatch batch;
+    const Vec3 right = vec3(1.0f, 0.0f, 0.0f);
+    const int32_t sphere = batch.add(SceneQuery::SPHERE_CAST, vec3(0.0f, 0.0f, 0.0f), right, 100.0f,
+                                     vec3(0.5f, 0.0f, 0.0f));
+    // A y = 1.1 con radio 0.5 pasa por encima de la caja y de la esfera
+    const int32_t above = batch.add(SceneQuery::SPHERE_CAST, vec3(0.0f, 1.1f, 0.0f), right, 100.0f,
+                                    vec3(0.5f, 0.0f, 0.0f));
+    const int32_t capsule = batch.add(SceneQuery::CAPSULE_CAST, vec3(0.0f, 0.0f, 0.0f), right, 100.0f,
+                                      vec3(0.25f, 0.5f, 0.0f));
+    batch.run(world);
+
+    CHECK(batch.slot(sphere) == 0);
+    CHECK_NEAR(batch.distance(sphere), 4.0f, 2.0f * SceneQuery::TOLERANCE);
+    CHECK_NEAR(batch.normal(sphere).x, -1.0f, 1e-2f);
+    CHECK(batch.slot(above) == -1);
+    CHECK(batch.slot(capsule) == 0);
+    CHECK_NEAR(batch.distance(capsule), 4.25f, 2.0f * SceneQuery::TOLERANCE);
+}
+
+TEST(overlapsListSlotsInOrderAcrossBatches) {
+    PhysicsWorld world;
+    addScene(world);
+    QueryBatch batch;
+    const Vec3 none = vec3(0.0f, 0.0f, 0.0f);
+    // Más consultas que QUERY_BATCH: los índices de solape son absolutos
+    std::vector<int32_t> between;
+    for (int32_t i = 0; i < 20; i++) {
+        between.push_back(batch.add(SceneQuery::OVERLAP_SPHERE, vec3(7.5f, 0.0f, 0.0f), none, 0.0f,
+                                    vec3(2.1f, 0.0f, 0.0f)));
+        batch.add(SceneQuery::RAYCAST, vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), 100.0f);
+    }
+    const int32_t box = batch.add(SceneQuery::OVERLAP_BOX, vec3(0.0f, 0.0f, 4.0f), none, 0.0f,
+                                  vec3(1.0f, 1.0f, 1.0f));
+    const int32_t empty = batch.add(SceneQuery::OVERLAP_SPHERE, vec3(0.0f, 10.0f, 0.0f), none, 0.0f,
+                                    vec3(1.0f, 0.0f, 0.0f));
+    const int32_t triggers = batch.add(SceneQuery::OVERLAP_SPHERE | SceneQuery::HIT_TRIGGERS,
+                                       vec3(2.5f, 0.0f, 0.0f), none, 0.0f, vec3(0.5f, 0.0f, 0.0f));
+    const int32_t total = batch.run(world);
+    CHECK(total == 20 * 2 + 1 + 1);
+
+    const std::vector<int32_t>& overlaps = world.getOverlapSlots();
+    CHECK(static_cast<int32_t>(overlaps.size()) == total);
+    for (int32_t i = 0; i < 20; i++) {
+        const int32_t first = batch.results[between[i] * SceneQuery::RESULT_INTS];
+        CHECK(first == 2 * i);
+        CHECK(batch.results[between[i] * SceneQuery::RESULT_INTS + 1] == 2);
+        CHECK(overlaps[first] == 0 && overlaps[first + 1] == 1);
+    }
+    CHECK(overlaps[batch.results[box * SceneQuery::RESULT_INTS]] == 3);
+    CHECK(batch.results[empty * SceneQuery::RESULT_INTS + 1] == 0);
+    CHECK(batch.results[triggers * SceneQuery::RESULT_INTS + 1] == 1);
+    CHECK(overlaps[batch.results[triggers * SceneQuery::RESULT_INTS]] == 2);
+}
+
+TEST(batchesGiveTheSameResultsWithAnyWorkerCount) {
+    PhysicsWorld serial;
+    serial.setWorkerCount(0);
+    addScene(serial);
+    PhysicsWorld parallel;
+    parallel.setWorkerCount(3);
+    addScene(parallel);
+
+    QueryBatch a;
+    for (int32_t i = 0; i < 64; i++) {
+        const float angle = 0.1f * static_cast<float>(i);
+        const Vec3 direction = vec3(std::cos(angle), 0.0f, std::sin(angle));
+        a.add(i % 3 == 0 ? SceneQuery::SPHERE_CAST : SceneQuery::RAYCAST, vec3(0.0f, 0.0f, 0.0f), direction, 20.0f,
+              vec3(0.3f, 0.0f, 0.0f));
+        a.add(SceneQuery::OVERLAP_SPHERE, direction * 5.0f, vec3(0.0f, 0.0f, 0.0f), 0.0f, vec3(1.0f, 0.0f, 0.0f));
+    }
+    QueryBatch b = a;
+    CHECK(a.run(serial) == b.run(parallel));
+    CHECK(a.results == b.results);
+    CHECK(a.resultFloats == b.resultFloats);
+    CHECK(serial.getOverlapSlots() == parallel.getOverlapSlots());
+}
+
+int main() {
+    return runTests();
+}
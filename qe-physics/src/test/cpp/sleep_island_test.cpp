@@ -0,0 +1,92 @@
+// sleep_island_test.cpp - Islas por contactos y joints, sueño y despertar
+#include "test_bodies.h"
+#include "test_check.h"
+
+namespace {
+
+const Vec3 GRAVITY = { 0.0f, -9.81f, 0.0f };
+
+void simulate(PhysicsWorld& world, int32_t steps) {
+    for (int32_t i = 0; i < steps; i++) world.step(1.0f / 60.0f, GRAVITY, 4);
+}
+
+/** Suelo y dos columnas de dos cajas: x = -3 (slots 1, 2) y x = 3 (slots 3, 4) */
+void addTwoStacks(PhysicsWorld& world) {
+    world.setSleepParameters(0.05f, 0.05f, 0.5f);
+    addTestGround(world, 0);
+    for (int32_t i = 0; i < 4; i++) {
+        TestBody box;
+        box.position = vec3(i < 2 ? -3.0f : 3.0f, 0.5f + static_cast<float>(i % 2), 0.0f);
+        addTestBody(world, 1 + i, box);
+    }
+}
+
+} // namespace
+
+TEST(restingStacksFallAsleepAndStopReportingChanges) {
+    PhysicsWorld world;
+    addTwoStacks(world);
+    simulate(world, 120);
+
+    for (int32_t slot = 1; slot <= 4; slot++) CHECK(world.isSleeping(slot));
+    CHECK(world.getSleepingCount() == 4);
+    // El estático no cuenta ni une islas
+    CHECK(!world.isSleeping(0));
+
+    const Vec3 before = world.getBodies().getPosition(2);
+    CHECK(world.step(1.0f / 60.0f, GRAVITY, 4) == 0);
+    CHECK(world.getBodies().getPosition(2).y == before.y);
+}
+
+TEST(wakingOneBodyWakesItsIslandOnly) {
+    PhysicsWorld world;
+    addTwoStacks(world);
+    simulate(world, 120);
+    CHECK(world.getSleepingCount() == 4);
+
+    // Sólo la columna del cuerpo 2: el suelo estático no une las dos
+    world.wakeBody(2);
+    CHECK(!world.isSleeping(1) && !world.isSleeping(2));
+    CHECK(world.isSleeping(3) && world.isSleeping(4));
+    CHECK(world.getSleepingCount() == 2);
+
+    // Despierta pero quieta: vuelve a dormirse tras timeToSleep
+    simulate(world, 60);
+    CHECK(world.getSleepingCount() == 4);
+}
+
+TEST(forcesWakeTheBodyAndMovingBodiesStayAwake) {
+    PhysicsWorld world;
+    addTwoStacks(world);
+    simulate(world, 120);
+
+    const int32_t slot = 4;
+    const float push[BodyStore::FORCE_FLOATS] = { 0.0f, 0.0f, 0.0f, 0.0f, 300.0f, 0.0f };
+    world.getBodies().addForces(&slot, push, 1);
+    world.step(1.0f / 60.0f, GRAVITY, 4);
+    CHECK(!world.isSleeping(3) && !world.isSleeping(4));
+    CHECK(world.getChangedSlots().size() >= 1);
+    CHECK(world.isSleeping(1) && world.isSleeping(2));
+
+    // Girando no se duerme
+    for (int32_t i = 0; i < 10; i++) {
+        world.step(1.0f / 60.0f, GRAVITY, 4);
+        CHECK(!world.isSleeping(4));
+    }
+}
+
+TEST(jointLinksJoinIslands) {
+    PhysicsWorld world;
+    addTwoStacks(world);
+    const int32_t links[] = { 2, 4 };
+    world.setJointLinks(links, 1);
+    simulate(world, 120);
+    CHECK(world.getSleepingCount() == 4);
+
+    world.wakeBody(1);
+    CHECK(world.getSleepingCount() == 0);
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,143 @@
+// snapshot_test.cpp - Anillo de snapshots, rewind y rollback del mundo
+#include "snapshot_ring.h"
+#include "test_bodies.h"
+#include "test_check.h"
+#include <vector>
+
+namespace {
+
+const Vec3 NO_GRAVITY = { 0.0f, 0.0f, 0.0f };
+
+/** Cuerpos 0 y 1 avanzando en x a 2 y 1 m/s; snapshot t tras cada step de 0.1 s */
+void addMovers(PhysicsWorld& world) {
+    TestBody fast;
+    fast.shape = BodyStore::SHAPE_SPHERE;
+    fast.velocity = vec3(2.0f, 0.0f, 0.0f);
+    addTestBody(world, 0, fast);
+    TestBody slow = fast;
+    slow.position = vec3(0.0f, 0.0f, 5.0f);
+    slow.velocity = vec3(1.0f, 0.0f, 0.0f);
+    addTestBody(world, 1, slow);
+}
+
+void stepAndCapture(PhysicsWorld& world, int64_t from, int64_t to) {
+    for (int64_t timestamp = from; timestamp <= to; timestamp++) {
+        world.step(0.1f, NO_GRAVITY, 1);
+        world.captureSnapshot(timestamp);
+    }
+}
+
+} // namespace
+
+TEST(ringKeepsTheNewestFramesAndFindsByTimestamp) {
+    PhysicsWorld world;
+    world.setSnapshotCapacity(4);
+    addMovers(world);
+    stepAndCapture(world, 1, 6);
+    CHECK(world.getSnapshotCount() == 4);
+
+    // Quedan 3..6: el 1 y el 2 se sobrescribieron
+    const int32_t slot = 0;
+    float state[BodyStore::STATE_FLOATS];
+    CHECK(!world.readSnapshot(2, &slot, 1, state));
+    CHECK(world.readSnapshot(3, &slot, 1, state));
+    CHECK_NEAR(state[0], 0.6f, 1e-5f);
+    // Entre capturas vale la última anterior
+    CHECK(world.readSnapshot(100, &slot, 1, state));
+    CHECK_NEAR(state[0], 1.2f, 1e-5f);
+    CHECK_NEAR(state[7], 2.0f, 1e-6f);
+
+    // Capacidad 0 lo desactiva
+    world.setSnapshotCapacity(0);
+    world.captureSnapshot(7);
+    CHECK(world.getSnapshotCount() == 0);
+}
+
+TEST(rewindMovesOnlyTheGivenBodiesUntilEndRewind) {
+    PhysicsWorld world;
+    world.setSnapshotCapacity(8);
+    addMovers(world);
+    stepAndCapture(world, 1, 5);
+
+    const int32_t slot = 1;
+    CHECK(world.rewind(2, &slot, 1) == 1);
+    CHECK_NEAR(world.getBodies().getPosition(1).x, 0.2f, 1e-5f);
+    CHECK_NEAR(world.getBodies().getPosition(0).x, 1.0f, 1e-5f);
+    world.endRewind();
+    CHECK_NEAR(world.getBodies().getPosition(1).x, 0.5f, 1e-5f);
+
+    CHECK(world.rewind(0, &slot, 1) == -1);
+    CHECK_NEAR(world.getBodies().getPosition(1).x, 0.5f, 1e-5f);
+}
+
+TEST(restoreRollsTheWorldBackAndResimulatesTheSame) {
+    PhysicsWorld world;
+    world.setSnapshotCapacity(8);
+    addMovers(world);
+    stepAndCapture(world, 1, 6);
+
+    CHECK(world.restoreSnapshot(0) == -1);
+    CHECK(world.restoreSnapshot(1) == 2);
+    CHECK_NEAR(world.getBodies().getPosition(0).x, 0.2f, 1e-5f);
+    CHECK_NEAR(world.getBodies().getVelocity(0).x, 2.0f, 1e-6f);
+    // Como tras un step: en getChangedSlots()
+    CHECK(world.getChangedSlots().size() == 2);
+
+    // Resimular desde el rollback y capturar descarta el futuro anterior
+    stepAndCapture(world, 2, 3);
+    CHECK(world.getSnapshotCount() == 3);
+    CHECK_NEAR(world.getBodies().getPosition(0).x, 0.6f, 1e-5f);
+}
+
+TEST(slotsReusedSinceTheCaptureAreLeftAlone) {
+    PhysicsWorld world;
+    world.setSnapshotCapacity(8);
+    addMovers(world);
+    stepAndCapture(world, 1, 1);
+
+    // Otro cuerpo en el slot 1
+    world.removeBody(1);
+    TestBody other;
+    other.position = vec3(-7.0f, 0.0f, 0.0f);
+    addTestBody(world, 1, other);
+    world.step(0.1f, NO_GRAVITY, 1);
+
+    const int32_t slots[] = { 0, 1 };
+    float states[2 * BodyStore::STATE_FLOATS];
+    CHECK(world.readSnapshot(1, slots, 2, states));
+    CHECK_NEAR(states[0], 0.2f, 1e-5f);
+
+    CHECK(world.restoreSnapshot(1) == 1);
+    CHECK(world.getChangedSlots()[0] == 0);
+    CHECK_NEAR(world.getBodies().getPosition(0).x, 0.2f, 1e-5f);
+    CHECK_NEAR(world.getBodies().getPosition(1).x, -7.0f, 1e-5f);
+}
+
+TEST(emptySlotsAreNeverRestored) {
+    // Capacidad con relleno: los slots que nunca tuvieron cuerpo ni cuentan
+    // ni aparecen como cambiados
+    TestBody body;
+    PhysicsWorld world;
+    world.setSnapshotCapacity(2);
+    addTestBody(world, 0, body);
+    world.step(0.1f, NO_GRAVITY, 1);
+    world.captureSnapshot(1);
+    CHECK(world.getBodies().getCapacity() > 1);
+    CHECK(world.restoreSnapshot(1) == 1);
+
+    // Ni los eliminados antes de capturar, con la generación ya impar
+    world.removeBody(0);
+    world.captureSnapshot(2);
+    CHECK(world.restoreSnapshot(2) == 0);
+
+    SnapshotRing ring;
+    ring.setCapacity(1);
+    ring.capture(1, world.getBodies());
+    float state[BodyStore::STATE_FLOATS];
+    CHECK(!ring.read(0, 0, world.getBodies(), state));
+    CHECK(!ring.read(0, 1, world.getBodies(), state));
+}
+
+int main() {
+    return runTests();
+}
@@ -0,0 +1,66 @@
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Jerarquía de transforms nativa en SoA
+ *
+ * Los nodos se guardan ordenados por profundidad, así cada padre precede a sus
+ * hijos y las matrices world se calculan en una sola pasada lineal: las locales
+ * de 4 en 4 con SIMD a partir de posición/rotación/escala, y luego padre * local.
+ * Los handles de nodo son estables aunque el orden interno cambie.
+ */
+class TransformHierarchy {
+public:
+    static constexpr uint32_t NO_SCENE_SLOT = UINT32_MAX;
+
+    int32_t createNode(int32_t parent, uint32_t sceneSlot);
+    void destroyNode(int32_t node);
+    void setParent(int32_t node, int32_t parent);
+    void setSceneSlot(int32_t node, uint32_t slot);
+
+    // trs: posición (3), rotación xyzw (4), escala (3) por nodo
+    void setLocal(int32_t node, const float* trs);
+    void setLocalBatch(const int* nodes, const float* trs, int count);
+
+    // Recalcula las matrices world de los nodos afectados
+    void update();
+
+    bool getWorldMatrix(int32_t node, float* out) const;
+    size_t getNodeCount() const { return indexToNode.size(); }
+
+    // Nodos con slot en el scene buffer cuya matriz cambió en el último update()
+    const std::vector<uint32_t>& getChangedSlots() const { return changedSlots; }
+    const std::vector<const float*>& getChangedMatrices() const { return changedMatrices; }
+
+private:
+    // SoA en orden de profundidad (capacidad redondeada a múltiplo de 4)
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> rotX, rotY, rotZ, rotW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+    std::vector<int32_t> parentIndex;
+    std::vector<uint32_t> sceneSlot;
+    std::vector<uint8_t> localDirty;
+    std::vector<uint8_t> worldChanged;
+    std::vector<float> world;
+
+    // Handles estables
+    std::vector<int32_t> nodeToIndex;
+    std::vector<int32_t> indexToNode;
+    std::vector<int32_t> nodeParent;
+    std::vector<int32_t> freeNodes;
+    bool orderDirty = false;
+
+    std::vector<uint32_t> changedSlots;
+    std::vector<const float*> changedMatrices;
+
+    void resizeStorage(size_t count);
+    void sortByDepth();
+    void moveIndex(const int32_t* order, size_t count);
+    void computeLocal4(size_t first, float* local) const;
+};
+
+#endif // TRANSFORM_HIERARCHY_H
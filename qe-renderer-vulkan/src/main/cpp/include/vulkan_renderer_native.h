@@ -7,6 +7,13 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include "frame_allocator.h"
+#include "transform_hierarchy.h"
 
 // Estructuras de datos
 
@@ -41,9 +48,112 @@ struct Shader {
     VkShaderStageFlagBits stage;
 };
 
+// Vertex layouts con pipeline de fallback propio (interleaved, binding 0)
+enum class VertexLayout : int {
+    Position = 0,
+    PositionNormal = 1,
+    PositionNormalUV = 2
+};
+
+static const int VERTEX_LAYOUT_COUNT = 3;
+
+enum class PipelineState : int {
+    Pending = 0,
+    Ready = 1,
+    Failed = 2
+};
+
+// Compilación pendiente: sólo datos que los workers pueden leer sin locks
+struct PipelineRequest {
+    uint64_t handle = 0;
+    VkShaderModule vertexShader = VK_NULL_HANDLE;
+    VkShaderModule fragmentShader = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+    uint32_t colorAttachmentCount = 1;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    bool depthTest = true;
+    bool depthWrite = true;
+    bool blend = false;
+    VertexLayout vertexLayout = VertexLayout::Position;
+};
+
 struct Pipeline {
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    PipelineState state = PipelineState::Pending;
+    VertexLayout vertexLayout = VertexLayout::Position;
+    PipelineRequest request;            // para recompilar al cambiar el render pass
+};
+
+struct PipelineResult {
+    uint64_t handle;
     VkPipeline pipeline;
-    VkPipelineLayout layout;
+};
+
+// Ruta de sombreado seleccionable por dispositivo
+enum class ShadingPath : int {
+    Forward = 0,
+    Deferred = 1
+};
+
+// Attachment propio del renderer (G-buffer, depth)
+struct FramebufferAttachment {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+};
+
+// Push constants de un draw: transform (column-major) + color
+struct DrawConstants {
+    float transform[16];
+    float color[4];
+};
+
+// Entrada de la tabla de objetos en el scene buffer (std430)
+struct SceneObject {
+    float transform[16];
+    float color[4];
+    uint32_t materialId;
+    uint32_t flags;
+    uint32_t padding[2];
+};
+
+static const uint32_t SCENE_OBJECT_VISIBLE = 1u;
+static const uint32_t SCENE_INITIAL_CAPACITY = 4096;
+
+// Arena por frame: crece sola hasta el máximo visto si se queda corta
+static const size_t FRAME_ARENA_CAPACITY = 64 * 1024;
+
+// Memoria nativa del último frame completo
+struct FrameAllocationStats {
+    uint32_t arenaAllocations = 0;
+    uint32_t heapAllocations = 0;       // desbordes de la arena y del scratch; 0 en régimen estable
+    uint64_t arenaBytes = 0;
+    uint64_t arenaPeakBytes = 0;
+    uint64_t arenaCapacity = 0;
+};
+
+// Draw de contenido estático
+struct StaticDraw {
+    uint64_t mesh;
+    uint64_t pipeline;
+    DrawConstants constants;
+    uint32_t sceneSlot;                 // objeto del scene buffer, se dibuja como firstInstance
+};
+
+// Chunk estático grabado en un secondary command buffer
+struct StaticChunk {
+    std::vector<StaticDraw> draws;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    // Pipelines usados al grabar (handle -> VkPipeline) para detectar cambios
+    std::vector<std::pair<uint64_t, VkPipeline>> boundPipelines;
+    uint32_t renderTargetGeneration = 0;
+    bool dirty = true;
 };
 
 // Clase principal del renderer
@@ -70,6 +180,21 @@ public:
     void setClearColor(float r, float g, float b, float a);
     void setViewport(int x, int y, int width, int height);
     
+    // Shading path
+    bool supportsDeferredShading() const;
+    bool setShadingPath(ShadingPath path);
+    ShadingPath getShadingPath() const { return shadingPath; }
+    uint64_t getLightingSubpassDraws() const { return lightingSubpassDraws; }
+    void setLightingPipeline(uint64_t pipelineHandle);
+    
+    // Static content cache
+    void beginStaticChunk(uint64_t chunkId);
+    void submitStaticMesh(uint64_t chunkId, uint64_t meshHandle, uint64_t pipelineHandle,
+                          const float* transform, const float* color);
+    void removeStaticChunk(uint64_t chunkId);
+    void invalidateStaticChunks();
+    uint32_t executeStaticChunks(VkCommandBuffer primary);
+    
     // Resources
     uint64_t loadMesh(const float* vertices, int vertexCount,
                       const uint32_t* indices, int indexCount,
@@ -80,6 +205,25 @@ public:
     uint64_t createGraphicsPipeline(uint64_t vertexShader, uint64_t fragmentShader,
                                      const int* config);
     
+    // Persistent scene buffer
+    uint32_t allocateSceneObject();
+    void releaseSceneObject(uint32_t slot);
+    void updateSceneTransforms(const int* slots, const float* matrices, int count);
+    void updateSceneMaterials(const int* slots, const float* colors, const int* materialIds, int count);
+    void updateSceneVisibility(const int* slots, const int* flags, int count);
+    VkDeviceSize recordSceneUpload(VkCommandBuffer cmd);
+    
+    // Native transform hierarchy (escribe en el scene buffer)
+    TransformHierarchy& getTransforms() { return transforms; }
+    void updateTransforms();
+    
+    // Async pipeline compilation
+    void setFallbackPipeline(int vertexLayout, uint64_t pipelineHandle);
+    PipelineState getPipelineState(uint64_t pipelineHandle) const;
+    const std::vector<uint64_t>& getPipelineEvents() const { return pipelineEvents; }
+    void clearPipelineEvents() { pipelineEvents.clear(); }
+    void waitForPipelineCompiler();
+    
     // Compute
     void dispatchCompute(uint64_t computeShader, int groupsX, int groupsY, int groupsZ);
     
@@ -90,6 +234,7 @@ public:
     
     // Info
     VulkanInfo getVulkanInfo() const;
+    const FrameAllocationStats& getFrameAllocationStats() const { return frameAllocationStats; }
     
 private:
     // Vulkan objects
@@ -144,6 +289,59 @@ private:
     
     uint64_t nextResourceId;
     
+    // Deferred shading: G-buffer transient leído como input attachments
+    ShadingPath shadingPath;
+    FramebufferAttachment gbufferAlbedo;
+    FramebufferAttachment gbufferNormal;
+    FramebufferAttachment depthAttachment;
+    VkDescriptorSetLayout gbufferSetLayout;
+    VkDescriptorSet gbufferDescriptorSet;
+    uint64_t lightingPipeline;
+    uint64_t lightingSubpassDraws;      // frames deferred cuyo swapchain escribió la iluminación
+    bool warnedUnlitDeferredFrame;
+    bool frameRecording;
+    
+    // Cache de secondary command buffers por chunk estático
+    std::unordered_map<uint64_t, StaticChunk> staticChunks;
+    std::vector<VkCommandBuffer> staticCommandBuffers;
+    std::vector<VkCommandBuffer> pendingStaticFrees;    // chunks eliminados, se liberan tras la fence
+    uint32_t renderTargetGeneration;
+    
+    // Scene buffer: copia CPU + SSBO device-local + staging mapeado
+    std::vector<SceneObject> sceneObjects;
+    std::vector<uint32_t> sceneFreeSlots;
+    std::vector<uint32_t> sceneDirtySlots;
+    std::vector<uint8_t> sceneDirtyFlags;
+    std::vector<uint8_t> sceneSlotLive;
+    std::vector<VkBufferCopy> sceneCopyRegions;
+    uint32_t sceneObjectCount;
+    uint32_t sceneCapacity;
+    VkBuffer sceneBuffer;
+    VkDeviceMemory sceneMemory;
+    VkBuffer sceneStagingBuffer;
+    VkDeviceMemory sceneStagingMemory;
+    void* sceneStagingMapped;
+    VkDescriptorSetLayout sceneSetLayout;
+    VkDescriptorSet sceneDescriptorSet;
+    TransformHierarchy transforms;
+    
+    // Compilación de pipelines en workers nativos
+    std::vector<std::thread> pipelineWorkers;
+    std::deque<PipelineRequest> pipelineQueue;
+    std::vector<PipelineResult> completedPipelines;
+    std::mutex pipelineQueueMutex;
+    std::condition_variable pipelineQueueCondition;
+    std::condition_variable pipelineIdleCondition;
+    size_t pendingPipelineCount;
+    bool stopPipelineWorkers;
+    VkPipelineCache pipelineCache;
+    uint64_t fallbackPipelines[VERTEX_LAYOUT_COUNT];
+    std::vector<uint64_t> pipelineEvents;
+    
+    // Memoria temporal del frame, reseteada al retirarlo (tras la fence)
+    FrameArena frameArena;
+    FrameAllocationStats frameAllocationStats;
+    
     // Helper functions
     bool createInstance();
     bool pickPhysicalDevice();
@@ -159,6 +357,49 @@ private:
     void destroySwapchain();
     void recreateSwapchain();
     
+    void updateFrameAllocationStats();
+    void abandonFrame();
+    
+    bool createDeferredRenderPass();
+    bool createGBuffer();
+    void destroyGBuffer();
+    bool createAttachment(VkFormat format, VkImageUsageFlags usage,
+                          VkImageAspectFlags aspect, FramebufferAttachment& attachment);
+    void destroyAttachment(FramebufferAttachment& attachment);
+    VkFormat findDepthFormat() const;
+    bool hasLazilyAllocatedMemory() const;
+    bool recordLightingSubpass(VkCommandBuffer cmd);
+    
+    bool isStaticChunkValid(const StaticChunk& chunk) const;
+    bool recordStaticChunk(StaticChunk& chunk);
+    void clearStaticChunks();
+    void releaseStaticDraws(StaticChunk& chunk);
+    void freeRetiredStaticChunks();
+    void recordDraw(VkCommandBuffer cmd, const Pipeline& pipeline, const Mesh& mesh,
+                    const DrawConstants& constants, uint32_t sceneSlot);
+    
+    bool createSceneBuffer(uint32_t capacity);
+    void destroySceneBuffer();
+    bool growSceneBuffer(uint32_t minCapacity);
+    void markSceneObjectDirty(uint32_t slot) {
+        if (!sceneDirtyFlags[slot]) {
+            sceneDirtyFlags[slot] = 1;
+            sceneDirtySlots.push_back(slot);
+        }
+    }
+    
+    uint64_t requestPipeline(uint64_t vertexShader, uint64_t fragmentShader, const int* config);
+    bool createPipelineLayout(uint32_t subpass, VkPipelineLayout& layout);
+    void queuePipelineRequest(const PipelineRequest& request);
+    void drainPipelineCompiler();
+    void rebuildPipelines();
+    bool startPipelineCompiler();
+    void stopPipelineCompiler();
+    void pipelineWorkerLoop();
+    VkPipeline buildPipeline(const PipelineRequest& request);
+    void processCompletedPipelines();
+    const Pipeline* resolvePipeline(uint64_t pipelineHandle) const;
+    
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
     void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
                      VkMemoryPropertyFlags properties,
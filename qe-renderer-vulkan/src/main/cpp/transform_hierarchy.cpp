@@ -0,0 +1,325 @@
+// transform_hierarchy.cpp
+#include "transform_hierarchy.h"
+#include "simd_transform.h"
+#include "frame_allocator.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstring>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "TransformHierarchy", __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, "TransformHierarchy", __VA_ARGS__)
+
+static const float IDENTITY_MATRIX[16] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+};
+
+template <typename T>
+static void permute(std::vector<T>& values, const int32_t* order, size_t count, size_t stride) {
+    ScratchScope scratch;
+    T* sorted = scratch.allocateArray<T>(count * stride);
+    for (size_t i = 0; i < count; i++) {
+        memcpy(&sorted[i * stride], &values[order[i] * stride], sizeof(T) * stride);
+    }
+    // El padding final conserva sus valores
+    memcpy(values.data(), sorted, sizeof(T) * count * stride);
+}
+
+void TransformHierarchy::resizeStorage(size_t count) {
+    // Múltiplo de 4 para que el kernel SIMD pueda leer el último grupo completo
+    size_t padded = (count + 3) & ~static_cast<size_t>(3);
+
+    posX.resize(padded, 0.0f);
+    posY.resize(padded, 0.0f);
+    posZ.resize(padded, 0.0f);
+    rotX.resize(padded, 0.0f);
+    rotY.resize(padded, 0.0f);
+    rotZ.resize(padded, 0.0f);
+    rotW.resize(padded, 1.0f);
+    scaleX.resize(padded, 1.0f);
+    scaleY.resize(padded, 1.0f);
+    scaleZ.resize(padded, 1.0f);
+    parentIndex.resize(padded, -1);
+    sceneSlot.resize(padded, NO_SCENE_SLOT);
+    localDirty.resize(padded, 0);
+    worldChanged.resize(padded, 0);
+    world.resize(padded * 16, 0.0f);
+
+    indexToNode.resize(count);
+}
+
+int32_t TransformHierarchy::createNode(int32_t parent, uint32_t slot) {
+    int32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        node = static_cast<int32_t>(nodeToIndex.size());
+        nodeToIndex.push_back(-1);
+        nodeParent.push_back(-1);
+    }
+
+    if (parent >= 0 && (parent >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[parent] < 0)) {
+        LOGW("Invalid parent %d for new node", parent);
+        parent = -1;
+    }
+
+    // Se añade al final: el padre ya existe, así que sigue precediendo al hijo
+    size_t index = indexToNode.size();
+    resizeStorage(index + 1);
+
+    posX[index] = posY[index] = posZ[index] = 0.0f;
+    rotX[index] = rotY[index] = rotZ[index] = 0.0f;
+    rotW[index] = 1.0f;
+    scaleX[index] = scaleY[index] = scaleZ[index] = 1.0f;
+    parentIndex[index] = parent >= 0 ? nodeToIndex[parent] : -1;
+    sceneSlot[index] = slot;
+    localDirty[index] = 1;
+    memcpy(&world[index * 16], IDENTITY_MATRIX, sizeof(IDENTITY_MATRIX));
+
+    indexToNode[index] = node;
+    nodeToIndex[node] = static_cast<int32_t>(index);
+    nodeParent[node] = parent;
+
+    return node;
+}
+
+void TransformHierarchy::destroyNode(int32_t node) {
+    if (node < 0 || node >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[node] < 0) return;
+
+    // Los hijos pasan a ser raíces
+    for (size_t other = 0; other < nodeParent.size(); other++) {
+        if (nodeParent[other] == node) {
+            nodeParent[other] = -1;
+            localDirty[nodeToIndex[other]] = 1;
+        }
+    }
+
+    // Swap-remove: el orden se rehace en el próximo update()
+    size_t index = static_cast<size_t>(nodeToIndex[node]);
+    size_t last = indexToNode.size() - 1;
+
+    if (index != last) {
+        posX[index] = posX[last];
+        posY[index] = posY[last];
+        posZ[index] = posZ[last];
+        rotX[index] = rotX[last];
+        rotY[index] = rotY[last];
+        rotZ[index] = rotZ[last];
+        rotW[index] = rotW[last];
+        scaleX[index] = scaleX[last];
+        scaleY[index] = scaleY[last];
+        scaleZ[index] = scaleZ[last];
+        sceneSlot[index] = sceneSlot[last];
+        localDirty[index] = localDirty[last];
+        memcpy(&world[index * 16], &world[last * 16], sizeof(float) * 16);
+
+        indexToNode[index] = indexToNode[last];
+        nodeToIndex[indexToNode[index]] = static_cast<int32_t>(index);
+    }
+
+    resizeStorage(last);
+
+    nodeToIndex[node] = -1;
+    nodeParent[node] = -1;
+    freeNodes.push_back(node);
+    orderDirty = true;
+}
+
+void TransformHierarchy::setParent(int32_t node, int32_t parent) {
+    if (node < 0 || node >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[node] < 0) return;
+    if (parent < 0) parent = -1;
+    if (nodeParent[node] == parent) return;
+
+    if (parent >= 0 && (parent >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[parent] < 0)) {
+        LOGW("Invalid parent %d for node %d", parent, node);
+        return;
+    }
+
+    // Rechazar ciclos: el nuevo padre no puede descender del nodo
+    for (int32_t ancestor = parent; ancestor >= 0; ancestor = nodeParent[ancestor]) {
+        if (ancestor == node) {
+            LOGW("Rejected cyclic parent %d for node %d", parent, node);
+            return;
+        }
+    }
+
+    nodeParent[node] = parent;
+    localDirty[nodeToIndex[node]] = 1;
+    orderDirty = true;
+}
+
+void TransformHierarchy::setSceneSlot(int32_t node, uint32_t slot) {
+    if (node < 0 || node >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[node] < 0) return;
+
+    int32_t index = nodeToIndex[node];
+    sceneSlot[index] = slot;
+    localDirty[index] = 1;
+}
+
+void TransformHierarchy::setLocal(int32_t node, const float* trs) {
+    if (node < 0 || node >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[node] < 0) return;
+
+    int32_t index = nodeToIndex[node];
+    posX[index] = trs[0];
+    posY[index] = trs[1];
+    posZ[index] = trs[2];
+    rotX[index] = trs[3];
+    rotY[index] = trs[4];
+    rotZ[index] = trs[5];
+    rotW[index] = trs[6];
+    scaleX[index] = trs[7];
+    scaleY[index] = trs[8];
+    scaleZ[index] = trs[9];
+    localDirty[index] = 1;
+}
+
+void TransformHierarchy::setLocalBatch(const int* nodes, const float* trs, int count) {
+    for (int i = 0; i < count; i++) {
+        setLocal(nodes[i], trs + i * 10);
+    }
+}
+
+void TransformHierarchy::sortByDepth() {
+    size_t count = indexToNode.size();
+    size_t nodeCount = nodeToIndex.size();
+
+    // Buffers temporales en la pila de scratch: reordenar no reserva memoria
+    ScratchScope scratch;
+
+    // Profundidad por handle, recorriendo cada cadena de padres una sola vez
+    int32_t* depth = scratch.allocateArray<int32_t>(nodeCount);
+    int32_t* chain = scratch.allocateArray<int32_t>(nodeCount);
+    std::fill(depth, depth + nodeCount, -1);
+    int32_t maxDepth = 0;
+
+    for (size_t index = 0; index < count; index++) {
+        int32_t node = indexToNode[index];
+        size_t chainLength = 0;
+
+        int32_t current = node;
+        while (current >= 0 && depth[current] < 0) {
+            chain[chainLength++] = current;
+            current = nodeParent[current];
+        }
+
+        int32_t d = current >= 0 ? depth[current] : -1;
+        while (chainLength > 0) {
+            depth[chain[--chainLength]] = ++d;
+        }
+        if (d > maxDepth) maxDepth = d;
+    }
+
+    // Counting sort estable por profundidad
+    int32_t* offsets = scratch.allocateArray<int32_t>(maxDepth + 2);
+    std::fill(offsets, offsets + maxDepth + 2, 0);
+    for (size_t index = 0; index < count; index++) {
+        offsets[depth[indexToNode[index]] + 1]++;
+    }
+    for (int32_t d = 1; d <= maxDepth + 1; d++) {
+        offsets[d] += offsets[d - 1];
+    }
+
+    int32_t* order = scratch.allocateArray<int32_t>(count);
+    for (size_t index = 0; index < count; index++) {
+        order[offsets[depth[indexToNode[index]]]++] = static_cast<int32_t>(index);
+    }
+
+    moveIndex(order, count);
+    orderDirty = false;
+}
+
+void TransformHierarchy::moveIndex(const int32_t* order, size_t count) {
+    permute(posX, order, count, 1);
+    permute(posY, order, count, 1);
+    permute(posZ, order, count, 1);
+    permute(rotX, order, count, 1);
+    permute(rotY, order, count, 1);
+    permute(rotZ, order, count, 1);
+    permute(rotW, order, count, 1);
+    permute(scaleX, order, count, 1);
+    permute(scaleY, order, count, 1);
+    permute(scaleZ, order, count, 1);
+    permute(sceneSlot, order, count, 1);
+    permute(localDirty, order, count, 1);
+    permute(world, order, count, 16);
+    permute(indexToNode, order, count, 1);
+
+    for (size_t i = 0; i < count; i++) {
+        nodeToIndex[indexToNode[i]] = static_cast<int32_t>(i);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        int32_t parent = nodeParent[indexToNode[i]];
+        parentIndex[i] = parent >= 0 ? nodeToIndex[parent] : -1;
+    }
+}
+
+void TransformHierarchy::computeLocal4(size_t first, float* local) const {
+    using namespace simd;
+
+    composeTRS4(load(&posX[first]), load(&posY[first]), load(&posZ[first]),
+                load(&rotX[first]), load(&rotY[first]), load(&rotZ[first]), load(&rotW[first]),
+                load(&scaleX[first]), load(&scaleY[first]), load(&scaleZ[first]),
+                local);
+}
+
+void TransformHierarchy::update() {
+    if (orderDirty) {
+        sortByDepth();
+    }
+
+    changedSlots.clear();
+    changedMatrices.clear();
+
+    size_t count = indexToNode.size();
+    float local[64];
+
+    for (size_t first = 0; first < count; first += 4) {
+        size_t end = first + 4 < count ? first + 4 : count;
+
+        // Cambia si su local cambió o si cambió la world de su padre (el padre va antes)
+        bool anyChanged = false;
+        for (size_t i = first; i < end; i++) {
+            int32_t parent = parentIndex[i];
+            uint8_t changed = localDirty[i] | (parent >= 0 ? worldChanged[parent] : 0);
+            worldChanged[i] = changed;
+            anyChanged |= changed != 0;
+        }
+        if (!anyChanged) continue;
+
+        computeLocal4(first, local);
+
+        for (size_t i = first; i < end; i++) {
+            if (!worldChanged[i]) continue;
+
+            float* out = &world[i * 16];
+            const float* localMatrix = local + (i - first) * 16;
+            int32_t parent = parentIndex[i];
+
+            if (parent >= 0) {
+                simd::mat4Mul(&world[parent * 16], localMatrix, out);
+            } else {
+                memcpy(out, localMatrix, sizeof(float) * 16);
+            }
+
+            localDirty[i] = 0;
+
+            if (sceneSlot[i] != NO_SCENE_SLOT) {
+                changedSlots.push_back(sceneSlot[i]);
+                changedMatrices.push_back(out);
+            }
+        }
+    }
+}
+
+bool TransformHierarchy::getWorldMatrix(int32_t node, float* out) const {
+    if (node < 0 || node >= static_cast<int32_t>(nodeToIndex.size()) || nodeToIndex[node] < 0) {
+        return false;
+    }
+
+    memcpy(out, &world[nodeToIndex[node] * 16], sizeof(float) * 16);
+    return true;
+}
@@ -0,0 +1,418 @@
+// vk_deferred.cpp
+#include "vulkan_renderer_native.h"
+#include <android/log.h>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "VulkanDeferred", __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, "VulkanDeferred", __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanDeferred", __VA_ARGS__)
+
+// Formatos del G-buffer
+static const VkFormat GBUFFER_ALBEDO_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+static const VkFormat GBUFFER_NORMAL_FORMAT = VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+
+// Índices de attachments en el render pass deferred
+enum DeferredAttachment : uint32_t {
+    ATTACHMENT_SWAPCHAIN = 0,
+    ATTACHMENT_ALBEDO = 1,
+    ATTACHMENT_NORMAL = 2,
+    ATTACHMENT_DEPTH = 3,
+    ATTACHMENT_COUNT = 4
+};
+
+static bool supportsAttachmentFormat(VkPhysicalDevice physicalDevice, VkFormat format,
+                                     VkFormatFeatureFlags features) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
+    return (props.optimalTilingFeatures & features) == features;
+}
+
+VkFormat VulkanRendererNative::findDepthFormat() const {
+    const VkFormat candidates[] = {
+        VK_FORMAT_D24_UNORM_S8_UINT,
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D16_UNORM
+    };
+
+    for (VkFormat format : candidates) {
+        if (supportsAttachmentFormat(physicalDevice, format,
+                                     VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+            return format;
+        }
+    }
+
+    return VK_FORMAT_UNDEFINED;
+}
+
+bool VulkanRendererNative::supportsDeferredShading() const {
+    if (physicalDevice == VK_NULL_HANDLE) {
+        return false;
+    }
+
+    // Geometría escribe albedo + normal, la iluminación lee 3 input attachments
+    if (deviceProperties.limits.maxColorAttachments < 2 ||
+        deviceProperties.limits.maxPerStageDescriptorInputAttachments < 3) {
+        return false;
+    }
+
+    if (!supportsAttachmentFormat(physicalDevice, GBUFFER_ALBEDO_FORMAT,
+                                  VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT) ||
+        !supportsAttachmentFormat(physicalDevice, GBUFFER_NORMAL_FORMAT,
+                                  VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT)) {
+        return false;
+    }
+
+    return findDepthFormat() != VK_FORMAT_UNDEFINED;
+}
+
+bool VulkanRendererNative::hasLazilyAllocatedMemory() const {
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool VulkanRendererNative::setShadingPath(ShadingPath path) {
+    if (path == shadingPath) {
+        return true;
+    }
+
+    if (path == ShadingPath::Deferred && !supportsDeferredShading()) {
+        LOGW("Deferred shading not supported on this device, keeping forward path");
+        return false;
+    }
+
+    LOGI("Switching shading path to %s (tile memory: %s)",
+         path == ShadingPath::Deferred ? "deferred" : "forward",
+         hasLazilyAllocatedMemory() ? "yes" : "no");
+
+    shadingPath = path;
+    warnedUnlitDeferredFrame = false;
+
+    // Sin swapchain todavía: se aplicará en setSurface()
+    if (swapchain == VK_NULL_HANDLE) {
+        return true;
+    }
+
+    // Las compilaciones en curso referencian el render pass actual
+    drainPipelineCompiler();
+    vkDeviceWaitIdle(device);
+
+    for (auto framebuffer : framebuffers) {
+        vkDestroyFramebuffer(device, framebuffer, nullptr);
+    }
+    framebuffers.clear();
+
+    destroyGBuffer();
+
+    if (renderPass != VK_NULL_HANDLE) {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+        renderPass = VK_NULL_HANDLE;
+    }
+
+    if (!createRenderPass()) {
+        return false;
+    }
+    rebuildPipelines();
+    return createFramebuffers();
+}
+
+void VulkanRendererNative::setLightingPipeline(uint64_t pipelineHandle) {
+    lightingPipeline = pipelineHandle;
+}
+
+/**
+ * Render pass de dos subpasses:
+ *   0 - geometría: escribe albedo, normal y depth
+ *   1 - iluminación: lee el G-buffer como input attachments y escribe al swapchain
+ *
+ * El G-buffer usa loadOp CLEAR / storeOp DONT_CARE y memoria transient, así en
+ * GPUs tiler nunca sale de la memoria on-chip.
+ */
+bool VulkanRendererNative::createDeferredRenderPass() {
+    LOGI("Creating deferred render pass");
+
+    VkFormat depthFormat = findDepthFormat();
+
+    VkAttachmentDescription attachments[ATTACHMENT_COUNT]{};
+
+    attachments[ATTACHMENT_SWAPCHAIN].format = swapchainFormat;
+    attachments[ATTACHMENT_SWAPCHAIN].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[ATTACHMENT_SWAPCHAIN].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[ATTACHMENT_SWAPCHAIN].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachments[ATTACHMENT_SWAPCHAIN].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[ATTACHMENT_SWAPCHAIN].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[ATTACHMENT_SWAPCHAIN].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[ATTACHMENT_SWAPCHAIN].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    const VkFormat gbufferFormats[] = {GBUFFER_ALBEDO_FORMAT, GBUFFER_NORMAL_FORMAT};
+    for (uint32_t i = 0; i < 2; i++) {
+        VkAttachmentDescription& gbuffer = attachments[ATTACHMENT_ALBEDO + i];
+        gbuffer.format = gbufferFormats[i];
+        gbuffer.samples = VK_SAMPLE_COUNT_1_BIT;
+        gbuffer.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        gbuffer.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        gbuffer.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        gbuffer.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        gbuffer.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        gbuffer.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+
+    attachments[ATTACHMENT_DEPTH].format = depthFormat;
+    attachments[ATTACHMENT_DEPTH].samples = VK_SAMPLE_COUNT_1_BIT;
+    attachments[ATTACHMENT_DEPTH].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachments[ATTACHMENT_DEPTH].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[ATTACHMENT_DEPTH].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachments[ATTACHMENT_DEPTH].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    attachments[ATTACHMENT_DEPTH].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachments[ATTACHMENT_DEPTH].finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+    // Subpass 0: geometría
+    VkAttachmentReference gbufferWriteRefs[] = {
+        {ATTACHMENT_ALBEDO, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL},
+        {ATTACHMENT_NORMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL}
+    };
+    VkAttachmentReference depthWriteRef = {ATTACHMENT_DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    // Subpass 1: iluminación
+    VkAttachmentReference swapchainRef = {ATTACHMENT_SWAPCHAIN, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference gbufferReadRefs[] = {
+        {ATTACHMENT_ALBEDO, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {ATTACHMENT_NORMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {ATTACHMENT_DEPTH, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL}
+    };
+
+    VkSubpassDescription subpasses[2]{};
+    subpasses[0].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[0].colorAttachmentCount = 2;
+    subpasses[0].pColorAttachments = gbufferWriteRefs;
+    subpasses[0].pDepthStencilAttachment = &depthWriteRef;
+
+    subpasses[1].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpasses[1].colorAttachmentCount = 1;
+    subpasses[1].pColorAttachments = &swapchainRef;
+    subpasses[1].inputAttachmentCount = 3;
+    subpasses[1].pInputAttachments = gbufferReadRefs;
+
+    VkSubpassDependency dependencies[2]{};
+
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[0].srcAccessMask = 0;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    // BY_REGION: la iluminación sólo lee el pixel propio, permite quedarse en el tile
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = 1;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = ATTACHMENT_COUNT;
+    renderPassInfo.pAttachments = attachments;
+    renderPassInfo.subpassCount = 2;
+    renderPassInfo.pSubpasses = subpasses;
+    renderPassInfo.dependencyCount = 2;
+    renderPassInfo.pDependencies = dependencies;
+
+    if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
+        LOGE("Failed to create deferred render pass");
+        return false;
+    }
+
+    LOGI("Deferred render pass created successfully");
+    return true;
+}
+
+bool VulkanRendererNative::createAttachment(VkFormat format, VkImageUsageFlags usage,
+                                            VkImageAspectFlags aspect,
+                                            FramebufferAttachment& attachment) {
+    attachment.format = format;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = swapchainExtent.width;
+    imageInfo.extent.height = swapchainExtent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = usage | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateImage(device, &imageInfo, nullptr, &attachment.image) != VK_SUCCESS) {
+        LOGE("Failed to create attachment image");
+        return false;
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(device, attachment.image, &memRequirements);
+
+    // Preferir memoria lazily allocated (tile memory); si no hay, device local
+    VkPhysicalDeviceMemoryProperties memProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+    uint32_t memoryType = UINT32_MAX;
+    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+        if ((memRequirements.memoryTypeBits & (1 << i)) &&
+            (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+            memoryType = i;
+            break;
+        }
+    }
+    if (memoryType == UINT32_MAX) {
+        memoryType = findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    if (vkAllocateMemory(device, &allocInfo, nullptr, &attachment.memory) != VK_SUCCESS) {
+        LOGE("Failed to allocate attachment memory");
+        return false;
+    }
+
+    vkBindImageMemory(device, attachment.image, attachment.memory, 0);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = attachment.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = aspect;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &attachment.view) != VK_SUCCESS) {
+        LOGE("Failed to create attachment image view");
+        return false;
+    }
+
+    return true;
+}
+
+void VulkanRendererNative::destroyAttachment(FramebufferAttachment& attachment) {
+    if (attachment.view != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, attachment.view, nullptr);
+        attachment.view = VK_NULL_HANDLE;
+    }
+    if (attachment.image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, attachment.image, nullptr);
+        attachment.image = VK_NULL_HANDLE;
+    }
+    if (attachment.memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, attachment.memory, nullptr);
+        attachment.memory = VK_NULL_HANDLE;
+    }
+}
+
+bool VulkanRendererNative::createGBuffer() {
+    LOGI("Creating G-buffer: %dx%d", swapchainExtent.width, swapchainExtent.height);
+
+    if (!createAttachment(GBUFFER_ALBEDO_FORMAT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                          VK_IMAGE_ASPECT_COLOR_BIT, gbufferAlbedo) ||
+        !createAttachment(GBUFFER_NORMAL_FORMAT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
+                          VK_IMAGE_ASPECT_COLOR_BIT, gbufferNormal) ||
+        !createAttachment(findDepthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                          VK_IMAGE_ASPECT_DEPTH_BIT, depthAttachment)) {
+        destroyGBuffer();
+        return false;
+    }
+
+    // Layout de input attachments para el subpass de iluminación (se crea una vez)
+    if (gbufferSetLayout == VK_NULL_HANDLE) {
+        VkDescriptorSetLayoutBinding bindings[3]{};
+        for (uint32_t i = 0; i < 3; i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        }
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 3;
+        layoutInfo.pBindings = bindings;
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &gbufferSetLayout) != VK_SUCCESS) {
+            LOGE("Failed to create G-buffer descriptor set layout");
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &gbufferSetLayout;
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &gbufferDescriptorSet) != VK_SUCCESS) {
+            LOGE("Failed to allocate G-buffer descriptor set");
+            return false;
+        }
+    }
+
+    // Las views cambian con cada swapchain: reescribir el set
+    VkDescriptorImageInfo imageInfos[3] = {
+        {VK_NULL_HANDLE, gbufferAlbedo.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {VK_NULL_HANDLE, gbufferNormal.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        {VK_NULL_HANDLE, depthAttachment.view, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL}
+    };
+
+    VkWriteDescriptorSet writes[3]{};
+    for (uint32_t i = 0; i < 3; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = gbufferDescriptorSet;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+        writes[i].pImageInfo = &imageInfos[i];
+    }
+    vkUpdateDescriptorSets(device, 3, writes, 0, nullptr);
+
+    return true;
+}
+
+void VulkanRendererNative::destroyGBuffer() {
+    destroyAttachment(gbufferAlbedo);
+    destroyAttachment(gbufferNormal);
+    destroyAttachment(depthAttachment);
+}
+
+bool VulkanRendererNative::recordLightingSubpass(VkCommandBuffer cmd) {
+    if (shadingPath != ShadingPath::Deferred) return false;
+
+    auto it = pipelines.find(lightingPipeline);
+    if (it == pipelines.end() || it->second->state != PipelineState::Ready) {
+        return false;
+    }
+
+    // Triángulo a pantalla completa, el vertex shader genera las posiciones
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, it->second->pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, it->second->layout,
+                            0, 1, &gbufferDescriptorSet, 0, nullptr);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    return true;
+}
@@ -1,7 +1,5 @@
 #include "vulkan_renderer_native.h"
 #include <android/log.h>
-#include <vector>
-#include <set>
 
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "VulkanDevice", __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanDevice", __VA_ARGS__)
@@ -17,11 +15,13 @@ bool VulkanRendererNative::pickPhysicalDevice() {
         return false;
     }
     
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+    ScratchScope scratch;
+    VkPhysicalDevice* devices = scratch.allocateArray<VkPhysicalDevice>(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices);
     
     // Seleccionar el primer dispositivo adecuado
-    for (const auto& device : devices) {
+    for (uint32_t i = 0; i < deviceCount; i++) {
+        VkPhysicalDevice device = devices[i];
         VkPhysicalDeviceProperties properties;
         vkGetPhysicalDeviceProperties(device, &properties);
         
@@ -55,8 +55,9 @@ bool VulkanRendererNative::createLogicalDevice() {
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
     
-    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    ScratchScope scratch;
+    VkQueueFamilyProperties* queueFamilies = scratch.allocateArray<VkQueueFamilyProperties>(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies);
     
     // Encontrar graphics queue family
     graphicsQueueFamily = UINT32_MAX;
@@ -80,26 +81,33 @@ bool VulkanRendererNative::createLogicalDevice() {
         return false;
     }
     
-    // Crear queues
-    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {
+    // Crear queues: una por familia distinta (como mucho tres)
+    const uint32_t queueFamilyIndices[3] = {
         graphicsQueueFamily,
         computeQueueFamily != UINT32_MAX ? computeQueueFamily : graphicsQueueFamily,
         transferQueueFamily != UINT32_MAX ? transferQueueFamily : graphicsQueueFamily
     };
     
+    VkDeviceQueueCreateInfo queueCreateInfos[3];
+    uint32_t queueCreateInfoCount = 0;
     float queuePriority = 1.0f;
-    for (uint32_t queueFamily : uniqueQueueFamilies) {
+    for (uint32_t queueFamily : queueFamilyIndices) {
+        bool duplicate = false;
+        for (uint32_t i = 0; i < queueCreateInfoCount; i++) {
+            duplicate |= queueCreateInfos[i].queueFamilyIndex == queueFamily;
+        }
+        if (duplicate) continue;
+        
         VkDeviceQueueCreateInfo queueCreateInfo{};
         queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueCreateInfo.queueFamilyIndex = queueFamily;
         queueCreateInfo.queueCount = 1;
         queueCreateInfo.pQueuePriorities = &queuePriority;
-        queueCreateInfos.push_back(queueCreateInfo);
+        queueCreateInfos[queueCreateInfoCount++] = queueCreateInfo;
     }
     
     // Device extensions
-    std::vector<const char*> deviceExtensions = {
+    const char* deviceExtensions[] = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
     
@@ -111,11 +119,11 @@ bool VulkanRendererNative::createLogicalDevice() {
     // Device create info
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
-    createInfo.pQueueCreateInfos = queueCreateInfos.data();
+    createInfo.queueCreateInfoCount = queueCreateInfoCount;
+    createInfo.pQueueCreateInfos = queueCreateInfos;
     createInfo.pEnabledFeatures = &features;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(sizeof(deviceExtensions) / sizeof(deviceExtensions[0]));
+    createInfo.ppEnabledExtensionNames = deviceExtensions;
     
     // Crear device
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS) {
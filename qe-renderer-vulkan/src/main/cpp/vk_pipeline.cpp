@@ -5,6 +5,10 @@
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanPipeline", __VA_ARGS__)
 
 bool VulkanRendererNative::createRenderPass() {
+    if (shadingPath == ShadingPath::Deferred) {
+        return createDeferredRenderPass();
+    }
+    
     LOGI("Creating render pass");
     
     VkAttachmentDescription colorAttachment{};
@@ -155,7 +159,6 @@ uint64_t VulkanRendererNative::createGraphicsPipeline(
     
     LOGI("Creating graphics pipeline with shaders");
     
-    // TODO: Implement with shaders
-    
-    return nextResourceId++;
+    // Devuelve el handle al instante, se compila en segundo plano
+    return requestPipeline(vertexShader, fragmentShader, config);
 }
@@ -0,0 +1,451 @@
+// vk_pipeline_compiler.cpp
+#include "vulkan_renderer_native.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "VulkanPipelineCompiler", __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, "VulkanPipelineCompiler", __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanPipelineCompiler", __VA_ARGS__)
+
+/**
+ * Compilación asíncrona de pipelines
+ *
+ * createGraphicsPipeline() devuelve el handle al instante y encola la compilación
+ * en un pool de workers nativos. Mientras el pipeline está pendiente se dibuja con
+ * el pipeline de fallback de su mismo vertex layout. Los resultados se instalan en
+ * el hilo de render (beginFrame) para no tocar el mapa de pipelines desde los workers.
+ *
+ * Cada petición guarda el render pass con el que se compila. Antes de destruirlo
+ * (cambio de ruta de sombreado, swapchain recreado) se vacía el compilador y después
+ * se recompilan todos los pipelines contra el render pass nuevo.
+ */
+
+// Índices del IntArray de PipelineConfig.toNative()
+enum PipelineConfigIndex : int {
+    CONFIG_TOPOLOGY = 0,
+    CONFIG_CULL_MODE = 1,
+    CONFIG_FRONT_FACE = 2,
+    CONFIG_DEPTH_TEST = 3,
+    CONFIG_DEPTH_WRITE = 4,
+    CONFIG_BLEND = 5,
+    CONFIG_SUBPASS = 6,
+    CONFIG_VERTEX_LAYOUT = 7
+};
+
+static void getVertexLayout(VertexLayout layout, uint32_t& stride,
+                            VkVertexInputAttributeDescription* attributes, uint32_t& attributeCount) {
+    // Interleaved en un único binding: posición, normal, uv
+    attributeCount = 0;
+    stride = 0;
+
+    attributes[attributeCount++] = {0, 0, VK_FORMAT_R32G32B32_SFLOAT, stride};
+    stride += 3 * sizeof(float);
+
+    if (layout == VertexLayout::PositionNormal || layout == VertexLayout::PositionNormalUV) {
+        attributes[attributeCount++] = {1, 0, VK_FORMAT_R32G32B32_SFLOAT, stride};
+        stride += 3 * sizeof(float);
+    }
+
+    if (layout == VertexLayout::PositionNormalUV) {
+        attributes[attributeCount++] = {2, 0, VK_FORMAT_R32G32_SFLOAT, stride};
+        stride += 2 * sizeof(float);
+    }
+}
+
+uint64_t VulkanRendererNative::requestPipeline(uint64_t vertexShader, uint64_t fragmentShader,
+                                               const int* config) {
+    auto vsIt = shaders.find(vertexShader);
+    auto fsIt = shaders.find(fragmentShader);
+    if (vsIt == shaders.end() || fsIt == shaders.end()) {
+        LOGE("Invalid shader handles for pipeline");
+        return 0;
+    }
+
+    if (pipelineWorkers.empty() && !startPipelineCompiler()) {
+        return 0;
+    }
+
+    PipelineRequest request{};
+    request.vertexShader = vsIt->second->module;
+    request.fragmentShader = fsIt->second->module;
+    request.topology = static_cast<VkPrimitiveTopology>(config[CONFIG_TOPOLOGY]);
+    request.cullMode = static_cast<VkCullModeFlags>(config[CONFIG_CULL_MODE]);
+    request.frontFace = static_cast<VkFrontFace>(config[CONFIG_FRONT_FACE]);
+    request.depthTest = config[CONFIG_DEPTH_TEST] != 0;
+    request.depthWrite = config[CONFIG_DEPTH_WRITE] != 0;
+    request.blend = config[CONFIG_BLEND] != 0;
+    request.subpass = static_cast<uint32_t>(config[CONFIG_SUBPASS]);
+    request.vertexLayout = static_cast<VertexLayout>(
+        std::min(std::max(config[CONFIG_VERTEX_LAYOUT], 0), VERTEX_LAYOUT_COUNT - 1));
+    request.renderPass = renderPass;
+
+    // El subpass de geometría deferred escribe albedo + normal
+    request.colorAttachmentCount =
+        (shadingPath == ShadingPath::Deferred && request.subpass == 0) ? 2 : 1;
+
+    auto pipeline = std::make_shared<Pipeline>();
+    pipeline->vertexLayout = request.vertexLayout;
+
+    // El layout es barato: se crea aquí para que el handle ya sea utilizable
+    if (!createPipelineLayout(request.subpass, pipeline->layout)) {
+        return 0;
+    }
+
+    request.layout = pipeline->layout;
+    request.handle = nextResourceId++;
+    pipeline->request = request;
+    pipelines[request.handle] = pipeline;
+
+    queuePipelineRequest(request);
+    return request.handle;
+}
+
+bool VulkanRendererNative::createPipelineLayout(uint32_t subpass, VkPipelineLayout& layout) {
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(DrawConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushConstantRange;
+    // Set 0: scene buffer en geometría, G-buffer en iluminación
+    if (subpass == 1 && gbufferSetLayout != VK_NULL_HANDLE) {
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &gbufferSetLayout;
+    } else if (subpass == 0 && sceneSetLayout != VK_NULL_HANDLE) {
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &sceneSetLayout;
+    }
+
+    if (vkCreatePipelineLayout(device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        LOGE("Failed to create pipeline layout");
+        return false;
+    }
+    return true;
+}
+
+void VulkanRendererNative::queuePipelineRequest(const PipelineRequest& request) {
+    {
+        std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+        pipelineQueue.push_back(request);
+        pendingPipelineCount++;
+    }
+    pipelineQueueCondition.notify_one();
+}
+
+void VulkanRendererNative::drainPipelineCompiler() {
+    // Lo que aún no empezó se descarta; lo que está compilando se espera
+    {
+        std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+        pendingPipelineCount -= pipelineQueue.size();
+        pipelineQueue.clear();
+    }
+    waitForPipelineCompiler();
+
+    // Resultados compilados contra el render pass que se va a destruir
+    std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+    for (const auto& result : completedPipelines) {
+        if (result.pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, result.pipeline, nullptr);
+        }
+    }
+    pendingPipelineCount -= completedPipelines.size();
+    completedPipelines.clear();
+}
+
+void VulkanRendererNative::rebuildPipelines() {
+    // Requiere el compilador vacío (drainPipelineCompiler) y la GPU ociosa
+    for (auto& entry : pipelines) {
+        Pipeline& pipeline = *entry.second;
+
+        if (pipeline.pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline.pipeline, nullptr);
+            pipeline.pipeline = VK_NULL_HANDLE;
+        }
+
+        // El set layout del G-buffer puede haber aparecido al pasar a deferred
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        if (!createPipelineLayout(pipeline.request.subpass, layout)) {
+            pipeline.state = PipelineState::Failed;
+            continue;
+        }
+        vkDestroyPipelineLayout(device, pipeline.layout, nullptr);
+        pipeline.layout = layout;
+
+        PipelineRequest& request = pipeline.request;
+        request.layout = layout;
+        request.renderPass = renderPass;
+        request.colorAttachmentCount =
+            (shadingPath == ShadingPath::Deferred && request.subpass == 0) ? 2 : 1;
+
+        // Mientras recompila se dibuja con el fallback de su vertex layout
+        pipeline.state = PipelineState::Pending;
+        queuePipelineRequest(request);
+    }
+
+    if (!pipelines.empty()) {
+        LOGI("Recompiling %zu pipelines for the new render pass", pipelines.size());
+    }
+}
+
+bool VulkanRendererNative::startPipelineCompiler() {
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+    if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+        LOGW("Failed to create pipeline cache, compiling without it");
+        pipelineCache = VK_NULL_HANDLE;
+    }
+
+    // Dejar núcleos libres para el hilo de juego y el de render
+    unsigned int cores = std::thread::hardware_concurrency();
+    unsigned int workerCount = std::max(1u, std::min(4u, cores > 2 ? cores - 2 : 1u));
+
+    stopPipelineWorkers = false;
+    for (unsigned int i = 0; i < workerCount; i++) {
+        pipelineWorkers.emplace_back(&VulkanRendererNative::pipelineWorkerLoop, this);
+    }
+
+    LOGI("Pipeline compiler started with %u workers", workerCount);
+    return true;
+}
+
+void VulkanRendererNative::stopPipelineCompiler() {
+    {
+        std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+        stopPipelineWorkers = true;
+        pipelineQueue.clear();
+    }
+    pipelineQueueCondition.notify_all();
+
+    for (auto& worker : pipelineWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    pipelineWorkers.clear();
+
+    // Resultados que nadie instaló
+    for (const auto& result : completedPipelines) {
+        if (result.pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, result.pipeline, nullptr);
+        }
+    }
+    completedPipelines.clear();
+    pendingPipelineCount = 0;
+
+    if (pipelineCache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(device, pipelineCache, nullptr);
+        pipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+void VulkanRendererNative::waitForPipelineCompiler() {
+    std::unique_lock<std::mutex> lock(pipelineQueueMutex);
+    pipelineIdleCondition.wait(lock, [this] { return pendingPipelineCount == completedPipelines.size(); });
+}
+
+void VulkanRendererNative::pipelineWorkerLoop() {
+    for (;;) {
+        PipelineRequest request;
+        {
+            std::unique_lock<std::mutex> lock(pipelineQueueMutex);
+            pipelineQueueCondition.wait(lock, [this] {
+                return stopPipelineWorkers || !pipelineQueue.empty();
+            });
+
+            if (stopPipelineWorkers) return;
+
+            request = pipelineQueue.front();
+            pipelineQueue.pop_front();
+        }
+
+        PipelineResult result{};
+        result.handle = request.handle;
+        result.pipeline = buildPipeline(request);
+
+        {
+            std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+            completedPipelines.push_back(result);
+        }
+        pipelineIdleCondition.notify_all();
+    }
+}
+
+VkPipeline VulkanRendererNative::buildPipeline(const PipelineRequest& request) {
+    if (request.renderPass == VK_NULL_HANDLE) {
+        LOGE("Pipeline %llu requested without render pass", (unsigned long long)request.handle);
+        return VK_NULL_HANDLE;
+    }
+
+    VkPipelineShaderStageCreateInfo stages[2]{};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = request.vertexShader;
+    stages[0].pName = "main";
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = request.fragmentShader;
+    stages[1].pName = "main";
+
+    // El subpass de iluminación dibuja un triángulo sin vertex buffer
+    VkVertexInputBindingDescription binding{};
+    VkVertexInputAttributeDescription attributes[3]{};
+    uint32_t attributeCount = 0;
+    getVertexLayout(request.vertexLayout, binding.stride, attributes, attributeCount);
+    binding.binding = 0;
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    if (request.subpass == 0) {
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &binding;
+        vertexInputInfo.vertexAttributeDescriptionCount = attributeCount;
+        vertexInputInfo.pVertexAttributeDescriptions = attributes;
+    }
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = request.topology;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport y scissor dinámicos: el pipeline no depende del tamaño del swapchain
+    VkPipelineViewportStateCreateInfo viewportState{};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkDynamicState dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer{};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = request.cullMode;
+    rasterizer.frontFace = request.frontFace;
+
+    VkPipelineMultisampleStateCreateInfo multisampling{};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil{};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = request.depthTest ? VK_TRUE : VK_FALSE;
+    depthStencil.depthWriteEnable = request.depthWrite ? VK_TRUE : VK_FALSE;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    VkPipelineColorBlendAttachmentState blendAttachments[2]{};
+    for (uint32_t i = 0; i < request.colorAttachmentCount; i++) {
+        VkPipelineColorBlendAttachmentState& blend = blendAttachments[i];
+        blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                               VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        blend.blendEnable = request.blend ? VK_TRUE : VK_FALSE;
+        blend.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blend.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blend.colorBlendOp = VK_BLEND_OP_ADD;
+        blend.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        blend.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        blend.alphaBlendOp = VK_BLEND_OP_ADD;
+    }
+
+    VkPipelineColorBlendStateCreateInfo colorBlending{};
+    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlending.attachmentCount = request.colorAttachmentCount;
+    colorBlending.pAttachments = blendAttachments;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = 2;
+    pipelineInfo.pStages = stages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = request.layout;
+    pipelineInfo.renderPass = request.renderPass;
+    pipelineInfo.subpass = request.subpass;
+
+    // VkPipelineCache está sincronizado internamente
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device, pipelineCache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+        LOGE("Failed to compile pipeline %llu", (unsigned long long)request.handle);
+        return VK_NULL_HANDLE;
+    }
+
+    return pipeline;
+}
+
+void VulkanRendererNative::processCompletedPipelines() {
+    // Copia en la arena del frame: completedPipelines conserva su capacidad
+    PipelineResult* results;
+    size_t resultCount;
+    {
+        std::lock_guard<std::mutex> lock(pipelineQueueMutex);
+        if (completedPipelines.empty()) return;
+        resultCount = completedPipelines.size();
+        results = frameArena.allocateArray<PipelineResult>(resultCount);
+        std::copy(completedPipelines.begin(), completedPipelines.end(), results);
+        completedPipelines.clear();
+        pendingPipelineCount -= resultCount;
+    }
+
+    for (size_t i = 0; i < resultCount; i++) {
+        const PipelineResult& result = results[i];
+        auto it = pipelines.find(result.handle);
+        if (it == pipelines.end()) {
+            if (result.pipeline != VK_NULL_HANDLE) {
+                vkDestroyPipeline(device, result.pipeline, nullptr);
+            }
+            continue;
+        }
+
+        Pipeline& pipeline = *it->second;
+        pipeline.pipeline = result.pipeline;
+        pipeline.state = result.pipeline != VK_NULL_HANDLE ? PipelineState::Ready : PipelineState::Failed;
+
+        pipelineEvents.push_back(result.handle);
+    }
+}
+
+const Pipeline* VulkanRendererNative::resolvePipeline(uint64_t pipelineHandle) const {
+    auto it = pipelines.find(pipelineHandle);
+    if (it == pipelines.end()) return nullptr;
+
+    const Pipeline* pipeline = it->second.get();
+    if (pipeline->state == PipelineState::Ready) return pipeline;
+
+    // Pendiente o fallido: dibujar con el fallback de su vertex layout
+    uint64_t fallback = fallbackPipelines[static_cast<int>(pipeline->vertexLayout)];
+    if (fallback == 0 || fallback == pipelineHandle) return nullptr;
+
+    auto fallbackIt = pipelines.find(fallback);
+    if (fallbackIt == pipelines.end() || fallbackIt->second->state != PipelineState::Ready) {
+        return nullptr;
+    }
+
+    return fallbackIt->second.get();
+}
+
+void VulkanRendererNative::setFallbackPipeline(int vertexLayout, uint64_t pipelineHandle) {
+    if (vertexLayout < 0 || vertexLayout >= VERTEX_LAYOUT_COUNT) return;
+
+    fallbackPipelines[vertexLayout] = pipelineHandle;
+}
+
+PipelineState VulkanRendererNative::getPipelineState(uint64_t pipelineHandle) const {
+    auto it = pipelines.find(pipelineHandle);
+    if (it == pipelines.end()) return PipelineState::Failed;
+
+    return it->second->state;
+}
@@ -0,0 +1,296 @@
+// vk_scene_buffer.cpp
+#include "vulkan_renderer_native.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstring>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "VulkanSceneBuffer", __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, "VulkanSceneBuffer", __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanSceneBuffer", __VA_ARGS__)
+
+/**
+ * Scene buffer persistente
+ *
+ * Tabla de objetos en un SSBO device-local con slots estables. Kotlin sólo envía
+ * lo que cambió (transform, material, visibilidad); cada slot modificado se marca
+ * dirty y al inicio del frame los slots dirty se agrupan en el mínimo número de
+ * regiones de copia. El coste escala con lo que se movió, no con el tamaño de la escena.
+ *
+ * Los shaders leen el objeto con gl_InstanceIndex (firstInstance = slot).
+ */
+
+// Huecos de hasta N slots limpios se copian igualmente: menos regiones, poco ancho de banda extra
+static const uint32_t SCENE_COPY_MERGE_GAP = 4;
+
+bool VulkanRendererNative::createSceneBuffer(uint32_t capacity) {
+    VkDeviceSize size = static_cast<VkDeviceSize>(capacity) * sizeof(SceneObject);
+
+    createBuffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, sceneBuffer, sceneMemory);
+
+    // Staging persistente mapeado: un solo frame en vuelo, se reutiliza tras el fence
+    createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 sceneStagingBuffer, sceneStagingMemory);
+
+    if (sceneBuffer == VK_NULL_HANDLE || sceneStagingBuffer == VK_NULL_HANDLE) {
+        LOGE("Failed to create scene buffer");
+        return false;
+    }
+
+    if (vkMapMemory(device, sceneStagingMemory, 0, size, 0, &sceneStagingMapped) != VK_SUCCESS) {
+        LOGE("Failed to map scene staging buffer");
+        return false;
+    }
+
+    if (sceneSetLayout == VK_NULL_HANDLE) {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkDescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+
+        if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &sceneSetLayout) != VK_SUCCESS) {
+            LOGE("Failed to create scene descriptor set layout");
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &sceneSetLayout;
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, &sceneDescriptorSet) != VK_SUCCESS) {
+            LOGE("Failed to allocate scene descriptor set");
+            return false;
+        }
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = sceneBuffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = sceneDescriptorSet;
+    write.dstBinding = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+
+    sceneCapacity = capacity;
+    sceneObjects.resize(capacity);
+    sceneDirtyFlags.resize(capacity, 0);
+    sceneSlotLive.resize(capacity, 0);
+
+    LOGI("Scene buffer created: %u objects (%llu KB)", capacity,
+         (unsigned long long)(size / 1024));
+    return true;
+}
+
+void VulkanRendererNative::destroySceneBuffer() {
+    if (sceneStagingMapped != nullptr) {
+        vkUnmapMemory(device, sceneStagingMemory);
+        sceneStagingMapped = nullptr;
+    }
+    if (sceneStagingBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, sceneStagingBuffer, nullptr);
+        sceneStagingBuffer = VK_NULL_HANDLE;
+    }
+    if (sceneStagingMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, sceneStagingMemory, nullptr);
+        sceneStagingMemory = VK_NULL_HANDLE;
+    }
+    if (sceneBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, sceneBuffer, nullptr);
+        sceneBuffer = VK_NULL_HANDLE;
+    }
+    if (sceneMemory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, sceneMemory, nullptr);
+        sceneMemory = VK_NULL_HANDLE;
+    }
+    sceneCapacity = 0;
+}
+
+bool VulkanRendererNative::growSceneBuffer(uint32_t minCapacity) {
+    uint32_t capacity = std::max(sceneCapacity, SCENE_INITIAL_CAPACITY);
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
+
+    LOGI("Growing scene buffer to %u objects", capacity);
+
+    vkDeviceWaitIdle(device);
+    destroySceneBuffer();
+
+    if (!createSceneBuffer(capacity)) {
+        return false;
+    }
+
+    // Los secondary buffers grabados con el descriptor anterior dejan de ser válidos
+    invalidateStaticChunks();
+
+    // El buffer nuevo está vacío: subir todos los slots vivos
+    for (uint32_t slot = 0; slot < sceneObjectCount; slot++) {
+        markSceneObjectDirty(slot);
+    }
+    return true;
+}
+
+uint32_t VulkanRendererNative::allocateSceneObject() {
+    uint32_t slot;
+
+    if (!sceneFreeSlots.empty()) {
+        slot = sceneFreeSlots.back();
+        sceneFreeSlots.pop_back();
+    } else {
+        if (sceneObjectCount >= sceneCapacity && !growSceneBuffer(sceneObjectCount + 1)) {
+            return UINT32_MAX;
+        }
+        slot = sceneObjectCount++;
+    }
+
+    SceneObject& object = sceneObjects[slot];
+    memset(&object, 0, sizeof(SceneObject));
+    object.transform[0] = object.transform[5] = object.transform[10] = object.transform[15] = 1.0f;
+    object.color[0] = object.color[1] = object.color[2] = object.color[3] = 1.0f;
+    object.flags = SCENE_OBJECT_VISIBLE;
+
+    sceneSlotLive[slot] = 1;
+    markSceneObjectDirty(slot);
+    return slot;
+}
+
+void VulkanRendererNative::releaseSceneObject(uint32_t slot) {
+    if (slot >= sceneObjectCount) return;
+
+    // Un doble release metería el slot dos veces en la lista libre
+    if (!sceneSlotLive[slot]) {
+        LOGW("Scene slot %u released twice, ignoring", slot);
+        return;
+    }
+    sceneSlotLive[slot] = 0;
+
+    // Un slot libre queda invisible hasta reutilizarse
+    sceneObjects[slot].flags = 0;
+    markSceneObjectDirty(slot);
+    sceneFreeSlots.push_back(slot);
+}
+
+void VulkanRendererNative::updateSceneTransforms(const int* slots, const float* matrices, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t slot = static_cast<uint32_t>(slots[i]);
+        if (slot >= sceneObjectCount) continue;
+
+        memcpy(sceneObjects[slot].transform, matrices + i * 16, sizeof(float) * 16);
+        markSceneObjectDirty(slot);
+    }
+}
+
+void VulkanRendererNative::updateSceneMaterials(const int* slots, const float* colors,
+                                                const int* materialIds, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t slot = static_cast<uint32_t>(slots[i]);
+        if (slot >= sceneObjectCount) continue;
+
+        memcpy(sceneObjects[slot].color, colors + i * 4, sizeof(float) * 4);
+        sceneObjects[slot].materialId = static_cast<uint32_t>(materialIds[i]);
+        markSceneObjectDirty(slot);
+    }
+}
+
+void VulkanRendererNative::updateSceneVisibility(const int* slots, const int* flags, int count) {
+    for (int i = 0; i < count; i++) {
+        uint32_t slot = static_cast<uint32_t>(slots[i]);
+        if (slot >= sceneObjectCount) continue;
+
+        sceneObjects[slot].flags = static_cast<uint32_t>(flags[i]);
+        markSceneObjectDirty(slot);
+    }
+}
+
+void VulkanRendererNative::updateTransforms() {
+    transforms.update();
+
+    // Sólo los nodos cuya matriz world cambió llegan al scene buffer
+    const std::vector<uint32_t>& slots = transforms.getChangedSlots();
+    const std::vector<const float*>& matrices = transforms.getChangedMatrices();
+
+    for (size_t i = 0; i < slots.size(); i++) {
+        uint32_t slot = slots[i];
+        if (slot >= sceneObjectCount) continue;
+
+        memcpy(sceneObjects[slot].transform, matrices[i], sizeof(float) * 16);
+        markSceneObjectDirty(slot);
+    }
+}
+
+VkDeviceSize VulkanRendererNative::recordSceneUpload(VkCommandBuffer cmd) {
+    if (sceneDirtySlots.empty()) return 0;
+
+    std::sort(sceneDirtySlots.begin(), sceneDirtySlots.end());
+
+    // Agrupar slots contiguos (o casi) en regiones de copia
+    sceneCopyRegions.clear();
+    uint32_t first = sceneDirtySlots[0];
+    uint32_t last = first;
+
+    for (size_t i = 1; i <= sceneDirtySlots.size(); i++) {
+        if (i < sceneDirtySlots.size() && sceneDirtySlots[i] <= last + SCENE_COPY_MERGE_GAP + 1) {
+            last = sceneDirtySlots[i];
+            continue;
+        }
+
+        VkBufferCopy region{};
+        region.srcOffset = static_cast<VkDeviceSize>(first) * sizeof(SceneObject);
+        region.dstOffset = region.srcOffset;
+        region.size = static_cast<VkDeviceSize>(last - first + 1) * sizeof(SceneObject);
+        sceneCopyRegions.push_back(region);
+
+        if (i < sceneDirtySlots.size()) {
+            first = last = sceneDirtySlots[i];
+        }
+    }
+
+    // La copia CPU se hace aquí, tras el fence, para no pisar la lectura del frame anterior
+    VkDeviceSize uploaded = 0;
+    auto* staging = static_cast<uint8_t*>(sceneStagingMapped);
+    for (const VkBufferCopy& region : sceneCopyRegions) {
+        memcpy(staging + region.srcOffset,
+               reinterpret_cast<const uint8_t*>(sceneObjects.data()) + region.srcOffset,
+               region.size);
+        uploaded += region.size;
+    }
+
+    vkCmdCopyBuffer(cmd, sceneStagingBuffer, sceneBuffer,
+                    static_cast<uint32_t>(sceneCopyRegions.size()), sceneCopyRegions.data());
+
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = sceneBuffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                         0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+    for (uint32_t slot : sceneDirtySlots) {
+        sceneDirtyFlags[slot] = 0;
+    }
+    sceneDirtySlots.clear();
+
+    return uploaded;
+}
@@ -0,0 +1,229 @@
+// vk_static_cache.cpp
+#include "vulkan_renderer_native.h"
+#include <android/log.h>
+#include <cstring>
+
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, "VulkanStaticCache", __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, "VulkanStaticCache", __VA_ARGS__)
+
+/**
+ * Cache de contenido estático por chunk
+ *
+ * La geometría estática (chunks de terreno, edificios de generateCity) se graba
+ * una sola vez en un secondary command buffer por chunk. Sólo se vuelve a grabar
+ * cuando cambia el contenido del chunk, alguno de sus pipelines o el render target;
+ * el resto de frames cuesta un vkCmdExecuteCommands.
+ *
+ * Cada draw ocupa un slot del scene buffer (firstInstance = slot), así que un
+ * chunk estático es un conjunto de objetos más de la tabla de escena.
+ */
+
+void VulkanRendererNative::releaseStaticDraws(StaticChunk& chunk) {
+    for (const StaticDraw& draw : chunk.draws) {
+        releaseSceneObject(draw.sceneSlot);
+    }
+    chunk.draws.clear();
+}
+
+void VulkanRendererNative::beginStaticChunk(uint64_t chunkId) {
+    StaticChunk& chunk = staticChunks[chunkId];
+    releaseStaticDraws(chunk);
+    chunk.dirty = true;
+}
+
+void VulkanRendererNative::submitStaticMesh(uint64_t chunkId, uint64_t meshHandle, uint64_t pipelineHandle,
+                                            const float* transform, const float* color) {
+    StaticChunk& chunk = staticChunks[chunkId];
+
+    StaticDraw draw{};
+    draw.mesh = meshHandle;
+    draw.pipeline = pipelineHandle;
+    memcpy(draw.constants.transform, transform, sizeof(draw.constants.transform));
+    memcpy(draw.constants.color, color, sizeof(draw.constants.color));
+
+    draw.sceneSlot = allocateSceneObject();
+    if (draw.sceneSlot == UINT32_MAX) {
+        LOGE("No scene slot for static mesh in chunk %llu", (unsigned long long)chunkId);
+        return;
+    }
+
+    SceneObject& object = sceneObjects[draw.sceneSlot];
+    memcpy(object.transform, transform, sizeof(object.transform));
+    memcpy(object.color, color, sizeof(object.color));
+
+    chunk.draws.push_back(draw);
+    chunk.dirty = true;
+}
+
+void VulkanRendererNative::removeStaticChunk(uint64_t chunkId) {
+    auto it = staticChunks.find(chunkId);
+    if (it == staticChunks.end()) return;
+
+    // El frame en vuelo puede estar ejecutándolo: se libera tras su fence
+    if (it->second.commandBuffer != VK_NULL_HANDLE) {
+        pendingStaticFrees.push_back(it->second.commandBuffer);
+    }
+
+    releaseStaticDraws(it->second);
+    staticChunks.erase(it);
+}
+
+void VulkanRendererNative::freeRetiredStaticChunks() {
+    if (pendingStaticFrees.empty()) return;
+
+    vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(pendingStaticFrees.size()),
+                         pendingStaticFrees.data());
+    pendingStaticFrees.clear();
+}
+
+void VulkanRendererNative::invalidateStaticChunks() {
+    for (auto& entry : staticChunks) {
+        entry.second.dirty = true;
+    }
+}
+
+void VulkanRendererNative::clearStaticChunks() {
+    if (device == VK_NULL_HANDLE) {
+        staticChunks.clear();
+        pendingStaticFrees.clear();
+        return;
+    }
+
+    freeRetiredStaticChunks();
+
+    for (auto& entry : staticChunks) {
+        if (entry.second.commandBuffer != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(device, commandPool, 1, &entry.second.commandBuffer);
+        }
+    }
+    staticChunks.clear();
+}
+
+bool VulkanRendererNative::isStaticChunkValid(const StaticChunk& chunk) const {
+    if (chunk.dirty || chunk.commandBuffer == VK_NULL_HANDLE) return false;
+    if (chunk.renderTargetGeneration != renderTargetGeneration) return false;
+
+    // Un pipeline puede cambiar de VkPipeline (p.ej. al terminar su compilación)
+    for (const auto& bound : chunk.boundPipelines) {
+        const Pipeline* pipeline = resolvePipeline(bound.first);
+        if (pipeline == nullptr || pipeline->pipeline != bound.second) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool VulkanRendererNative::recordStaticChunk(StaticChunk& chunk) {
+    if (chunk.commandBuffer == VK_NULL_HANDLE) {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &chunk.commandBuffer) != VK_SUCCESS) {
+            LOGE("Failed to allocate secondary command buffer");
+            return false;
+        }
+    }
+
+    // Sin framebuffer heredado: el mismo buffer vale para todas las imágenes del swapchain
+    VkCommandBufferInheritanceInfo inheritance{};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.renderPass = renderPass;
+    inheritance.subpass = 0;
+    inheritance.framebuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                      VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    if (vkBeginCommandBuffer(chunk.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        LOGE("Failed to begin secondary command buffer");
+        return false;
+    }
+
+    VkViewport viewport{};
+    viewport.width = (float)swapchainExtent.width;
+    viewport.height = (float)swapchainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(chunk.commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.extent = swapchainExtent;
+    vkCmdSetScissor(chunk.commandBuffer, 0, 1, &scissor);
+
+    chunk.boundPipelines.clear();
+    uint64_t currentPipeline = 0;
+    const Pipeline* pipeline = nullptr;
+
+    for (const StaticDraw& draw : chunk.draws) {
+        auto meshIt = meshes.find(draw.mesh);
+        if (meshIt == meshes.end()) continue;
+
+        if (draw.pipeline != currentPipeline) {
+            // Si aún compila se graba con el fallback y se regraba al terminar
+            pipeline = resolvePipeline(draw.pipeline);
+            if (pipeline == nullptr) continue;
+
+            currentPipeline = draw.pipeline;
+            vkCmdBindPipeline(chunk.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline->pipeline);
+            chunk.boundPipelines.emplace_back(draw.pipeline, pipeline->pipeline);
+        }
+
+        recordDraw(chunk.commandBuffer, *pipeline, *meshIt->second, draw.constants, draw.sceneSlot);
+    }
+
+    if (vkEndCommandBuffer(chunk.commandBuffer) != VK_SUCCESS) {
+        LOGE("Failed to end secondary command buffer");
+        return false;
+    }
+
+    chunk.renderTargetGeneration = renderTargetGeneration;
+    chunk.dirty = false;
+    return true;
+}
+
+void VulkanRendererNative::recordDraw(VkCommandBuffer cmd, const Pipeline& pipeline, const Mesh& mesh,
+                                      const DrawConstants& constants, uint32_t sceneSlot) {
+    // Set 0 de los pipelines de geometría: la tabla de objetos del scene buffer
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.layout,
+                            0, 1, &sceneDescriptorSet, 0, nullptr);
+
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(cmd, mesh.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdPushConstants(cmd, pipeline.layout,
+                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(DrawConstants), &constants);
+    vkCmdDrawIndexed(cmd, mesh.indexCount, 1, 0, 0, sceneSlot);
+}
+
+uint32_t VulkanRendererNative::executeStaticChunks(VkCommandBuffer primary) {
+    // El render pass debe haberse iniciado con VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+    uint32_t rerecorded = 0;
+    staticCommandBuffers.clear();
+
+    for (auto& entry : staticChunks) {
+        StaticChunk& chunk = entry.second;
+        if (chunk.draws.empty()) continue;
+
+        if (!isStaticChunkValid(chunk)) {
+            if (!recordStaticChunk(chunk)) continue;
+            rerecorded++;
+        }
+
+        staticCommandBuffers.push_back(chunk.commandBuffer);
+    }
+
+    if (!staticCommandBuffers.empty()) {
+        vkCmdExecuteCommands(primary, static_cast<uint32_t>(staticCommandBuffers.size()),
+                             staticCommandBuffers.data());
+    }
+
+    return rerecorded;
+}
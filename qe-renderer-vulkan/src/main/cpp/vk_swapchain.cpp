@@ -12,19 +12,28 @@ bool VulkanRendererNative::createSwapchain() {
     VkSurfaceCapabilitiesKHR capabilities;
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, surface, &capabilities);
     
+    // Se recrea en cada resize/rotación: las enumeraciones van a la pila de scratch
+    ScratchScope scratch;
+    
     uint32_t formatCount;
     vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats.data());
+    VkSurfaceFormatKHR* formats = scratch.allocateArray<VkSurfaceFormatKHR>(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, surface, &formatCount, formats);
     
     uint32_t presentModeCount;
     vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, nullptr);
-    std::vector<VkPresentModeKHR> presentModes(presentModeCount);
-    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes.data());
+    VkPresentModeKHR* presentModes = scratch.allocateArray<VkPresentModeKHR>(presentModeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, surface, &presentModeCount, presentModes);
+    
+    if (formatCount == 0) {
+        LOGE("No surface formats available");
+        return false;
+    }
     
     // Seleccionar formato
     VkSurfaceFormatKHR surfaceFormat = formats[0];
-    for (const auto& format : formats) {
+    for (uint32_t i = 0; i < formatCount; i++) {
+        const VkSurfaceFormatKHR& format = formats[i];
         if (format.format == VK_FORMAT_B8G8R8A8_SRGB &&
             format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
             surfaceFormat = format;
@@ -36,9 +45,9 @@ bool VulkanRendererNative::createSwapchain() {
     
     // Seleccionar present mode
     VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    for (const auto& mode : presentModes) {
-        if (mode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            presentMode = mode;
+    for (uint32_t i = 0; i < presentModeCount; i++) {
+        if (presentModes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
+            presentMode = presentModes[i];
             break;
         }
     }
@@ -111,6 +120,8 @@ bool VulkanRendererNative::createSwapchain() {
 }
 
 void VulkanRendererNative::destroySwapchain() {
+    destroyGBuffer();
+    
     for (auto imageView : swapchainImageViews) {
         vkDestroyImageView(device, imageView, nullptr);
     }
@@ -123,6 +134,7 @@ void VulkanRendererNative::destroySwapchain() {
 }
 
 void VulkanRendererNative::recreateSwapchain() {
+    drainPipelineCompiler();
     vkDeviceWaitIdle(device);
     
     destroySwapchain();
@@ -133,5 +145,7 @@ void VulkanRendererNative::recreateSwapchain() {
     framebuffers.clear();
     
     createSwapchain();
+    createRenderPass();
+    rebuildPipelines();
     createFramebuffers();
 }
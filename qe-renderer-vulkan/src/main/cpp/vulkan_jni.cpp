@@ -77,6 +77,26 @@ Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeEndFrame(
     renderer->endFrame();
 }
 
+/**
+ * Contadores de memoria nativa del último frame completo en out[5]:
+ * reservas en la arena, idas al heap, bytes, pico de bytes, capacidad
+ */
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeGetFrameAllocationStats(
+    JNIEnv* env, jobject obj, jlong handle, jlongArray out) {
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    const FrameAllocationStats& stats = renderer->getFrameAllocationStats();
+    
+    jlong values[5] = {
+        static_cast<jlong>(stats.arenaAllocations),
+        static_cast<jlong>(stats.heapAllocations),
+        static_cast<jlong>(stats.arenaBytes),
+        static_cast<jlong>(stats.arenaPeakBytes),
+        static_cast<jlong>(stats.arenaCapacity)
+    };
+    env->SetLongArrayRegion(out, 0, 5, values);
+}
+
 // ========== Rendering ==========
 
 JNIEXPORT void JNICALL
@@ -129,6 +149,207 @@ Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetViewport(
     renderer->setViewport(x, y, width, height);
 }
 
+// ========== Shading Path ==========
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSupportsDeferredShading(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    return renderer->supportsDeferredShading();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetShadingPath(
+    JNIEnv* env, jobject obj, jlong handle, jint path) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    return renderer->setShadingPath(static_cast<ShadingPath>(path));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetLightingPipeline(
+    JNIEnv* env, jobject obj, jlong handle, jlong pipeline) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->setLightingPipeline(pipeline);
+}
+
+// ========== Static Content Cache ==========
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeBeginStaticChunk(
+    JNIEnv* env, jobject obj, jlong handle, jlong chunkId) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->beginStaticChunk(chunkId);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSubmitStaticMesh(
+    JNIEnv* env, jobject obj, jlong handle, jlong chunkId,
+    jlong meshHandle, jlong pipeline, jfloatArray transform, jfloatArray color) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    jfloat* transformData = env->GetFloatArrayElements(transform, nullptr);
+    jfloat* colorData = env->GetFloatArrayElements(color, nullptr);
+    
+    renderer->submitStaticMesh(chunkId, meshHandle, pipeline, transformData, colorData);
+    
+    env->ReleaseFloatArrayElements(transform, transformData, JNI_ABORT);
+    env->ReleaseFloatArrayElements(color, colorData, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeRemoveStaticChunk(
+    JNIEnv* env, jobject obj, jlong handle, jlong chunkId) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->removeStaticChunk(chunkId);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeInvalidateStaticChunks(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->invalidateStaticChunks();
+}
+
+// ========== Scene Buffer ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeAllocateSceneObject(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    return static_cast<jint>(renderer->allocateSceneObject());
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeReleaseSceneObject(
+    JNIEnv* env, jobject obj, jlong handle, jint slot) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->releaseSceneObject(static_cast<uint32_t>(slot));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeUpdateSceneTransforms(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray matrices, jint count) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    jint* slotData = env->GetIntArrayElements(slots, nullptr);
+    jfloat* matrixData = env->GetFloatArrayElements(matrices, nullptr);
+    
+    renderer->updateSceneTransforms(slotData, matrixData, count);
+    
+    env->ReleaseIntArrayElements(slots, slotData, JNI_ABORT);
+    env->ReleaseFloatArrayElements(matrices, matrixData, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeUpdateSceneMaterials(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jfloatArray colors, jintArray materialIds, jint count) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    jint* slotData = env->GetIntArrayElements(slots, nullptr);
+    jfloat* colorData = env->GetFloatArrayElements(colors, nullptr);
+    jint* materialData = env->GetIntArrayElements(materialIds, nullptr);
+    
+    renderer->updateSceneMaterials(slotData, colorData, materialData, count);
+    
+    env->ReleaseIntArrayElements(slots, slotData, JNI_ABORT);
+    env->ReleaseFloatArrayElements(colors, colorData, JNI_ABORT);
+    env->ReleaseIntArrayElements(materialIds, materialData, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeUpdateSceneVisibility(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray slots, jintArray flags, jint count) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    jint* slotData = env->GetIntArrayElements(slots, nullptr);
+    jint* flagData = env->GetIntArrayElements(flags, nullptr);
+    
+    renderer->updateSceneVisibility(slotData, flagData, count);
+    
+    env->ReleaseIntArrayElements(slots, slotData, JNI_ABORT);
+    env->ReleaseIntArrayElements(flags, flagData, JNI_ABORT);
+}
+
+// ========== Transform Hierarchy ==========
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeCreateTransformNode(
+    JNIEnv* env, jobject obj, jlong handle, jint parent, jint sceneSlot) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    return renderer->getTransforms().createNode(parent, static_cast<uint32_t>(sceneSlot));
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeDestroyTransformNode(
+    JNIEnv* env, jobject obj, jlong handle, jint node) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->getTransforms().destroyNode(node);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetTransformParent(
+    JNIEnv* env, jobject obj, jlong handle, jint node, jint parent) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->getTransforms().setParent(node, parent);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetLocalTransforms(
+    JNIEnv* env, jobject obj, jlong handle,
+    jintArray nodes, jfloatArray trs, jint count) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    jint* nodeData = env->GetIntArrayElements(nodes, nullptr);
+    jfloat* trsData = env->GetFloatArrayElements(trs, nullptr);
+    
+    renderer->getTransforms().setLocalBatch(nodeData, trsData, count);
+    
+    env->ReleaseIntArrayElements(nodes, nodeData, JNI_ABORT);
+    env->ReleaseFloatArrayElements(trs, trsData, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeUpdateTransforms(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->updateTransforms();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeGetWorldMatrix(
+    JNIEnv* env, jobject obj, jlong handle, jint node, jfloatArray out) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    float matrix[16];
+    if (!renderer->getTransforms().getWorldMatrix(node, matrix)) {
+        return JNI_FALSE;
+    }
+    
+    env->SetFloatArrayRegion(out, 0, 16, matrix);
+    return JNI_TRUE;
+}
+
 // ========== Resources ==========
 
 JNIEXPORT jlong JNICALL
@@ -222,6 +443,51 @@ Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeCreateGraphicsPipel
     return static_cast<jlong>(pipelineHandle);
 }
 
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeSetFallbackPipeline(
+    JNIEnv* env, jobject obj, jlong handle, jint vertexLayout, jlong pipeline) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->setFallbackPipeline(vertexLayout, pipeline);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeGetPipelineState(
+    JNIEnv* env, jobject obj, jlong handle, jlong pipeline) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    return static_cast<jint>(renderer->getPipelineState(pipeline));
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativePollPipelineEvents(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    
+    // Se copian directamente desde el buffer del renderer, que conserva su capacidad
+    const std::vector<uint64_t>& events = renderer->getPipelineEvents();
+    
+    // Sin eventos no se reserva nada en el heap de Java
+    if (events.empty()) {
+        return nullptr;
+    }
+    
+    jlongArray result = env->NewLongArray(static_cast<jsize>(events.size()));
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(events.size()),
+                            reinterpret_cast<const jlong*>(events.data()));
+    renderer->clearPipelineEvents();
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_com_quantum_engine_renderer_vulkan_VulkanRenderer_nativeWaitForPipelines(
+    JNIEnv* env, jobject obj, jlong handle) {
+    
+    auto* renderer = reinterpret_cast<VulkanRendererNative*>(handle);
+    renderer->waitForPipelineCompiler();
+}
+
 // ========== Compute ==========
 
 JNIEXPORT void JNICALL
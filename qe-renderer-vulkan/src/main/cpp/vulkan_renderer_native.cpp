@@ -31,6 +31,28 @@ VulkanRendererNative::VulkanRendererNative()
     , currentFrame(0)
     , imageIndex(0)
     , nextResourceId(1)
+    , shadingPath(ShadingPath::Forward)
+    , gbufferSetLayout(VK_NULL_HANDLE)
+    , gbufferDescriptorSet(VK_NULL_HANDLE)
+    , lightingPipeline(0)
+    , lightingSubpassDraws(0)
+    , warnedUnlitDeferredFrame(false)
+    , frameRecording(false)
+    , renderTargetGeneration(0)
+    , sceneObjectCount(0)
+    , sceneCapacity(0)
+    , sceneBuffer(VK_NULL_HANDLE)
+    , sceneMemory(VK_NULL_HANDLE)
+    , sceneStagingBuffer(VK_NULL_HANDLE)
+    , sceneStagingMemory(VK_NULL_HANDLE)
+    , sceneStagingMapped(nullptr)
+    , sceneSetLayout(VK_NULL_HANDLE)
+    , sceneDescriptorSet(VK_NULL_HANDLE)
+    , pendingPipelineCount(0)
+    , stopPipelineWorkers(false)
+    , pipelineCache(VK_NULL_HANDLE)
+    , fallbackPipelines{}
+    , frameArena(FRAME_ARENA_CAPACITY)
 {
     clearColor = {{0.1f, 0.1f, 0.15f, 1.0f}};
     swapchainExtent = {0, 0};
@@ -74,6 +96,11 @@ bool VulkanRendererNative::initialize() {
         return false;
     }
     
+    if (!createSceneBuffer(SCENE_INITIAL_CAPACITY)) {
+        LOGE("Failed to create scene buffer");
+        return false;
+    }
+    
     LOGI("Vulkan Renderer initialized successfully");
     return true;
 }
@@ -81,6 +108,7 @@ bool VulkanRendererNative::initialize() {
 void VulkanRendererNative::shutdown() {
     if (device != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(device);
+        stopPipelineCompiler();
         
         // Cleanup resources
         meshes.clear();
@@ -102,8 +130,20 @@ void VulkanRendererNative::shutdown() {
             imageAvailableSemaphore = VK_NULL_HANDLE;
         }
         
+        clearStaticChunks();
         destroySwapchain();
         
+        if (gbufferSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, gbufferSetLayout, nullptr);
+            gbufferSetLayout = VK_NULL_HANDLE;
+        }
+        
+        destroySceneBuffer();
+        if (sceneSetLayout != VK_NULL_HANDLE) {
+            vkDestroyDescriptorSetLayout(device, sceneSetLayout, nullptr);
+            sceneSetLayout = VK_NULL_HANDLE;
+        }
+        
         if (descriptorPool != VK_NULL_HANDLE) {
             vkDestroyDescriptorPool(device, descriptorPool, nullptr);
             descriptorPool = VK_NULL_HANDLE;
@@ -173,11 +213,13 @@ bool VulkanRendererNative::pickPhysicalDevice() {
         return false;
     }
     
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
+    ScratchScope scratch;
+    VkPhysicalDevice* devices = scratch.allocateArray<VkPhysicalDevice>(deviceCount);
+    vkEnumeratePhysicalDevices(instance, &deviceCount, devices);
     
     // Pick first suitable device
-    for (const auto& dev : devices) {
+    for (uint32_t i = 0; i < deviceCount; i++) {
+        VkPhysicalDevice dev = devices[i];
         vkGetPhysicalDeviceProperties(dev, &deviceProperties);
         vkGetPhysicalDeviceFeatures(dev, &deviceFeatures);
         
@@ -196,8 +238,9 @@ bool VulkanRendererNative::createLogicalDevice() {
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
     
-    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
-    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    ScratchScope scratch;
+    VkQueueFamilyProperties* queueFamilies = scratch.allocateArray<VkQueueFamilyProperties>(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies);
     
     for (uint32_t i = 0; i < queueFamilyCount; i++) {
         if (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
@@ -220,7 +263,6 @@ bool VulkanRendererNative::createLogicalDevice() {
     if (computeQueueFamily == UINT32_MAX) computeQueueFamily = graphicsQueueFamily;
     if (transferQueueFamily == UINT32_MAX) transferQueueFamily = graphicsQueueFamily;
     
-    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     float queuePriority = 1.0f;
     
     VkDeviceQueueCreateInfo queueCreateInfo{};
@@ -228,9 +270,8 @@ bool VulkanRendererNative::createLogicalDevice() {
     queueCreateInfo.queueFamilyIndex = graphicsQueueFamily;
     queueCreateInfo.queueCount = 1;
     queueCreateInfo.pQueuePriorities = &queuePriority;
-    queueCreateInfos.push_back(queueCreateInfo);
     
-    std::vector<const char*> deviceExtensions = {
+    const char* deviceExtensions[] = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
     };
     
@@ -238,11 +279,11 @@ bool VulkanRendererNative::createLogicalDevice() {
     
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
-    createInfo.pQueueCreateInfos = queueCreateInfos.data();
+    createInfo.queueCreateInfoCount = 1;
+    createInfo.pQueueCreateInfos = &queueCreateInfo;
     createInfo.pEnabledFeatures = &enabledFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(sizeof(deviceExtensions) / sizeof(deviceExtensions[0]));
+    createInfo.ppEnabledExtensionNames = deviceExtensions;
     
     if (vkCreateDevice(physicalDevice, &createInfo, nullptr, &device) != VK_SUCCESS) {
         LOGE("Failed to create logical device");
@@ -294,7 +335,9 @@ bool VulkanRendererNative::createSyncObjects() {
 bool VulkanRendererNative::createDescriptorPool() {
     std::vector<VkDescriptorPoolSize> poolSizes = {
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 100},
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100}
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 100},
+        {VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 4},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4}
     };
     
     VkDescriptorPoolCreateInfo poolInfo{};
@@ -378,6 +421,10 @@ bool VulkanRendererNative::createSwapchain() {
 }
 
 bool VulkanRendererNative::createRenderPass() {
+    if (shadingPath == ShadingPath::Deferred) {
+        return createDeferredRenderPass();
+    }
+    
     VkAttachmentDescription colorAttachment{};
     colorAttachment.format = swapchainFormat;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -408,15 +455,29 @@ bool VulkanRendererNative::createRenderPass() {
 }
 
 bool VulkanRendererNative::createFramebuffers() {
+    // Cambia el render target: los secondary buffers estáticos deben regrabarse
+    renderTargetGeneration++;
+    
+    bool deferred = shadingPath == ShadingPath::Deferred;
+    if (deferred && !createGBuffer()) {
+        return false;
+    }
+    
     framebuffers.resize(swapchainImageViews.size());
     
     for (size_t i = 0; i < swapchainImageViews.size(); i++) {
-        VkImageView attachments[] = {swapchainImageViews[i]};
+        // El G-buffer es compartido: sólo hay un frame en vuelo
+        VkImageView attachments[] = {
+            swapchainImageViews[i],
+            gbufferAlbedo.view,
+            gbufferNormal.view,
+            depthAttachment.view
+        };
         
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = renderPass;
-        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.attachmentCount = deferred ? 4 : 1;
         framebufferInfo.pAttachments = attachments;
         framebufferInfo.width = swapchainExtent.width;
         framebufferInfo.height = swapchainExtent.height;
@@ -431,6 +492,14 @@ bool VulkanRendererNative::createFramebuffers() {
 }
 
 bool VulkanRendererNative::createCommandBuffers() {
+    // Al recrear el swapchain: los primarios anteriores vuelven al pool
+    if (!commandBuffers.empty()) {
+        vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()),
+                             commandBuffers.data());
+        commandBuffers.clear();
+    }
+    if (framebuffers.empty()) return false;
+    
     commandBuffers.resize(framebuffers.size());
     
     VkCommandBufferAllocateInfo allocInfo{};
@@ -439,7 +508,11 @@ bool VulkanRendererNative::createCommandBuffers() {
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
     
-    return vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) == VK_SUCCESS;
+    if (vkAllocateCommandBuffers(device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+        commandBuffers.clear();
+        return false;
+    }
+    return true;
 }
 
 void VulkanRendererNative::destroySwapchain() {
@@ -448,6 +521,8 @@ void VulkanRendererNative::destroySwapchain() {
     }
     framebuffers.clear();
     
+    destroyGBuffer();
+    
     for (auto imageView : swapchainImageViews) {
         vkDestroyImageView(device, imageView, nullptr);
     }
@@ -465,13 +540,119 @@ void VulkanRendererNative::destroySwapchain() {
 }
 
 void VulkanRendererNative::beginFrame() {
+    frameRecording = false;
+    if (swapchain == VK_NULL_HANDLE || commandBuffers.empty() || inFlightFence == VK_NULL_HANDLE) return;
+    
     vkWaitForFences(device, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+    
+    // El frame anterior se ha retirado: su memoria temporal se puede reutilizar
+    frameArena.beginFrame();
+    freeRetiredStaticChunks();
+    updateFrameAllocationStats();
+    
+    VkResult result = vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailableSemaphore,
+                                            VK_NULL_HANDLE, &imageIndex);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        recreateSwapchain();
+        return;
+    }
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        LOGE("Failed to acquire swapchain image: %d", result);
+        return;
+    }
+    
+    // La fence solo se resetea si este frame se va a enviar
     vkResetFences(device, 1, &inFlightFence);
     
-    vkAcquireNextImageKHR(device, swapchain, UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    // Instalar los pipelines que terminaron de compilar
+    processCompletedPipelines();
+    
+    VkCommandBuffer cmd = commandBuffers[imageIndex];
+    vkResetCommandBuffer(cmd, 0);
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmd, &beginInfo);
+    
+    // Las copias al scene buffer van fuera del render pass, antes de los draws que lo leen
+    recordSceneUpload(cmd);
+    
+    // Swapchain + G-buffer + depth en deferred, solo swapchain en forward
+    VkClearValue clearValues[4]{};
+    clearValues[0].color = clearColor;
+    clearValues[3].depthStencil = {1.0f, 0};
+    
+    VkRenderPassBeginInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = renderPass;
+    renderPassInfo.framebuffer = framebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = swapchainExtent;
+    renderPassInfo.clearValueCount = shadingPath == ShadingPath::Deferred ? 4 : 1;
+    renderPassInfo.pClearValues = clearValues;
+    
+    // El subpass de geometría se compone de los secondary buffers de los chunks estáticos
+    vkCmdBeginRenderPass(cmd, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    executeStaticChunks(cmd);
+    frameRecording = true;
+}
+
+void VulkanRendererNative::updateFrameAllocationStats() {
+    const AllocatorStats& arenaStats = frameArena.getLastFrameStats();
+    
+    frameAllocationStats.arenaAllocations = arenaStats.allocations;
+    frameAllocationStats.arenaBytes = arenaStats.bytes;
+    frameAllocationStats.arenaPeakBytes = arenaStats.peakBytes;
+    frameAllocationStats.arenaCapacity = frameArena.getCapacity();
+    frameAllocationStats.heapAllocations = arenaStats.heapAllocations + ScratchStack::takeHeapAllocations();
 }
 
 void VulkanRendererNative::endFrame() {
+    if (!frameRecording) return;
+    frameRecording = false;
+    
+    VkCommandBuffer cmd = commandBuffers[imageIndex];
+    
+    if (shadingPath == ShadingPath::Deferred) {
+        vkCmdNextSubpass(cmd, VK_SUBPASS_CONTENTS_INLINE);
+        bool lit = recordLightingSubpass(cmd);
+        
+        // Smoke check: sin el draw de iluminación el swapchain solo tiene el clear
+        if (lit) {
+            lightingSubpassDraws++;
+        } else if (!warnedUnlitDeferredFrame) {
+            LOGW("Deferred frame presented without lighting pass (pipeline %llu not ready)",
+                 static_cast<unsigned long long>(lightingPipeline));
+            warnedUnlitDeferredFrame = true;
+        }
+    }
+    
+    vkCmdEndRenderPass(cmd);
+    if (vkEndCommandBuffer(cmd) != VK_SUCCESS) {
+        LOGE("Failed to record frame command buffer");
+        abandonFrame();
+        return;
+    }
+    
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &imageAvailableSemaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &renderFinishedSemaphore;
+    
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFence) != VK_SUCCESS) {
+        LOGE("Failed to submit frame command buffer");
+        abandonFrame();
+        return;
+    }
+    
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     presentInfo.waitSemaphoreCount = 1;
@@ -480,7 +661,39 @@ void VulkanRendererNative::endFrame() {
     presentInfo.pSwapchains = &swapchain;
     presentInfo.pImageIndices = &imageIndex;
     
-    vkQueuePresentKHR(graphicsQueue, &presentInfo);
+    VkResult result = vkQueuePresentKHR(graphicsQueue, &presentInfo);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        recreateSwapchain();
+    }
+}
+
+void VulkanRendererNative::abandonFrame() {
+    // beginFrame() ya reseteó la fence: sin señalarla el próximo frame se
+    // queda esperando para siempre. Un submit vacío la señala y consume el
+    // semáforo del acquire
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &imageAvailableSemaphore;
+    submitInfo.pWaitDstStageMask = &waitStage;
+    
+    if (vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFence) == VK_SUCCESS) {
+        return;
+    }
+    
+    // La cola tampoco acepta el submit vacío: fence nueva ya señalada
+    LOGE("Failed to signal frame fence, recreating it");
+    vkDestroyFence(device, inFlightFence, nullptr);
+    
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    if (vkCreateFence(device, &fenceInfo, nullptr, &inFlightFence) != VK_SUCCESS) {
+        inFlightFence = VK_NULL_HANDLE;
+        LOGE("Failed to recreate frame fence");
+    }
 }
 
 // Stubs for remaining functions
@@ -511,7 +724,7 @@ uint64_t VulkanRendererNative::compileShader(const uint8_t* spirvCode, int codeS
 
 uint64_t VulkanRendererNative::createGraphicsPipeline(uint64_t vertexShader, uint64_t fragmentShader,
                                                        const int* config) {
-    return nextResourceId++;
+    return requestPipeline(vertexShader, fragmentShader, config);
 }
 
 void VulkanRendererNative::dispatchCompute(uint64_t computeShader, int groupsX, int groupsY, int groupsZ) {}
@@ -624,10 +837,12 @@ void VulkanRendererNative::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, Vk
 }
 
 void VulkanRendererNative::recreateSwapchain() {
+    drainPipelineCompiler();
     vkDeviceWaitIdle(device);
     destroySwapchain();
     createSwapchain();
     createRenderPass();
+    rebuildPipelines();
     createFramebuffers();
     createCommandBuffers();
 }
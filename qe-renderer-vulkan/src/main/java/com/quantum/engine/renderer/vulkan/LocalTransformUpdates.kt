@@ -0,0 +1,51 @@
+package com.quantum.engine.renderer.vulkan
+
+import com.quantum.engine.math.Quaternion
+import com.quantum.engine.math.Vector3
+
+/**
+ * LocalTransformUpdates - Transforms locales modificados este frame
+ *
+ * Se acumulan como posición/rotación/escala planos (10 floats por nodo) y se
+ * envían a la jerarquía nativa con VulkanRenderer.pushLocalTransforms().
+ * Nativo calcula las matrices world en SoA con SIMD y las escribe directamente
+ * en el scene buffer, sin pasar por TransformComponent.updateMatrix().
+ */
+class LocalTransformUpdates(initialCapacity: Int = 256) {
+
+    internal var nodes = IntArray(initialCapacity)
+    internal var trs = FloatArray(initialCapacity * FLOATS_PER_NODE)
+    internal var count = 0
+
+    val isEmpty: Boolean
+        get() = count == 0
+
+    fun set(node: Int, position: Vector3, rotation: Quaternion, scale: Vector3) {
+        if (count == nodes.size) {
+            nodes = nodes.copyOf(nodes.size * 2)
+            trs = trs.copyOf(trs.size * 2)
+        }
+
+        val base = count * FLOATS_PER_NODE
+        nodes[count] = node
+        trs[base] = position.x
+        trs[base + 1] = position.y
+        trs[base + 2] = position.z
+        trs[base + 3] = rotation.x
+        trs[base + 4] = rotation.y
+        trs[base + 5] = rotation.z
+        trs[base + 6] = rotation.w
+        trs[base + 7] = scale.x
+        trs[base + 8] = scale.y
+        trs[base + 9] = scale.z
+        count++
+    }
+
+    fun clear() {
+        count = 0
+    }
+
+    companion object {
+        const val FLOATS_PER_NODE = 10
+    }
+}
@@ -0,0 +1,89 @@
+package com.quantum.engine.renderer.vulkan
+
+import com.quantum.engine.core.components.Color
+import com.quantum.engine.math.Matrix4
+
+/**
+ * SceneBufferUpdates - Cambios pendientes para el scene buffer nativo
+ *
+ * Acumula sólo los objetos que cambiaron este frame (transform, material,
+ * visibilidad) en arrays planos reutilizables, y se envían a nativo con una
+ * llamada JNI por tipo de cambio en VulkanRenderer.pushSceneUpdates().
+ * Los objetos estáticos no cuestan nada después de su primera subida.
+ */
+class SceneBufferUpdates(initialCapacity: Int = 256) {
+
+    // Transforms: slot + matriz column-major
+    internal var transformSlots = IntArray(initialCapacity)
+    internal var transformData = FloatArray(initialCapacity * 16)
+    internal var transformCount = 0
+
+    // Materiales: slot + color RGBA + id de material
+    internal var materialSlots = IntArray(initialCapacity)
+    internal var materialColors = FloatArray(initialCapacity * 4)
+    internal var materialIds = IntArray(initialCapacity)
+    internal var materialCount = 0
+
+    // Visibilidad: slot + flags
+    internal var visibilitySlots = IntArray(initialCapacity)
+    internal var visibilityFlags = IntArray(initialCapacity)
+    internal var visibilityCount = 0
+
+    val isEmpty: Boolean
+        get() = transformCount == 0 && materialCount == 0 && visibilityCount == 0
+
+    fun setTransform(slot: Int, matrix: Matrix4) {
+        if (transformCount == transformSlots.size) {
+            transformSlots = transformSlots.copyOf(transformSlots.size * 2)
+            transformData = transformData.copyOf(transformData.size * 2)
+        }
+
+        // Copia directa, sin el FloatArray temporal de toArray()
+        var index = transformCount * 16
+        for (column in 0..3) {
+            for (row in 0..3) {
+                transformData[index++] = matrix[column, row]
+            }
+        }
+        transformSlots[transformCount] = slot
+        transformCount++
+    }
+
+    fun setMaterial(slot: Int, color: Color, materialId: Int = 0) {
+        if (materialCount == materialSlots.size) {
+            materialSlots = materialSlots.copyOf(materialSlots.size * 2)
+            materialColors = materialColors.copyOf(materialColors.size * 2)
+            materialIds = materialIds.copyOf(materialIds.size * 2)
+        }
+
+        val base = materialCount * 4
+        materialSlots[materialCount] = slot
+        materialColors[base] = color.r
+        materialColors[base + 1] = color.g
+        materialColors[base + 2] = color.b
+        materialColors[base + 3] = color.a
+        materialIds[materialCount] = materialId
+        materialCount++
+    }
+
+    fun setVisible(slot: Int, visible: Boolean) {
+        if (visibilityCount == visibilitySlots.size) {
+            visibilitySlots = visibilitySlots.copyOf(visibilitySlots.size * 2)
+            visibilityFlags = visibilityFlags.copyOf(visibilityFlags.size * 2)
+        }
+
+        visibilitySlots[visibilityCount] = slot
+        visibilityFlags[visibilityCount] = if (visible) SCENE_OBJECT_VISIBLE else 0
+        visibilityCount++
+    }
+
+    fun clear() {
+        transformCount = 0
+        materialCount = 0
+        visibilityCount = 0
+    }
+
+    companion object {
+        const val SCENE_OBJECT_VISIBLE = 1
+    }
+}
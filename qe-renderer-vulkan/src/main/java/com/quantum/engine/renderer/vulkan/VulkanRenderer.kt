@@ -4,6 +4,7 @@ import android.view.Surface
 import com.quantum.engine.renderer.*
 import com.quantum.engine.math.*
 import com.quantum.engine.core.components.Color
+import com.quantum.engine.streaming.ChunkCoord
 import timber.log.Timber
 
 /**
@@ -29,6 +30,44 @@ class VulkanRenderer : Renderer {
     private var swapchainExtent = Pair(0, 0)
     private var currentFrame = 0
     
+    /**
+     * Ruta de sombreado activa
+     */
+    var shadingPath = ShadingPath.FORWARD
+        private set
+    
+    /**
+     * Callback cuando un pipeline termina de compilar (READY o FAILED)
+     * Se invoca en el hilo de render desde beginFrame()
+     */
+    var onPipelineCompiled: ((pipeline: Long, state: PipelineState) -> Unit)? = null
+    
+    // Buffers reutilizados para pasar datos por draw sin reservar arrays
+    private val transformScratch = FloatArray(16)
+    private val viewScratch = FloatArray(16)
+    private val projectionScratch = FloatArray(16)
+    private val colorScratch = FloatArray(4)
+    private val allocationScratch = LongArray(5)
+    
+    /**
+     * Memoria nativa del último frame completo
+     * 
+     * heapAllocations debe ser 0 en régimen estable: los buffers temporales
+     * del frame salen de una arena que se resetea al retirarlo.
+     */
+    val frameAllocationStats = FrameAllocationStats()
+        get() {
+            if (isInitialized) {
+                nativeGetFrameAllocationStats(nativeHandle, allocationScratch)
+                field.arenaAllocations = allocationScratch[0].toInt()
+                field.heapAllocations = allocationScratch[1].toInt()
+                field.arenaBytes = allocationScratch[2]
+                field.arenaPeakBytes = allocationScratch[3]
+                field.arenaCapacity = allocationScratch[4]
+            }
+            return field
+        }
+    
     companion object {
         init {
             System.loadLibrary("vulkan_renderer")
@@ -79,6 +118,8 @@ class VulkanRenderer : Renderer {
         
         nativeBeginFrame(nativeHandle)
         stats.reset()
+        
+        dispatchPipelineEvents()
     }
     
     override fun endFrame() {
@@ -91,20 +132,12 @@ class VulkanRenderer : Renderer {
     override fun submit(command: RenderCommand) {
         if (!isInitialized) return
         
-        // Convertir a formato nativo
-        val transform = command.transform.toArray()
-        val color = floatArrayOf(
-            command.material.color.r,
-            command.material.color.g,
-            command.material.color.b,
-            command.material.color.a
-        )
-        
+        // Convertir a formato nativo (JNI copia los arrays en la llamada)
         nativeSubmitMesh(
             nativeHandle,
             getMeshHandle(command.mesh),
-            transform,
-            color
+            command.transform.toArray(transformScratch),
+            colorToArray(command.material.color)
         )
         
         stats.drawCalls++
@@ -117,8 +150,8 @@ class VulkanRenderer : Renderer {
         
         nativeSetViewProjection(
             nativeHandle,
-            view.toArray(),
-            projection.toArray()
+            view.toArray(viewScratch),
+            projection.toArray(projectionScratch)
         )
     }
     
@@ -140,6 +173,202 @@ class VulkanRenderer : Renderer {
         nativeSetViewport(nativeHandle, x, y, width, height)
     }
     
+    /**
+     * Indica si el dispositivo soporta el path deferred por subpasses
+     */
+    fun supportsDeferredShading(): Boolean {
+        if (!isInitialized) return false
+        
+        return nativeSupportsDeferredShading(nativeHandle)
+    }
+    
+    /**
+     * Selecciona forward o deferred shading
+     * 
+     * El path deferred usa un render pass de dos subpasses con el G-buffer
+     * transient leído como input attachments, así en GPUs tiler nunca sale
+     * de la memoria on-chip. Conviene para escenas con muchas luces solapadas.
+     * Retorna false si el dispositivo no lo soporta (se mantiene forward).
+     */
+    fun setShadingPath(path: ShadingPath): Boolean {
+        if (!isInitialized) return false
+        
+        val applied = nativeSetShadingPath(nativeHandle, path.ordinal)
+        if (applied) {
+            shadingPath = path
+        }
+        return applied
+    }
+    
+    /**
+     * Pipeline de iluminación del subpass 1 (triángulo a pantalla completa)
+     */
+    fun setLightingPipeline(pipeline: Long) {
+        if (!isInitialized) return
+        
+        nativeSetLightingPipeline(nativeHandle, pipeline)
+    }
+    
+    /**
+     * Graba el contenido estático de un chunk (terreno, edificios)
+     * 
+     * Los draws se graban una vez en un secondary command buffer y se reutilizan
+     * cada frame. Sólo se regraban si se vuelve a llamar con el mismo chunkId,
+     * si cambia alguno de sus pipelines o si cambia el render target.
+     */
+    fun buildStaticChunk(chunkId: Long, commands: List<RenderCommand>, pipeline: Long) {
+        if (!isInitialized) return
+        
+        nativeBeginStaticChunk(nativeHandle, chunkId)
+        
+        for (command in commands) {
+            nativeSubmitStaticMesh(
+                nativeHandle,
+                chunkId,
+                getMeshHandle(command.mesh),
+                pipeline,
+                command.transform.toArray(transformScratch),
+                colorToArray(command.material.color)
+            )
+        }
+    }
+    
+    fun buildStaticChunk(coord: ChunkCoord, commands: List<RenderCommand>, pipeline: Long) {
+        buildStaticChunk(staticChunkId(coord), commands, pipeline)
+    }
+    
+    /**
+     * Libera el contenido estático de un chunk (p.ej. al descargarlo)
+     */
+    fun removeStaticChunk(chunkId: Long) {
+        if (!isInitialized) return
+        
+        nativeRemoveStaticChunk(nativeHandle, chunkId)
+    }
+    
+    fun removeStaticChunk(coord: ChunkCoord) {
+        removeStaticChunk(staticChunkId(coord))
+    }
+    
+    /**
+     * Fuerza a regrabar todos los chunks estáticos en el próximo frame
+     */
+    fun invalidateStaticChunks() {
+        if (!isInitialized) return
+        
+        nativeInvalidateStaticChunks(nativeHandle)
+    }
+    
+    private fun staticChunkId(coord: ChunkCoord): Long {
+        return (coord.x.toLong() shl 32) or (coord.z.toLong() and 0xFFFFFFFFL)
+    }
+    
+    /**
+     * Reserva un slot estable en el scene buffer nativo (-1 si falla)
+     */
+    fun allocateSceneObject(): Int {
+        if (!isInitialized) return -1
+        
+        return nativeAllocateSceneObject(nativeHandle)
+    }
+    
+    fun releaseSceneObject(slot: Int) {
+        if (!isInitialized) return
+        
+        nativeReleaseSceneObject(nativeHandle, slot)
+    }
+    
+    /**
+     * Envía sólo los cambios acumulados y vacía el acumulador
+     * 
+     * Nativo agrupa los slots modificados en regiones de copia contiguas
+     * que se suben al inicio del siguiente frame.
+     */
+    fun pushSceneUpdates(updates: SceneBufferUpdates) {
+        if (!isInitialized || updates.isEmpty) return
+        
+        if (updates.transformCount > 0) {
+            nativeUpdateSceneTransforms(
+                nativeHandle,
+                updates.transformSlots,
+                updates.transformData,
+                updates.transformCount
+            )
+        }
+        
+        if (updates.materialCount > 0) {
+            nativeUpdateSceneMaterials(
+                nativeHandle,
+                updates.materialSlots,
+                updates.materialColors,
+                updates.materialIds,
+                updates.materialCount
+            )
+        }
+        
+        if (updates.visibilityCount > 0) {
+            nativeUpdateSceneVisibility(
+                nativeHandle,
+                updates.visibilitySlots,
+                updates.visibilityFlags,
+                updates.visibilityCount
+            )
+        }
+        
+        updates.clear()
+    }
+    
+    /**
+     * Crea un nodo en la jerarquía de transforms nativa
+     * 
+     * Si sceneSlot >= 0 su matriz world se escribe en ese slot del scene buffer.
+     */
+    fun createTransformNode(parent: Int = -1, sceneSlot: Int = -1): Int {
+        if (!isInitialized) return -1
+        
+        return nativeCreateTransformNode(nativeHandle, parent, sceneSlot)
+    }
+    
+    fun destroyTransformNode(node: Int) {
+        if (!isInitialized) return
+        
+        nativeDestroyTransformNode(nativeHandle, node)
+    }
+    
+    /**
+     * Cambia el padre de un nodo; nativo reordena para que los padres precedan a los hijos
+     */
+    fun setTransformParent(node: Int, parent: Int) {
+        if (!isInitialized) return
+        
+        nativeSetTransformParent(nativeHandle, node, parent)
+    }
+    
+    fun pushLocalTransforms(updates: LocalTransformUpdates) {
+        if (!isInitialized || updates.isEmpty) return
+        
+        nativeSetLocalTransforms(nativeHandle, updates.nodes, updates.trs, updates.count)
+        updates.clear()
+    }
+    
+    /**
+     * Propaga las matrices world (una pasada lineal SIMD) y marca sus slots dirty
+     */
+    fun updateTransforms() {
+        if (!isInitialized) return
+        
+        nativeUpdateTransforms(nativeHandle)
+    }
+    
+    /**
+     * Copia la matriz world de un nodo (column-major) en out
+     */
+    fun getWorldMatrix(node: Int, out: FloatArray): Boolean {
+        if (!isInitialized) return false
+        
+        return nativeGetWorldMatrix(nativeHandle, node, out)
+    }
+    
     /**
      * Carga un mesh en Vulkan
      */
@@ -175,6 +404,9 @@ class VulkanRenderer : Renderer {
     
     /**
      * Crea un pipeline gráfico
+     * 
+     * Retorna el handle al instante; la compilación ocurre en workers nativos.
+     * Hasta que esté listo se dibuja con el fallback de su vertex layout.
      */
     fun createGraphicsPipeline(
         vertexShader: Long,
@@ -191,6 +423,49 @@ class VulkanRenderer : Renderer {
         )
     }
     
+    /**
+     * Pipeline usado mientras compilan los pipelines del mismo vertex layout
+     * 
+     * Conviene crearlo al cargar y esperar con waitForPipelines() antes de jugar.
+     */
+    fun setFallbackPipeline(layout: VertexLayout, pipeline: Long) {
+        if (!isInitialized) return
+        
+        nativeSetFallbackPipeline(nativeHandle, layout.ordinal, pipeline)
+    }
+    
+    fun getPipelineState(pipeline: Long): PipelineState {
+        if (!isInitialized) return PipelineState.FAILED
+        
+        return PipelineState.values()[nativeGetPipelineState(nativeHandle, pipeline)]
+    }
+    
+    fun isPipelineReady(pipeline: Long): Boolean {
+        return getPipelineState(pipeline) == PipelineState.READY
+    }
+    
+    /**
+     * Bloquea hasta que terminen las compilaciones en curso (pantallas de carga)
+     */
+    fun waitForPipelines() {
+        if (!isInitialized) return
+        
+        nativeWaitForPipelines(nativeHandle)
+        dispatchPipelineEvents()
+    }
+    
+    private fun dispatchPipelineEvents() {
+        val events = nativePollPipelineEvents(nativeHandle) ?: return
+        
+        for (pipeline in events) {
+            val state = getPipelineState(pipeline)
+            if (state == PipelineState.FAILED) {
+                Timber.e("Pipeline $pipeline failed to compile")
+            }
+            onPipelineCompiled?.invoke(pipeline, state)
+        }
+    }
+    
     /**
      * Activa compute shader
      */
@@ -251,6 +526,14 @@ class VulkanRenderer : Renderer {
         Timber.i("Mesh Shaders: ${info.supportsMeshShaders}")
     }
     
+    private fun colorToArray(color: Color): FloatArray {
+        colorScratch[0] = color.r
+        colorScratch[1] = color.g
+        colorScratch[2] = color.b
+        colorScratch[3] = color.a
+        return colorScratch
+    }
+    
     private val meshHandles = mutableMapOf<Mesh, Long>()
     
     private fun getMeshHandle(mesh: Mesh): Long {
@@ -269,6 +552,7 @@ class VulkanRenderer : Renderer {
     
     private external fun nativeBeginFrame(handle: Long)
     private external fun nativeEndFrame(handle: Long)
+    private external fun nativeGetFrameAllocationStats(handle: Long, out: LongArray)
     
     private external fun nativeSubmitMesh(
         handle: Long,
@@ -299,6 +583,63 @@ class VulkanRenderer : Renderer {
         height: Int
     )
     
+    private external fun nativeSupportsDeferredShading(handle: Long): Boolean
+    private external fun nativeSetShadingPath(handle: Long, path: Int): Boolean
+    private external fun nativeSetLightingPipeline(handle: Long, pipeline: Long)
+    
+    private external fun nativeBeginStaticChunk(handle: Long, chunkId: Long)
+    
+    private external fun nativeSubmitStaticMesh(
+        handle: Long,
+        chunkId: Long,
+        meshHandle: Long,
+        pipeline: Long,
+        transform: FloatArray,
+        color: FloatArray
+    )
+    
+    private external fun nativeRemoveStaticChunk(handle: Long, chunkId: Long)
+    private external fun nativeInvalidateStaticChunks(handle: Long)
+    
+    private external fun nativeAllocateSceneObject(handle: Long): Int
+    private external fun nativeReleaseSceneObject(handle: Long, slot: Int)
+    
+    private external fun nativeUpdateSceneTransforms(
+        handle: Long,
+        slots: IntArray,
+        matrices: FloatArray,
+        count: Int
+    )
+    
+    private external fun nativeUpdateSceneMaterials(
+        handle: Long,
+        slots: IntArray,
+        colors: FloatArray,
+        materialIds: IntArray,
+        count: Int
+    )
+    
+    private external fun nativeUpdateSceneVisibility(
+        handle: Long,
+        slots: IntArray,
+        flags: IntArray,
+        count: Int
+    )
+    
+    private external fun nativeCreateTransformNode(handle: Long, parent: Int, sceneSlot: Int): Int
+    private external fun nativeDestroyTransformNode(handle: Long, node: Int)
+    private external fun nativeSetTransformParent(handle: Long, node: Int, parent: Int)
+    
+    private external fun nativeSetLocalTransforms(
+        handle: Long,
+        nodes: IntArray,
+        trs: FloatArray,
+        count: Int
+    )
+    
+    private external fun nativeUpdateTransforms(handle: Long)
+    private external fun nativeGetWorldMatrix(handle: Long, node: Int, out: FloatArray): Boolean
+    
     private external fun nativeLoadMesh(
         handle: Long,
         vertices: FloatArray,
@@ -328,6 +669,11 @@ class VulkanRenderer : Renderer {
         config: IntArray
     ): Long
     
+    private external fun nativeSetFallbackPipeline(handle: Long, vertexLayout: Int, pipeline: Long)
+    private external fun nativeGetPipelineState(handle: Long, pipeline: Long): Int
+    private external fun nativePollPipelineEvents(handle: Long): LongArray?
+    private external fun nativeWaitForPipelines(handle: Long)
+    
     private external fun nativeDispatchCompute(
         handle: Long,
         computeShader: Long,
@@ -359,7 +705,9 @@ data class PipelineConfig(
     val frontFace: FrontFace = FrontFace.COUNTER_CLOCKWISE,
     val depthTest: Boolean = true,
     val depthWrite: Boolean = true,
-    val blendEnable: Boolean = false
+    val blendEnable: Boolean = false,
+    val subpass: Int = 0, // 0 = geometría, 1 = iluminación (deferred)
+    val vertexLayout: VertexLayout = VertexLayout.POSITION_NORMAL_UV
 ) {
     fun toNative(): IntArray {
         return intArrayOf(
@@ -368,7 +716,9 @@ data class PipelineConfig(
             frontFace.ordinal,
             if (depthTest) 1 else 0,
             if (depthWrite) 1 else 0,
-            if (blendEnable) 1 else 0
+            if (blendEnable) 1 else 0,
+            subpass,
+            vertexLayout.ordinal
         )
     }
 }
@@ -393,6 +743,23 @@ enum class FrontFace {
     CLOCKWISE
 }
 
+enum class VertexLayout {
+    POSITION,
+    POSITION_NORMAL,
+    POSITION_NORMAL_UV
+}
+
+enum class PipelineState {
+    PENDING,
+    READY,
+    FAILED
+}
+
+enum class ShadingPath {
+    FORWARD,
+    DEFERRED
+}
+
 enum class ShaderStage {
     VERTEX,
     FRAGMENT,
@@ -416,6 +783,17 @@ data class VulkanInfo(
     val supportsMeshShaders: Boolean = false
 )
 
+/**
+ * Contadores de memoria nativa de un frame
+ */
+data class FrameAllocationStats(
+    var arenaAllocations: Int = 0,
+    var heapAllocations: Int = 0,
+    var arenaBytes: Long = 0,
+    var arenaPeakBytes: Long = 0,
+    var arenaCapacity: Long = 0
+)
+
 /**
  * VulkanSurface - Wrapper para Surface de Android
  */
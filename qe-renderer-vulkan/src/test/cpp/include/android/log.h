@@ -0,0 +1,20 @@
+#ifndef QE_VULKAN_TEST_ANDROID_LOG_H
+#define QE_VULKAN_TEST_ANDROID_LOG_H
+
+/**
+ * Sustituto de <android/log.h> para los tests en el host: la jerarquía sólo
+ * avisa de padres rechazados
+ */
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6
+};
+
+inline int __android_log_print(int, const char*, const char*, ...) {
+    return 0;
+}
+
+#endif // QE_VULKAN_TEST_ANDROID_LOG_H
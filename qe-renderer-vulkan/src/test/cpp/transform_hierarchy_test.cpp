@@ -0,0 +1,245 @@
+// transform_hierarchy_test.cpp - Matrices world de TransformHierarchy contra padre * local
+#include "transform_hierarchy.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/** Generador fijo: los fallos se reproducen */
+struct Random {
+    uint32_t state = 31337u;
+
+    float next(float lo, float hi) {
+        state = state * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<float>(state >> 8) / 16777216.0f;
+    }
+
+    /** Posición, rotación unitaria y escala */
+    void trs(float* out) {
+        for (int k = 0; k < 3; k++) out[k] = next(-5.0f, 5.0f);
+        float length = 0.0f;
+        for (int k = 3; k < 7; k++) {
+            out[k] = next(-1.0f, 1.0f);
+            length += out[k] * out[k];
+        }
+        length = std::sqrt(length);
+        for (int k = 3; k < 7; k++) out[k] /= length;
+        for (int k = 7; k < 10; k++) out[k] = next(0.5f, 1.5f);
+    }
+};
+
+// ========== Referencia escalar (Matrix4.trs y Matrix4.multiply) ==========
+
+void referenceTRS(const float* trs, float* m) {
+    const float x = trs[3], y = trs[4], z = trs[5], w = trs[6];
+    const float r[9] = {
+        1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w),
+        2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w),
+        2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y)
+    };
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < 3; k++) m[c * 4 + k] = r[c * 3 + k] * trs[7 + c];
+        m[c * 4 + 3] = 0.0f;
+    }
+    m[12] = trs[0];
+    m[13] = trs[1];
+    m[14] = trs[2];
+    m[15] = 1.0f;
+}
+
+void referenceMul(const float* a, const float* b, float* out) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+/** Espejo de la jerarquía: padre y TRS local por handle */
+struct Mirror {
+    std::vector<int32_t> parent;
+    std::vector<float> local;
+
+    void set(int32_t node, int32_t newParent, const float* trs) {
+        if (node >= static_cast<int32_t>(parent.size())) {
+            parent.resize(node + 1, -1);
+            local.resize((node + 1) * 10, 0.0f);
+        }
+        parent[node] = newParent;
+        std::copy(trs, trs + 10, &local[node * 10]);
+    }
+
+    void world(int32_t node, float* out) const {
+        float matrix[16];
+        referenceTRS(&local[node * 10], matrix);
+        if (parent[node] < 0) {
+            std::copy(matrix, matrix + 16, out);
+            return;
+        }
+        float parentWorld[16];
+        world(parent[node], parentWorld);
+        referenceMul(parentWorld, matrix, out);
+    }
+};
+
+void checkWorld(const TransformHierarchy& hierarchy, const Mirror& mirror, int32_t node) {
+    float actual[16], expected[16];
+    CHECK(hierarchy.getWorldMatrix(node, actual));
+    mirror.world(node, expected);
+    for (int k = 0; k < 16; k++) CHECK_NEAR(actual[k], expected[k], 1e-4f * (1.0f + std::fabs(expected[k])));
+}
+
+} // namespace
+
+TEST(worldMatricesFollowParentsCreatedInAnyOrder) {
+    TransformHierarchy hierarchy;
+    Mirror mirror;
+    Random random;
+    constexpr int32_t COUNT = 203;
+
+    // Todos como raíces y luego padres de índice mayor: el orden de creación
+    // no sirve, update() tiene que reordenar por profundidad
+    for (int32_t i = 0; i < COUNT; i++) {
+        float trs[10];
+        random.trs(trs);
+        const int32_t node = hierarchy.createNode(-1, static_cast<uint32_t>(i));
+        CHECK(node == i);
+        hierarchy.setLocal(node, trs);
+        mirror.set(node, -1, trs);
+    }
+    for (int32_t i = 0; i < COUNT - 1; i++) {
+        if (i % 5 == 4) continue;
+        const int32_t parent = i + 1 + static_cast<int32_t>(random.next(0.0f, 3.0f));
+        if (parent >= COUNT) continue;
+        hierarchy.setParent(i, parent);
+        mirror.parent[i] = parent;
+    }
+    hierarchy.update();
+    CHECK(hierarchy.getNodeCount() == COUNT);
+    CHECK(hierarchy.getChangedSlots().size() == COUNT);
+    for (int32_t i = 0; i < COUNT; i++) checkWorld(hierarchy, mirror, i);
+
+    // La matriz publicada es la world de ese slot
+    const std::vector<uint32_t>& slots = hierarchy.getChangedSlots();
+    for (size_t i = 0; i < slots.size(); i++) {
+        float world[16];
+        hierarchy.getWorldMatrix(static_cast<int32_t>(slots[i]), world);
+        for (int k = 0; k < 16; k++) CHECK(hierarchy.getChangedMatrices()[i][k] == world[k]);
+    }
+}
+
+TEST(onlyChangedSubtreesAreRecomputed) {
+    TransformHierarchy hierarchy;
+    Mirror mirror;
+    Random random;
+    // 0 <- 1 <- 2, 3 suelto y 4 (sin slot) hijo de 1
+    const int32_t parents[] = { -1, 0, 1, -1, 1 };
+    for (int32_t i = 0; i < 5; i++) {
+        float trs[10];
+        random.trs(trs);
+        hierarchy.createNode(parents[i], i == 4 ? TransformHierarchy::NO_SCENE_SLOT : static_cast<uint32_t>(10 + i));
+        hierarchy.setLocal(i, trs);
+        mirror.set(i, parents[i], trs);
+    }
+    hierarchy.update();
+    CHECK(hierarchy.getChangedSlots().size() == 4);
+
+    hierarchy.update();
+    CHECK(hierarchy.getChangedSlots().empty());
+
+    float trs[10];
+    random.trs(trs);
+    hierarchy.setLocal(1, trs);
+    mirror.set(1, 0, trs);
+    hierarchy.update();
+    std::vector<uint32_t> changed = hierarchy.getChangedSlots();
+    std::sort(changed.begin(), changed.end());
+    CHECK(changed.size() == 2 && changed[0] == 11 && changed[1] == 12);
+    for (int32_t i = 0; i < 5; i++) checkWorld(hierarchy, mirror, i);
+
+    // Un batch de 2 nodos de grupos de 4 distintos
+    const int nodes[] = { 3, 2 };
+    float batch[20];
+    random.trs(batch);
+    random.trs(batch + 10);
+    hierarchy.setLocalBatch(nodes, batch, 2);
+    mirror.set(3, -1, batch);
+    mirror.set(2, 1, batch + 10);
+    hierarchy.update();
+    CHECK(hierarchy.getChangedSlots().size() == 2);
+    for (int32_t i = 0; i < 5; i++) checkWorld(hierarchy, mirror, i);
+}
+
+TEST(invalidAndCyclicParentsAreRejected) {
+    TransformHierarchy hierarchy;
+    const int32_t root = hierarchy.createNode(-1, TransformHierarchy::NO_SCENE_SLOT);
+    const int32_t child = hierarchy.createNode(root, TransformHierarchy::NO_SCENE_SLOT);
+    const int32_t grandchild = hierarchy.createNode(child, TransformHierarchy::NO_SCENE_SLOT);
+    // Padre inexistente: nace como raíz
+    const int32_t orphan = hierarchy.createNode(99, TransformHierarchy::NO_SCENE_SLOT);
+
+    const float offset[10] = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    for (int32_t node : { root, child, grandchild, orphan }) hierarchy.setLocal(node, offset);
+
+    hierarchy.setParent(root, grandchild);
+    hierarchy.setParent(root, root);
+    hierarchy.setParent(child, 42);
+    hierarchy.update();
+
+    float world[16];
+    CHECK(hierarchy.getWorldMatrix(grandchild, world));
+    CHECK_NEAR(world[12], 3.0f, 1e-6f);
+    CHECK(hierarchy.getWorldMatrix(root, world));
+    CHECK_NEAR(world[12], 1.0f, 1e-6f);
+    CHECK(hierarchy.getWorldMatrix(orphan, world));
+    CHECK_NEAR(world[12], 1.0f, 1e-6f);
+    CHECK(!hierarchy.getWorldMatrix(-1, world));
+    CHECK(!hierarchy.getWorldMatrix(7, world));
+}
+
+TEST(destroyedNodesOrphanTheirChildrenAndReuseHandles) {
+    TransformHierarchy hierarchy;
+    Mirror mirror;
+    Random random;
+    for (int32_t i = 0; i < 9; i++) {
+        float trs[10];
+        random.trs(trs);
+        const int32_t parent = i == 0 ? -1 : (i - 1) / 2;
+        hierarchy.createNode(parent, static_cast<uint32_t>(i));
+        hierarchy.setLocal(i, trs);
+        mirror.set(i, parent, trs);
+    }
+    hierarchy.update();
+
+    // 1 tenía a 3 y 4: pasan a raíces
+    hierarchy.destroyNode(1);
+    mirror.parent[3] = -1;
+    mirror.parent[4] = -1;
+    hierarchy.destroyNode(1);
+    CHECK(hierarchy.getNodeCount() == 8);
+    float world[16];
+    CHECK(!hierarchy.getWorldMatrix(1, world));
+
+    hierarchy.update();
+    for (int32_t i = 0; i < 9; i++) {
+        if (i != 1) checkWorld(hierarchy, mirror, i);
+    }
+
+    // El handle libre se reutiliza, como hijo de 8
+    float trs[10];
+    random.trs(trs);
+    CHECK(hierarchy.createNode(8, 1u) == 1);
+    hierarchy.setLocal(1, trs);
+    mirror.set(1, 8, trs);
+    hierarchy.update();
+    for (int32_t i = 0; i < 9; i++) checkWorld(hierarchy, mirror, i);
+}
+
+int main() {
+    return runTests();
+}